@@ -18,11 +18,12 @@
 #include "Algorithms.h"
 
 #include <algorithm> // Of course we stand on the shoulders of the standard library, rather than reinvent the wheel
+#include <array>
 #include <cmath>
 
 #include <QDebug>
-#include <QVector>
 
+#include "Logging.h"
 #include "measurement/PhysicalConstants.h"
 #include "measurement/SucroseConversion.h"
 #include "measurement/Unit.h"
@@ -49,10 +50,68 @@ namespace {
    // This is the cubic fit to get Plato from specific gravity, measured at 20C
    // relative to density of water at 20C.
    // P = -616.868 + 1111.14(SG) - 630.272(SG)^2 + 135.997(SG)^3
+   std::array<double, 4> constexpr platoFromSG_20C20C_coeffs {-616.868, 1111.14, -630.272, 135.997};
    Polynomial const platoFromSG_20C20C {
-      Polynomial() << -616.868 << 1111.14 << -630.272 << 135.997
+      platoFromSG_20C20C_coeffs.data(), platoFromSG_20C20C_coeffs.size() - 1
    };
 
+   constexpr double platoFromSG_20C20C_eval(double const sg) {
+      return ((platoFromSG_20C20C_coeffs[3]  * sg +
+               platoFromSG_20C20C_coeffs[2]) * sg +
+               platoFromSG_20C20C_coeffs[1]) * sg +
+               platoFromSG_20C20C_coeffs[0];
+   }
+
+   //
+   // For the batch version of Algorithms::PlatoToSG_20C20C, rather than root-finding for every value, we pre-compute
+   // (at compile time) the SG for evenly spaced values of °P, and interpolate between them.  The range covers
+   // everything between minPlausibleSpecificGravity and maxPlausibleSpecificGravity.  The cubic is monotonic
+   // increasing over this range, so a simple bisection finds the roots.
+   //
+   double constexpr platoToSgGrid_minPlato = -25.0;
+   double constexpr platoToSgGrid_step     =   0.05;
+   size_t constexpr platoToSgGrid_size     = 1181; // Up to 34 °P
+
+   constexpr double platoToSg_bisection(double const plato) {
+      double lower = minPlausibleSpecificGravity;
+      double upper = maxPlausibleSpecificGravity;
+      for (int ii = 0; ii < 64; ++ii) {
+         double const middle = (lower + upper) / 2.0;
+         if (platoFromSG_20C20C_eval(middle) < plato) {
+            lower = middle;
+         } else {
+            upper = middle;
+         }
+      }
+      return (lower + upper) / 2.0;
+   }
+
+   constexpr std::array<double, platoToSgGrid_size> makePlatoToSgGrid() {
+      std::array<double, platoToSgGrid_size> grid{};
+      for (size_t ii = 0; ii < grid.size(); ++ii) {
+         grid[ii] = platoToSg_bisection(platoToSgGrid_minPlato + static_cast<double>(ii) * platoToSgGrid_step);
+      }
+      return grid;
+   }
+   std::array<double, platoToSgGrid_size> constexpr platoToSgGrid = makePlatoToSgGrid();
+
+   static_assert(platoFromSG_20C20C_eval(minPlausibleSpecificGravity) < platoToSgGrid_minPlato);
+   static_assert(platoFromSG_20C20C_eval(maxPlausibleSpecificGravity) >
+                 platoToSgGrid_minPlato + (platoToSgGrid_size - 1) * platoToSgGrid_step);
+
+   /**
+    * \brief Linear interpolation on an evenly spaced grid.  Caller is responsible for clamping \c position to
+    *        [0, gridSize - 1].
+    *
+    * \param position Position in the grid, in units of the grid spacing
+    */
+   template<size_t gridSize>
+   inline double interpolateOnGrid(std::array<double, gridSize> const & grid, double const position) {
+      size_t const index = std::min(static_cast<size_t>(position), gridSize - 2);
+      double const fraction = position - static_cast<double>(index);
+      return grid[index] + fraction * (grid[index + 1] - grid[index]);
+   }
+
    // Water density polynomial, given in kg/L as a function of degrees C.
    // 1.80544064e-8*x^3 - 6.268385468e-6*x^2 + 3.113930471e-5*x + 0.999924134
    Polynomial const waterDensityPoly_C {
@@ -89,7 +148,7 @@ namespace {
       double pctAbv_Max;
       double factorToUse;
    };
-   QVector<AbvFactorForGravityDifference> const gravityDifferenceFactors {
+   std::array<AbvFactorForGravityDifference, 11> constexpr gravityDifferenceFactors {{
       { 00,   69,  0.0,  0.8, 0.125},
       { 70,  104,  0.8,  1.3, 0.126},
       {105,  172,  1.3,  2.1, 0.127},
@@ -101,7 +160,45 @@ namespace {
       {680,  788,  9.0, 10.5, 0.133},
       {789,  897, 10.5, 12.0, 0.134},
       {898, 1007, 12.0, 13.6, 0.135}
-   };
+   }};
+
+   //
+   // Since the ranges in gravityDifferenceFactors are contiguous and the excess gravity difference is an integer, we can
+   // precompute, for every possible difference, which row of the table applies.  This saves searching the table.
+   //
+   int constexpr maxExcessGravityDiffx10 = gravityDifferenceFactors.back().excessGravityDiffx10_Max;
+
+   constexpr std::array<std::size_t, maxExcessGravityDiffx10 + 1> makeGravityDifferenceFactorIndex() {
+      std::array<std::size_t, maxExcessGravityDiffx10 + 1> index{};
+      for (std::size_t row = 0; row < gravityDifferenceFactors.size(); ++row) {
+         for (int diff = gravityDifferenceFactors[row].excessGravityDiffx10_Min;
+              diff <= gravityDifferenceFactors[row].excessGravityDiffx10_Max;
+              ++diff) {
+            index[diff] = row;
+         }
+      }
+      return index;
+   }
+   std::array<std::size_t, maxExcessGravityDiffx10 + 1> constexpr gravityDifferenceFactorIndex =
+      makeGravityDifferenceFactorIndex();
+
+   constexpr bool gravityDifferenceFactorsAreContiguous() {
+      for (std::size_t row = 1; row < gravityDifferenceFactors.size(); ++row) {
+         if (gravityDifferenceFactors[row].excessGravityDiffx10_Min !=
+             gravityDifferenceFactors[row - 1].excessGravityDiffx10_Max + 1) {
+            return false;
+         }
+      }
+      return gravityDifferenceFactors[0].excessGravityDiffx10_Min == 0;
+   }
+   static_assert(gravityDifferenceFactorsAreContiguous());
+
+   /**
+    * \brief See \c Algorithms::abvFromOgAndFg for explanation.
+    */
+   double constexpr abvByFallbackMethod(double const og, double const fg) {
+      return (76.08 * (og - fg) / (1.775 - og)) * (fg / 0.794);
+   }
 
    /**
     * \brief Extension of std::lower_bound to find an interpolated conversion in a sorted range
@@ -165,7 +262,7 @@ namespace {
 
       double const positionInRange =
          (getFrom(value) - getFrom(*lastSmaller)) / (getFrom(*firstLarger) - getFrom(*lastSmaller));
-      qDebug() <<
+      qCDebug(logCalc) <<
          Q_FUNC_INFO << "Supplied value" << getFrom(value) << whatFrom << " lies" << (100 * positionInRange) << "% "
          "between" << getFrom(*lastSmaller) << whatFrom << "(=" << getTo(*lastSmaller) << whatTo << ") and" <<
          getFrom(*firstLarger) << whatFrom << "(=" << getTo(*firstLarger) << whatTo << ")";
@@ -495,7 +592,7 @@ double Algorithms::abvFromOgAndFg(double og, double fg) {
    //
    int excessGravityDiffx10 = round(10.0 * (specificGravityToExcessGravity(og) - specificGravityToExcessGravity(fg)));
    double excessGravityDiff = excessGravityDiffx10 / 10.0;
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "OG (as SG) =" << og << ", FG (as SG) =" << fg << ", excess gravity diff =" << excessGravityDiff <<
       "(×10 =" << excessGravityDiffx10 << ")";
 
@@ -504,14 +601,7 @@ double Algorithms::abvFromOgAndFg(double og, double fg) {
    // difference, which makes everything simple for this lookup, and means we don't have to think about floating point
    // rounding errors.
    //
-   auto matchingGravityDifferenceRec = std::find_if(
-      gravityDifferenceFactors.cbegin(),
-      gravityDifferenceFactors.cend(),
-      [excessGravityDiffx10](AbvFactorForGravityDifference const & rec) {
-         return (rec.excessGravityDiffx10_Min <= excessGravityDiffx10 &&
-                 excessGravityDiffx10 <= rec.excessGravityDiffx10_Max);
-      }
-   );
+   bool const haveFactor = (0 <= excessGravityDiffx10 && excessGravityDiffx10 <= maxExcessGravityDiffx10);
 
    //
    // FALLBACK METHOD
@@ -524,19 +614,21 @@ double Algorithms::abvFromOgAndFg(double og, double fg) {
    //    The relationship between the change in gravity, and the change in ABV is not linear. All these equations are
    //    approximations."
    //
-   double const abvByFallbackMethod = (76.08 * (og - fg) / (1.775 - og)) * (fg / 0.794);
+   double const abvByFallback = abvByFallbackMethod(og, fg);
 
-   if (matchingGravityDifferenceRec == gravityDifferenceFactors.cend()) {
+   if (!haveFactor) {
       qCritical() <<
          Q_FUNC_INFO << "Could not find gravity difference record for difference of " <<
          (excessGravityDiffx10 / 10.0) << "so using fallback method";
-      return abvByFallbackMethod;
+      return abvByFallback;
    }
 
+   AbvFactorForGravityDifference const * const matchingGravityDifferenceRec =
+      &gravityDifferenceFactors[gravityDifferenceFactorIndex[excessGravityDiffx10]];
    double const abvByHmrcMethod = excessGravityDiff * matchingGravityDifferenceRec->factorToUse;
 
-   qDebug() <<
-      Q_FUNC_INFO << "ABV old method:" << abvByFallbackMethod << "% , new method:" << abvByHmrcMethod << "% (used factor" <<
+   qCDebug(logCalc) <<
+      Q_FUNC_INFO << "ABV old method:" << abvByFallback << "% , new method:" << abvByHmrcMethod << "% (used factor" <<
       matchingGravityDifferenceRec->factorToUse << "and should be in range" <<
       matchingGravityDifferenceRec->pctAbv_Min << "% -" << matchingGravityDifferenceRec->pctAbv_Max << "%)";
 
@@ -580,7 +672,7 @@ double Algorithms::correctSgForTemperature(double measuredSg, double readingTemp
       (1.00130346 - 0.000134722124 * tc + 0.00000204052596 * intPow(tc,2) - 0.00000000232820948 * intPow(tc,3))
    );
 
-   qDebug() <<
+   qCDebug(logCalc) <<
      Q_FUNC_INFO << measuredSg << "SG measured @" << readingTempInC << "°C (" << tr << "°F) "
      "on hydrometer calibrated at" << calibrationTempInC << "°C (" << tc << "°F) is corrected to" << correctedSg <<
      "SG";
@@ -588,3 +680,62 @@ double Algorithms::correctSgForTemperature(double measuredSg, double readingTemp
    return correctedSg;
 
 }
+
+void Algorithms::PlatoToSG_20C20C(std::span<double const> plato, std::span<double> sg) {
+   Q_ASSERT(plato.size() == sg.size());
+   double const maxPosition = static_cast<double>(platoToSgGrid_size - 1);
+   for (std::size_t ii = 0; ii < plato.size(); ++ii) {
+      double const position = (plato[ii] - platoToSgGrid_minPlato) / platoToSgGrid_step;
+      sg[ii] = interpolateOnGrid(platoToSgGrid, std::clamp(position, 0.0, maxPosition));
+   }
+
+   //
+   // Anything off the grid is implausible, but, for consistency with the single-value version, we root-find it.  This
+   // is a separate pass so that the loop above stays simple.
+   //
+   double const maxPlato = platoToSgGrid_minPlato + maxPosition * platoToSgGrid_step;
+   for (std::size_t ii = 0; ii < plato.size(); ++ii) {
+      if (plato[ii] < platoToSgGrid_minPlato || plato[ii] > maxPlato) {
+         sg[ii] = Algorithms::PlatoToSG_20C20C(plato[ii]);
+      }
+   }
+   return;
+}
+
+void Algorithms::SgAt20CToBrix(std::span<double const> sg, std::span<double> brix) {
+   Q_ASSERT(sg.size() == brix.size());
+   // As in the single-value version, SG at or below 1.000 gives 0 Brix, and SG off the top of the table gives the max
+   double const maxPosition = static_cast<double>(Measurement::sgToBrixGrid_size - 1);
+   for (std::size_t ii = 0; ii < sg.size(); ++ii) {
+      double const position = (sg[ii] - 1.0) / Measurement::sgToBrixGrid_step;
+      brix[ii] = interpolateOnGrid(Measurement::sgToBrixGrid, std::clamp(position, 0.0, maxPosition));
+   }
+   return;
+}
+
+void Algorithms::abvFromOgAndFg(std::span<double const> og, std::span<double const> fg, std::span<double> abv) {
+   Q_ASSERT(og.size() == fg.size());
+   Q_ASSERT(og.size() == abv.size());
+   std::size_t numFallbacks = 0;
+   for (std::size_t ii = 0; ii < og.size(); ++ii) {
+      // Same calculation (including the same rounding) as the single-value version -- see comments there
+      int const excessGravityDiffx10 = static_cast<int>(
+         round(10.0 * (specificGravityToExcessGravity(og[ii]) - specificGravityToExcessGravity(fg[ii])))
+      );
+      if (excessGravityDiffx10 < 0 || excessGravityDiffx10 > maxExcessGravityDiffx10) {
+         abv[ii] = abvByFallbackMethod(og[ii], fg[ii]);
+         ++numFallbacks;
+         continue;
+      }
+      abv[ii] = (excessGravityDiffx10 / 10.0) *
+                gravityDifferenceFactors[gravityDifferenceFactorIndex[excessGravityDiffx10]].factorToUse;
+   }
+
+   // Rather than log for each value, we just give a summary
+   if (numFallbacks > 0) {
+      qWarning() <<
+         Q_FUNC_INFO << "Used fallback method for" << numFallbacks << "of" << og.size() << "values, as gravity "
+         "difference was outside HMRC table";
+   }
+   return;
+}
@@ -22,6 +22,7 @@
 
 #include <cmath>
 #include <limits> // For std::numeric_limits
+#include <span>
 #include <string.h>
 #include <vector>
 
@@ -149,6 +150,30 @@ namespace Algorithms {
    //! \brief Correct specific gravity reading for the temperature at which it was taken
    double correctSgForTemperature(double measuredSg, double readingTempInC, double calibrationTempInC);
 
+   //=====================Batch versions=======================
+   //
+   // These do the same calculations as their single-value counterparts above, but on whole arrays of inputs at once,
+   // eg for recalculating a whole catalog or for sweeping a parameter across a range of values.  Inputs and outputs
+   // are separate arrays of the same length (ie structure-of-arrays), and the loops have no logging, look-ups or
+   // branches that would stop the compiler vectorising them.  Results match the single-value versions to within
+   // rounding (or, where noted, interpolation) error.
+   //
+
+   /**
+    * \brief Batch version of \c PlatoToSG_20C20C.  Uses linear interpolation on a grid of exact roots computed at
+    *        compile time, so results agree with the single-value version to within 1e-6 SG.
+    */
+   void PlatoToSG_20C20C(std::span<double const> plato, std::span<double> sg);
+
+   /**
+    * \brief Batch version of \c SgAt20CToBrix.  Uses an evenly spaced resampling of the USDA data (see
+    *        \c Measurement::sgToBrixGrid), so results agree with the single-value version to within 0.005 Brix.
+    */
+   void SgAt20CToBrix(std::span<double const> sg, std::span<double> brix);
+
+   //! \brief Batch version of \c abvFromOgAndFg
+   void abvFromOgAndFg(std::span<double const> og, std::span<double const> fg, std::span<double> abv);
+
 }
 
 #endif
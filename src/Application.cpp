@@ -49,6 +49,10 @@
 #include "BtSplashScreen.h"
 #include "config.h"
 #include "database/Database.h"
+#include "database/DbChangeNotifier.h"
+#include "database/DbMaintenance.h"
+#include "database/DbWriter.h"
+#include "database/QueryStats.h"
 #include "LatestReleaseFinder.h"
 #include "Localization.h"
 #include "MainWindow.h"
@@ -351,6 +355,7 @@ void Application::cleanup() {
 
    qDebug() << Q_FUNC_INFO << "Unloading database";
    Database::instance().unload();
+   QueryStats::logReport();
 
    qDebug() << Q_FUNC_INFO << "Done cleaning up";
    return;
@@ -404,6 +409,54 @@ int Application::run() {
    mainWindow.connect(latestReleaseFinder, &LatestReleaseFinder::foundLatestRelease, &mainWindow        , &MainWindow::checkAgainstLatestRelease    , Qt::QueuedConnection);
    latestReleaseFinderThread.start();
 
+   //
+   // Optionally, DB writes for property changes can be done on a background thread, so that a slow DB doesn't make for
+   // a slow UI.  (It is stopped, after writing out anything still queued, in Database::unload().)  As above, the lambda
+   // will get run on the main event loop because we supply mainWindow as the context object.
+   //
+   if (PersistentSettings::value(PersistentSettings::Names::dbAsyncWrites, false).toBool()) {
+      mainWindow.connect(
+         &DbWriter::instance(),
+         &DbWriter::writeFailed,
+         &mainWindow,
+         [&mainWindow](QString const & description) {
+            QMessageBox::warning(
+               &mainWindow,
+               QObject::tr("Database write failed"),
+               QObject::tr("Unable to save a change to the database (%1).\n\nSee log file for details.").arg(description)
+            );
+         }
+      );
+      DbWriter::instance().start();
+   }
+
+   //
+   // If we're sharing a PostgreSQL database with other clients, listen for their changes so we can keep our cached
+   // objects (and therefore what's shown in the UI) up-to-date.  (This does nothing on SQLite.  It is stopped in
+   // Database::unload().)  Whatever the DB, we want to tell the user if one of their changes lost out to someone
+   // else's.
+   //
+   mainWindow.connect(
+      &DbChangeNotifier::instance(),
+      &DbChangeNotifier::conflictDetected,
+      &mainWindow,
+      [&mainWindow](QString const & description) {
+         QMessageBox::warning(
+            &mainWindow,
+            QObject::tr("Change not saved"),
+            QObject::tr("Someone else changed the same item before your change could be saved (%1).  The item now "
+                        "shows their version.").arg(description)
+         );
+      }
+   );
+   DbChangeNotifier::instance().start();
+
+   //
+   // Tidy up the DB (purge deleted objects, reclaim space, update statistics) when the user isn't doing anything.  (It
+   // is stopped in Database::unload().)
+   //
+   DbMaintenance::instance().start();
+
    mainWindow.initialiseAndMakeVisible();
    splashScreen.finish(&mainWindow);
 
@@ -441,6 +494,8 @@ void Application::readSystemOptions() {
      IbuMethods::loadFormula();
    ColorMethods::loadFormula();
 
+   QueryStats::loadSettings();
+
    //=======================Language & Date format===================
    Localization::loadSettings();
 
@@ -0,0 +1,442 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BatchRunner.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "BatchRunner.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+
+#include "Application.h"
+#include "config.h"
+#include "database/ObjectStoreWrapper.h"
+#include "database/SyntheticDataGenerator.h"
+#include "model/Recipe.h"
+#include "RecipeFormatter.h"
+#include "serialization/ImportExport.h"
+
+namespace {
+   QCommandLineOption const batchOption{
+      "batch",
+      "Run without GUI, do the jobs specified by the --batch-* options, then exit"
+   };
+   QCommandLineOption const generateOption{
+      "batch-generate",
+      "In batch mode, generate a synthetic data set (for scale testing) in the database.  Use --batch-export afterwards "
+      "to also get it as a BeerXML or BeerJSON file."
+   };
+   QCommandLineOption const generateSeedOption{
+      "batch-generate-seed",
+      "With --batch-generate, seed the random number generator with <number>.  The same seed and sizes always give "
+      "the same data set.",
+      "number"
+   };
+   QCommandLineOption const generateIngredientsOption{
+      "batch-generate-ingredients",
+      "With --batch-generate, create <number> hops, fermentables, miscs and yeasts in total (default 50000)",
+      "number"
+   };
+   QCommandLineOption const generateRecipesOption{
+      "batch-generate-recipes",
+      "With --batch-generate, create <number> recipes, including previous versions (default 20000)",
+      "number"
+   };
+   QCommandLineOption const generateFolderDepthOption{
+      "batch-generate-folder-depth",
+      "With --batch-generate, make folder trees <number> levels deep (default 5)",
+      "number"
+   };
+   QCommandLineOption const importOption{
+      "batch-import",
+      "In batch mode, import BeerXML or BeerJSON <file>.  Can be given more than once.",
+      "file"
+   };
+   QCommandLineOption const recalcOption{
+      "batch-recalc",
+      "In batch mode, recalculate all recipes"
+   };
+   QCommandLineOption const exportOption{
+      "batch-export",
+      "In batch mode, export recipes to <file> (.json for BeerJSON or .xml for BeerXML)",
+      "file"
+   };
+   QCommandLineOption const exportChangesOption{
+      "batch-export-changes",
+      "In batch mode, export to <file> (.json for BeerJSON or .xml for BeerXML) only the recipes, ingredients, etc "
+      "that have changed since the last time this option was used",
+      "file"
+   };
+   QCommandLineOption const reportOption{
+      "batch-report",
+      "In batch mode, write an HTML report for each recipe to <directory>",
+      "directory"
+   };
+   QCommandLineOption const recipeOption{
+      "batch-recipe",
+      "In batch mode, only export / report the recipe called <name> (rather than all recipes).  Can be given more "
+      "than once.",
+      "name"
+   };
+   QCommandLineOption const timingsOption{
+      "batch-timings",
+      "In batch mode, write job timings (as JSON) to <file> rather than standard output",
+      "file"
+   };
+   QCommandLineOption const threadsOption{
+      "batch-threads",
+      "In batch mode, use at most <number> worker threads (default is number of CPU cores)",
+      "number"
+   };
+
+   /**
+    * \brief Make something usable as a file name from a recipe name
+    */
+   QString safeFileName(Recipe const & recipe) {
+      static QRegularExpression const unsafeCharacters{"[^A-Za-z0-9_-]+"};
+      QString fileName = recipe.name();
+      fileName.replace(unsafeCharacters, "_");
+      // Recipe names are not unique, but IDs are
+      return QString{"%1-%2.html"}.arg(fileName).arg(recipe.key());
+   }
+}
+
+// This private implementation class holds all private non-virtual members of BatchRunner
+class BatchRunner::impl {
+public:
+
+   impl(QCommandLineParser const & parser) :
+      m_parser      {parser},
+      m_jobs        {},
+      m_allSucceeded{true},
+      m_numThreads  {QThread::idealThreadCount()} {
+      if (parser.isSet(threadsOption)) {
+         bool ok = false;
+         int const numThreads = parser.value(threadsOption).toInt(&ok);
+         if (ok && numThreads > 0) {
+            this->m_numThreads = numThreads;
+         } else {
+            qWarning() << Q_FUNC_INFO << "Ignoring invalid thread count" << parser.value(threadsOption);
+         }
+      }
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Run one job, recording how long it took and whether it succeeded
+    *
+    * \param jobName  Name of the job for the timing output (eg "import")
+    * \param target   What the job is operating on (eg file name), or empty string if not applicable
+    * \param job      Does the work.  Takes a \c QTextStream & for any message and returns \c true if succeeded.
+    */
+   template<typename Functor>
+   void timeJob(QString const & jobName, QString const & target, Functor job) {
+      qInfo() << Q_FUNC_INFO << "Starting" << jobName << target;
+      QString message;
+      QTextStream messageAsStream{&message};
+
+      QElapsedTimer timer;
+      timer.start();
+      bool const succeeded = job(messageAsStream);
+      double const elapsed_ms = static_cast<double>(timer.nsecsElapsed()) / 1000000.0;
+
+      qInfo() <<
+         Q_FUNC_INFO << jobName << target << (succeeded ? "succeeded" : "failed") << "in" << elapsed_ms << "ms" <<
+         message;
+      this->m_jobs.append(QJsonObject{
+         {"job"      , jobName          },
+         {"target"   , target           },
+         {"succeeded", succeeded        },
+         {"elapsedMs", elapsed_ms       },
+         {"message"  , message.trimmed()},
+      });
+      this->m_allSucceeded &= succeeded;
+      return;
+   }
+
+   /**
+    * \brief Get the value of an integer option, or \c defaultValue if it's not set or not valid
+    */
+   int intValue(QCommandLineOption const & option, int const defaultValue) const {
+      if (!this->m_parser.isSet(option)) {
+         return defaultValue;
+      }
+      bool ok = false;
+      int const value = this->m_parser.value(option).toInt(&ok);
+      if (!ok || value < 0) {
+         qWarning() << Q_FUNC_INFO << "Ignoring invalid value" << this->m_parser.value(option) << "for" << option.names();
+         return defaultValue;
+      }
+      return value;
+   }
+
+   /**
+    * \brief As \c intValue, but for an unsigned 32-bit option (eg a random number seed), so that the whole range is
+    *        accepted
+    */
+   quint32 uintValue(QCommandLineOption const & option, quint32 const defaultValue) const {
+      if (!this->m_parser.isSet(option)) {
+         return defaultValue;
+      }
+      bool ok = false;
+      quint32 const value = this->m_parser.value(option).toUInt(&ok);
+      if (!ok) {
+         qWarning() << Q_FUNC_INFO << "Ignoring invalid value" << this->m_parser.value(option) << "for" << option.names();
+         return defaultValue;
+      }
+      return value;
+   }
+
+   bool generate(QTextStream & message) {
+      SyntheticDataGenerator::Parameters parameters;
+      parameters.seed           = this->uintValue(generateSeedOption, parameters.seed);
+      parameters.numIngredients = this->intValue(generateIngredientsOption, parameters.numIngredients);
+      parameters.numRecipes     = this->intValue(generateRecipesOption    , parameters.numRecipes    );
+      parameters.folderDepth    = this->intValue(generateFolderDepthOption, parameters.folderDepth   );
+      return SyntheticDataGenerator::generate(parameters, message);
+   }
+
+   /**
+    * \brief The recipes the user asked for with --batch-recipe or, if none, all (displayable) recipes
+    */
+   QList<Recipe *> selectedRecipes() const {
+      if (!this->m_parser.isSet(recipeOption)) {
+         return ObjectStoreWrapper::getAllDisplayableRaw<Recipe>();
+      }
+
+      QList<Recipe *> recipes;
+      for (QString const & name : this->m_parser.values(recipeOption)) {
+         auto matches = ObjectStoreWrapper::findAllMatching<Recipe>(
+            [&name](Recipe const * recipe) { return recipe->display() && recipe->name() == name; }
+         );
+         if (matches.isEmpty()) {
+            qWarning() << Q_FUNC_INFO << "No recipe called" << name;
+         }
+         recipes.append(matches);
+      }
+      return recipes;
+   }
+
+   bool recalcAll(QTextStream & message) {
+      auto recipes = ObjectStoreWrapper::getAllDisplayableRaw<Recipe>();
+      for (Recipe * recipe : recipes) {
+         recipe->recalcAll();
+      }
+      message << recipes.size() << " recipe(s)";
+      return true;
+   }
+
+   bool exportRecipes(QString const & fileName, QTextStream & message) {
+      auto recipes = this->selectedRecipes();
+      if (recipes.isEmpty()) {
+         message << "No recipes to export";
+         return false;
+      }
+      QList<Recipe const *> const constRecipes{recipes.begin(), recipes.end()};
+      return ImportExport::exportToNamedFile(fileName, message, &constRecipes);
+   }
+
+   bool writeReports(QString const & directoryName, QTextStream & message) {
+      QDir const directory{directoryName};
+      if (!directory.exists() && !QDir{}.mkpath(directoryName)) {
+         message << "Could not create directory " << directoryName;
+         return false;
+      }
+
+      //
+      // Generating the HTML has to be done on this thread (see class comment), but we can write the files in parallel
+      // with that.
+      //
+      QThreadPool threadPool;
+      threadPool.setMaxThreadCount(this->m_numThreads);
+      std::atomic<int> numFailures{0};
+
+      RecipeFormatter recipeFormatter;
+      auto recipes = this->selectedRecipes();
+      for (Recipe * recipe : recipes) {
+         recipeFormatter.setRecipe(recipe);
+         QString html = recipeFormatter.getHtmlFormat();
+         QString const filePath = directory.filePath(safeFileName(*recipe));
+         threadPool.start([html = std::move(html), filePath, &numFailures]() {
+            QFile file{filePath};
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+               qWarning() << Q_FUNC_INFO << "Could not open" << filePath << "for writing";
+               ++numFailures;
+               return;
+            }
+            QTextStream fileAsStream{&file};
+            fileAsStream << html;
+            return;
+         });
+      }
+      threadPool.waitForDone();
+
+      message << recipes.size() << " recipe(s), " << numFailures << " failure(s)";
+      return numFailures == 0;
+   }
+
+   /**
+    * \brief Output the results of all the jobs as JSON
+    */
+   void writeTimings(double const total_ms) {
+      QJsonObject const timings{
+         {"application", CONFIG_APPLICATION_NAME_UC},
+         {"version"    , CONFIG_VERSION_STRING     },
+         {"threads"    , this->m_numThreads        },
+         {"jobs"       , this->m_jobs              },
+         {"succeeded"  , this->m_allSucceeded      },
+         {"totalMs"    , total_ms                  },
+      };
+      QByteArray const output = QJsonDocument{timings}.toJson();
+
+      if (!this->m_parser.isSet(timingsOption)) {
+         std::cout << output.constData() << std::flush;
+         return;
+      }
+
+      QString const fileName = this->m_parser.value(timingsOption);
+      QFile file{fileName};
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+         qCritical() << Q_FUNC_INFO << "Could not open" << fileName << "for writing";
+         std::cerr << "Could not write timings to " << fileName.toStdString() << std::endl;
+         this->m_allSucceeded = false;
+         return;
+      }
+      file.write(output);
+      return;
+   }
+
+   QCommandLineParser const & m_parser;
+   QJsonArray m_jobs;
+   bool m_allSucceeded;
+   int m_numThreads;
+};
+
+BatchRunner::BatchRunner(QCommandLineParser const & parser) : pimpl{std::make_unique<impl>(parser)} {
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+BatchRunner::~BatchRunner() = default;
+
+void BatchRunner::addCommandLineOptions(QCommandLineParser & parser) {
+   parser.addOption(batchOption  );
+   parser.addOption(generateOption);
+   parser.addOption(generateSeedOption);
+   parser.addOption(generateIngredientsOption);
+   parser.addOption(generateRecipesOption);
+   parser.addOption(generateFolderDepthOption);
+   parser.addOption(importOption );
+   parser.addOption(recalcOption );
+   parser.addOption(exportOption );
+   parser.addOption(exportChangesOption);
+   parser.addOption(reportOption );
+   parser.addOption(recipeOption );
+   parser.addOption(timingsOption);
+   parser.addOption(threadsOption);
+   return;
+}
+
+bool BatchRunner::isRequested(int argc, char const * const * argv) {
+   for (int ii = 1; ii < argc; ++ii) {
+      if (std::strcmp(argv[ii], "--batch") == 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+int BatchRunner::run() {
+   QElapsedTimer totalTimer;
+   totalTimer.start();
+
+   // There's no-one to answer any questions, so we must not ask any
+   Application::setInteractive(false);
+   if (!Application::initialize()) {
+      std::cerr << "Unable to initialise (eg could not open database) - see log file for details" << std::endl;
+      Application::cleanup();
+      return EXIT_FAILURE;
+   }
+
+   QCommandLineParser const & parser = this->pimpl->m_parser;
+   if (parser.isSet(generateOption)) {
+      this->pimpl->timeJob(
+         "generate", "", [this](QTextStream & message) { return this->pimpl->generate(message); }
+      );
+   }
+
+   for (QString const & fileName : parser.values(importOption)) {
+      this->pimpl->timeJob(
+         "import", fileName, [&fileName](QTextStream & message) {
+            return ImportExport::importFromFile(fileName, message);
+         }
+      );
+   }
+
+   if (parser.isSet(recalcOption)) {
+      this->pimpl->timeJob(
+         "recalc", "", [this](QTextStream & message) { return this->pimpl->recalcAll(message); }
+      );
+   }
+
+   if (parser.isSet(exportOption)) {
+      QString const fileName = parser.value(exportOption);
+      this->pimpl->timeJob(
+         "export", fileName, [this, &fileName](QTextStream & message) {
+            return this->pimpl->exportRecipes(fileName, message);
+         }
+      );
+   }
+
+   if (parser.isSet(exportChangesOption)) {
+      QString const fileName = parser.value(exportChangesOption);
+      this->pimpl->timeJob(
+         "exportChanges", fileName, [&fileName](QTextStream & message) {
+            return ImportExport::exportChangesToNamedFile(fileName, message);
+         }
+      );
+   }
+
+   if (parser.isSet(reportOption)) {
+      QString const directoryName = parser.value(reportOption);
+      this->pimpl->timeJob(
+         "report", directoryName, [this, &directoryName](QTextStream & message) {
+            return this->pimpl->writeReports(directoryName, message);
+         }
+      );
+   }
+
+   Application::cleanup();
+
+   this->pimpl->writeTimings(static_cast<double>(totalTimer.nsecsElapsed()) / 1000000.0);
+   return this->pimpl->m_allSucceeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,72 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * BatchRunner.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+#pragma once
+
+#include <memory> // For PImpl
+
+class QCommandLineParser;
+
+/**
+ * \brief Runs the application headless (ie with \c QCoreApplication and no widgets) to do a batch of jobs against the
+ *        database and then exit.  This is intended for running from cron, CI, etc.
+ *
+ *        The jobs are specified on the command line (see \c addCommandLineOptions) and are always run in the following
+ *        order, regardless of the order they are given in:
+ *           - generate a synthetic data set for scale testing (see \c SyntheticDataGenerator);
+ *           - import any number of BeerXML / BeerJSON files;
+ *           - recalculate all recipes;
+ *           - export recipes to a BeerXML / BeerJSON file;
+ *           - write an HTML report (as generated by \c RecipeFormatter) for each recipe to a directory.
+ *
+ *        How long each job took, and whether it succeeded, is written as JSON to standard output (or to a file).
+ *
+ *        Anything that touches the model objects or the database is done on the main thread, as neither
+ *        \c ObjectStore nor the model objects are safe to use from multiple threads at once.  Work that doesn't need
+ *        them (currently writing report files) is spread across a thread pool.
+ */
+class BatchRunner {
+public:
+   BatchRunner(QCommandLineParser const & parser);
+   ~BatchRunner();
+
+   /**
+    * \brief Add the options for batch mode to the supplied command line parser
+    */
+   static void addCommandLineOptions(QCommandLineParser & parser);
+
+   /**
+    * \brief Returns \c true if batch mode was requested on the command line.  This has to be checked before we
+    *        construct the Qt application object (as we need to know whether to construct \c QApplication or
+    *        \c QCoreApplication), so we can't use \c QCommandLineParser here.
+    */
+   static bool isRequested(int argc, char const * const * argv);
+
+   /**
+    * \brief Initialise the application (without any UI), run all the requested jobs, and clean up
+    *
+    * \return Exit code for the application: \c EXIT_SUCCESS if all jobs succeeded, \c EXIT_FAILURE otherwise
+    */
+   int run();
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
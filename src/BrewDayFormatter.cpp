@@ -27,6 +27,7 @@
 #include "model/Equipment.h"
 #include "model/Instruction.h"
 #include "model/Mash.h"
+#include "model/RecipeAdditionFermentable.h"
 #include "model/Style.h"
 #include "PersistentSettings.h"
 
@@ -36,16 +37,75 @@
 #endif
 
 BrewDayFormatter::BrewDayFormatter(QObject * parent)
-   : QObject(parent) {
+   : QObject(parent),
+     fragmentCache{"BrewDayFormatter", *this} {
    recObs = nullptr;
+
+   //
+   // The title table shows a lot of calculated values, so it depends on every property of the recipe
+   //
+   this->fragmentCache.addSection(
+      static_cast<int>(HtmlSection::Title),
+      {},
+      [this]() {
+         QList<NamedEntity const *> dependencies;
+         if (this->recObs) {
+            dependencies.append(this->recObs->style().get());
+            dependencies.append(this->recObs->equipment().get());
+         }
+         return dependencies;
+      },
+      [this]() { return this->buildTitleHtml(); }
+   );
+
+   //
+   // The instructions pull in the reagents for the "Add grains" and "Heat water" steps, so they depend on the
+   // fermentable additions and the mash as well as on the instructions themselves.
+   //
+   this->fragmentCache.addSection(
+      static_cast<int>(HtmlSection::Instructions),
+      {&PropertyNames::Recipe::instructions,
+       &PropertyNames::Recipe::fermentableAdditions,
+       &PropertyNames::Recipe::mash},
+      [this]() {
+         QList<NamedEntity const *> dependencies;
+         if (this->recObs) {
+            for (auto const & instruction : this->recObs->instructions()) {
+               dependencies.append(instruction.get());
+            }
+            for (auto const & fermentableAddition : this->recObs->fermentableAdditions()) {
+               dependencies.append(fermentableAddition.get());
+            }
+            if (this->recObs->mash()) {
+               dependencies.append(this->recObs->mash().get());
+               for (auto const & mashStep : this->recObs->mash()->mashSteps()) {
+                  dependencies.append(mashStep.get());
+               }
+            }
+         }
+         return dependencies;
+      },
+      [this]() { return this->buildInstructionHtml(); }
+   );
+   return;
 }
 
 void BrewDayFormatter::setRecipe(Recipe * recipe) {
    recObs = recipe;
+   this->fragmentCache.setOwner(recipe);
+   return;
 }
 
 QString BrewDayFormatter::buildHtml() {
-   return buildTitleHtml() + buildInstructionHtml() + buildFooterHtml();
+   QDate const today = QDate::currentDate();
+   if (today != this->titleDate) {
+      this->fragmentCache.invalidate(static_cast<int>(HtmlSection::Title));
+      this->titleDate = today;
+   }
+
+   return this->fragmentCache.fragment(static_cast<int>(HtmlSection::Title       )) +
+          this->fragmentCache.fragment(static_cast<int>(HtmlSection::Instructions)) +
+          this->buildFooterHtml();
 }
 
 QString BrewDayFormatter::buildTitleHtml(bool includeImage) {
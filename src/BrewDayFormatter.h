@@ -21,12 +21,14 @@
 #define BREWDAYFORMATTER_H
 #pragma once
 
+#include <QDate>
 #include <QList>
 #include <QObject>
 #include <QStringList>
 #include <QWidget>
 
 #include "model/Recipe.h"
+#include "utils/HtmlFragmentCache.h"
 
 class BrewDayFormatter : public QObject {
    Q_OBJECT
@@ -47,13 +49,20 @@ public:
    void setRecipe(Recipe *recipe);
 
    /**
-    * @brief Builds the whole HTML page for Brewday instructions
+    * @brief Builds the whole HTML page for Brewday instructions.  The title and instructions sections are cached, and
+    *        only rebuilt when something they show has changed.
     *
     * @return QString
     */
    QString buildHtml();
 
 private:
+   //! The sections of the page that are cached in \c fragmentCache
+   enum class HtmlSection {
+      Title       ,
+      Instructions,
+   };
+
    /**
     * @brief Create HTML string containing the basic information about the recipe
     *
@@ -92,6 +101,9 @@ public:
 private:
    Recipe *recObs;
    QString cssName;
+   HtmlFragmentCache fragmentCache;
+   //! The title section shows today's date, so we need to rebuild it if the date changes
+   QDate titleDate;
 };
 
 #endif
@@ -17,6 +17,8 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "InventoryFormatter.h"
 
+#include <functional>
+
 #include <QList>
 #include <QMap>
 #include <QStringList>
@@ -35,6 +37,7 @@
 #include "model/Misc.h"
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
+#include "utils/CellDataCache.h"
 
 namespace {
    /**
@@ -233,13 +236,14 @@ namespace {
    /**
     * Create Inventory HTML Body
     */
-   QString createInventoryBody(InventoryFormatter::HtmlGenerationFlags flags) {
+   QString createInventoryBody(InventoryFormatter::HtmlGenerationFlags flags,
+                               std::function<QString(InventoryFormatter::HtmlGenerationFlag, QString (*)())> const & getTable) {
       // Only generate users selection of Ingredient inventory.
       QString result =
-         ((flags & InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ) ? createInventoryTableFermentable() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::HOPS         ) ? createInventoryTableHop() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS) ? createInventoryTableMiscellaneous() : "") +
-         ((flags & InventoryFormatter::HtmlGenerationFlag::YEAST        ) ? createInventoryTableYeast() : "");
+         ((flags & InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ) ? getTable(InventoryFormatter::HtmlGenerationFlag::FERMENTABLES , createInventoryTableFermentable  ) : "") +
+         ((flags & InventoryFormatter::HtmlGenerationFlag::HOPS         ) ? getTable(InventoryFormatter::HtmlGenerationFlag::HOPS         , createInventoryTableHop          ) : "") +
+         ((flags & InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS) ? getTable(InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS, createInventoryTableMiscellaneous) : "") +
+         ((flags & InventoryFormatter::HtmlGenerationFlag::YEAST        ) ? getTable(InventoryFormatter::HtmlGenerationFlag::YEAST        , createInventoryTableYeast        ) : "");
 
       // If user selects no printout or if there are no inventory for the selected ingredients
       if (result.size() == 0) {
@@ -268,8 +272,75 @@ namespace {
 ///   return (static_cast<int>(a) & static_cast<int>(b));
 ///}
 
-QString InventoryFormatter::createInventoryHtml(HtmlGenerationFlags flags) {
+// This private implementation class holds all private non-virtual members of TableCache
+class InventoryFormatter::TableCache::impl {
+public:
+   impl() :
+      m_tables{},
+      m_displaySettingsGeneration{CellDataCache::currentDisplaySettingsGeneration()},
+      m_connectionContext{} {
+      this->watch<InventoryFermentable, Fermentable>(HtmlGenerationFlag::FERMENTABLES );
+      this->watch<InventoryHop        , Hop        >(HtmlGenerationFlag::HOPS         );
+      this->watch<InventoryMisc       , Misc       >(HtmlGenerationFlag::MISCELLANEOUS);
+      this->watch<InventoryYeast      , Yeast      >(HtmlGenerationFlag::YEAST        );
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Throw away the cached \c table whenever anything it could have been built from changes.  The connections
+    *        are made with \c m_connectionContext as context object, so they go away with us.
+    */
+   template<class InventoryClass, class IngredientClass>
+   void watch(HtmlGenerationFlag const table) {
+      auto invalidate = [this, table]() { this->m_tables.remove(table); return; };
+      auto & inventoryStore  = ObjectStoreTyped<InventoryClass >::getInstance();
+      auto & ingredientStore = ObjectStoreTyped<IngredientClass>::getInstance();
+      QObject::connect(&inventoryStore , &ObjectStoreTyped<InventoryClass >::signalObjectInserted , &this->m_connectionContext, invalidate);
+      QObject::connect(&inventoryStore , &ObjectStoreTyped<InventoryClass >::signalObjectDeleted  , &this->m_connectionContext, invalidate);
+      QObject::connect(&inventoryStore , &ObjectStoreTyped<InventoryClass >::signalPropertyChanged, &this->m_connectionContext, invalidate);
+      QObject::connect(&ingredientStore, &ObjectStoreTyped<IngredientClass>::signalObjectInserted , &this->m_connectionContext, invalidate);
+      QObject::connect(&ingredientStore, &ObjectStoreTyped<IngredientClass>::signalObjectDeleted  , &this->m_connectionContext, invalidate);
+      QObject::connect(&ingredientStore, &ObjectStoreTyped<IngredientClass>::signalPropertyChanged, &this->m_connectionContext, invalidate);
+      return;
+   }
+
+   QString getTable(HtmlGenerationFlag const table, QString (*createTable)()) {
+      unsigned int const currentGeneration = CellDataCache::currentDisplaySettingsGeneration();
+      if (this->m_displaySettingsGeneration != currentGeneration) {
+         this->m_tables.clear();
+         this->m_displaySettingsGeneration = currentGeneration;
+      }
+
+      auto cached = this->m_tables.constFind(table);
+      if (cached == this->m_tables.cend()) {
+         cached = this->m_tables.insert(table, createTable());
+      }
+      return *cached;
+   }
+
+   //! Tables we have generated and not since invalidated
+   QMap<HtmlGenerationFlag, QString> m_tables;
+   //! The display settings that \c m_tables were generated with
+   unsigned int m_displaySettingsGeneration;
+   //! Context object for our signal connections
+   QObject m_connectionContext;
+};
+
+InventoryFormatter::TableCache::TableCache() : pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+InventoryFormatter::TableCache::~TableCache() = default;
+
+QString InventoryFormatter::createInventoryHtml(HtmlGenerationFlags flags, TableCache * cache) {
+   auto getTable = [cache](HtmlGenerationFlag const table, QString (*createTable)()) {
+      return cache ? cache->pimpl->getTable(table, createTable) : createTable();
+   };
    return createInventoryHeader() +
-          createInventoryBody(flags) +
+          createInventoryBody(flags, getTable) +
           createInventoryFooter();
 }
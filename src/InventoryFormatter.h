@@ -20,6 +20,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory> // For PImpl
 
 #include <QFlags> // For Q_DECLARE_FLAGS
 
@@ -59,12 +60,35 @@ namespace InventoryFormatter {
     */
 //   bool operator&(HtmlGenerationFlags a, HtmlGenerationFlags b);
 
+   /**
+    * \brief Each inventory table means walking every inventory object of the relevant type, and the print preview asks
+    *        for them every time one of its checkboxes changes.  An instance of this class holds on to the tables it has
+    *        generated until something is inserted, deleted or modified in the inventory or ingredient object store a
+    *        table is built from, or until the display settings change (see \c CellDataCache::displaySettingsChanged).
+    *
+    *        Like the object stores, this is only intended to be used on the GUI thread.
+    */
+   class TableCache {
+   public:
+      TableCache();
+      ~TableCache();
+
+   private:
+      friend QString createInventoryHtml(HtmlGenerationFlags flags, TableCache * cache);
+
+      // Private implementation details - see https://herbsutter.com/gotw/_100/
+      class impl;
+      std::unique_ptr<impl> pimpl;
+   };
+
    /**
     * @brief Create a Inventory HTML for export
     *
+    * @param cache If not \c nullptr, tables are served from, and added to, this cache
+    *
     * @return QString containing the HTML code for the inventory tables.
     */
-   QString createInventoryHtml(HtmlGenerationFlags flags);
+   QString createInventoryHtml(HtmlGenerationFlags flags, TableCache * cache = nullptr);
 
 }
 
@@ -26,13 +26,14 @@
 #include <QDir>
 #include <QLibraryInfo>
 #include <QLocale>
-#include <QRegularExpression>
 #include <QTranslator>
 
 #include "Application.h"
+#include "measurement/AmountParser.h"
 #include "model/NamedEntity.h"
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
+#include "utils/CellDataCache.h"
 
 //
 // Anonymous namespace for constants, global variables and functions used only in this file
@@ -215,6 +216,7 @@ QLocale const & Localization::getLocale() {
 
 void Localization::setDateFormat(NumericDateFormat newDateFormat) {
    dateFormat = newDateFormat;
+   CellDataCache::displaySettingsChanged();
    return;
 }
 
@@ -314,6 +316,7 @@ void Localization::setLanguage(QLocale const & newLanguageLocale) {
       currentTwoLetterLanguageCode.truncate(2);
    }
    qDebug() << Q_FUNC_INFO << "currentTwoLetterLanguageCode" << currentTwoLetterLanguageCode;
+   CellDataCache::displaySettingsChanged();
    return;
 }
 
@@ -360,18 +363,8 @@ QString Localization::getSystemLanguage() {
 }
 
 bool Localization::hasUnits(QString qstr) {
-   QString decimal = QRegularExpression::escape(Localization::getLocale().decimalPoint());
-   QString grouping = QRegularExpression::escape(Localization::getLocale().groupSeparator());
-
-   QRegularExpression amtUnit("((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*(\\w+)?");
-   QRegularExpressionMatch match = amtUnit.match(qstr);
-
-   // We could use hasCaptured here, but for debugging it's helpful to be able to show what we matched.
-   QString const units = match.captured(2);
-   bool const result = units.size() > 0;
-   qDebug() << Q_FUNC_INFO << qstr << (result ? "has" : "does not have") << "units:" << units;
-
-   return result;
+   // This gets called for every amount the user enters, so we don't log here
+   return Measurement::AmountParser::current()->hasUnits(qstr);
 }
 
 double Localization::toDouble(QString text, bool* ok) {
@@ -18,13 +18,22 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "Logging.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
 #include <sstream>      // For std::ostringstream
+#include <thread>
+#include <vector>
 
 //#include <stacktrace>
 #include <boost/stacktrace.hpp>
 
 #include <QApplication>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QMutex>
 #include <QMutexLocker>
 #include <QObject>
@@ -43,6 +52,26 @@ namespace {
 
    Logging::Level currentLoggingLevel = Logging::LogLevel_INFO;
 
+   /**
+    * \brief Per-category enabled flags, indexed by Logging::Category and sized from Logging::categoryDetails, so a new
+    *        category only needs adding there.  Read from whichever thread first uses a logging category, hence atomic.
+    *
+    *        Function-local static because Logging::categoryDetails is defined further down this file.
+    */
+   std::vector<std::atomic<bool>> & categoryEnabled() {
+      static std::vector<std::atomic<bool>> enabled = [](){
+         std::vector<std::atomic<bool>> flags(static_cast<std::size_t>(Logging::categoryDetails.size()));
+         for (auto & flag : flags) {
+            flag.store(true);
+         }
+         return flags;
+      }();
+      return enabled;
+   }
+
+   // The filter (if any) that was installed before ours
+   QLoggingCategory::CategoryFilter previousCategoryFilter = nullptr;
+
    // We decompose the log filename into its body and suffix for log rotation
    // The _current_ log file is always "[applicaiton name].log"
    static QString const logFilename = QString{CONFIG_APPLICATION_NAME_LC};
@@ -59,7 +88,7 @@ namespace {
 
    // This global flag controls whether, in general, we are logging to stderr or not.  Usually it's turned off for at
    // least the part of automated testing where we're generating lots of test logging.
-   bool isLoggingToStderr{true};
+   std::atomic<bool> isLoggingToStderr{true};
 
    QTextStream errStream{stderr};
    QTextStream * stream;
@@ -115,21 +144,374 @@ namespace {
       }
    }
 
+   /**
+    * \brief Everything we need to write a log message.  We capture the time and thread when the message is logged, but
+    *        leave it to whoever writes the message (usually \c AsyncLogWriter) to turn it all into a line of text.
+    *
+    *        NB: \c sourceFile comes from \c QMessageLogContext, where it is a string literal (from \c __FILE__), so it
+    *        is OK to hold on to the pointer.
+    */
+   struct LogEntry {
+      QTime          time;
+      QString        threadId;
+      Logging::Level level;
+      //! Whether the message should also go to stderr -- see \c isLoggingToStderr and \c forceStderrLogging
+      bool           toStderr;
+      QString        message;
+      char const *   sourceFile;
+      int            sourceLine;
+   };
+
+   /**
+    * \brief Append the text of a log entry, including the terminating newline, to \c output
+    */
+   void formatLogEntry(LogEntry const & entry, QString & output) {
+      Q_ASSERT(entry.level >= 0 && entry.level < Logging::levelDetails.size());
+      output.append('[').append(entry.time.toString(timeFormat)).append("] (").append(entry.threadId).append(") ");
+      output.append(QLatin1String{Logging::levelDetails.at(entry.level).name}).append(" : ").append(entry.message);
+      if (entry.sourceFile) {
+         //
+         // We don't want to log the full path of the source file, because that might contain private info about the
+         // directory structure on the machine on which the build was done.  We could just show the filename, but we'd
+         // like to show the relative path under the src directory (eg database/Database.cpp rather than just
+         // Database.cpp).  (The code here assumes there will not be any subdirectory of src that is also called src,
+         // which seems pretty reasonable.)
+         //
+         char const * sourceFile = entry.sourceFile;
+         for (char const * srcDir = std::strstr(sourceFile, "/src/"); srcDir; srcDir = std::strstr(srcDir + 1, "/src/")) {
+            sourceFile = srcDir + 5;
+         }
+         output.append("  [").append(QLatin1String{sourceFile}).append(':').append(QString::number(entry.sourceLine)).append(']');
+      }
+      output.append('\n');
+      return;
+   }
+
    //
-   // This is what actually outputs a message to the log file and/or std::cerr
+   // This is what actually outputs a message to the log file and/or std::cerr when we are not using the background
+   // writer thread (ie before Logging::initializeLogging() or after Logging::terminateLogging()).
    //
-   void doLog(const Logging::Level level, const QString message) {
-      QString logEntry = QString{"[%1] (%2) %3 : %4"}.arg(QTime::currentTime().toString(timeFormat))
-                                                     .arg(threadId)
-                                                     .arg(Logging::getStringFromLogLevel(level))
-                                                     .arg(message);
+   void doLog(LogEntry const & entry) {
+      QString logEntry;
+      formatLogEntry(entry, logEntry);
       QMutexLocker locker(&mutex);
-      if (isLoggingToStderr ||
-          forceStderrLogging) { errStream << logEntry << Qt::endl; }
-      if (stream)             {   *stream << logEntry << Qt::endl; }
+      if (entry.toStderr) { errStream << logEntry << Qt::flush; }
+      if (stream)         {   *stream << logEntry << Qt::flush; }
       return;
    }
 
+   /**
+    * \brief Bounded multi-producer queue of log entries that does not need any locks.  This is Dmitry Vyukov's
+    *        well-known bounded MPMC queue algorithm: each slot has a sequence number that tells producers and the
+    *        consumer whether it is free to be written or ready to be read.  We only have one consumer (the writer
+    *        thread), but there is no harm in the algorithm supporting more.
+    */
+   class LogQueue {
+   public:
+      //! Must be a power of 2
+      static constexpr std::size_t capacity = 8192;
+
+      LogQueue() : m_enqueuePos{0}, m_dequeuePos{0} {
+         for (std::size_t ii = 0; ii < capacity; ++ii) {
+            this->m_slots[ii].sequence.store(ii, std::memory_order_relaxed);
+         }
+         return;
+      }
+
+      /**
+       * \return \c false if the queue is full, in which case \c entry is untouched
+       */
+      bool tryPush(LogEntry & entry) {
+         std::size_t position = this->m_enqueuePos.load(std::memory_order_relaxed);
+         for (;;) {
+            Slot & slot = this->m_slots[position & (capacity - 1)];
+            std::size_t const sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t const diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+               if (this->m_enqueuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                  slot.entry = std::move(entry);
+                  slot.sequence.store(position + 1, std::memory_order_release);
+                  return true;
+               }
+               // compare_exchange_weak updated position, so just go round again
+            } else if (diff < 0) {
+               return false;
+            } else {
+               position = this->m_enqueuePos.load(std::memory_order_relaxed);
+            }
+         }
+      }
+
+      /**
+       * \return \c false if the queue is empty
+       */
+      bool tryPop(LogEntry & entry) {
+         std::size_t position = this->m_dequeuePos.load(std::memory_order_relaxed);
+         for (;;) {
+            Slot & slot = this->m_slots[position & (capacity - 1)];
+            std::size_t const sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t const diff =
+               static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (diff == 0) {
+               if (this->m_dequeuePos.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                  entry = std::move(slot.entry);
+                  slot.sequence.store(position + capacity, std::memory_order_release);
+                  return true;
+               }
+            } else if (diff < 0) {
+               return false;
+            } else {
+               position = this->m_dequeuePos.load(std::memory_order_relaxed);
+            }
+         }
+      }
+
+      //! Approximate number of entries in the queue
+      std::size_t size() const {
+         return this->m_enqueuePos.load(std::memory_order_relaxed) - this->m_dequeuePos.load(std::memory_order_relaxed);
+      }
+
+   private:
+      struct Slot {
+         std::atomic<std::size_t> sequence;
+         LogEntry entry;
+      };
+      std::array<Slot, capacity> m_slots;
+      // Keep the producer and consumer positions on separate cache lines so they don't keep invalidating each other
+      alignas(64) std::atomic<std::size_t> m_enqueuePos;
+      alignas(64) std::atomic<std::size_t> m_dequeuePos;
+   };
+
+   bool openLogFile();
+   void pruneLogFiles();
+
+   // Set on the writer thread, so we can avoid it waiting for itself
+   thread_local bool isLogWriterThread{false};
+
+   /**
+    * \brief Background thread that takes entries off a \c LogQueue and writes them to the log file and/or stderr.
+    *
+    *        Threads that log just put an entry on the queue and (usually) carry on without waiting.  The writer thread
+    *        wakes up every \c flushInterval, or sooner if a warning or error is logged or the queue is getting full,
+    *        and writes everything on the queue in batches.  The log file is only flushed when a warning or error was
+    *        written, when someone calls \c Logging::flush(), or when \c flushInterval has passed since the last flush.
+    *
+    *        The writer thread is also responsible for log rotation, which it checks after each batch.
+    */
+   class AsyncLogWriter {
+   public:
+      static constexpr std::chrono::milliseconds flushInterval{250};
+      //! Roughly how many characters we write between checks on the log file size
+      static constexpr qsizetype batchSize = 16 * 1024;
+
+      AsyncLogWriter() :
+         m_queue{},
+         m_thread{},
+         m_running{false},
+         m_wakeRequested{false},
+         m_flushRequested{false},
+         m_numPushed{0},
+         m_numWritten{0},
+         m_numFlushed{0} {
+         return;
+      }
+
+      ~AsyncLogWriter() {
+         // This is a safety net for if Logging::terminateLogging() wasn't called.  We must not destroy a joinable
+         // std::thread.
+         this->stop();
+         return;
+      }
+
+      bool isRunning() const {
+         return this->m_running.load(std::memory_order_acquire);
+      }
+
+      void start() {
+         if (this->m_running.exchange(true)) {
+            return;
+         }
+         this->m_thread = std::thread{[this]() { this->run(); }};
+         return;
+      }
+
+      //! Write out everything on the queue then stop the writer thread
+      void stop() {
+         if (!this->m_running.exchange(false)) {
+            return;
+         }
+         this->wake();
+         if (this->m_thread.joinable()) {
+            this->m_thread.join();
+         }
+         // Anything logged (by another thread) after the writer thread did its final drain needs to be written out
+         // directly.
+         LogEntry entry;
+         while (this->m_queue.tryPop(entry)) {
+            doLog(entry);
+         }
+         return;
+      }
+
+      void push(LogEntry & entry) {
+         bool const urgent = entry.level >= Logging::LogLevel_WARNING;
+         while (!this->m_queue.tryPush(entry)) {
+            // The queue is full.  If we are the writer thread (eg because openLogFile() is logging), there's no point
+            // waiting for ourselves, so write the message straight out.  Otherwise wait for the writer to catch up.
+            if (isLogWriterThread || !this->isRunning()) {
+               doLog(entry);
+               return;
+            }
+            this->wake();
+            std::this_thread::yield();
+         }
+         this->m_numPushed.fetch_add(1, std::memory_order_release);
+         if (urgent || this->m_queue.size() > LogQueue::capacity / 2) {
+            this->wake();
+         }
+         return;
+      }
+
+      //! Block until everything logged before the call has been written and flushed
+      void flush() {
+         if (isLogWriterThread || !this->isRunning()) {
+            return;
+         }
+         std::uint64_t const target = this->m_numPushed.load(std::memory_order_acquire);
+         this->m_flushRequested.store(true, std::memory_order_release);
+         this->wake();
+         std::unique_lock<std::mutex> lock{this->m_flushedMutex};
+         this->m_flushedCondition.wait(lock, [this, target]() {
+            return this->m_numFlushed.load(std::memory_order_acquire) >= target || !this->isRunning();
+         });
+         return;
+      }
+
+   private:
+      void wake() {
+         //
+         // We deliberately don't take m_wakeMutex here, so that logging threads never block on each other.  The cost
+         // is that, occasionally, a notification can arrive just before the writer thread starts waiting and get
+         // missed, but then the writer will just wake up on its next timeout.
+         //
+         this->m_wakeRequested.store(true, std::memory_order_release);
+         this->m_wakeCondition.notify_one();
+         return;
+      }
+
+      void run() {
+         isLogWriterThread = true;
+         QElapsedTimer sinceLastFlush;
+         sinceLastFlush.start();
+         for (;;) {
+            {
+               std::unique_lock<std::mutex> lock{this->m_wakeMutex};
+               this->m_wakeCondition.wait_for(lock, flushInterval, [this]() {
+                  return this->m_wakeRequested.load(std::memory_order_acquire) || !this->isRunning();
+               });
+            }
+            this->m_wakeRequested.store(false, std::memory_order_relaxed);
+            bool const stopping = !this->isRunning();
+
+            bool const flushRequested = this->m_flushRequested.exchange(false, std::memory_order_acq_rel);
+            bool const wroteUrgent = this->drain();
+            if (stopping || wroteUrgent || flushRequested || sinceLastFlush.elapsed() >= flushInterval.count()) {
+               this->flushStreams();
+               sinceLastFlush.restart();
+            }
+            if (stopping) {
+               break;
+            }
+         }
+         return;
+      }
+
+      /**
+       * \brief Write out everything on the queue
+       *
+       * \return \c true if any of the entries written was a warning or an error
+       */
+      bool drain() {
+         bool wroteUrgent = false;
+         QString fileBatch;
+         QString errBatch;
+         fileBatch.reserve(batchSize + 1024);
+         LogEntry entry;
+         for (bool more = true; more; ) {
+            std::uint64_t numInBatch = 0;
+            while ((more = this->m_queue.tryPop(entry))) {
+               qsizetype const previousSize = fileBatch.size();
+               formatLogEntry(entry, fileBatch);
+               if (entry.toStderr) {
+                  errBatch.append(QStringView{fileBatch}.sliced(previousSize));
+               }
+               wroteUrgent |= entry.level >= Logging::LogLevel_WARNING;
+               ++numInBatch;
+               if (fileBatch.size() >= batchSize) {
+                  break;
+               }
+            }
+            if (numInBatch == 0) {
+               break;
+            }
+
+            bool needsRotation = false;
+            {
+               QMutexLocker locker(&mutex);
+               if (!errBatch.isEmpty()) { errStream << errBatch; }
+               if (stream) {
+                  *stream << fileBatch;
+                  // We need to flush to know how big the file is, but, because we're writing in batches, this is
+                  // still far less often than once per message.
+                  stream->flush();
+                  needsRotation = logFile.size() >= Logging::logFileSize;
+               }
+            }
+            this->m_numWritten.fetch_add(numInBatch, std::memory_order_release);
+            fileBatch.clear();
+            errBatch.clear();
+
+            if (needsRotation) {
+               pruneLogFiles();
+               openLogFile();
+            }
+         }
+         return wroteUrgent;
+      }
+
+      void flushStreams() {
+         {
+            QMutexLocker locker(&mutex);
+            errStream.flush();
+            if (stream) {
+               stream->flush();
+            }
+         }
+         {
+            std::lock_guard<std::mutex> lock{this->m_flushedMutex};
+            this->m_numFlushed.store(this->m_numWritten.load(std::memory_order_acquire), std::memory_order_release);
+         }
+         this->m_flushedCondition.notify_all();
+         return;
+      }
+
+      LogQueue                   m_queue;
+      std::thread                m_thread;
+      std::atomic<bool>          m_running;
+      std::atomic<bool>          m_wakeRequested;
+      std::atomic<bool>          m_flushRequested;
+      std::mutex                 m_wakeMutex;
+      std::condition_variable    m_wakeCondition;
+      std::atomic<std::uint64_t> m_numPushed;
+      std::atomic<std::uint64_t> m_numWritten;
+      std::atomic<std::uint64_t> m_numFlushed;
+      std::mutex                 m_flushedMutex;
+      std::condition_variable    m_flushedCondition;
+   };
+
+   // NB: This needs to be defined after logFile, stream, etc, so that it gets destroyed before them at program exit
+   AsyncLogWriter logWriter;
+
    /**
     * \brief Generates a log file name
     */
@@ -184,12 +566,14 @@ namespace {
       // We _really_ need to see problems with opening the log file on stderr!
       TemporarilyForceStderrLogging temporarilyForceStderrLogging;
 
-      // First check if it's time to rotate the log file
-      if (logFile.size() > Logging::logFileSize) {
-         // Acquire lock due to the file mangling below.  NB: This means we do not want to use Qt logging in this
-         // block, as we'd end up attempting to acquire the same mutex in the doLog() function above!  So, any errors
-         // between here and the closing brace need to go to stderr
-         QMutexLocker locker(&mutex);
+      // Acquire lock due to the file mangling below.  NB: This means we do not want to use Qt logging whilst we hold
+      // the lock, as, if the writer thread is not running, we'd end up attempting to acquire the same mutex in the
+      // doLog() function above!  So, any errors whilst the lock is held need to go to stderr.
+      QMutexLocker locker(&mutex);
+
+      // First check if it's time to rotate the log file.  (This needs to be the same test as in the writer, otherwise a
+      // file that is exactly the maximum size would just get reopened rather than rotated.)
+      if (logFile.size() >= Logging::logFileSize) {
          // Double check that the stream is not initiated, if so, kill it.
          closeLogFile();
          if (!renameLogFileWithTimestamp(logDirectory)) {
@@ -204,23 +588,28 @@ namespace {
       logFile.setFileName(logDirectory.filePath(logFileFullName()));
       if (logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
          stream = new QTextStream(&logFile);
+         locker.unlock();
          qInfo() << Q_FUNC_INFO << "Logging to file" << QFileInfo(logFile).canonicalFilePath();
          return true;
       }
+      locker.unlock();
 
       qInfo() <<
          Q_FUNC_INFO << "Could not open log file" << QFileInfo(logFile).canonicalFilePath() <<
          "for writing.  Will try using temporary directory";
 
       // Defaults to temporary
+      locker.relock();
       logFile.setFileName(QDir::temp().filePath(logFileFullName()));
       if (logFile.open(QFile::WriteOnly | QFile::Truncate)) {
          logFile.setPermissions(QFileDevice::WriteUser | QFileDevice::ReadUser | QFileDevice::ExeUser);
          stream = new QTextStream(&logFile);
+         locker.unlock();
          qWarning() <<
             Q_FUNC_INFO << "Log file is in a temporary directory: " << QFileInfo(logFile).canonicalFilePath();
          return true;
       }
+      locker.unlock();
 
       qCritical() << Q_FUNC_INFO << "Unable to open" << QFileInfo(logFile).canonicalFilePath();
 
@@ -271,6 +660,27 @@ namespace {
          return;
       }
 
+      LogEntry entry{QTime::currentTime(),
+                     threadId,
+                     logLevelOfMessage,
+                     isLoggingToStderr || forceStderrLogging,
+                     message,
+                     context.file,
+                     context.line};
+
+      //
+      // Normally, we just queue the message for the writer thread, so that the thread doing the logging doesn't have
+      // to wait for the formatting or file I/O, or for other threads that are logging.
+      //
+      if (logWriter.isRunning()) {
+         logWriter.push(entry);
+         // If Qt is about to abort the program, we need to make sure this message gets written first
+         if (qtMsgType == QtFatalMsg) {
+            logWriter.flush();
+         }
+         return;
+      }
+
       // Check if there is a file actually set yet.  In a rare case if the logfile was not created at initialization,
       // then we won't be logging to a file, the location may not yet have been loaded from the settings, thus only logging to the stderr.
       // In this case we cannot do any of the pruning or filename generation.
@@ -282,27 +692,71 @@ namespace {
       }
 
       // Writing the actual log
-      //
-      // QMessageLogContext members are a bit hard to find in Qt documentation so noted here:
-      //    category : const char *
-      //    file : const char *      -- full path of the source file
-      //    function : const char *  -- same as what gets written out by Q_FUNC_INFO
-      //    line : int
-      //    version : int
-      //
-      // We don't want to log the full path of the source file, because that might contain private info about the
-      // directory structure on the machine on which the build was done.  We could just show the filename with:
-      //    QString sourceFile = QFileInfo(context.file).fileName();
-      // But we'd like to show the relative path under the src directory (eg database/Database.cpp rather than just
-      // Database.cpp).  (The code here assumes there will not be any subdirectory of src that is also called src,
-      // which seems pretty reasonable.)
-      QString sourceFile = QString{context.file}.split("/src/").last();
-      doLog(logLevelOfMessage, QString("%1  [%2:%3]").arg(message).arg(sourceFile).arg(context.line));
+      doLog(entry);
       return;
    }
 
 }
 
+Q_LOGGING_CATEGORY(logDb           , DEF_CONFIG_APPLICATION_NAME_LC ".db"           )
+Q_LOGGING_CATEGORY(logCalc         , DEF_CONFIG_APPLICATION_NAME_LC ".calc"         )
+Q_LOGGING_CATEGORY(logSerialization, DEF_CONFIG_APPLICATION_NAME_LC ".serialization")
+Q_LOGGING_CATEGORY(logUi           , DEF_CONFIG_APPLICATION_NAME_LC ".ui"           )
+Q_LOGGING_CATEGORY(logTrees        , DEF_CONFIG_APPLICATION_NAME_LC ".trees"        )
+
+QVector<Logging::CategoryDetail> const Logging::categoryDetails{
+   { Logging::Category::Database     , "db"           , QObject::tr("Database")                            },
+   { Logging::Category::Calculation  , "calc"         , QObject::tr("Recipe calculations")                 },
+   { Logging::Category::Serialization, "serialization", QObject::tr("Import and export")                   },
+   { Logging::Category::UserInterface, "ui"           , QObject::tr("User interface")                      },
+   { Logging::Category::Trees        , "trees"        , QObject::tr("Recipe and ingredient trees")         },
+};
+
+namespace {
+   /**
+    * \brief Installed with \c QLoggingCategory::installFilter, this is called by Qt for each logging category when it is
+    *        first used and whenever we call \c refreshLoggingCategories().  For our own categories, we turn message
+    *        types on and off according to the logging level and which categories are enabled, which is what makes
+    *        \c qCDebug etc skip evaluating their arguments.  Other categories (eg Qt's own) are left to the previous
+    *        filter.
+    *
+    *        NB: Qt calls this from inside the \c QLoggingCategory constructor, so we must identify categories by name
+    *        rather than by calling, eg, \c logDb(), which would be a recursive static initialisation.
+    */
+   void loggingCategoryFilter(QLoggingCategory * loggingCategory) {
+      if (previousCategoryFilter) {
+         previousCategoryFilter(loggingCategory);
+      }
+
+      QLatin1String const name{loggingCategory->categoryName()};
+      QLatin1String const prefix{DEF_CONFIG_APPLICATION_NAME_LC "."};
+      if (!name.startsWith(prefix)) {
+         return;
+      }
+      QLatin1String const shortName = name.sliced(prefix.size());
+      for (auto const & detail : Logging::categoryDetails) {
+         if (shortName == QLatin1String{detail.name}) {
+            loggingCategory->setEnabled(
+               QtDebugMsg,
+               currentLoggingLevel <= Logging::LogLevel_DEBUG && Logging::isCategoryEnabled(detail.category)
+            );
+            loggingCategory->setEnabled(QtInfoMsg   , currentLoggingLevel <= Logging::LogLevel_INFO   );
+            loggingCategory->setEnabled(QtWarningMsg, currentLoggingLevel <= Logging::LogLevel_WARNING);
+            return;
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Get Qt to re-run \c loggingCategoryFilter on all logging categories.  Setting the filter rules (to the same
+    *        empty set we always use) is the documented way to do this.
+    */
+   void refreshLoggingCategories() {
+      QLoggingCategory::setFilterRules(QString{});
+      return;
+   }
+}
 
 QVector<Logging::LevelDetail> const Logging::levelDetails{
    { Logging::LogLevel_DEBUG,   "DEBUG",   QObject::tr("Detailed (for debugging)")},
@@ -338,6 +792,23 @@ Logging::Level Logging::getLogLevel() {
 void Logging::setLogLevel(Level newLevel) {
    currentLoggingLevel = newLevel;
    PersistentSettings::insert(PersistentSettings::Names::LoggingLevel, Logging::getStringFromLogLevel(currentLoggingLevel));
+   refreshLoggingCategories();
+   return;
+}
+
+bool Logging::isCategoryEnabled(Logging::Category const category) {
+   return categoryEnabled().at(static_cast<std::size_t>(category)).load(std::memory_order_relaxed);
+}
+
+void Logging::setCategoryEnabled(Logging::Category const category, bool const enabled) {
+   categoryEnabled().at(static_cast<std::size_t>(category)).store(enabled, std::memory_order_relaxed);
+   for (auto const & detail : Logging::categoryDetails) {
+      if (detail.category == category) {
+         PersistentSettings::insert(detail.name, enabled, *PersistentSettings::Names::LoggingCategories);
+         break;
+      }
+   }
+   refreshLoggingCategories();
    return;
 }
 
@@ -365,6 +836,14 @@ bool Logging::initializeLogging() {
          std::optional<QDir>(PersistentSettings::value(PersistentSettings::Names::LogDirectory).toString()) : std::optional<QDir>(std::nullopt)
    );
 
+   logWriter.start();
+   for (auto const & detail : Logging::categoryDetails) {
+      categoryEnabled().at(static_cast<std::size_t>(detail.category)).store(
+         PersistentSettings::value(detail.name, true, *PersistentSettings::Names::LoggingCategories).toBool()
+      );
+   }
+   previousCategoryFilter = QLoggingCategory::installFilter(loggingCategoryFilter);
+
    qInstallMessageHandler(logMessageHandler);
    qDebug() << Q_FUNC_INFO << "Logging initialized.  Logs will be written to" << logDirectory.absolutePath();
 
@@ -511,7 +990,14 @@ QFileInfoList Logging::getLogFileList() {
 }
 
 
+void Logging::flush() {
+   logWriter.flush();
+   return;
+}
+
 void Logging::terminateLogging() {
+   // Write out anything still queued, and stop the writer thread, before we close the log file
+   logWriter.stop();
    QMutexLocker locker(&mutex);
    closeLogFile();
    return;
@@ -23,6 +23,7 @@
 
 #include <QDir>
 #include <QFileInfoList>
+#include <QLoggingCategory>
 #include <QString>
 #include <QVector>
 
@@ -86,6 +87,51 @@ namespace Logging {
     */
    extern void setLogLevel(Level newLevel);
 
+   /**
+    * \brief Debug logging in the busiest parts of the code is split into categories, each of which can be turned on
+    *        and off at run-time (in addition to the overall logging level).  Code in these areas should log debug
+    *        messages with, eg, \c qCDebug(logCalc) rather than \c qDebug().  When a category is disabled (or the logging
+    *        level is above \c LogLevel_DEBUG), \c qCDebug does not even evaluate the things being logged, so the
+    *        logging costs almost nothing.
+    *
+    *        Each category here has a corresponding \c QLoggingCategory declared at the end of this file.
+    */
+   enum class Category {
+      //! Database access and object stores
+      Database,
+      //! Recipe calculations, algorithms and units of measurement
+      Calculation,
+      //! Import and export (BeerXML, BeerJSON)
+      Serialization,
+      //! Main window, dialogs and other widgets
+      UserInterface,
+      //! Tree views of recipes, ingredients, etc
+      Trees
+   };
+
+   /**
+    * \brief User-friendly info about logging categories.  Similar to \c LevelDetail.  The name is used in the config file
+    *        and, prefixed with the application name, as the name of the \c QLoggingCategory.
+    */
+   struct CategoryDetail {
+      Category category;
+      char const * name;
+      QString description;
+   };
+   extern QVector<CategoryDetail> const categoryDetails;
+
+   /**
+    * \return \c true if debug logging is enabled for the specified category.  NB: Debug messages are only logged if the
+    *         category is enabled \b and the logging level is \c LogLevel_DEBUG.
+    */
+   extern bool isCategoryEnabled(Category const category);
+
+   /**
+    * \brief Turn debug logging for the specified category on or off.  The setting is remembered for the next run of the
+    *        program.
+    */
+   extern void setCategoryEnabled(Category const category, bool const enabled);
+
    /**
     * \return \b true if we are logging in the config dir (the default), \b false if we are logging in a directory
     *         configured via \c Logging::setDirectory()
@@ -158,7 +204,14 @@ namespace Logging {
    extern QFileInfoList getLogFileList();
 
    /**
-    * \brief Terminate logging
+    * \brief Log messages are written to the log file (and stderr) asynchronously by a background thread.  Call this to
+    *        wait until everything logged so far, by any thread, has been written out (eg before examining the log
+    *        files).
+    */
+   extern void flush();
+
+   /**
+    * \brief Terminate logging.  Any messages still waiting to be written are written out first.
     */
    extern void terminateLogging();
 
@@ -184,4 +237,13 @@ namespace Logging {
 //   return stream;
 //}
 
+//
+// See Logging::Category
+//
+Q_DECLARE_LOGGING_CATEGORY(logDb)
+Q_DECLARE_LOGGING_CATEGORY(logCalc)
+Q_DECLARE_LOGGING_CATEGORY(logSerialization)
+Q_DECLARE_LOGGING_CATEGORY(logUi)
+Q_DECLARE_LOGGING_CATEGORY(logTrees)
+
 #endif
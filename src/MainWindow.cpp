@@ -39,13 +39,18 @@
 #endif
 
 #include <algorithm>
+#include <initializer_list>
 #include <memory>
 #include <mutex> // For std::once_flag etc
 
 #include <QAction>
 #include <QBrush>
+#include <QDialog>
+#include <QDialogButtonBox>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileDialog>
+#include <QHash>
 #include <QIcon>
 #include <QInputDialog>
 #include <QIODevice>
@@ -56,11 +61,14 @@
 #include <QMessageBox>
 #include <QPen>
 #include <QPixmap>
+#include <QPlainTextEdit>
+#include <QPushButton>
 #include <QScreen>
 #include <QSize>
 #include <QString>
 #include <QTextStream>
 #include <QtGui>
+#include <QTimer>
 #include <QToolButton>
 #include <QUndoStack>
 #include <QUrl>
@@ -75,6 +83,7 @@
 #include "Application.h"
 #include "BrewNoteWidget.h"
 #include "BtDatePopup.h"
+#include "Logging.h"
 #include "model/Folder.h"
 #include "BtHorizontalTabs.h"
 #include "BtTabWidget.h"
@@ -113,6 +122,7 @@
 #include "config.h"
 #include "database/Database.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/QueryStats.h"
 #include "editors/BoilEditor.h"
 #include "editors/BoilStepEditor.h"
 #include "editors/EquipmentEditor.h"
@@ -163,6 +173,7 @@
 #include "undoRedo/UndoableAddOrRemove.h"
 #include "undoRedo/UndoableAddOrRemoveList.h"
 #include "utils/BtStringConst.h"
+#include "utils/LazyWidget.h"
 #include "utils/VeriTable.h"
 #include "utils/OptionalHelpers.h"
 
@@ -250,6 +261,84 @@ namespace {
 
       return;
    }
+
+   /**
+    * \brief The parts of the recipe panel on the main window that \c MainWindow::refreshRecipePanel can update
+    *        independently of each other.  Used as bit flags.
+    */
+   enum RecipePanelPart : unsigned int {
+      RecipePanel_None              = 0u,
+      RecipePanel_Name              = 1u <<  0,
+      RecipePanel_BatchSize         = 1u <<  1,
+      RecipePanel_Efficiency        = 1u <<  2,
+      RecipePanel_BoilInfo          = 1u <<  3,
+      RecipePanel_BoilGravity       = 1u <<  4,
+      RecipePanel_Og                = 1u <<  5,
+      RecipePanel_Fg                = 1u <<  6,
+      RecipePanel_Abv               = 1u <<  7,
+      RecipePanel_Ibu               = 1u <<  8,
+      RecipePanel_IbuGu             = 1u <<  9,
+      RecipePanel_Color             = 1u << 10,
+      RecipePanel_BatchSizeRange    = 1u << 11,
+      RecipePanel_BoilSizeRange     = 1u << 12,
+      RecipePanel_Calories          = 1u << 13,
+      RecipePanel_MashSteps         = 1u << 14,
+      RecipePanel_BoilSteps         = 1u << 15,
+      RecipePanel_FermentationSteps = 1u << 16,
+      // The hop table refresh includes a recalculation, so we only do it when the caller asks for everything
+      RecipePanel_HopTable          = 1u << 17,
+      RecipePanel_AllFields         = ~RecipePanel_HopTable,
+      RecipePanel_All               = ~0u
+   };
+
+   /**
+    * \brief Which parts of the recipe panel need to be refreshed when the named property of the \c Recipe (or its
+    *        \c Boil) changes.  Properties that are not in the map cause a refresh of every field, so it is always safe
+    *        to leave a property out; properties we know are not shown on the panel at all map to \c RecipePanel_None.
+    */
+   unsigned int recipePanelPartsFor(QString const & propertyName) {
+      static QHash<QString, unsigned int> const propertyToParts {
+         {*PropertyNames::Recipe::name             , RecipePanel_Name                                                   },
+         {*PropertyNames::Recipe::batchSize_l      , RecipePanel_BatchSize | RecipePanel_BatchSizeRange                 },
+         {*PropertyNames::Recipe::finalVolume_l    , RecipePanel_BatchSizeRange                                         },
+         {*PropertyNames::Recipe::efficiency_pct   , RecipePanel_Efficiency                                             },
+         {*PropertyNames::Recipe::boil             , RecipePanel_BoilInfo | RecipePanel_BoilSizeRange |
+                                                     RecipePanel_BoilSteps                                              },
+         {*PropertyNames::Boil::preBoilSize_l      , RecipePanel_BoilInfo | RecipePanel_BoilSizeRange                   },
+         {*PropertyNames::Boil::boilTime_mins      , RecipePanel_BoilInfo                                               },
+         {*PropertyNames::StepOwnerBase::steps     , RecipePanel_BoilSteps                                              },
+         {*PropertyNames::Recipe::boilVolume_l     , RecipePanel_BoilSizeRange                                          },
+         {*PropertyNames::Recipe::boilGrav         , RecipePanel_BoilGravity                                            },
+         {*PropertyNames::Recipe::og               , RecipePanel_Og | RecipePanel_IbuGu                                 },
+         {*PropertyNames::Recipe::fg               , RecipePanel_Fg                                                     },
+         {*PropertyNames::Recipe::ABV_pct          , RecipePanel_Abv                                                    },
+         {*PropertyNames::Recipe::IBU              , RecipePanel_Ibu | RecipePanel_IbuGu                                },
+         {*PropertyNames::Recipe::color_srm        , RecipePanel_Color                                                  },
+         {*PropertyNames::Recipe::style            , RecipePanel_Og | RecipePanel_Fg | RecipePanel_Color                },
+         {*PropertyNames::Recipe::caloriesPer33cl  , RecipePanel_Calories                                               },
+         {*PropertyNames::Recipe::caloriesPerLiter , RecipePanel_Calories                                               },
+         {*PropertyNames::Recipe::caloriesPerUs12oz, RecipePanel_Calories                                               },
+         {*PropertyNames::Recipe::caloriesPerUsPint, RecipePanel_Calories                                               },
+         {*PropertyNames::Recipe::mash             , RecipePanel_MashSteps                                              },
+         {*PropertyNames::Recipe::fermentation     , RecipePanel_FermentationSteps                                      },
+         // These are shown elsewhere (eg RecipeExtrasWidget), not on the recipe panel
+         {*PropertyNames::Recipe::age_days         , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::ageTemp_c        , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::asstBrewer       , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::brewer           , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::carbonationTemp_c, RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::carbonation_vols , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::date             , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::forcedCarbonation, RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::kegPrimingFactor , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::notes            , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::primingSugarEquiv, RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::primingSugarName , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::tasteNotes       , RecipePanel_None                                                   },
+         {*PropertyNames::Recipe::tasteRating      , RecipePanel_None                                                   },
+      };
+      return propertyToParts.value(propertyName, RecipePanel_AllFields);
+   }
 }
 
 // This private implementation class holds all private non-virtual members of MainWindow
@@ -262,7 +351,56 @@ public:
       m_hopAdditionsVeriTable        {},
       m_miscAdditionsVeriTable       {},
       m_yeastAdditionsVeriTable      {},
-      m_saltAdditionsVeriTable       {} {
+      m_saltAdditionsVeriTable       {},
+      m_aboutDialog               {self, "AboutDialog"},
+      m_alcoholTool               {self, "AlcoholTool"},
+      m_boilCatalog               {self, "BoilCatalog"},
+      m_btDatePopup               {self, "BtDatePopup"},
+      m_converterTool             {self, "ConverterTool"},
+      m_equipmentCatalog          {self, "EquipmentCatalog"},
+      m_fermentableCatalog        {self, "FermentableCatalog"},
+      m_fermentationCatalog       {self, "FermentationCatalog"},
+      m_helpDialog                {self, "HelpDialog"},
+      m_hopCatalog                {self, "HopCatalog"},
+      m_hydrometerTool            {self, "HydrometerTool"},
+      m_inventoryWindow           {self, "InventoryWindow"},
+      m_mashCatalog               {self, "MashCatalog"},
+      m_mashDesigner              {self, "MashDesigner"},
+      m_mashWizard                {self, "MashWizard"},
+      m_miscCatalog               {self, "MiscCatalog"},
+      m_ogAdjuster                {self, "OgAdjuster"},
+      m_pitchDialog               {self, "PitchDialog"},
+      m_primingDialog             {self, "PrimingDialog"},
+      m_printAndPreviewDialog     {self, "PrintAndPreviewDialog"},
+      m_refractoDialog            {self, "RefractoDialog"},
+      m_saltCatalog               {self, "SaltCatalog"},
+      m_recipeScaler              {self, "ScaleRecipeTool"},
+      m_strikeWaterDialog         {self, "StrikeWaterDialog"},
+      m_styleCatalog              {self, "StyleCatalog"},
+      m_timerMainDialog           {self, "TimerMainDialog"},
+      m_waterCatalog              {self, "WaterCatalog"},
+      m_waterProfileAdjustmentTool{self, "WaterProfileAdjustmentTool"},
+      m_yeastCatalog              {self, "YeastCatalog"},
+      m_prewarmQueue                 {},
+      m_prewarmTimer                 {},
+      m_startupTimer                 {},
+      m_catalogsCanAddToRecipe       {true},
+      m_dirtyRecipePanelParts        {0},
+      m_numChangesSinceRefresh       {0},
+      m_numRecipePanelRefreshes      {0},
+      m_recipePanelRefreshTimer      {} {
+      //
+      // A single user edit typically results in a lot of change notifications from the Recipe (eg one for each value
+      // that recalcAll() updates).  Rather than refresh the recipe panel for each one, we note which parts of the panel
+      // need updating and then do them all at once the next time the event loop runs.
+      //
+      this->m_recipePanelRefreshTimer.setSingleShot(true);
+      this->m_recipePanelRefreshTimer.setInterval(0);
+      connect(&this->m_recipePanelRefreshTimer, &QTimer::timeout, &this->m_self, [this]() {
+         this->m_self.refreshRecipePanel();
+      });
+
+      this->m_startupTimer.start();
       return;
    }
 
@@ -296,6 +434,23 @@ public:
       return;
    }
 
+   /**
+    * \brief Note that the parts of the recipe panel affected by a change to the named property need to be refreshed,
+    *        and make sure that a refresh will happen once control returns to the event loop.
+    */
+   void scheduleRecipePanelRefresh(QString const & propertyName) {
+      unsigned int const parts = recipePanelPartsFor(propertyName);
+      ++this->m_numChangesSinceRefresh;
+      if (parts == 0) {
+         return;
+      }
+      this->m_dirtyRecipePanelParts |= parts;
+      if (!this->m_recipePanelRefreshTimer.isActive()) {
+         this->m_recipePanelRefreshTimer.start();
+      }
+      return;
+   }
+
    //! \brief Previously called setupContextMenu
    void setupTreeViews() {
 
@@ -314,22 +469,40 @@ public:
       m_self.treeView_water       ->init(*this->m_waterEditor       );
 
       connect(m_self.treeView_recipe, &RecipeTreeView::recipeSpawn, &m_self, &MainWindow::versionedRecipe);
+
+      //
+      // The search box applies to all the trees, so that it doesn't matter which tab the user switches to.  Each search
+      // is a lookup in the relevant SearchIndex, so this is quick.
+      //
+      connect(m_self.lineEdit_treeSearch, &QLineEdit::textChanged, &m_self, [this](QString const & searchText) {
+         for (TreeView * treeView : std::initializer_list<TreeView *>{m_self.treeView_recipe      ,
+                                                                      m_self.treeView_style       ,
+                                                                      m_self.treeView_equipment   ,
+                                                                      m_self.treeView_mash        ,
+                                                                      m_self.treeView_boil        ,
+                                                                      m_self.treeView_fermentation,
+                                                                      m_self.treeView_fermentable ,
+                                                                      m_self.treeView_hop         ,
+                                                                      m_self.treeView_misc        ,
+                                                                      m_self.treeView_salt        ,
+                                                                      m_self.treeView_yeast       ,
+                                                                      m_self.treeView_water       }) {
+            treeView->filterItems(searchText);
+         }
+      });
       return;
    }
 
    /**
     * \brief Create the dialogs, including the file dialogs
     *
-    *        Most dialogs are initialized in here. That should include any initial configurations as well.
+    *        The editors are created here because tree views and tables need them straight away.  Everything else
+    *        (catalogs, tools, etc) is created on first use (see \c LazyWidget), so here we just register what needs to
+    *        be done to each one when it is created, and queue up the ones we want to pre-warm in idle time.
     */
    void setupDialogs() {
-      m_aboutDialog                = std::make_unique<AboutDialog               >(&m_self);
-      m_helpDialog                 = std::make_unique<HelpDialog                >(&m_self);
-      m_equipmentCatalog           = std::make_unique<EquipmentCatalog          >(&m_self);
       m_equipmentEditor            = std::make_unique<EquipmentEditor           >(&m_self);
-      m_fermentableCatalog         = std::make_unique<FermentableCatalog        >(&m_self);
       m_fermentableEditor          = std::make_unique<FermentableEditor         >(&m_self);
-      m_hopCatalog                 = std::make_unique<HopCatalog                >(&m_self);
       m_hopEditor                  = std::make_unique<HopEditor                 >(&m_self);
       m_mashEditor                 = std::make_unique<MashEditor                >(&m_self);
       m_mashStepEditor             = std::make_unique<MashStepEditor            >(&m_self);
@@ -337,39 +510,71 @@ public:
       m_boilStepEditor             = std::make_unique<BoilStepEditor            >(&m_self);
       m_fermentationEditor         = std::make_unique<FermentationEditor        >(&m_self);
       m_fermentationStepEditor     = std::make_unique<FermentationStepEditor    >(&m_self);
-      m_mashWizard                 = std::make_unique<MashWizard                >(&m_self);
-      m_miscCatalog                = std::make_unique<MiscCatalog               >(&m_self);
       m_miscEditor                 = std::make_unique<MiscEditor                >(&m_self);
-      m_saltCatalog                = std::make_unique<SaltCatalog               >(&m_self);
-      m_waterCatalog               = std::make_unique<WaterCatalog              >(&m_self);
-      m_inventoryWindow            = std::make_unique<InventoryWindow           >(&m_self);
       m_saltEditor                 = std::make_unique<SaltEditor                >(&m_self);
-      m_styleCatalog               = std::make_unique<StyleCatalog              >(&m_self);
       m_styleEditor                = std::make_unique<StyleEditor               >(&m_self);
-      m_yeastCatalog               = std::make_unique<YeastCatalog              >(&m_self);
       m_yeastEditor                = std::make_unique<YeastEditor               >(&m_self);
       m_optionDialog               = std::make_unique<OptionDialog              >(&m_self);
-      m_recipeScaler               = std::make_unique<ScaleRecipeTool           >(&m_self);
       m_recipeFormatter            = std::make_unique<RecipeFormatter           >(&m_self);
-      m_printAndPreviewDialog      = std::make_unique<PrintAndPreviewDialog     >(&m_self);
-      m_ogAdjuster                 = std::make_unique<OgAdjuster                >(&m_self);
-      m_converterTool              = std::make_unique<ConverterTool             >(&m_self);
-      m_hydrometerTool             = std::make_unique<HydrometerTool            >(&m_self);
-      m_alcoholTool                = std::make_unique<AlcoholTool               >(&m_self);
-      m_timerMainDialog            = std::make_unique<TimerMainDialog           >(&m_self);
-      m_primingDialog              = std::make_unique<PrimingDialog             >(&m_self);
-      m_strikeWaterDialog          = std::make_unique<StrikeWaterDialog         >(&m_self);
-      m_refractoDialog             = std::make_unique<RefractoDialog            >(&m_self);
-      m_mashDesigner               = std::make_unique<MashDesigner              >(&m_self);
-      m_pitchDialog                = std::make_unique<PitchDialog               >(&m_self);
-      m_btDatePopup                = std::make_unique<BtDatePopup               >(&m_self);
-      m_waterProfileAdjustmentTool = std::make_unique<WaterProfileAdjustmentTool>(&m_self);
       m_waterEditor                = std::make_unique<WaterEditor               >(&m_self);
       m_ancestorDialog             = std::make_unique<AncestorDialog            >(&m_self);
-      m_mashCatalog                = std::make_unique<MashCatalog               >(&m_self);
-      m_boilCatalog                = std::make_unique<BoilCatalog               >(&m_self);
-      m_fermentationCatalog        = std::make_unique<FermentationCatalog       >(&m_self);
 
+      // Tools that work on the current recipe need to be told what it is when they are created.  Thereafter,
+      // MainWindow::setRecipe keeps them up-to-date.
+      this->m_mashWizard  .onCreate([this](MashWizard      & tool) { if (this->m_recipeObs) { tool.setRecipe(this->m_recipeObs); } });
+      this->m_ogAdjuster  .onCreate([this](OgAdjuster      & tool) { if (this->m_recipeObs) { tool.setRecipe(this->m_recipeObs); } });
+      this->m_mashDesigner.onCreate([this](MashDesigner    & tool) { if (this->m_recipeObs) { tool.setRecipe(this->m_recipeObs); } });
+      this->m_recipeScaler.onCreate([this](ScaleRecipeTool & tool) { if (this->m_recipeObs) { tool.setRecipe(this->m_recipeObs); } });
+
+      // Similarly, catalogs that can add to the recipe need to know whether it is locked.  (NB: Don't yet support add
+      // to recipe from water catalog.)
+      this->m_fermentableCatalog.onCreate([this](FermentableCatalog & catalog) { catalog.setEnableAddToRecipe(this->m_catalogsCanAddToRecipe); });
+      this->m_hopCatalog        .onCreate([this](HopCatalog         & catalog) { catalog.setEnableAddToRecipe(this->m_catalogsCanAddToRecipe); });
+      this->m_miscCatalog       .onCreate([this](MiscCatalog        & catalog) { catalog.setEnableAddToRecipe(this->m_catalogsCanAddToRecipe); });
+      this->m_yeastCatalog      .onCreate([this](YeastCatalog       & catalog) { catalog.setEnableAddToRecipe(this->m_catalogsCanAddToRecipe); });
+      this->m_saltCatalog       .onCreate([this](SaltCatalog        & catalog) { catalog.setEnableAddToRecipe(this->m_catalogsCanAddToRecipe); });
+
+      //
+      // The catalogs are the most expensive things to create and the most likely to be opened, so we pre-warm them
+      // once the main window is up.  We start with the ones behind the "add ingredient" buttons.  The tools and
+      // dialogs are cheap enough to just create on demand.
+      //
+      this->m_prewarmQueue = {
+         &this->m_fermentableCatalog ,
+         &this->m_hopCatalog         ,
+         &this->m_miscCatalog        ,
+         &this->m_yeastCatalog       ,
+         &this->m_saltCatalog        ,
+         &this->m_equipmentCatalog   ,
+         &this->m_styleCatalog       ,
+         &this->m_waterCatalog       ,
+         &this->m_mashCatalog        ,
+         &this->m_boilCatalog        ,
+         &this->m_fermentationCatalog,
+      };
+      this->m_prewarmTimer.setInterval(50);
+      m_self.connect(&this->m_prewarmTimer, &QTimer::timeout, &m_self, [this]() { this->prewarmNextLazyWidget(); });
+
+      return;
+   }
+
+   /**
+    * \brief Create the next widget in \c m_prewarmQueue (if any).  We do one per timer tick so that we never block the
+    *        event loop for long.
+    */
+   void prewarmNextLazyWidget() {
+      while (!this->m_prewarmQueue.isEmpty()) {
+         LazyWidgetBase * lazyWidget = this->m_prewarmQueue.takeFirst();
+         // Skip anything the user has already opened
+         if (!lazyWidget->exists()) {
+            lazyWidget->prewarm();
+            qCDebug(logUi) << Q_FUNC_INFO << "Pre-warmed" << lazyWidget->name();
+            return;
+         }
+      }
+      this->m_prewarmTimer.stop();
+      qCDebug(logUi) <<
+         Q_FUNC_INFO << "Pre-warming finished" << this->m_startupTimer.elapsed() << "ms after start-up";
       return;
    }
 
@@ -412,7 +617,7 @@ public:
       // tabWidget_ingredients
       //
       auto const widgetName = QString("recipe%1Tab").arg(RA::IngredientClass::staticMetaObject.className());
-      qDebug() << Q_FUNC_INFO << widgetName;
+      qCDebug(logUi) << Q_FUNC_INFO << widgetName;
       QWidget * widget = this->m_self.tabWidget_ingredients->findChild<QWidget *>(widgetName);
       Q_ASSERT(widget);
       this->m_self.tabWidget_ingredients->setCurrentWidget(widget);
@@ -486,13 +691,13 @@ public:
       //
       auto const dpiX = this->m_self.logicalDpiX();
       auto const dpiY = this->m_self.logicalDpiY();
-      qDebug() << QString("Logical DPI: %1,%2.  Physical DPI: %3,%4")
+      qCDebug(logUi) << QString("Logical DPI: %1,%2.  Physical DPI: %3,%4")
          .arg(dpiX)
          .arg(dpiY)
          .arg(this->m_self.physicalDpiX())
          .arg(this->m_self.physicalDpiY());
       auto const defaultToolBarIconSize = this->m_self.toolBar->iconSize();
-      qDebug() <<
+      qCDebug(logUi) <<
          Q_FUNC_INFO << "Default toolbar icon size:" << defaultToolBarIconSize.width() << "×" <<
          defaultToolBarIconSize.height();
       this->m_self.toolBar->setIconSize(QSize(dpiX/4,dpiY/4));
@@ -502,7 +707,7 @@ public:
       // size as the toolbar ones.
       //
       auto defaultTabIconSize = this->m_self.tabWidget_Trees->iconSize();
-      qDebug() <<
+      qCDebug(logUi) <<
          Q_FUNC_INFO << "Default tab icon size:" << defaultTabIconSize.width() << "×" << defaultTabIconSize.height();
       this->m_self.tabWidget_Trees->setIconSize(QSize(dpiX/4,dpiY/4));
 
@@ -516,13 +721,13 @@ public:
       //
       // This is a bit more work to implement because its a PNG image in a QLabel object
       //
-      qDebug() <<
+      qCDebug(logUi) <<
          Q_FUNC_INFO << "Logo default size:" << this->m_self.label_Brewtarget->width() << "×" <<
          this->m_self.label_Brewtarget->height();
       this->m_self.label_Brewtarget->setScaledContents(true);
       this->m_self.label_Brewtarget->setFixedSize((265.0/66.0) * dpiX/2,  // width = 265/66 × height = 265/66 × half an inch = (265/66) × (dpiX/2)
                                                dpiY/2);                // height = half an inch = dpiY/2
-      qDebug() <<
+      qCDebug(logUi) <<
          Q_FUNC_INFO << "Logo new size:" << this->m_self.label_Brewtarget->width() << "×" <<
          this->m_self.label_Brewtarget->height();
 
@@ -569,11 +774,11 @@ public:
    void closeBrewNoteTab(BrewNote const & brewNote) const {
       BrewNoteWidget* widget = this->findBrewNoteWidget(brewNote);
       if (!widget) {
-         qDebug() << Q_FUNC_INFO << "Could not find tab for BrewNote" << brewNote;
+         qCDebug(logUi) << Q_FUNC_INFO << "Could not find tab for BrewNote" << brewNote;
          return;
       }
 
-      qDebug() << Q_FUNC_INFO << "Closing tab for BrewNote" << brewNote;
+      qCDebug(logUi) << Q_FUNC_INFO << "Closing tab for BrewNote" << brewNote;
       auto const tabIndex = this->m_self.tabWidget_recipeView->indexOf(widget);
       this->m_self.tabWidget_recipeView->removeTab(tabIndex);
 
@@ -582,7 +787,7 @@ public:
 
    //! Clean out any brew notes
    void closeAllBrewNoteTabs() const {
-      qDebug() << Q_FUNC_INFO << "Closing all BrewNote tabs";
+      qCDebug(logUi) << Q_FUNC_INFO << "Closing all BrewNote tabs";
       this->m_self.tabWidget_recipeView->setCurrentIndex(0);
 
       // Start closing from the right (highest index) down. Anything else dumps
@@ -675,59 +880,81 @@ public:
    VeriTable<RecipeAdjustmentSalt     > m_saltAdditionsVeriTable       ;
 
    // All initialised in setupDialogs
-   std::unique_ptr<AboutDialog               > m_aboutDialog           ;
-   std::unique_ptr<AlcoholTool               > m_alcoholTool           ;
    std::unique_ptr<AncestorDialog            > m_ancestorDialog        ;
-   std::unique_ptr<MashCatalog               > m_mashCatalog           ;
-   std::unique_ptr<BoilCatalog               > m_boilCatalog           ;
-   std::unique_ptr<FermentationCatalog       > m_fermentationCatalog   ;
    std::unique_ptr<BoilEditor                > m_boilEditor            ;
    std::unique_ptr<BoilStepEditor            > m_boilStepEditor        ;
-   std::unique_ptr<BtDatePopup               > m_btDatePopup           ;
-   std::unique_ptr<ConverterTool             > m_converterTool         ;
-   std::unique_ptr<EquipmentCatalog          > m_equipmentCatalog      ;
    std::unique_ptr<EquipmentEditor           > m_equipmentEditor       ;
-   std::unique_ptr<FermentableCatalog        > m_fermentableCatalog    ;
    std::unique_ptr<FermentableEditor         > m_fermentableEditor     ;
    std::unique_ptr<FermentationEditor        > m_fermentationEditor    ;
    std::unique_ptr<FermentationStepEditor    > m_fermentationStepEditor;
-   std::unique_ptr<HelpDialog                > m_helpDialog            ;
-   std::unique_ptr<HopCatalog                > m_hopCatalog            ;
    std::unique_ptr<HopEditor                 > m_hopEditor             ;
-   std::unique_ptr<HydrometerTool            > m_hydrometerTool        ;
-   std::unique_ptr<MashDesigner              > m_mashDesigner          ;
    std::unique_ptr<MashEditor                > m_mashEditor            ;
    std::unique_ptr<MashStepEditor            > m_mashStepEditor        ;
-   std::unique_ptr<MashWizard                > m_mashWizard            ;
-   std::unique_ptr<MiscCatalog               > m_miscCatalog           ;
    std::unique_ptr<MiscEditor                > m_miscEditor            ;
-   std::unique_ptr<OgAdjuster                > m_ogAdjuster            ;
    std::unique_ptr<OptionDialog              > m_optionDialog          ;
-   std::unique_ptr<PitchDialog               > m_pitchDialog           ;
-   std::unique_ptr<PrimingDialog             > m_primingDialog         ;
-   std::unique_ptr<PrintAndPreviewDialog     > m_printAndPreviewDialog ;
    std::unique_ptr<RecipeFormatter           > m_recipeFormatter       ;
-   std::unique_ptr<RefractoDialog            > m_refractoDialog        ;
-   std::unique_ptr<ScaleRecipeTool           > m_recipeScaler          ;
-   std::unique_ptr<StrikeWaterDialog         > m_strikeWaterDialog     ;
-   std::unique_ptr<SaltCatalog               > m_saltCatalog           ;
-   std::unique_ptr<WaterCatalog              > m_waterCatalog          ;
-   std::unique_ptr<InventoryWindow           > m_inventoryWindow       ;
    std::unique_ptr<SaltEditor                > m_saltEditor            ;
-   std::unique_ptr<StyleCatalog              > m_styleCatalog          ;
    std::unique_ptr<StyleEditor               > m_styleEditor           ;
-   std::unique_ptr<TimerMainDialog           > m_timerMainDialog       ;
-   std::unique_ptr<WaterProfileAdjustmentTool> m_waterProfileAdjustmentTool;
    std::unique_ptr<WaterEditor               > m_waterEditor           ;
-   std::unique_ptr<YeastCatalog              > m_yeastCatalog          ;
    std::unique_ptr<YeastEditor               > m_yeastEditor           ;
 
+   //
+   // These are only created when first needed, or when we get round to pre-warming them after start-up (see
+   // prewarmNextLazyWidget).  The catalogs in particular are expensive to create, as each one builds a table model over
+   // a whole ObjectStore.
+   //
+   LazyWidget<AboutDialog                      > m_aboutDialog               ;
+   LazyWidget<AlcoholTool                      > m_alcoholTool               ;
+   LazyWidget<BoilCatalog                      > m_boilCatalog               ;
+   LazyWidget<BtDatePopup                      > m_btDatePopup               ;
+   LazyWidget<ConverterTool                    > m_converterTool             ;
+   LazyWidget<EquipmentCatalog                 > m_equipmentCatalog          ;
+   LazyWidget<FermentableCatalog               > m_fermentableCatalog        ;
+   LazyWidget<FermentationCatalog              > m_fermentationCatalog       ;
+   LazyWidget<HelpDialog                       > m_helpDialog                ;
+   LazyWidget<HopCatalog                       > m_hopCatalog                ;
+   LazyWidget<HydrometerTool                   > m_hydrometerTool            ;
+   LazyWidget<InventoryWindow                  > m_inventoryWindow           ;
+   LazyWidget<MashCatalog                      > m_mashCatalog               ;
+   LazyWidget<MashDesigner                     > m_mashDesigner              ;
+   LazyWidget<MashWizard                       > m_mashWizard                ;
+   LazyWidget<MiscCatalog                      > m_miscCatalog               ;
+   LazyWidget<OgAdjuster                       > m_ogAdjuster                ;
+   LazyWidget<PitchDialog                      > m_pitchDialog               ;
+   LazyWidget<PrimingDialog                    > m_primingDialog             ;
+   LazyWidget<PrintAndPreviewDialog, MainWindow> m_printAndPreviewDialog     ;
+   LazyWidget<RefractoDialog                   > m_refractoDialog            ;
+   LazyWidget<SaltCatalog                      > m_saltCatalog               ;
+   LazyWidget<ScaleRecipeTool                  > m_recipeScaler              ;
+   LazyWidget<StrikeWaterDialog                > m_strikeWaterDialog         ;
+   LazyWidget<StyleCatalog                     > m_styleCatalog              ;
+   LazyWidget<TimerMainDialog      , MainWindow> m_timerMainDialog           ;
+   LazyWidget<WaterCatalog                     > m_waterCatalog              ;
+   LazyWidget<WaterProfileAdjustmentTool       > m_waterProfileAdjustmentTool;
+   LazyWidget<YeastCatalog                     > m_yeastCatalog              ;
+
+   //! The lazily-created widgets that we create in idle time after start-up, in the order we create them
+   QList<LazyWidgetBase *> m_prewarmQueue;
+   QTimer m_prewarmTimer;
+   //! Started when \c MainWindow is constructed, so we can log how long it takes for the program to be usable
+   QElapsedTimer m_startupTimer;
+   //! Whether catalogs should allow adding to the current recipe (ie whether it is unlocked)
+   bool m_catalogsCanAddToRecipe;
+
    QString highSS, lowSS, goodSS, boldSS; // Palette replacements
+
+   //! Bit flags (see \c RecipePanelPart) of the parts of the recipe panel awaiting refresh
+   unsigned int m_dirtyRecipePanelParts;
+   //! For instrumentation: how many change notifications we have had since the last refresh
+   int m_numChangesSinceRefresh;
+   //! For instrumentation: how many times we have refreshed the recipe panel
+   unsigned long m_numRecipePanelRefreshes;
+   QTimer m_recipePanelRefreshTimer;
 };
 
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_unique<impl>(*this)} {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logUi) << Q_FUNC_INFO;
 
    // Need to call this parent class method to get all the widgets added (I think).
    this->setupUi(this);
@@ -798,7 +1025,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
          dataLoadErrorMessageBox.setDefaultButton(QMessageBox::Close);
          int ret = dataLoadErrorMessageBox.exec();
          if (ret == QMessageBox::Close) {
-            qDebug() << Q_FUNC_INFO << "User clicked \"Close\".  Exiting.";
+            qCDebug(logUi) << Q_FUNC_INFO << "User clicked \"Close\".  Exiting.";
          } else {
             qWarning() <<
                Q_FUNC_INFO << "User clicked \"Ignore\" after errors loading data.  PROGRAM MAY NOT FUNCTION CORRECTLY!";
@@ -807,11 +1034,11 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
       }
       if (bail) {
          // Either the user clicked Close, or we're not interactive.  Either way, we quit in the same way as above.
-         qDebug() << Q_FUNC_INFO << "Exiting...";
+         qCDebug(logUi) << Q_FUNC_INFO << "Exiting...";
          QCoreApplication::quit();
-         qDebug() << Q_FUNC_INFO << "Still Exiting...";
+         qCDebug(logUi) << Q_FUNC_INFO << "Still Exiting...";
          QCoreApplication::exit(1);
-         qDebug() << Q_FUNC_INFO << "Really Exiting now...";
+         qCDebug(logUi) << Q_FUNC_INFO << "Really Exiting now...";
          exit(1);
       }
    }
@@ -829,7 +1056,7 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
 }
 
 void MainWindow::initialiseAndMakeVisible() {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logUi) << Q_FUNC_INFO;
 
    this->setupCSS();
    // initialize all of the dialog windows
@@ -888,7 +1115,16 @@ void MainWindow::initialiseAndMakeVisible() {
 
    emit initialisedAndVisible();
 
-   qDebug() << Q_FUNC_INFO << "MainWindow initialisation complete";
+   qCDebug(logUi) << Q_FUNC_INFO << "MainWindow initialisation complete";
+
+   //
+   // Once the event loop has had a chance to paint the window, the program is usable, so that's when we measure
+   // time-to-interactive.  Then we start creating, in idle time, the things we deferred (see Impl::setupDialogs).
+   //
+   QTimer::singleShot(0, this, [this]() {
+      qInfo() << Q_FUNC_INFO << "Main window interactive" << this->pimpl->m_startupTimer.elapsed() << "ms after start-up";
+      this->pimpl->m_prewarmTimer.start();
+   });
    return;
 }
 
@@ -1072,7 +1308,7 @@ void MainWindow::restoreSavedState() {
       // We can't assume that the "remembered" recipe exists.  The user might have restored to an older DB file since
       // the last time the program was run.
       Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(key);
-      qDebug() << Q_FUNC_INFO << "Recipe #" << key << (recipe ? "found" : "not found");
+      qCDebug(logUi) << Q_FUNC_INFO << "Recipe #" << key << (recipe ? "found" : "not found");
       if (recipe) {
          // We trust setRecipe to do any necessary checks and UI updates
          this->setRecipe(recipe);
@@ -1146,8 +1382,8 @@ void MainWindow::restoreSavedState() {
 void MainWindow::setupTriggers() {
    // Connect actions defined in *.ui files to methods in code
    connect(actionExit                      , &QAction::triggered, this                                      , &QWidget::close                    ); // > File > Exit
-   connect(actionAbout                     , &QAction::triggered, this->pimpl->m_aboutDialog.get()          , &QWidget::show                     ); // > About > About Brewtarget
-   connect(actionHelp                      , &QAction::triggered, this->pimpl->m_helpDialog.get()           , &QWidget::show                     ); // > About > Help
+   connect(actionAbout                     , &QAction::triggered, this, [this]() { this->pimpl->m_aboutDialog          ->show(); }); // > About > About Brewtarget
+   connect(actionHelp                      , &QAction::triggered, this, [this]() { this->pimpl->m_helpDialog           ->show(); }); // > About > Help
 
    connect(actionNewRecipe                 , &QAction::triggered, this                                      , &MainWindow::newRecipe             ); // > File > New Recipe
    connect(actionImportFromXml             , &QAction::triggered, this                                      , &MainWindow::importFiles           ); // > File > Import Recipes
@@ -1155,39 +1391,39 @@ void MainWindow::setupTriggers() {
    connect(actionUndo                      , &QAction::triggered, this                                      , &MainWindow::editUndo              ); // > Edit > Undo
    connect(actionRedo                      , &QAction::triggered, this                                      , &MainWindow::editRedo              ); // > Edit > Redo
    this->setUndoRedoEnable();
-   connect(actionEquipments                , &QAction::triggered, this->pimpl->m_equipmentCatalog.get()     , &QWidget::show                     ); // > View > Equipments
-   connect(actionMashes                    , &QAction::triggered, this->pimpl->m_mashCatalog.get()          , &QWidget::show                     ); // > View > Mash Profiles
-   connect(actionBoils                     , &QAction::triggered, this->pimpl->m_boilCatalog.get()          , &QWidget::show                     ); // > View > Boil Profiles
-   connect(actionFermentations             , &QAction::triggered, this->pimpl->m_fermentationCatalog.get()  , &QWidget::show                     ); // > View > Fermentation Profiles
-
-   connect(actionStyles                    , &QAction::triggered, this->pimpl->m_styleCatalog.get()         , &QWidget::show                     ); // > View > Styles
-   connect(actionFermentables              , &QAction::triggered, this->pimpl->m_fermentableCatalog.get()          , &QWidget::show                     ); // > View > Fermentables
-   connect(actionHops                      , &QAction::triggered, this->pimpl->m_hopCatalog.get()           , &QWidget::show                     ); // > View > Hops
-   connect(actionMiscs                     , &QAction::triggered, this->pimpl->m_miscCatalog.get()          , &QWidget::show                     ); // > View > Miscs
-   connect(actionYeasts                    , &QAction::triggered, this->pimpl->m_yeastCatalog.get()         , &QWidget::show                     ); // > View > Yeasts
-   connect(actionSalts                     , &QAction::triggered, this->pimpl->m_saltCatalog.get()          , &QWidget::show                     ); // > View > Salts
-   connect(actionWaters                    , &QAction::triggered, this->pimpl->m_waterCatalog.get()         , &QWidget::show                     ); // > View > Waters
-   connect(actionInventory                 , &QAction::triggered, this->pimpl->m_inventoryWindow.get()      , &QWidget::show                     ); // > View > Inventory
+   connect(actionEquipments                , &QAction::triggered, this, [this]() { this->pimpl->m_equipmentCatalog     ->show(); }); // > View > Equipments
+   connect(actionMashes                    , &QAction::triggered, this, [this]() { this->pimpl->m_mashCatalog          ->show(); }); // > View > Mash Profiles
+   connect(actionBoils                     , &QAction::triggered, this, [this]() { this->pimpl->m_boilCatalog          ->show(); }); // > View > Boil Profiles
+   connect(actionFermentations             , &QAction::triggered, this, [this]() { this->pimpl->m_fermentationCatalog  ->show(); }); // > View > Fermentation Profiles
+
+   connect(actionStyles                    , &QAction::triggered, this, [this]() { this->pimpl->m_styleCatalog         ->show(); }); // > View > Styles
+   connect(actionFermentables              , &QAction::triggered, this, [this]() { this->pimpl->m_fermentableCatalog   ->show(); }); // > View > Fermentables
+   connect(actionHops                      , &QAction::triggered, this, [this]() { this->pimpl->m_hopCatalog           ->show(); }); // > View > Hops
+   connect(actionMiscs                     , &QAction::triggered, this, [this]() { this->pimpl->m_miscCatalog          ->show(); }); // > View > Miscs
+   connect(actionYeasts                    , &QAction::triggered, this, [this]() { this->pimpl->m_yeastCatalog         ->show(); }); // > View > Yeasts
+   connect(actionSalts                     , &QAction::triggered, this, [this]() { this->pimpl->m_saltCatalog          ->show(); }); // > View > Salts
+   connect(actionWaters                    , &QAction::triggered, this, [this]() { this->pimpl->m_waterCatalog         ->show(); }); // > View > Waters
+   connect(actionInventory                 , &QAction::triggered, this, [this]() { this->pimpl->m_inventoryWindow      ->show(); }); // > View > Inventory
    connect(actionOptions                   , &QAction::triggered, this->pimpl->m_optionDialog.get()         , &OptionDialog::show                ); // > Tools > Options
 //   connect( actionManual, &QAction::triggered, this, &MainWindow::openManual);                                               // > About > Manual
-   connect(actionScale_Recipe              , &QAction::triggered, this->pimpl->m_recipeScaler.get()         , &QWidget::show                     ); // > Tools > Scale Recipe
+   connect(actionScale_Recipe              , &QAction::triggered, this, [this]() { this->pimpl->m_recipeScaler         ->show(); }); // > Tools > Scale Recipe
    connect(action_recipeToTextClipboard    , &QAction::triggered, this->pimpl->m_recipeFormatter.get()      , &RecipeFormatter::toTextClipboard  ); // > Tools > Recipe to Clipboard as Text
-   connect(actionConvert_Units             , &QAction::triggered, this->pimpl->m_converterTool.get()        , &QWidget::show                     ); // > Tools > Convert Units
-   connect(actionHydrometer_Temp_Adjustment, &QAction::triggered, this->pimpl->m_hydrometerTool.get()       , &QWidget::show                     ); // > Tools > Hydrometer Temp Adjustment
-   connect(actionAlcohol_Percentage_Tool   , &QAction::triggered, this->pimpl->m_alcoholTool.get()          , &QWidget::show                     ); // > Tools > Alcohol
-   connect(actionOG_Correction_Help        , &QAction::triggered, this->pimpl->m_ogAdjuster.get()           , &QWidget::show                     ); // > Tools > OG Correction Help
+   connect(actionConvert_Units             , &QAction::triggered, this, [this]() { this->pimpl->m_converterTool        ->show(); }); // > Tools > Convert Units
+   connect(actionHydrometer_Temp_Adjustment, &QAction::triggered, this, [this]() { this->pimpl->m_hydrometerTool       ->show(); }); // > Tools > Hydrometer Temp Adjustment
+   connect(actionAlcohol_Percentage_Tool   , &QAction::triggered, this, [this]() { this->pimpl->m_alcoholTool          ->show(); }); // > Tools > Alcohol
+   connect(actionOG_Correction_Help        , &QAction::triggered, this, [this]() { this->pimpl->m_ogAdjuster           ->show(); }); // > Tools > OG Correction Help
    connect(actionCopySelected              , &QAction::triggered, this                                      , &MainWindow::copySelected          ); // > File > Copy Selected
-   connect(actionPriming_Calculator        , &QAction::triggered, this->pimpl->m_primingDialog.get()        , &QWidget::show                     ); // > Tools > Priming Calculator
-   connect(actionStrikeWater_Calculator    , &QAction::triggered, this->pimpl->m_strikeWaterDialog.get()    , &QWidget::show                     ); // > Tools > Strike Water Calculator
-   connect(actionRefractometer_Tools       , &QAction::triggered, this->pimpl->m_refractoDialog.get()       , &QWidget::show                     ); // > Tools > Refractometer Tools
+   connect(actionPriming_Calculator        , &QAction::triggered, this, [this]() { this->pimpl->m_primingDialog        ->show(); }); // > Tools > Priming Calculator
+   connect(actionStrikeWater_Calculator    , &QAction::triggered, this, [this]() { this->pimpl->m_strikeWaterDialog    ->show(); }); // > Tools > Strike Water Calculator
+   connect(actionRefractometer_Tools       , &QAction::triggered, this, [this]() { this->pimpl->m_refractoDialog       ->show(); }); // > Tools > Refractometer Tools
    connect(actionPitch_Rate_Calculator     , &QAction::triggered, this                                      , &MainWindow::showPitchDialog       ); // > Tools > Pitch Rate Calculator
-   connect(actionTimers                    , &QAction::triggered, this->pimpl->m_timerMainDialog.get()      , &QWidget::show                     ); // > Tools > Timers
+   connect(actionTimers                    , &QAction::triggered, this, [this]() { this->pimpl->m_timerMainDialog      ->show(); }); // > Tools > Timers
    connect(actionDeleteSelected            , &QAction::triggered, this                                      , &MainWindow::deleteSelected        );
    connect(actionWaterProfileAdjustmentTool, &QAction::triggered, this                                      , &MainWindow::showWaterProfileAdjustmentTool); // > Tools > Water Chemistry
    connect(actionAncestors                 , &QAction::triggered, this                                      , &MainWindow::setAncestor           ); // > Tools > Ancestors
    connect(action_brewit                   , &QAction::triggered, this                                      , &MainWindow::brewItHelper          );
    //One Dialog to rule them all, at least all printing and export.
-   connect(actionPrint                     , &QAction::triggered, this->pimpl->m_printAndPreviewDialog.get(), &QWidget::show                     ); // > File > Print and Preview
+   connect(actionPrint                     , &QAction::triggered, this, [this]() { this->pimpl->m_printAndPreviewDialog->show(); }); // > File > Print and Preview
 
    // postgresql cannot backup or restore yet. I would like to find some way
    // around this, but for now just disable
@@ -1199,6 +1435,7 @@ void MainWindow::setupTriggers() {
       connect( actionBackup_Database, &QAction::triggered, this, &MainWindow::backup );                                 // > File > Database > Backup
       connect( actionRestore_Database, &QAction::triggered, this, &MainWindow::restoreFromBackup );                     // > File > Database > Restore
    }
+   connect(actionQueryStats_Database, &QAction::triggered, this, &MainWindow::showQueryStats);                         // > File > Database > Query Statistics
    return;
 }
 
@@ -1217,11 +1454,11 @@ void MainWindow::setupClicks() {
    connect(this->        boilButton       , &QAbstractButton::clicked, this, &MainWindow::editRecipeBoil        );
    connect(this->fermentationButton       , &QAbstractButton::clicked, this, &MainWindow::editRecipeFermentation);
 
-   connect(this->pushButton_addFerm       , &QAbstractButton::clicked, this->pimpl-> m_fermentableCatalog.get(), &QWidget::show);
-   connect(this->pushButton_addHop        , &QAbstractButton::clicked, this->pimpl->         m_hopCatalog.get(), &QWidget::show);
-   connect(this->pushButton_addMisc       , &QAbstractButton::clicked, this->pimpl->        m_miscCatalog.get(), &QWidget::show);
-   connect(this->pushButton_addYeast      , &QAbstractButton::clicked, this->pimpl->       m_yeastCatalog.get(), &QWidget::show);
-   connect(this->pushButton_addSalt       , &QAbstractButton::clicked, this->pimpl->        m_saltCatalog.get(), &QWidget::show);
+   connect(this->pushButton_addFerm       , &QAbstractButton::clicked, this, [this]() { this->pimpl->m_fermentableCatalog->show(); });
+   connect(this->pushButton_addHop        , &QAbstractButton::clicked, this, [this]() { this->pimpl->        m_hopCatalog->show(); });
+   connect(this->pushButton_addMisc       , &QAbstractButton::clicked, this, [this]() { this->pimpl->       m_miscCatalog->show(); });
+   connect(this->pushButton_addYeast      , &QAbstractButton::clicked, this, [this]() { this->pimpl->      m_yeastCatalog->show(); });
+   connect(this->pushButton_addSalt       , &QAbstractButton::clicked, this, [this]() { this->pimpl->       m_saltCatalog->show(); });
    // NB: We don't currently have pushButton_addWater
 
    connect(this->pushButton_removeFerm    , &QAbstractButton::clicked, this, &MainWindow::removeSelectedFermentableAddition);
@@ -1236,8 +1473,8 @@ void MainWindow::setupClicks() {
    connect(this->pushButton_editYeast     , &QAbstractButton::clicked, this, &MainWindow::editYeastOfSelectedYeastAddition            );
    connect(this->pushButton_editSalt      , &QAbstractButton::clicked, this, &MainWindow::editSaltOfSelectedSaltAddition              );
 
-   connect(this->pushButton_mashWizard, &QAbstractButton::clicked, this->pimpl->m_mashWizard.get()  , &MashWizard::show  );
-   connect(this->pushButton_mashDesigner   , &QAbstractButton::clicked, this->pimpl->m_mashDesigner.get(), &MashDesigner::show);
+   connect(this->pushButton_mashWizard    , &QAbstractButton::clicked, this, [this]() { this->pimpl->  m_mashWizard->show(); });
+   connect(this->pushButton_mashDesigner  , &QAbstractButton::clicked, this, [this]() { this->pimpl->m_mashDesigner->show(); });
 
    return;
 }
@@ -1288,7 +1525,7 @@ void MainWindow::deleteSelected() {
 
    // This happens after startup when nothing is selected
    if (!activeTreeView) {
-      qDebug() << Q_FUNC_INFO << "Nothing selected, so nothing to delete";
+      qCDebug(logUi) << Q_FUNC_INFO << "Nothing selected, so nothing to delete";
       return;
    }
    activeTreeView->deleteSelected();
@@ -1316,7 +1553,7 @@ void MainWindow::setRecipe(Recipe * recipe) {
       return;
    }
 
-   qDebug() << Q_FUNC_INFO << "Recipe #" << recipe->key() << ":" << recipe->name();
+   qCDebug(logUi) << Q_FUNC_INFO << "Recipe #" << recipe->key() << ":" << recipe->name();
 
 
    // Make sure this MainWindow is paying attention...
@@ -1341,12 +1578,13 @@ void MainWindow::setRecipe(Recipe * recipe) {
    this->pimpl->closeAllBrewNoteTabs();
 
    // Tell some of our other widgets to observe the new recipe.
-   this->pimpl->m_mashWizard->setRecipe(recipe);
+   // (Tools that haven't been created yet will pick up the recipe when they are -- see Impl::setupDialogs.)
+   this->pimpl->m_mashWizard.ifExists([recipe](MashWizard & tool) { tool.setRecipe(recipe); });
    brewDayScrollWidget->setRecipe(recipe);
    this->pimpl->m_recipeFormatter->setRecipe(recipe);
-   this->pimpl->m_ogAdjuster->setRecipe(recipe);
+   this->pimpl->m_ogAdjuster.ifExists([recipe](OgAdjuster & tool) { tool.setRecipe(recipe); });
    recipeExtrasWidget->setRecipe(recipe);
-   this->pimpl->m_mashDesigner->setRecipe(recipe);
+   this->pimpl->m_mashDesigner.ifExists([recipe](MashDesigner & tool) { tool.setRecipe(recipe); });
    this->equipmentButton->setRecipe(recipe);
    this->equipmentComboBox->setItem(recipe->equipment());
    if (recipe->equipment()) {
@@ -1376,7 +1614,7 @@ void MainWindow::setRecipe(Recipe * recipe) {
    this->fermentationComboBox->setItem(recipe->fermentation());
    this->fermentationStepsWidget->setRecipe(recipe);
 
-   this->pimpl->m_recipeScaler->setRecipe(recipe);
+   this->pimpl->m_recipeScaler.ifExists([recipe](ScaleRecipeTool & tool) { tool.setRecipe(recipe); });
 
    // Set the locked flag as required
    checkBox_locked->setCheckState(recipe->locked() ? Qt::Checked : Qt::Unchecked);
@@ -1470,11 +1708,13 @@ void MainWindow::lockRecipe(int state) {
    pushButton_removeSalt->setEnabled(enabled);
    pushButton_editSalt->setEnabled(enabled);
 
-   this->pimpl-> m_fermentableCatalog->setEnableAddToRecipe(enabled);
-   this->pimpl->  m_hopCatalog->setEnableAddToRecipe(enabled);
-   this->pimpl-> m_miscCatalog->setEnableAddToRecipe(enabled);
-   this->pimpl->m_yeastCatalog->setEnableAddToRecipe(enabled);
-   this->pimpl-> m_saltCatalog->setEnableAddToRecipe(enabled);
+   // Catalogs not yet created will pick this up when they are (see Impl::setupDialogs)
+   this->pimpl->m_catalogsCanAddToRecipe = enabled;
+   this->pimpl->m_fermentableCatalog.ifExists([enabled](FermentableCatalog & catalog) { catalog.setEnableAddToRecipe(enabled); });
+   this->pimpl->        m_hopCatalog.ifExists([enabled](HopCatalog         & catalog) { catalog.setEnableAddToRecipe(enabled); });
+   this->pimpl->       m_miscCatalog.ifExists([enabled](MiscCatalog        & catalog) { catalog.setEnableAddToRecipe(enabled); });
+   this->pimpl->      m_yeastCatalog.ifExists([enabled](YeastCatalog       & catalog) { catalog.setEnableAddToRecipe(enabled); });
+   this->pimpl->       m_saltCatalog.ifExists([enabled](SaltCatalog        & catalog) { catalog.setEnableAddToRecipe(enabled); });
    // NB: Don't yet support add to recipe from water catalog
 
    // TODO: mashes still need dealing with
@@ -1485,7 +1725,7 @@ void MainWindow::lockRecipe(int state) {
 void MainWindow::changed(QMetaProperty prop, [[maybe_unused]] QVariant val) {
    QObject * sender = this->sender();
    QString propName(prop.name());
-   qDebug() << Q_FUNC_INFO << "sender:" << sender << "; propName:" << propName;
+   qCDebug(logUi) << Q_FUNC_INFO << "sender:" << sender << "; propName:" << propName;
 
    if (propName == PropertyNames::Recipe::equipment) {
       auto equipment = this->pimpl->m_recipeObs->equipment();
@@ -1500,29 +1740,58 @@ void MainWindow::changed(QMetaProperty prop, [[maybe_unused]] QVariant val) {
 }
 
 void MainWindow::showChanges(QMetaProperty* prop) {
-   if (this->pimpl->m_recipeObs == nullptr) {
+   if (prop) {
+      this->pimpl->scheduleRecipePanelRefresh(prop->name());
       return;
    }
 
-   bool updateAll = (prop == nullptr);
-   QString propName;
-   if (prop) {
-      propName = prop->name();
+   // Caller wants everything up-to-date now
+   ++this->pimpl->m_numChangesSinceRefresh;
+   this->pimpl->m_dirtyRecipePanelParts = RecipePanel_All;
+   this->refreshRecipePanel();
+   return;
+}
+
+void MainWindow::refreshRecipePanel() {
+   this->pimpl->m_recipePanelRefreshTimer.stop();
+   unsigned int const dirty = this->pimpl->m_dirtyRecipePanelParts;
+   this->pimpl->m_dirtyRecipePanelParts = 0;
+   int const numChanges = this->pimpl->m_numChangesSinceRefresh;
+   this->pimpl->m_numChangesSinceRefresh = 0;
+
+   if (this->pimpl->m_recipeObs == nullptr || dirty == 0) {
+      return;
    }
-   qDebug() << Q_FUNC_INFO << "propName:" << propName;
+
+   ++this->pimpl->m_numRecipePanelRefreshes;
+   qCDebug(logUi) <<
+      Q_FUNC_INFO << "Refresh #" << this->pimpl->m_numRecipePanelRefreshes << "covering" << numChanges <<
+      "change notification(s); parts" << Qt::hex << dirty;
+
+   auto isDirty = [dirty](RecipePanelPart const part) { return (dirty & part) != 0; };
 
    // May St. Stevens preserve me
-   this->lineEdit_name      ->setText    (this->pimpl->m_recipeObs->name          ());
-   this->lineEdit_batchSize ->setQuantity(this->pimpl->m_recipeObs->batchSize_l   ());
-   this->lineEdit_efficiency->setQuantity(this->pimpl->m_recipeObs->efficiency_pct());
+   if (isDirty(RecipePanel_Name)) {
+      this->lineEdit_name->setText          (this->pimpl->m_recipeObs->name());
+      this->lineEdit_name->setCursorPosition(0);
+   }
+   if (isDirty(RecipePanel_BatchSize)) {
+      this->lineEdit_batchSize->setQuantity      (this->pimpl->m_recipeObs->batchSize_l());
+      this->lineEdit_batchSize->setCursorPosition(0);
+   }
+   if (isDirty(RecipePanel_Efficiency)) {
+      this->lineEdit_efficiency->setQuantity      (this->pimpl->m_recipeObs->efficiency_pct());
+      this->lineEdit_efficiency->setCursorPosition(0);
+   }
    // TODO: One day we'll want to do some work to properly handle no-boil recipes....
    std::optional<double> const boilSize = this->pimpl->m_recipeObs->boil() ? this->pimpl->m_recipeObs->boil()->preBoilSize_l() : std::nullopt;
-   this->label_targetBoilSize_value->setQuantity(boilSize);
-   this->label_boilTime_value->setQuantity(this->pimpl->m_recipeObs->boil() ? this->pimpl->m_recipeObs->boil()->boilTime_mins() : 0.0);
-   this->label_boilSg_value  ->setQuantity(this->pimpl->m_recipeObs->boilGrav());
-   this->lineEdit_name      ->setCursorPosition(0);
-   this->lineEdit_batchSize ->setCursorPosition(0);
-   this->lineEdit_efficiency->setCursorPosition(0);
+   if (isDirty(RecipePanel_BoilInfo)) {
+      this->label_targetBoilSize_value->setQuantity(boilSize);
+      this->label_boilTime_value->setQuantity(this->pimpl->m_recipeObs->boil() ? this->pimpl->m_recipeObs->boil()->boilTime_mins() : 0.0);
+   }
+   if (isDirty(RecipePanel_BoilGravity)) {
+      this->label_boilSg_value  ->setQuantity(this->pimpl->m_recipeObs->boilGrav());
+   }
 /*
    lineEdit_calcBatchSize->setText(this->pimpl->m_recipeObs);
    lineEdit_calcBoilSize->setText(this->pimpl->m_recipeObs);
@@ -1546,78 +1815,93 @@ void MainWindow::showChanges(QMetaProperty* prop) {
 */
 
    auto style = this->pimpl->m_recipeObs->style();
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_og, *this->oGLabel, style->ogMin(), style->ogMax(), 1.120);
+   if (isDirty(RecipePanel_Og)) {
+      if (style) {
+         updateDensitySlider(*this->styleRangeWidget_og, *this->oGLabel, style->ogMin(), style->ogMax(), 1.120);
+      }
+      this->styleRangeWidget_og->setValue(this->oGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->og()));
    }
-   this->styleRangeWidget_og->setValue(this->oGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->og()));
 
-   if (style) {
-      updateDensitySlider(*this->styleRangeWidget_fg, *this->fGLabel, style->fgMin(), style->fgMax(), 1.030);
+   if (isDirty(RecipePanel_Fg)) {
+      if (style) {
+         updateDensitySlider(*this->styleRangeWidget_fg, *this->fGLabel, style->fgMin(), style->fgMax(), 1.030);
+      }
+      this->styleRangeWidget_fg->setValue(this->fGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->fg()));
    }
-   this->styleRangeWidget_fg->setValue(this->fGLabel->getAmountToDisplay(this->pimpl->m_recipeObs->fg()));
 
-   this->styleRangeWidget_abv->setValue(this->pimpl->m_recipeObs->ABV_pct());
-   this->styleRangeWidget_ibu->setValue(this->pimpl->m_recipeObs->IBU());
+   if (isDirty(RecipePanel_Abv)) {
+      this->styleRangeWidget_abv->setValue(this->pimpl->m_recipeObs->ABV_pct());
+   }
+   if (isDirty(RecipePanel_Ibu)) {
+      this->styleRangeWidget_ibu->setValue(this->pimpl->m_recipeObs->IBU());
+   }
 
-   this->rangeWidget_batchSize->setRange         (0,
-                                                  this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->batchSize_l()));
-   this->rangeWidget_batchSize->setPreferredRange(0,
-                                                  this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
-   this->rangeWidget_batchSize->setValue         (this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
+   if (isDirty(RecipePanel_BatchSizeRange)) {
+      this->rangeWidget_batchSize->setRange         (0,
+                                                     this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->batchSize_l()));
+      this->rangeWidget_batchSize->setPreferredRange(0,
+                                                     this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
+      this->rangeWidget_batchSize->setValue         (this->label_batchSize->getAmountToDisplay(this->pimpl->m_recipeObs->finalVolume_l()));
+   }
 
-   this->rangeWidget_boilsize->setRange         (0,
-                                                 this->label_boilSize->getAmountToDisplay(boilSize.value_or(0.0)));
-   this->rangeWidget_boilsize->setPreferredRange(0,
-                                                 this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
-   this->rangeWidget_boilsize->setValue         (this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
+   if (isDirty(RecipePanel_BoilSizeRange)) {
+      this->rangeWidget_boilsize->setRange         (0,
+                                                    this->label_boilSize->getAmountToDisplay(boilSize.value_or(0.0)));
+      this->rangeWidget_boilsize->setPreferredRange(0,
+                                                    this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
+      this->rangeWidget_boilsize->setValue         (this->label_boilSize->getAmountToDisplay(this->pimpl->m_recipeObs->boilVolume_l()));
+   }
 
    // Colors need the same basic treatment as gravity
-   if (style) {
-      updateColorSlider(*this->styleRangeWidget_srm,
-                        *this->colorSRMLabel,
-                        style->colorMin_srm(),
-                        style->colorMax_srm());
+   if (isDirty(RecipePanel_Color)) {
+      if (style) {
+         updateColorSlider(*this->styleRangeWidget_srm,
+                           *this->colorSRMLabel,
+                           style->colorMin_srm(),
+                           style->colorMax_srm());
+      }
+      this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(this->pimpl->m_recipeObs->color_srm()));
    }
-   this->styleRangeWidget_srm->setValue(this->colorSRMLabel->getAmountToDisplay(this->pimpl->m_recipeObs->color_srm()));
 
    // In some, incomplete, recipes, OG is approximately 1.000, which then makes GU close to 0 and thus IBU/GU insanely
    // large.  Besides being meaningless, such a large number takes up a lot of space.  So, where gravity units are
    // below 1, we just show IBU on the IBU/GU slider.
-   auto gravityUnits = (this->pimpl->m_recipeObs->og()-1)*1000;
-   if (gravityUnits < 1) {
-      gravityUnits = 1;
-   }
-   this->ibuGuSlider->setValue(this->pimpl->m_recipeObs->IBU()/gravityUnits);
-
-   label_calories->setText(
-      QString("%1").arg(
-         Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) == Measurement::UnitSystems::volume_Metric ?
-         this->pimpl->m_recipeObs->caloriesPer33cl() : this->pimpl->m_recipeObs->caloriesPerUs12oz(),
-         0,
-         'f',
-         0
-      )
-   );
+   if (isDirty(RecipePanel_IbuGu)) {
+      auto gravityUnits = (this->pimpl->m_recipeObs->og()-1)*1000;
+      if (gravityUnits < 1) {
+         gravityUnits = 1;
+      }
+      this->ibuGuSlider->setValue(this->pimpl->m_recipeObs->IBU()/gravityUnits);
+   }
+
+   if (isDirty(RecipePanel_Calories)) {
+      label_calories->setText(
+         QString("%1").arg(
+            Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) == Measurement::UnitSystems::volume_Metric ?
+            this->pimpl->m_recipeObs->caloriesPer33cl() : this->pimpl->m_recipeObs->caloriesPerUs12oz(),
+            0,
+            'f',
+            0
+         )
+      );
+   }
 
    // See if we need to change the mash in the table.
-   if (this->pimpl->m_recipeObs->mash() && (updateAll || propName == PropertyNames::Recipe::mash)) {
+   if (this->pimpl->m_recipeObs->mash() && isDirty(RecipePanel_MashSteps)) {
       this->mashStepsWidget->setStepOwner(this->pimpl->m_recipeObs->mash());
    }
    // See if we need to change the boil in the table.
-   if (this->pimpl->m_recipeObs->boil() &&
-       (updateAll ||
-        propName == PropertyNames::Recipe::boil ||
-        propName == PropertyNames::StepOwnerBase::steps)) {
+   if (this->pimpl->m_recipeObs->boil() && isDirty(RecipePanel_BoilSteps)) {
       this->boilStepsWidget->setStepOwner(this->pimpl->m_recipeObs->boil());
    }
    // See if we need to change the fermentation in the table.
-   if (this->pimpl->m_recipeObs->fermentation() && (updateAll || propName == PropertyNames::Recipe::fermentation)) {
+   if (this->pimpl->m_recipeObs->fermentation() && isDirty(RecipePanel_FermentationSteps)) {
       this->fermentationStepsWidget->setStepOwner(this->pimpl->m_recipeObs->fermentation());
    }
 
    // Not sure about this, but I am annoyed that modifying the hop usage
    // modifiers isn't automatically updating my display
-   if (updateAll) {
+   if (isDirty(RecipePanel_HopTable)) {
      this->pimpl->m_recipeObs->recalcIfNeeded(Hop::staticMetaObject.className());
      this->pimpl->m_hopAdditionsVeriTable.m_sortFilterProxyModel->invalidate();
    }
@@ -1792,11 +2076,11 @@ void MainWindow::droppedRecipeEquipment(Equipment * kitRaw) {
 // This isn't called when we think it is...!
 void MainWindow::droppedRecipeStyle(Style * styleRaw) {
    if (!this->pimpl->m_recipeObs) {
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(logUi) << Q_FUNC_INFO;
       return;
    }
    // When the style is changed, we also need to update what is shown on the Style button
-   qDebug() << Q_FUNC_INFO << "Do or redo";
+   qCDebug(logUi) << Q_FUNC_INFO << "Do or redo";
    auto style = ObjectStoreWrapper::getSharedFromRaw(styleRaw);
    Undoable::doOrRedoUpdate(
       newRelationalUndoableUpdate(*this->pimpl->m_recipeObs,
@@ -1930,7 +2214,7 @@ void MainWindow::updateRecipeBatchSize() {
 }
 
 void MainWindow::updateRecipeEfficiency() {
-   qDebug() << Q_FUNC_INFO << lineEdit_efficiency->getNonOptValue<double>();
+   qCDebug(logUi) << Q_FUNC_INFO << lineEdit_efficiency->getNonOptValue<double>();
    if (!this->pimpl->m_recipeObs) {
       return;
    }
@@ -2036,7 +2320,7 @@ void MainWindow::setUndoRedoEnable() {
 void MainWindow::editUndo() {
    QUndoStack & undoStack { Undoable::getStack() };
    if (!undoStack.canUndo()) {
-      qDebug() << "Undo called but nothing to undo";
+      qCDebug(logUi) << "Undo called but nothing to undo";
    } else {
       undoStack.undo();
    }
@@ -2048,7 +2332,7 @@ void MainWindow::editUndo() {
 void MainWindow::editRedo() {
    QUndoStack & undoStack { Undoable::getStack() };
    if (!undoStack.canRedo()) {
-      qDebug() << "Redo called but nothing to redo";
+      qCDebug(logUi) << "Redo called but nothing to redo";
    } else {
       undoStack.redo();
    }
@@ -2139,10 +2423,10 @@ void MainWindow::newRecipeInFolder(QString folderPath) {
 }
 
 void MainWindow::setTreeSelection(QModelIndex index) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logUi) << Q_FUNC_INFO;
 
    if (!index.isValid()) {
-      qDebug() << Q_FUNC_INFO << "Index invalid";
+      qCDebug(logUi) << Q_FUNC_INFO << "Index invalid";
       return;
    }
 
@@ -2153,7 +2437,7 @@ void MainWindow::setTreeSelection(QModelIndex index) {
 
    // Couldn't cast the activeTreeView index to a TreeView
    if (!activeTreeView) {
-      qDebug() << Q_FUNC_INFO << "Couldn't cast the activeTreeView index to a TreeView";
+      qCDebug(logUi) << Q_FUNC_INFO << "Couldn't cast the activeTreeView index to a TreeView";
       return;
    }
 
@@ -2259,7 +2543,7 @@ void MainWindow::backup() {
    // NB: QDir does all the necessary magic of translating '/' to whatever current platform's directory separator is
    QString defaultBackupFileName = QDir::currentPath() + "/" + Database::getDefaultBackupFileName();
    QString backupFileName = QFileDialog::getSaveFileName(this, tr("Backup Database"), defaultBackupFileName);
-   qDebug() << QString("Database backup filename \"%1\"").arg(backupFileName);
+   qCDebug(logUi) << QString("Database backup filename \"%1\"").arg(backupFileName);
 
    // If the filename returned from the dialog is empty, it means the user clicked cancel, so we should stop trying to do the backup
    if (!backupFileName.isEmpty())
@@ -2271,6 +2555,35 @@ void MainWindow::backup() {
    }
 }
 
+void MainWindow::showQueryStats() {
+   QDialog dialog{this};
+   dialog.setWindowTitle(tr("Database Query Statistics"));
+   auto * layout = new QVBoxLayout{&dialog};
+
+   auto * reportText = new QPlainTextEdit{&dialog};
+   reportText->setReadOnly(true);
+   reportText->setLineWrapMode(QPlainTextEdit::NoWrap);
+   reportText->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+   auto refresh = [reportText]() {
+      QString report;
+      QTextStream reportAsStream{&report};
+      QueryStats::writeReport(reportAsStream);
+      reportText->setPlainText(report);
+   };
+   refresh();
+   layout->addWidget(reportText);
+
+   auto * buttons = new QDialogButtonBox{QDialogButtonBox::Close, &dialog};
+   QPushButton * resetButton = buttons->addButton(tr("Reset"), QDialogButtonBox::ResetRole);
+   connect(resetButton, &QPushButton::clicked, &dialog, [refresh]() { QueryStats::reset(); refresh(); });
+   connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+   layout->addWidget(buttons);
+
+   dialog.resize(1000, 600);
+   dialog.exec();
+   return;
+}
+
 void MainWindow::restoreFromBackup() {
    if (QMessageBox::question(
           this,
@@ -2385,13 +2698,13 @@ void MainWindow::copySelected() {
 void MainWindow::exportSelected() {
    TreeView * activeTreeView = this->getActiveTreeView();
    if (!activeTreeView) {
-      qDebug() << Q_FUNC_INFO << "No active tree so can't get a selection";
+      qCDebug(logUi) << Q_FUNC_INFO << "No active tree so can't get a selection";
       return;
    }
 
    QModelIndexList selected = activeTreeView->selectionModel()->selectedRows();
    if (selected.count() == 0) {
-      qDebug() << Q_FUNC_INFO << "Nothing selected, so nothing to export";
+      qCDebug(logUi) << Q_FUNC_INFO << "Nothing selected, so nothing to export";
       return;
    }
 
@@ -2471,9 +2784,9 @@ void MainWindow::exportSelected() {
                ++count;
             }
          } else if (nodeClass == Folder::staticMetaObject.className()) {
-            qDebug() << Q_FUNC_INFO << "Can't export selected Folder to XML as BeerXML does not support it";
+            qCDebug(logUi) << Q_FUNC_INFO << "Can't export selected Folder to XML as BeerXML does not support it";
          } else if (nodeClass == BrewNote::staticMetaObject.className()) {
-            qDebug() << Q_FUNC_INFO << "Can't export selected BrewNote to XML as BeerXML does not support it";
+            qCDebug(logUi) << Q_FUNC_INFO << "Can't export selected BrewNote to XML as BeerXML does not support it";
          } else {
             // This shouldn't happen, because we should explicitly cover all the types above
             qWarning() << Q_FUNC_INFO << "Don't know how to export TreeNode type" << nodeClass;
@@ -2482,7 +2795,7 @@ void MainWindow::exportSelected() {
    }
 
    if (0 == count) {
-      qDebug() << Q_FUNC_INFO << "Nothing selected was exportable to XML";
+      qCDebug(logUi) << Q_FUNC_INFO << "Nothing selected was exportable to XML";
       QMessageBox msgBox{QMessageBox::Critical,
                          tr("Nothing to export"),
                          tr("None of the selected items is exportable")};
@@ -2583,7 +2896,7 @@ void MainWindow::brewNoteDeleted([[maybe_unused]] int brewNoteId, std::shared_pt
    //
    BrewNote * deletedBrewNote = std::static_pointer_cast<BrewNote>(object).get();
    Recipe * recipe = ObjectStoreWrapper::getByIdRaw<Recipe>(deletedBrewNote->recipeId());
-   qDebug() << Q_FUNC_INFO << "BrewNote" << *deletedBrewNote << "deleted on Recipe" << *recipe;
+   qCDebug(logUi) << Q_FUNC_INFO << "BrewNote" << *deletedBrewNote << "deleted on Recipe" << *recipe;
 
    // If this isn't the focused recipe, do nothing because there are no tabs
    // to close.
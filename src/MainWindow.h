@@ -218,6 +218,8 @@ public slots:
    void backup();
    //! \brief Restore the database.
    void restoreFromBackup();
+   //! \brief Show timings etc of the database queries run so far (see \c QueryStats).
+   void showQueryStats();
 
    //! \brief makes sure we can do water chemistry before we show the window
    void showWaterProfileAdjustmentTool();
@@ -277,7 +279,10 @@ public:
     *
     *        Called by \c Recipe and \c OptionDialog::saveLoggingSettings
     *
-    * \param prop Not yet used. Will indicate which Recipe property has changed.
+    * \param prop If supplied, the \c Recipe (or \c Boil) property that has changed.  In this case, only the widgets
+    *             that depend on that property are marked for update, and the update happens (along with any others
+    *             marked in the meantime) when control next returns to the event loop.  If \c nullptr, all widgets are
+    *             updated straight away.
     */
    void showChanges(QMetaProperty* prop = nullptr);
 
@@ -309,6 +314,11 @@ private:
    // Insert all the usual boilerplate to prevent copy/assignment/move
    NO_COPY_DECLARATIONS(MainWindow)
 
+   /**
+    * \brief Update the widgets on the recipe panel that have been marked as needing it by \c showChanges
+    */
+   void refreshRecipePanel();
+
    //! \brief Scroll to the given \c item in the currently visible item tree.
    void setTreeSelection(QModelIndex item);
 
@@ -134,7 +134,8 @@ public:
       label_numBackups           {self.groupBox_dbConfig},
       spinBox_numBackups         {self.groupBox_dbConfig},
       label_frequency            {self.groupBox_dbConfig},
-      spinBox_frequency          {self.groupBox_dbConfig} {
+      spinBox_frequency          {self.groupBox_dbConfig},
+      checkBoxes_loggingCategories{} {
       //
       // Optimise the select file dialog to select directories
       //
@@ -263,6 +264,14 @@ public:
       this->m_self.checkBox_LogFileLocationUseDefault->setChecked(Logging::getLogInConfigDir());
       this->m_self.lineEdit_LogFileLocation->setText(Logging::getDirectory().absolutePath());
       this->m_self.setFileLocationState(Logging::getLogInConfigDir());
+
+      for (auto const & detail : Logging::categoryDetails) {
+         auto checkBox = new QCheckBox(detail.description, this->m_self.groupBox_loggingCategories);
+         checkBox->setObjectName(QString{"checkBox_loggingCategory_%1"}.arg(detail.name));
+         checkBox->setChecked(Logging::isCategoryEnabled(detail.category));
+         this->m_self.verticalLayout_loggingCategories->addWidget(checkBox);
+         this->checkBoxes_loggingCategories.append(checkBox);
+      }
       return;
    }
 
@@ -620,6 +629,9 @@ public:
    QSpinBox    spinBox_numBackups;
    QLabel      label_frequency;
    QSpinBox    spinBox_frequency;
+   // Logging things.  One check box per entry in Logging::categoryDetails, in the same order.  (The check boxes are
+   // owned by groupBox_loggingCategories.)
+   QVector<QCheckBox *> checkBoxes_loggingCategories;
 
    DbConnectionTestStates dbConnectionTestState;
 
@@ -913,6 +925,10 @@ void OptionDialog::saveFormulae() {
 void OptionDialog::saveLoggingSettings() {
    // Saving Logging Options to the Log object
    Logging::setLogLevel(static_cast<Logging::Level>(loggingLevelComboBox->currentData().toInt()));
+   for (int ii = 0; ii < Logging::categoryDetails.size(); ++ii) {
+      Logging::setCategoryEnabled(Logging::categoryDetails.at(ii).category,
+                                  this->pimpl->checkBoxes_loggingCategories.at(ii)->isChecked());
+   }
    Logging::setDirectory(
       checkBox_LogFileLocationUseDefault->isChecked() ?
       std::optional<QDir>(std::nullopt) : std::optional<QDir>(lineEdit_LogFileLocation->text())
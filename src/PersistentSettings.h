@@ -50,11 +50,16 @@ AddSettingName(config_version)
 AddSettingName(converted)
 AddSettingName(count)                            // backups section
 AddSettingName(date_format)
+AddSettingName(dbAsyncWrites)
 AddSettingName(dbHostname)
+AddSettingName(dbLastMaintenance)
+AddSettingName(dbMaintenance)
+AddSettingName(dbMaintenanceFullVacuum)
 AddSettingName(dbName)
 AddSettingName(dbPassword)
 AddSettingName(dbPortnum)
 AddSettingName(dbSchema)
+AddSettingName(dbStartupSnapshot)
 AddSettingName(dbType)
 AddSettingName(dbUsername)
 AddSettingName(defaultBatchSize_l)
@@ -71,8 +76,10 @@ AddSettingName(geometry)
 AddSettingName(ibu_formula)
 AddSettingName(language)
 AddSettingName(last_db_merge_req)
+AddSettingName(lastChangeExportSequence)
 AddSettingName(LogDirectory)
 AddSettingName(LoggingLevel)
+AddSettingName(LoggingCategories)               // Section for Logging::Category settings
 AddSettingName(mashHopAdjustment)
 AddSettingName(mashStepTableWidget_headerState)  // MainWindow section
 AddSettingName(boilStepTableWidget_headerState)  // MainWindow section
@@ -81,6 +88,7 @@ AddSettingName(maximum)                          // backups section
 AddSettingName(productionDate)
 AddSettingName(recipeKey)
 AddSettingName(showsnapshots)
+AddSettingName(slowQueryThreshold_ms)
 AddSettingName(splitter_horizontal_State)        // MainWindow section
 AddSettingName(splitter_vertical_State)          // MainWindow section
 AddSettingName(treeView_equipment_headerState)       // MainWindow section
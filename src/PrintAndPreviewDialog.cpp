@@ -16,7 +16,12 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "PrintAndPreviewDialog.h"
 
+#include <algorithm>
+
 #include <QDebug>
+
+#include <QAbstractTextDocumentLayout>
+#include <QElapsedTimer>
 #include <QFileDialog>
 #include <QFont>
 #include <QList>
@@ -25,15 +30,86 @@
 #include <QPrinterInfo>
 #include <QSizePolicy>
 #include <QStandardPaths>
+#include <QTextBlock>
 #include <QTextBrowser>
 
 #include "InventoryFormatter.h"
+#include "Logging.h"
 
 #ifdef BUILDING_WITH_CMAKE
    // Explicitly doing this include reduces potential problems with AUTOMOC when compiling with CMake
    #include "moc_PrintAndPreviewDialog.cpp"
 #endif
 
+namespace {
+   //
+   // How long to wait after a change to the options before regenerating the preview.  Long enough to swallow the burst
+   // of signals from a single user action, short enough not to be noticeable.
+   //
+   constexpr int previewDebounceInterval_ms = 150;
+
+   //
+   // When paginating the preview, how much of the document to lay out before letting the event loop run again.  We
+   // check the time after each block, so a slice can overrun by one (usually small) block.
+   //
+   constexpr qint64 paginationTimeSlice_ms = 20;
+
+   /**
+    * \brief Parse the supplied HTML into a new document and, if \c pageSize is valid, paginate it, all in one go.
+    */
+   std::unique_ptr<QTextDocument> layOutDocument(QString const & html, QSizeF const & pageSize) {
+      auto document = std::make_unique<QTextDocument>();
+      document->setHtml(html);
+      if (pageSize.isValid()) {
+         // Once the document has a page size, asking for the page count lays out the whole document
+         document->setPageSize(pageSize);
+         int const numPages = document->pageCount();
+         qCDebug(logUi) << Q_FUNC_INFO << "Paginated preview to" << numPages << "pages";
+      }
+      return document;
+   }
+
+   /**
+    * \brief Render a document that has already been paginated (by \c QTextDocument::setPageSize) to a printer, one page
+    *        at a time.  Unlike \c QTextDocument::print, this never clones the document, and each page is handed to the
+    *        printer (or written to the PDF file) before the next is drawn.
+    *
+    * \param sourceDpi The resolution at which \c document was paginated
+    */
+   void printPaginatedDocument(QTextDocument & document, QPrinter & printer, int const sourceDpi) {
+      QPainter painter;
+      if (!painter.begin(&printer)) {
+         qWarning() << Q_FUNC_INFO << "Unable to start painting to printer";
+         return;
+      }
+
+      // The document was laid out in pixels at screen resolution, so scale that up (or down) to the printer's
+      painter.scale(static_cast<double>(printer.logicalDpiX()) / sourceDpi,
+                    static_cast<double>(printer.logicalDpiY()) / sourceDpi);
+
+      QSizeF const pageSize = document.pageSize();
+      int const numPages = document.pageCount();
+      // As with QTextDocument::print, fromPage() and toPage() are 1-based and 0 means "no limit"
+      int const firstPage = printer.fromPage() > 0 ? printer.fromPage() - 1              : 0;
+      int const lastPage  = printer.toPage()   > 0 ? std::min(printer.toPage(), numPages) - 1 : numPages - 1;
+      for (int pageNum = firstPage; pageNum <= lastPage; ++pageNum) {
+         if (printer.printerState() == QPrinter::Aborted || printer.printerState() == QPrinter::Error) {
+            break;
+         }
+         if (pageNum > firstPage) {
+            printer.newPage();
+         }
+         QRectF const pageRect{0, pageNum * pageSize.height(), pageSize.width(), pageSize.height()};
+         painter.save();
+         painter.translate(0, -pageRect.top());
+         document.drawContents(&painter, pageRect);
+         painter.restore();
+      }
+      painter.end();
+      return;
+   }
+}
+
 /**
  * @brief Construct a new Print And Preview Dialog:: Print And Preview Dialog object
  *
@@ -63,6 +139,16 @@ PrintAndPreviewDialog::PrintAndPreviewDialog(MainWindow * parent) : QDialog(pare
    brewDayFormatter = new BrewDayFormatter(this);
    htmlDocument = new QTextBrowser(this);
 
+   this->previewTimer = new QTimer(this);
+   this->previewTimer->setSingleShot(true);
+   this->previewTimer->setInterval(previewDebounceInterval_ms);
+   connect(this->previewTimer, &QTimer::timeout, this, &PrintAndPreviewDialog::startPreviewJob);
+   // Zero interval, so the next chunk of pagination runs as soon as the event loop has caught up with everything else
+   this->paginationTimer = new QTimer(this);
+   this->paginationTimer->setInterval(0);
+   connect(this->paginationTimer, &QTimer::timeout, this, &PrintAndPreviewDialog::paginateNextChunk);
+   this->paginatedToPosition = 0;
+
    checkBox_Recipe->setChecked(true);
    checkBox_Recipe->setEnabled(false);
 
@@ -91,7 +177,13 @@ PrintAndPreviewDialog::PrintAndPreviewDialog(MainWindow * parent) : QDialog(pare
  * @brief Destroy the Print And Preview Dialog:: Print And Preview Dialog object
  *
  */
-PrintAndPreviewDialog::~PrintAndPreviewDialog() = default;
+PrintAndPreviewDialog::~PrintAndPreviewDialog() {
+   //
+   // Detach our document from the HTML preview widget, since the widget does not own it but will outlive it.
+   //
+   this->htmlDocument->setDocument(nullptr);
+   return;
+}
 
 void PrintAndPreviewDialog::showEvent(QShowEvent * event) {
    //
@@ -285,6 +377,12 @@ void PrintAndPreviewDialog::verticalTabWidget_currentChanged([[maybe_unused]] in
  *
  */
 void PrintAndPreviewDialog::handlePrinting() {
+   //
+   // Make sure we output what the user has currently selected, and the data as it is now, rather than whatever the last
+   // preview was built from.
+   //
+   this->rebuildPreviewNow();
+
    // Make it short if we are printing to paper.
    if (radioButton_OutputPaper->isChecked()) {
       previewWidget->print();
@@ -328,32 +426,8 @@ void PrintAndPreviewDialog::handlePrinting() {
  * @param checked
  */
 void PrintAndPreviewDialog::updatePreview() {
-   if (!radioButton_OutputHTML->isChecked()) {
-      previewWidget->updatePreview();
-   } else {
-      QString pDoc = "";
-
-      if (verticalTabWidget->currentIndex() == 0) {
-         bool chkRec = checkBox_Recipe->isChecked();
-         bool chkBDI = checkBox_BrewdayInstructions->isChecked();
-         if (chkRec) {
-            pDoc = recipeFormatter->getHtmlFormat();
-         }
-         if ( chkBDI && !chkRec ) {
-            pDoc += brewDayFormatter->buildHtml();
-         }
-      } else if (verticalTabWidget->currentIndex() == 1) {
-         InventoryFormatter::HtmlGenerationFlags flags;
-         if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
-         if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
-         if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
-         if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
-
-         pDoc = InventoryFormatter::createInventoryHtml(flags);
-      }
-      // adding the generated HTML to the QTexBrowser.
-      htmlDocument->setHtml(pDoc);
-   }
+   // (Re)starting the timer means a burst of changes results in only one preview job
+   this->previewTimer->start();
 
    // choose what displaywidget that should be showing depending on users choice.
    if (radioButton_OutputHTML->isChecked()) {
@@ -370,6 +444,143 @@ void PrintAndPreviewDialog::updatePreview() {
    return;
 }
 
+void PrintAndPreviewDialog::startPreviewJob() {
+   //
+   // Generating the HTML reads model objects (but is mostly served from the formatters' caches) and QTextDocument is
+   // not safe to lay out anywhere other than the GUI thread, so everything happens here.  Parsing the HTML is done in
+   // one go, but paginating it, which is the expensive part for a long document, is done in chunks by
+   // paginateNextChunk, so that the dialog stays responsive.
+   //
+   // Any pagination still in progress for an earlier request is abandoned.
+   //
+   this->paginationTimer->stop();
+   this->paginatingDocument.reset();
+
+   bool const forHtmlOutput = this->radioButton_OutputHTML->isChecked();
+   std::shared_ptr<QTextDocument> document = std::make_shared<QTextDocument>();
+   document->setHtml(this->buildDocumentHtml(forHtmlOutput));
+   if (forHtmlOutput) {
+      // The HTML preview is not paginated
+      this->acceptPreviewDocument(document, forHtmlOutput);
+      return;
+   }
+
+   //
+   // A QTextDocument with no page size has no layout, so setting the page size here is what starts pagination.  (Qt
+   // only lays out the first part of the document straight away, and does the rest lazily.)
+   //
+   document->setPageSize(this->previewPageSize());
+   this->paginatingDocument = document;
+   this->paginatedToPosition = 0;
+   this->paginationTimer->start();
+   return;
+}
+
+void PrintAndPreviewDialog::paginateNextChunk() {
+   if (!this->paginatingDocument) {
+      this->paginationTimer->stop();
+      return;
+   }
+
+   //
+   // Asking the layout for the position of a block makes it lay out the document at least as far as that block, so we
+   // work through the document one block at a time until we've used up our time slice.
+   //
+   QElapsedTimer timer;
+   timer.start();
+   QAbstractTextDocumentLayout * layout = this->paginatingDocument->documentLayout();
+   QTextBlock block = this->paginatingDocument->findBlock(this->paginatedToPosition);
+   while (block.isValid() && timer.elapsed() < paginationTimeSlice_ms) {
+      layout->blockBoundingRect(block);
+      this->paginatedToPosition = block.position() + block.length();
+      block = block.next();
+   }
+   if (block.isValid()) {
+      // More to do next time round
+      return;
+   }
+
+   this->paginationTimer->stop();
+   std::shared_ptr<QTextDocument> document = std::move(this->paginatingDocument);
+   this->paginatingDocument.reset();
+   // The whole document is laid out now, so this is cheap
+   qCDebug(logUi) << Q_FUNC_INFO << "Paginated preview to" << document->pageCount() << "pages";
+   this->acceptPreviewDocument(document, false);
+   return;
+}
+
+void PrintAndPreviewDialog::rebuildPreviewNow() {
+   this->previewTimer->stop();
+   this->paginationTimer->stop();
+   this->paginatingDocument.reset();
+
+   bool const forHtmlOutput = this->radioButton_OutputHTML->isChecked();
+   std::shared_ptr<QTextDocument> document{
+      layOutDocument(this->buildDocumentHtml(forHtmlOutput), forHtmlOutput ? QSizeF{} : this->previewPageSize())
+   };
+   this->acceptPreviewDocument(document, forHtmlOutput);
+   return;
+}
+
+void PrintAndPreviewDialog::acceptPreviewDocument(std::shared_ptr<QTextDocument> document, bool const forHtmlOutput) {
+   if (forHtmlOutput) {
+      // Switch the widget over before we release the previous document
+      this->htmlDocument->setDocument(document.get());
+      this->htmlPreviewDocument = document;
+   } else {
+      this->printPreviewDocument = document;
+      this->previewWidget->updatePreview();
+   }
+   return;
+}
+
+QString PrintAndPreviewDialog::buildDocumentHtml(bool const forHtmlOutput) {
+   QString hDoc = "";
+   // If we are watching the Recipe tab we should output recipe stuff.
+   if (this->verticalTabWidget->currentIndex() == 0) {
+      if (this->selectedRecipe == nullptr) {
+         return hDoc;
+      }
+      bool const chkRec = this->checkBox_Recipe->isChecked();
+      bool const chkBDI = this->checkBox_BrewdayInstructions->isChecked();
+      if (forHtmlOutput) {
+         if (chkRec) {
+            hDoc = this->recipeFormatter->getHtmlFormat();
+         }
+         if (chkBDI && !chkRec) {
+            hDoc += this->brewDayFormatter->buildHtml();
+         }
+      } else {
+         //
+         // TODO: All of the below code to generate the printout will be subject to change and refactoring when I get
+         //       around to making the template editor for printouts where you can save your templates and use them or
+         //       share them with other BT users.
+         //
+         hDoc += this->recipeFormatter->buildHtmlHeader();
+         if (chkRec) {
+            hDoc += this->recipeFormatter->getHtmlFormat();
+         }
+         if (chkBDI) {
+            hDoc += this->brewDayFormatter->buildInstructionHtml();
+         }
+         hDoc += this->recipeFormatter->buildHtmlFooter();
+      }
+   } else if (this->verticalTabWidget->currentIndex() == 1) {
+      InventoryFormatter::HtmlGenerationFlags flags;
+      if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
+      if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
+      if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
+      if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
+
+      hDoc += InventoryFormatter::createInventoryHtml(flags, &this->inventoryTableCache);
+   }
+   return hDoc;
+}
+
+QSizeF PrintAndPreviewDialog::previewPageSize() const {
+   return this->printer->pageLayout().paintRectPixels(this->logicalDpiX()).size();
+}
+
 /**
  * @brief Closes the Dialog
  *
@@ -421,7 +632,8 @@ void PrintAndPreviewDialog::outputRadioButtonsClicked() {
  */
 void PrintAndPreviewDialog::orientationRadioButtonsClicked() {
    printer->setPageOrientation((radioButton_Protrait->isChecked()) ? QPageLayout::Orientation::Portrait : QPageLayout::Orientation::Landscape);
-   previewWidget->updatePreview();
+   // The page shape has changed, so the document needs to be paginated again
+   this->updatePreview();
    return;
 }
 
@@ -492,40 +704,24 @@ void PrintAndPreviewDialog::printDocument(QPrinter * printer) {
    if ( mainWindow->currentRecipe() == nullptr) {
       return;
    }
-   recipeFormatter->setRecipe(mainWindow->currentRecipe());
-   // Setting up a blank page for drawing.
-   QTextBrowser textBrowser;
-   QString hDoc = "";
-   // If we are watching the Recipe tab we should print recipe stuff.
-   if (Ui_BtPrintAndPreview::verticalTabWidget->currentIndex() == 0) {
-      //
-      // TODO: All of the below code to generate the printout will be subject to change and refactoring when I get
-      //       around to making the template editor for printouts where you can save your templates and use them or
-      //       share them with other BT users.
-      //
-      hDoc += recipeFormatter->buildHtmlHeader();
-      if (checkBox_Recipe->isChecked()) {
-         hDoc += recipeFormatter->getHtmlFormat();
-      }
 
-      if (checkBox_BrewdayInstructions->isChecked()) {
-         hDoc += brewDayFormatter->buildInstructionHtml();
+   //
+   // Normally we already have a paginated document, but the preview widget can also ask for a repaint of its own accord
+   // (eg when it is first shown), possibly before the first preview has finished.  In that case, we finish off any
+   // pagination in progress (drawing the document lays out the rest of it) or, failing that, build the document now.
+   // We can't call acceptPreviewDocument here, as that would ask the preview widget to update again.
+   //
+   if (!this->printPreviewDocument) {
+      if (this->paginatingDocument) {
+         this->paginationTimer->stop();
+         this->printPreviewDocument = std::move(this->paginatingDocument);
+         this->paginatingDocument.reset();
+      } else {
+         this->printPreviewDocument = layOutDocument(this->buildDocumentHtml(false), this->previewPageSize());
       }
-
-      hDoc += recipeFormatter->buildHtmlFooter();
-   } else if (verticalTabWidget->currentIndex() == 1) {
-      InventoryFormatter::HtmlGenerationFlags flags;
-      if (checkBox_inventoryFermentables->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::FERMENTABLES ; }
-      if (checkBox_inventoryHops->isChecked()        ) { flags |= InventoryFormatter::HtmlGenerationFlag::HOPS         ; }
-      if (checkBox_inventoryYeast->isChecked()       ) { flags |= InventoryFormatter::HtmlGenerationFlag::YEAST        ; }
-      if (checkBox_inventoryMicellaneous->isChecked()) { flags |= InventoryFormatter::HtmlGenerationFlag::MISCELLANEOUS; }
-
-      hDoc += InventoryFormatter::createInventoryHtml(flags);
    }
 
-   // Render the page onto the painter/printer for preview/printing.
-   textBrowser.setHtml(hDoc);
-   textBrowser.print(printer);
+   printPaginatedDocument(*this->printPreviewDocument, *printer, this->logicalDpiX());
 
    return;
 }
@@ -19,16 +19,22 @@
 #pragma once
 #include "ui_BtPrintAndPreview.h"
 
+#include <memory>
+
 #include <QDialog>
 #include <QMap>
 #include <QPageSize>
 #include <QPrinter>
 #include <QPrintPreviewWidget>
+#include <QSizeF>
 #include <QString>
 #include <QTextBrowser>
+#include <QTextDocument>
+#include <QTimer>
 #include <QWidget>
 
 #include "BrewDayFormatter.h"
+#include "InventoryFormatter.h"
 #include "MainWindow.h"
 #include "model/Recipe.h"
 #include "RecipeFormatter.h"
@@ -122,10 +128,49 @@ private:
    void handlePrinting();
 
    /**
-    * @brief Updates the preview to the currently set options.
+    * @brief Updates the preview to the currently set options.  The actual work is done, after a short delay, by
+    *        \c startPreviewJob, so that a burst of changes (eg "Inventory All" toggling four other checkboxes) only
+    *        results in one new preview.
     */
    void updatePreview();
 
+   /**
+    * @brief Generates the HTML for the current options, parses it and, for paper or PDF output, starts paginating it
+    *        (see \c paginateNextChunk).  Any pagination still in progress for an earlier request is abandoned.
+    */
+   void startPreviewJob();
+
+   /**
+    * @brief Lays out the next part of \c paginatingDocument, then returns to the event loop.  Called repeatedly by
+    *        \c paginationTimer until the whole document is paginated, at which point the document is accepted.
+    */
+   void paginateNextChunk();
+
+   /**
+    * @brief Abandon any preview update waiting or in progress and regenerate the preview now, synchronously.  Used
+    *        before printing or saving, so that what we output always matches the current options and data, even if
+    *        nothing has asked for a new preview since the data changed.
+    */
+   void rebuildPreviewNow();
+
+   /**
+    * @brief Show a newly built (and, if it is for paper or PDF, paginated) document in the relevant preview widget
+    */
+   void acceptPreviewDocument(std::shared_ptr<QTextDocument> document, bool const forHtmlOutput);
+
+   /**
+    * @brief Generates the HTML for the currently selected tab and options
+    *
+    * @param forHtmlOutput \c true if the result is for the HTML preview/output, \c false if it is for paper or PDF
+    */
+   QString buildDocumentHtml(bool const forHtmlOutput);
+
+   /**
+    * @brief The size, in pixels at screen resolution, of the printable area of a page, which is what we paginate the
+    *        document to.
+    */
+   QSizeF previewPageSize() const;
+
    QPrintPreviewWidget* previewWidget;
    RecipeFormatter* recipeFormatter;
    BrewDayFormatter* brewDayFormatter;
@@ -136,5 +181,20 @@ private:
    QTextBrowser *htmlDocument;
    QPageSize currentlySelectedPageSize;
 
+   //! Single-shot timer used to coalesce bursts of calls to \c updatePreview
+   QTimer * previewTimer;
+   //! Zero-interval timer that drives \c paginateNextChunk while \c paginatingDocument is being paginated
+   QTimer * paginationTimer;
+   //! Document for paper or PDF preview that is part way through being paginated, or \c nullptr if there isn't one
+   std::shared_ptr<QTextDocument> paginatingDocument;
+   //! How far through \c paginatingDocument (as a character position) we have laid out
+   int paginatedToPosition;
+   //! Document shown in \c htmlDocument (which does not take ownership of it)
+   std::shared_ptr<QTextDocument> htmlPreviewDocument;
+   //! Parsed and paginated document from which \c printDocument renders pages
+   std::shared_ptr<QTextDocument> printPreviewDocument;
+   //! Inventory tables generated for earlier previews
+   InventoryFormatter::TableCache inventoryTableCache;
+
 };
 #endif
@@ -56,6 +56,7 @@
 #include "model/Water.h"
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
+#include "utils/HtmlFragmentCache.h"
 
 #ifdef BUILDING_WITH_CMAKE
    // Explicitly doing this include reduces potential problems with AUTOMOC when compiling with CMake
@@ -147,6 +148,32 @@ namespace {
       return sorted;
    }
 
+   /**
+    * \return The supplied additions and the ingredients they add, which is what the corresponding HTML table depends
+    *         on for \c HtmlFragmentCache purposes.
+    */
+   template<class RA>
+   QList<NamedEntity const *> additionsAndIngredients(QList<std::shared_ptr<RA>> const & additions) {
+      QList<NamedEntity const *> dependencies;
+      for (auto const & addition : additions) {
+         dependencies.append(addition.get());
+         dependencies.append(addition->ingredient().get());
+      }
+      return dependencies;
+   }
+
+   /**
+    * \return The supplied list of owned objects (eg instructions) as \c HtmlFragmentCache dependencies
+    */
+   template<class NE>
+   QList<NamedEntity const *> asDependencies(QList<std::shared_ptr<NE>> const & items) {
+      QList<NamedEntity const *> dependencies;
+      for (auto const & item : items) {
+         dependencies.append(item.get());
+      }
+      return dependencies;
+   }
+
 }
 
 
@@ -154,11 +181,28 @@ namespace {
 class RecipeFormatter::impl {
 public:
 
+   /**
+    * \brief The sections of the HTML view, each of which is cached separately in \c fragmentCache
+    */
+   enum class HtmlSection {
+      Stats       ,
+      Fermentables,
+      Hops        ,
+      Miscs       ,
+      Yeasts      ,
+      Mash        ,
+      Notes       ,
+      Instructions,
+      BrewNotes   ,
+   };
+
    /**
     * Constructor
     */
-   impl() : textSeparator{nullptr},
-            rec{nullptr} {
+   impl(RecipeFormatter & self) : textSeparator{nullptr},
+                                  rec{nullptr},
+                                  fragmentCache{"RecipeFormatter", self} {
+      this->addHtmlSections();
       return;
    }
 
@@ -226,15 +270,15 @@ public:
    //! Get an HTML view.
    QString getHtmlFormat() {
       QString pDoc = this->buildHtmlHeader();
-      pDoc += this->buildStatTableHtml();
-      pDoc += this->buildFermentableTableHtml();
-      pDoc += this->buildHopsTableHtml();
-      pDoc += this->buildMiscTableHtml();
-      pDoc += this->buildYeastTableHtml();
-      pDoc += this->buildMashTableHtml();
-      pDoc += this->buildNotesHtml();
-      pDoc += this->buildInstructionTableHtml();
-      pDoc += this->buildBrewNotesHtml();
+      pDoc += this->cachedHtml(HtmlSection::Stats       );
+      pDoc += this->cachedHtml(HtmlSection::Fermentables);
+      pDoc += this->cachedHtml(HtmlSection::Hops        );
+      pDoc += this->cachedHtml(HtmlSection::Miscs       );
+      pDoc += this->cachedHtml(HtmlSection::Yeasts      );
+      pDoc += this->cachedHtml(HtmlSection::Mash        );
+      pDoc += this->cachedHtml(HtmlSection::Notes       );
+      pDoc += this->cachedHtml(HtmlSection::Instructions);
+      pDoc += this->cachedHtml(HtmlSection::BrewNotes   );
 
       pDoc += this->buildHtmlFooter();
 
@@ -1075,14 +1119,109 @@ public:
       return "</div></body></html>";
    }
 
+   /**
+    * \brief Tell \c fragmentCache how to build each section of the HTML view and what each one depends on.  The stats
+    *        table shows a lot of calculated values, so we rebuild it whenever anything on the recipe changes.  The other
+    *        tables only depend on their own slice of the recipe.
+    */
+   void addHtmlSections() {
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Stats),
+         {},
+         [this]() {
+            QList<NamedEntity const *> dependencies;
+            if (this->rec) {
+               dependencies.append(this->rec->style().get());
+               dependencies.append(this->rec->equipment().get());
+            }
+            return dependencies;
+         },
+         [this]() { return this->buildStatTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Fermentables),
+         {&PropertyNames::Recipe::fermentableAdditions, &PropertyNames::Recipe::grains_kg},
+         [this]() {
+            return this->rec ? additionsAndIngredients(this->rec->fermentableAdditions()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildFermentableTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Hops),
+         {&PropertyNames::Recipe::hopAdditions, &PropertyNames::Recipe::IBU},
+         [this]() {
+            return this->rec ? additionsAndIngredients(this->rec->hopAdditions()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildHopsTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Miscs),
+         {&PropertyNames::Recipe::miscAdditions},
+         [this]() {
+            return this->rec ? additionsAndIngredients(this->rec->miscAdditions()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildMiscTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Yeasts),
+         {&PropertyNames::Recipe::yeastAdditions},
+         [this]() {
+            return this->rec ? additionsAndIngredients(this->rec->yeastAdditions()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildYeastTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Mash),
+         {&PropertyNames::Recipe::mash},
+         [this]() {
+            QList<NamedEntity const *> dependencies;
+            if (this->rec && this->rec->mash()) {
+               dependencies = asDependencies(this->rec->mash()->mashSteps());
+               dependencies.append(this->rec->mash().get());
+            }
+            return dependencies;
+         },
+         [this]() { return this->buildMashTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Notes),
+         {&PropertyNames::Recipe::notes},
+         []() { return QList<NamedEntity const *>{}; },
+         [this]() { return this->buildNotesHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::Instructions),
+         {&PropertyNames::Recipe::instructions},
+         [this]() {
+            return this->rec ? asDependencies(this->rec->instructions()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildInstructionTableHtml(); }
+      );
+      this->fragmentCache.addSection(
+         static_cast<int>(HtmlSection::BrewNotes),
+         {&PropertyNames::Recipe::brewNotes},
+         [this]() {
+            return this->rec ? asDependencies(this->rec->brewNotes()) : QList<NamedEntity const *>{};
+         },
+         [this]() { return this->buildBrewNotesHtml(); }
+      );
+      return;
+   }
+
+   //! \return The HTML for the supplied section of the current recipe, from the cache if possible
+   QString cachedHtml(HtmlSection const section) {
+      return this->fragmentCache.fragment(static_cast<int>(section));
+   }
+
    std::unique_ptr<QString> textSeparator;
    Recipe* rec;
+   HtmlFragmentCache fragmentCache;
 
 };
 
 
 RecipeFormatter::RecipeFormatter(QWidget* parent) : QObject{parent},
-                                                    pimpl{std::make_unique<impl>()} {
+                                                    pimpl{std::make_unique<impl>(*this)} {
    return;
 }
 
@@ -1093,6 +1232,7 @@ RecipeFormatter::~RecipeFormatter() = default;
 
 void RecipeFormatter::setRecipe(Recipe* recipe) {
    this->pimpl->rec = recipe;
+   this->pimpl->fragmentCache.setOwner(recipe);
    return;
 }
 
@@ -1131,15 +1271,20 @@ QString RecipeFormatter::getHtmlFormat(QList<Recipe*> recipes) {
 }
 
 QString RecipeFormatter::getHtmlFormat() {
+   //
+   // Each section comes from the fragment cache, so only the sections whose inputs have changed since the last call
+   // actually get rebuilt.
+   //
+   using HtmlSection = RecipeFormatter::impl::HtmlSection;
    QString pDoc = this->pimpl->buildHtmlHeader();
-   pDoc += this->pimpl->buildStatTableHtml();
-   pDoc += this->pimpl->buildFermentableTableHtml();
-   pDoc += this->pimpl->buildHopsTableHtml();
-   pDoc += this->pimpl->buildMiscTableHtml();
-   pDoc += this->pimpl->buildYeastTableHtml();
-   pDoc += this->pimpl->buildMashTableHtml();
-   pDoc += this->pimpl->buildNotesHtml();
-   pDoc += this->pimpl->buildBrewNotesHtml();
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Stats       );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Fermentables);
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Hops        );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Miscs       );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Yeasts      );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Mash        );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::Notes       );
+   pDoc += this->pimpl->cachedHtml(HtmlSection::BrewNotes   );
    pDoc += this->pimpl->buildHtmlFooter();
 
    return pDoc;
@@ -22,6 +22,7 @@
 #include <QButtonGroup>
 
 #include "config.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
 #include "qtModels/listModels/EquipmentListModel.h"
 #include "model/Boil.h"
@@ -80,6 +81,9 @@ void ScaleRecipeTool::scale(Equipment* equip, double newEff) {
 
    auto equipment = ObjectStoreWrapper::getSharedFromRaw(equip);
 
+   // Scaling updates every addition in the Recipe, so we want all the resulting writes in one DB transaction
+   DbUnitOfWork unitOfWork{"Scale Recipe"};
+
    // Calculate volume ratio
    double currentBatchSize_l = m_recObs->batchSize_l();
    double newBatchSize_l = equipment->fermenterBatchSize_l();
@@ -38,6 +38,7 @@
 #include <QToolButton>
 
 #include "database/ObjectStoreWrapper.h"
+#include "database/SearchIndex.h"
 #include "MainWindow.h"
 #include "model/Ingredient.h"
 #include "utils/BtStringStream.h"
@@ -235,6 +236,8 @@ public:
       this->derived().setContextMenuPolicy(Qt::CustomContextMenu);
       this->derived().connect(&this->derived(), &QWidget::customContextMenuRequested, &this->derived(), &Derived::contextMenu);
 
+      // Catalogs can be large, and only change through our own edits, so it's worth caching the formatted cell data
+      this->m_neTableModel->setCellCacheEnabled(true);
       this->m_neTableModel->observeDatabase(true);
 
       return;
@@ -623,8 +626,12 @@ public:
     * \brief Subclass should call this from its \c filterItems slot
     */
    void filter(QString searchExpression) {
-      m_sortFilterProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-      m_sortFilterProxy->setFilterFixedString(searchExpression);
+      //
+      // Rather than have the proxy model do a substring match on every row, we look up matches (in name, notes, etc) in
+      // the full-text index.  A blank search expression shows everything.  The proxy re-runs the search whenever the
+      // index changes.
+      //
+      this->m_sortFilterProxy->setSearch(SearchIndex::instance<NE>(), searchExpression);
       return;
    }
 
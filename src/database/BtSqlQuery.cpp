@@ -18,11 +18,36 @@
 #include <stdexcept>
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlDriver>
 #include <QSqlError>
+#include <QStringList>
 
+#include "database/QueryStats.h"
 #include "Logging.h"
 
+BtSqlQuery::BtSqlQuery(QSqlDatabase const & db) :
+   QSqlQuery{db},
+   bt_connection{db} {
+   return;
+}
+
+BtSqlQuery::~BtSqlQuery() {
+   this->recordRowsReturned();
+   return;
+}
+
+void BtSqlQuery::recordRowsReturned() {
+   if (this->bt_countingRows) {
+      QueryStats::recordRows(this->bt_query, this->bt_rowsReturned);
+      this->bt_countingRows = false;
+   }
+   this->bt_rowsReturned = 0;
+   return;
+}
+
 bool BtSqlQuery::prepare(const QString & query) {
+   this->recordRowsReturned();
    //
    // We don't want to call QSqlQuery::prepare() because if there are no bind values and the DB is PostgreSQL then we'll
    // get an error.
@@ -71,6 +96,10 @@ void BtSqlQuery::bindValue(int pos, const QVariant &val, QSql::ParamType paramTy
    *        as a parameter
    */
 bool BtSqlQuery::exec() {
+   this->recordRowsReturned();
+
+   QElapsedTimer timer;
+   timer.start();
    bool result;
    if (this->bt_boundValues) {
       result = this->QSqlQuery::exec();
@@ -79,9 +108,82 @@ bool BtSqlQuery::exec() {
       // pass it to QSqlQuery for execution
       result = this->QSqlQuery::exec(this->bt_query);
    }
+   qint64 const elapsed_ns = timer.nsecsElapsed();
+
+   QueryStats::recordExecution(this->bt_query, elapsed_ns);
+   if (result) {
+      if (this->isSelect()) {
+         this->bt_countingRows = true;
+      } else {
+         QueryStats::recordRows(this->bt_query, this->numRowsAffected());
+      }
+   }
+   int const threshold_ms = QueryStats::slowQueryThreshold_ms();
+   if (threshold_ms >= 0 && elapsed_ns > static_cast<qint64>(threshold_ms) * 1000000) {
+      this->logSlowQuery(elapsed_ns);
+   }
 
    // If someone wants to reuse the object, eg to insert multiple rows with the same query, it's already in the correct
    // state (whether or not there were bound variables, so we're done here.
 
    return result;
 }
+
+bool BtSqlQuery::exec(QString const & query) {
+   this->prepare(query);
+   return this->exec();
+}
+
+bool BtSqlQuery::next() {
+   bool const result = this->QSqlQuery::next();
+   if (result) {
+      ++this->bt_rowsReturned;
+   }
+   return result;
+}
+
+void BtSqlQuery::logSlowQuery(qint64 const elapsed_ns) {
+   qWarning().noquote() <<
+      Q_FUNC_INFO << "Slow query (" << QString::number(static_cast<double>(elapsed_ns) / 1.0e6, 'f', 1) <<
+      "ms, threshold" << QueryStats::slowQueryThreshold_ms() << "ms):" << this->bt_query.simplified();
+   if (this->bt_boundValues) {
+      qWarning() << Q_FUNC_INFO << "Bound values:" << this->boundValues();
+   }
+
+   //
+   // On SQLite, we can also ask how the query was executed.  We need a separate query object for this so as not to
+   // disturb the results of this one (which the caller has yet to read), and we use QSqlQuery rather than BtSqlQuery
+   // so the EXPLAIN itself doesn't get timed and, potentially, explained.
+   //
+   if (!this->bt_connection.isValid() ||
+       !this->bt_connection.driver() ||
+       this->bt_connection.driver()->dbmsType() != QSqlDriver::SQLite) {
+      return;
+   }
+   QSqlQuery explainQuery{this->bt_connection};
+   bool explained = false;
+   if (this->bt_boundValues) {
+      if (explainQuery.prepare(QString{"EXPLAIN QUERY PLAN %1"}.arg(this->bt_query))) {
+         for (QVariant const & boundValue : this->boundValues()) {
+            explainQuery.addBindValue(boundValue);
+         }
+         explained = explainQuery.exec();
+      }
+   } else {
+      explained = explainQuery.exec(QString{"EXPLAIN QUERY PLAN %1"}.arg(this->bt_query));
+   }
+   if (!explained) {
+      qWarning() << Q_FUNC_INFO << "Unable to get query plan:" << explainQuery.lastError().text();
+      return;
+   }
+   //
+   // EXPLAIN QUERY PLAN gives one row per step, with columns id, parent, notused, detail.  The detail column is the
+   // useful bit (eg "SCAN hop" vs "SEARCH hop USING INDEX ...").
+   //
+   QStringList planSteps;
+   while (explainQuery.next()) {
+      planSteps.append(explainQuery.value(3).toString());
+   }
+   qWarning().noquote() << Q_FUNC_INFO << "Query plan:" << planSteps.join("; ");
+   return;
+}
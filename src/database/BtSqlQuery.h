@@ -17,8 +17,9 @@
 #define DATABASE_BTSQLQUERY_H
 #pragma once
 
-#include <QString>
+#include <QSqlDatabase>
 #include <QSqlQuery>
+#include <QString>
 
 /**
  * \class BtSqlQuery is an extension of \c QSqlQuery with more helpful behaviour around prepared statements
@@ -47,6 +48,10 @@
  *        Note that a syntax error in a prepared statement will not get reported until the first call to \c bindValue()
  *        (and will be reported via logging + run-time exception rather than return value), but otherwise behaviour
  *        should be similar to the way you would want \c QSqlQuery to work.
+ *
+ *        Every execution is also timed and recorded in \c QueryStats, along with the number of rows affected or (as
+ *        they are read with \c next()) returned.  Executions slower than \c QueryStats::slowQueryThreshold_ms are
+ *        logged.
  */
 class BtSqlQuery : public QSqlQuery {
 public:
@@ -56,6 +61,9 @@ public:
    // meant to be copied. Use move construction instead.").  So, let's not do copy construction!
    BtSqlQuery(BtSqlQuery const & other) = delete;
    BtSqlQuery(QSqlQuery const & other) = delete;
+   // ...and we want to remember the connection, if we're given it, so we can ask it to explain slow queries.
+   explicit BtSqlQuery(QSqlDatabase const & db);
+   ~BtSqlQuery();
 
    /**
     * \brief As \c QSqlQuery::prepare() except we don't actually call QSqlQuery::prepare() unless and until a value is
@@ -67,22 +75,34 @@ public:
    void bindValue(const QString &placeholder, const QVariant &val, QSql::ParamType paramType = QSql::In);
    void bindValue(int pos, const QVariant &val, QSql::ParamType paramType = QSql::In);
 
-   // Allow access to the version of QSqlQuery::exec() that we don't override
-   using QSqlQuery::exec;
-
    /**
     * \brief As \c QSqlQuery::exec() except that if no values were bound to the query, we pass the SQL from \c prepare()
     *        as a parameter
     */
    bool exec();
 
+   //! \brief Equivalent to calling \c prepare() then \c exec() with no bound values
+   bool exec(QString const & query);
+
+   //! \brief As \c QSqlQuery::next() but also counts the rows returned, for \c QueryStats
+   bool next();
+
 private:
    // We need to be careful about names to avoid clashes with anything in the base class
    QString bt_query;
    bool bt_boundValues = false;
+   QSqlDatabase bt_connection;
+   //! Set if the last exec() was a successful SELECT, in which case we count the rows as they are read
+   bool bt_countingRows = false;
+   qint64 bt_rowsReturned = 0;
 
    void reallyPrepare();
 
+   //! \brief Pass on to \c QueryStats the count of rows read since the last exec (if any)
+   void recordRowsReturned();
+
+   void logSlowQuery(qint64 const elapsed_ns);
+
    // This is deprecated in the base class
    BtSqlQuery & operator=(BtSqlQuery const & other) = delete;
 };
@@ -0,0 +1,303 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/ChangeJournal.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/ChangeJournal.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QPair>
+#include <QSqlError>
+#include <QTimer>
+
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/DbWriter.h"
+#include "Logging.h"
+
+namespace {
+   /**
+    * \brief Once this many entries are buffered, we write them out without waiting for the timer.  The number is not
+    *        critical: it just needs to be big enough that we are not writing to the DB on every edit.
+    */
+   int constexpr flushThreshold = 256;
+
+   //! How long after the first entry is added to an empty buffer we write the buffer out
+   int constexpr flushInterval_ms = 2000;
+
+   char const * operationToString(DbChangeNotifier::Operation const operation) {
+      switch (operation) {
+         case DbChangeNotifier::Operation::Insert: return "insert";
+         case DbChangeNotifier::Operation::Update: return "update";
+         case DbChangeNotifier::Operation::Delete: return "delete";
+         // No default case needed as compiler should warn us if any options covered above
+      }
+      // It's a coding error if we get here!
+      Q_UNREACHABLE();
+   }
+
+   DbChangeNotifier::Operation operationFromString(QString const & operation) {
+      if (operation == "insert") { return DbChangeNotifier::Operation::Insert; }
+      if (operation == "delete") { return DbChangeNotifier::Operation::Delete; }
+      return DbChangeNotifier::Operation::Update;
+   }
+
+   /**
+    * \brief Write a batch of entries to the journal.  The caller is responsible for the transaction.
+    */
+   bool writeEntries(QSqlDatabase & connection, QVector<ChangeJournal::Entry> const & entries) {
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(
+         "INSERT INTO change_journal (table_name, row_id, operation, columns, changed_at) "
+         "VALUES (:table_name, :row_id, :operation, :columns, :changed_at);"
+      );
+      for (auto const & entry : entries) {
+         sqlQuery.bindValue(":table_name", entry.tableName                            );
+         sqlQuery.bindValue(":row_id"    , entry.id                                   );
+         sqlQuery.bindValue(":operation" , operationToString(entry.operation)         );
+         sqlQuery.bindValue(":columns"   , entry.columnNames.join(',')                );
+         sqlQuery.bindValue(":changed_at", entry.timestamp.toString(Qt::ISODateWithMs));
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error writing change journal entry for" << entry.tableName << "#" << entry.id << ":" <<
+               sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
+   }
+}
+
+// This private implementation class holds all private non-virtual members of ChangeJournal
+class ChangeJournal::impl {
+public:
+   impl() :
+      m_mutex{},
+      m_pending{},
+      m_pendingUpdates{} {
+      return;
+   }
+
+   ~impl() = default;
+
+   //! Caller must hold m_mutex
+   QVector<Entry> takePending() {
+      QVector<Entry> entries;
+      entries.swap(this->m_pending);
+      this->m_pendingUpdates.clear();
+      return entries;
+   }
+
+   /**
+    * \brief Make sure everything recorded so far is in the DB.  Writes queued on the DB writer can themselves record
+    *        journal entries when they run, so we need to wait for them both before and after flushing our buffer.
+    */
+   void writeOutEverything(ChangeJournal & changeJournal) {
+      DbWriter & dbWriter = DbWriter::instance();
+      dbWriter.flush();
+      changeJournal.flush();
+      dbWriter.flush();
+      return;
+   }
+
+   //! Arrange for \c flush to be called soon on the main thread, whichever thread we are called on
+   void scheduleFlush() {
+      QCoreApplication * application = QCoreApplication::instance();
+      if (!application) {
+         return;
+      }
+      QMetaObject::invokeMethod(
+         application,
+         [application]() {
+            QTimer::singleShot(flushInterval_ms, application, []() { ChangeJournal::instance().flush(); });
+            return;
+         },
+         Qt::QueuedConnection
+      );
+      return;
+   }
+
+   mutable std::mutex m_mutex;
+   QVector<Entry> m_pending;
+   /**
+    * \brief For each object with a pending insert or update, the index of that entry in \c m_pending.  This is how we
+    *        merge several updates to the same object into one entry.
+    */
+   QHash<QPair<QString, int>, qsizetype> m_pendingUpdates;
+};
+
+ChangeJournal::ChangeJournal() : pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+ChangeJournal::~ChangeJournal() = default;
+
+ChangeJournal & ChangeJournal::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static ChangeJournal changeJournal;
+   return changeJournal;
+}
+
+void ChangeJournal::record(DbChangeNotifier::Operation const operation,
+                           QString const & tableName,
+                           int const id,
+                           QStringList const & columnNames) {
+   QDateTime const now = QDateTime::currentDateTimeUtc();
+   bool scheduleFlush = false;
+   bool flushNow = false;
+   {
+      std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+      QPair<QString, int> const key{tableName, id};
+
+      if (operation == DbChangeNotifier::Operation::Update && this->pimpl->m_pendingUpdates.contains(key)) {
+         //
+         // Merge into the pending entry.  If that's an insert, it already covers every column.  If it's an update with
+         // no columns, it already covers every column too.
+         //
+         Entry & pending = this->pimpl->m_pending[this->pimpl->m_pendingUpdates.value(key)];
+         pending.timestamp = now;
+         if (pending.operation == DbChangeNotifier::Operation::Update && !pending.columnNames.isEmpty()) {
+            if (columnNames.isEmpty()) {
+               pending.columnNames.clear();
+            } else {
+               for (QString const & columnName : columnNames) {
+                  if (!pending.columnNames.contains(columnName)) {
+                     pending.columnNames.append(columnName);
+                  }
+               }
+            }
+         }
+         return;
+      }
+
+      scheduleFlush = this->pimpl->m_pending.isEmpty();
+      if (operation == DbChangeNotifier::Operation::Delete) {
+         this->pimpl->m_pendingUpdates.remove(key);
+      } else {
+         this->pimpl->m_pendingUpdates.insert(key, this->pimpl->m_pending.size());
+      }
+      this->pimpl->m_pending.append(Entry{0, tableName, id, operation, columnNames, now});
+      flushNow = this->pimpl->m_pending.size() >= flushThreshold;
+   }
+
+   if (flushNow) {
+      this->flush();
+   } else if (scheduleFlush) {
+      this->pimpl->scheduleFlush();
+   }
+   return;
+}
+
+void ChangeJournal::flush() {
+   QVector<Entry> entries;
+   {
+      std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+      entries = this->pimpl->takePending();
+   }
+   if (entries.isEmpty()) {
+      return;
+   }
+
+   qCDebug(logDb) << Q_FUNC_INFO << "Writing" << entries.size() << "change journal entries";
+   //
+   // If the DB writer is running, this gets queued behind the writes it is journaling.  Otherwise, it is written now, in
+   // one transaction.
+   //
+   DbWriter::instance().enqueue(
+      QString{"Write %1 change journal entries"}.arg(entries.size()),
+      [entries](QSqlDatabase & connection) { return writeEntries(connection, entries); }
+   );
+   return;
+}
+
+int ChangeJournal::numPending() const {
+   std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+   return static_cast<int>(this->pimpl->m_pending.size());
+}
+
+QVector<ChangeJournal::Entry> ChangeJournal::changesSince(qint64 const cursor, int const maxEntries) {
+   this->pimpl->writeOutEverything(*this);
+
+   QString queryString{
+      "SELECT seq, table_name, row_id, operation, columns, changed_at "
+      "FROM change_journal "
+      "WHERE seq > :cursor "
+      "ORDER BY seq"
+   };
+   if (maxEntries >= 0) {
+      queryString += QString{" LIMIT %1"}.arg(maxEntries);
+   }
+   queryString += ";";
+
+   QVector<Entry> entries;
+   BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+   sqlQuery.prepare(queryString);
+   sqlQuery.bindValue(":cursor", cursor);
+   if (!sqlQuery.exec()) {
+      qCritical() << Q_FUNC_INFO << "Error reading change journal:" << sqlQuery.lastError().text();
+      return entries;
+   }
+   while (sqlQuery.next()) {
+      QString const columns = sqlQuery.value(4).toString();
+      entries.append(Entry{
+         sqlQuery.value(0).toLongLong(),
+         sqlQuery.value(1).toString(),
+         sqlQuery.value(2).toInt(),
+         operationFromString(sqlQuery.value(3).toString()),
+         columns.isEmpty() ? QStringList{} : columns.split(','),
+         QDateTime::fromString(sqlQuery.value(5).toString(), Qt::ISODateWithMs)
+      });
+   }
+   return entries;
+}
+
+qint64 ChangeJournal::latestSequence() {
+   this->pimpl->writeOutEverything(*this);
+
+   BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+   sqlQuery.prepare("SELECT MAX(seq) FROM change_journal;");
+   if (!sqlQuery.exec() || !sqlQuery.next()) {
+      qCritical() << Q_FUNC_INFO << "Error reading change journal:" << sqlQuery.lastError().text();
+      return 0;
+   }
+   // MAX() of no rows is NULL, which converts to 0
+   return sqlQuery.value(0).toLongLong();
+}
+
+int ChangeJournal::prune(qint64 const upToSequence, int const maxEntries) {
+   //
+   // Neither SQLite (unless compiled with a non-default option) nor PostgreSQL supports LIMIT on DELETE, so we have to
+   // select the entries to delete in a sub-query.
+   //
+   BtSqlQuery sqlQuery{Database::instance().sqlDatabase()};
+   sqlQuery.prepare(
+      QString{
+         "DELETE FROM change_journal "
+         "WHERE seq IN (SELECT seq FROM change_journal WHERE seq <= :upToSequence ORDER BY seq LIMIT %1);"
+      }.arg(maxEntries)
+   );
+   sqlQuery.bindValue(":upToSequence", upToSequence);
+   if (!sqlQuery.exec()) {
+      qCritical() << Q_FUNC_INFO << "Error pruning change journal:" << sqlQuery.lastError().text();
+      return 0;
+   }
+   int const numPruned = sqlQuery.numRowsAffected();
+   qCDebug(logDb) << Q_FUNC_INFO << "Pruned" << numPruned << "change journal entries up to" << upToSequence;
+   return std::max(numPruned, 0);
+}
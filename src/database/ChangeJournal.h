@@ -0,0 +1,117 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/ChangeJournal.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_CHANGEJOURNAL_H
+#define DATABASE_CHANGEJOURNAL_H
+#pragma once
+
+#include <memory>
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "database/DbChangeNotifier.h"
+
+/**
+ * \brief Records, in the \c change_journal DB table, every insert, update and delete that \c ObjectStore makes, so
+ *        that other code (eg a delta export, or a mirror of the DB) can find out what changed since it last looked,
+ *        without having to compare everything.
+ *
+ *        Each journal entry gets a sequence number (assigned by the DB, so always increasing), which callers use as a
+ *        cursor: remember the sequence number of the last entry you processed, and pass it to \c changesSince next
+ *        time.
+ *
+ *        To keep the cost off normal edits, \c ObjectStore does not write to the journal itself.  Instead, after each
+ *        successful write, it calls \c record, which just adds to an in-memory buffer.  The buffer is written out, in
+ *        one transaction, when it gets big enough, shortly after the first entry is added to it, when anyone reads the
+ *        journal, and when the DB is closed.  Whilst entries are in the buffer, several updates to the same object are
+ *        merged into one entry.
+ *
+ *        Note that the journal is a hint about what to look at, rather than an exact history.  Eg, if the process
+ *        crashes, changes in the last couple of seconds will not be journaled, and a change that was part of a
+ *        transaction that later rolled back may be.
+ */
+class ChangeJournal {
+public:
+   struct Entry {
+      qint64                      sequence;
+      QString                     tableName;
+      int                         id;
+      DbChangeNotifier::Operation operation;
+      //! Empty for inserts and deletes, and for updates that could have changed any column
+      QStringList                 columnNames;
+      //! UTC
+      QDateTime                   timestamp;
+   };
+
+   static ChangeJournal & instance();
+
+   /**
+    * \brief Note a change that has been written to the DB.  Can be called from any thread.
+    */
+   void record(DbChangeNotifier::Operation const operation,
+               QString const & tableName,
+               int const id,
+               QStringList const & columnNames = {});
+
+   /**
+    * \brief Write out any buffered entries.  If the DB writer is running, and we're not on it, the write is queued
+    *        there, so this does not block.  (Anything that reads the journal first waits for the DB writer.)
+    */
+   void flush();
+
+   //! \return Number of entries recorded but not yet written to the DB
+   int numPending() const;
+
+   /**
+    * \brief Get the journal entries after \c cursor (ie with sequence number greater than it), oldest first
+    *
+    * \param cursor     Sequence number of the last entry already seen, or 0 to get everything
+    * \param maxEntries If non-negative, return at most this many entries
+    */
+   QVector<Entry> changesSince(qint64 const cursor, int const maxEntries = -1);
+
+   //! \return Sequence number of the latest entry in the journal, or 0 if it is empty
+   qint64 latestSequence();
+
+   /**
+    * \brief Delete journal entries that are no longer needed, oldest first.  Nothing stops the journal growing
+    *        otherwise.
+    *
+    * \param upToSequence Entries with this sequence number or lower are deleted
+    * \param maxEntries   Delete at most this many entries, so that the caller can do a big prune a bit at a time
+    *
+    * \return Number of entries deleted
+    */
+   int prune(qint64 const upToSequence, int const maxEntries);
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   ChangeJournal();
+   ~ChangeJournal();
+
+   // Singleton shouldn't be getting copied or moved
+   ChangeJournal(ChangeJournal const &) = delete;
+   ChangeJournal & operator=(ChangeJournal const &) = delete;
+   ChangeJournal(ChangeJournal &&) = delete;
+   ChangeJournal & operator=(ChangeJournal &&) = delete;
+};
+
+#endif
@@ -59,8 +59,14 @@
 #include "Application.h"
 #include "config.h"
 #include "database/BtSqlQuery.h"
+#include "database/ChangeJournal.h"
 #include "database/DefaultContentLoader.h"
 #include "database/DatabaseSchemaHelper.h"
+#include "database/DbChangeNotifier.h"
+#include "database/DbMaintenance.h"
+#include "database/DbWriter.h"
+#include "database/StartupSnapshot.h"
+#include "Logging.h"
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
 #include "utils/EnumStringMapping.h"
@@ -234,6 +240,9 @@ public:
                                    dbConName{},
                                    loaded{false},
                                    loadWasSuccessful{false},
+                                   restartWriterOnLoad{false},
+                                   restartNotifierOnLoad{false},
+                                   restartMaintenanceOnLoad{false},
                                    mutex{},
                                    userDatabaseDidNotExist{false} {
       return;
@@ -246,7 +255,7 @@ public:
 
    // Don't know where to put this, so it goes here for right now
    bool loadSQLite(Database & database) {
-      qDebug() << "Loading SQLITE...";
+      qCDebug(logDb) << "Loading SQLITE...";
 
       // Set file names.
       this->dbFileName = PersistentSettings::getUserDataDir().filePath("database.sqlite");
@@ -287,7 +296,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(logDb) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -370,7 +379,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(logDb) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -514,7 +523,7 @@ public:
             dbUpgradeMessageBox.setDefaultButton(QMessageBox::Ok);
             int ret = dbUpgradeMessageBox.exec();
             if (ret == QMessageBox::Abort) {
-               qDebug() << Q_FUNC_INFO << "User clicked \"Abort\".  Exiting.";
+               qCDebug(logDb) << Q_FUNC_INFO << "User clicked \"Abort\".  Exiting.";
                Application::abort();
             }
          }
@@ -625,6 +634,14 @@ public:
    bool createFromScratch;
    bool schemaUpdated;
 
+   //
+   // Whether the DB writer, change notifier and maintenance were running when we last unloaded, so that load() can
+   // start them again (eg after restoring from a backup, which unloads and then reloads the DB).
+   //
+   bool restartWriterOnLoad;
+   bool restartNotifierOnLoad;
+   bool restartMaintenanceOnLoad;
+
    // Used for locking member functions that must be single-threaded
    QMutex mutex;
 
@@ -681,7 +698,7 @@ QSqlDatabase Database::sqlDatabase() const {
    Q_ASSERT(!connectionName.isEmpty());
    QSqlDatabase connection = QSqlDatabase::database(connectionName);
    if (connection.isValid()) {
-      qDebug() << Q_FUNC_INFO << "Returning connection " << connectionName;
+      qCDebug(logDb) << Q_FUNC_INFO << "Returning connection " << connectionName;
       return connection;
    }
 
@@ -690,7 +707,7 @@ QSqlDatabase Database::sqlDatabase() const {
    // safe, so we don't need to worry about mutexes here.)
    //
    QString driverType{this->pimpl->dbType == Database::DbType::PGSQL ? "QPSQL" : "QSQLITE"};
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Creating connection " << connectionName << " with " << driverType << " driver";
    connection = QSqlDatabase::addDatabase(driverType, connectionName);
    if (!connection.isValid()) {
@@ -701,7 +718,7 @@ QSqlDatabase Database::sqlDatabase() const {
       qCritical() << Q_FUNC_INFO << "Unable to load " << driverType << " database driver";
    }
 
-   qDebug() << Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
+   qCDebug(logDb) << Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
 
    //
    // Initialisation parameters depend on the DB type
@@ -793,19 +810,38 @@ bool Database::load() {
       return false;
    }
 
+   // If we have a snapshot from the last clean shutdown, and the DB hasn't changed since, the object stores can load
+   // from that instead of the DB
+   StartupSnapshot::instance().open(*this);
+
    this->pimpl->loadWasSuccessful = true;
+
+   // If we are being reloaded, start up again whatever unload() stopped
+   if (this->pimpl->restartWriterOnLoad) {
+      DbWriter::instance().start();
+   }
+   if (this->pimpl->restartNotifierOnLoad) {
+      DbChangeNotifier::instance().start();
+   }
+   if (this->pimpl->restartMaintenanceOnLoad) {
+      DbMaintenance::instance().start();
+   }
+   this->pimpl->restartWriterOnLoad      = false;
+   this->pimpl->restartNotifierOnLoad    = false;
+   this->pimpl->restartMaintenanceOnLoad = false;
+
    return this->pimpl->loadWasSuccessful;
 }
 
 void Database::checkForNewDefaultData() {
    // See if there are new ingredients that we need to merge from the data-space db.
 ///   // Don't do this if we JUST copied the default database.
-///   qDebug() <<
+///   qCDebug(logDb) <<
 ///      Q_FUNC_INFO << "dataDbFile:" << this->pimpl->dataDbFile.fileName() << ", dbFile:" <<
 ///      this->pimpl->dbFile.fileName() << ", userDatabaseDidNotExist: " <<
 ///      (this->pimpl->userDatabaseDidNotExist ? "True" : "False") << ", dataDbFile.lastModified:" <<
 ///      QFileInfo(this->pimpl->dataDbFile).lastModified();
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "dbFile:" << this->pimpl->dbFile.fileName() << ", userDatabaseDidNotExist: " <<
       (this->pimpl->userDatabaseDidNotExist ? "True" : "False");
 ///   if (this->pimpl->dataDbFile.fileName() != this->pimpl->dbFile.fileName() &&
@@ -835,7 +871,7 @@ void Database::checkForNewDefaultData() {
             );
             qCritical() << Q_FUNC_INFO << userMessage;
          }
-         qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+         qCDebug(logDb) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
          QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                            messageBoxTitle,
                            messageBoxText};
@@ -883,12 +919,30 @@ void Database::unload() {
    // We really don't want this function to be called twice on the same object or when we didn't get as far as making a
    // connection to the DB etc.
    if (!this->pimpl->loaded) {
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Nothing to do for Database object for" <<
          getDbNativeName(displayableDbType, this->pimpl->dbType) << "as not loaded";
       return;
    }
 
+   // Stop any maintenance, as it uses the connections we are about to close.  Stop listening for other clients' changes
+   // (which closes the connection we were listening on).  Then, anything still queued for the DB writer needs to be
+   // written before we close connections.  (Stopping the writer also closes its own connection.)  Once the writer has
+   // stopped, nothing else can be added to the change journal, so we can write out whatever it still has buffered.
+   this->pimpl->restartMaintenanceOnLoad = DbMaintenance::instance().isRunning();
+   this->pimpl->restartNotifierOnLoad    = DbChangeNotifier::instance().isRunning();
+   this->pimpl->restartWriterOnLoad      = DbWriter::instance().isRunning();
+   DbMaintenance::instance().stop();
+   DbChangeNotifier::instance().stop();
+   DbWriter::instance().stop();
+   ChangeJournal::instance().flush();
+
+   // Now everything is written, we can take a snapshot to speed up loading next time
+   StartupSnapshot::instance().close();
+   if (this->pimpl->loadWasSuccessful) {
+      StartupSnapshot::instance().save(*this);
+   }
+
    // This RAII wrapper does all the hard work on mutex.lock() and mutex.unlock() in an exception-safe way
    QMutexLocker locker(&this->pimpl->mutex);
 
@@ -899,7 +953,7 @@ void Database::unload() {
    QStringList allConnectionNames{QSqlDatabase::connectionNames()};
    for (QString conName : allConnectionNames) {
       if (0 == conName.indexOf(ourConnectionPrefix)) {
-         qDebug() << Q_FUNC_INFO << "Closing connection " << conName;
+         qCDebug(logDb) << Q_FUNC_INFO << "Closing connection " << conName;
          {
             //
             // Extra braces here are to ensure that this QSqlDatabase object is out of scope before the call to
@@ -913,12 +967,12 @@ void Database::unload() {
          }
          QSqlDatabase::removeDatabase(conName);
       } else {
-         qDebug() <<
+         qCDebug(logDb) <<
             Q_FUNC_INFO << "Ignoring connection" << conName << "as does not start with" << ourConnectionPrefix;
       }
    }
 
-   qDebug() << Q_FUNC_INFO << "DB connections all closed";
+   qCDebug(logDb) << Q_FUNC_INFO << "DB connections all closed";
 
    if (this->pimpl->loadWasSuccessful && this->dbType() == Database::DbType::SQLITE ) {
       this->pimpl->dbFile.close();
@@ -928,7 +982,7 @@ void Database::unload() {
    this->pimpl->loaded = false;
    this->pimpl->loadWasSuccessful = false;
 
-   qDebug() << Q_FUNC_INFO << "Drop Instance done";
+   qCDebug(logDb) << Q_FUNC_INFO << "Drop Instance done";
 
    return;
 }
@@ -982,7 +1036,10 @@ char const * Database::getDefaultBackupFileName() {
 bool Database::backupToFile(QString const & newDbFileName) {
    QString const curDbFileName = this->pimpl->dbFile.fileName();
 
-   qDebug() << Q_FUNC_INFO << "Database backup from" << curDbFileName << "to" << newDbFileName;
+   qCDebug(logDb) << Q_FUNC_INFO << "Database backup from" << curDbFileName << "to" << newDbFileName;
+
+   // Make sure the file we're about to copy includes any writes still queued for the DB writer
+   DbWriter::instance().flush();
 
    //
    // In earlier versions of the code, we just used the copy() member function of QFile.  When this works it is fine,
@@ -35,9 +35,10 @@
 #include "database/Database.h"
 #include "database/DbTransaction.h"
 #include "database/ObjectStoreTyped.h"
+#include "Logging.h"
 #include "model/Salt.h"
 
-int constexpr DatabaseSchemaHelper::latestVersion = 18;
+int constexpr DatabaseSchemaHelper::latestVersion = 21;
 
 // Default namespace hides functions from everything outside this file.
 namespace {
@@ -79,7 +80,7 @@ namespace {
             // one query in a row to be dependent on a single "dummy-run" query
             continue;
          }
-         qDebug() << Q_FUNC_INFO << query.sql;
+         qCDebug(logDb) << Q_FUNC_INFO << query.sql;
 
          q.prepare(query.sql);
          for (auto & bv : query.bindValues) {
@@ -93,7 +94,7 @@ namespace {
                q.lastError().text();
             return false;
          }
-         qDebug() << Q_FUNC_INFO << q.numRowsAffected() << "rows affected";
+         qCDebug(logDb) << Q_FUNC_INFO << q.numRowsAffected() << "rows affected";
          priorQueryHadResults = q.next();
          priorQuerySql = query.sql;
       }
@@ -110,10 +111,10 @@ namespace {
       QString queryString{"ALTER TABLE brewnote ADD COLUMN projected_ferm_points "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << db.getDbNativeTypeName<double>() << ";"; // Previously DEFAULT 0.0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(logDb) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
       queryString = "ALTER TABLE brewnote SET projected_ferm_points = -1.0;";
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(logDb) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       // Add the settings table
@@ -122,7 +123,7 @@ namespace {
          "id " << db.getDbNativePrimaryKeyDeclaration() << ",\n"
          "repopulatechildrenonnextstart " << db.getDbNativeTypeName<int>() << ",\n" // Previously DEFAULT 0
          "version " << db.getDbNativeTypeName<int>() << ");"; // Previously DEFAULT 0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(logDb) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       return ret;
@@ -2534,11 +2535,164 @@ namespace {
       return executeSqlQueries(q, migrationQueries);
    }
 
+   /**
+    * \brief Add indexes on foreign key columns (eg recipe_id on hop_in_recipe) and on name columns of the main tables.
+    *
+    *        New databases get these from ObjectStore::addTableConstraints, which uses the same index names, hence the
+    *        "IF NOT EXISTS".
+    */
+   bool migrate_to_19([[maybe_unused]] Database & db, BtSqlQuery & q) {
+      QVector<QueryAndParameters> const migrationQueries{
+         //
+         // Without these, anything that looks up rows by foreign key has to scan the whole table.  This includes the
+         // foreign key checks the database does itself, eg deleting a hop means checking hop_in_recipe and
+         // hop_in_inventory for rows that refer to it.
+         //
+         {QString("CREATE INDEX IF NOT EXISTS fermentable_in_inventory_fermentable_id_idx "
+                  "ON fermentable_in_inventory (fermentable_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS hop_in_inventory_hop_id_idx "
+                  "ON hop_in_inventory (hop_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS mash_step_mash_id_idx "
+                  "ON mash_step (mash_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS boil_step_boil_id_idx "
+                  "ON boil_step (boil_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS fermentation_step_fermentation_id_idx "
+                  "ON fermentation_step (fermentation_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS misc_in_inventory_misc_id_idx "
+                  "ON misc_in_inventory (misc_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS salt_in_inventory_salt_id_idx "
+                  "ON salt_in_inventory (salt_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS yeast_in_inventory_yeast_id_idx "
+                  "ON yeast_in_inventory (yeast_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_equipment_id_idx "
+                  "ON recipe (equipment_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_mash_id_idx "
+                  "ON recipe (mash_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_style_id_idx "
+                  "ON recipe (style_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_ancestor_id_idx "
+                  "ON recipe (ancestor_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_boil_id_idx "
+                  "ON recipe (boil_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_fermentation_id_idx "
+                  "ON recipe (fermentation_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS fermentable_in_recipe_recipe_id_idx "
+                  "ON fermentable_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS fermentable_in_recipe_fermentable_id_idx "
+                  "ON fermentable_in_recipe (fermentable_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS hop_in_recipe_recipe_id_idx "
+                  "ON hop_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS hop_in_recipe_hop_id_idx "
+                  "ON hop_in_recipe (hop_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS misc_in_recipe_recipe_id_idx "
+                  "ON misc_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS misc_in_recipe_misc_id_idx "
+                  "ON misc_in_recipe (misc_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS yeast_in_recipe_recipe_id_idx "
+                  "ON yeast_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS yeast_in_recipe_yeast_id_idx "
+                  "ON yeast_in_recipe (yeast_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS salt_in_recipe_recipe_id_idx "
+                  "ON salt_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS salt_in_recipe_salt_id_idx "
+                  "ON salt_in_recipe (salt_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS water_in_recipe_recipe_id_idx "
+                  "ON water_in_recipe (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS water_in_recipe_water_id_idx "
+                  "ON water_in_recipe (water_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS brewnote_recipe_id_idx "
+                  "ON brewnote (recipe_id)")},
+         {QString("CREATE INDEX IF NOT EXISTS instruction_recipe_id_idx "
+                  "ON instruction (recipe_id)")},
+         //
+         // Name columns of tables that users browse, search and sort
+         //
+         {QString("CREATE INDEX IF NOT EXISTS equipment_name_idx "
+                  "ON equipment (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS fermentable_name_idx "
+                  "ON fermentable (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS hop_name_idx "
+                  "ON hop (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS misc_name_idx "
+                  "ON misc (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS recipe_name_idx "
+                  "ON recipe (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS salt_name_idx "
+                  "ON salt (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS style_name_idx "
+                  "ON style (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS water_name_idx "
+                  "ON water (name)")},
+         {QString("CREATE INDEX IF NOT EXISTS yeast_name_idx "
+                  "ON yeast (name)")},
+      };
+
+      return executeSqlQueries(q, migrationQueries);
+   }
+
+   /**
+    * \brief Add a row version to each primary table, which ObjectStore uses to detect when another client has changed a
+    *        row since we read it.  Existing rows all start at version 1.
+    */
+   bool migrate_to_20([[maybe_unused]] Database & db, BtSqlQuery & q) {
+      QVector<QueryAndParameters> const migrationQueries{
+         {QString("ALTER TABLE equipment ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE fermentable ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE fermentable_in_inventory ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE hop ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE hop_in_inventory ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE mash ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE mash_step ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE boil ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE boil_step ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE fermentation ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE fermentation_step ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE misc ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE misc_in_inventory ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE salt ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE salt_in_inventory ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE style ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE water ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE yeast ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE yeast_in_inventory ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE fermentable_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE hop_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE misc_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE yeast_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE salt_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE water_in_recipe ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE brewnote ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+         {QString("ALTER TABLE instruction ADD COLUMN row_version INTEGER NOT NULL DEFAULT 1")},
+      };
+
+      return executeSqlQueries(q, migrationQueries);
+   }
+
+   /**
+    * \brief Add the change journal (see \c ChangeJournal).  NB: If you change this, you probably also need to change
+    *        the corresponding query in \c DatabaseSchemaHelper::create().
+    */
+   bool migrate_to_21(Database & db, BtSqlQuery & q) {
+      QVector<QueryAndParameters> const migrationQueries{
+         {QString("CREATE TABLE change_journal (seq %1, "
+                                               "table_name %2, "
+                                               "row_id %3, "
+                                               "operation %2, "
+                                               "columns %2, "
+                                               "changed_at %2)").arg(db.getDbNativePrimaryKeyDeclaration(),
+                                                                     db.getDbNativeTypeName<QString>(),
+                                                                     db.getDbNativeTypeName<int>())},
+      };
+
+      return executeSqlQueries(q, migrationQueries);
+   }
+
    /*!
     * \brief Migrate from version \c oldVersion to \c oldVersion+1
     */
    bool migrateNext(Database & database, int oldVersion, QSqlDatabase db ) {
-      qDebug() << Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
+      qCDebug(logDb) << Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
       BtSqlQuery sqlQuery(db);
       bool ret = true;
 
@@ -2562,6 +2716,9 @@ namespace {
          case 15: ret &= migrate_to_16(database, sqlQuery); break;
          case 16: ret &= migrate_to_17(database, sqlQuery); break;
          case 17: ret &= migrate_to_18(database, sqlQuery); break;
+         case 18: ret &= migrate_to_19(database, sqlQuery); break;
+         case 19: ret &= migrate_to_20(database, sqlQuery); break;
+         case 20: ret &= migrate_to_21(database, sqlQuery); break;
          default:
             qCritical() << QString("Unknown version %1").arg(oldVersion);
             return false;
@@ -2585,8 +2742,8 @@ namespace {
 
 
 int DatabaseSchemaHelper::getDefaultContentVersionFromDb(QSqlDatabase & db) {
-   BtSqlQuery sqlQuery("SELECT default_content_version FROM settings WHERE id=1", db);
-   if (sqlQuery.next() ) {
+   BtSqlQuery sqlQuery{db};
+   if (sqlQuery.exec("SELECT default_content_version FROM settings WHERE id=1") && sqlQuery.next()) {
       QVariant dc = sqlQuery.value("default_content_version");
       return dc.toInt();
    }
@@ -2627,7 +2784,7 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
    // having called dbTransaction.commit().
    DbTransaction dbTransaction{database, connection, "DatabaseSchemaHelper::create"};
 
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logDb) << Q_FUNC_INFO;
    if (!CreateAllDatabaseTables(database, connection)) {
       return false;
    }
@@ -2646,7 +2803,19 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
                                                                          database.getDbNativeTypeName<int>        ())},
       {QString("INSERT INTO settings (version, "
                                      "default_content_version) "
-               "VALUES (?, ?)"), {QVariant(DatabaseSchemaHelper::latestVersion), QVariant(0)}}
+               "VALUES (?, ?)"), {QVariant(DatabaseSchemaHelper::latestVersion), QVariant(0)}},
+      //
+      // Similarly, the change journal is only used by ChangeJournal, so does not need an ObjectStore.  NB: If you change
+      // this, you probably also need to change migrate_to_21().
+      //
+      {QString("CREATE TABLE change_journal (seq %1, "
+                                            "table_name %2, "
+                                            "row_id %3, "
+                                            "operation %2, "
+                                            "columns %2, "
+                                            "changed_at %2)").arg(database.getDbNativePrimaryKeyDeclaration(),
+                                                                  database.getDbNativeTypeName<QString>(),
+                                                                  database.getDbNativeTypeName<int>())}
    };
    BtSqlQuery sqlQuery{connection};
 
@@ -2670,7 +2839,7 @@ bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newV
    }
 
    bool ret = true;
-   qDebug() << Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
+   qCDebug(logDb) << Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
 
    // Start transaction
    // By the magic of RAII, this will abort if we exit this function (including by throwing an exception) without
@@ -2693,9 +2862,9 @@ bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newV
 int DatabaseSchemaHelper::schemaVersion(QSqlDatabase & db) {
    // Version was a string field in early versions of the code and then became an integer field
    // We'll read it into a QVariant and then work out whether it's a string or an integer
-   BtSqlQuery q("SELECT version FROM settings WHERE id=1", db);
+   BtSqlQuery q{db};
    QVariant ver;
-   if (q.next() ) {
+   if (q.exec("SELECT version FROM settings WHERE id=1") && q.next()) {
       ver = q.value("version");
    } else {
       // No settings table in version 2.0.0
@@ -2704,7 +2873,7 @@ int DatabaseSchemaHelper::schemaVersion(QSqlDatabase & db) {
 
    // Get the string before we kill it by convert()-ing
    QString stringVer( ver.toString() );
-   qDebug() << Q_FUNC_INFO << "Database schema version" << stringVer;
+   qCDebug(logDb) << Q_FUNC_INFO << "Database schema version" << stringVer;
 
    // Initially, versioning was done with strings, so we need to convert
    // the old version strings to integer versions
@@ -0,0 +1,222 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbChangeNotifier.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/DbChangeNotifier.h"
+
+#include <QDebug>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlError>
+#include <QUuid>
+
+#include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/ObjectStore.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+
+#ifdef BUILDING_WITH_CMAKE
+   // Explicitly doing this include reduces potential problems with AUTOMOC when compiling with CMake
+   #include "moc_DbChangeNotifier.cpp"
+#endif
+
+namespace {
+   // Not one of the connections that Database::sqlDatabase() manages, so we give it a name of its own
+   QString const listenConnectionName{"DbChangeNotifier"};
+
+   char const * operationToString(DbChangeNotifier::Operation const operation) {
+      switch (operation) {
+         case DbChangeNotifier::Operation::Insert: return "insert";
+         case DbChangeNotifier::Operation::Update: return "update";
+         case DbChangeNotifier::Operation::Delete: return "delete";
+         // No default case needed as compiler should warn us if any options covered above
+      }
+      // It's a coding error if we get here!
+      Q_UNREACHABLE();
+   }
+}
+
+// This private implementation class holds all private non-virtual members of DbChangeNotifier
+class DbChangeNotifier::impl {
+public:
+   impl() : m_running{false} {
+      return;
+   }
+
+   ~impl() = default;
+
+   bool m_running;
+};
+
+DbChangeNotifier::DbChangeNotifier() : pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+DbChangeNotifier::~DbChangeNotifier() = default;
+
+DbChangeNotifier & DbChangeNotifier::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static DbChangeNotifier dbChangeNotifier;
+   return dbChangeNotifier;
+}
+
+QString const & DbChangeNotifier::clientId() {
+   static QString const id{QUuid::createUuid().toString(QUuid::WithoutBraces)};
+   return id;
+}
+
+QString const & DbChangeNotifier::channelName() {
+   // NB: PostgreSQL folds unquoted identifiers to lower case, so the channel name needs to be lower case to match
+   static QString const name{QString{"%1_changes"}.arg(CONFIG_APPLICATION_NAME_LC)};
+   return name;
+}
+
+bool DbChangeNotifier::start() {
+   if (this->pimpl->m_running) {
+      return false;
+   }
+   Database & database = Database::instance();
+   if (database.dbType() != Database::DbType::PGSQL) {
+      qCDebug(logDb) << Q_FUNC_INFO << "Change notifications are only supported on PostgreSQL";
+      return false;
+   }
+
+   //
+   // We need a connection of our own because, whilst we are listening on it, it would not be a good idea to be running
+   // other queries (and, in particular, transactions) on it.  Cloning the main connection gets us the same host, port,
+   // user etc.
+   //
+   QSqlDatabase connection = QSqlDatabase::cloneDatabase(database.sqlDatabase(), listenConnectionName);
+   if (!connection.open()) {
+      qCritical() <<
+         Q_FUNC_INFO << "Unable to open connection to listen for DB changes:" << connection.lastError().text();
+      QSqlDatabase::removeDatabase(listenConnectionName);
+      return false;
+   }
+
+   QSqlDriver * driver = connection.driver();
+   if (!driver->hasFeature(QSqlDriver::EventNotifications) ||
+       !driver->subscribeToNotification(DbChangeNotifier::channelName())) {
+      qCritical() <<
+         Q_FUNC_INFO << "Unable to LISTEN on" << DbChangeNotifier::channelName() << ":" << driver->lastError().text();
+      connection.close();
+      connection = QSqlDatabase{};
+      QSqlDatabase::removeDatabase(listenConnectionName);
+      return false;
+   }
+
+   connect(driver,
+           QOverload<QString const &, QSqlDriver::NotificationSource, QVariant const &>::of(&QSqlDriver::notification),
+           this,
+           &DbChangeNotifier::receiveNotification);
+
+   qInfo() <<
+      Q_FUNC_INFO << "Listening for DB changes on" << DbChangeNotifier::channelName() << "as client" <<
+      DbChangeNotifier::clientId();
+   this->pimpl->m_running = true;
+   return true;
+}
+
+void DbChangeNotifier::stop() {
+   if (!this->pimpl->m_running) {
+      return;
+   }
+   qInfo() << Q_FUNC_INFO << "Stopping listening for DB changes";
+   {
+      // Per the comments in Database.h, we need all QSqlDatabase objects for the connection to be out of scope before
+      // we remove it.
+      QSqlDatabase connection = QSqlDatabase::database(listenConnectionName, false);
+      if (connection.isOpen()) {
+         disconnect(connection.driver(), nullptr, this, nullptr);
+         connection.driver()->unsubscribeFromNotification(DbChangeNotifier::channelName());
+         connection.close();
+      }
+   }
+   QSqlDatabase::removeDatabase(listenConnectionName);
+   this->pimpl->m_running = false;
+   return;
+}
+
+bool DbChangeNotifier::isRunning() const {
+   return this->pimpl->m_running;
+}
+
+bool DbChangeNotifier::publish(QSqlDatabase & connection,
+                               DbChangeNotifier::Operation const operation,
+                               QString const & tableName,
+                               int const id,
+                               QStringList const & columnNames) {
+   if (connection.driverName() != "QPSQL") {
+      return true;
+   }
+
+   QJsonObject payload{
+      {"client", DbChangeNotifier::clientId()           },
+      {"op"    , operationToString(operation)           },
+      {"table" , tableName                              },
+      {"id"    , id                                     },
+      {"cols"  , QJsonArray::fromStringList(columnNames)},
+   };
+
+   //
+   // We use pg_notify() rather than NOTIFY because the latter does not accept bind parameters for the payload.  As
+   // noted in the header, if we're in a transaction, the notification only gets sent when (and if) it commits.
+   //
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare("SELECT pg_notify(:channel, :payload);");
+   sqlQuery.bindValue(":channel", DbChangeNotifier::channelName());
+   sqlQuery.bindValue(":payload", QString::fromUtf8(QJsonDocument{payload}.toJson(QJsonDocument::Compact)));
+   if (!sqlQuery.exec()) {
+      qWarning() <<
+         Q_FUNC_INFO << "Unable to notify change to" << tableName << "#" << id << ":" << sqlQuery.lastError().text();
+      return false;
+   }
+   return true;
+}
+
+void DbChangeNotifier::reportConflict(QString const & description) {
+   qWarning() << Q_FUNC_INFO << "Write conflict:" << description;
+   emit this->conflictDetected(description);
+   return;
+}
+
+void DbChangeNotifier::receiveNotification(QString const & name,
+                                           [[maybe_unused]] QSqlDriver::NotificationSource source,
+                                           QVariant const & payload) {
+   if (name != DbChangeNotifier::channelName()) {
+      return;
+   }
+
+   QJsonObject const change = QJsonDocument::fromJson(payload.toString().toUtf8()).object();
+   // Ignore our own changes -- the cache is already up-to-date with them
+   if (change.value("client").toString() == DbChangeNotifier::clientId()) {
+      return;
+   }
+
+   QString const tableName = change.value("table").toString();
+   int const id = change.value("id").toInt(-1);
+   qCDebug(logDb) << Q_FUNC_INFO << "Change notification:" << payload.toString();
+
+   ObjectStore * objectStore = FindObjectStoreForTable(tableName);
+   if (!objectStore || id <= 0) {
+      qWarning() << Q_FUNC_INFO << "Ignoring change notification we do not understand:" << payload.toString();
+      return;
+   }
+
+   objectStore->refreshFromDb(id);
+   return;
+}
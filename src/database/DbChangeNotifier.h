@@ -0,0 +1,126 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbChangeNotifier.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_DBCHANGENOTIFIER_H
+#define DATABASE_DBCHANGENOTIFIER_H
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+/**
+ * \brief Keeps the in-memory \c ObjectStore caches of several clients sharing one PostgreSQL database coherent.
+ *
+ *        Each \c ObjectStore loads its whole table once at start-up, so, without this, a change made by one client is
+ *        not seen by another until it restarts (and can be silently overwritten by it in the meantime).  So:
+ *
+ *          - Every \c ObjectStore write calls \c publish(), which, on PostgreSQL, does a NOTIFY (via \c pg_notify) on
+ *            our channel in the same transaction as the write.  (PostgreSQL only delivers the notification if and when
+ *            the transaction commits.)  The payload identifies the client, the operation, the table, the row and the
+ *            columns changed.
+ *
+ *          - When running, we LISTEN on that channel on a separate connection.  For each notification from another
+ *            client, we ask the relevant \c ObjectStore to refresh just that row from the DB (see
+ *            \c ObjectStore::refreshFromDb), which in turn updates (or adds or removes) the cached object and, via the
+ *            usual signals, any tree and table views showing it.
+ *
+ *        Notifications complement, rather than replace, the optimistic concurrency checks in \c ObjectStore: every
+ *        row has a version number that each write increments and checks, so that a client that writes to a row that
+ *        someone else changed since it was last read finds out (via \c conflictDetected) rather than overwriting the
+ *        other change.  Those checks work on all DB types, but on SQLite there is no-one else to conflict with in
+ *        practice.
+ *
+ *        The listening connection is driven by the Qt event loop on the thread that calls \c start() (normally the
+ *        main thread, which is where the \c ObjectStore caches live), so it does not block anything while waiting.
+ */
+class DbChangeNotifier : public QObject {
+   Q_OBJECT
+
+public:
+   enum class Operation {
+      Insert,
+      Update,
+      Delete
+   };
+
+   static DbChangeNotifier & instance();
+
+   /**
+    * \brief Start listening for changes from other clients.  Does nothing (and returns \c false) if the DB is not
+    *        PostgreSQL, or if we are already listening.
+    */
+   bool start();
+
+   //! \brief Stop listening and close the listening connection
+   void stop();
+
+   bool isRunning() const;
+
+   //! \brief Identifies this process in the notifications we send, so that we can ignore our own
+   static QString const & clientId();
+
+   //! \brief The PostgreSQL channel on which we send, and listen for, notifications
+   static QString const & channelName();
+
+   /**
+    * \brief Tell other clients about a change.  Call this inside the transaction that makes the change.  Does nothing
+    *        if \c connection is not to a PostgreSQL DB.
+    *
+    * \return \c false if the notification could not be sent (which will be logged, but which callers can treat as
+    *         non-fatal)
+    */
+   static bool publish(QSqlDatabase & connection,
+                       Operation const operation,
+                       QString const & tableName,
+                       int const id,
+                       QStringList const & columnNames = {});
+
+   /**
+    * \brief Called by \c ObjectStore when a write is rejected because someone else changed the row first.  Logs, and
+    *        emits \c conflictDetected.
+    */
+   void reportConflict(QString const & description);
+
+signals:
+   /**
+    * \brief Emitted when one of our writes lost out to a change made by another client.  By the time this is emitted,
+    *        the object will have been refreshed with the other client's version.
+    */
+   void conflictDetected(QString const & description);
+
+private slots:
+   void receiveNotification(QString const & name, QSqlDriver::NotificationSource source, QVariant const & payload);
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   DbChangeNotifier();
+   ~DbChangeNotifier();
+
+   // Singleton shouldn't be getting copied or moved
+   DbChangeNotifier(DbChangeNotifier const &) = delete;
+   DbChangeNotifier & operator=(DbChangeNotifier const &) = delete;
+   DbChangeNotifier(DbChangeNotifier &&) = delete;
+   DbChangeNotifier & operator=(DbChangeNotifier &&) = delete;
+};
+
+#endif
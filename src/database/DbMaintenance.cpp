@@ -0,0 +1,406 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbMaintenance.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/DbMaintenance.h"
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+#include <QTimer>
+
+#include "database/BtSqlQuery.h"
+#include "database/ChangeJournal.h"
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "database/DbWriter.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "PersistentSettings.h"
+
+#ifdef BUILDING_WITH_CMAKE
+   // Explicitly doing this include reduces potential problems with AUTOMOC when compiling with CMake
+   #include "moc_DbMaintenance.cpp"
+#endif
+
+namespace {
+   //! How often we check whether we are idle (and, if so, do the next step)
+   int constexpr tickInterval_ms = 5 * 1000;
+
+   //! How long the user has to have left the keyboard and mouse alone before we count as idle
+   qint64 constexpr idleThreshold_ms = 60 * 1000;
+
+   //! Minimum time between the starts of two maintenance cycles
+   qint64 constexpr cycleInterval_s = 24 * 60 * 60;
+
+   //! Most soft-deleted objects we look at (and, if we can, purge) in one step
+   int constexpr maxPurgeCandidatesPerStep = 20;
+
+   //! Most change journal entries we delete in one step
+   int constexpr maxJournalEntriesPrunedPerStep = 1000;
+
+   //! Most free pages we give back to the file system in one step on SQLite
+   int constexpr maxPagesPerStep = 512;
+
+   //! Values of SQLite's auto_vacuum pragma -- see https://www.sqlite.org/pragma.html#pragma_auto_vacuum
+   qint64 constexpr sqliteAutoVacuumNone        = 0;
+   qint64 constexpr sqliteAutoVacuumIncremental = 2;
+
+   bool isEnabled() {
+      return PersistentSettings::value(PersistentSettings::Names::dbMaintenance, true).toBool();
+   }
+
+   //! Whether we may do a (one-off, but not small) full VACUUM to switch an SQLite DB to incremental auto-vacuum
+   bool isFullVacuumAllowed() {
+      return PersistentSettings::value(PersistentSettings::Names::dbMaintenanceFullVacuum, false).toBool();
+   }
+
+   bool isUserInput(QEvent::Type const eventType) {
+      switch (eventType) {
+         case QEvent::KeyPress:
+         case QEvent::MouseButtonPress:
+         case QEvent::MouseMove:
+         case QEvent::Wheel:
+         case QEvent::TouchBegin:
+            return true;
+         default:
+            break;
+      }
+      return false;
+   }
+
+   /**
+    * \brief Run a maintenance statement, reading through any rows it returns.  (On SQLite, some pragmas, notably
+    *        \c incremental_vacuum, only do all their work if every row is read.)
+    *
+    *        NB: We use QSqlQuery rather than BtSqlQuery here because these statements are expected to be slow, so
+    *            there's no point logging them as slow queries or including them in \c QueryStats.  (We log how long
+    *            maintenance takes separately.)
+    */
+   bool execStatement(QSqlDatabase & connection, QString const & queryString) {
+      QSqlQuery sqlQuery{connection};
+      if (!sqlQuery.exec(queryString)) {
+         qWarning() << Q_FUNC_INFO << "Error executing" << queryString << ":" << sqlQuery.lastError().text();
+         return false;
+      }
+      while (sqlQuery.next()) {
+         // Nothing to do with the rows, we just need to read them
+      }
+      return true;
+   }
+
+   /**
+    * \brief Run a query that returns a single number
+    *
+    * \return The number, or -1 if there was an error
+    */
+   qint64 queryNumber(QSqlDatabase & connection, QString const & queryString) {
+      BtSqlQuery sqlQuery{connection};
+      if (!sqlQuery.exec(queryString) || !sqlQuery.next()) {
+         qWarning() << Q_FUNC_INFO << "Error executing" << queryString << ":" << sqlQuery.lastError().text();
+         return -1;
+      }
+      return sqlQuery.value(0).toLongLong();
+   }
+
+   //! \return Size in bytes of the DB, or -1 if we could not find out
+   qint64 databaseSize(Database const & database, QSqlDatabase & connection) {
+      if (database.dbType() == Database::DbType::SQLITE) {
+         qint64 const pageCount = queryNumber(connection, "PRAGMA page_count;");
+         qint64 const pageSize  = queryNumber(connection, "PRAGMA page_size;");
+         return (pageCount < 0 || pageSize < 0) ? -1 : pageCount * pageSize;
+      }
+      return queryNumber(connection, "SELECT pg_database_size(current_database());");
+   }
+}
+
+// This private implementation class holds all private non-virtual members of DbMaintenance
+class DbMaintenance::impl {
+public:
+   enum class Phase {
+      NoCycle,
+      Purge,
+      PruneJournal,
+      Vacuum,
+      Analyze
+   };
+
+   impl() :
+      m_timer{},
+      m_sinceUserInput{},
+      m_phase{Phase::NoCycle},
+      m_purgeProgress{},
+      m_tablesToAnalyze{},
+      m_report{},
+      m_lastReport{} {
+      this->m_sinceUserInput.start();
+      return;
+   }
+
+   ~impl() = default;
+
+   bool isCycleDue() const {
+      QDateTime const lastCycle =
+         PersistentSettings::value(PersistentSettings::Names::dbLastMaintenance, QDateTime{}).toDateTime();
+      return !lastCycle.isValid() || lastCycle.secsTo(QDateTime::currentDateTimeUtc()) >= cycleInterval_s;
+   }
+
+   void startCycle() {
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      this->m_report = Report{};
+      this->m_report.bytesBefore = databaseSize(database, connection);
+      this->m_purgeProgress = PurgeProgress{};
+      this->m_tablesToAnalyze.clear();
+      for (QString const & tableName : connection.tables()) {
+         // SQLite's own tables can't be analyzed separately
+         if (!tableName.startsWith("sqlite_")) {
+            this->m_tablesToAnalyze.append(tableName);
+         }
+      }
+      this->m_phase = Phase::Purge;
+      qInfo() << Q_FUNC_INFO << "Starting DB maintenance.  DB size:" << this->m_report.bytesBefore << "bytes";
+      return;
+   }
+
+   /**
+    * \brief Give some free pages back to the file system (SQLite only)
+    *
+    * \return \c true if there may be more to do, \c false otherwise
+    */
+   bool vacuumStep(Database & database, QSqlDatabase & connection) {
+      if (database.dbType() != Database::DbType::SQLITE) {
+         // On PostgreSQL, we vacuum each table as part of the analyze phase
+         return false;
+      }
+      qint64 const numFreePages = queryNumber(connection, "PRAGMA freelist_count;");
+      if (numFreePages <= 0) {
+         return false;
+      }
+      qint64 const autoVacuum = queryNumber(connection, "PRAGMA auto_vacuum;");
+      if (autoVacuum == sqliteAutoVacuumIncremental) {
+         return execStatement(connection, QString{"PRAGMA incremental_vacuum(%1);"}.arg(maxPagesPerStep));
+      }
+      if (autoVacuum == sqliteAutoVacuumNone) {
+         //
+         // Changing the auto_vacuum mode of an existing DB only takes effect after a full VACUUM (which also gives
+         // back all the free pages).  This is the one step that isn't small -- it rewrites the whole DB, on the main
+         // thread -- so we only do it if the user has said we may.  Otherwise, there is no way to give back free pages
+         // a few at a time, so we leave them for SQLite to reuse.
+         //
+         if (!isFullVacuumAllowed()) {
+            qCDebug(logDb) <<
+               Q_FUNC_INFO << "Leaving" << numFreePages << "free pages as DB is not in incremental auto-vacuum mode";
+            return false;
+         }
+         qInfo() <<
+            Q_FUNC_INFO << "Switching DB to incremental auto-vacuum (" << numFreePages << "free pages to reclaim)";
+         if (execStatement(connection, "PRAGMA auto_vacuum = INCREMENTAL;")) {
+            execStatement(connection, "VACUUM;");
+         }
+         return false;
+      }
+      // Otherwise we're in full auto-vacuum mode, where SQLite gives back free pages at every commit
+      return false;
+   }
+
+   void analyzeTable(Database & database, QSqlDatabase & connection, QString const & tableName) {
+      if (database.dbType() == Database::DbType::SQLITE) {
+         execStatement(connection, QString{"ANALYZE %1;"}.arg(tableName));
+      } else {
+         execStatement(connection, QString{"VACUUM (ANALYZE) %1;"}.arg(tableName));
+      }
+      return;
+   }
+
+   /**
+    * \brief Do the next step of the current cycle, finishing the cycle if there is nothing more to do
+    */
+   void doStep() {
+      QElapsedTimer stepTimer;
+      stepTimer.start();
+
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      // Anything queued for the DB needs to be written before we look at what's there
+      DbWriter::instance().flush();
+
+      switch (this->m_phase) {
+         case Phase::Purge:
+            {
+               this->m_report.numPurged +=
+                  PurgeUnreferencedDeletedObjects(this->m_purgeProgress, maxPurgeCandidatesPerStep);
+               if (this->m_purgeProgress.finished) {
+                  this->m_phase = Phase::PruneJournal;
+               }
+            }
+            break;
+         case Phase::PruneJournal:
+            {
+               // Entries up to the last delta export have been exported, so we don't need them any more
+               qint64 const lastExportedSequence = PersistentSettings::value(
+                  PersistentSettings::Names::lastChangeExportSequence, 0
+               ).toLongLong();
+               int const numPruned =
+                  lastExportedSequence > 0 ?
+                  ChangeJournal::instance().prune(lastExportedSequence, maxJournalEntriesPrunedPerStep) : 0;
+               this->m_report.numJournalEntriesPruned += numPruned;
+               if (numPruned < maxJournalEntriesPrunedPerStep) {
+                  this->m_phase = Phase::Vacuum;
+               }
+            }
+            break;
+         case Phase::Vacuum:
+            if (!this->vacuumStep(database, connection)) {
+               this->m_phase = Phase::Analyze;
+            }
+            break;
+         case Phase::Analyze:
+            if (!this->m_tablesToAnalyze.isEmpty()) {
+               this->analyzeTable(database, connection, this->m_tablesToAnalyze.takeFirst());
+            }
+            if (this->m_tablesToAnalyze.isEmpty()) {
+               this->m_phase = Phase::NoCycle;
+            }
+            break;
+         case Phase::NoCycle:
+            break;
+         // No default case needed as compiler should warn us if any options covered above
+      }
+
+      this->m_report.timeSpent_ms += stepTimer.elapsed();
+      ++this->m_report.numSteps;
+
+      if (this->m_phase == Phase::NoCycle) {
+         this->finishCycle(database, connection);
+      }
+      return;
+   }
+
+   void finishCycle(Database & database, QSqlDatabase & connection) {
+      this->m_report.bytesAfter = databaseSize(database, connection);
+      qInfo() <<
+         Q_FUNC_INFO << "Finished DB maintenance.  Purged" << this->m_report.numPurged << "deleted objects and" <<
+         this->m_report.numJournalEntriesPruned << "change journal entries.  DB size" <<
+         this->m_report.bytesBefore << "->" << this->m_report.bytesAfter << "bytes (" <<
+         this->m_report.bytesBefore - this->m_report.bytesAfter << "reclaimed).  Took" <<
+         this->m_report.timeSpent_ms << "ms in" << this->m_report.numSteps << "steps";
+      PersistentSettings::insert(PersistentSettings::Names::dbLastMaintenance, QDateTime::currentDateTimeUtc());
+      this->m_lastReport = this->m_report;
+      return;
+   }
+
+   QTimer m_timer;
+   //! Restarted whenever the user does something
+   QElapsedTimer m_sinceUserInput;
+   Phase m_phase;
+   //! Where the purge phase of the current cycle has got to
+   PurgeProgress m_purgeProgress;
+   QStringList m_tablesToAnalyze;
+   //! For the cycle in progress
+   Report m_report;
+   Report m_lastReport;
+};
+
+DbMaintenance::DbMaintenance() : pimpl{std::make_unique<impl>()} {
+   this->pimpl->m_timer.setInterval(tickInterval_ms);
+   connect(&this->pimpl->m_timer, &QTimer::timeout, this, &DbMaintenance::doIdleWork);
+   return;
+}
+
+DbMaintenance::~DbMaintenance() = default;
+
+DbMaintenance & DbMaintenance::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static DbMaintenance dbMaintenance;
+   return dbMaintenance;
+}
+
+void DbMaintenance::start() {
+   if (this->isRunning()) {
+      return;
+   }
+   if (!isEnabled()) {
+      qInfo() << Q_FUNC_INFO << "DB maintenance is turned off";
+      return;
+   }
+   qApp->installEventFilter(this);
+   this->pimpl->m_sinceUserInput.restart();
+   this->pimpl->m_timer.start();
+   return;
+}
+
+void DbMaintenance::stop() {
+   if (!this->isRunning()) {
+      return;
+   }
+   this->pimpl->m_timer.stop();
+   qApp->removeEventFilter(this);
+   if (this->pimpl->m_phase != impl::Phase::NoCycle) {
+      qInfo() << Q_FUNC_INFO << "Abandoning DB maintenance part-way through";
+      this->pimpl->m_phase = impl::Phase::NoCycle;
+   }
+   return;
+}
+
+bool DbMaintenance::isRunning() const {
+   return this->pimpl->m_timer.isActive();
+}
+
+DbMaintenance::Report DbMaintenance::runCycle() {
+   if (this->pimpl->m_phase == impl::Phase::NoCycle) {
+      this->pimpl->startCycle();
+   }
+   while (this->pimpl->m_phase != impl::Phase::NoCycle) {
+      this->pimpl->doStep();
+   }
+   return this->pimpl->m_lastReport;
+}
+
+DbMaintenance::Report DbMaintenance::lastReport() const {
+   return this->pimpl->m_lastReport;
+}
+
+bool DbMaintenance::eventFilter(QObject * watched, QEvent * event) {
+   if (isUserInput(event->type())) {
+      this->pimpl->m_sinceUserInput.restart();
+   }
+   return this->QObject::eventFilter(watched, event);
+}
+
+void DbMaintenance::doIdleWork() {
+   if (this->pimpl->m_sinceUserInput.elapsed() < idleThreshold_ms) {
+      return;
+   }
+
+   // If we've been called from inside a transaction (eg because an import is updating a progress dialog), now is not
+   // the time
+   if (DbTransaction::isInProgress(Database::instance().sqlDatabase())) {
+      return;
+   }
+
+   if (this->pimpl->m_phase == impl::Phase::NoCycle) {
+      if (!this->pimpl->isCycleDue()) {
+         return;
+      }
+      this->pimpl->startCycle();
+   }
+   this->pimpl->doStep();
+   return;
+}
@@ -0,0 +1,124 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbMaintenance.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_DBMAINTENANCE_H
+#define DATABASE_DBMAINTENANCE_H
+#pragma once
+
+#include <memory>
+
+#include <QEvent>
+#include <QObject>
+
+/**
+ * \brief Tidies up the DB in idle time: removes soft-deleted objects that nothing uses any more, trims the change
+ *        journal, gives free space back to the file system, and keeps the query planner's statistics up-to-date.
+ *
+ *        Without this, the DB only ever grows: soft-deleted objects (see \c ObjectStoreTyped::softDelete) stay in the
+ *        DB, and in memory, for ever; every change adds to the \c ChangeJournal; SQLite does not shrink the DB file
+ *        when rows are deleted; and neither SQLite nor PostgreSQL has statistics on our tables unless someone runs
+ *        ANALYZE.
+ *
+ *        Once a day (at most), when the user has not touched the keyboard or mouse for a while, we run a maintenance
+ *        "cycle", a small step at a time, so the UI never notices.  The steps are:
+ *
+ *          - Purge: hard delete, a few at a time, soft-deleted objects that nothing in the DB refers to (see
+ *            \c PurgeUnreferencedDeletedObjects).  Objects that can't be purged (eg because they are in use in
+ *            memory) are skipped, so they don't hold up the rest.  Anything owned by a purged object (eg the additions in a
+ *            \c Recipe) goes with it.  Objects that are still referred to (eg an ancestor of a \c Recipe that is still
+ *            in use, or a \c Recipe with brew notes) are left alone.
+ *
+ *          - Prune journal: delete, a batch at a time, \c ChangeJournal entries that the last delta export has already
+ *            covered (ie up to the \c lastChangeExportSequence setting).  If there has never been a delta export,
+ *            there is nothing we know to be safe to delete, so we leave the journal alone.
+ *
+ *          - Vacuum (SQLite only): release free pages, a few at a time, with \c PRAGMA \c incremental_vacuum.  This
+ *            needs the DB to be in incremental auto-vacuum mode, which an existing DB can only be switched to by a full
+ *            \c VACUUM.  That rewrites the whole DB in one go, which is far from a small step, so we only do it if the
+ *            \c dbMaintenanceFullVacuum setting is on (in which case it only ever happens once per DB).  Otherwise, a
+ *            DB that is not in incremental mode keeps its free pages, which SQLite reuses for new rows.
+ *
+ *          - Analyze: one table per step.  On SQLite, this is \c ANALYZE.  On PostgreSQL, it is \c VACUUM \c (ANALYZE),
+ *            which also makes the space used by deleted rows available for reuse.
+ *
+ *        At the end of each cycle we log how much space was reclaimed and how long, in total, the steps took.
+ *        Maintenance can be turned off with the \c dbMaintenance setting.
+ *
+ *        This all happens on the main thread, because purging objects changes the \c ObjectStore caches (and sends
+ *        the same signals as any other delete).
+ */
+class DbMaintenance : public QObject {
+   Q_OBJECT
+
+public:
+   struct Report {
+      //! Number of soft-deleted objects hard deleted
+      int    numPurged   = 0;
+      //! Number of change journal entries deleted
+      int    numJournalEntriesPruned = 0;
+      //! Size of the DB when the cycle started, or -1 if we could not find out
+      qint64 bytesBefore = -1;
+      //! Size of the DB when the cycle finished, or -1 if we could not find out
+      qint64 bytesAfter  = -1;
+      //! Total time spent running steps (so not including the idle time in between them)
+      qint64 timeSpent_ms = 0;
+      int    numSteps    = 0;
+   };
+
+   static DbMaintenance & instance();
+
+   /**
+    * \brief Start watching for idle time in which to do maintenance.  Does nothing if maintenance is turned off, or
+    *        we are already running.
+    */
+   void start();
+
+   //! \brief Stop watching for idle time.  A cycle that is part-way through is abandoned, but can safely be re-run.
+   void stop();
+
+   bool isRunning() const;
+
+   /**
+    * \brief Run a whole maintenance cycle now, whether or not we are idle or one is due.  This is mainly for testing.
+    *        If a cycle is part-way through, this finishes it.
+    */
+   Report runCycle();
+
+   //! \return Report from the last cycle to finish
+   Report lastReport() const;
+
+protected:
+   //! We look at all events for the application, so we know when the user last did something
+   virtual bool eventFilter(QObject * watched, QEvent * event) override;
+
+private slots:
+   //! Called periodically whilst running, to do the next step, if we're idle and there is one to do
+   void doIdleWork();
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   DbMaintenance();
+   ~DbMaintenance();
+
+   // Singleton shouldn't be getting copied or moved
+   DbMaintenance(DbMaintenance const &) = delete;
+   DbMaintenance & operator=(DbMaintenance const &) = delete;
+   DbMaintenance(DbMaintenance &&) = delete;
+   DbMaintenance & operator=(DbMaintenance &&) = delete;
+};
+
+#endif
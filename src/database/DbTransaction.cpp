@@ -15,12 +15,82 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "database/DbTransaction.h"
 
+#include <utility>
+#include <vector>
+
 #include <QDebug>
+#include <QHash>
 #include <QSqlError>
+#include <QSqlQuery>
 
 #include "database/Database.h"
+#include "database/DbWriter.h"
 #include "Logging.h"
 
+namespace {
+   /**
+    * \brief Number of \c DbTransaction objects currently open, on this thread, for each connection (identified by
+    *        connection name).
+    */
+   int & openTransactions(QSqlDatabase const & connection) {
+      // Since C++11, thread_local variables are initialised "before first use", so no locking is needed here
+      thread_local QHash<QString, int> openTransactionsForThisThread;
+      return openTransactionsForThisThread[connection.connectionName()];
+   }
+
+   /**
+    * \brief Something to do once we know whether the changes made inside a transaction (at \c depth) were committed
+    *        or rolled back.  See \c DbTransaction::onOutcome.
+    */
+   struct PendingOutcome {
+      int depth;
+      std::function<void()> onCommit;
+      std::function<void()> onRollback;
+   };
+
+   /**
+    * \brief \c PendingOutcome objects, in the order they were added, on this thread, for each connection (identified by
+    *        connection name).
+    */
+   std::vector<PendingOutcome> & pendingOutcomes(QSqlDatabase const & connection) {
+      thread_local QHash<QString, std::vector<PendingOutcome>> pendingOutcomesForThisThread;
+      return pendingOutcomesForThisThread[connection.connectionName()];
+   }
+
+   /**
+    * \brief Call \c onRollback, newest first, for, and forget, all the outcomes pending at \c depth or deeper
+    */
+   void rollBackPendingOutcomes(QSqlDatabase const & connection, int const depth) {
+      std::vector<PendingOutcome> & outcomes = pendingOutcomes(connection);
+      std::vector<PendingOutcome> rolledBack;
+      while (!outcomes.empty() && outcomes.back().depth >= depth) {
+         rolledBack.push_back(std::move(outcomes.back()));
+         outcomes.pop_back();
+      }
+      for (auto & outcome : rolledBack) {
+         outcome.onRollback();
+      }
+      return;
+   }
+
+   QString savepointName(int const depth) {
+      return QString{"bt_savepoint_%1"}.arg(depth);
+   }
+
+   /**
+    * \brief Run one of the SAVEPOINT / RELEASE SAVEPOINT / ROLLBACK TO SAVEPOINT statements, which have the same
+    *        syntax on all the DBs we support.
+    */
+   bool execSavepointStatement(QSqlDatabase & connection, QString const & sql) {
+      QSqlQuery query{connection};
+      bool const succeeded = query.exec(sql);
+      if (!succeeded) {
+         qCritical() << Q_FUNC_INFO << "Error executing" << sql << ":" << query.lastError().text();
+      }
+      return succeeded;
+   }
+}
+
 DbTransaction::DbTransaction(Database & database,
                              QSqlDatabase & connection,
                              QString const nameForLogging,
@@ -29,7 +99,29 @@ DbTransaction::DbTransaction(Database & database,
    connection{connection},
    nameForLogging{nameForLogging},
    committed{false},
-   specialBehaviours{specialBehaviours} {
+   specialBehaviours{specialBehaviours},
+   depth{openTransactions(connection)++} {
+
+   if (this->depth > 0) {
+      if (this->specialBehaviours & DISABLE_FOREIGN_KEYS) {
+         qWarning() <<
+            Q_FUNC_INFO << "Cannot disable foreign keys for nested transaction" << this->nameForLogging;
+         this->specialBehaviours &= ~DISABLE_FOREIGN_KEYS;
+      }
+      bool succeeded = execSavepointStatement(this->connection, QString{"SAVEPOINT %1;"}.arg(savepointName(this->depth)));
+      qCDebug(logDb) <<
+         Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "savepoint at depth" << this->depth << ": " <<
+         (succeeded ? "succeeded" : "failed");
+      return;
+   }
+
+   //
+   // If there are writes queued on the DB writer thread, they need to happen before anything we're about to do, both
+   // to keep writes in order and to avoid contention between the two connections.  (This is a no-op if the writer is
+   // not running or if we are the writer.)
+   //
+   DbWriter::instance().flush();
+
    // Note that, on SQLite at least, turning foreign keys on and off has to happen outside a transaction, so we have to
    // be careful about the order in which we do things.
    if (this->specialBehaviours & DISABLE_FOREIGN_KEYS) {
@@ -37,10 +129,10 @@ DbTransaction::DbTransaction(Database & database,
    }
 
    // Normally leave the next line commented out
-//   qDebug().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+//   qCDebug(logDb).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
 
    bool succeeded = this->connection.transaction();
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "begin: " << (succeeded ? "succeeded" : "failed");
    if (!succeeded) {
       qCritical() <<
@@ -51,10 +143,27 @@ DbTransaction::DbTransaction(Database & database,
 }
 
 DbTransaction::~DbTransaction() {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logDb) << Q_FUNC_INFO;
+   --openTransactions(this->connection);
+
+   if (this->depth > 0) {
+      if (!this->committed) {
+         // Rolling back to a savepoint does not remove it, so we release it afterwards
+         QString const savepoint = savepointName(this->depth);
+         bool succeeded = execSavepointStatement(this->connection, QString{"ROLLBACK TO SAVEPOINT %1;"}.arg(savepoint)) &&
+                          execSavepointStatement(this->connection, QString{"RELEASE SAVEPOINT %1;"}.arg(savepoint));
+         qCDebug(logDb) <<
+            Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "rollback to savepoint at depth" <<
+            this->depth << ": " << (succeeded ? "succeeded" : "failed");
+         rollBackPendingOutcomes(this->connection, this->depth);
+      }
+      return;
+   }
+
    if (!committed) {
+      rollBackPendingOutcomes(this->connection, this->depth);
       bool succeeded = this->connection.rollback();
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "rollback: " << (succeeded ? "succeeded" : "failed");
       if (!succeeded) {
          qCritical() <<
@@ -70,8 +179,29 @@ DbTransaction::~DbTransaction() {
 }
 
 bool DbTransaction::commit() {
-   this->committed = connection.commit();
-   qDebug() <<
+   if (this->depth > 0) {
+      this->committed = execSavepointStatement(
+         this->connection, QString{"RELEASE SAVEPOINT %1;"}.arg(savepointName(this->depth))
+      );
+      if (this->committed) {
+         // Changes made inside the savepoint now stand or fall with the transaction that encloses it
+         for (auto & outcome : pendingOutcomes(this->connection)) {
+            if (outcome.depth >= this->depth) {
+               outcome.depth = this->depth - 1;
+            }
+         }
+      }
+   } else {
+      this->committed = connection.commit();
+      if (this->committed) {
+         // Take the list first in case any of the callbacks starts a new transaction
+         std::vector<PendingOutcome> const committedOutcomes = std::exchange(pendingOutcomes(this->connection), {});
+         for (auto const & outcome : committedOutcomes) {
+            outcome.onCommit();
+         }
+      }
+   }
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Database transaction" << this->nameForLogging << "commit: " << (this->committed ? "succeeded" : "failed");
    if (!this->committed) {
       qCritical() <<
@@ -79,3 +209,31 @@ bool DbTransaction::commit() {
    }
    return this->committed;
 }
+
+bool DbTransaction::isInProgress(QSqlDatabase const & connection) {
+   return openTransactions(connection) > 0;
+}
+
+void DbTransaction::onOutcome(QSqlDatabase const & connection,
+                              std::function<void()> onCommit,
+                              std::function<void()> onRollback) {
+   int const numOpen = openTransactions(connection);
+   if (numOpen == 0) {
+      onCommit();
+      return;
+   }
+   pendingOutcomes(connection).push_back(PendingOutcome{numOpen - 1, std::move(onCommit), std::move(onRollback)});
+   return;
+}
+
+DbUnitOfWork::DbUnitOfWork(QString const nameForLogging) :
+   connection{Database::instance().sqlDatabase()},
+   dbTransaction{Database::instance(), this->connection, nameForLogging} {
+   return;
+}
+
+DbUnitOfWork::~DbUnitOfWork() {
+   // See class comment for why we always commit here
+   this->dbTransaction.commit();
+   return;
+}
@@ -17,12 +17,18 @@
 #define DATABASE_DBTRANSACTION_H
 #pragma once
 
+#include <functional>
+
 #include <QSqlDatabase>
 
 class Database;
 
 /**
  * \brief RAII wrapper for transaction(), commit(), rollback() member functions of QSqlDatabase
+ *
+ *        \c DbTransaction objects can be nested (on the same thread and connection).  Only the outermost one starts
+ *        and ends a real DB transaction.  Inner ones are implemented with \c SAVEPOINT, \c RELEASE \c SAVEPOINT and
+ *        \c ROLLBACK \c TO \c SAVEPOINT, so that rolling back an inner one only undoes the changes made inside it.
  */
 class DbTransaction {
 public:
@@ -32,7 +38,11 @@ public:
    };
 
    /**
-    * \brief Constructing a \c DbTransaction will start a DB transaction
+    * \brief Constructing a \c DbTransaction will start a DB transaction, or, if there is already one in progress on
+    *        this connection in this thread, a savepoint inside it.
+    *
+    *        Note that \c DISABLE_FOREIGN_KEYS is ignored for a nested transaction, as, on SQLite at least, foreign keys
+    *        cannot be turned on or off inside a transaction.
     */
    DbTransaction(Database & database,
                  QSqlDatabase & connection,
@@ -52,6 +62,25 @@ public:
     */
    bool commit();
 
+   /**
+    * \return \c true if there is a \c DbTransaction open on \c connection in the current thread
+    */
+   static bool isInProgress(QSqlDatabase const & connection);
+
+   /**
+    * \brief Because committing a nested \c DbTransaction only releases a savepoint, changes made inside it are not
+    *        really committed until the outermost transaction is, and can still be undone before then.  So, if there is
+    *        a \c DbTransaction open on \c connection in the current thread, this arranges for \c onCommit to be
+    *        called once the outermost one commits, or for \c onRollback to be called if the changes made so far are
+    *        instead rolled back (by the outermost transaction or by the innermost savepoint).  If there is no
+    *        transaction open then whatever was written is already committed, so \c onCommit is called straight away.
+    *
+    *        This is for keeping in-memory state (eg \c ObjectStore row versions) in step with the DB.
+    */
+   static void onOutcome(QSqlDatabase const & connection,
+                         std::function<void()> onCommit,
+                         std::function<void()> onRollback);
+
 private:
    Database & database;
    // This is intended to be a short-lived object, so it's OK to store a reference to a QSqlDatabase object
@@ -61,6 +90,8 @@ private:
    QString const nameForLogging;
    bool committed;
    int specialBehaviours;
+   //! Number of transactions that were already open on this connection when we were constructed.  0 = outermost.
+   int const depth;
 
    // RAII class shouldn't be getting copied or moved
    DbTransaction(DbTransaction const &) = delete;
@@ -70,5 +101,35 @@ private:
 
 };
 
+/**
+ * \brief RAII "unit of work" scope.  For the lifetime of a \c DbUnitOfWork object, all DB writes made on the current
+ *        thread (eg via \c ObjectStore insert, update and delete) join one outer transaction instead of each running
+ *        its own top-level one.  (Their own \c DbTransaction objects become savepoints inside it.)
+ *
+ *        This is purely for performance when doing lots of writes in one go -- eg importing a file or scaling a
+ *        recipe.  It is \b not an atomicity guarantee: the outer transaction is always committed when the
+ *        \c DbUnitOfWork goes out of scope.  (Rolling it back would leave the in-memory object caches out of step with
+ *        the DB.)  Individual writes that fail are still rolled back via their own savepoints.
+ *
+ *        Scopes can be nested; inner ones are then just savepoints too.
+ */
+class DbUnitOfWork {
+public:
+   DbUnitOfWork(QString const nameForLogging = "Unit of work");
+   ~DbUnitOfWork();
+
+private:
+   // Per the comments in Database.h, we shouldn't keep a QSqlDatabase around for long, but the lifetime of this object
+   // is just a single operation.
+   QSqlDatabase connection;
+   DbTransaction dbTransaction;
+
+   // RAII class shouldn't be getting copied or moved
+   DbUnitOfWork(DbUnitOfWork const &) = delete;
+   DbUnitOfWork & operator=(DbUnitOfWork const &) = delete;
+   DbUnitOfWork(DbUnitOfWork &&) = delete;
+   DbUnitOfWork & operator=(DbUnitOfWork &&) = delete;
+};
+
 
 #endif
@@ -0,0 +1,224 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbWriter.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/DbWriter.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <QDebug>
+
+#include "database/Database.h"
+#include "database/DbTransaction.h"
+#include "Logging.h"
+
+#ifdef BUILDING_WITH_CMAKE
+   // Explicitly doing this include reduces potential problems with AUTOMOC when compiling with CMake
+   #include "moc_DbWriter.cpp"
+#endif
+
+namespace {
+   // Set on the writer thread, so we can avoid it waiting for itself
+   thread_local bool isDbWriterThread{false};
+
+   struct QueuedWrite {
+      QString description;
+      DbWriter::WriteFunction writeFunction;
+   };
+}
+
+// This private implementation class holds all private non-virtual members of DbWriter
+class DbWriter::impl {
+public:
+   impl(DbWriter & self) :
+      m_self{self},
+      m_thread{},
+      m_running{false},
+      m_mutex{},
+      m_wakeCondition{},
+      m_idleCondition{},
+      m_queue{},
+      m_busy{false} {
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Do one queued write, in its own savepoint, reporting any failure.  (If called outside the writer thread,
+    *        the savepoint will just be a normal transaction.)
+    */
+   void write(Database & database, QSqlDatabase & connection, QueuedWrite & queuedWrite) {
+      DbTransaction dbTransaction{database, connection, queuedWrite.description};
+      if (queuedWrite.writeFunction(connection) && dbTransaction.commit()) {
+         return;
+      }
+      qCritical() << Q_FUNC_INFO << "Queued DB write failed:" << queuedWrite.description;
+      emit this->m_self.writeFailed(queuedWrite.description);
+      return;
+   }
+
+   //! Write out a batch of queued writes in a single transaction
+   void writeBatch(std::deque<QueuedWrite> & batch) {
+      Database & database = Database::instance();
+      QSqlDatabase connection = database.sqlDatabase();
+      this->m_connectionName = connection.connectionName();
+      DbTransaction dbTransaction{database, connection, QString{"DB writer batch of %1"}.arg(batch.size())};
+      for (auto & queuedWrite : batch) {
+         this->write(database, connection, queuedWrite);
+      }
+      dbTransaction.commit();
+      return;
+   }
+
+   void run() {
+      isDbWriterThread = true;
+      for (;;) {
+         std::deque<QueuedWrite> batch;
+         {
+            std::unique_lock<std::mutex> lock{this->m_mutex};
+            this->m_wakeCondition.wait(lock, [this]() {
+               return !this->m_queue.empty() || !this->m_running.load(std::memory_order_acquire);
+            });
+            // When we're asked to stop, we still write out anything that's already queued
+            if (this->m_queue.empty()) {
+               break;
+            }
+            batch.swap(this->m_queue);
+            this->m_busy = true;
+         }
+         qCDebug(logDb) << Q_FUNC_INFO << "Writing" << batch.size() << "queued write(s)";
+         this->writeBatch(batch);
+         {
+            std::lock_guard<std::mutex> lock{this->m_mutex};
+            this->m_busy = false;
+         }
+         this->m_idleCondition.notify_all();
+      }
+
+      //
+      // Per the comments in Database.h, the connection has to be removed on the thread that used it, and only once all
+      // QSqlDatabase objects referring to it are out of scope (which they are by now).
+      //
+      if (!this->m_connectionName.isEmpty()) {
+         QSqlDatabase::removeDatabase(this->m_connectionName);
+         this->m_connectionName.clear();
+      }
+      this->m_idleCondition.notify_all();
+      return;
+   }
+
+   DbWriter &              m_self;
+   std::thread             m_thread;
+   std::atomic<bool>       m_running;
+   std::mutex              m_mutex;
+   std::condition_variable m_wakeCondition;
+   std::condition_variable m_idleCondition;
+   std::deque<QueuedWrite> m_queue;
+   bool                    m_busy;
+   // Only accessed on the writer thread
+   QString                 m_connectionName;
+};
+
+DbWriter::DbWriter() : pimpl{std::make_unique<impl>(*this)} {
+   return;
+}
+
+DbWriter::~DbWriter() {
+   // This is a safety net for if stop() wasn't called.  We must not destroy a joinable std::thread.
+   this->stop();
+   return;
+}
+
+DbWriter & DbWriter::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static DbWriter dbWriter;
+   return dbWriter;
+}
+
+void DbWriter::start() {
+   if (this->pimpl->m_running.exchange(true)) {
+      return;
+   }
+   qInfo() << Q_FUNC_INFO << "Starting DB writer thread";
+   this->pimpl->m_thread = std::thread{[this]() { this->pimpl->run(); }};
+   return;
+}
+
+void DbWriter::stop() {
+   {
+      std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+      if (!this->pimpl->m_running.exchange(false)) {
+         return;
+      }
+   }
+   qInfo() << Q_FUNC_INFO << "Stopping DB writer thread";
+   this->pimpl->m_wakeCondition.notify_one();
+   if (this->pimpl->m_thread.joinable()) {
+      this->pimpl->m_thread.join();
+   }
+   return;
+}
+
+bool DbWriter::isRunning() const {
+   return this->pimpl->m_running.load(std::memory_order_acquire);
+}
+
+bool DbWriter::isWriterThread() {
+   return isDbWriterThread;
+}
+
+void DbWriter::enqueue(QString const & description, DbWriter::WriteFunction writeFunction) {
+   QueuedWrite queuedWrite{description, std::move(writeFunction)};
+   {
+      std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+      if (this->pimpl->m_running.load(std::memory_order_acquire)) {
+         this->pimpl->m_queue.push_back(std::move(queuedWrite));
+         this->pimpl->m_wakeCondition.notify_one();
+         return;
+      }
+   }
+
+   // Writer isn't running, so just do the write now
+   Database & database = Database::instance();
+   QSqlDatabase connection = database.sqlDatabase();
+   this->pimpl->write(database, connection, queuedWrite);
+   return;
+}
+
+void DbWriter::flush() {
+   if (isDbWriterThread) {
+      return;
+   }
+   //
+   // Note that we don't check isRunning() here, because, when stop() has been called, that returns false straight away
+   // but the writer thread keeps going until it has written out everything on the queue.  If the writer was never
+   // started, the queue is empty and it is not busy, so we don't wait.
+   //
+   std::unique_lock<std::mutex> lock{this->pimpl->m_mutex};
+   this->pimpl->m_idleCondition.wait(lock, [this]() {
+      return this->pimpl->m_queue.empty() && !this->pimpl->m_busy;
+   });
+   return;
+}
+
+std::size_t DbWriter::numQueued() const {
+   std::lock_guard<std::mutex> lock{this->pimpl->m_mutex};
+   return this->pimpl->m_queue.size();
+}
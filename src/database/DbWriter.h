@@ -0,0 +1,109 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/DbWriter.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_DBWRITER_H
+#define DATABASE_DBWRITER_H
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include <QObject>
+#include <QSqlDatabase>
+#include <QString>
+
+/**
+ * \brief Optional background thread, with its own DB connection, that does DB writes on behalf of other threads.
+ *
+ *        Normally every \c ObjectStore write happens synchronously on the calling (usually GUI) thread.  On a slow DB
+ *        (eg PostgreSQL over a slow link, or SQLite on a network share), this means every keystroke-driven property
+ *        change blocks the UI for a DB round trip.  When the writer is running, \c ObjectStore::updateProperty
+ *        instead captures what it needs to write (on the calling thread) and queues it here.  The in-memory object
+ *        has already been updated, so the rest of the program carries on as normal.
+ *
+ *        The writer thread takes everything on the queue in one go and writes it in a single transaction, with each
+ *        queued write in its own savepoint (see \c DbTransaction), so one failed write does not lose the others.
+ *        Failures are reported via \c writeFailed.
+ *
+ *        Writes that cannot be queued (eg inserts, which need the DB to assign a primary key before they return) stay
+ *        synchronous.  To keep all writes in order, starting a top-level \c DbTransaction on any other thread first
+ *        calls \c flush(), which waits for the queue to be written out.  Callers that need the DB file itself to be
+ *        up-to-date (eg backup) should also call \c flush().
+ */
+class DbWriter : public QObject {
+   Q_OBJECT
+
+public:
+   /**
+    * \brief A queued write.  This is run on the writer thread, so it must not touch any model objects -- ie anything
+    *        it needs from them has to be captured (by value) when it is created.
+    *
+    * \return \c true if the write succeeded, \c false otherwise
+    */
+   using WriteFunction = std::function<bool(QSqlDatabase & connection)>;
+
+   static DbWriter & instance();
+
+   //! \brief Start the writer thread.  Does nothing if it is already running.
+   void start();
+
+   //! \brief Write out everything queued, then stop the writer thread (and close its DB connection)
+   void stop();
+
+   bool isRunning() const;
+
+   //! \return \c true if we are being called on the writer thread
+   static bool isWriterThread();
+
+   /**
+    * \brief Queue a write.  If the writer is not running, the write is done straight away on the calling thread.
+    *
+    * \param description For logging and for \c writeFailed
+    */
+   void enqueue(QString const & description, WriteFunction writeFunction);
+
+   /**
+    * \brief Block until everything queued before the call has been written to the DB.  This includes the case where
+    *        the writer is part way through stopping, and still writing out its queue.  Does nothing if called on the
+    *        writer thread.
+    */
+   void flush();
+
+   //! \return Number of writes on the queue, not counting any that the writer thread has already started on
+   std::size_t numQueued() const;
+
+signals:
+   /**
+    * \brief Emitted (from the writer thread) when a queued write fails.  NB: by this point, the in-memory object will
+    *        differ from what is stored in the DB.
+    */
+   void writeFailed(QString const & description);
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   DbWriter();
+   ~DbWriter();
+
+   // Singleton shouldn't be getting copied or moved
+   DbWriter(DbWriter const &) = delete;
+   DbWriter & operator=(DbWriter const &) = delete;
+   DbWriter(DbWriter &&) = delete;
+   DbWriter & operator=(DbWriter &&) = delete;
+};
+
+#endif
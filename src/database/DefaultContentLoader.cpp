@@ -25,6 +25,7 @@
 #include "config.h"
 #include "database/DatabaseSchemaHelper.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Recipe.h"
 #include "serialization/ImportExport.h"
 
@@ -123,7 +124,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             userMessage << QObject::tr("Error matching %1 file pattern in %2 directory").arg(globPattern, dir.absolutePath());
             return DefaultContentLoader::UpdateResult::Failed;
          }
-         qDebug() << Q_FUNC_INFO << "Will read in" << matchingFiles.at(0);
+         qCDebug(logDb) << Q_FUNC_INFO << "Will read in" << matchingFiles.at(0);
          inputFiles << dir.absoluteFilePath(matchingFiles.at(0));
       }
 
@@ -134,7 +135,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
          // folder.
          //
          QList<Recipe *> allRecipesBeforeImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-         qDebug() << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
+         qCDebug(logDb) << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
 
          succeeded = ImportExport::importFromFiles(inputFiles);
 
@@ -143,7 +144,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             // Now see what Recipes exist that weren't there before the import
             //
             QList<Recipe *> allRecipesAfterImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-            qDebug() << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
+            qCDebug(logDb) << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
 
             //
             // Once the lists are sorted, finding the difference is just a library call
@@ -155,7 +156,7 @@ DefaultContentLoader::UpdateResult DefaultContentLoader::updateContentIfNecessar
             std::set_difference(allRecipesAfterImport.begin(), allRecipesAfterImport.end(),
                                 allRecipesBeforeImport.begin(), allRecipesBeforeImport.end(),
                                 std::back_inserter(newlyImportedRecipes));
-            qDebug() << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
+            qCDebug(logDb) << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
             // TODO: It would be neat, at some point, to to have a mechanism for setting a property on multiple objects
             //       of the same type, so that we could do it in a single DB update.
             for (auto recipe : newlyImportedRecipes) {
@@ -15,12 +15,18 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "database/ObjectStore.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream> // For start-up errors!
+#include <memory>
+#include <numeric>
 #include <tuple>
+#include <utility>
+#include <vector>
 
 #include <QDebug>
 #include <QHash>
+#include <QList>
 #include <QMap>
 #include <QSqlDriver>
 #include <QSqlError>
@@ -30,10 +36,17 @@
 #include <qglobal.h> // For Q_ASSERT and Q_UNREACHABLE
 
 #include "database/BtSqlQuery.h"
+#include "database/ChangeJournal.h"
 #include "database/Database.h"
+#include "database/DbChangeNotifier.h"
 #include "database/DbTransaction.h"
+#include "database/DbWriter.h"
+#include "database/StartupSnapshot.h"
 #include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/EnumeratedBase.h"
 #include "model/NamedParameterBundle.h"
+#include "model/OwnedByRecipe.h"
 #include "utils/MetaTypes.h"
 #include "utils/OptionalHelpers.h"
 
@@ -45,6 +58,64 @@
 // Private implementation details that don't need access to class member variables
 namespace {
 
+   /**
+    * \brief Every primary table has this extra column, which is not mapped to any object property.  It starts at 1 and
+    *        every write to the row increments it.  A write only succeeds if the row version in the DB is still the one
+    *        we last read or wrote, which is how we detect that someone else (ie another client sharing a PostgreSQL
+    *        database) changed the row in the meantime.  See also \c DbChangeNotifier.
+    */
+   char const * const rowVersionColumn = "row_version";
+
+   /**
+    * \brief Non-zero whilst we are updating cached objects to match changes someone else made in the DB (see
+    *        \c ObjectStore::refreshFromDb).
+    */
+   thread_local int applyingRemoteChangesDepth{0};
+
+   /**
+    * \brief RAII wrapper for setting \c applyingRemoteChangesDepth
+    */
+   struct ApplyingRemoteChanges {
+      ApplyingRemoteChanges() {
+         ++applyingRemoteChangesDepth;
+         return;
+      }
+      ~ApplyingRemoteChanges() {
+         --applyingRemoteChangesDepth;
+         return;
+      }
+   };
+
+   /**
+    * \brief Result of trying to write an object, or one of its properties, to the DB
+    */
+   enum class WriteResult {
+      Succeeded,
+      Failed,
+      //! Nothing was written because someone else changed the row since we last read or wrote it
+      Conflict
+   };
+
+   /**
+    * \brief One row of a snapshot (see \c StartupSnapshot), with the same \c value() accessor as \c BtSqlQuery, so
+    *        that \c readRow can read from either.  The columns are in the same order as in a \c selectRowsQueryString
+    *        query.
+    */
+   struct SnapshotRow {
+      QVariant value(int const index) const {
+         return this->values.at(index);
+      }
+      QVector<QVariant> values;
+   };
+
+   QString lastErrorText(BtSqlQuery const & sqlQuery) {
+      return sqlQuery.lastError().text();
+   }
+
+   QString lastErrorText([[maybe_unused]] SnapshotRow const & snapshotRow) {
+      return "Invalid value in snapshot";
+   }
+
    /**
     * \brief For a given field type, get the native database typename
     */
@@ -82,7 +153,8 @@ namespace {
     */
    bool createTableWithoutForeignKeys(Database & database,
                                       QSqlDatabase & connection,
-                                      ObjectStore::TableDefinition const & tableDefinition) {
+                                      ObjectStore::TableDefinition const & tableDefinition,
+                                      bool const withRowVersion) {
       //
       // We're building a SQL string of the form
       //    CREATE TABLE foobar (
@@ -101,7 +173,7 @@ namespace {
       bool firstFieldOutput = false;
       for (auto const & fieldDefn: tableDefinition.tableFields) {
          if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
-            qDebug() << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
+            qCDebug(logDb) << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
             // It's (currently) a coding error if a foreign key is anything other than an integer
             Q_ASSERT(fieldDefn.fieldType == ObjectStore::FieldType::Int);
             continue;
@@ -131,9 +203,13 @@ namespace {
             queryStringAsStream << " " << getDatabaseNativeTypeName(database, fieldDefn.fieldType);
          }
       }
+      if (withRowVersion) {
+         queryStringAsStream <<
+            ", \n" << rowVersionColumn << " " << database.getDbNativeTypeName<int>() << " NOT NULL DEFAULT 1";
+      }
       queryStringAsStream << "\n);";
 
-      qDebug().noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
+      qCDebug(logDb).noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
 
       BtSqlQuery sqlQuery{connection};
       sqlQuery.prepare(queryString);
@@ -194,7 +270,7 @@ namespace {
             ).arg(
                *foreignKeyTo->tableFields[0].columnName
             );
-            qDebug().noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
+            qCDebug(logDb).noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
 
             sqlQuery.prepare(queryString);
             if (!sqlQuery.exec()) {
@@ -208,6 +284,46 @@ namespace {
       return true;
    }
 
+   /**
+    * \brief Add indexes to a table, on all its foreign key columns plus any others listed in
+    *        \c TableDefinition::indexedColumns.  This needs to be done after \c addForeignKeysToTable, as that's what
+    *        adds the foreign key columns.
+    *
+    *        We use "IF NOT EXISTS" (which both SQLite and PostgreSQL support) so that it doesn't matter if a migration
+    *        has already added the index to an existing database.
+    *
+    * \return true if succeeded, false otherwise
+    */
+   bool addIndexesToTable(QSqlDatabase & connection, ObjectStore::TableDefinition const & tableDefinition) {
+      QStringList columnNames;
+      for (auto const & fieldDefn: tableDefinition.tableFields) {
+         if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
+            columnNames.append(*fieldDefn.columnName);
+         }
+      }
+      for (auto const & columnName : tableDefinition.indexedColumns) {
+         if (!columnNames.contains(columnName)) {
+            columnNames.append(columnName);
+         }
+      }
+
+      BtSqlQuery sqlQuery{connection};
+      for (auto const & columnName : columnNames) {
+         QString const queryString = QString{
+            "CREATE INDEX IF NOT EXISTS %1_%2_idx ON %1 (%2);"
+         }.arg(*tableDefinition.tableName).arg(columnName);
+         qCDebug(logDb).noquote() << Q_FUNC_INFO << "Index: " << queryString;
+
+         sqlQuery.prepare(queryString);
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
+   }
+
    /**
     * \brief Converts a QVariant to a QString, but with a special value for a null QVariant
     */
@@ -223,7 +339,7 @@ namespace {
     *        when you get an error!
     *
     *        NOTE: This can be a long string.  It includes newlines, and is intended to be logged with
-    *              qDebug().noquote() or similar.
+    *              qCDebug(logDb).noquote() or similar.
     */
    QString BoundValuesToString(BtSqlQuery const & sqlQuery) {
       QString result;
@@ -246,6 +362,43 @@ namespace {
       return result;
    }
 
+   /**
+    * \brief SQL and bind values for a single write, captured so that it can be executed later and/or on another thread
+    *        (see \c DbWriter)
+    */
+   struct PreparedWrite {
+      QString queryString;
+      QList<std::pair<QString, QVariant>> bindValues;
+      //! If \c true, the query has a row version check, so not updating any rows means there was a conflict
+      bool checksRowVersion = false;
+   };
+
+   /**
+    * \brief Execute a \c PreparedWrite.  NB: Caller is responsible for handling transactions.
+    */
+   WriteResult execPreparedWrite(QSqlDatabase & connection, PreparedWrite const & preparedWrite) {
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(preparedWrite.queryString);
+      for (auto const & [name, value] : preparedWrite.bindValues) {
+         sqlQuery.bindValue(name, value);
+      }
+      qCDebug(logDb).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+
+      if (!sqlQuery.exec()) {
+         qCritical() <<
+            Q_FUNC_INFO << "Error executing database query " << preparedWrite.queryString << ": " <<
+            sqlQuery.lastError().text();
+         return WriteResult::Failed;
+      }
+      if (preparedWrite.checksRowVersion && sqlQuery.numRowsAffected() == 0) {
+         qWarning() <<
+            Q_FUNC_INFO << "Row version check failed for" << preparedWrite.queryString << "with bind values" <<
+            BoundValuesToString(sqlQuery);
+         return WriteResult::Conflict;
+      }
+      return WriteResult::Succeeded;
+   }
+
    /**
     * \brief Given a string value pulled out of the DB for an enum, look up and return its internal numerical enum
     *        equivalent.  Caller's responsibility to handle null values etc before deciding whether to call this
@@ -332,7 +485,7 @@ namespace {
                                           QObject const & object,
                                           QVariant const & primaryKey,
                                           QSqlDatabase & connection) {
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Writing" << object.metaObject()->className() << "property" <<
          GetJunctionTableDefinitionPropertyName(junctionTable) << " into junction table " <<
          junctionTable.tableName;
@@ -385,7 +538,7 @@ namespace {
          queryStringAsStream << ", " << orderByBindName;
       }
       queryStringAsStream << ");";
-      qDebug() << Q_FUNC_INFO << "Using query string" << queryString;
+      qCDebug(logDb) << Q_FUNC_INFO << "Using query string" << queryString;
 
       //
       // Note that, when we are using bind values, we do NOT want to call the
@@ -422,7 +575,7 @@ namespace {
          // If the foreign key returned is not valid, it's not an error, it just means there is no associated object,
          // eg this Hop does not have a parent.
          if (theValue <= 0) {
-            qDebug() <<
+            qCDebug(logDb) <<
                Q_FUNC_INFO << "Property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
                object.metaObject()->className() << "#" << primaryKey.toInt() << "is" << theValue <<
                "which we assume means \"unset\", so nothing to write to junction table" <<
@@ -451,7 +604,7 @@ namespace {
 
       // Now loop through and bind/run the insert query once for each item in the list
       int itemNumber = 1;
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << propertyValues.size() << "value(s) (in" << propertyValuesWrapper.typeName() <<
          ") for property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
          object.metaObject()->className() << "#" << primaryKey.toInt();
@@ -461,7 +614,7 @@ namespace {
          if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
             sqlQuery.bindValue(orderByBindName, itemNumber);
          }
-         qDebug() <<
+         qCDebug(logDb) <<
             Q_FUNC_INFO <<
             GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << " #" << primaryKey.toInt() << ":" <<
             GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) << "N°" << itemNumber << " is #" << curValue;
@@ -490,7 +643,7 @@ namespace {
                                           QVariant const & primaryKey,
                                           QSqlDatabase & connection) {
 
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Deleting property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
          " in junction table " << junctionTable.tableName;
 
@@ -509,7 +662,7 @@ namespace {
 
       // Bind the primary key value
       sqlQuery.bindValue(thisPrimaryKeyBindName, primaryKey);
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      qCDebug(logDb).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
       // Run the query
       if (!sqlQuery.exec()) {
@@ -604,9 +757,11 @@ ObjectStore::TableField::TableField(ObjectStore::FieldType                 const
 }
 
 ObjectStore::TableDefinition::TableDefinition(char const * const tableName,
-                                              std::initializer_list<TableField> const tableFields) :
+                                              std::initializer_list<TableField> const tableFields,
+                                              QStringList const & indexedColumns) :
          tableName{tableName},
-         tableFields{tableFields} {
+         tableFields{tableFields},
+         indexedColumns{indexedColumns} {
 
    //
    // Uncomment the following if trying to debug issues with foreign keys.
@@ -624,7 +779,7 @@ ObjectStore::TableDefinition::TableDefinition(char const * const tableName,
 //            qCritical() << Q_FUNC_INFO << "Foreign key table for column" << fieldDefn.columnName << "has no columns!";
 //            exit(EXIT_FAILURE);
 //         }
-//         qDebug() <<
+//         qCDebug(logDb) <<
 //            Q_FUNC_INFO << "Table" << tableName << "foreign key" << fieldDefn.columnName << "points to table "
 //            "definition for table" << *tableDefinition->tableName << "with" << tableDefinition->tableFields.size() <<
 //            "columns";
@@ -650,12 +805,75 @@ public:
                                                            primaryTable{primaryTable},
                                                            junctionTables{junctionTables},
                                                            allObjects{},
-                                                           database{nullptr} {
+                                                           database{nullptr},
+                                                           columnDecoders{},
+                                                           rowLayout{},
+                                                           rowVersions{},
+                                                           confirmedRowVersions{} {
       return;
    }
 
    ~impl() = default;
 
+   /**
+    * \brief Everything we need to know to turn the value of one primary table column into a constructor parameter that
+    *        does not depend on the row being read.  We work this out once per store rather than once per row.
+    */
+   struct ColumnDecoder {
+      ObjectStore::TableField const * fieldDefn;
+      //! Ordinal of the property in \c rowLayout, which is also the ordinal of the column in the \c loadAll query
+      int ordinal;
+      bool isOptional;
+      //! Types that we accept from the DB driver for this column (see \c getExpectedTypes)
+      QVector<int> expectedTypes;
+      /**
+       * If a non-null value read from the DB already has this type, it can be passed straight to the constructor
+       * without any further processing.  Set to \c QMetaType::UnknownType for columns that always need processing
+       * (optionals, enums, units).
+       */
+      int propertyTypeId;
+   };
+
+   /**
+    * \brief Called once, on first use, to set up \c columnDecoders and \c rowLayout.  (We can't do it in the
+    *        constructor as the static \c TypeLookup and \c TableDefinition objects we refer to are not guaranteed to have
+    *        been initialised by then.)
+    */
+   void initColumnDecoders() {
+      if (this->rowLayout) {
+         return;
+      }
+      std::vector<BtStringConst const *> propertyNames;
+      propertyNames.reserve(this->primaryTable.tableFields.size());
+      this->columnDecoders.clear();
+      this->columnDecoders.reserve(this->primaryTable.tableFields.size());
+      for (auto const & fieldDefn : this->primaryTable.tableFields) {
+         bool const isOptional = this->typeLookup.getType(fieldDefn.propertyName).isOptional();
+         int propertyTypeId = QMetaType::UnknownType;
+         if (!isOptional) {
+            switch (fieldDefn.fieldType) {
+               case ObjectStore::FieldType::Bool  : { propertyTypeId = QMetaType::Bool   ; break; }
+               case ObjectStore::FieldType::Int   : { propertyTypeId = QMetaType::Int    ; break; }
+               case ObjectStore::FieldType::UInt  : { propertyTypeId = QMetaType::UInt   ; break; }
+               case ObjectStore::FieldType::Double: { propertyTypeId = QMetaType::Double ; break; }
+               case ObjectStore::FieldType::String: { propertyTypeId = QMetaType::QString; break; }
+               case ObjectStore::FieldType::Date  : { propertyTypeId = QMetaType::QDate  ; break; }
+               case ObjectStore::FieldType::Enum  :
+               case ObjectStore::FieldType::Unit  : { break; }
+               // No default case needed as compiler should warn us if any options covered above
+            }
+         }
+         this->columnDecoders.push_back(ColumnDecoder{&fieldDefn,
+                                                      static_cast<int>(propertyNames.size()),
+                                                      isOptional,
+                                                      getExpectedTypes(fieldDefn.fieldType),
+                                                      propertyTypeId});
+         propertyNames.push_back(&fieldDefn.propertyName);
+      }
+      this->rowLayout = std::make_shared<NamedParameterBundle::Layout const>(std::move(propertyNames));
+      return;
+   }
+
    /**
     * \brief This function does any required special handling for optional and/or enum fields retrieved from a
     *        \c NamedEntity or subclass thereof.  It takes the \c QVariant returned from \c QObject::property() and does
@@ -795,34 +1013,40 @@ public:
     *
     * \param primaryTable This is used only for logging errors (in case there is bad data in the DB, which could happen
     *                     if the DB has been manually edited or partially restored from an old verison etc.
-    * \param fieldDefn
+    * \param columnDecoder
     * \param valueFromDb the QVariant that we may need to modify
     */
    void wrapAndUnmapAsNeeded(ObjectStore::TableDefinition const & primaryTable,
-                             ObjectStore::TableField const & fieldDefn,
+                             ColumnDecoder const & columnDecoder,
                              QVariant & propertyValue) {
+      ObjectStore::TableField const & fieldDefn = *columnDecoder.fieldDefn;
       //
       // If it is not null (when the type info is not meaningful), we would like to check that the QVariant we've
       // received back from the QSqlQuery object is a sane type.  If it isn't then it could indicate either a past or
       // current coding error, or some manual edit of the DB.  Either way we at least want to log a warning.
       //
       if (!propertyValue.isNull()) {
-         auto expectedTypes = getExpectedTypes(fieldDefn.fieldType);
-
          // NB: In Qt 6, QVariant::type() becomes QVariant::typeId()
 #if QT_VERSION < QT_VERSION_CHECK(6,0,0)
             int const propertyType = propertyValue.type();
 #else
             int const propertyType = propertyValue.typeId();
 #endif
-         if (!expectedTypes.contains(propertyType)) {
+         //
+         // Most of the time, the DB driver hands us exactly the type the property wants, in which case there is
+         // nothing to check and nothing to clean.
+         //
+         if (propertyType == columnDecoder.propertyTypeId) {
+            return;
+         }
+         if (!columnDecoder.expectedTypes.contains(propertyType)) {
             TableColumnAndType tableColumnAndType{*primaryTable.tableName, *fieldDefn.columnName, fieldDefn.fieldType};
             if (legacyBadTypes.contains(tableColumnAndType) &&
                legacyBadTypes.value(tableColumnAndType).contains(propertyType)) {
                // It's technically wrong but we know about it and it works, so just log it.  If this logging is
                // uncommented, you can get a list of all the things we need to fix with:
                //   grep "known ugliness" *.log | sed 's/^.*property /Property /; s/This is a known ugliness .*$//' | sort -u
-//               qDebug() <<
+//               qCDebug(logDb) <<
 //                  Q_FUNC_INFO << fieldDefn.fieldType << "property" << fieldDefn.propertyName << "on table" <<
 //                  primaryTable.tableName << "(value " << propertyValue << ") is stored as " <<
 //                  propertyValue.typeName() << "(" << propertyType << ") in column" << fieldDefn.columnName <<
@@ -885,7 +1109,7 @@ public:
          }
       }
 
-      if (this->typeLookup.getType(fieldDefn.propertyName).isOptional()) {
+      if (columnDecoder.isOptional) {
          //
          // This is an optional field, so we are converting from a QVariant holding either T or null to a QVariant
          // holding std::optional<T>, with relevant special case handling for when T is actually an enum (where we need
@@ -1034,100 +1258,243 @@ public:
    }
 
    /**
-    * \brief Update the specified property on an object
-    *
-    *        NB: Caller is responsible for handling transactions
-    *
-    * \return \c true if succeeded, \c false otherwise
+    * \return The \c TableField for \c propertyName if it is stored directly in the primary table, or \c nullptr if it
+    *         is stored in a junction table
     */
-   bool updatePropertyInDb(QSqlDatabase & connection, QObject const & object, BtStringConst const & propertyName) {
-      // We'll need some of this info even if it's a junction table property we're updating
-      BtStringConst const & primaryKeyColumn {this->getPrimaryKeyColumn()};
-      QVariant const        primaryKey       {this->getPrimaryKey(object)};
-
-      //
-      // First check whether this is a simple property.  (If not we look for it in the ones we store in junction
-      // tables.)
-      //
+   TableField const * findSimpleProperty(BtStringConst const & propertyName) const {
       auto matchingFieldDefn = std::find_if(
          this->primaryTable.tableFields.begin(),
          this->primaryTable.tableFields.end(),
          [propertyName](TableField const & fd) {return fd.propertyName == propertyName;}
       );
+      if (matchingFieldDefn == this->primaryTable.tableFields.end()) {
+         return nullptr;
+      }
+      return &(*matchingFieldDefn);
+   }
 
-      if (matchingFieldDefn != this->primaryTable.tableFields.end()) {
-         //
-         // We're updating a simple property
+   /**
+    * \brief Construct the SQL and bind values to update a property that is stored directly in the primary table.
+    *        This reads the property value from \c object, so it must be called on the thread that owns it, but the
+    *        result can be executed (by \c execPreparedWrite) on any thread.
+    */
+   PreparedWrite prepareSimplePropertyUpdate(QObject const & object, TableField const & fieldDefn) {
+      QVariant const primaryKey{this->getPrimaryKey(object)};
+
+      //
+      // Construct the SQL, which will be of the form
+      //
+      //    UPDATE tablename
+      //    SET columnName = :columnName, row_version = row_version + 1
+      //    WHERE primaryKeyColumn = :primaryKeyColumn AND row_version = :row_version;
+      //
+      PreparedWrite preparedWrite{"UPDATE ", {}};
+      QTextStream queryStringAsStream{&preparedWrite.queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+
+      BtStringConst const & columnToUpdateInDb = fieldDefn.columnName;
+
+      queryStringAsStream << " " << columnToUpdateInDb << " = :" << columnToUpdateInDb << ", ";
+      this->appendRowVersionUpdate(queryStringAsStream, preparedWrite, primaryKey);
+
+      //
+      // Work out the bind values
+      //
+      QVariant propertyBindValue{object.property(*fieldDefn.propertyName)};
+      // It's a coding error if the property we are trying to read from does not exist
+      Q_ASSERT(propertyBindValue.isValid());
+
+      // Fix-up the QVariant if needed, including converting enums to strings
+      this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, propertyBindValue);
+
+      if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
          //
-         // Construct the SQL, which will be of the form
+         // If the columns if a foreign key and the caller is setting it to a non-positive value then we actually
+         // need to store NULL in the DB.  (In the code we store foreign key IDs as ints, and use -1 to mean null.
+         // In the DB we need to store NULL explicitly because, if we try to store -1, we'll get a foreign key
+         // constraint violation as the DB is unable to find a row in the related table with primary key -1.)
          //
-         //    UPDATE tablename
-         //    SET columnName = :columnName
-         //    WHERE primaryKeyColumn = :primaryKeyColumn;
+         // Firstly, we assert it's a coding error if we've created a foreign key column that's not an int.  For the
+         // moment at least, we don't support other types of primary/foreign key.
          //
-         QString queryString{"UPDATE "};
-         QTextStream queryStringAsStream{&queryString};
-         queryStringAsStream << this->primaryTable.tableName << " SET ";
+         Q_ASSERT(ObjectStore::FieldType::Int == fieldDefn.fieldType);
+         if (propertyBindValue.toInt() <= 0) {
+            qCDebug(logDb) << Q_FUNC_INFO << "Treating" << propertyBindValue << "foreign key value as NULL";
+            propertyBindValue = QVariant{QMetaType{QMetaType::Int}};
+         }
+      }
+      preparedWrite.bindValues.append({QString{":%1"}.arg(*columnToUpdateInDb), propertyBindValue});
+      return preparedWrite;
+   }
+
+   /**
+    * \brief Append, to an UPDATE query we are constructing, the increment of the row version and the WHERE clause
+    *        that selects the row by its primary key and, if we know it, the row version we expect it to have.  Bind
+    *        values for the WHERE clause are added to \c preparedWrite.
+    */
+   void appendRowVersionUpdate(QTextStream & queryStringAsStream,
+                               PreparedWrite & preparedWrite,
+                               QVariant const & primaryKey) {
+      BtStringConst const & primaryKeyColumn {this->getPrimaryKeyColumn()};
+      queryStringAsStream <<
+         rowVersionColumn << " = " << rowVersionColumn << " + 1 WHERE " << primaryKeyColumn << " = :" <<
+         primaryKeyColumn;
+      preparedWrite.bindValues.append({QString{":%1"}.arg(*primaryKeyColumn), primaryKey});
 
-         BtStringConst const & columnToUpdateInDb = matchingFieldDefn->columnName;
+      //
+      // If we don't know the row version (which shouldn't happen for anything we loaded or inserted) then we just have
+      // to do the write without the check.
+      //
+      int const rowVersion = this->rowVersions.value(primaryKey.toInt(), 0);
+      if (rowVersion > 0) {
+         queryStringAsStream << " AND " << rowVersionColumn << " = :" << rowVersionColumn;
+         preparedWrite.bindValues.append({QString{":%1"}.arg(rowVersionColumn), rowVersion});
+         preparedWrite.checksRowVersion = true;
+      }
+      queryStringAsStream << ";";
+      return;
+   }
 
-         queryStringAsStream << " " << columnToUpdateInDb << " = :" << columnToUpdateInDb;
-         queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
+   /**
+    * \brief Construct the SQL and bind values to just increment the row version of an object (with the usual check).
+    *        Used when the change itself is not in the primary table.
+    */
+   PreparedWrite prepareRowVersionUpdate(QVariant const & primaryKey) {
+      PreparedWrite preparedWrite{"UPDATE ", {}};
+      QTextStream queryStringAsStream{&preparedWrite.queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+      this->appendRowVersionUpdate(queryStringAsStream, preparedWrite, primaryKey);
+      return preparedWrite;
+   }
 
-         qDebug() <<
-            Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
-            "with database query" << queryString;
-         // Normally leave the next debug output commented, as it can generate a lot of logging.  But it's useful to
-         // uncomment if you're seeing a lot of DB updates and the cause is not clear.
-//         qDebug().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+   /**
+    * \brief Call after a successful write of an object (once the write's own \c DbTransaction has finished) to keep
+    *        our record of its row version in step with the DB.
+    *
+    *        If the write was part of an enclosing transaction (eg a \c DbUnitOfWork), then the next write to the object
+    *        needs to expect the new row version straight away, but we only count it as confirmed once the outermost
+    *        transaction commits.  If instead the write gets rolled back, so does our record of it.
+    */
+   void recordWrite(int const primaryKey) {
+      this->recordQueuedWrite(primaryKey);
+      DbTransaction::onOutcome(
+         this->database->sqlDatabase(),
+         [this, primaryKey]() {
+            auto confirmedRowVersion = this->confirmedRowVersions.find(primaryKey);
+            if (confirmedRowVersion != this->confirmedRowVersions.end()) {
+               ++confirmedRowVersion.value();
+            }
+            return;
+         },
+         [this, primaryKey]() {
+            auto rowVersion = this->rowVersions.find(primaryKey);
+            if (rowVersion != this->rowVersions.end()) {
+               --rowVersion.value();
+            }
+            return;
+         }
+      );
+      return;
+   }
 
-         //
-         // Bind the values
-         //
-         BtSqlQuery sqlQuery{connection};
-         sqlQuery.prepare(queryString);
-         QVariant propertyBindValue{object.property(*propertyName)};
-         // It's a coding error if the property we are trying to read from does not exist
-         Q_ASSERT(propertyBindValue.isValid());
-         auto fieldDefn = std::find_if(
-            this->primaryTable.tableFields.begin(),
-            this->primaryTable.tableFields.end(),
-            [propertyName](TableField const & fd){return propertyName == fd.propertyName;}
-         );
+   /**
+    * \brief Call when handing off a write of an object to the \c DbWriter.  We assume the write will succeed, so that
+    *        the next write to the object (which might also get queued before this one is done) expects the right row
+    *        version, but we don't yet count it as confirmed.
+    */
+   void recordQueuedWrite(int const primaryKey) {
+      auto rowVersion = this->rowVersions.find(primaryKey);
+      if (rowVersion != this->rowVersions.end()) {
+         ++rowVersion.value();
+      }
+      return;
+   }
 
-         // It's a coding error if we're trying to update a property that's not in the field definitions
-         Q_ASSERT(fieldDefn != this->primaryTable.tableFields.end());
+   /**
+    * \brief Call (on the \c ObjectStore's thread) once a write queued with \c recordQueuedWrite has succeeded
+    *
+    * \param newRowVersion The row version the object has in the DB after the write
+    */
+   void confirmQueuedWrite(int const primaryKey, int const newRowVersion) {
+      auto confirmedRowVersion = this->confirmedRowVersions.find(primaryKey);
+      if (confirmedRowVersion == this->confirmedRowVersions.end()) {
+         // Object was deleted (or re-read) in the meantime, so there's nothing to do
+         return;
+      }
+      confirmedRowVersion.value() = std::max(confirmedRowVersion.value(), newRowVersion);
+      int & rowVersion = this->rowVersions[primaryKey];
+      rowVersion = std::max(rowVersion, confirmedRowVersion.value());
+      return;
+   }
 
-         // Fix-up the QVariant if needed, including converting enums to strings
-         this->unwrapAndMapAsNeeded(this->primaryTable, *fieldDefn, propertyBindValue);
+   /**
+    * \brief Set (or, if \c rowVersion is 0, forget) both the optimistic and the confirmed row versions of an object.
+    *        Call whenever we have just read the object from, or written it to, the DB.
+    */
+   void setRowVersion(int const primaryKey, int const rowVersion) {
+      if (rowVersion == 0) {
+         this->rowVersions.remove(primaryKey);
+         this->confirmedRowVersions.remove(primaryKey);
+      } else {
+         this->rowVersions.insert(primaryKey, rowVersion);
+         this->confirmedRowVersions.insert(primaryKey, rowVersion);
+      }
+      return;
+   }
 
-         if (std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn->valueDecoder)) {
-            //
-            // If the columns if a foreign key and the caller is setting it to a non-positive value then we actually
-            // need to store NULL in the DB.  (In the code we store foreign key IDs as ints, and use -1 to mean null.
-            // In the DB we need to store NULL explicitly because, if we try to store -1, we'll get a foreign key
-            // constraint violation as the DB is unable to find a row in the related table with primary key -1.)
+   /**
+    * \brief Called when a write to \c objectStore was rejected because someone else changed the row first.  Can be
+    *        called from any thread (including the \c DbWriter one).  Because we might be in the middle of a setter, or
+    *        a transaction, we don't re-read the row straight away, but rather queue this on the \c ObjectStore's thread.
+    */
+   void handleWriteConflict(ObjectStore & objectStore, QString const & description, int const primaryKey) {
+      QMetaObject::invokeMethod(
+         &objectStore,
+         [this, &objectStore, description, primaryKey]() {
             //
-            // Firstly, we assert it's a coding error if we've created a foreign key column that's not an int.  For the
-            // moment at least, we don't support other types of primary/foreign key.
+            // Any queued writes we were counting on have not all happened, so we go back to the last row version we
+            // know the DB had.  Otherwise, if the optimistic version happened to match what's now in the DB,
+            // refreshFromDb() would think we were up-to-date and we'd be left with our (rejected) local changes.
             //
-            Q_ASSERT(ObjectStore::FieldType::Int == fieldDefn->fieldType);
-            if (propertyBindValue.toInt() <= 0) {
-               qDebug() << Q_FUNC_INFO << "Treating" << propertyBindValue << "foreign key value as NULL";
-               propertyBindValue = QVariant{QMetaType{QMetaType::Int}};
+            auto confirmedRowVersion = this->confirmedRowVersions.constFind(primaryKey);
+            if (confirmedRowVersion != this->confirmedRowVersions.cend()) {
+               this->rowVersions.insert(primaryKey, confirmedRowVersion.value());
             }
-         }
-         sqlQuery.bindValue(QString{":%1"}.arg(*columnToUpdateInDb), propertyBindValue);
-         sqlQuery.bindValue(QString{":%1"}.arg(*primaryKeyColumn), primaryKey);
-         qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+            objectStore.refreshFromDb(primaryKey);
+            DbChangeNotifier::instance().reportConflict(description);
+         },
+         Qt::QueuedConnection
+      );
+      return;
+   }
 
+   /**
+    * \brief Update the specified property on an object
+    *
+    *        NB: Caller is responsible for handling transactions, including rolling back if we do not succeed
+    */
+   WriteResult updatePropertyInDb(QSqlDatabase & connection,
+                                  QObject const & object,
+                                  BtStringConst const & propertyName) {
+      //
+      // First check whether this is a simple property.  (If not we look for it in the ones we store in junction
+      // tables.)
+      //
+      TableField const * matchingFieldDefn = this->findSimpleProperty(propertyName);
+      if (matchingFieldDefn) {
          //
-         // Run the query
+         // We're updating a simple property
          //
-         if (!sqlQuery.exec()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-            return false;
+         PreparedWrite const preparedWrite = this->prepareSimplePropertyUpdate(object, *matchingFieldDefn);
+         qCDebug(logDb) <<
+            Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
+            "with database query" << preparedWrite.queryString;
+         // Normally leave the next debug output commented, as it can generate a lot of logging.  But it's useful to
+         // uncomment if you're seeing a lot of DB updates and the cause is not clear.
+//         qCDebug(logDb).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+         WriteResult const writeResult = execPreparedWrite(connection, preparedWrite);
+         if (writeResult != WriteResult::Succeeded) {
+            return writeResult;
          }
       } else {
          //
@@ -1151,23 +1518,33 @@ public:
             Q_ASSERT(false);
          }
 
+         //
+         // The change is not in the primary table row, but it's still a change to the object, so we bump (and check)
+         // the row version.
+         //
+         QVariant const primaryKey{this->getPrimaryKey(object)};
+         WriteResult const writeResult = execPreparedWrite(connection, this->prepareRowVersionUpdate(primaryKey));
+         if (writeResult != WriteResult::Succeeded) {
+            return writeResult;
+         }
+
          //
          // As elsewhere, the simplest way to update a junction table is to blat any rows relating to the current object
          // and then write out data based on the current property values.
          //
-         qDebug() <<
+         qCDebug(logDb) <<
             Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
             "in junction table" << matchingJunctionTableDefinitionDefn->tableName;
          if (!deleteFromJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, primaryKey, connection)) {
-            return false;
+            return WriteResult::Failed;
          }
          if (!insertIntoJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, object, primaryKey, connection)) {
-            return false;
+            return WriteResult::Failed;
          }
       }
 
       // If we made it this far then everything worked
-      return true;
+      return WriteResult::Succeeded;
    }
 
    /**
@@ -1206,11 +1583,11 @@ public:
       this->appendColumNames(queryStringAsStream, writePrimaryKey, true);
       queryStringAsStream << ");";
 
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Inserting" << object.metaObject()->className() << "main table row with database query " <<
          queryString;
       // Uncomment the following to track down errors where we're trying to insert an object to the database twice
-//      qDebug().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
+//      qCDebug(logDb).noquote() << Q_FUNC_INFO << Logging::getStackTrace();
 
       //
       // Bind the values
@@ -1222,7 +1599,7 @@ public:
 
          QVariant bindValue{object.property(*fieldDefn.propertyName)};
          // Uncomment the following line if the assert below is firing
-         qDebug() << Q_FUNC_INFO << fieldDefn.propertyName << ":" << bindValue;
+         qCDebug(logDb) << Q_FUNC_INFO << fieldDefn.propertyName << ":" << bindValue;
 
          // It's a coding error if the property we are trying to read from does not exist
          Q_ASSERT(bindValue.isValid());
@@ -1240,7 +1617,7 @@ public:
          sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
       }
 
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      qCDebug(logDb).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
       //
       // Run the query
@@ -1301,7 +1678,7 @@ public:
          }
       }
 
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << object.metaObject()->className() << "#" << primaryKeyInDb << "inserted in database using" <<
          queryString;
 
@@ -1319,49 +1696,401 @@ public:
       return primaryKeyInDb;
    }
 
-   char const * const m_className;
-   ObjectStore::State m_state;
-   TypeLookup const & typeLookup;
-   TableDefinition const & primaryTable;
-   JunctionTableDefinitions const & junctionTables;
-   QHash<int, std::shared_ptr<QObject> > allObjects;
-   Database * database;
-};
-
-QString ObjectStore::getDisplayName(ObjectStore::FieldType const fieldType) {
-   switch (fieldType) {
-      case ObjectStore::FieldType::Bool  : return "ObjectStore::FieldType::Bool"  ;
-      case ObjectStore::FieldType::Int   : return "ObjectStore::FieldType::Int"   ;
-      case ObjectStore::FieldType::UInt  : return "ObjectStore::FieldType::UInt"  ;
-      case ObjectStore::FieldType::Double: return "ObjectStore::FieldType::Double";
-      case ObjectStore::FieldType::String: return "ObjectStore::FieldType::String";
-      case ObjectStore::FieldType::Date  : return "ObjectStore::FieldType::Date"  ;
-      case ObjectStore::FieldType::Enum  : return "ObjectStore::FieldType::Enum"  ;
-      case ObjectStore::FieldType::Unit  : return "ObjectStore::FieldType::Unit"  ;
+   /**
+    * \brief The query to read rows from the primary table, optionally restricted by \c whereClause.  As well as the
+    *        mapped columns (in the order of \c primaryTable.tableFields), this reads the row version.
+    */
+   QString selectRowsQueryString(QString const & whereClause = QString{}) {
+      //
+      // We specify the column names rather than just do SELECT * because it's small extra effort and will give us an
+      // early error if an invalid column is specified.
+      //
+      QString queryString{"SELECT "};
+      QTextStream queryStringAsStream{&queryString};
+      this->appendColumNames(queryStringAsStream, true, false);
+      queryStringAsStream << ", " << rowVersionColumn << "\n FROM " << this->primaryTable.tableName;
+      if (!whereClause.isEmpty()) {
+         queryStringAsStream << " WHERE " << whereClause;
+      }
+      queryStringAsStream << ";";
+      return queryString;
    }
-   Q_UNREACHABLE();
-}
 
-ObjectStore::ObjectStore(char const *             const   className,
-                         TypeLookup               const & typeLookup,
-                         TableDefinition          const & primaryTable,
-                         JunctionTableDefinitions const & junctionTables) :
-   pimpl{ std::make_unique<impl>(className, typeLookup, primaryTable, junctionTables) } {
-   qDebug() << Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
-   // We have seen a circumstance where primaryTable.tableName is null, which shouldn't be possible.  This is some
-   // diagnostic to try to find out why.
-   if (this->pimpl->primaryTable.tableName.isNull()) {
-      qCritical().noquote() << Q_FUNC_INFO << "Primary table without name.  Call stack is:" << Logging::getStackTrace();
+   /**
+    * \brief Resolve each column's position in the results of a \c selectRowsQueryString query once, up front, rather
+    *        than looking it up by name for every field of every row.  (We listed the columns ourselves, so in practice
+    *        the ordinals are just 0, 1, 2, ... but it costs nothing to ask.)
+    *
+    * \param columnIndexes Set to the position of the column for each entry of \c columnDecoders
+    * \param rowVersionIndex Set to the position of the row version column
+    *
+    * \return \c false if any column is missing from the results
+    */
+   bool resolveColumnIndexes(BtSqlQuery const & sqlQuery, std::vector<int> & columnIndexes, int & rowVersionIndex) {
+      this->initColumnDecoders();
+      QSqlRecord const resultRecord = sqlQuery.record();
+      columnIndexes.clear();
+      columnIndexes.reserve(this->columnDecoders.size());
+      for (auto const & columnDecoder : this->columnDecoders) {
+         int const columnIndex = resultRecord.indexOf(*columnDecoder.fieldDefn->columnName);
+         if (columnIndex < 0) {
+            qCritical() <<
+               Q_FUNC_INFO << "Column" << columnDecoder.fieldDefn->columnName << "missing from results of query" <<
+               sqlQuery.lastQuery();
+            return false;
+         }
+         columnIndexes.push_back(columnIndex);
+      }
+      rowVersionIndex = resultRecord.indexOf(rowVersionColumn);
+      if (rowVersionIndex < 0) {
+         qCritical() << Q_FUNC_INFO << "Row version missing from results of query" << sqlQuery.lastQuery();
+         return false;
+      }
+      return true;
    }
-   return;
-}
+
+   /**
+    * \brief The columns, in order, of a \c selectRowsQueryString query, which is also the order in which we write them
+    *        in a snapshot.  Stored in the snapshot so that we can tell if it was written for a different table layout.
+    */
+   QStringList snapshotColumnNames() {
+      this->initColumnDecoders();
+      QStringList columnNames;
+      columnNames.reserve(static_cast<qsizetype>(this->columnDecoders.size()) + 1);
+      for (auto const & columnDecoder : this->columnDecoders) {
+         columnNames.append(*columnDecoder.fieldDefn->columnName);
+      }
+      columnNames.append(rowVersionColumn);
+      return columnNames;
+   }
+
+   /**
+    * \brief Read all the fields of the current row of a \c selectRowsQueryString query (or of a snapshot -- see
+    *        \c SnapshotRow) into \c namedParameterBundle
+    *
+    *        By convention, the primary key should be listed as the first field.  NB: For now we're assuming that the
+    *        primary key is always an integer, but it would not be enormous work to allow a wider range of types.
+    *
+    * \param row Either \c BtSqlQuery or \c SnapshotRow
+    *
+    * \return the primary key of the row
+    */
+   template<class RowSource>
+   int readRow(RowSource const & row,
+               std::vector<int> const & columnIndexes,
+               NamedParameterBundle & namedParameterBundle) {
+      int primaryKey = -1;
+      bool readPrimaryKey = false;
+      for (auto const & columnDecoder : this->columnDecoders) {
+         QVariant fieldValue = row.value(columnIndexes[columnDecoder.ordinal]);
+         //qCDebug(logDb) <<
+         //   Q_FUNC_INFO << "Reading col" << columnDecoder.fieldDefn->columnName << "(=" << fieldValue <<
+         //   ") into property" << columnDecoder.fieldDefn->propertyName;
+         if (!fieldValue.isValid()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error reading column " << columnDecoder.fieldDefn->columnName << " (" <<
+               fieldValue.toString() << ") from database table " << this->primaryTable.tableName <<
+               ". Error message: " << lastErrorText(row);
+            break;
+         }
+
+         // Fix-up the QVariant if needed, including converting enum string representation to int
+         this->wrapAndUnmapAsNeeded(this->primaryTable, columnDecoder, fieldValue);
+
+         if (!readPrimaryKey) {
+            readPrimaryKey = true;
+            primaryKey = fieldValue.toInt();
+         }
+
+         namedParameterBundle.insert(columnDecoder.ordinal, std::move(fieldValue));
+      }
+      return primaryKey;
+   }
+
+   /**
+    * \brief Load the data from the junction tables into cached objects.  This, pretty much by definition, isn't needed
+    *        for the object's constructor, so we're OK to pull it out separately.  Otherwise we'd have to do a LEFT JOIN
+    *        for each junction table in the primary table query.  Since we're caching everything in memory, and we're
+    *        not overly worried about optimising every single SQL query (because the amount of data in the DB is not
+    *        enormous), we prefer the simplicity of separate queries.
+    *
+    * \param connection
+    * \param onlyPrimaryKey If set, we only load data for this one object (and, where it has no junction table rows,
+    *                       set the relevant properties to "none").  Otherwise, we load data for all cached objects.
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool loadJunctionTables(QSqlDatabase & connection, std::optional<int> const onlyPrimaryKey = std::nullopt) {
+      BtSqlQuery sqlQuery{connection};
+      for (auto const & junctionTable : this->junctionTables) {
+         qCDebug(logDb) <<
+            Q_FUNC_INFO << "Reading junction table " << junctionTable.tableName << " into " <<
+            GetJunctionTableDefinitionPropertyName(junctionTable);
+
+         //
+         // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
+         // column if one is specified.
+         //
+         QString const thisPrimaryKeyBindName =
+            QString{":"} + *GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable);
+         QString queryString{"SELECT "};
+         QTextStream queryStringAsStream{&queryString};
+         queryStringAsStream <<
+            GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
+            GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
+            " FROM " << junctionTable.tableName;
+         if (onlyPrimaryKey) {
+            queryStringAsStream <<
+               " WHERE " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << " = " <<
+               thisPrimaryKeyBindName;
+         }
+         queryStringAsStream <<
+            " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
+         if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
+            queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
+         } else {
+            queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+         }
+         queryStringAsStream << ";";
+
+         sqlQuery.prepare(queryString);
+         if (onlyPrimaryKey) {
+            sqlQuery.bindValue(thisPrimaryKeyBindName, *onlyPrimaryKey);
+         }
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+
+         qCDebug(logDb) << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+
+         //
+         // The simplest way to process the data is first to build the ID-to-ordered-list-of-IDs map in memory, then
+         // loop through this to pass the data to the relevant objects.
+         //
+         int previousPrimaryKey = -1;
+         QMap< int, QVector<int> > thisToOtherKeys;
+         if (onlyPrimaryKey) {
+            // We need to clear the property if there are no rows for the object
+            thisToOtherKeys.insert(*onlyPrimaryKey, QVector<int>{});
+         }
+         while (sqlQuery.next()) {
+            int thisPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable)).toInt();
+            int otherPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)).toInt();
+            // Usually keep the next line commented out otherwise it generates a lot of lines in the logs
+//            qCDebug(logDb) << Q_FUNC_INFO << "Interim store of" << thisPrimaryKey << "<->" << otherPrimaryKey;
+
+            if (thisPrimaryKey != previousPrimaryKey) {
+               if (!thisToOtherKeys.contains(thisPrimaryKey)) {
+                  thisToOtherKeys.insert(thisPrimaryKey, QVector<int>{});
+               }
+               previousPrimaryKey = thisPrimaryKey;
+            }
+            Q_ASSERT(thisToOtherKeys.contains(thisPrimaryKey));
+            thisToOtherKeys[thisPrimaryKey].append(otherPrimaryKey);
+         }
+
+         for (auto currentMapping = thisToOtherKeys.cbegin();
+              currentMapping != thisToOtherKeys.cend();
+              ++currentMapping) {
+            //
+            // It's probably a coding error somewhere if there's an associative entry for an object that doesn't exist,
+            // but we can recover by ignoring the associative entry
+            //
+            if (!this->allObjects.contains(currentMapping.key())) {
+               qCritical() <<
+                  Q_FUNC_INFO << "Ignoring record in table " << junctionTable.tableName <<
+                  " for non-existent object with primary key " << currentMapping.key();
+               continue;
+            }
+
+            auto currentObject = this->allObjects.value(currentMapping.key());
+
+            // We assert that we could not have created a mapping without at least one entry, unless it's the one we
+            // were asked to refresh
+            Q_ASSERT(currentMapping.value().size() > 0 || onlyPrimaryKey);
+
+            //
+            // Normally we'd pass a list of all the "other" keys for each "this" object, but if we've been told to
+            // assume there is at most one "other" per "this", then we'll pass just the first one we get back for each
+            // "this".  (As elsewhere, -1 means "none".)
+            //
+            bool success = false;
+            if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
+               int const otherKey = currentMapping.value().isEmpty() ? -1 : currentMapping.value().first();
+               qCDebug(logDb) <<
+                  Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
+                  GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << otherKey;
+               success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable), otherKey);
+            } else {
+               //
+               // The setProperty function always takes a QVariant, so we need to create one from the QList<QVariant>
+               // we have.  However, we need to be careful here.  There are several ways to get the call to setProperty
+               // wrong at runtime, which gives you a "false" return code but no diagnostics or log of why the call
+               // failed.
+               //
+               // In particular, we can't just shove a QList<QVariant> (ie otherKeys) inside a QVariant, because
+               // passing this to setProperty() (or equivalent calls via the metaObject) will cause Qt to attempt (and
+               // fail) to access a setter that takes QList<QVariant>.  We need a QVector<int> (ie what the setter
+               // expects) wrapped in a QVariant.
+               //
+               // To add to the challenge, despite QVariant having a huge number of constructors, none of them will
+               // accept QVector<int>, so, instead, you have to use the static function QVariant::fromValue to create a
+               // QVariant wrapper around QVector<int>.
+               //
+               QVariant wrappedConvertedOtherKeys = QVariant::fromValue(currentMapping.value());
+               qCDebug(logDb) <<
+                  Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
+                  GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << currentMapping.value() << "(" <<
+                  wrappedConvertedOtherKeys << ")";
+               success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
+                                                    wrappedConvertedOtherKeys);
+            }
+            if (!success) {
+               // This is a coding error - eg the property doesn't have a WRITE member function or it doesn't take the
+               // type of argument we supplied inside a QVariant.
+               qCritical() <<
+                  Q_FUNC_INFO << "Unable to set property" << GetJunctionTableDefinitionPropertyName(junctionTable) <<
+                  "on" << currentObject->metaObject()->className();
+               Q_ASSERT(false); // Stop here on a debug build
+               return false;    // Continue but abort the transaction on a non-debug build
+            }
+         }
+      }
+      return true;
+   }
+
+   /**
+    * \brief Update all the stored data for an object that is already in the database
+    *
+    *        NB: Caller is responsible for handling transactions, including rolling back if we do not succeed
+    */
+   WriteResult updateObjectInDb(QSqlDatabase & connection, QObject const & object) {
+      //
+      // Construct the SQL, which will be of the form
+      //
+      //    UPDATE tablename
+      //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ..., row_version = row_version + 1
+      //    WHERE primaryKeyColumn = :primaryKeyColumn AND row_version = :row_version;
+      //
+      // .:TBD:. A small optimisation might be to construct this just once rather than every time this function is
+      //         called
+      //
+      PreparedWrite preparedWrite{"UPDATE ", {}};
+      QTextStream queryStringAsStream{&preparedWrite.queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+
+      QVariant const primaryKey{this->getPrimaryKey(object)};
+
+      bool skippedPrimaryKey = false;
+      for (auto const & fieldDefn: this->primaryTable.tableFields) {
+         if (!skippedPrimaryKey) {
+            skippedPrimaryKey = true;
+            continue;
+         }
+         queryStringAsStream << " " << fieldDefn.columnName << " = :" << fieldDefn.columnName << ", ";
+
+         //
+         // Bind the values.  Note that, because we're using bind names, it doesn't matter that the order in which we
+         // do the binds is different than the order in which the fields appear in the query.
+         //
+         QVariant bindValue{object.property(*fieldDefn.propertyName)};
+
+         // Fix-up the QVariant if needed, including converting enums to strings
+         this->unwrapAndMapAsNeeded(this->primaryTable, fieldDefn, bindValue);
+
+         preparedWrite.bindValues.append({QString{":"} + *fieldDefn.columnName, bindValue});
+      }
+      this->appendRowVersionUpdate(queryStringAsStream, preparedWrite, primaryKey);
+
+      //
+      // Run the query
+      //
+      WriteResult const writeResult = execPreparedWrite(connection, preparedWrite);
+      if (writeResult != WriteResult::Succeeded) {
+         return writeResult;
+      }
+
+      //
+      // Now update data in the junction tables
+      //
+      for (auto const & junctionTable : this->junctionTables) {
+         qCDebug(logDb) <<
+            Q_FUNC_INFO << "Updating property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
+            " in junction table " << junctionTable.tableName;
+
+         //
+         // The simplest thing to do with each junction table is to blat any rows relating to the current object and
+         // then write out data based on the current property values.  This may often mean we're deleting rows and
+         // rewriting them but, for the small quantity of data we're talking about, it doesn't seem worth the
+         // complexity of optimising (eg read what's in the DB, compare with what's in the object property, work out
+         // what deletes, inserts and updates are needed to sync them, etc.
+         //
+         if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
+            return WriteResult::Failed;
+         }
+         if (!insertIntoJunctionTableDefinition(junctionTable, object, primaryKey, connection)) {
+            return WriteResult::Failed;
+         }
+      }
+
+      return WriteResult::Succeeded;
+   }
+
+   char const * const m_className;
+   ObjectStore::State m_state;
+   TypeLookup const & typeLookup;
+   TableDefinition const & primaryTable;
+   JunctionTableDefinitions const & junctionTables;
+   QHash<int, std::shared_ptr<QObject> > allObjects;
+   Database * database;
+   //! One entry per field in \c primaryTable.tableFields, in the same order.  Set up by \c initColumnDecoders.
+   std::vector<ColumnDecoder> columnDecoders;
+   //! Shared by all the bundles \c loadAll creates.  Set up by \c initColumnDecoders.
+   std::shared_ptr<NamedParameterBundle::Layout const> rowLayout;
+   //! Row version (see \c rowVersionColumn) of each object, as of when we last read or wrote it, including writes
+   //! that are still queued on the \c DbWriter.  This is what the next write to the object expects to find in the DB.
+   QHash<int, int> rowVersions;
+   //! Row version of each object as last confirmed by the DB (ie read, or written by a write that has completed).
+   //! Only differs from \c rowVersions whilst writes to the object are queued on the \c DbWriter.
+   QHash<int, int> confirmedRowVersions;
+};
+
+QString ObjectStore::getDisplayName(ObjectStore::FieldType const fieldType) {
+   switch (fieldType) {
+      case ObjectStore::FieldType::Bool  : return "ObjectStore::FieldType::Bool"  ;
+      case ObjectStore::FieldType::Int   : return "ObjectStore::FieldType::Int"   ;
+      case ObjectStore::FieldType::UInt  : return "ObjectStore::FieldType::UInt"  ;
+      case ObjectStore::FieldType::Double: return "ObjectStore::FieldType::Double";
+      case ObjectStore::FieldType::String: return "ObjectStore::FieldType::String";
+      case ObjectStore::FieldType::Date  : return "ObjectStore::FieldType::Date"  ;
+      case ObjectStore::FieldType::Enum  : return "ObjectStore::FieldType::Enum"  ;
+      case ObjectStore::FieldType::Unit  : return "ObjectStore::FieldType::Unit"  ;
+   }
+   Q_UNREACHABLE();
+}
+
+ObjectStore::ObjectStore(char const *             const   className,
+                         TypeLookup               const & typeLookup,
+                         TableDefinition          const & primaryTable,
+                         JunctionTableDefinitions const & junctionTables) :
+   pimpl{ std::make_unique<impl>(className, typeLookup, primaryTable, junctionTables) } {
+   qCDebug(logDb) << Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
+   // We have seen a circumstance where primaryTable.tableName is null, which shouldn't be possible.  This is some
+   // diagnostic to try to find out why.
+   if (this->pimpl->primaryTable.tableName.isNull()) {
+      qCritical().noquote() << Q_FUNC_INFO << "Primary table without name.  Call stack is:" << Logging::getStackTrace();
+   }
+   return;
+}
 
 // See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
 // header file)
 ObjectStore::~ObjectStore() {
    // Normally we try to avoid logging things here, as it's possible that the objects used in Logging.cpp have already
    // been destroyed, but it can be useful to turn this on when debugging ObjectStore problems.
-   //qDebug() <<
+   //qCDebug(logDb) <<
    //   Q_FUNC_INFO << "Destruct of object store for primary table" << this->pimpl->primaryTable.tableName <<
    //   "(containing" << this->pimpl->allObjects.size() << "objects)";
    return;
@@ -1371,6 +2100,14 @@ QString ObjectStore::name() const {
    return this->pimpl->m_className;
 }
 
+QString ObjectStore::tableName() const {
+   return *this->pimpl->primaryTable.tableName;
+}
+
+bool ObjectStore::isApplyingRemoteChanges() {
+   return applyingRemoteChangesDepth > 0;
+}
+
 ObjectStore::State ObjectStore::state() const {
    return this->pimpl->m_state;
 }
@@ -1378,7 +2115,7 @@ ObjectStore::State ObjectStore::state() const {
 void ObjectStore::logDiagnostics() const {
    for (int key : this->pimpl->allObjects.keys()) {
       std::shared_ptr<QObject> object = this->pimpl->allObjects.value(key);
-      qDebug() <<
+      qCDebug(logDb) <<
          Q_FUNC_INFO << "Object @" << static_cast<void *>(object.get()) << "stored as #" << key << "has key" <<
          this->pimpl->getPrimaryKey(*object) << "and shared pointer use count" << object.use_count();
    }
@@ -1395,7 +2132,7 @@ bool ObjectStore::createTables(Database & database, QSqlDatabase & connection) c
    // Note too, that we don't care about default values as we assume we will always provide values for all columns when
    // we do an insert.  (Suitable default values for object fields are set in the object's constructor.)
    //
-   if (!createTableWithoutForeignKeys(database, connection, this->pimpl->primaryTable)) {
+   if (!createTableWithoutForeignKeys(database, connection, this->pimpl->primaryTable, true)) {
       return false;
    }
 
@@ -1403,7 +2140,7 @@ bool ObjectStore::createTables(Database & database, QSqlDatabase & connection) c
    // Now create the junction tables
    //
    for (auto const & junctionTable : this->pimpl->junctionTables) {
-      if (!createTableWithoutForeignKeys(database, connection, junctionTable)) {
+      if (!createTableWithoutForeignKeys(database, connection, junctionTable, false)) {
          return false;
       }
    }
@@ -1416,12 +2153,14 @@ bool ObjectStore::createTables(Database & database, QSqlDatabase & connection) c
 bool ObjectStore::addTableConstraints(Database & database, QSqlDatabase & connection) const {
    // This is all pretty much the same structure as createTables(), so I won't repeat all the comments here
 
-   if (!addForeignKeysToTable(database, connection, this->pimpl->primaryTable)) {
+   if (!addForeignKeysToTable(database, connection, this->pimpl->primaryTable) ||
+       !addIndexesToTable(connection, this->pimpl->primaryTable)) {
       return false;
    }
 
    for (auto const & junctionTable : this->pimpl->junctionTables) {
-      if (!addForeignKeysToTable(database, connection, junctionTable)) {
+      if (!addForeignKeysToTable(database, connection, junctionTable) ||
+          !addIndexesToTable(connection, junctionTable)) {
          return false;
       }
    }
@@ -1440,6 +2179,15 @@ void ObjectStore::loadAll(Database * database) {
       this->pimpl->database = &Database::instance();
    }
 
+   //
+   // If the DB hasn't changed since the last clean shutdown, we can build everything from the snapshot written then,
+   // rather than reading it all from the DB.  (See StartupSnapshot for more details.)
+   //
+   QByteArray const snapshotData = StartupSnapshot::instance().tableData(*this->pimpl->primaryTable.tableName);
+   if (!snapshotData.isEmpty() && this->loadFromSnapshot(snapshotData, this->pimpl->database)) {
+      return;
+   }
+
    // Start transaction
    // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
    //
@@ -1456,13 +2204,9 @@ void ObjectStore::loadAll(Database * database) {
    // testing with SQLite, the returned QSqlRecord object for an index one beyond the end of he table still gave a
    // false return to QSqlRecord::isEmpty() but then returned invalid record values.)
    //
-   // So, instead, we create the appropriate SELECT query from scratch.  We specify the column names rather than just
-   // do SELECT * because it's small extra effort and will give us an early error if an invalid column is specified.
+   // So, instead, we create the appropriate SELECT query from scratch.
    //
-   QString queryString{"SELECT "};
-   QTextStream queryStringAsStream{&queryString};
-   this->pimpl->appendColumNames(queryStringAsStream, true, false);
-   queryStringAsStream << "\n FROM " << this->pimpl->primaryTable.tableName << ";";
+   QString const queryString = this->pimpl->selectRowsQueryString();
    BtSqlQuery sqlQuery{connection};
    sqlQuery.prepare(queryString);
    if (!sqlQuery.exec()) {
@@ -1471,10 +2215,16 @@ void ObjectStore::loadAll(Database * database) {
       return;
    }
 
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Reading main table rows from" << this->pimpl->primaryTable.tableName <<
       "database table using query " << queryString;
 
+   std::vector<int> columnIndexes;
+   int rowVersionIndex = -1;
+   if (!this->pimpl->resolveColumnIndexes(sqlQuery, columnIndexes, rowVersionIndex)) {
+      return;
+   }
+
    while (sqlQuery.next()) {
       //
       // We want to pull all the fields for the current row from the database and use them to construct a new
@@ -1507,48 +2257,11 @@ void ObjectStore::loadAll(Database * database) {
       // object class to enforce mandatory construction parameters with this approach.
       //
       // Method (ii) is therefore our preferred approach.  We use NamedParameterBundle, which is a simple extension of
-      // QHash.
-      //
-      NamedParameterBundle namedParameterBundle;
-      int primaryKey = -1;
-
-      //
-      // Populate all the fields
-      // By convention, the primary key should be listed as the first field
+      // QHash.  Because every row has the same set of parameters, all the bundles share one layout, so that filling in
+      // a row's values is just a series of writes by ordinal.
       //
-      // NB: For now we're assuming that the primary key is always an integer, but it would not be enormous work to
-      //     allow a wider range of types.
-      //
-      bool readPrimaryKey = false;
-      for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
-         QVariant fieldValue = sqlQuery.value(*fieldDefn.columnName);
-         //qDebug() <<
-         //   Q_FUNC_INFO << "Reading col" << fieldDefn.columnName << "(=" << fieldValue << ") into property" <<
-         //   fieldDefn.propertyName;
-         if (!fieldValue.isValid()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error reading column " << fieldDefn.columnName << " (" << fieldValue.toString() <<
-               ") from database table " << this->pimpl->primaryTable.tableName << ". SQL error message: " <<
-               sqlQuery.lastError().text();
-            break;
-         }
-
-         // Fix-up the QVariant if needed, including converting enum string representation to int
-         this->pimpl->wrapAndUnmapAsNeeded(this->pimpl->primaryTable, fieldDefn, fieldValue);
-
-         // It's a coding error if we got the same parameter twice
-         Q_ASSERT(!namedParameterBundle.contains(fieldDefn.propertyName));
-
-         namedParameterBundle.insert(fieldDefn.propertyName, fieldValue);
-
-         // We assert that the insert always works!
-         Q_ASSERT(namedParameterBundle.contains(fieldDefn.propertyName));
-
-         if (!readPrimaryKey) {
-            readPrimaryKey = true;
-            primaryKey = fieldValue.toInt();
-         }
-      }
+      NamedParameterBundle namedParameterBundle{this->pimpl->rowLayout};
+      int const primaryKey = this->pimpl->readRow(sqlQuery, columnIndexes, namedParameterBundle);
 
       // Get a new object...
       auto object = this->createNewObject(namedParameterBundle);
@@ -1557,157 +2270,143 @@ void ObjectStore::loadAll(Database * database) {
       // It's a coding error if we have two objects with the same primary key
       Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
       this->pimpl->allObjects.insert(primaryKey, object);
+      this->pimpl->setRowVersion(primaryKey, sqlQuery.value(rowVersionIndex).toInt());
       // Normally leave this debug output commented, as it generates a lot of logging at start-up, but can be useful to
       // enable for debugging.
-//      qDebug() <<
+//      qCDebug(logDb) <<
 //         Q_FUNC_INFO << "Cached" << object->metaObject()->className() << "#" << primaryKey << "in" <<
 //         this->metaObject()->className();
    }
 
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Read" << this->pimpl->allObjects.size() << "entries from primary table" <<
       this->pimpl->primaryTable.tableName;
 
    //
-   // Now we load the data from the junction tables.  This, pretty much by definition, isn't needed for the object's
-   // constructor, so we're OK to pull it out separately.  Otherwise we'd have to do a LEFT JOIN for each junction
-   // table in the query above.  Since we're caching everything in memory, and we're not overly worried about
-   // optimising every single SQL query (because the amount of data in the DB is not enormous), we prefer the
-   // simplicity of separate queries.
+   // Now we load the data from the junction tables
    //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
-         Q_FUNC_INFO << "Reading junction table " << junctionTable.tableName << " into " <<
-         GetJunctionTableDefinitionPropertyName(junctionTable);
+   if (!this->pimpl->loadJunctionTables(connection)) {
+      return;
+   }
 
-      //
-      // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
-      // column if one is specified.
-      //
-      queryString = "SELECT ";
-      queryStringAsStream <<
-         GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
-         GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
-         " FROM " << junctionTable.tableName <<
-         " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
-      if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
-         queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
-      } else {
-         queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
-      }
-      queryStringAsStream << ";";
+   dbTransaction.commit();
 
-      sqlQuery.prepare(queryString);
-      if (!sqlQuery.exec()) {
-         qCritical() <<
-            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-         return;
-      }
+   qInfo() << Q_FUNC_INFO << "Read" << this->size() << "objects from DB table" << this->pimpl->primaryTable.tableName;
 
-      qDebug() << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+   // If we made it this far, everything must have loaded in OK (otherwise we'd have bailed out above).
+   this->pimpl->m_state = ObjectStore::State::InitialisedOk;
 
-      //
-      // The simplest way to process the data is first to build the ID-to-ordered-list-of-IDs map in memory, then loop
-      // through this to pass the data to the relevant objects.
-      //
-      int previousPrimaryKey = -1;
-      QMap< int, QVector<int> > thisToOtherKeys;
-      while (sqlQuery.next()) {
-         int thisPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable)).toInt();
-         int otherPrimaryKey = sqlQuery.value(*GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)).toInt();
-         // Usually keep the next line commented out otherwise it generates a lot of lines in the logs
-//         qDebug() << Q_FUNC_INFO << "Interim store of" << thisPrimaryKey << "<->" << otherPrimaryKey;
+   return;
+}
 
-         if (thisPrimaryKey != previousPrimaryKey) {
-            thisToOtherKeys.insert(thisPrimaryKey, QVector<int>{});
-            previousPrimaryKey = thisPrimaryKey;
-         }
-         Q_ASSERT(thisToOtherKeys.contains(thisPrimaryKey));
-         thisToOtherKeys[thisPrimaryKey].append(otherPrimaryKey);
-      }
+bool ObjectStore::loadFromSnapshot(QByteArray const & snapshotData, Database * database) {
+   this->pimpl->database = database ? database : &Database::instance();
+   QString const tableName{*this->pimpl->primaryTable.tableName};
 
-      for (auto currentMapping = thisToOtherKeys.cbegin();
-           currentMapping != thisToOtherKeys.cend();
-           ++currentMapping) {
-         //
-         // It's probably a coding error somewhere if there's an associative entry for an object that doesn't exist,
-         // but we can recover by ignoring the associative entry
-         //
-         if (!this->contains(currentMapping.key())) {
-            qCritical() <<
-               Q_FUNC_INFO << "Ignoring record in table " << junctionTable.tableName <<
-               " for non-existent object with primary key " << currentMapping.key();
-            continue;
-         }
+   QDataStream in{snapshotData};
+   in.setVersion(StartupSnapshot::dataStreamVersion);
 
-         auto currentObject = this->getById(currentMapping.key());
+   //
+   // The snapshot has to have been written with the same columns, in the same order, as we would read from the DB now.
+   // (The snapshot's fingerprint includes the program and schema versions, so this is belt-and-braces.)
+   //
+   QStringList columnNames;
+   qint32 numRows = 0;
+   in >> columnNames >> numRows;
+   if (in.status() != QDataStream::Ok || columnNames != this->pimpl->snapshotColumnNames()) {
+      qWarning() << Q_FUNC_INFO << "Ignoring snapshot for" << tableName << "as it does not match current columns";
+      return false;
+   }
 
-         // We assert that we could not have created a mapping without at least one entry
-         Q_ASSERT(currentMapping.value().size() > 0);
+   // Columns in the snapshot are in the order we want them, so, unlike for a DB query, there's nothing to look up
+   std::vector<int> columnIndexes(this->pimpl->columnDecoders.size());
+   std::iota(columnIndexes.begin(), columnIndexes.end(), 0);
+   int const rowVersionIndex = static_cast<int>(columnIndexes.size());
 
-         //
-         // Normally we'd pass a list of all the "other" keys for each "this" object, but if we've been told to assume
-         // there is at most one "other" per "this", then we'll pass just the first one we get back for each "this".
-         //
-         bool success = false;
-         if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
-            qDebug() <<
-               Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
-               GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << currentMapping.value().first();
-            success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
-                                                 currentMapping.value().first());
-         } else {
-            //
-            // The setProperty function always takes a QVariant, so we need to create one from the QList<QVariant> we
-            // have.  However, we need to be careful here.  There are several ways to get the call to setProperty wrong
-            // at runtime, which gives you a "false" return code but no diagnostics or log of why the call failed.
-            //
-            // In particular, we can't just shove a QList<QVariant> (ie otherKeys) inside a QVariant, because passing
-            // this to setProperty() (or equivalent calls via the metaObject) will cause Qt to attempt (and fail) to
-            // access a setter that takes QList<QVariant>.  We need a QVector<int> (ie what the setter expects) wrapped
-            // in a QVariant.
-            //
-            // To add to the challenge, despite QVariant having a huge number of constructors, none of them will accept
-            // QVector<int>, so, instead, you have to use the static function QVariant::fromValue to create a QVariant
-            // wrapper around QVector<int>.
-            //
-            QVariant wrappedConvertedOtherKeys = QVariant::fromValue(currentMapping.value());
-            qDebug() <<
-               Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentMapping.key() << ", " <<
-               GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << currentMapping.value() << "(" <<
-               wrappedConvertedOtherKeys << ")";
-            success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
-                                                 wrappedConvertedOtherKeys);
-         }
-         if (!success) {
-            // This is a coding error - eg the property doesn't have a WRITE member function or it doesn't take the
-            // type of argument we supplied inside a QVariant.
-            qCritical() <<
-               Q_FUNC_INFO << "Unable to set property" << GetJunctionTableDefinitionPropertyName(junctionTable) <<
-               "on" << currentObject->metaObject()->className();
-            Q_ASSERT(false); // Stop here on a debug build
-            return;          // Continue but abort the transaction on a non-debug build
-         }
+   //
+   // We build everything in local containers first so that, if the snapshot turns out to be truncated or otherwise
+   // corrupt part way through, we haven't left any half-loaded state behind.
+   //
+   decltype(this->pimpl->allObjects) allObjects;
+   decltype(this->pimpl->rowVersions) rowVersions;
+   allObjects.reserve(numRows);
+   rowVersions.reserve(numRows);
+   SnapshotRow snapshotRow;
+   snapshotRow.values.resize(rowVersionIndex + 1);
+   for (qint32 rowNumber = 0; rowNumber < numRows; ++rowNumber) {
+      for (QVariant & value : snapshotRow.values) {
+         in >> value;
+      }
+      if (in.status() != QDataStream::Ok) {
+         qWarning() << Q_FUNC_INFO << "Ignoring snapshot for" << tableName << "as unable to read row" << rowNumber;
+         return false;
+      }
 
-         // This is useful for debugging but I usually leave it commented out as it generates a lot of logging at
-         // start-up
-//         qDebug() <<
-//            Q_FUNC_INFO << "Set" <<
-//            (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY ? 1 : otherKeys.size()) <<
-//            GetJunctionTableDefinitionPropertyName(junctionTable).c_str() << "property for" <<
-//            currentObject->metaObject()->className() << "#" << currentKey;
+      // This is the same as in loadAll(), just with a different source for the column values
+      NamedParameterBundle namedParameterBundle{this->pimpl->rowLayout};
+      int const primaryKey = this->pimpl->readRow(snapshotRow, columnIndexes, namedParameterBundle);
+      Q_ASSERT(!allObjects.contains(primaryKey));
+      allObjects.insert(primaryKey, this->createNewObject(namedParameterBundle));
+      rowVersions.insert(primaryKey, snapshotRow.values.at(rowVersionIndex).toInt());
+   }
+
+   this->pimpl->allObjects.swap(allObjects);
+   this->pimpl->rowVersions.swap(rowVersions);
+   this->pimpl->confirmedRowVersions = this->pimpl->rowVersions;
 
+   //
+   // The snapshot only holds the primary table.  If we have junction tables (which, at the moment, no object store
+   // does), they still have to come from the DB.
+   //
+   if (!this->pimpl->junctionTables.empty()) {
+      QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+      if (!this->pimpl->loadJunctionTables(connection)) {
+         this->pimpl->m_state = ObjectStore::State::ErrorInitialising;
+         return true;
       }
    }
 
-   dbTransaction.commit();
+   qInfo() << Q_FUNC_INFO << "Read" << this->size() << "objects from snapshot of DB table" << tableName;
+   this->pimpl->m_state = ObjectStore::State::InitialisedOk;
+   return true;
+}
 
-   qInfo() << Q_FUNC_INFO << "Read" << this->size() << "objects from DB table" << this->pimpl->primaryTable.tableName;
+bool ObjectStore::writeSnapshot(QSqlDatabase & connection, QDataStream & out) const {
+   QString const queryString = this->pimpl->selectRowsQueryString();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   if (!sqlQuery.exec()) {
+      qCritical() <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return false;
+   }
 
-   // If we made it this far, everything must have loaded in OK (otherwise we'd have bailed out above).
-   this->pimpl->m_state = ObjectStore::State::InitialisedOk;
+   std::vector<int> columnIndexes;
+   int rowVersionIndex = -1;
+   if (!this->pimpl->resolveColumnIndexes(sqlQuery, columnIndexes, rowVersionIndex)) {
+      return false;
+   }
 
-   return;
+   //
+   // We store the raw column values, rather than, say, the properties of the cached objects, so that loading from the
+   // snapshot goes through exactly the same conversions as loading from the DB.  We don't know how many rows there are
+   // until we've read them all, so they go into a buffer first.
+   //
+   QByteArray rows;
+   QDataStream rowsStream{&rows, QIODevice::WriteOnly};
+   rowsStream.setVersion(out.version());
+   qint32 numRows = 0;
+   while (sqlQuery.next()) {
+      for (int const columnIndex : columnIndexes) {
+         rowsStream << sqlQuery.value(columnIndex);
+      }
+      rowsStream << sqlQuery.value(rowVersionIndex);
+      ++numRows;
+   }
+
+   out << this->pimpl->snapshotColumnNames() << numRows;
+   out.writeRawData(rows.constData(), static_cast<int>(rows.size()));
+   return rowsStream.status() == QDataStream::Ok && out.status() == QDataStream::Ok;
 }
 
 size_t ObjectStore::size() const {
@@ -1752,16 +2451,24 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
                                QString("Insert %1").arg(*this->pimpl->primaryTable.tableName)};
 
    int primaryKey = this->pimpl->insertObjectInDb(connection, *object, false);
+   DbChangeNotifier::publish(connection,
+                             DbChangeNotifier::Operation::Insert,
+                             *this->pimpl->primaryTable.tableName,
+                             primaryKey);
 
    //
    // Add the object to our list of all objects of this type (asserting that it should be impossible for an object with
-   // this ID to already exist in that list).
+   // this ID to already exist in that list).  New rows start at version 1 (courtesy of the column default).
    //
    Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
    this->pimpl->allObjects.insert(primaryKey, object);
+   this->pimpl->setRowVersion(primaryKey, 1);
 
    // Everything succeeded if we got this far so we can wrap up the transaction
    dbTransaction.commit();
+   ChangeJournal::instance().record(DbChangeNotifier::Operation::Insert,
+                                    *this->pimpl->primaryTable.tableName,
+                                    primaryKey);
 
    //
    // Now we tell the object what its primary key is.  Note that we must do this _after_ the database transaction is
@@ -1785,94 +2492,39 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
 }
 
 void ObjectStore::update(std::shared_ptr<QObject> object) {
-   // Start transaction
-   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database,
-                               connection,
-                               QString("Update %1").arg(*this->pimpl->primaryTable.tableName)};
-
-   //
-   // Construct the SQL, which will be of the form
-   //
-   //    UPDATE tablename
-   //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ...
-   //    WHERE primaryKeyColumn = :primaryKeyColumn;
-   //
-   // .:TBD:. A small optimisation might be to construct this just once rather than every time this function is called
-   //
-   QString queryString{"UPDATE "};
-   QTextStream queryStringAsStream{&queryString};
-   queryStringAsStream << this->pimpl->primaryTable.tableName << " SET ";
-
-   QString  const primaryKeyColumn {*this->pimpl->getPrimaryKeyColumn()};
-   QVariant const primaryKey       {this->pimpl->getPrimaryKey(*object)};
-
-   bool skippedPrimaryKey = false;
-   bool firstFieldOutput = false;
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      if (!skippedPrimaryKey) {
-         skippedPrimaryKey = true;
-      } else {
-         if (!firstFieldOutput) {
-            firstFieldOutput = true;
-         } else {
-            queryStringAsStream << ", ";
-         }
-         queryStringAsStream << " " << fieldDefn.columnName << " = :" << fieldDefn.columnName;
+   int const primaryKey = this->pimpl->getPrimaryKey(*object).toInt();
+   WriteResult writeResult;
+   {
+      // Start transaction
+      // (By the magic of RAII, this will abort if we leave this scope without calling dbTransaction.commit()
+      QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+      DbTransaction dbTransaction{*this->pimpl->database,
+                                  connection,
+                                  QString("Update %1").arg(*this->pimpl->primaryTable.tableName)};
+
+      writeResult = this->pimpl->updateObjectInDb(connection, *object);
+      if (writeResult == WriteResult::Succeeded) {
+         DbChangeNotifier::publish(connection,
+                                   DbChangeNotifier::Operation::Update,
+                                   *this->pimpl->primaryTable.tableName,
+                                   primaryKey);
+         dbTransaction.commit();
       }
    }
 
-   queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-
-   //
-   // Bind the values.  Note that, because we're using bind names, it doesn't matter that the order in which we do the
-   // binds is different than the order in which the fields appear in the query.
-   //
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      QVariant bindValue{object->property(*fieldDefn.propertyName)};
-
-      // Fix-up the QVariant if needed, including converting enums to strings
-      this->pimpl->unwrapAndMapAsNeeded(this->pimpl->primaryTable, fieldDefn, bindValue);
-
-      sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
-   }
-
-   //
-   // Run the query
-   //
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-      return;
-   }
-
-   //
-   // Now update data in the junction tables
-   //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
-         Q_FUNC_INFO << "Updating property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
-         " in junction table " << junctionTable.tableName;
-
-      //
-      // The simplest thing to do with each junction table is to blat any rows relating to the current object and then
-      // write out data based on the current property values.  This may often mean we're deleting rows and rewriting
-      // them but, for the small quantity of data we're talking about, it doesn't seem worth the complexity of
-      // optimising (eg read what's in the DB, compare with what's in the object property, work out what deletes,
-      // inserts and updates are needed to sync them, etc.
-      //
-      if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
-         return;
-      }
-      if (!insertIntoJunctionTableDefinition(junctionTable, *object, primaryKey, connection)) {
-         return;
-      }
+   if (writeResult == WriteResult::Conflict) {
+      this->pimpl->handleWriteConflict(
+         *this,
+         QString("Update %1 #%2").arg(*this->pimpl->primaryTable.tableName).arg(primaryKey),
+         primaryKey
+      );
+   } else if (writeResult == WriteResult::Succeeded) {
+      this->pimpl->recordWrite(primaryKey);
+      ChangeJournal::instance().record(DbChangeNotifier::Operation::Update,
+                                       *this->pimpl->primaryTable.tableName,
+                                       primaryKey);
+      emit this->signalObjectUpdated(primaryKey);
    }
-
-   dbTransaction.commit();
    return;
 }
 
@@ -1913,25 +2565,118 @@ int ObjectStore::insertOrUpdate(QObject & object) {
 }
 
 void ObjectStore::updateProperty(QObject const & object, BtStringConst const & propertyName) {
-   // Start transaction
-   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{
-      *this->pimpl->database,
-      connection,
-      QString("Update property %1 on %2").arg(*propertyName).arg(*this->pimpl->primaryTable.tableName)
-   };
+   int const primaryKey = this->pimpl->getPrimaryKey(object).toInt();
 
-   if (!this->pimpl->updatePropertyInDb(connection, object, propertyName)) {
-      // Something went wrong.  Bailing out here will abort the transaction and avoid sending the signal.
+   //
+   // If we're in the middle of updating the object to match what someone else wrote to the DB, then there's nothing to
+   // write back, but the UI still needs to know about the change.
+   //
+   if (ObjectStore::isApplyingRemoteChanges()) {
+      emit this->signalPropertyChanged(primaryKey, propertyName);
       return;
    }
 
-   // Everything went fine so we can commit the transaction
-   dbTransaction.commit();
+   TableField const * fieldDefn = this->pimpl->findSimpleProperty(propertyName);
+   // For other clients, we say which column changed, or, if it's stored in a junction table, which property
+   QStringList const changedColumns{fieldDefn ? *fieldDefn->columnName : *propertyName};
+   QString const tableName{*this->pimpl->primaryTable.tableName};
+   QString const description{QString("Update property %1 on %2 #%3").arg(*propertyName).arg(tableName).arg(primaryKey)};
+
+   //
+   // If the DB writer thread is running, we can hand off writing a simple property to it, so that the caller doesn't
+   // have to wait for the DB.  We don't do this if we're inside a transaction (eg a DbUnitOfWork), as the queued write
+   // would then not be part of it (and, on SQLite, would contend with it for the DB lock).
+   //
+   DbWriter & dbWriter = DbWriter::instance();
+   if (dbWriter.isRunning() && !DbWriter::isWriterThread()) {
+      if (fieldDefn && !DbTransaction::isInProgress(this->pimpl->database->sqlDatabase())) {
+         PreparedWrite preparedWrite = this->pimpl->prepareSimplePropertyUpdate(object, *fieldDefn);
+         //
+         // We assume the write will succeed, so that the next write to this object (which might also get queued before
+         // this one is done) expects the right row version.  If it doesn't, the object gets re-read from the DB anyway.
+         //
+         int const expectedRowVersion = this->pimpl->rowVersions.value(primaryKey, 0);
+         this->pimpl->recordQueuedWrite(primaryKey);
+         dbWriter.enqueue(
+            description,
+            [this, preparedWrite, tableName, changedColumns, description, primaryKey, expectedRowVersion](
+               QSqlDatabase & connection
+            ) {
+               switch (execPreparedWrite(connection, preparedWrite)) {
+                  case WriteResult::Succeeded:
+                     if (expectedRowVersion > 0) {
+                        QMetaObject::invokeMethod(
+                           this,
+                           [this, primaryKey, expectedRowVersion]() {
+                              this->pimpl->confirmQueuedWrite(primaryKey, expectedRowVersion + 1);
+                           },
+                           Qt::QueuedConnection
+                        );
+                     }
+                     DbChangeNotifier::publish(connection,
+                                               DbChangeNotifier::Operation::Update,
+                                               tableName,
+                                               primaryKey,
+                                               changedColumns);
+                     ChangeJournal::instance().record(DbChangeNotifier::Operation::Update,
+                                                      tableName,
+                                                      primaryKey,
+                                                      changedColumns);
+                     return true;
+                  case WriteResult::Conflict:
+                     // Nothing got written, so there's nothing to roll back, and it's not a DB error as such
+                     this->pimpl->handleWriteConflict(*this, description, primaryKey);
+                     return true;
+                  case WriteResult::Failed:
+                     break;
+                  // No default case needed as compiler should warn us if any options covered above
+               }
+               return false;
+            }
+         );
+         // The in-memory object is already updated, so we can tell the UI straight away
+         emit this->signalPropertyChanged(primaryKey, propertyName);
+         return;
+      }
+   }
+
+   WriteResult writeResult;
+   {
+      // Start transaction
+      // (By the magic of RAII, this will abort if we leave this scope without calling dbTransaction.commit()
+      QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+      DbTransaction dbTransaction{
+         *this->pimpl->database,
+         connection,
+         QString("Update property %1 on %2").arg(*propertyName).arg(tableName)
+      };
+
+      writeResult = this->pimpl->updatePropertyInDb(connection, object, propertyName);
+      if (writeResult == WriteResult::Succeeded) {
+         DbChangeNotifier::publish(connection,
+                                   DbChangeNotifier::Operation::Update,
+                                   tableName,
+                                   primaryKey,
+                                   changedColumns);
+         // Everything went fine so we can commit the transaction
+         dbTransaction.commit();
+      }
+   }
+
+   if (writeResult == WriteResult::Conflict) {
+      // Someone else changed the object first, so we'll end up with their version (and no signal for ours)
+      this->pimpl->handleWriteConflict(*this, description, primaryKey);
+      return;
+   }
+   if (writeResult == WriteResult::Failed) {
+      // Something went wrong.  Bailing out here will have aborted the transaction and avoids sending the signal.
+      return;
+   }
+   this->pimpl->recordWrite(primaryKey);
+   ChangeJournal::instance().record(DbChangeNotifier::Operation::Update, tableName, primaryKey, changedColumns);
 
    // Tell any bits of the UI that need to know that the property was updated
-   emit this->signalPropertyChanged(this->pimpl->getPrimaryKey(object).toInt(), propertyName);
+   emit this->signalPropertyChanged(primaryKey, propertyName);
 
    return;
 }
@@ -1941,7 +2686,7 @@ std::shared_ptr<QObject> ObjectStore::defaultSoftDelete(int id) {
    // We assume on soft-delete that there is nothing to do on related objects - eg if a Mash is soft deleted (ie marked
    // deleted but remains in the DB) then there isn't actually anything we need to do with its MashSteps.
    //
-   qDebug() << Q_FUNC_INFO << "Soft delete" << this->pimpl->m_className << "#" << id;
+   qCDebug(logDb) << Q_FUNC_INFO << "Soft delete" << this->pimpl->m_className << "#" << id;
    auto object = this->pimpl->allObjects.value(id);
    if (this->pimpl->allObjects.contains(id)) {
       this->pimpl->allObjects.remove(id);
@@ -1960,7 +2705,7 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    // the object model than here in the object store as they can be subtle, and it would be cumbersome to model them
    // generically.
    //
-   qDebug() << Q_FUNC_INFO << "Hard delete" << this->pimpl->m_className << "#" << id;
+   qCDebug(logDb) << Q_FUNC_INFO << "Hard delete" << this->pimpl->m_className << "#" << id;
    auto object = this->pimpl->allObjects.value(id);
    QSqlDatabase connection = this->pimpl->database->sqlDatabase();
    DbTransaction dbTransaction{*this->pimpl->database,
@@ -2003,7 +2748,7 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    queryStringAsStream << this->pimpl->primaryTable.tableName;
    BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
    queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-   qDebug() <<
+   qCDebug(logDb) <<
       Q_FUNC_INFO << "Deleting main table row #" << id << "with database query " << queryString;
 
    //
@@ -2012,7 +2757,7 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    BtSqlQuery sqlQuery{connection};
    sqlQuery.prepare(queryString);
    sqlQuery.bindValue(QString{":"} + *primaryKeyColumn, primaryKey);
-   qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+   qCDebug(logDb).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
    //
    // Run the query
@@ -2024,12 +2769,18 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
       return object;
    }
 
+   DbChangeNotifier::publish(connection,
+                             DbChangeNotifier::Operation::Delete,
+                             *this->pimpl->primaryTable.tableName,
+                             id);
    dbTransaction.commit();
+   ChangeJournal::instance().record(DbChangeNotifier::Operation::Delete, *this->pimpl->primaryTable.tableName, id);
 
    //
    // Remove the object from the cache
    //
    this->pimpl->allObjects.remove(id);
+   this->pimpl->setRowVersion(id, 0);
 
    // Tell any bits of the UI that need to know that an object was deleted
    emit this->signalObjectDeleted(id, object);
@@ -2037,6 +2788,189 @@ std::shared_ptr<QObject> ObjectStore::defaultHardDelete(int id) {
    return object;
 }
 
+QVector<ObjectStore::ForeignKeyColumn> ObjectStore::foreignKeysTo(QString const & tableName) const {
+   QVector<ForeignKeyColumn> foreignKeys;
+   //
+   // A brew note belongs to its Recipe, and goes when the Recipe is hard deleted, but it's also the only record of what
+   // was actually brewed.  So, for purging, we treat it like any other reference: a soft-deleted Recipe is kept for as
+   // long as it has brew notes.
+   //
+   bool const isHistory = std::strcmp(this->pimpl->m_className, BrewNote::staticMetaObject.className()) == 0;
+   auto addForeignKeys = [&foreignKeys, &tableName, isHistory](TableDefinition const & tableDefinition,
+                                                               int const firstField) {
+      for (int ii = firstField; ii < tableDefinition.tableFields.size(); ++ii) {
+         TableField const & fieldDefn = tableDefinition.tableFields.at(ii);
+         if (!std::holds_alternative<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder)) {
+            continue;
+         }
+         auto const foreignKeyTo = std::get<ObjectStore::TableDefinition const *>(fieldDefn.valueDecoder);
+         if (foreignKeyTo && *foreignKeyTo->tableName == tableName) {
+            // Ownership is always expressed by one of these two properties (see model/OwnedByRecipe.h and
+            // model/EnumeratedBase.h)
+            bool const isOwner = !isHistory &&
+                                 (fieldDefn.propertyName == PropertyNames::OwnedByRecipe::recipeId ||
+                                  fieldDefn.propertyName == PropertyNames::EnumeratedBase::ownerId);
+            foreignKeys.append(ForeignKeyColumn{*tableDefinition.tableName, *fieldDefn.columnName, isOwner});
+         }
+      }
+      return;
+   };
+
+   addForeignKeys(this->pimpl->primaryTable, 1);
+   // In junction tables, the first field is the table's own primary key and the second refers back to our primary
+   // table, so it's only the third field onwards we need to look at
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      addForeignKeys(junctionTable, 2);
+   }
+   return foreignKeys;
+}
+
+QVector<int> ObjectStore::findUnreferencedDeleted(QVector<ForeignKeyColumn> const & referencingColumns,
+                                                  int const maxIds,
+                                                  int const afterId) const {
+   QVector<int> ids;
+   TableField const * deletedFieldDefn = this->pimpl->findSimpleProperty(PropertyNames::NamedEntity::deleted);
+   if (!deletedFieldDefn || maxIds <= 0) {
+      return ids;
+   }
+
+   //
+   // Construct the SQL, which will be of the form
+   //
+   //    SELECT t.id FROM hop t
+   //    WHERE t.deleted = :deleted
+   //    AND t.id > :afterId
+   //    AND NOT EXISTS (SELECT 1 FROM inventory_hop r WHERE r.hop_id = t.id)
+   //    AND NOT EXISTS (SELECT 1 FROM recipe_addition_hop r WHERE r.hop_id = t.id)
+   //    ORDER BY t.id
+   //    LIMIT 20;
+   //
+   // Where a table refers to itself (eg recipe.ancestor_id), a row referring to itself does not count.
+   //
+   QString const & tableName = *this->pimpl->primaryTable.tableName;
+   QString const & primaryKeyColumn = *this->pimpl->getPrimaryKeyColumn();
+   QString queryString;
+   QTextStream queryStringAsStream{&queryString};
+   queryStringAsStream <<
+      "SELECT t." << primaryKeyColumn << " FROM " << tableName << " t WHERE t." << deletedFieldDefn->columnName <<
+      " = :deleted AND t." << primaryKeyColumn << " > :afterId";
+   for (auto const & referencingColumn : referencingColumns) {
+      if (referencingColumn.isOwner) {
+         continue;
+      }
+      queryStringAsStream <<
+         " AND NOT EXISTS (SELECT 1 FROM " << referencingColumn.tableName << " r WHERE r." <<
+         referencingColumn.columnName << " = t." << primaryKeyColumn;
+      if (referencingColumn.tableName == tableName) {
+         queryStringAsStream << " AND r." << primaryKeyColumn << " <> t." << primaryKeyColumn;
+      }
+      queryStringAsStream << ")";
+   }
+   queryStringAsStream << " ORDER BY t." << primaryKeyColumn << " LIMIT " << maxIds << ";";
+
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   sqlQuery.bindValue(":deleted", true);
+   sqlQuery.bindValue(":afterId", afterId);
+   if (!sqlQuery.exec()) {
+      qCritical() <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return ids;
+   }
+   while (sqlQuery.next()) {
+      ids.append(sqlQuery.value(0).toInt());
+   }
+   qCDebug(logDb) << Q_FUNC_INFO << "Found" << ids.size() << "unreferenced deleted rows in" << tableName;
+   return ids;
+}
+
+void ObjectStore::refreshFromDb(int id) {
+   qCDebug(logDb) << Q_FUNC_INFO << "Refresh" << this->pimpl->m_className << "#" << id;
+   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
+
+   BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
+   QString const queryString = this->pimpl->selectRowsQueryString(QString{"%1 = :%1"}.arg(*primaryKeyColumn));
+   BtSqlQuery sqlQuery{connection};
+   sqlQuery.prepare(queryString);
+   sqlQuery.bindValue(QString{":"} + *primaryKeyColumn, id);
+   if (!sqlQuery.exec()) {
+      qCritical() <<
+         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      return;
+   }
+   std::vector<int> columnIndexes;
+   int rowVersionIndex = -1;
+   if (!this->pimpl->resolveColumnIndexes(sqlQuery, columnIndexes, rowVersionIndex)) {
+      return;
+   }
+
+   auto cachedObject = this->pimpl->allObjects.value(id);
+   if (!sqlQuery.next()) {
+      //
+      // The row has gone from the DB, so it needs to go from the cache.  (If someone else soft-deleted it, then we'll
+      // instead have been told about a change to its "deleted" property.)
+      //
+      if (cachedObject) {
+         qCDebug(logDb) << Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "no longer in DB";
+         this->pimpl->allObjects.remove(id);
+         this->pimpl->setRowVersion(id, 0);
+         emit this->signalObjectDeleted(id, cachedObject);
+      }
+      return;
+   }
+
+   NamedParameterBundle namedParameterBundle{this->pimpl->rowLayout};
+   this->pimpl->readRow(sqlQuery, columnIndexes, namedParameterBundle);
+   int const rowVersion = sqlQuery.value(rowVersionIndex).toInt();
+
+   if (!cachedObject) {
+      // Someone else created the object, so it's the same as when we're loading everything at start-up
+      auto object = this->createNewObject(namedParameterBundle);
+      this->pimpl->allObjects.insert(id, object);
+      this->pimpl->setRowVersion(id, rowVersion);
+      this->pimpl->loadJunctionTables(connection, id);
+      emit this->signalObjectInserted(id);
+      return;
+   }
+
+   //
+   // We compare with the last row version the DB confirmed, rather than the one we're expecting once any queued writes
+   // are done, otherwise a change made elsewhere could be mistaken for one of ours.
+   //
+   if (this->pimpl->confirmedRowVersions.value(id, 0) == rowVersion) {
+      qCDebug(logDb) << Q_FUNC_INFO << this->pimpl->m_className << "#" << id << "already up-to-date";
+      return;
+   }
+
+   //
+   // We update the cached object in place, because other objects (and bits of the UI) will be holding pointers to it.
+   // Using the setters means that the usual signals get sent, so everything showing the object gets updated.  We only
+   // call setters for properties that have actually changed, to avoid needless recalculations etc.
+   //
+   {
+      ApplyingRemoteChanges applyingRemoteChanges;
+      for (auto const & columnDecoder : this->pimpl->columnDecoders) {
+         BtStringConst const & propertyName = columnDecoder.fieldDefn->propertyName;
+         if (propertyName == this->pimpl->getPrimaryKeyProperty()) {
+            continue;
+         }
+         QVariant const newValue = namedParameterBundle.get(propertyName);
+         if (cachedObject->property(*propertyName) == newValue) {
+            continue;
+         }
+         if (!cachedObject->setProperty(*propertyName, newValue)) {
+            qWarning() <<
+               Q_FUNC_INFO << "Unable to set property" << propertyName << "on" <<
+               cachedObject->metaObject()->className() << "#" << id << "to" << newValue;
+         }
+      }
+      this->pimpl->loadJunctionTables(connection, id);
+   }
+   this->pimpl->setRowVersion(id, rowVersion);
+   return;
+}
+
 std::shared_ptr<QObject> ObjectStore::findFirstMatching(
    std::function<bool(std::shared_ptr<QObject>)> const & matchFunction
 ) const {
@@ -2093,7 +3027,7 @@ QList<QObject *> ObjectStore::findAllMatching(std::function<bool(QObject *)> con
 QVector<int> ObjectStore::idsOfAllMatching(
    std::function<bool(QObject const *)> const & matchFunction
 ) const {
-   qDebug() << Q_FUNC_INFO << this->pimpl->m_className;
+   qCDebug(logDb) << Q_FUNC_INFO << this->pimpl->m_className;
    // It would be nice to use C++20 ranges here, but I couldn't find a way to use them with QHash in such a way that the
    // keys of the hash would be accessible in the range.  So, for now, we do it the old way.
    QVector<int> results;
@@ -22,8 +22,11 @@
 #include <optional>
 
 #include <QObject>
+#include <QByteArray>
+#include <QDataStream>
 #include <QSqlDatabase>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
 #include "measurement/Unit.h"
@@ -128,13 +131,20 @@ public:
    /**
     * \brief The main table in which objects of the type handled by this \c ObjectStore live, and how to map between
     *        object properties and table fields.
+    *
+    *        Every foreign key column gets an index automatically (as we look up, update and delete rows by them, eg
+    *        all the additions for a given recipe).  \c indexedColumns is for any other columns that should be indexed.
+    *        Indexes are created in \c addTableConstraints, and are named \c {table}_{column}_idx, which migrations
+    *        that add indexes to existing databases (see \c DatabaseSchemaHelper) need to follow.
     */
    struct TableDefinition {
       BtStringConst tableName;
       QVector<TableField> const tableFields;
+      QStringList const indexedColumns;
       //! Constructor
       TableDefinition(char const * const tableName,
-                      std::initializer_list<TableField> const tableFields);
+                      std::initializer_list<TableField> const tableFields,
+                      QStringList const & indexedColumns = {});
    };
 
    /**
@@ -216,6 +226,9 @@ public:
 
    QString name() const;
 
+   //! \brief Name of the primary table in the DB
+   QString tableName() const;
+
    /**
     * \brief Gets the state of the ObjectStore.  If it's \c ErrorInitialising, we probably need to terminate the
     *        program.  (This is because, if we were unable to read some or all data from the database during startup,
@@ -237,7 +250,7 @@ public:
    bool createTables(Database & database, QSqlDatabase & connection) const;
 
    /**
-    * \brief Add (eg foreign key) constraints to the table(s) for the objects handled by this store
+    * \brief Add (eg foreign key) constraints, and indexes, to the table(s) for the objects handled by this store
     */
    bool addTableConstraints(Database & database, QSqlDatabase & connection) const;
 
@@ -249,6 +262,24 @@ public:
     */
    void loadAll(Database * database = nullptr);
 
+   /**
+    * \brief Alternative to the DB part of \c loadAll that builds all our objects from data written by
+    *        \c writeSnapshot rather than from the DB.  Normally only called from \c loadAll, when \c StartupSnapshot
+    *        has a snapshot for our table.
+    *
+    * \return \c false if the data was not written for our current table layout or is otherwise unusable, in which
+    *         case nothing has been loaded (and caller should read from the DB instead), \c true otherwise
+    */
+   bool loadFromSnapshot(QByteArray const & snapshotData, Database * database = nullptr);
+
+   /**
+    * \brief Write all the rows of our primary table, as currently stored in the DB, in the form that
+    *        \c loadFromSnapshot reads
+    *
+    * \return \c true if succeeded \c false otherwise
+    */
+   bool writeSnapshot(QSqlDatabase & connection, QDataStream & out) const;
+
    /**
     * \brief Create a new object of the type we are handling, using the parameters read from the DB.  Subclass needs to
     *        implement.
@@ -341,6 +372,73 @@ public:
     */
    std::shared_ptr<QObject> defaultHardDelete(int id);
 
+   /**
+    * \brief A foreign key column, in one of our tables, that refers to another table's primary key.  See
+    *        \c foreignKeysTo.
+    */
+   struct ForeignKeyColumn {
+      QString tableName;
+      QString columnName;
+      /**
+       * \brief \c true if the row containing this column belongs to the row it refers to (eg a \c RecipeAdditionHop
+       *        belongs to its \c Recipe, a \c MashStep to its \c Mash), and so gets deleted along with it by a hard
+       *        delete.  Always \c false for a \c BrewNote: although it belongs to its \c Recipe, it is a record of
+       *        what was brewed, so it needs to keep the \c Recipe from being purged.
+       */
+      bool isOwner;
+   };
+
+   /**
+    * \brief Find the foreign key columns, in our primary table and our junction tables, that refer to \c tableName.
+    *        Junction table columns that refer back to our own primary table are not included, as a hard delete
+    *        always removes those junction table rows first.
+    */
+   QVector<ForeignKeyColumn> foreignKeysTo(QString const & tableName) const;
+
+   /**
+    * \brief Find soft-deleted objects whose DB rows are not referred to from anywhere else in the DB, and which are
+    *        therefore candidates for \c purge.
+    *
+    * \param referencingColumns All the foreign key columns (across all object stores) that refer to our primary
+    *                           table.  References from owned rows (see \c ForeignKeyColumn::isOwner) are ignored.
+    * \param maxIds Return no more than this many IDs
+    * \param afterId Only look at objects with IDs greater than this, so that callers can page through the results
+    *                (and not be given again the objects they could not purge)
+    *
+    * \return IDs of the objects found (lowest first).  Empty if there are none, or if objects of this type cannot be
+    *         soft-deleted.
+    */
+   QVector<int> findUnreferencedDeleted(QVector<ForeignKeyColumn> const & referencingColumns,
+                                        int const maxIds,
+                                        int const afterId = 0) const;
+
+   /**
+    * \brief Hard delete a soft-deleted object, eg because \c findUnreferencedDeleted says nothing else needs it.
+    *        Subclass needs to implement, so that anything the object owns is deleted along with it.
+    *
+    * \return \c true if the object was deleted.  \c false if it does not exist, is not soft-deleted, or is still
+    *         being used by something in memory, in which case nothing is done.
+    */
+   virtual bool purge(int id) = 0;
+
+   /**
+    * \brief Re-read one object from the DB, because someone else (ie another client sharing a PostgreSQL database)
+    *        changed it, and update the cache to match.  Depending on what we find, this means updating the properties
+    *        of the cached object, adding a new object to the cache or removing one from it, with the same signals as
+    *        for a local change.  Does nothing if we are already up-to-date with the row.  See \c DbChangeNotifier.
+    *
+    *        NB: The cached object's setters are called as normal, except that nothing gets written back to the DB (see
+    *        \c isApplyingRemoteChanges).
+    */
+   void refreshFromDb(int id);
+
+   /**
+    * \brief Returns \c true whilst \c refreshFromDb is updating cached objects.  Besides \c ObjectStore itself, this
+    *        is used by \c NamedEntity to avoid side-effects (eg Recipe versioning) that only make sense for local
+    *        changes.
+    */
+   static bool isApplyingRemoteChanges();
+
    /**
     * \brief Returns the number of objects in this store
     */
@@ -516,7 +614,8 @@ signals:
     *            void Database::changedInventory(DatabaseConstants::DbTableId, int, QVariant);
     *
     *        Note that this signal is only emitted when \c updateProperty() is called, NOT when \c update() is called
-    *        (as in the latter case we won't know which, if any, properties were changed).
+    *        (as in the latter case we won't know which, if any, properties were changed).  See \c signalObjectUpdated
+    *        for the latter.
     *
     * \param id The primary key of the object that changed.  (Recipient will already know which class, as, eg, will
     *           connect slot to \c ObjectStoreTyped<InventoryFermentable>::getInstance(),
@@ -525,6 +624,15 @@ signals:
     */
    void signalPropertyChanged(int id, BtStringConst const & propertyName);
 
+   /**
+    * \brief Signal emitted when \c update() has written the whole of an object to the DB.  Since we don't know which
+    *        properties (if any) changed, recipients that care about particular properties need to assume they all
+    *        might have.
+    *
+    * \param id The primary key of the object that was updated
+    */
+   void signalObjectUpdated(int id);
+
 private:
    // Private implementation details - see https://herbsutter.com/gotw/_100/
    class impl;
@@ -17,7 +17,11 @@
 
 #include  <mutex> // for std::once_flag
 
+#include <QElapsedTimer>
+
 #include "database/DbTransaction.h"
+#include "database/StartupSnapshot.h"
+#include "Logging.h"
 #include "measurement/Unit.h"
 #include "model/Boil.h"
 #include "model/BoilStep.h"
@@ -137,7 +141,8 @@ namespace {
          {ObjectStore::FieldType::String, "fermenter_notes"               , PropertyNames::Equipment::fermenterNotes             },
          {ObjectStore::FieldType::String, "aging_vessel_notes"            , PropertyNames::Equipment::agingVesselNotes           },
          {ObjectStore::FieldType::String, "packaging_vessel_notes"        , PropertyNames::Equipment::packagingVesselNotes       },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -183,7 +188,8 @@ namespace {
          {ObjectStore::FieldType::Double, "fan_ppm"                  , PropertyNames::Fermentable::fan_ppm               },
          {ObjectStore::FieldType::Double, "fermentability_pct"       , PropertyNames::Fermentable::fermentability_pct    },
          {ObjectStore::FieldType::Double, "beta_glucan_ppm"          , PropertyNames::Fermentable::betaGlucan_ppm        },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -236,7 +242,8 @@ namespace {
          {ObjectStore::FieldType::Double, "pinene_pct"           , PropertyNames::Hop::pinene_pct        },
          {ObjectStore::FieldType::Double, "polyphenols_pct"      , PropertyNames::Hop::polyphenols_pct   },
          {ObjectStore::FieldType::Double, "xanthohumol_pct"      , PropertyNames::Hop::xanthohumol_pct   },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -419,7 +426,8 @@ namespace {
          // ⮜⮜⮜ All below added for BeerJSON support ⮞⮞⮞
          {ObjectStore::FieldType::String, "producer"        , PropertyNames::Misc::producer      },
          {ObjectStore::FieldType::String, "product_id"      , PropertyNames::Misc::productId     },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -448,7 +456,8 @@ namespace {
          {ObjectStore::FieldType::String, "folder"          , PropertyNames::FolderBase::folderPath   },
          {ObjectStore::FieldType::Double, "percent_acid"    , PropertyNames::Salt::percentAcid    },
          {ObjectStore::FieldType::Enum  , "stype"           , PropertyNames::Salt::type           , &Salt::typeStringMapping},
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
    // Salts don't have children
    template<> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES<Salt> {};
@@ -503,7 +512,8 @@ namespace {
          {ObjectStore::FieldType::String, "flavor"            , PropertyNames::Style::flavor           },
          {ObjectStore::FieldType::String, "mouthfeel"         , PropertyNames::Style::mouthfeel        },
          {ObjectStore::FieldType::String, "overall_impression", PropertyNames::Style::overallImpression},
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -536,7 +546,8 @@ namespace {
          {ObjectStore::FieldType::Double, "nitrate_ppm"  , PropertyNames::Water::nitrate_ppm     },
          {ObjectStore::FieldType::Double, "nitrite_ppm"  , PropertyNames::Water::nitrite_ppm     },
          {ObjectStore::FieldType::Double, "fluoride_ppm" , PropertyNames::Water::fluoride_ppm    },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -570,7 +581,8 @@ namespace {
          {ObjectStore::FieldType::Bool  , "killer_producing_k28_toxin"  , PropertyNames::Yeast::killerProducingK28Toxin  },
          {ObjectStore::FieldType::Bool  , "killer_producing_klus_toxin" , PropertyNames::Yeast::killerProducingKlusToxin },
          {ObjectStore::FieldType::Bool  , "killer_neutral"              , PropertyNames::Yeast::killerNeutral            },
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -627,7 +639,8 @@ namespace {
          {ObjectStore::FieldType::Double, "beer_acidity_ph"         , PropertyNames::Recipe::beerAcidity_pH         },
          {ObjectStore::FieldType::Double, "apparent_attenuation_pct", PropertyNames::Recipe::apparentAttenuation_pct},
 
-      }
+      },
+      {"name"} // Indexed columns, in addition to foreign keys
    };
    template<> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES<Recipe> {};
 
@@ -847,6 +860,11 @@ ObjectStoreTyped<NE> & ObjectStoreTyped<NE>::getInstance(Database * database) {
    return ostSingleton;
 }
 
+template<class NE>
+std::unique_ptr<ObjectStoreTyped<NE>> ObjectStoreTyped<NE>::createDetachedInstance() {
+   return std::make_unique<ObjectStoreTyped<NE>>(NE::typeLookup, PRIMARY_TABLE<NE>, JUNCTION_TABLES<NE>);
+}
+
 namespace {
    //! Helper for \c postLoadInit
    template<typename T>
@@ -867,7 +885,7 @@ namespace {
       // in the store.
       //
       if constexpr (HasConnectSignalsMemberFunction<NE>) {
-         qDebug() << Q_FUNC_INFO << "Connecting signals for" << store<< "objects";
+         qCDebug(logDb) << Q_FUNC_INFO << "Connecting signals for" << store<< "objects";
          for (NE * ne : store.getAllRaw()) {
             ne->connectSignals();
          }
@@ -913,7 +931,21 @@ template ObjectStoreTyped<Style                    > & ObjectStoreTyped<Style
 template ObjectStoreTyped<Water                    > & ObjectStoreTyped<Water                    >::getInstance(Database * database = nullptr);
 template ObjectStoreTyped<Yeast                    > & ObjectStoreTyped<Yeast                    >::getInstance(Database * database = nullptr);
 
+// At the moment, we only need detached instances for benchmarking, so there's no need to instantiate this for every
+// type.
+template std::unique_ptr<ObjectStoreTyped<Hop>> ObjectStoreTyped<Hop>::createDetachedInstance();
+
+namespace {
+   //! Set once \c InitialiseAllObjectStores has succeeded, so that \c SnapshotAllObjectStores knows it's safe to run
+   bool allObjectStoresInitialised = false;
+}
+
 bool InitialiseAllObjectStores(QString & errorMessage) {
+   // We log how long loading takes, as, eg, it tells us whether the snapshot is worth having
+   QElapsedTimer loadTimer;
+   loadTimer.start();
+   bool const haveSnapshot = StartupSnapshot::instance().isOpen();
+
    // It's deliberate that we don't stop after the first error.  If there is a problem, it's quite useful to know how
    // extensive it is.
    QStringList errors;
@@ -947,6 +979,12 @@ bool InitialiseAllObjectStores(QString & errorMessage) {
    if (ObjectStoreTyped<Water                    >::getInstance().state() == ObjectStore::State::ErrorInitialising) { errors << "Water"                    ; }
    if (ObjectStoreTyped<Yeast                    >::getInstance().state() == ObjectStore::State::ErrorInitialising) { errors << "Yeast"                    ; }
 
+   // Whether or not it was used, we're now done with any snapshot
+   StartupSnapshot::instance().close();
+   qInfo() <<
+      Q_FUNC_INFO << (haveSnapshot ? "Warm start (from snapshot):" : "Cold start (from DB):") <<
+      "loaded all object stores in" << loadTimer.elapsed() << "ms";
+
    if (errors.size() > 0) {
       qCritical() << Q_FUNC_INFO << "Errors loading" << errors.join(", ");
       errorMessage = QObject::tr("There were errors loading the following object store(s): %1").arg(errors.join(", "));
@@ -993,13 +1031,14 @@ bool InitialiseAllObjectStores(QString & errorMessage) {
    postLoadInit(ObjectStoreTyped<Water                    >::getInstance());
    postLoadInit(ObjectStoreTyped<Yeast                    >::getInstance());
 
+   allObjectStoresInitialised = true;
    return true;
 }
 
 namespace {
-   QVector<ObjectStore const *> getAllObjectStores(Database * database = nullptr) {
+   QVector<ObjectStore *> getAllObjectStores(Database * database = nullptr) {
       // NOTE: This is the 4th of 4 places we need to add any new ObjectStoreTyped
-      static QVector<ObjectStore const *> allObjectStores {
+      static QVector<ObjectStore *> allObjectStores {
          &ObjectStoreTyped<Boil                     >::getInstance(database),
          &ObjectStoreTyped<BoilStep                 >::getInstance(database),
          &ObjectStoreTyped<BrewNote                 >::getInstance(database),
@@ -1034,7 +1073,7 @@ namespace {
 }
 
 bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logDb) << Q_FUNC_INFO;
    //
    // This is obviously deliberately two separate loops because we cannot add the constraints until after all the tables
    // have been created.
@@ -1074,3 +1113,74 @@ bool WriteAllObjectStoresToNewDb(Database & newDatabase, QSqlDatabase & connecti
    dbTransaction.commit();
    return true;
 }
+
+ObjectStore * FindObjectStoreForTable(QString const & tableName) {
+   for (ObjectStore * objectStore : getAllObjectStores()) {
+      if (objectStore->tableName() == tableName) {
+         return objectStore;
+      }
+   }
+   return nullptr;
+}
+
+int PurgeUnreferencedDeletedObjects(PurgeProgress & progress, int const maxToExamine) {
+   QVector<ObjectStore *> const allObjectStores = getAllObjectStores();
+   int numExamined = 0;
+   int numPurged = 0;
+   while (!progress.finished && numExamined < maxToExamine) {
+      if (progress.storeIndex >= allObjectStores.size()) {
+         // End of a pass.  Unless it purged nothing, go round again, as there might now be more we can purge.
+         if (progress.numPurgedThisPass == 0) {
+            progress.finished = true;
+         } else {
+            progress = PurgeProgress{};
+         }
+         continue;
+      }
+
+      ObjectStore * objectStore = allObjectStores.at(progress.storeIndex);
+      // Gather up everything, in any store, that refers to this store's primary table
+      QVector<ObjectStore::ForeignKeyColumn> referencingColumns;
+      for (ObjectStore const * otherStore : allObjectStores) {
+         referencingColumns.append(otherStore->foreignKeysTo(objectStore->tableName()));
+      }
+      int const maxIds = maxToExamine - numExamined;
+      QVector<int> const ids = objectStore->findUnreferencedDeleted(referencingColumns, maxIds, progress.afterId);
+      for (int const id : ids) {
+         ++numExamined;
+         // Whether or not we manage to purge it, we don't want to look at this object again in this pass
+         progress.afterId = id;
+         if (objectStore->purge(id)) {
+            ++numPurged;
+            ++progress.numPurgedThisPass;
+         }
+      }
+      if (ids.size() < maxIds) {
+         // Nothing more to look at in this store
+         ++progress.storeIndex;
+         progress.afterId = 0;
+      }
+   }
+   qCDebug(logDb) << Q_FUNC_INFO << "Purged" << numPurged << "of" << numExamined << "objects examined";
+   return numPurged;
+}
+
+bool SnapshotAllObjectStores(
+   QSqlDatabase & connection,
+   std::function<bool(QString const & tableName, QByteArray const & tableData)> const & tableHandler
+) {
+   if (!allObjectStoresInitialised) {
+      qCDebug(logDb) << Q_FUNC_INFO << "Not taking snapshot as object stores were not all loaded";
+      return false;
+   }
+
+   for (ObjectStore const * objectStore : getAllObjectStores()) {
+      QByteArray tableData;
+      QDataStream out{&tableData, QIODevice::WriteOnly};
+      out.setVersion(StartupSnapshot::dataStreamVersion);
+      if (!objectStore->writeSnapshot(connection, out) || !tableHandler(objectStore->tableName(), tableData)) {
+         return false;
+      }
+   }
+   return true;
+}
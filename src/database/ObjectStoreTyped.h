@@ -21,6 +21,7 @@
 #include <QDebug>
 
 #include "database/ObjectStore.h"
+#include "Logging.h"
 #include "model/NamedEntity.h"
 
 /**
@@ -55,6 +56,13 @@ public:
     */
    static ObjectStoreTyped<NE> & getInstance(Database * database = nullptr);
 
+   /**
+    * \brief Create a new store with the same mappings as the singleton, but which is not shared with the rest of the
+    *        program and has not loaded anything from the DB.  This is only really useful for benchmarking
+    *        \c loadAll(), which is otherwise only ever called once per object type.
+    */
+   static std::unique_ptr<ObjectStoreTyped<NE>> createDetachedInstance();
+
    using ObjectStore::insert;
 
    /**
@@ -182,6 +190,27 @@ public:
       return this->hardOrSoftDelete(id, true);
    }
 
+   /**
+    * \brief See \c ObjectStore::purge
+    */
+   virtual bool purge(int id) override {
+      std::shared_ptr<NE> ne = this->getById(id);
+      if (!ne || !ne->deleted()) {
+         return false;
+      }
+      // One reference is held by our cache and one by ne.  Any more than that means something else (eg the undo stack)
+      // still has a use for the object.
+      if (ne.use_count() > 2) {
+         qCDebug(logDb) <<
+            Q_FUNC_INFO << "Not purging" << NE::staticMetaObject.className() << "#" << id << "as it is still in use";
+         return false;
+      }
+      ne.reset();
+      this->hardDelete(id);
+      // If the delete failed (which will have been logged), the object will still be in the cache
+      return !this->contains(id);
+   }
+
    /**
     * \brief Search the set of all cached objects with a lambda.
     *
@@ -442,4 +471,53 @@ bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection);
  */
 bool WriteAllObjectStoresToNewDb(Database & newDatabase, QSqlDatabase & connectionNew);
 
+/**
+ * \brief For \c StartupSnapshot: get a snapshot (see \c ObjectStore::writeSnapshot) of each object store's primary
+ *        table and pass it, along with the table name, to \c tableHandler.
+ *
+ * \return \c false if the object stores have not all been loaded by \c InitialiseAllObjectStores (in which case
+ *         nothing is done), if there was an error, or if \c tableHandler returned \c false; \c true otherwise
+ */
+bool SnapshotAllObjectStores(
+   QSqlDatabase & connection,
+   std::function<bool(QString const & tableName, QByteArray const & tableData)> const & tableHandler
+);
+
+/**
+ * \brief Find the object store whose primary table is \c tableName
+ *
+ * \return \c nullptr if there is no such store
+ */
+ObjectStore * FindObjectStoreForTable(QString const & tableName);
+
+/**
+ * \brief Where \c PurgeUnreferencedDeletedObjects has got to, so that the next call can carry on from there
+ */
+struct PurgeProgress {
+   //! Index of the object store we are working through
+   int storeIndex = 0;
+   //! We have already looked at the objects in that store with this ID or lower
+   int afterId = 0;
+   //! Number of objects purged so far in the current pass over all the object stores
+   int numPurgedThisPass = 0;
+   //! Set once a whole pass over all the object stores purged nothing, ie there is nothing more that can be purged
+   bool finished = false;
+};
+
+/**
+ * \brief For \c DbMaintenance: look at up to \c maxToExamine soft-deleted objects, across all object stores, that
+ *        nothing in the DB refers to any more, and hard delete (see \c ObjectStore::purge) them if we can.  Call
+ *        repeatedly, with the same \c progress, until \c progress.finished is set, to purge everything that can be
+ *        purged.
+ *
+ *        Objects that cannot be purged (eg because they are still in use in memory) are skipped rather than looked at
+ *        again on the next call.  Once we have been through all the object stores, if we purged anything, we go round
+ *        again, because purging an object can make others purgeable (eg purging a \c Recipe removes its references to
+ *        the ingredients it uses).  A soft-deleted \c Recipe that still has brew notes is not purged (unless and until
+ *        the brew notes are themselves deleted), as purging it would also delete them.
+ *
+ * \return Number of objects purged
+ */
+int PurgeUnreferencedDeletedObjects(PurgeProgress & progress, int const maxToExamine);
+
 #endif
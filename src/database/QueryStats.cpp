@@ -0,0 +1,185 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/QueryStats.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/QueryStats.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <mutex>
+
+#include <QDebug>
+#include <QHash>
+
+#include "PersistentSettings.h"
+
+namespace {
+   //
+   // Execution times are counted in buckets whose upper bounds go up by a factor of 2^(1/4) (ie about 19%) each time,
+   // starting at 1µs.  So the percentiles we report are accurate to within that, which is plenty for seeing where time
+   // goes.  96 buckets takes us up to about 16 seconds, and anything slower than that goes in the last bucket.
+   //
+   int    const bucketsPerDoubling = 4;
+   int    const numBuckets = 96;
+   double const firstBucketUpperBound_ns = 1000.0;
+
+   int bucketFor(qint64 const elapsed_ns) {
+      if (elapsed_ns <= firstBucketUpperBound_ns) {
+         return 0;
+      }
+      int const bucket = static_cast<int>(
+         std::ceil(bucketsPerDoubling * std::log2(static_cast<double>(elapsed_ns) / firstBucketUpperBound_ns))
+      );
+      return std::min(bucket, numBuckets - 1);
+   }
+
+   qint64 bucketUpperBound_ns(int const bucket) {
+      return static_cast<qint64>(
+         firstBucketUpperBound_ns * std::exp2(static_cast<double>(bucket) / bucketsPerDoubling)
+      );
+   }
+
+   struct Counters {
+      qint64 count = 0;
+      qint64 total_ns = 0;
+      qint64 rows = 0;
+      std::array<qint64, numBuckets> histogram{};
+
+      //! \return Upper bound of the bucket containing the \c fraction point of all executions
+      qint64 percentile(double const fraction) const {
+         qint64 const target = static_cast<qint64>(std::ceil(fraction * static_cast<double>(this->count)));
+         qint64 soFar = 0;
+         for (int bucket = 0; bucket < numBuckets; ++bucket) {
+            soFar += this->histogram[bucket];
+            if (soFar >= target && soFar > 0) {
+               return bucketUpperBound_ns(bucket);
+            }
+         }
+         return 0;
+      }
+   };
+
+   std::mutex statsMutex;
+   QHash<QString, Counters> stats;
+
+   //! Default for PersistentSettings::Names::slowQueryThreshold_ms
+   int const defaultSlowQueryThreshold_ms = 200;
+
+   std::atomic<int> slowThreshold_ms{defaultSlowQueryThreshold_ms};
+}
+
+void QueryStats::recordExecution(QString const & statement, qint64 const elapsed_ns) {
+   std::lock_guard<std::mutex> lock{statsMutex};
+   Counters & counters = stats[statement];
+   ++counters.count;
+   counters.total_ns += elapsed_ns;
+   ++counters.histogram[bucketFor(elapsed_ns)];
+   return;
+}
+
+void QueryStats::recordRows(QString const & statement, qint64 const numRows) {
+   if (numRows <= 0) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock{statsMutex};
+   stats[statement].rows += numRows;
+   return;
+}
+
+int QueryStats::slowQueryThreshold_ms() {
+   return slowThreshold_ms.load(std::memory_order_relaxed);
+}
+
+void QueryStats::setSlowQueryThreshold_ms(int const threshold_ms) {
+   slowThreshold_ms.store(threshold_ms, std::memory_order_relaxed);
+   return;
+}
+
+void QueryStats::loadSettings() {
+   QueryStats::setSlowQueryThreshold_ms(
+      PersistentSettings::value(PersistentSettings::Names::slowQueryThreshold_ms,
+                                defaultSlowQueryThreshold_ms).toInt()
+   );
+   qDebug() << Q_FUNC_INFO << "Slow query threshold:" << QueryStats::slowQueryThreshold_ms() << "ms";
+   return;
+}
+
+std::vector<QueryStats::StatementStats> QueryStats::snapshot() {
+   std::vector<QueryStats::StatementStats> result;
+   {
+      std::lock_guard<std::mutex> lock{statsMutex};
+      result.reserve(stats.size());
+      for (auto ii = stats.cbegin(); ii != stats.cend(); ++ii) {
+         Counters const & counters = ii.value();
+         result.push_back(QueryStats::StatementStats{ii.key(),
+                                                     counters.count,
+                                                     counters.total_ns,
+                                                     counters.percentile(0.50),
+                                                     counters.percentile(0.99),
+                                                     counters.rows});
+      }
+   }
+   std::sort(result.begin(), result.end(), [](StatementStats const & lhs, StatementStats const & rhs) {
+      return lhs.total_ns > rhs.total_ns;
+   });
+   return result;
+}
+
+void QueryStats::reset() {
+   std::lock_guard<std::mutex> lock{statsMutex};
+   stats.clear();
+   return;
+}
+
+void QueryStats::writeReport(QTextStream & stream, int const maxStatements) {
+   auto const allStats = QueryStats::snapshot();
+   qint64 totalCount = 0;
+   qint64 total_ns = 0;
+   for (auto const & statementStats : allStats) {
+      totalCount += statementStats.count;
+      total_ns   += statementStats.total_ns;
+   }
+   stream <<
+      allStats.size() << " distinct statements, " << totalCount << " executions, " <<
+      QString::number(static_cast<double>(total_ns) / 1.0e6, 'f', 1) << " ms in total\n";
+
+   auto toMs = [](qint64 const ns) { return QString::number(static_cast<double>(ns) / 1.0e6, 'f', 3); };
+   stream << "   count |   total ms |     p50 ms |     p99 ms |     rows | statement\n";
+   int numWritten = 0;
+   for (auto const & statementStats : allStats) {
+      if (maxStatements > 0 && numWritten >= maxStatements) {
+         stream << "   (" << (allStats.size() - numWritten) << " more)\n";
+         break;
+      }
+      stream <<
+         QString::number(statementStats.count).rightJustified(8) << " | " <<
+         toMs(statementStats.total_ns).rightJustified(10) << " | " <<
+         toMs(statementStats.p50_ns).rightJustified(10) << " | " <<
+         toMs(statementStats.p99_ns).rightJustified(10) << " | " <<
+         QString::number(statementStats.rows).rightJustified(8) << " | " <<
+         statementStats.statement.simplified() << "\n";
+      ++numWritten;
+   }
+   return;
+}
+
+void QueryStats::logReport() {
+   QString report;
+   QTextStream reportAsStream{&report};
+   QueryStats::writeReport(reportAsStream);
+   qInfo().noquote() << Q_FUNC_INFO << "Database query statistics:\n" << report;
+   return;
+}
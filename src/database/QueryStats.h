@@ -0,0 +1,86 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/QueryStats.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_QUERYSTATS_H
+#define DATABASE_QUERYSTATS_H
+#pragma once
+
+#include <vector>
+
+#include <QString>
+#include <QTextStream>
+
+/**
+ * \brief Per-statement timing statistics for everything run through \c BtSqlQuery.  This is so that, when the program
+ *        is slow, we can tell whether (and where) the database is the cause.
+ *
+ *        Statistics are keyed on the SQL passed to \c BtSqlQuery::prepare, ie the statement template with its bind
+ *        placeholders, rather than on the values bound to it.  For each statement we keep a count, total time, an
+ *        approximate median and 99th percentile (from a fixed set of exponentially-sized buckets, so memory use does
+ *        not grow with the number of executions) and the number of rows returned (for queries) or affected (for
+ *        everything else).
+ *
+ *        Any statement that takes longer than the slow-query threshold is logged, along with its bound values and, on
+ *        SQLite, the output of EXPLAIN QUERY PLAN.
+ *
+ *        Everything here is thread-safe, as the DB can be used from more than one thread (see \c DbWriter).
+ */
+namespace QueryStats {
+
+   struct StatementStats {
+      QString statement;
+      qint64 count;
+      qint64 total_ns;
+      //! Approximate median execution time
+      qint64 p50_ns;
+      //! Approximate 99th percentile execution time
+      qint64 p99_ns;
+      qint64 rows;
+   };
+
+   //! \brief Record one execution of \c statement taking \c elapsed_ns
+   void recordExecution(QString const & statement, qint64 const elapsed_ns);
+
+   //! \brief Add to the number of rows returned or affected by \c statement
+   void recordRows(QString const & statement, qint64 const numRows);
+
+   /**
+    * \brief Threshold above which a single execution is logged as slow.  A negative value turns off slow-query logging
+    *        (but not the collection of statistics).
+    */
+   int slowQueryThreshold_ms();
+   void setSlowQueryThreshold_ms(int const threshold_ms);
+
+   //! \brief Read \c slowQueryThreshold_ms from \c PersistentSettings
+   void loadSettings();
+
+   //! \return Current statistics for all statements, most total time first
+   std::vector<StatementStats> snapshot();
+
+   //! \brief Discard all statistics collected so far
+   void reset();
+
+   /**
+    * \brief Write a human-readable table of \c snapshot() to \c stream
+    *
+    * \param maxStatements If positive, only output this many statements (the ones with the most total time)
+    */
+   void writeReport(QTextStream & stream, int const maxStatements = -1);
+
+   //! \brief Write the report to the log (done at shutdown)
+   void logReport();
+}
+
+#endif
@@ -0,0 +1,385 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SearchIndex.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/SearchIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include <QDebug>
+#include <QHash>
+#include <QStringList>
+#include <QTimer>
+
+#include "database/ObjectStore.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "model/Boil.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Fermentation.h"
+#include "model/Hop.h"
+#include "model/Mash.h"
+#include "model/Misc.h"
+#include "model/NamedEntity.h"
+#include "model/Recipe.h"
+#include "model/Salt.h"
+#include "model/Style.h"
+#include "model/Water.h"
+#include "model/Yeast.h"
+
+namespace {
+   //
+   // Standard BM25 tuning parameters -- see https://en.wikipedia.org/wiki/Okapi_BM25
+   //
+   double constexpr bm25_k1 = 1.2;
+   double constexpr bm25_b  = 0.75;
+
+   //
+   // Weights for the different fields.  A match in the name is what the user is usually looking for, so it counts
+   // for most.
+   //
+   float constexpr weightName        = 3.0f;
+   float constexpr weightDescriptive = 1.5f; // Short descriptive fields such as Hop substitutes or Style aroma
+   float constexpr weightNotes       = 1.0f;
+
+   /**
+    * \brief Which properties to index for each class.  Only the classes for which \c SearchIndex::instance is
+    *        instantiated below need to specialise this.
+    */
+   template<class NE> QVector<SearchIndex::Field> searchFields();
+   template<> QVector<SearchIndex::Field> searchFields<Boil>() {
+      return {{&PropertyNames::NamedEntity::name, weightName       },
+              {&PropertyNames::Boil::description, weightDescriptive},
+              {&PropertyNames::Boil::notes      , weightNotes      }};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Equipment>() {
+      return {{&PropertyNames::NamedEntity::name, weightName}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Fermentable>() {
+      return {{&PropertyNames::NamedEntity::name , weightName },
+              {&PropertyNames::Fermentable::notes, weightNotes}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Fermentation>() {
+      return {{&PropertyNames::NamedEntity::name        , weightName       },
+              {&PropertyNames::Fermentation::description, weightDescriptive},
+              {&PropertyNames::Fermentation::notes      , weightNotes      }};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Hop>() {
+      return {{&PropertyNames::NamedEntity::name, weightName       },
+              {&PropertyNames::Hop::substitutes , weightDescriptive},
+              {&PropertyNames::Hop::notes       , weightNotes      }};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Mash>() {
+      return {{&PropertyNames::NamedEntity::name, weightName },
+              {&PropertyNames::Mash::notes      , weightNotes}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Misc>() {
+      return {{&PropertyNames::NamedEntity::name, weightName },
+              {&PropertyNames::Misc::notes      , weightNotes}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Recipe>() {
+      return {{&PropertyNames::NamedEntity::name, weightName },
+              {&PropertyNames::Recipe::tasteNotes, weightNotes},
+              {&PropertyNames::Recipe::notes     , weightNotes}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Salt>() {
+      return {{&PropertyNames::NamedEntity::name, weightName}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Style>() {
+      return {{&PropertyNames::NamedEntity::name, weightName       },
+              {&PropertyNames::Style::aroma     , weightDescriptive},
+              {&PropertyNames::Style::flavor    , weightDescriptive},
+              {&PropertyNames::Style::notes     , weightNotes      }};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Water>() {
+      return {{&PropertyNames::NamedEntity::name, weightName },
+              {&PropertyNames::Water::notes     , weightNotes}};
+   }
+   template<> QVector<SearchIndex::Field> searchFields<Yeast>() {
+      return {{&PropertyNames::NamedEntity::name, weightName       },
+              {&PropertyNames::Yeast::bestFor   , weightDescriptive},
+              {&PropertyNames::Yeast::notes     , weightNotes      }};
+   }
+}
+
+// This private implementation class holds all private non-virtual members of SearchIndex
+class SearchIndex::impl {
+public:
+   impl(QVector<Field> const & fields) :
+      m_fields{fields},
+      m_postings{},
+      m_documents{},
+      m_documentLengths{},
+      m_totalLength{0.0},
+      m_updatedTimer{} {
+      // Zero interval means the timer fires once control returns to the event loop -- see SearchIndex::updated
+      this->m_updatedTimer.setSingleShot(true);
+      this->m_updatedTimer.setInterval(0);
+      return;
+   }
+
+   ~impl() = default;
+
+   bool isIndexed(BtStringConst const & propertyName) const {
+      return std::any_of(
+         this->m_fields.begin(),
+         this->m_fields.end(),
+         [&propertyName](Field const & field) { return *field.propertyName == propertyName; }
+      );
+   }
+
+   void addObject(int const key, QObject const & object) {
+      QHash<QString, float> termFrequencies;
+      float length = 0.0f;
+      for (auto const & field : this->m_fields) {
+         for (QString const & term : SearchIndex::terms(object.property(**field.propertyName).toString())) {
+            termFrequencies[term] += field.weight;
+            length += field.weight;
+         }
+      }
+      // NB: QHash::asKeyValueRange() needs Qt 6.4, so we use iterators
+      for (auto termFrequency = termFrequencies.cbegin(); termFrequency != termFrequencies.cend(); ++termFrequency) {
+         this->m_postings[termFrequency.key()].insert(key, termFrequency.value());
+      }
+      this->m_documents.insert(key, std::move(termFrequencies));
+      this->m_documentLengths.insert(key, length);
+      this->m_totalLength += length;
+      return;
+   }
+
+   void removeObject(int const key) {
+      auto document = this->m_documents.find(key);
+      if (document == this->m_documents.end()) {
+         return;
+      }
+      for (QString const & term : document->keys()) {
+         auto posting = this->m_postings.find(term);
+         if (posting != this->m_postings.end()) {
+            posting->second.remove(key);
+            if (posting->second.isEmpty()) {
+               this->m_postings.erase(posting);
+            }
+         }
+      }
+      this->m_documents.erase(document);
+      this->m_totalLength -= this->m_documentLengths.take(key);
+      return;
+   }
+
+   void updateObject(int const key, QObject const & object) {
+      this->removeObject(key);
+      this->addObject(key, object);
+      return;
+   }
+
+   /**
+    * \brief Score every object that has a term starting with \c queryTerm.  If an object has several such terms, we
+    *        take the best one.
+    */
+   QHash<int, double> scoreTerm(QString const & queryTerm, double const averageLength) const {
+      double const numDocuments = static_cast<double>(this->m_documents.size());
+      QHash<int, double> scores;
+      for (auto posting = this->m_postings.lower_bound(queryTerm);
+           posting != this->m_postings.end() && posting->first.startsWith(queryTerm);
+           ++posting) {
+         double const documentFrequency = static_cast<double>(posting->second.size());
+         double const idf = std::log(1.0 + (numDocuments - documentFrequency + 0.5) / (documentFrequency + 0.5));
+         for (auto match = posting->second.cbegin(); match != posting->second.cend(); ++match) {
+            double const frequency = match.value();
+            double const length = this->m_documentLengths.value(match.key());
+            double const score = idf * (frequency * (bm25_k1 + 1.0)) /
+                                 (frequency + bm25_k1 * (1.0 - bm25_b + bm25_b * length / averageLength));
+            double & best = scores[match.key()];
+            best = std::max(best, score);
+         }
+      }
+      return scores;
+   }
+
+   /**
+    * \return Scores for all objects matching every term in \c query, or \c std::nullopt if \c query has no terms
+    */
+   std::optional<QHash<int, double>> score(QString const & query) const {
+      QStringList const queryTerms = SearchIndex::terms(query);
+      if (queryTerms.isEmpty()) {
+         return std::nullopt;
+      }
+      QHash<int, double> scores;
+      if (this->m_documents.isEmpty()) {
+         return scores;
+      }
+      double const averageLength = std::max(this->m_totalLength / this->m_documents.size(), 1.0);
+      for (qsizetype ii = 0; ii < queryTerms.size(); ++ii) {
+         QHash<int, double> const termScores = this->scoreTerm(queryTerms.at(ii), averageLength);
+         if (ii == 0) {
+            scores = termScores;
+            continue;
+         }
+         // Every term has to match, so we only keep objects that match all the terms so far
+         for (auto result = scores.begin(); result != scores.end(); ) {
+            auto termScore = termScores.find(result.key());
+            if (termScore == termScores.end()) {
+               result = scores.erase(result);
+            } else {
+               result.value() += termScore.value();
+               ++result;
+            }
+         }
+         if (scores.isEmpty()) {
+            break;
+         }
+      }
+      return scores;
+   }
+
+   QVector<Field> const m_fields;
+   // Term -> (object key -> weighted frequency of term in object).  We need an ordered map for prefix searches.
+   std::map<QString, QHash<int, float>> m_postings;
+   // Object key -> (term -> weighted frequency), so we can remove an object's postings when it changes
+   QHash<int, QHash<QString, float>> m_documents;
+   QHash<int, float> m_documentLengths;
+   double m_totalLength;
+   //! Used to coalesce a burst of changes into one \c SearchIndex::updated signal
+   QTimer m_updatedTimer;
+};
+
+SearchIndex::SearchIndex(ObjectStore const & objectStore, QVector<Field> const & fields) :
+   QObject{},
+   pimpl{std::make_unique<impl>(fields)} {
+
+   for (auto const & object : objectStore.getAll()) {
+      auto namedEntity = qobject_cast<NamedEntity const *>(object.get());
+      if (namedEntity) {
+         this->pimpl->addObject(namedEntity->key(), *namedEntity);
+      }
+   }
+   qCDebug(logDb) <<
+      Q_FUNC_INFO << "Indexed" << this->pimpl->m_documents.size() << "objects from" << objectStore.name() << "with" <<
+      this->pimpl->m_postings.size() << "terms";
+
+   connect(&this->pimpl->m_updatedTimer, &QTimer::timeout, this, &SearchIndex::updated);
+   auto reindexObject = [this, &objectStore](int id) {
+      auto object = objectStore.getById(id);
+      if (object) {
+         this->pimpl->updateObject(id, *object);
+         this->pimpl->m_updatedTimer.start();
+      }
+   };
+   connect(&objectStore, &ObjectStore::signalObjectInserted, this, reindexObject);
+   connect(&objectStore, &ObjectStore::signalPropertyChanged, this,
+           [this, reindexObject](int id, BtStringConst const & propertyName) {
+      if (this->pimpl->isIndexed(propertyName)) {
+         reindexObject(id);
+      }
+   });
+   // A whole-object update doesn't tell us what changed, so we have to assume it might be something we index
+   connect(&objectStore, &ObjectStore::signalObjectUpdated, this, reindexObject);
+   connect(&objectStore, &ObjectStore::signalObjectDeleted, this,
+           [this](int id, [[maybe_unused]] std::shared_ptr<QObject> object) {
+      this->pimpl->removeObject(id);
+      this->pimpl->m_updatedTimer.start();
+   });
+   return;
+}
+
+SearchIndex::~SearchIndex() = default;
+
+template<class NE> SearchIndex & SearchIndex::instance() {
+   // As of C++11, initialisation of function-local statics is thread-safe
+   static SearchIndex searchIndex{ObjectStoreTyped<NE>::getInstance(), searchFields<NE>()};
+   return searchIndex;
+}
+
+QVector<SearchIndex::Result> SearchIndex::search(QString const & query, int const maxResults) const {
+   QVector<Result> results;
+   std::optional<QHash<int, double>> const scores = this->pimpl->score(query);
+   if (!scores) {
+      return results;
+   }
+   results.reserve(scores->size());
+   for (auto score = scores->cbegin(); score != scores->cend(); ++score) {
+      results.append(Result{score.key(), score.value()});
+   }
+   // Best score first; for equal scores, use key order so results are stable
+   auto const isBetter = [](Result const & lhs, Result const & rhs) {
+      return lhs.score > rhs.score || (lhs.score == rhs.score && lhs.key < rhs.key);
+   };
+   if (maxResults > 0 && maxResults < results.size()) {
+      std::partial_sort(results.begin(), results.begin() + maxResults, results.end(), isBetter);
+      results.resize(maxResults);
+   } else {
+      std::sort(results.begin(), results.end(), isBetter);
+   }
+   return results;
+}
+
+std::optional<QSet<int>> SearchIndex::matchingKeys(QString const & query) const {
+   std::optional<QHash<int, double>> const scores = this->pimpl->score(query);
+   if (!scores) {
+      return std::nullopt;
+   }
+   QSet<int> keys;
+   keys.reserve(scores->size());
+   for (auto score = scores->cbegin(); score != scores->cend(); ++score) {
+      keys.insert(score.key());
+   }
+   return keys;
+}
+
+int SearchIndex::size() const {
+   return static_cast<int>(this->pimpl->m_documents.size());
+}
+
+QStringList SearchIndex::terms(QString const & text) {
+   QStringList result;
+   // Compatibility decomposition splits, eg, "ü" into "u" followed by a combining diaeresis, which we then skip
+   QString const decomposed = text.normalized(QString::NormalizationForm_KD);
+   QString term;
+   for (QChar const ch : decomposed) {
+      if (ch.isMark()) {
+         continue;
+      }
+      if (ch.isLetterOrNumber()) {
+         term.append(ch.toCaseFolded());
+         continue;
+      }
+      if (!term.isEmpty()) {
+         result.append(term);
+         term.clear();
+      }
+   }
+   if (!term.isEmpty()) {
+      result.append(term);
+   }
+   return result;
+}
+
+//
+// Instantiate the above template function for the types that are going to use it
+//
+template SearchIndex & SearchIndex::instance<Boil        >();
+template SearchIndex & SearchIndex::instance<Equipment   >();
+template SearchIndex & SearchIndex::instance<Fermentable >();
+template SearchIndex & SearchIndex::instance<Fermentation>();
+template SearchIndex & SearchIndex::instance<Hop         >();
+template SearchIndex & SearchIndex::instance<Mash        >();
+template SearchIndex & SearchIndex::instance<Misc        >();
+template SearchIndex & SearchIndex::instance<Recipe      >();
+template SearchIndex & SearchIndex::instance<Salt        >();
+template SearchIndex & SearchIndex::instance<Style       >();
+template SearchIndex & SearchIndex::instance<Water       >();
+template SearchIndex & SearchIndex::instance<Yeast       >();
@@ -0,0 +1,124 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SearchIndex.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_SEARCHINDEX_H
+#define DATABASE_SEARCHINDEX_H
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+#include "utils/BtStringConst.h"
+
+class ObjectStore;
+
+/**
+ * \brief Full-text index over the text properties (name, notes, etc) of all objects of one type, with ranked search.
+ *
+ *        Previously, finding an item by text meant the sort/filter proxies doing a case-insensitive substring match on
+ *        the name of every row on every keystroke, and notes etc weren't searchable at all.  Instead, each
+ *        \c SearchIndex keeps an inverted index (term -> objects containing it) which it keeps up-to-date from the
+ *        \c ObjectStore signals for inserts, updates and deletes.  A search then only has to look at the
+ *        postings for the terms being searched for, which takes a few milliseconds even over 100,000 objects.
+ *
+ *        Since all objects are already held in memory by \c ObjectStore, we keep the index in memory too, rather than
+ *        in the DB (eg via SQLite FTS5 or PostgreSQL tsvector).  This means it works the same way on all the DBs we
+ *        support, needs no schema changes, and doesn't need a DB round trip on every keystroke.
+ *
+ *        Text is split into terms on anything that isn't a letter or a digit, and terms are case-folded with accents
+ *        removed, so "Mittelfruh" finds "Hallertauer Mittelfrüh".  Every term in a query must match (as a prefix, so
+ *        that search-as-you-type works) for an object to be returned.  Results are ranked using BM25, with matches in
+ *        the name weighted more highly than matches in, eg, notes.
+ *
+ *        Use \c SearchIndex::instance<NE>() to get the index for a given class.
+ */
+class SearchIndex : public QObject {
+   Q_OBJECT
+
+public:
+   //! \brief A text property to index, and how much a match in it counts for relative to other properties
+   struct Field {
+      BtStringConst const * propertyName;
+      float weight;
+   };
+
+   struct Result {
+      int key;
+      double score;
+   };
+
+   /**
+    * \brief Constructs the index from all the objects currently in \c objectStore, and connects to its signals to keep
+    *        it up-to-date.  Normally, you want \c instance() rather than calling this directly.
+    */
+   SearchIndex(ObjectStore const & objectStore, QVector<Field> const & fields);
+   ~SearchIndex();
+
+   /**
+    * \brief Get the index for the objects of class \c NE.  (It is created, from everything in the \c ObjectStore, on
+    *        first use.)
+    */
+   template<class NE> static SearchIndex & instance();
+
+   /**
+    * \brief Search the index
+    *
+    * \param query Free text, eg "citrus pine"
+    * \param maxResults If positive, only this many of the best results are returned
+    *
+    * \return Keys of matching objects, best match first
+    */
+   QVector<Result> search(QString const & query, int const maxResults = -1) const;
+
+   /**
+    * \brief Convenience function for filters, where order does not matter
+    *
+    * \return \c std::nullopt if \c query contains no searchable terms (eg is blank), so everything should be shown;
+    *         otherwise the keys of all matching objects
+    */
+   std::optional<QSet<int>> matchingKeys(QString const & query) const;
+
+   //! \return The number of objects in the index
+   int size() const;
+
+   /**
+    * \brief Split some text into the terms we index.  This is exposed mostly for testing.
+    */
+   static QStringList terms(QString const & text);
+
+signals:
+   /**
+    * \brief Emitted when objects have been added to, changed in or removed from the index, so that anything holding
+    *        the results of an earlier search (eg a filter) can re-run it.  A burst of changes (eg an import) results
+    *        in one signal, once control returns to the event loop.
+    */
+   void updated();
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   SearchIndex(SearchIndex const &) = delete;
+   SearchIndex & operator=(SearchIndex const &) = delete;
+   SearchIndex(SearchIndex &&) = delete;
+   SearchIndex & operator=(SearchIndex &&) = delete;
+};
+
+#endif
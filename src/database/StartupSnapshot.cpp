@@ -0,0 +1,346 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/StartupSnapshot.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/StartupSnapshot.h"
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QSaveFile>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QStringList>
+
+#include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/Database.h"
+#include "database/DatabaseSchemaHelper.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "PersistentSettings.h"
+
+namespace {
+   //! First thing in the file, so we can reject anything that isn't a snapshot.  ("BTSS" in ASCII.)
+   quint32 constexpr snapshotMagic = 0x42545353;
+
+   //! Increment this if the layout of the file changes
+   quint32 constexpr snapshotFormatVersion = 1;
+
+   bool isEnabled() {
+      return PersistentSettings::value(PersistentSettings::Names::dbStartupSnapshot, true).toBool();
+   }
+
+   /**
+    * \brief For SQLite, the snapshot lives next to the DB file.  For PostgreSQL, it goes in the user data directory
+    *        (and, because the fingerprint includes the connection details, we'll spot if it's for a different DB).
+    */
+   QString snapshotFilePath(Database const & database, QSqlDatabase const & connection) {
+      if (database.dbType() == Database::DbType::SQLITE) {
+         return QString{"%1.snapshot"}.arg(connection.databaseName());
+      }
+      return PersistentSettings::getUserDataDir().filePath("pgsql.snapshot");
+   }
+
+   /**
+    * \brief On PostgreSQL, there's no DB file to look at, so we instead ask the server, for each table that has a row
+    *        version column (ie each \c ObjectStore primary table), the number of rows, the highest primary key and the
+    *        total of the row versions.  Every update through an \c ObjectStore (of this or any other client) increments
+    *        a row version, every insert gets a higher primary key than any before it, and every delete reduces the row
+    *        count.  So between them they change whenever the table's contents do, even if an insert and a delete
+    *        happen in the same session.
+    *
+    *        NB: We can't ask the object stores for their table names here because we're called from Database::load(),
+    *            which is before they are created, so we get them from the DB's own catalogue instead.
+    *
+    * \return \c false if there was an error
+    */
+   bool appendTableFingerprints(QSqlDatabase & connection, QStringList & parts) {
+      // Column names here need to match rowVersionColumn and the primary key column in ObjectStore.cpp
+      QStringList tableNames;
+      {
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(
+            "SELECT table_name FROM information_schema.columns "
+            "WHERE table_schema = current_schema() AND column_name = 'row_version' "
+            "ORDER BY table_name;"
+         );
+         if (!sqlQuery.exec()) {
+            qWarning() << Q_FUNC_INFO << "Error reading table names:" << sqlQuery.lastError().text();
+            return false;
+         }
+         while (sqlQuery.next()) {
+            tableNames << sqlQuery.value(0).toString();
+         }
+      }
+      if (tableNames.isEmpty()) {
+         qWarning() << Q_FUNC_INFO << "No tables with row versions";
+         return false;
+      }
+
+      // One round trip to the server for all the tables
+      QStringList selects;
+      for (QString const & tableName : tableNames) {
+         selects << QString{"SELECT COUNT(*), MAX(id), SUM(row_version) FROM %1"}.arg(tableName);
+      }
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(selects.join(" UNION ALL ") + ";");
+      if (!sqlQuery.exec()) {
+         qWarning() << Q_FUNC_INFO << "Error reading table statistics:" << sqlQuery.lastError().text();
+         return false;
+      }
+      for (QString const & tableName : tableNames) {
+         if (!sqlQuery.next()) {
+            qWarning() << Q_FUNC_INFO << "Missing statistics for" << tableName;
+            return false;
+         }
+         parts << QString{"%1:%2:%3:%4"}.arg(tableName,
+                                             sqlQuery.value(0).toString(),
+                                             sqlQuery.value(1).toString(),
+                                             sqlQuery.value(2).toString());
+      }
+      return true;
+   }
+
+   /**
+    * \brief Something that will change if the DB contents (or the way we read them) might have changed.  See class
+    *        comment in header for more details.
+    *
+    * \return Empty string if we could not work out the fingerprint
+    */
+   QString fingerprint(Database const & database, QSqlDatabase & connection) {
+      QStringList parts{CONFIG_VERSION_STRING, QString::number(DatabaseSchemaHelper::latestVersion)};
+      if (database.dbType() == Database::DbType::SQLITE) {
+         QFileInfo const dbFileInfo{connection.databaseName()};
+         parts << dbFileInfo.absoluteFilePath() <<
+                  QString::number(dbFileInfo.size()) <<
+                  QString::number(dbFileInfo.lastModified().toMSecsSinceEpoch());
+      } else {
+         parts << connection.hostName() <<
+                  QString::number(connection.port()) <<
+                  connection.databaseName();
+         if (!appendTableFingerprints(connection, parts)) {
+            return QString{};
+         }
+      }
+      return parts.join('|');
+   }
+}
+
+// This private implementation class holds all private non-virtual members of StartupSnapshot
+class StartupSnapshot::impl {
+public:
+   impl() :
+      m_file{},
+      m_data{nullptr},
+      m_tables{} {
+      return;
+   }
+
+   ~impl() = default;
+
+   /**
+    * \brief Unmap, close and delete the snapshot file.  We delete it because we only want to use a given snapshot
+    *        once, and, if it's unusable, there's no point keeping it.
+    */
+   void discard() {
+      if (this->m_data) {
+         this->m_file.unmap(this->m_data);
+         this->m_data = nullptr;
+      }
+      this->m_tables.clear();
+      if (this->m_file.isOpen()) {
+         this->m_file.close();
+      }
+      if (!this->m_file.fileName().isEmpty() && this->m_file.exists() && !this->m_file.remove()) {
+         qWarning() << Q_FUNC_INFO << "Unable to remove" << this->m_file.fileName() << ":" << this->m_file.errorString();
+      }
+      return;
+   }
+
+   QFile m_file;
+   uchar * m_data;
+   //! For each table, the offset and length of its data in the file
+   QHash<QString, QPair<qint64, qint64>> m_tables;
+};
+
+StartupSnapshot::StartupSnapshot() : pimpl{std::make_unique<impl>()} {
+   return;
+}
+
+StartupSnapshot::~StartupSnapshot() = default;
+
+StartupSnapshot & StartupSnapshot::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static StartupSnapshot startupSnapshot;
+   return startupSnapshot;
+}
+
+bool StartupSnapshot::open(Database & database) {
+   this->close();
+   if (!isEnabled()) {
+      return false;
+   }
+
+   QSqlDatabase connection = database.sqlDatabase();
+   QString const filePath = snapshotFilePath(database, connection);
+   if (!QFile::exists(filePath)) {
+      qInfo() << Q_FUNC_INFO << "No snapshot at" << filePath;
+      return false;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+   QFile & file = this->pimpl->m_file;
+   file.setFileName(filePath);
+   if (!file.open(QIODevice::ReadOnly)) {
+      qWarning() << Q_FUNC_INFO << "Unable to open" << filePath << ":" << file.errorString();
+      this->pimpl->discard();
+      return false;
+   }
+   qint64 const fileSize = file.size();
+   uchar * data = file.map(0, fileSize);
+   if (!data) {
+      qWarning() << Q_FUNC_INFO << "Unable to map" << filePath << ":" << file.errorString();
+      this->pimpl->discard();
+      return false;
+   }
+   this->pimpl->m_data = data;
+
+   // This doesn't copy anything -- it's just a way of reading the mapped file with QDataStream
+   QByteArray const mappedFile = QByteArray::fromRawData(reinterpret_cast<char const *>(data), fileSize);
+   QDataStream in{mappedFile};
+   in.setVersion(StartupSnapshot::dataStreamVersion);
+
+   quint32 magic = 0;
+   quint32 formatVersion = 0;
+   QString snapshotFingerprint;
+   in >> magic >> formatVersion >> snapshotFingerprint;
+   if (in.status() != QDataStream::Ok || magic != snapshotMagic || formatVersion != snapshotFormatVersion) {
+      qWarning() << Q_FUNC_INFO << "Ignoring" << filePath << "as it is not a snapshot we can read";
+      this->pimpl->discard();
+      return false;
+   }
+   QString const currentFingerprint = fingerprint(database, connection);
+   if (currentFingerprint.isEmpty() || snapshotFingerprint != currentFingerprint) {
+      qInfo() <<
+         Q_FUNC_INFO << "Ignoring snapshot" << filePath << "as DB has changed (snapshot fingerprint" <<
+         snapshotFingerprint << "; current fingerprint" << currentFingerprint << ")";
+      this->pimpl->discard();
+      return false;
+   }
+
+   //
+   // Each table is its name followed by its data (as a QByteArray, ie a 32-bit length and then the bytes).  A null
+   // name marks the end.  We just note where each table's data is: ObjectStore::loadFromSnapshot does the actual
+   // reading.
+   //
+   for (;;) {
+      QString tableName;
+      in >> tableName;
+      if (tableName.isEmpty()) {
+         break;
+      }
+      quint32 length = 0;
+      in >> length;
+      qint64 const offset = in.device()->pos();
+      if (in.status() != QDataStream::Ok || in.skipRawData(static_cast<int>(length)) != static_cast<int>(length)) {
+         qWarning() << Q_FUNC_INFO << "Ignoring snapshot" << filePath << "as data for" << tableName << "is truncated";
+         this->pimpl->discard();
+         return false;
+      }
+      this->pimpl->m_tables.insert(tableName, {offset, static_cast<qint64>(length)});
+   }
+   if (in.status() != QDataStream::Ok) {
+      qWarning() << Q_FUNC_INFO << "Ignoring snapshot" << filePath << "as it is truncated";
+      this->pimpl->discard();
+      return false;
+   }
+
+   qInfo() <<
+      Q_FUNC_INFO << "Using snapshot" << filePath << "(" << fileSize << "bytes," << this->pimpl->m_tables.size() <<
+      "tables) - opened in" << timer.elapsed() << "ms";
+   return true;
+}
+
+bool StartupSnapshot::isOpen() const {
+   return this->pimpl->m_data != nullptr;
+}
+
+QByteArray StartupSnapshot::tableData(QString const & tableName) const {
+   if (!this->pimpl->m_data || !this->pimpl->m_tables.contains(tableName)) {
+      return QByteArray{};
+   }
+   auto const [offset, length] = this->pimpl->m_tables.value(tableName);
+   return QByteArray::fromRawData(reinterpret_cast<char const *>(this->pimpl->m_data) + offset, length);
+}
+
+void StartupSnapshot::close() {
+   if (this->isOpen()) {
+      this->pimpl->discard();
+   }
+   return;
+}
+
+bool StartupSnapshot::save(Database & database) {
+   if (!isEnabled()) {
+      return false;
+   }
+
+   QElapsedTimer timer;
+   timer.start();
+   QSqlDatabase connection = database.sqlDatabase();
+   QString const filePath = snapshotFilePath(database, connection);
+   QString const currentFingerprint = fingerprint(database, connection);
+   if (currentFingerprint.isEmpty()) {
+      return false;
+   }
+
+   // Using QSaveFile means we never leave a half-written snapshot behind
+   QSaveFile file{filePath};
+   if (!file.open(QIODevice::WriteOnly)) {
+      qWarning() << Q_FUNC_INFO << "Unable to open" << filePath << "for writing:" << file.errorString();
+      return false;
+   }
+   QDataStream out{&file};
+   out.setVersion(StartupSnapshot::dataStreamVersion);
+   out << snapshotMagic << snapshotFormatVersion << currentFingerprint;
+
+   bool const succeeded = SnapshotAllObjectStores(
+      connection,
+      [&out](QString const & tableName, QByteArray const & tableData) {
+         out << tableName << tableData;
+         return out.status() == QDataStream::Ok;
+      }
+   );
+   if (!succeeded) {
+      file.cancelWriting();
+      return false;
+   }
+   // End marker
+   out << QString{};
+
+   if (out.status() != QDataStream::Ok || !file.commit()) {
+      qWarning() << Q_FUNC_INFO << "Error writing" << filePath << ":" << file.errorString();
+      return false;
+   }
+
+   qInfo() <<
+      Q_FUNC_INFO << "Wrote snapshot" << filePath << "(" << QFileInfo{filePath}.size() << "bytes) in" <<
+      timer.elapsed() << "ms";
+   return true;
+}
@@ -0,0 +1,104 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/StartupSnapshot.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_STARTUPSNAPSHOT_H
+#define DATABASE_STARTUPSNAPSHOT_H
+#pragma once
+
+#include <memory>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QString>
+
+class Database;
+
+/**
+ * \brief Optional cache, written at clean shutdown, of the contents of all the \c ObjectStore tables, so that the next
+ *        start-up does not have to read them all from the DB.
+ *
+ *        Normally, every \c ObjectStore reads its whole table, via SQL, at start-up (see \c InitialiseAllObjectStores).
+ *        When the DB is closed, we instead (also) write each table's rows to a "snapshot" file next to the DB.  The file
+ *        is a compact binary format (each table being a \c QDataStream of the raw column values, in the order the
+ *        \c ObjectStore expects them) that we can memory-map, and it carries a fingerprint of the DB: for SQLite, the
+ *        size and modification time of the DB file; for PostgreSQL, the row count, highest primary key and total of
+ *        row versions (see \c ObjectStore) of each table, as reported by the server.  Both also include the schema
+ *        version and the program version.
+ *
+ *        When the DB is next opened, if the snapshot's fingerprint matches, each \c ObjectStore builds its objects
+ *        straight from the mapped data (see \c ObjectStore::loadFromSnapshot) rather than running its SELECT.  If it
+ *        doesn't match, or anything else is wrong with it, we just do the normal \c ObjectStore::loadAll.
+ *
+ *        The snapshot is deleted once start-up has finished with it, so that, if we then crash, it cannot be used
+ *        again.  Caching can be turned off with the \c dbStartupSnapshot setting.
+ *
+ *        NB: On PostgreSQL, the fingerprint notices all changes made through an \c ObjectStore (of this or another
+ *            client), but not an update made by some other means that leaves the row version alone.
+ */
+class StartupSnapshot {
+public:
+   //! The \c QDataStream format we use for reading and writing snapshots
+   static QDataStream::Version constexpr dataStreamVersion = QDataStream::Qt_6_2;
+
+   static StartupSnapshot & instance();
+
+   /**
+    * \brief Called once the DB is open (and its schema up-to-date).  If there is a snapshot for it, and the snapshot's
+    *        fingerprint matches, map the snapshot into memory for \c ObjectStore::loadAll to use.
+    *
+    * \return \c true if there is a usable snapshot, \c false otherwise
+    */
+   bool open(Database & database);
+
+   bool isOpen() const;
+
+   /**
+    * \brief The data for one table in the open snapshot.  This refers directly to the mapped file, so it is only valid
+    *        until \c close() is called.
+    *
+    * \return Empty array if there is no snapshot open, or it has nothing for \c tableName
+    */
+   QByteArray tableData(QString const & tableName) const;
+
+   /**
+    * \brief Unmap and delete the snapshot file.  Called once all the \c ObjectStore objects are loaded.  Does nothing
+    *        if there is no snapshot open.
+    */
+   void close();
+
+   /**
+    * \brief Write a new snapshot of all the \c ObjectStore tables.  Called when the DB is being closed, after all
+    *        pending writes are done, but before the connections are closed.  Does nothing if the object stores were not
+    *        all loaded or if caching is turned off.
+    *
+    * \return \c true if the snapshot was written, \c false otherwise
+    */
+   bool save(Database & database);
+
+private:
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   StartupSnapshot();
+   ~StartupSnapshot();
+
+   // Singleton shouldn't be getting copied or moved
+   StartupSnapshot(StartupSnapshot const &) = delete;
+   StartupSnapshot & operator=(StartupSnapshot const &) = delete;
+   StartupSnapshot(StartupSnapshot &&) = delete;
+   StartupSnapshot & operator=(StartupSnapshot &&) = delete;
+};
+
+#endif
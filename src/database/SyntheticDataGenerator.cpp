@@ -0,0 +1,405 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SyntheticDataGenerator.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "database/SyntheticDataGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include <QDate>
+#include <QDebug>
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreWrapper.h"
+#include "model/BrewNote.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "model/RecipeAdditionMisc.h"
+#include "model/RecipeAdditionYeast.h"
+#include "model/Yeast.h"
+
+namespace {
+   //! \brief Number of distinct equipment setups that recipes are spread across
+   int const numEquipments = 10;
+
+   //! \brief All brew dates are within 10 years of this (rather than of today, so that we're reproducible)
+   QDate const firstBrewDate{2015, 1, 1};
+
+   /**
+    * \brief Does the actual work for \c SyntheticDataGenerator::generate.  Everything random goes through
+    *        \c m_random, and we always ask it for values in the same order, which is what makes the output reproducible.
+    */
+   class Generator {
+   public:
+      Generator(SyntheticDataGenerator::Parameters const & parameters) :
+         m_parameters{parameters},
+         m_random{parameters.seed},
+         m_folderPaths{},
+         m_hops{},
+         m_fermentables{},
+         m_miscs{},
+         m_yeasts{},
+         m_equipments{},
+         m_numRecipes{0},
+         m_numAncestors{0},
+         m_numBrewNotes{0},
+         m_error{} {
+         return;
+      }
+
+      /**
+       * \brief Insert \c object in the database, noting in \c m_error if that fails
+       *
+       * \return \c true if succeeded, \c false otherwise
+       */
+      template<class NE>
+      bool insert(std::shared_ptr<NE> object) {
+         ObjectStoreWrapper::insert(object);
+         return this->checkInserted(*object);
+      }
+
+      /**
+       * \brief Check that \c object, which should have just been inserted (either by us or, eg, by \c Recipe::addAddition)
+       *        got a valid ID, noting in \c m_error if it did not
+       *
+       * \return \c true if succeeded, \c false otherwise
+       */
+      bool checkInserted(NamedEntity const & object) {
+         if (object.key() > 0) {
+            return true;
+         }
+         this->m_error = QString{"Unable to insert %1 \"%2\" in the database"}.arg(
+            object.metaObject()->className()
+         ).arg(object.name());
+         qCritical() << Q_FUNC_INFO << this->m_error;
+         return false;
+      }
+
+      //! \return Random value in the range [min, max)
+      double uniform(double const min, double const max) {
+         return min + (max - min) * this->m_random.generateDouble();
+      }
+
+      //! \return Random value in the range [min, max]
+      int between(int const min, int const max) {
+         return static_cast<int>(this->m_random.bounded(min, max + 1));
+      }
+
+      //! \return Random value of the enum whose values are listed in \c mapping
+      template<typename E>
+      E pick(EnumStringMapping const & mapping) {
+         return static_cast<E>(mapping.at(this->m_random.bounded(static_cast<int>(mapping.size()))).native);
+      }
+
+      template<typename T>
+      T * pick(std::vector<std::shared_ptr<T>> const & items) {
+         return items.at(this->m_random.bounded(static_cast<quint32>(items.size()))).get();
+      }
+
+      /**
+       * \brief Fills \c m_folderPaths with every folder in a tree \c folderDepth deep where each folder has
+       *        \c foldersPerLevel sub-folders.  Note that this grows exponentially with depth, so we don't let the
+       *        caller go mad.
+       */
+      void makeFolderPaths() {
+         int const depth    = std::clamp(this->m_parameters.folderDepth    , 0, 8);
+         int const perLevel = std::clamp(this->m_parameters.foldersPerLevel, 1, 8);
+         QStringList currentLevel{"/Synthetic"};
+         this->m_folderPaths = currentLevel;
+         for (int level = 1; level <= depth; ++level) {
+            QStringList nextLevel;
+            for (QString const & parent : currentLevel) {
+               for (int ii = 0; ii < perLevel; ++ii) {
+                  nextLevel.append(QString{"%1/Level %2 Folder %3"}.arg(parent).arg(level).arg(ii));
+               }
+            }
+            this->m_folderPaths.append(nextLevel);
+            currentLevel = std::move(nextLevel);
+         }
+         return;
+      }
+
+      QString const & folderPath() {
+         return this->m_folderPaths.at(this->m_random.bounded(static_cast<int>(this->m_folderPaths.size())));
+      }
+
+      static QString itemName(char const * const type, int const number) {
+         return QString{"Synthetic %1 %2"}.arg(type).arg(number, 6, 10, QChar{'0'});
+      }
+
+      //! \return \c true if succeeded, \c false otherwise (in which case \c m_error says what went wrong)
+      bool makeIngredients() {
+         //
+         // Roughly the mix you'd expect to see in a big catalog.  We make sure there's at least one of each type so
+         // that we can always make recipes.
+         //
+         int const numIngredients  = std::max(4, this->m_parameters.numIngredients);
+         int const numHops         = std::max(1, numIngredients * 3 / 10);
+         int const numFermentables = std::max(1, numIngredients * 3 / 10);
+         int const numMiscs        = std::max(1, numIngredients * 2 / 10);
+         int const numYeasts       = std::max(1, numIngredients - numHops - numFermentables - numMiscs);
+
+         //
+         // Note that we set all the properties before inserting each object in the database, as otherwise each setter
+         // call would be a separate database update.
+         //
+         for (int ii = 0; ii < numHops; ++ii) {
+            auto hop = std::make_shared<Hop>(itemName("Hop", ii));
+            hop->setFolderPath(this->folderPath());
+            hop->setAlpha_pct(this->uniform(2.0, 18.0));
+            hop->setBeta_pct (this->uniform(2.0, 10.0));
+            hop->setForm(this->pick<Hop::Form>(Hop::formStringMapping));
+            hop->setType(this->pick<Hop::Type>(Hop::typeStringMapping));
+            if (!this->insert(hop)) {
+               return false;
+            }
+            this->m_hops.push_back(hop);
+         }
+
+         for (int ii = 0; ii < numFermentables; ++ii) {
+            auto fermentable = std::make_shared<Fermentable>(itemName("Fermentable", ii));
+            fermentable->setFolderPath(this->folderPath());
+            fermentable->setType(this->pick<Fermentable::Type>(Fermentable::typeStringMapping));
+            fermentable->setFineGrindYield_pct(this->uniform(60.0, 82.0));
+            // Most fermentables are pale, a few are very dark
+            fermentable->setColor_srm(1.5 + 500.0 * std::pow(this->m_random.generateDouble(), 4.0));
+            if (!this->insert(fermentable)) {
+               return false;
+            }
+            this->m_fermentables.push_back(fermentable);
+         }
+
+         for (int ii = 0; ii < numMiscs; ++ii) {
+            auto misc = std::make_shared<Misc>(itemName("Misc", ii));
+            misc->setFolderPath(this->folderPath());
+            misc->setType(this->pick<Misc::Type>(Misc::typeStringMapping));
+            if (!this->insert(misc)) {
+               return false;
+            }
+            this->m_miscs.push_back(misc);
+         }
+
+         for (int ii = 0; ii < numYeasts; ++ii) {
+            auto yeast = std::make_shared<Yeast>(itemName("Yeast", ii));
+            yeast->setFolderPath(this->folderPath());
+            yeast->setType(this->pick<Yeast::Type>(Yeast::typeStringMapping));
+            yeast->setForm(this->pick<Yeast::Form>(Yeast::formStringMapping));
+            double const attenuationMin_pct = this->uniform(65.0, 78.0);
+            yeast->setAttenuationMin_pct(attenuationMin_pct);
+            yeast->setAttenuationMax_pct(attenuationMin_pct + this->uniform(2.0, 8.0));
+            if (!this->insert(yeast)) {
+               return false;
+            }
+            this->m_yeasts.push_back(yeast);
+         }
+
+         for (int ii = 0; ii < numEquipments; ++ii) {
+            auto equipment = std::make_shared<Equipment>(itemName("Equipment", ii));
+            equipment->setFolderPath(this->folderPath());
+            double const batchSize_l = this->uniform(10.0, 100.0);
+            equipment->setFermenterBatchSize_l(batchSize_l);
+            equipment->setKettleBoilSize_l(batchSize_l * 1.25);
+            equipment->setMashTunVolume_l(batchSize_l * 2.0);
+            equipment->setKettleEvaporationPerHour_l(batchSize_l * 0.15);
+            equipment->setBoilTime_min(60);
+            if (!this->insert(equipment)) {
+               return false;
+            }
+            this->m_equipments.push_back(equipment);
+         }
+         return true;
+      }
+
+      /**
+       * \brief Make one version of a recipe, complete with additions and brew notes
+       *
+       * \return The recipe, or \c nullptr if something could not be inserted (in which case \c m_error says what)
+       */
+      std::shared_ptr<Recipe> makeRecipe(QString const & name, QString const & folderPath) {
+         auto recipe = std::make_shared<Recipe>(name);
+         recipe->setFolderPath(folderPath);
+         // Recipe::Type also covers cider, kombucha etc, but we want beer recipes
+         static Recipe::Type const beerTypes[] {
+            Recipe::Type::AllGrain, Recipe::Type::AllGrain, Recipe::Type::PartialMash, Recipe::Type::Extract
+         };
+         recipe->setType(beerTypes[this->m_random.bounded(static_cast<int>(std::size(beerTypes)))]);
+         auto equipment = this->m_equipments.at(this->m_random.bounded(numEquipments));
+         recipe->setEquipment(equipment);
+         recipe->setBatchSize_l(equipment->fermenterBatchSize_l());
+         // As with the ingredients, set everything we can before inserting.  Additions and brew notes need the recipe
+         // to have an ID, so they have to come afterwards.
+         if (!this->insert(recipe)) {
+            return nullptr;
+         }
+
+         for (int ii = this->between(2, 6); ii > 0; --ii) {
+            auto addition = std::make_shared<RecipeAdditionFermentable>(QString{"%1 fermentable %2"}.arg(name).arg(ii));
+            addition->setFermentable(this->pick(this->m_fermentables));
+            addition->setStage(RecipeAddition::Stage::Mash);
+            addition->setQuantity(this->uniform(0.1, 6.0));
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            recipe->addAddition(addition);
+            if (!this->checkInserted(*addition)) {
+               return nullptr;
+            }
+         }
+
+         for (int ii = this->between(1, 5); ii > 0; --ii) {
+            auto addition = std::make_shared<RecipeAdditionHop>(QString{"%1 hop %2"}.arg(name).arg(ii));
+            addition->setHop(this->pick(this->m_hops));
+            addition->setStage(RecipeAddition::Stage::Boil);
+            addition->setAddAtTime_mins(5 * this->between(0, 12));
+            addition->setQuantity(this->uniform(0.005, 0.1));
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            recipe->addAddition(addition);
+            if (!this->checkInserted(*addition)) {
+               return nullptr;
+            }
+         }
+
+         for (int ii = this->between(0, 2); ii > 0; --ii) {
+            auto addition = std::make_shared<RecipeAdditionMisc>(QString{"%1 misc %2"}.arg(name).arg(ii));
+            addition->setMisc(this->pick(this->m_miscs));
+            addition->setStage(RecipeAddition::Stage::Boil);
+            addition->setAddAtTime_mins(this->between(0, 15));
+            addition->setQuantity(this->uniform(0.001, 0.05));
+            addition->setMeasure(Measurement::PhysicalQuantity::Mass);
+            recipe->addAddition(addition);
+            if (!this->checkInserted(*addition)) {
+               return nullptr;
+            }
+         }
+
+         auto yeastAddition = std::make_shared<RecipeAdditionYeast>(QString{"%1 yeast"}.arg(name));
+         yeastAddition->setYeast(this->pick(this->m_yeasts));
+         yeastAddition->setStage(RecipeAddition::Stage::Fermentation);
+         yeastAddition->setQuantity(0.0115);
+         yeastAddition->setMeasure(Measurement::PhysicalQuantity::Mass);
+         recipe->addAddition(yeastAddition);
+         if (!this->checkInserted(*yeastAddition)) {
+            return nullptr;
+         }
+
+         for (int ii = this->between(0, std::max(0, this->m_parameters.maxBrewNotesPerRecipe)); ii > 0; --ii) {
+            auto brewNote = std::make_shared<BrewNote>(*recipe);
+            brewNote->setBrewDate(firstBrewDate.addDays(this->m_random.bounded(3650)));
+            brewNote->setOg(this->uniform(1.035, 1.090));
+            brewNote->setFg(this->uniform(1.005, 1.020));
+            if (!this->insert(brewNote)) {
+               return nullptr;
+            }
+            ++this->m_numBrewNotes;
+         }
+
+         ++this->m_numRecipes;
+         return recipe;
+      }
+
+      /**
+       * \brief Make recipes in "families" of versions, where each version has the previous one as its ancestor (as if
+       *        the user had edited a recipe with versioning turned on).
+       *
+       * \return \c true if succeeded, \c false otherwise (in which case \c m_error says what went wrong)
+       */
+      bool makeRecipes() {
+         int const maxVersions = std::max(1, this->m_parameters.maxVersionsPerRecipe);
+         int familyNumber = 0;
+         while (this->m_numRecipes < this->m_parameters.numRecipes) {
+            int const numVersions = std::min(this->between(1, maxVersions),
+                                             this->m_parameters.numRecipes - this->m_numRecipes);
+            QString const name = itemName("Recipe", familyNumber++);
+            QString const & recipeFolderPath = this->folderPath();
+            std::shared_ptr<Recipe> previousVersion;
+            for (int version = 0; version < numVersions; ++version) {
+               auto recipe = this->makeRecipe(name, recipeFolderPath);
+               if (!recipe) {
+                  return false;
+               }
+               if (previousVersion) {
+                  recipe->setAncestor(*previousVersion);
+                  ++this->m_numAncestors;
+               }
+               previousVersion = recipe;
+            }
+         }
+         return true;
+      }
+
+      SyntheticDataGenerator::Parameters const & m_parameters;
+      QRandomGenerator m_random;
+      QStringList m_folderPaths;
+      std::vector<std::shared_ptr<Hop        >> m_hops;
+      std::vector<std::shared_ptr<Fermentable>> m_fermentables;
+      std::vector<std::shared_ptr<Misc       >> m_miscs;
+      std::vector<std::shared_ptr<Yeast      >> m_yeasts;
+      std::vector<std::shared_ptr<Equipment  >> m_equipments;
+      int m_numRecipes;
+      int m_numAncestors;
+      int m_numBrewNotes;
+      //! \brief If something failed, what it was
+      QString m_error;
+   };
+}
+
+bool SyntheticDataGenerator::generate(Parameters const & parameters, QTextStream & message) {
+   if (parameters.numIngredients < 0 || parameters.numRecipes < 0) {
+      message << "Number of ingredients and recipes cannot be negative";
+      return false;
+   }
+
+   qInfo() <<
+      Q_FUNC_INFO << "Generating" << parameters.numIngredients << "ingredients and" << parameters.numRecipes <<
+      "recipes from seed" << parameters.seed;
+
+   Generator generator{parameters};
+   generator.makeFolderPaths();
+   bool succeeded = false;
+   {
+      // We're doing a very large number of inserts and updates, so we want them in one DB transaction
+      DbUnitOfWork unitOfWork{"Generate synthetic data"};
+      succeeded = generator.makeIngredients() && generator.makeRecipes();
+   }
+   if (!succeeded) {
+      //
+      // Per the comments on DbUnitOfWork, whatever we did manage to insert stays in the database, so we say how far we
+      // got as well as what went wrong.
+      //
+      message <<
+         generator.m_error << " (after creating " << generator.m_hops.size() + generator.m_fermentables.size() +
+         generator.m_miscs.size() + generator.m_yeasts.size() << " ingredient(s) and " << generator.m_numRecipes <<
+         " recipe(s))";
+      return false;
+   }
+
+   message <<
+      generator.m_hops.size() << " hop(s), " << generator.m_fermentables.size() << " fermentable(s), " <<
+      generator.m_miscs.size() << " misc(s), " << generator.m_yeasts.size() << " yeast(s), " <<
+      generator.m_equipments.size() << " equipment(s), " << generator.m_numRecipes << " recipe(s) (of which " <<
+      generator.m_numAncestors << " previous versions), " << generator.m_numBrewNotes << " brew note(s) in " <<
+      generator.m_folderPaths.size() << " folder(s), from seed " << parameters.seed;
+   return true;
+}
@@ -0,0 +1,66 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * database/SyntheticDataGenerator.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef DATABASE_SYNTHETICDATAGENERATOR_H
+#define DATABASE_SYNTHETICDATAGENERATOR_H
+#pragma once
+
+#include <QtGlobal>
+
+class QTextStream;
+
+/**
+ * \brief Generates large, realistic-looking, but entirely made-up, data sets so that we can test and benchmark how the
+ *        program scales (eg to tens of thousands of ingredients and recipes, with deep folder trees, multiple versions
+ *        of recipes and brew notes).
+ *
+ *        Objects are created via the normal model classes and \c ObjectStoreWrapper, so they end up in whatever
+ *        database the application is currently using.  To get BeerXML or BeerJSON files, export them afterwards via
+ *        \c ImportExport.  (Both of these are done from \c BatchRunner when run from the command line.)
+ *
+ *        Everything is derived from the supplied random seed, so the same \c Parameters always give the same data set.
+ *        (Database IDs can still differ, as they depend on what was in the database beforehand.)
+ */
+namespace SyntheticDataGenerator {
+
+   struct Parameters {
+      //! \brief Seed for the pseudo-random number generator
+      quint32 seed = 1;
+      //! \brief Total number of hops, fermentables, miscs and yeasts
+      int numIngredients = 50000;
+      //! \brief Total number of recipes, including previous versions (aka ancestors)
+      int numRecipes = 20000;
+      //! \brief Each recipe has between 1 and this many versions (ie a recipe plus up to this-minus-1 ancestors)
+      int maxVersionsPerRecipe = 4;
+      //! \brief Each recipe has between 0 and this many brew notes
+      int maxBrewNotesPerRecipe = 3;
+      //! \brief How deep the folder trees go
+      int folderDepth = 5;
+      //! \brief How many sub-folders each folder has
+      int foldersPerLevel = 4;
+   };
+
+   /**
+    * \brief Create a data set in the current database
+    *
+    * \param parameters
+    * \param message Summary of what was created, or, on failure, what went wrong
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool generate(Parameters const & parameters, QTextStream & message);
+}
+
+#endif
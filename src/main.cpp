@@ -21,6 +21,7 @@
 #include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
 
 #include <iostream>
+#include <memory>
 
 #include <xercesc/util/PlatformUtils.hpp>
 #include <xalanc/Include/PlatformDefinitions.hpp>
@@ -33,6 +34,7 @@
 #include <QSharedMemory>
 
 #include "Application.h"
+#include "BatchRunner.h"
 #include "config.h"
 #include "database/Database.h"
 #include "Localization.h"
@@ -67,6 +69,23 @@ namespace {
       exit(0);
    }
 
+   /**
+    * \brief Tell the user about an error that's going to stop the application.  In batch mode, there is no GUI, so we
+    *        just write to stderr.
+    */
+   void showFatalError(bool const batchMode, QString const & errorMessage) {
+      qCritical() << Q_FUNC_INFO << "Fatal error:" << errorMessage;
+      QString const message = errorMessage.isEmpty() ?
+         QCoreApplication::tr("The application encountered a fatal error.") :
+         QCoreApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(errorMessage);
+      if (batchMode) {
+         std::cerr << message.toStdString() << std::endl;
+         return;
+      }
+      QMessageBox::critical(nullptr, QApplication::tr("Application terminates"), message);
+      return;
+   }
+
    /**
     * \brief Uncaught exceptions in a Qt application will terminate the program with a generic error message that does
     *        not give as much info about the exception as we might like.  This small extension of Qt's \c QApplication
@@ -132,12 +151,21 @@ int main(int argc, char **argv) {
    // application name are set on the QApplication object, but omitting the call to setOrganizationName() takes out the
    // extra directory layer).
    //
-   ExceptionCatchingQApplication app(argc, argv);
-   app.setOrganizationDomain(CONFIG_ORGANIZATION_DOMAIN);
+   // In batch mode (see BatchRunner) we don't have, or want, a GUI, so there is no need for QApplication.  This means
+   // we can run on a machine with no display (eg from a cron job).
+   //
+   bool const batchMode = BatchRunner::isRequested(argc, argv);
+   std::unique_ptr<QCoreApplication> app;
+   if (batchMode) {
+      app = std::make_unique<QCoreApplication>(argc, argv);
+   } else {
+      app = std::make_unique<ExceptionCatchingQApplication>(argc, argv);
+   }
+   app->setOrganizationDomain(CONFIG_ORGANIZATION_DOMAIN);
    // We used to vary the application name (and therefore location of config files etc) depending on whether we're
    // building with debug or release version of Qt, but on the whole I don't think this is helpful
-   app.setApplicationName(CONFIG_APPLICATION_NAME_LC);
-   app.setApplicationVersion(CONFIG_VERSION_STRING);
+   app->setApplicationName(CONFIG_APPLICATION_NAME_LC);
+   app->setApplicationVersion(CONFIG_VERSION_STRING);
 
    // Process command-line options relatively early as some may override other settings
    QCommandLineParser parser;
@@ -160,9 +188,10 @@ int main(int argc, char **argv) {
       QString()
    };
    parser.addOption(userDirectoryOption);
+   BatchRunner::addCommandLineOptions(parser);
    parser.addHelpOption();
    parser.addVersionOption();
-   parser.process(app);
+   parser.process(*app);
 
    //
    // Having initialised various QApplication settings and read command line options, we can now allow Qt to work out
@@ -216,6 +245,11 @@ int main(int argc, char **argv) {
       sharedMemory.attach();
       sharedMemory.detach(); // This should delete the shared memory if no other process is using it
       if (!sharedMemory.create(1)) {
+         if (batchMode) {
+            // No-one to ask whether to carry on, so we have to assume not
+            std::cerr << "Another instance of " << CONFIG_APPLICATION_NAME_UC << " is already running" << std::endl;
+            return EXIT_FAILURE;
+         }
          enum QMessageBox::StandardButton buttonPressed =
             QMessageBox::warning(NULL,
                                  QApplication::tr("%1 is already running!").arg(CONFIG_APPLICATION_NAME_UC),
@@ -227,7 +261,7 @@ int main(int argc, char **argv) {
          if (buttonPressed == QMessageBox::Ok) {
             // We haven't yet called exec on QApplication, so I'm not sure we _need_ to call exit() here, but it
             // doesn't seem to hurt.
-            app.exit();
+            app->exit();
             return EXIT_SUCCESS;
          }
       }
@@ -239,7 +273,7 @@ int main(int argc, char **argv) {
    try {
       qInfo() <<
          "Starting" << CONFIG_APPLICATION_NAME_UC << "v" << CONFIG_VERSION_STRING << " (app name" <<
-         app.applicationName() << ") on " << QSysInfo::prettyProductName();
+         app->applicationName() << ") on " << QSysInfo::prettyProductName();
       qInfo() <<
          "Built at" << CONFIG_BUILD_TIMESTAMP << "on" << CONFIG_BUILD_SYSTEM << "for" << CONFIG_RUN_SYSTEM << "with" <<
          CONFIG_CXX_COMPILER_ID << "compiler";
@@ -253,7 +287,7 @@ int main(int argc, char **argv) {
 
       registerMetaTypes();
 
-      auto mainAppReturnValue = Application::run();
+      auto mainAppReturnValue = batchMode ? BatchRunner{parser}.run() : Application::run();
 
       //
       // Clean exit of Xerces XML tools
@@ -268,23 +302,14 @@ int main(int argc, char **argv) {
 
       return mainAppReturnValue;
    }
-   catch (const QString & error)
-   {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(error));
+   catch (const QString & error) {
+      showFatalError(batchMode, error);
    }
-   catch (std::exception & exception)
-   {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error.\nError message:\n%1").arg(exception.what()));
+   catch (std::exception & exception) {
+      showFatalError(batchMode, exception.what());
    }
-   catch (...)
-   {
-      QMessageBox::critical(0,
-            QApplication::tr("Application terminates"),
-            QApplication::tr("The application encountered a fatal error."));
+   catch (...) {
+      showFatalError(batchMode, "");
    }
    return EXIT_FAILURE;
 }
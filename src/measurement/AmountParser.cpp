@@ -0,0 +1,262 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * measurement/AmountParser.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "measurement/AmountParser.h"
+
+#include <mutex>
+#include <stdexcept>
+
+#include <QHash>
+#include <QRegularExpression>
+
+#include "Localization.h"
+#include "Logging.h"
+#include "measurement/Measurement.h"
+#include "measurement/Unit.h"
+#include "measurement/UnitSystem.h"
+#include "utils/CellDataCache.h"
+
+namespace {
+   //! Key for looking up a unit by physical quantity and lower-cased name
+   using QuantityAndName = std::pair<int, QString>;
+
+   /**
+    * \brief Of several units for the same \c PhysicalQuantity that have the same name (eg Imperial and US Customary
+    *        quarts), choose the one in the display unit system if there is one.  Otherwise, the last one, which, because
+    *        \c m_unitsByName lists the most recently constructed unit first, is the US Customary one where there is a
+    *        choice between that and Imperial.  (This is what \c Unit::getUnit did when it looked units up in a
+    *        \c QMultiMap.)
+    */
+   Measurement::Unit const * preferDisplayUnitSystem(QList<Measurement::Unit const *> const & matches) {
+      if (matches.isEmpty()) {
+         return nullptr;
+      }
+      if (matches.size() == 1) {
+         return matches.first();
+      }
+      auto const & displayUnitSystem = Measurement::getDisplayUnitSystem(matches.first()->getPhysicalQuantity());
+      for (auto const unit : matches) {
+         if (unit->getUnitSystem() == displayUnitSystem) {
+            return unit;
+         }
+      }
+      return matches.last();
+   }
+}
+
+// This private implementation class holds all private non-virtual members of AmountParser
+class Measurement::AmountParser::impl {
+public:
+
+   impl(unsigned int const generation) :
+      m_generation         {generation},
+      m_amountAndUnit      {},
+      m_amountAndWordUnit  {},
+      m_unitsByName        {},
+      m_preferredUnits     {} {
+      //
+      // For the numeric part (the quantity) we need to make sure we get the right decimal point (. or ,) and the right
+      // grouping separator (, or .).  Some locales write 1.000,10 and others write 1,000.10.  We need to catch both.
+      //
+      QLocale const & locale = Localization::getLocale();
+      QString const decimal  = QRegularExpression::escape(locale.decimalPoint());
+      QString const grouping = QRegularExpression::escape(locale.groupSeparator());
+      QString const number   = "((?:\\d+" + grouping + ")?\\d+(?:" + decimal + "\\d+)?|" + decimal + "\\d+)\\s*";
+
+      //
+      // For the units, we have to be a bit careful.  We used to use "\\w" to match "word characters" for the unit name.
+      // This was fine when we had "simple" unit names such as "kg" and "floz", but it breaks for names containing
+      // symbols, such as "L/kg" or "c/g·C".  Instead, we have to match non-space characters.
+      //
+      // Localization::hasUnits has always used the narrower "word characters" match, so we keep a separate expression
+      // for it.
+      //
+      this->m_amountAndUnit     = QRegularExpression{number + "([^\\s]+)?", QRegularExpression::CaseInsensitiveOption};
+      this->m_amountAndWordUnit = QRegularExpression{number + "(\\w+)?"};
+      // Compile now rather than on first use, as that might be in the middle of an import on some other thread
+      this->m_amountAndUnit.optimize();
+      this->m_amountAndWordUnit.optimize();
+
+      //
+      // We keep the order that QMultiMap::values() used to give us when Unit did these look-ups -- ie most recently
+      // constructed first -- as the fallbacks in preferDisplayUnitSystem() and findUnit() rely on it.
+      //
+      for (auto const unit : Measurement::Unit::getAllUnits()) {
+         this->m_unitsByName[unit->name.toLower()].prepend(unit);
+      }
+
+      //
+      // Resolve, once, which unit each name means for each physical quantity, so that the common case of
+      // Unit::getUnit() is a single hash look-up.
+      //
+      for (auto ii = this->m_unitsByName.cbegin(); ii != this->m_unitsByName.cend(); ++ii) {
+         QHash<int, QList<Measurement::Unit const *>> unitsByQuantity;
+         for (auto const unit : ii.value()) {
+            unitsByQuantity[static_cast<int>(unit->getPhysicalQuantity())].append(unit);
+         }
+         for (auto jj = unitsByQuantity.cbegin(); jj != unitsByQuantity.cend(); ++jj) {
+            this->m_preferredUnits.insert(QuantityAndName{jj.key(), ii.key()}, preferDisplayUnitSystem(jj.value()));
+         }
+      }
+
+      qCDebug(logCalc) <<
+         Q_FUNC_INFO << "Built parser for locale" << locale.name() << "(generation" << generation << ") with" <<
+         this->m_unitsByName.size() << "unit names";
+      return;
+   }
+
+   ~impl() = default;
+
+   //! The \c CellDataCache::currentDisplaySettingsGeneration value we were built for
+   unsigned int const m_generation;
+
+   //! Used by \c splitAmountString
+   QRegularExpression m_amountAndUnit;
+   //! Used by \c hasUnits
+   QRegularExpression m_amountAndWordUnit;
+
+   //
+   // Note that, although Unit names (ie abbreviations) are unique within an individual UnitSystem, some are are not
+   // globally unique, and some are not even unique within a PhysicalQuantity.   For example:
+   //    - "L" is the abbreviation/name of both Liters and Lintner
+   //    - "gal" is the abbreviation/name of the Imperial gallon and the US Customary one
+   //
+   //! Lower-cased unit name -> all units with that name (most recently constructed first)
+   QHash<QString, QList<Measurement::Unit const *>> m_unitsByName;
+
+   //! (Physical quantity, lower-cased unit name) -> the unit that name means, taking display unit systems into account
+   QHash<QuantityAndName, Measurement::Unit const *> m_preferredUnits;
+};
+
+Measurement::AmountParser::AmountParser(unsigned int const generation) :
+   pimpl{std::make_unique<impl>(generation)} {
+   return;
+}
+
+Measurement::AmountParser::~AmountParser() = default;
+
+std::shared_ptr<Measurement::AmountParser const> Measurement::AmountParser::current() {
+   //
+   // Each thread keeps its own pointer to the parser so that, in the normal case where nothing has changed, we don't
+   // need to take a lock.  We only need the mutex when the settings have changed and (at most) one thread has to build
+   // a new parser.
+   //
+   static std::mutex mutex;
+   static std::shared_ptr<AmountParser const> sharedParser;
+   thread_local std::shared_ptr<AmountParser const> threadParser;
+
+   unsigned int const generation = CellDataCache::currentDisplaySettingsGeneration();
+   if (threadParser && threadParser->pimpl->m_generation == generation) {
+      return threadParser;
+   }
+
+   std::lock_guard<std::mutex> lock(mutex);
+   if (!sharedParser || sharedParser->pimpl->m_generation != generation) {
+      sharedParser = std::make_shared<AmountParser const>(generation);
+   }
+   threadParser = sharedParser;
+   return threadParser;
+}
+
+std::pair<double, QString> Measurement::AmountParser::splitAmountString(QString const & inputString, bool * ok) const {
+   // Assume it didn't work until it did.  It's less code this way!
+   if (ok) {
+      *ok = false;
+   }
+
+   // Make sure we can parse the string
+   QRegularExpressionMatch match = this->pimpl->m_amountAndUnit.match(inputString);
+   if (!match.hasMatch()) {
+      qCDebug(logCalc) << Q_FUNC_INFO << "Unable to parse" << inputString << "so treating as 0.0";
+      return std::pair<double, QString>{0.0, ""};
+   }
+
+   QString const unitName = match.captured(2);
+
+   double quantity = 0.0;
+   QString numericPartOfInput{match.captured(1)};
+   try {
+      quantity = Localization::toDouble(numericPartOfInput, Q_FUNC_INFO);
+      // If we didn't throw an exception then all must finally be OK!
+      if (ok) {
+         *ok = true;
+      }
+   } catch (std::invalid_argument const & ex) {
+      // If we get this error it's most probably either a bug in our regular expression or a problem with
+      // Localization::getLocale().
+      qWarning() << Q_FUNC_INFO << "Could not parse" << numericPartOfInput << "as number:" << ex.what();
+   } catch(std::out_of_range const & ex) {
+      // This one is more likely user error!
+      qWarning() << Q_FUNC_INFO << "Out of range parsing" << numericPartOfInput << "as number:" << ex.what();
+   }
+
+   return std::pair<double, QString>{quantity, unitName};
+}
+
+bool Measurement::AmountParser::hasUnits(QString const & inputString) const {
+   QRegularExpressionMatch match = this->pimpl->m_amountAndWordUnit.match(inputString);
+   return match.captured(2).size() > 0;
+}
+
+Measurement::Unit const * Measurement::AmountParser::findUnit(QString const & name,
+                                                              PhysicalQuantity const physicalQuantity,
+                                                              bool const caseInensitiveMatching) const {
+   QString const lowerCaseName = name.toLower();
+   Unit const * preferredUnit =
+      this->pimpl->m_preferredUnits.value(QuantityAndName{static_cast<int>(physicalQuantity), lowerCaseName}, nullptr);
+   if (!preferredUnit || caseInensitiveMatching || preferredUnit->name == name) {
+      return preferredUnit;
+   }
+
+   //
+   // Case-sensitive matching is rare, and the preferred unit didn't match exactly, so we have to look at all the
+   // candidates.
+   //
+   QList<Unit const *> exactMatches;
+   for (auto const unit : this->pimpl->m_unitsByName.value(lowerCaseName)) {
+      if (unit->getPhysicalQuantity() == physicalQuantity && unit->name == name) {
+         exactMatches.append(unit);
+      }
+   }
+   return preferDisplayUnitSystem(exactMatches);
+}
+
+Measurement::Unit const * Measurement::AmountParser::findUnit(QString const & name,
+                                                              UnitSystem const & unitSystem,
+                                                              bool const caseInensitiveMatching) const {
+   //
+   // If we have more than one match, then we prefer the first one we find (if any) in the supplied UnitSystem,
+   // otherwise, first in the list will have to do.
+   //
+   PhysicalQuantity const physicalQuantity = unitSystem.getPhysicalQuantity();
+   Unit const * firstMatch = nullptr;
+   for (auto const unit : this->pimpl->m_unitsByName.value(name.toLower())) {
+      if (unit->getPhysicalQuantity() != physicalQuantity ||
+          (!caseInensitiveMatching && unit->name != name)) {
+         continue;
+      }
+      if (unit->getUnitSystem() == unitSystem) {
+         return unit;
+      }
+      if (!firstMatch) {
+         firstMatch = unit;
+      }
+   }
+   return firstMatch;
+}
+
+QList<Measurement::Unit const *> Measurement::AmountParser::findUnitsOnlyByName(QString const & name) const {
+   return this->pimpl->m_unitsByName.value(name.toLower());
+}
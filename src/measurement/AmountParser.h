@@ -0,0 +1,101 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * measurement/AmountParser.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef MEASUREMENT_AMOUNTPARSER_H
+#define MEASUREMENT_AMOUNTPARSER_H
+#pragma once
+
+#include <memory> // For PImpl
+#include <utility> // For std::pair
+
+#include <QList>
+#include <QString>
+
+#include "measurement/PhysicalQuantity.h"
+
+namespace Measurement {
+   class Unit;
+   class UnitSystem;
+
+   /**
+    * \brief Does the work of turning strings such as "3,5 kg" or "2 qt" into a quantity and a \c Unit.
+    *
+    *        Parsing amounts is done every time the user edits a \c SmartLineEdit and for every amount read in during an
+    *        import, so we want it to be cheap.  This class holds everything that can be worked out in advance: the
+    *        regular expressions (which depend on the locale's decimal point and grouping separator) and a hash from
+    *        lower-cased unit name to the \c Unit objects with that name, with the ambiguous ones (eg "qt", "gal")
+    *        already resolved against the display unit systems.
+    *
+    *        An \c AmountParser never changes once constructed, so it can safely be shared between threads.  Callers
+    *        should get the current one via \c AmountParser::current, which builds a new one whenever the locale or
+    *        display unit systems change (see \c CellDataCache::displaySettingsChanged).  Code parsing lots of strings
+    *        in a loop can hold on to the returned pointer to avoid even the small cost of checking for changes.
+    *
+    *        Most callers will not use this directly, but will go via \c Unit::splitAmountString, \c Unit::getUnit,
+    *        \c Localization::hasUnits, etc.
+    */
+   class AmountParser {
+   public:
+      /**
+       * \brief Get the parser for the current locale and display unit systems.  Thread-safe.
+       */
+      static std::shared_ptr<AmountParser const> current();
+
+      //! Should only be called from \c current, but needs to be public for \c std::make_shared
+      AmountParser(unsigned int const generation);
+      ~AmountParser();
+
+      /**
+       * \brief See \c Unit::splitAmountString
+       */
+      std::pair<double, QString> splitAmountString(QString const & inputString, bool * ok = nullptr) const;
+
+      /**
+       * \brief See \c Localization::hasUnits
+       */
+      bool hasUnits(QString const & inputString) const;
+
+      /**
+       * \brief See first overload of \c Unit::getUnit
+       */
+      Unit const * findUnit(QString const & name,
+                            PhysicalQuantity const physicalQuantity,
+                            bool const caseInensitiveMatching = true) const;
+
+      /**
+       * \brief See second overload of \c Unit::getUnit
+       */
+      Unit const * findUnit(QString const & name,
+                            UnitSystem const & unitSystem,
+                            bool const caseInensitiveMatching = true) const;
+
+      /**
+       * \brief All units, of any \c PhysicalQuantity, whose name matches \c name case-insensitively
+       */
+      QList<Unit const *> findUnitsOnlyByName(QString const & name) const;
+
+   private:
+      // Private implementation details - see https://herbsutter.com/gotw/_100/
+      class impl;
+      std::unique_ptr<impl> pimpl;
+
+      AmountParser(AmountParser const &) = delete;
+      AmountParser & operator=(AmountParser const &) = delete;
+      AmountParser(AmountParser &&) = delete;
+      AmountParser & operator=(AmountParser &&) = delete;
+   };
+}
+
+#endif
@@ -18,16 +18,16 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "measurement/IbuMethods.h"
 
-#include <numbers> // For std::numbers::pi
-
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <numbers> // For std::numbers::pi
 
 #include <QDebug>
 #include <QObject>
 #include <QString>
 #include <qglobal.h> // For Q_ASSERT and Q_UNREACHABLE
 
-#include "Algorithms.h"
 #include "measurement/Unit.h"
 #include "PersistentSettings.h"
 
@@ -42,8 +42,8 @@ namespace {
     * \param wortGravity_sg
     * \param timeInBoil_minutes usually measured from the point at which hops are added until flameout
     */
-   double calculateDecimalAlphaAcidUtilization(double const wortGravity_sg,
-                                               double const timeInBoil_minutes) {
+   inline double calculateDecimalAlphaAcidUtilization(double const wortGravity_sg,
+                                                      double const timeInBoil_minutes) {
       //
       // TODO This is Tinseth's "Utilization Table" from which we could probably get a better value for
       //      decimalAlphaAcidUtilization via look-up and interpolation.
@@ -109,35 +109,42 @@ namespace {
       return (parms.hops_grams * utilization * parms.AArating * 1000) / (parms.postBoilVolume_liters * (1 + gravityFactor));
    }
 
+   //
+   // Coefficients, in ascending order of power, of the polynomial in boil time used by Noonan's formula
+   //
+   std::array<double, 8> constexpr noonanTimeCoeffs {
+      0.7000029428, -0.08868853463, 0.02720809386, -0.002340415323, 0.00009925450081, -0.000002102006144,
+      0.00000002132644293, -0.00000000008229488217
+   };
+
+   inline double noonanTimeFactor(double const timeInBoil_minutes) {
+      // Horner's method
+      double result = noonanTimeCoeffs.back();
+      for (std::size_t ii = noonanTimeCoeffs.size() - 1; ii > 0; --ii) {
+         result = result * timeInBoil_minutes + noonanTimeCoeffs[ii - 1];
+      }
+      return result;
+   }
+
+   //
+   // Using 60 minutes as a general table
+   //
+   inline double noonanUtilizationFactor(double const wortGravity_sg) {
+      return (wortGravity_sg <= 1.050) ? 1.0    :
+             (wortGravity_sg <= 1.065) ? 0.9286 :
+             (wortGravity_sg <= 1.085) ? 0.8571 :
+                                         0.75;
+   }
+
    /*!
     * \brief Calculates the IBU by Greg Noonan's formula
     */
    double noonan(IbuMethods::IbuCalculationParms const & parms) {
       double const volumeFactor = (Measurement::Units::us_gallons.toCanonical(5.0).quantity)/ parms.postBoilVolume_liters;
       double const hopsFactor = parms.hops_grams/ (Measurement::Units::ounces.toCanonical(1.0).quantity * 1000.0);
-      static const Polynomial p(Polynomial() << 0.7000029428 << -0.08868853463 << 0.02720809386 << -0.002340415323 << 0.00009925450081 << -0.000002102006144 << 0.00000002132644293 << -0.00000000008229488217);
-
-      //using 60 minutes as a general table
-      static double const utilizationFactorTable[4][2] =  {
-                        {1.050, 1},
-                        {1.065, 0.9286},
-                        {1.085, 0.8571},
-                        {1.100, 0.75}
-                     };
-
-      double utilizationFactor;
-
-      if (parms.wortGravity_sg <= utilizationFactorTable[0][0]) {
-         utilizationFactor = utilizationFactorTable[0][1];
-      } else if (parms.wortGravity_sg <= utilizationFactorTable[1][0]) {
-         utilizationFactor = utilizationFactorTable[1][1];
-      } else if (parms.wortGravity_sg <= utilizationFactorTable[2][0]) {
-         utilizationFactor = utilizationFactorTable[2][1];
-      } else {
-         utilizationFactor = utilizationFactorTable[3][1];
-      }
+      double const utilizationFactor = noonanUtilizationFactor(parms.wortGravity_sg);
 
-      return(volumeFactor * ( hopsFactor * (100 * parms.AArating) * p.eval(parms.timeInBoil_minutes) ) * utilizationFactor);
+      return(volumeFactor * ( hopsFactor * (100 * parms.AArating) * noonanTimeFactor(parms.timeInBoil_minutes) ) * utilizationFactor);
    }
 
    /**
@@ -175,7 +182,8 @@ namespace {
     * \brief Calculates the IBU by the mIBU formula, developed by Paul-John Hosom, and described at
     *        https://alchemyoverlord.wordpress.com/2015/05/12/a-modified-ibu-measurement-especially-for-late-hopping/
     */
-   double mIbu(IbuMethods::IbuCalculationParms const & parms) {
+   template<class Parms>
+   void checkMIbuParms(Parms const & parms) {
       //
       // Check optional parameters available for this formula.  We supply fallback values below, but they likely
       // won't be great.
@@ -183,6 +191,11 @@ namespace {
       if (!parms.coolTime_minutes         ) { qWarning() << Q_FUNC_INFO << "coolTime_minutes          not set!"; }
       if (!parms.kettleInternalDiameter_cm) { qWarning() << Q_FUNC_INFO << "kettleInternalDiameter_cm not set!"; }
       if (!parms.kettleOpeningDiameter_cm ) { qWarning() << Q_FUNC_INFO << "kettleOpeningDiameter_cm  not set!"; }
+      return;
+   }
+
+   double mIbu(IbuMethods::IbuCalculationParms const & parms) {
+      checkMIbuParms(parms);
       double const decimalAlphaAcidUtilization = calculateDecimalAlphaAcidUtilization(parms.wortGravity_sg,
                                                                                       parms.timeInBoil_minutes);
       double const postBoilUtilization = computePostBoilUtilization(parms.timeInBoil_minutes,
@@ -267,3 +280,71 @@ double IbuMethods::getIbus(IbuMethods::IbuCalculationParms const & parms) {
    }
    Q_UNREACHABLE();
 }
+
+void IbuMethods::getIbus(IbuMethods::IbuCalculationBatch const & batch, std::span<double> ibus) {
+   std::size_t const size = ibus.size();
+   Q_ASSERT(batch.AArating             .size() == size);
+   Q_ASSERT(batch.hops_grams           .size() == size);
+   Q_ASSERT(batch.postBoilVolume_liters.size() == size);
+   Q_ASSERT(batch.wortGravity_sg       .size() == size);
+   Q_ASSERT(batch.timeInBoil_minutes   .size() == size);
+
+   //
+   // We choose the formula once, outside the loops, and keep the loop bodies to straight-line arithmetic.  The
+   // calculations are the same as in the single-value functions above.
+   //
+   switch (IbuMethods::formula) {
+      case IbuMethods::IbuFormula::Tinseth:
+         for (std::size_t ii = 0; ii < size; ++ii) {
+            double const mgPerLiterOfAddedAlphaAcids =
+               (batch.AArating[ii] * batch.hops_grams[ii] * 1000) / batch.postBoilVolume_liters[ii];
+            ibus[ii] = calculateDecimalAlphaAcidUtilization(batch.wortGravity_sg[ii], batch.timeInBoil_minutes[ii]) *
+                       mgPerLiterOfAddedAlphaAcids;
+         }
+         return;
+
+      case IbuMethods::IbuFormula::Rager:
+         for (std::size_t ii = 0; ii < size; ++ii) {
+            double const utilization = (18.11 + 13.86 * tanh((batch.timeInBoil_minutes[ii] - 31.32) / 18.17)) / 100.0;
+            double const gravityFactor = std::max(0.0, (batch.wortGravity_sg[ii] - 1.050)/0.2);
+            ibus[ii] = (batch.hops_grams[ii] * utilization * batch.AArating[ii] * 1000) /
+                       (batch.postBoilVolume_liters[ii] * (1 + gravityFactor));
+         }
+         return;
+
+      case IbuMethods::IbuFormula::Noonan:
+         {
+            double const fiveGallons_liters = Measurement::Units::us_gallons.toCanonical(5.0).quantity;
+            double const oneOunce_mg        = Measurement::Units::ounces.toCanonical(1.0).quantity * 1000.0;
+            for (std::size_t ii = 0; ii < size; ++ii) {
+               double const volumeFactor = fiveGallons_liters / batch.postBoilVolume_liters[ii];
+               double const hopsFactor = batch.hops_grams[ii] / oneOunce_mg;
+               ibus[ii] = volumeFactor * (
+                  hopsFactor * (100 * batch.AArating[ii]) * noonanTimeFactor(batch.timeInBoil_minutes[ii])
+               ) * noonanUtilizationFactor(batch.wortGravity_sg[ii]);
+            }
+         }
+         return;
+
+      case IbuMethods::IbuFormula::mIbu:
+         // Only warn once for the whole batch about missing parameters
+         checkMIbuParms(batch);
+         for (std::size_t ii = 0; ii < size; ++ii) {
+            double const decimalAlphaAcidUtilization =
+               calculateDecimalAlphaAcidUtilization(batch.wortGravity_sg[ii], batch.timeInBoil_minutes[ii]);
+            double const postBoilUtilization =
+               computePostBoilUtilization(batch.timeInBoil_minutes[ii],
+                                          batch.wortGravity_sg[ii],
+                                          batch.postBoilVolume_liters[ii],
+                                          batch.coolTime_minutes.value_or(0.0),
+                                          batch.kettleInternalDiameter_cm.value_or(45.0),
+                                          batch.kettleOpeningDiameter_cm.value_or(45.0));
+            ibus[ii] = ((decimalAlphaAcidUtilization + postBoilUtilization) *
+                        batch.AArating[ii] * batch.hops_grams[ii] * 1000.0) / batch.postBoilVolume_liters[ii];
+         }
+         return;
+
+//      case IbuMethods::IbuFormula::Smph   : ...
+   }
+   Q_UNREACHABLE();
+}
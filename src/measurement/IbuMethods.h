@@ -19,6 +19,9 @@
 #define MEASUREMENT_IBUMETHODS_H
 #pragma once
 
+#include <optional>
+#include <span>
+
 #include "utils/BtStringConst.h"
 #include "utils/EnumStringMapping.h"
 
@@ -139,6 +142,34 @@ namespace IbuMethods {
     * \return IBUs according to selected algorithm.
     */
    double getIbus(IbuCalculationParms const & parms);
+
+   /**
+    * \brief Parameters for calculating IBUs for many hop additions at once, in structure-of-arrays form.  Meanings
+    *        are as for \c IbuCalculationParms.  All the spans must be the same length.
+    *
+    *        The mIbu-only parameters relate to the kettle and cooling, so are the same for the whole batch.
+    */
+   struct IbuCalculationBatch {
+      std::span<double const> AArating;
+      std::span<double const> hops_grams;
+      std::span<double const> postBoilVolume_liters;
+      std::span<double const> wortGravity_sg;
+      std::span<double const> timeInBoil_minutes;
+      std::optional<double> coolTime_minutes          = std::nullopt;
+      std::optional<double> kettleInternalDiameter_cm = std::nullopt;
+      std::optional<double> kettleOpeningDiameter_cm  = std::nullopt;
+   };
+
+   /*!
+    * \brief Batch version of \c getIbus, eg for recalculating a whole catalog or for sensitivity sweeps.  The formula
+    *        is chosen once for the whole batch, and the Tinseth, Rager and Noonan calculations are simple loops that
+    *        the compiler can vectorise.  (The mIbu formula does a numerical integration per hop addition, so it gains
+    *        less.)
+    *
+    * \param batch
+    * \param ibus Receives the IBUs for each hop addition.  Must be the same length as the spans in \c batch.
+    */
+   void getIbus(IbuCalculationBatch const & batch, std::span<double> ibus);
 }
 
 #endif
@@ -24,12 +24,14 @@
 
 #include "Algorithms.h"
 #include "Localization.h"
+#include "Logging.h"
 #include "measurement/PhysicalQuantity.h"
 #include "measurement/UnitSystem.h"
 #include "model/NamedEntity.h"
 #include "model/Style.h" // For PropertyNames::Style::colorMin_srm, PropertyNames::Style::colorMax_srm
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
+#include "utils/CellDataCache.h"
 #include "utils/OptionalHelpers.h"
 #include "utils/TypeLookup.h"
 
@@ -143,8 +145,9 @@ void Measurement::setDisplayUnitSystem(Measurement::PhysicalQuantity physicalQua
                                        Measurement::UnitSystem const & unitSystem) {
    // It's a coding error if we try to store a UnitSystem against a PhysicalQuantity to which it does not relate!
    Q_ASSERT(physicalQuantity == unitSystem.getPhysicalQuantity());
-   qDebug() << Q_FUNC_INFO << "Setting UnitSystem for" << physicalQuantity << "to" << unitSystem.uniqueName;
+   qCDebug(logCalc) << Q_FUNC_INFO << "Setting UnitSystem for" << physicalQuantity << "to" << unitSystem.uniqueName;
    physicalQuantityToDisplayUnitSystem.insert(physicalQuantity, &unitSystem);
+   CellDataCache::displaySettingsChanged();
    return;
 }
 
@@ -250,7 +253,7 @@ Measurement::Amount Measurement::qStringToSI(QString qstr,
                                              std::optional<Measurement::SystemOfMeasurement> forcedSystemOfMeasurement,
                                              std::optional<Measurement::UnitSystem::RelativeScale> forcedScale) {
    // Commented out this log statement as it otherwise takes up a lot of log space
-//   qDebug() <<
+//   qCDebug(logCalc) <<
 //      Q_FUNC_INFO << "Input" << qstr << "of" << physicalQuantity << "; forcedSystemOfMeasurement=" <<
 //      forcedSystemOfMeasurement << "; forcedScale=" << forcedScale;
 
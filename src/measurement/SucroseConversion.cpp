@@ -41,7 +41,7 @@
 //         I found to avoid copying this data on to the heap (which would be unnecessary since it's const and known at
 //         compile time).
 //
-Measurement::SucroseConversion const Measurement::sucroseConversions[] = {
+Measurement::SucroseConversion constexpr Measurement::sucroseConversions[] = {
    // Refractive Index at 20°C  ||  % sucrose or degree Brix  ||  Apparent specific gravity @ 20/20 °C
    {  1.3330,                       0.0,                          1.00000  },
    {  1.3331,                       0.1,                          1.00039  }, // The PDF has this as 0.0 Brix, but I think that's clearly a typo
@@ -847,3 +847,50 @@ Measurement::SucroseConversion const Measurement::sucroseConversions[] = {
 };
 
 size_t constexpr Measurement::sucroseConversions_size = std::size(Measurement::sucroseConversions);
+
+namespace {
+   /**
+    * \brief Compile-time equivalent of the look-up and linear interpolation that \c Algorithms::SgAt20CToBrix used to
+    *        do on every call.  SG below the table gives 0 Brix; SG above it gives the maximum.
+    */
+   constexpr double interpolateBrixFromSg(double const sg) {
+      auto const & table = Measurement::sucroseConversions;
+      size_t const last = Measurement::sucroseConversions_size - 1;
+      if (sg <= table[0].apparentSgAt2020C) {
+         return table[0].degreesBrix;
+      }
+      if (sg >= table[last].apparentSgAt2020C) {
+         return table[last].degreesBrix;
+      }
+      // Binary search for the first row whose SG is not less than the one we want
+      size_t lower = 0;
+      size_t upper = last;
+      while (upper - lower > 1) {
+         size_t const middle = (lower + upper) / 2;
+         if (table[middle].apparentSgAt2020C < sg) {
+            lower = middle;
+         } else {
+            upper = middle;
+         }
+      }
+      double const positionInRange =
+         (sg - table[lower].apparentSgAt2020C) / (table[upper].apparentSgAt2020C - table[lower].apparentSgAt2020C);
+      return table[lower].degreesBrix + positionInRange * (table[upper].degreesBrix - table[lower].degreesBrix);
+   }
+
+   constexpr std::array<double, Measurement::sgToBrixGrid_size> makeSgToBrixGrid() {
+      std::array<double, Measurement::sgToBrixGrid_size> grid{};
+      for (size_t ii = 0; ii < grid.size(); ++ii) {
+         grid[ii] = interpolateBrixFromSg(1.0 + static_cast<double>(ii) * Measurement::sgToBrixGrid_step);
+      }
+      return grid;
+   }
+}
+
+static_assert(
+   1.0 + (Measurement::sgToBrixGrid_size - 1) * Measurement::sgToBrixGrid_step >=
+   Measurement::sucroseConversions[Measurement::sucroseConversions_size - 1].apparentSgAt2020C,
+   "sgToBrixGrid does not cover all of sucroseConversions"
+);
+
+std::array<double, Measurement::sgToBrixGrid_size> constexpr Measurement::sgToBrixGrid = makeSgToBrixGrid();
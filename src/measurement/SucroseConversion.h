@@ -17,6 +17,7 @@
 #define MEASUREMENT_SUCROSECONVERSION_H
 #pragma once
 
+#include <array>
 #include <cstddef> // For size_t
 
 namespace Measurement {
@@ -30,6 +31,18 @@ namespace Measurement {
    extern SucroseConversion const sucroseConversions[];
 
    extern size_t const sucroseConversions_size;
+
+   //! Spacing, in specific gravity, of the points in \c sgToBrixGrid
+   double constexpr sgToBrixGrid_step = 0.0001;
+   //! Enough points to cover all of \c sucroseConversions, starting from SG 1.000
+   size_t constexpr sgToBrixGrid_size = 4149;
+
+   /**
+    * \brief The Brix column of \c sucroseConversions, linearly interpolated on to evenly spaced specific gravities
+    *        (1.000, 1.0001, 1.0002, etc), so that converting SG to Brix is an index calculation rather than a search.
+    *        This is computed at compile time.  See \c Algorithms::SgAt20CToBrix.
+    */
+   extern std::array<double, sgToBrixGrid_size> const sgToBrixGrid;
 }
 
 #endif
@@ -24,20 +24,20 @@
 #include <string>
 
 #include <QStringList>
-#include <QRegularExpression>
 #include <QDebug>
 
 #include "Algorithms.h"
 #include "Localization.h"
 #include "Logging.h"
+#include "measurement/AmountParser.h"
 #include "measurement/Measurement.h"
 #include "measurement/UnitSystem.h"
 
 namespace {
 
    /**
-    * \brief This is useful to allow us to initialise \c unitNameLookup and \c physicalQuantityToCanonicalUnit after
-    *        all \c Unit and \c UnitSystem objects have been created.
+    * \brief This is useful to allow us to initialise \c physicalQuantityToCanonicalUnit (and \c AmountParser to build
+    *        its look-ups) after all \c Unit and \c UnitSystem objects have been created.
     */
    QVector<Measurement::Unit const *> listOfAllUnits;
 
@@ -46,109 +46,8 @@ namespace {
     */
    std::once_flag initFlag_Lookups;
 
-   //
-   // Note that, although Unit names (ie abbreviations) are unique within an individual UnitSystem, some are are not
-   // globally unique, and some are not even unique within a PhysicalQuantity.   For example:
-   //    - "L" is the abbreviation/name of both Liters and Lintner
-   //    - "gal" is the abbreviation/name of the Imperial gallon and the US Customary one
-   //
-   // Almost all of the time when we are doing look-ups, we know the PhysicalQuantity (and it is not meaningful for the
-   // user to specify units relating to a different PhysicalQuantity) so it makes sense to group look-ups by that.
-   //
-   struct NameLookupKey {
-      Measurement::PhysicalQuantity physicalQuantity;
-      QString                       lowerCaseUnitName;
-      //
-      // We need an ordering on the struct to use it as a key of QMap / QMultiMap.  AIUI, these two operators suffice
-      // for the compiler to deduce all the others.
-      //
-      friend auto operator==(NameLookupKey const & lhs, NameLookupKey const & rhs);
-      friend auto operator<=>(NameLookupKey const & lhs, NameLookupKey const & rhs);
-
-   };
-
-   auto operator==(NameLookupKey const & lhs, NameLookupKey const & rhs) {
-      return lhs.physicalQuantity == rhs.physicalQuantity && lhs.lowerCaseUnitName == rhs.lowerCaseUnitName;
-   }
-
-   auto operator<=>(NameLookupKey const & lhs, NameLookupKey const & rhs) {
-      if (lhs.physicalQuantity < rhs.physicalQuantity) { return std::strong_ordering::less; }
-      if (lhs.physicalQuantity > rhs.physicalQuantity) { return std::strong_ordering::greater; }
-      if (lhs.lowerCaseUnitName < rhs.lowerCaseUnitName) { return std::strong_ordering::less; }
-      if (lhs.lowerCaseUnitName > rhs.lowerCaseUnitName) { return std::strong_ordering::greater; }
-      return std::strong_ordering::equal;
-   }
-
-   QMultiMap<NameLookupKey, Measurement::Unit const *> unitNameLookup;
-
    QMap<Measurement::PhysicalQuantity, Measurement::Unit const *> physicalQuantityToCanonicalUnit;
 
-   /**
-    * \brief Get all units matching a given name and physical quantity
-    *
-    * \param name
-    * \param physicalQuantity
-    * \param caseInensitiveMatching If \c true, do a case-insensitive search.  Eg, match "ml" for milliliters, even
-    *                               though the correct name is "mL".  This should always be safe to do, as AFAICT there
-    *                               are no current or foreseeable units that _we_ use whose names only differ by case --
-    *                               or, at least, that's the case in English...
-    */
-   QList<Measurement::Unit const *> getUnitsByNameAndPhysicalQuantity(QString const & name,
-                                                                      Measurement::PhysicalQuantity const & physicalQuantity,
-                                                                      bool const caseInensitiveMatching) {
-      // Need this before we reference unitNameLookup or physicalQuantityToCanonicalUnit
-      std::call_once(initFlag_Lookups, &Measurement::Unit::initialiseLookups);
-
-      auto matches = unitNameLookup.values(NameLookupKey{physicalQuantity, name.toLower()});
-      // Commented out this log statement as it otherwise takes up a lot of log space
-//      qDebug() << Q_FUNC_INFO << name << "has" << matches.length() << "case-insensitive match(es)";
-
-      if (caseInensitiveMatching) {
-         return matches;
-      }
-
-      // If we ever want to do case insensitive matching (which we think should be rare), the simplest thing is just to
-      // go through all the case-insensitive matches and exclude those that aren't an exact match
-      decltype(matches) filteredMatches;
-      for (auto match : matches) {
-         if (match->name == name) {
-            filteredMatches.append(match);
-         }
-      }
-      qDebug() << Q_FUNC_INFO << name << "has" << filteredMatches.length() << "case-sensitive match(es)";
-      return filteredMatches;
-   }
-
-   /**
-    * \brief Get all units matching a given name, but without knowing the physical quantity.  Pretty much the only time
-    *        we need this is in \c ConverterTool to do contextless conversions.
-    *
-    * \param name
-    * \param caseInensitiveMatching If \c true, do a case-insensitive search.  Eg, match "ml" for milliliters, even
-    *                               though the correct name is "mL".
-    */
-   QList<Measurement::Unit const *> getUnitsOnlyByName(QString const & name) {
-      // Need this before we reference unitNameLookup or physicalQuantityToCanonicalUnit
-      std::call_once(initFlag_Lookups, &Measurement::Unit::initialiseLookups);
-
-      QList<Measurement::Unit const *> allMatches;
-      auto const & keys {unitNameLookup.uniqueKeys()};
-      for (auto const & key : keys) {
-
-         if (name.toLower() == key.lowerCaseUnitName) {
-            auto matches = unitNameLookup.values(key);
-            allMatches.append(matches);
-            qDebug() <<
-               Q_FUNC_INFO << "Added" << matches.length() << "matches for" << key.lowerCaseUnitName << "/" <<
-               key.physicalQuantity << ":";
-            for (auto & match : matches) {
-               qDebug() << Q_FUNC_INFO << " - " << match;
-            }
-         }
-      }
-      return allMatches;
-   }
-
    QString displayableConvert(Measurement::Unit const & fromUnit,
                               Measurement::Unit const &   toUnit,
                               double const fromQuantity) {
@@ -241,8 +140,8 @@ Measurement::Unit::Unit(UnitSystem const & unitSystem,
                                 boundaryValue,
                                 (canonical == nullptr))} {
    //
-   // You might think here would be a neat place to add the Unit we are constructing to unitNameLookup and, if
-   // appropriate, physicalQuantityToCanonicalUnit.  However, there is not guarantee that unitSystem is constructed at
+   // You might think here would be a neat place to add the Unit we are constructing to
+   // physicalQuantityToCanonicalUnit (if appropriate).  However, there is not guarantee that unitSystem is constructed at
    // this point, so unitSystem.getPhysicalQuantity() could result in a core dump.
    //
    // What we can do safely is add ourselves to listOfAllUnits
@@ -276,7 +175,6 @@ Measurement::Unit::~Unit() = default;
 void Measurement::Unit::initialiseLookups() {
    for (auto const unit : listOfAllUnits) {
       Measurement::PhysicalQuantity const physicalQuantity = unit->pimpl->m_unitSystem.getPhysicalQuantity();
-      unitNameLookup.insert(NameLookupKey{physicalQuantity, unit->name.toLower()}, unit);
       if (unit->pimpl->m_isCanonical) {
          physicalQuantityToCanonicalUnit.insert(physicalQuantity, unit);
       }
@@ -284,56 +182,12 @@ void Measurement::Unit::initialiseLookups() {
    return;
 }
 
-std::pair<double, QString> Measurement::Unit::splitAmountString(QString const & inputString, bool * ok) {
-   // Assume it didn't work until it did.  It's less code this way!
-   if (ok) {
-      *ok = false;
-   }
-
-   // All functions in QRegularExpression are reentrant, so it should be safe to use as a shared const in multi-threaded
-   // code.
-   static QRegularExpression const amtUnit {
-      //
-      // For the numeric part (the quantity) we need to make sure we get the right decimal point (. or ,) and the right
-      // grouping separator (, or .).  Some locales write 1.000,10 and others write 1,000.10.  We need to catch both.
-      //
-      // For the units, we have to be a bit careful.  We used to use "\\w" to match "word characters" for the unit name.
-      // This was fine when we had "simple" unit names such as "kg" and "floz", but it breaks for names containing
-      // symbols, such as "L/kg" or "c/g·C".  Instead, we have to match non-space characters
-      //
-      "((?:\\d+" + QRegularExpression::escape(Localization::getLocale().groupSeparator()) + ")?\\d+(?:" +
-      QRegularExpression::escape(Localization::getLocale().decimalPoint()) + "\\d+)?|" +
-      QRegularExpression::escape(Localization::getLocale().decimalPoint()) + "\\d+)\\s*([^\\s]+)?",
-      QRegularExpression::CaseInsensitiveOption
-   };
-
-   // Make sure we can parse the string
-   QRegularExpressionMatch match = amtUnit.match(inputString);
-   if (!match.hasMatch()) {
-      qDebug() << Q_FUNC_INFO << "Unable to parse" << inputString << "so treating as 0.0";
-      return std::pair<double, QString>{0.0, ""};
-   }
-
-   QString const unitName = match.captured(2);
-
-   double quantity = 0.0;
-   QString numericPartOfInput{match.captured(1)};
-   try {
-      quantity = Localization::toDouble(numericPartOfInput, Q_FUNC_INFO);
-      // If we didn't throw an exception then all must finally be OK!
-      if (ok) {
-         *ok = true;
-      }
-   } catch (std::invalid_argument const & ex) {
-      // If we get this error it's most probably either a bug in our regular expression or a problem with
-      // Localization::getLocale().
-      qWarning() << Q_FUNC_INFO << "Could not parse" << numericPartOfInput << "as number:" << ex.what();
-   } catch(std::out_of_range const & ex) {
-      // This one is more likely user error!
-      qWarning() << Q_FUNC_INFO << "Out of range parsing" << numericPartOfInput << "as number:" << ex.what();
-   }
+QVector<Measurement::Unit const *> const & Measurement::Unit::getAllUnits() {
+   return listOfAllUnits;
+}
 
-   return std::pair<double, QString>{quantity, unitName};
+std::pair<double, QString> Measurement::Unit::splitAmountString(QString const & inputString, bool * ok) {
+   return Measurement::AmountParser::current()->splitAmountString(inputString, ok);
 }
 
 bool Measurement::Unit::operator==(Unit const & other) const {
@@ -391,7 +245,7 @@ double Measurement::Unit::boundary() const {
 }
 
 Measurement::Unit const & Measurement::Unit::getCanonicalUnit(Measurement::PhysicalQuantity const physicalQuantity) {
-   // Need this before we reference unitNameLookup or physicalQuantityToCanonicalUnit
+   // Need this before we reference physicalQuantityToCanonicalUnit
    std::call_once(initFlag_Lookups, &Measurement::Unit::initialiseLookups);
 
    // It's a coding error if there is no canonical unit for a real physical quantity (ie not Mixed).  (And of course
@@ -403,13 +257,12 @@ Measurement::Unit const & Measurement::Unit::getCanonicalUnit(Measurement::Physi
 
 QString Measurement::Unit::convertWithoutContext(QString const & qstr, QString const & toUnitName) {
 
-   qDebug() << Q_FUNC_INFO << "Trying to convert" << qstr << "to" << toUnitName;
-   double const fromQuantity = Measurement::Unit::splitAmountString(qstr).first;
-
-   QString const fromUnitName =  Measurement::Unit::splitAmountString(qstr).second;
-   auto const fromUnits = getUnitsOnlyByName(fromUnitName);
-   auto const toUnits   = getUnitsOnlyByName(toUnitName);
-   qDebug() <<
+   qCDebug(logCalc) << Q_FUNC_INFO << "Trying to convert" << qstr << "to" << toUnitName;
+   auto const parser = Measurement::AmountParser::current();
+   auto const [fromQuantity, fromUnitName] = parser->splitAmountString(qstr);
+   auto const fromUnits = parser->findUnitsOnlyByName(fromUnitName);
+   auto const toUnits   = parser->findUnitsOnlyByName(toUnitName);
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "Found" << fromUnits.length() << "matches for" << fromUnitName << "and" << toUnits.length() <<
       "matches for" << toUnitName;
 
@@ -478,84 +331,13 @@ QString Measurement::Unit::convertWithoutContext(QString const & qstr, QString c
 Measurement::Unit const * Measurement::Unit::getUnit(QString const & name,
                                                      Measurement::PhysicalQuantity const & physicalQuantity,
                                                      bool const caseInensitiveMatching) {
-   auto matches = getUnitsByNameAndPhysicalQuantity(name, physicalQuantity, caseInensitiveMatching);
-
-   auto const numMatches = matches.length();
-   if (0 == numMatches) {
-      return nullptr;
-   }
-
-   // Under most circumstances, there is a one-to-one relationship between unit string and Unit. C will only map to
-   // Measurement::Unit::Celsius, for example. If there's only one match, just return it.
-   if (1 == numMatches) {
-      auto unitToReturn = matches.at(0);
-      if (unitToReturn->getPhysicalQuantity() != physicalQuantity) {
-         qWarning() <<
-            Q_FUNC_INFO << "Unit" << name << "matches a unit of type" << unitToReturn->getPhysicalQuantity() <<
-            "but caller specified" << physicalQuantity;
-         return nullptr;
-      }
-      return unitToReturn;
-   }
-
-   // That solved something like 99% of the use cases. Now we have to handle those pesky volumes.
-   // Loop through the found Units, like Measurement::Unit::us_quart and
-   // Measurement::Unit::imperial_quart, and try to find one that matches the global default.
-   Measurement::Unit const * defUnit = nullptr;
-   for (auto const unit : matches) {
-      auto const & displayUnitSystem = Measurement::getDisplayUnitSystem(unit->getPhysicalQuantity());
-      qDebug() <<
-         Q_FUNC_INFO << "Look at" << *unit << "from" << unit->getUnitSystem() << "(Display Unit System for" <<
-         unit->getPhysicalQuantity() << "is" << displayUnitSystem << ")";
-      if (unit->getPhysicalQuantity() != physicalQuantity) {
-         // If the caller knows the amount is, say, a Volume, don't bother trying to match against units for any other
-         // physical quantity.
-         qDebug() << Q_FUNC_INFO << "Ignoring match in" << unit->getPhysicalQuantity() << "as not" << physicalQuantity;
-         continue;
-      }
-
-      if (displayUnitSystem == unit->getUnitSystem()) {
-         // We found a match that belongs to one of the global default unit systems
-         return unit;
-      }
-
-      // Save this for later if we need it - ie if we don't find a better match
-      defUnit = unit;
-   }
-
-   // If we got here, we couldn't find a match. Unless something weird has
-   // happened, that means you entered "qt" into a field and the system
-   // default is SI. At that point, just use the USCustomary
-   return defUnit;
+   return Measurement::AmountParser::current()->findUnit(name, physicalQuantity, caseInensitiveMatching);
 }
 
 Measurement::Unit const * Measurement::Unit::getUnit(QString const & name,
                                                      Measurement::UnitSystem const & unitSystem,
                                                      bool const caseInensitiveMatching) {
-   auto matches = getUnitsByNameAndPhysicalQuantity(name, unitSystem.getPhysicalQuantity(), caseInensitiveMatching);
-
-   //
-   // At this point, matches is a list of all units matching the supplied name and the PhysicalQuantity of the supplied
-   // UnitSystem.  If we have more than one match, then we prefer the first one we find (if any) in the supplied
-   // UnitSystem, otherwise, first in the list will have to do.
-   //
-
-   auto const numMatches = matches.length();
-   if (0 == numMatches) {
-      return nullptr;
-   }
-
-   if (1 == numMatches) {
-      return matches.at(0);
-   }
-
-   for (auto const match : matches) {
-      if (match->getUnitSystem() == unitSystem) {
-         return match;
-      }
-   }
-
-   return matches.at(0);
+   return Measurement::AmountParser::current()->findUnit(name, unitSystem, caseInensitiveMatching);
 }
 
 // This is where we actually define all the different units and how to convert them to/from their canonical equivalents
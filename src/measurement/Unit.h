@@ -30,6 +30,7 @@
 #include <QMultiMap>
 #include <QObject>
 #include <QString>
+#include <QVector>
 
 #include "measurement/Amount.h"
 #include "measurement/PhysicalQuantity.h"
@@ -110,11 +111,18 @@ namespace Measurement {
        */
       static void initialiseLookups();
 
+      /**
+       * \brief All the \c Unit objects that exist.  Used by \c AmountParser to build its look-ups.
+       */
+      static QVector<Unit const *> const & getAllUnits();
+
       /**
        * \brief Given a string of quantity plus optional units, this function breaks it down into the quantity (or 0.0
        *        if none was found) and the units (or "" if none was found).  This is a bit fiddly to get right (partly
        *        because of locale-specific thousands and decimal separators, and partly because unit names can contain
        *        symbols such as '/').  So we only want to do it in one place!
+       *
+       *        This is a convenience wrapper around \c AmountParser::splitAmountString.
        */
       static std::pair<double, QString> splitAmountString(QString const & inputString, bool * ok = nullptr);
 
@@ -23,6 +23,7 @@
 #include <QDebug>
 
 #include "Localization.h"
+#include "Logging.h"
 #include "measurement/Unit.h"
 #include "utils/EnumStringMapping.h"
 
@@ -231,20 +232,20 @@ Measurement::Amount Measurement::UnitSystem::qstringToSI(QString qstr, Unit cons
       // return nullptr;
       unitToUse = Unit::getUnit(unitName, *this, true);
 //      if (unitToUse) {
-//         qDebug() << Q_FUNC_INFO << this->uniqueName << ":" << unitName << "interpreted as" << unitToUse->name;
+//         qCDebug(logCalc) << Q_FUNC_INFO << this->uniqueName << ":" << unitName << "interpreted as" << unitToUse->name;
 //      } else {
-//         qDebug() <<
+//         qCDebug(logCalc) <<
 //            Q_FUNC_INFO << this->uniqueName << ":" << unitName << "not recognised for" << this->pimpl->physicalQuantity;
 //      }
    }
 
    if (!unitToUse) {
-//      qDebug() << Q_FUNC_INFO << "Defaulting to" << defUnit;
+//      qCDebug(logCalc) << Q_FUNC_INFO << "Defaulting to" << defUnit;
       unitToUse = &defUnit;
    }
 
    Measurement::Amount siAmount = unitToUse->toCanonical(amt);
-//   qDebug() <<
+//   qCDebug(logCalc) <<
 //      Q_FUNC_INFO << this->uniqueName << ": " << qstr << "is" << amt << " " << unitToUse->name << "=" <<
 //      siAmount.quantity << "in" << siAmount.unit->name;
 
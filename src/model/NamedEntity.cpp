@@ -414,8 +414,12 @@ void NamedEntity::prepareForPropertyChange(BtStringConst const & propertyName) {
    // At the moment, the only thing we want to do in this pre-change check is to see whether we need to version a
    // Recipe.  Obviously we leave all the details of that to the Recipe-related namespace.
    //
-   // Obviously nothing gets versioned if it's not yet in the DB
+   // Obviously nothing gets versioned if it's not yet in the DB.  Nor do we version anything when the change is just
+   // us catching up with what another client wrote to the DB.
    //
+   if (ObjectStore::isApplyingRemoteChanges()) {
+      return;
+   }
    auto owningRecipe = this->owningRecipe();
    if (owningRecipe) {
       RecipeHelper::prepareForPropertyChange(*this, propertyName);
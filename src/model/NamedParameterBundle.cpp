@@ -18,6 +18,7 @@
 #include <string>
 #include <stdexcept>
 #include <sstream>
+#include <utility>
 
 #include <boost/stacktrace.hpp>
 
@@ -26,8 +27,60 @@
 #include <QTextStream>
 #include <qglobal.h> // For Q_ASSERT and Q_UNREACHABLE
 
+NamedParameterBundle::Layout::Layout(std::vector<BtStringConst const *> propertyNames) :
+   m_propertyNames{std::move(propertyNames)},
+   m_byAddress{},
+   m_byName{} {
+   this->m_byAddress.reserve(this->m_propertyNames.size());
+   this->m_byName.reserve(this->m_propertyNames.size());
+   for (int ordinal = 0; ordinal < static_cast<int>(this->m_propertyNames.size()); ++ordinal) {
+      char const * const name = **this->m_propertyNames[ordinal];
+      // It's a coding error to have the same property twice in a layout
+      Q_ASSERT(!this->m_byName.contains(name));
+      this->m_byAddress.emplace(name, ordinal);
+      this->m_byName.emplace(name, ordinal);
+   }
+   return;
+}
+
+NamedParameterBundle::Layout::~Layout() = default;
+
+int NamedParameterBundle::Layout::ordinal(BtStringConst const & propertyName) const {
+   char const * const name = *propertyName;
+   if (auto const match = this->m_byAddress.find(name); match != this->m_byAddress.end()) {
+      return match->second;
+   }
+   if (!name) {
+      return -1;
+   }
+   if (auto const match = this->m_byName.find(name); match != this->m_byName.end()) {
+      return match->second;
+   }
+   return -1;
+}
+
+std::size_t NamedParameterBundle::Layout::size() const noexcept {
+   return this->m_propertyNames.size();
+}
+
+BtStringConst const & NamedParameterBundle::Layout::propertyName(int const ordinal) const {
+   return *this->m_propertyNames.at(ordinal);
+}
+
 NamedParameterBundle::NamedParameterBundle(NamedParameterBundle::OperationMode mode) :
    m_parameters{},
+   m_layout{},
+   m_values{},
+   m_mode{mode},
+   m_containedBundles{} {
+   return;
+}
+
+NamedParameterBundle::NamedParameterBundle(std::shared_ptr<Layout const> layout,
+                                           NamedParameterBundle::OperationMode mode) :
+   m_parameters{},
+   m_layout{std::move(layout)},
+   m_values(m_layout ? m_layout->size() : 0),
    m_mode{mode},
    m_containedBundles{} {
    return;
@@ -35,7 +88,37 @@ NamedParameterBundle::NamedParameterBundle(NamedParameterBundle::OperationMode m
 
 NamedParameterBundle::~NamedParameterBundle() = default;
 
+void NamedParameterBundle::insert(int const ordinal, QVariant value) {
+   // It's a coding error to call this on a bundle without a layout or with an ordinal outside the layout
+   Q_ASSERT(this->m_layout);
+   Q_ASSERT(ordinal >= 0 && ordinal < static_cast<int>(this->m_values.size()));
+   this->m_values[ordinal] = std::move(value);
+   return;
+}
+
+QVariant const * NamedParameterBundle::find(BtStringConst const & propertyName) const {
+   if (this->m_layout) {
+      int const ordinal = this->m_layout->ordinal(propertyName);
+      if (ordinal >= 0) {
+         auto const & value = this->m_values[ordinal];
+         return value ? &*value : nullptr;
+      }
+   }
+   auto const match = this->m_parameters.find(*propertyName);
+   return match == this->m_parameters.end() ? nullptr : &match->second;
+}
+
 void NamedParameterBundle::insert(BtStringConst const & propertyName, QVariant const & value) {
+   if (this->m_layout) {
+      int const ordinal = this->m_layout->ordinal(propertyName);
+      if (ordinal >= 0) {
+         // Same semantics as std::map::insert below, ie we do not overwrite an existing value
+         if (!this->m_values[ordinal]) {
+            this->m_values[ordinal] = value;
+         }
+         return;
+      }
+   }
    // std::map and std::unordered_map both need an extra set of braces on the call to insert, as we're actually passing
    // in one parameter (std::pair) rather than two.
    this->m_parameters.insert({QString{*propertyName}, value});
@@ -67,7 +150,7 @@ void NamedParameterBundle::insert(PropertyPath const & propertyPath, QVariant co
 }
 
 bool NamedParameterBundle::contains(BtStringConst const & propertyName) const {
-   return this->m_parameters.contains(*propertyName);
+   return this->find(propertyName) != nullptr;
 }
 
 bool NamedParameterBundle::contains(PropertyPath const & propertyPath) const {
@@ -105,19 +188,36 @@ std::size_t NamedParameterBundle::size() const noexcept {
    // This function is only used for logging, so, for simplicitly, we'll count each contained bundle as 1, rather than
    // by the number of parameters it contains.
    //
-   return this->m_parameters.size() + this->m_containedBundles.size();
+   std::size_t numOrdinalValues = 0;
+   for (auto const & value : this->m_values) {
+      if (value) {
+         ++numOrdinalValues;
+      }
+   }
+   return numOrdinalValues + this->m_parameters.size() + this->m_containedBundles.size();
 }
 
 bool NamedParameterBundle::isEmpty() const {
-   return this->m_parameters.empty() && this->m_containedBundles.empty();
+   return this->size() == 0;
 }
 
 QVariant NamedParameterBundle::get(BtStringConst const & propertyName) const {
-   if (!this->m_parameters.contains(*propertyName)) {
+   QVariant const * storedValue = this->find(propertyName);
+   if (!storedValue) {
       QString errorMessage = QString("No value supplied for required parameter, %1.").arg(*propertyName);
       QTextStream errorMessageAsStream(&errorMessage);
       errorMessageAsStream << "  (Parameters in this bundle are ";
       bool wroteFirst = false;
+      for (std::size_t ordinal = 0; ordinal < this->m_values.size(); ++ordinal) {
+         if (this->m_values[ordinal]) {
+            if (!wroteFirst) {
+               wroteFirst = true;
+            } else {
+               errorMessageAsStream << ", ";
+            }
+            errorMessageAsStream << *this->m_layout->propertyName(static_cast<int>(ordinal));
+         }
+      }
       for (auto const & [key, value] : this->m_parameters) {
          if (!wroteFirst) {
             wroteFirst = true;
@@ -150,7 +250,7 @@ QVariant NamedParameterBundle::get(BtStringConst const & propertyName) const {
       qInfo() << Q_FUNC_INFO << errorMessage << ", so using generic default";
       return QVariant{};
    }
-   QVariant returnValue = this->m_parameters.at(*propertyName);
+   QVariant returnValue = *storedValue;
    if (!returnValue.isValid()) {
       QString errorMessage =
          QString{"Invalid value (%1) supplied for required parameter, %2"}.arg(returnValue.toString(), *propertyName);
@@ -173,6 +273,12 @@ S & NamedParameterBundle::writeToStream(S & stream, QString const indent) const
    stream << indent << this->size() << "element NamedParameterBundle @" <<
    static_cast<void const *>(this) << " {\n";
    QString const newIndent{QString("   %1").arg(indent)};
+   for (std::size_t ordinal = 0; ordinal < this->m_values.size(); ++ordinal) {
+      if (auto const & value = this->m_values[ordinal]; value) {
+         stream << newIndent << *this->m_layout->propertyName(static_cast<int>(ordinal)) << "->" <<
+         value->typeName() << ":" << value->toString() << "\n";
+      }
+   }
    for (auto const & [key, value] : this->m_parameters) {
       stream << newIndent << key << "->" << value.typeName() << ":" << value.toString() << "\n";
    }
@@ -18,8 +18,12 @@
 #pragma once
 
 #include <cstddef> // for std::size_t
-#include <optional>
 #include <map>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include <QDate>
 #include <QString>
@@ -63,11 +67,56 @@ public:
       NotStrict
    };
 
+   /**
+    * \brief A fixed, ordered list of property names, shared between many bundles that all carry the same parameters
+    *        (eg one bundle per row when \c ObjectStore::loadAll reads a table).  A bundle constructed with a \c Layout
+    *        holds the values for those properties in a flat vector indexed by ordinal, so filling it is just a series
+    *        of vector writes, and reading it back does not require building or comparing any \c QString keys.
+    *
+    *        Property names that are not part of the layout can still be inserted into (and read from) such a bundle;
+    *        they just go via the slower name-keyed storage.
+    */
+   class Layout {
+   public:
+      Layout(std::vector<BtStringConst const *> propertyNames);
+      ~Layout();
+
+      /**
+       * \brief Returns the ordinal of \c propertyName in this layout, or -1 if it is not part of it.
+       *
+       *        We first look up by the address of the underlying C string, which is what almost all callers will hit
+       *        as property names are compile-time constants, and only fall back to comparing characters when that
+       *        fails.
+       */
+      int ordinal(BtStringConst const & propertyName) const;
+
+      std::size_t size() const noexcept;
+
+      BtStringConst const & propertyName(int const ordinal) const;
+
+   private:
+      std::vector<BtStringConst const *> m_propertyNames;
+      std::unordered_map<char const *, int> m_byAddress;
+      std::unordered_map<std::string_view, int> m_byName;
+   };
+
    template<class S> S & writeToStream(S & stream, QString const indent) const;
 
    NamedParameterBundle(OperationMode mode = OperationMode::Strict);
+
+   /**
+    * \brief Construct an empty bundle whose values for the properties in \c layout will be stored by ordinal.
+    */
+   NamedParameterBundle(std::shared_ptr<Layout const> layout, OperationMode mode = OperationMode::Strict);
+
    ~NamedParameterBundle();
 
+   /**
+    * \brief Set the value of the property at \c ordinal in the layout this bundle was constructed with.  This is the
+    *        fast path for bulk loading and does no name look-up at all.
+    */
+   void insert(int const ordinal, QVariant value);
+
    void insert(BtStringConst const & propertyName, QVariant const & value);
 
    void insert(PropertyPath  const & propertyPath, QVariant const & value);
@@ -113,10 +162,11 @@ public:
    template <class T> std::optional<T> optEnumVal(BtStringConst const & propertyName) const {
       // Of course it's a coding error to request a parameter without a name!
       Q_ASSERT(!propertyName.isNull());
-      if (!this->m_parameters.contains(*propertyName)) {
+      QVariant const * storedValue = this->find(propertyName);
+      if (!storedValue) {
          return std::nullopt;
       }
-      auto value = this->m_parameters.at(*propertyName).value< std::optional<int> >();
+      auto value = storedValue->value< std::optional<int> >();
       if (value.has_value()) {
          return std::optional<T>(static_cast<T>(value.value()));
       }
@@ -132,10 +182,11 @@ public:
    template <class T> T val(BtStringConst const & propertyName, T const & defaultValue) const {
       // Of course it's a coding error to request a parameter without a name!
       Q_ASSERT(!propertyName.isNull());
-      if (!this->m_parameters.contains(*propertyName)) {
+      QVariant const * storedValue = this->find(propertyName);
+      if (!storedValue) {
          return defaultValue;
       }
-      return this->m_parameters.at(*propertyName).value<T>();
+      return storedValue->value<T>();
    }
 
    bool containsBundle(BtStringConst const & propertyName) const;
@@ -143,6 +194,11 @@ public:
    NamedParameterBundle const & getBundle(BtStringConst const & propertyName) const;
 
 private:
+   /**
+    * \brief Returns pointer to the stored value for \c propertyName, or \c nullptr if there isn't one
+    */
+   QVariant const * find(BtStringConst const & propertyName) const;
+
    //
    // The default choice here for look-ups would be QMap or QHash.  However, these have the undesirable attribute that
    // they always return a copy of the contained value, which we especially don't want to do for m_containedBundles.
@@ -155,6 +211,12 @@ private:
    // always change it later if I'm wrong.
    //
    std::map<QString, QVariant> m_parameters;
+   //
+   // Only used if we were constructed with a Layout.  An unset std::optional means no value has been supplied for that
+   // ordinal, which is different from an invalid QVariant having been supplied.
+   //
+   std::shared_ptr<Layout const> m_layout;
+   std::vector<std::optional<QVariant>> m_values;
    OperationMode m_mode;
    std::map<QString, NamedParameterBundle> m_containedBundles;
 };
@@ -37,8 +37,10 @@
 
 #include "Algorithms.h"
 #include "config.h"
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
 #include "Localization.h"
+#include "Logging.h"
 #include "measurement/Amount.h"
 #include "measurement/ColorMethods.h"
 #include "measurement/IbuMethods.h"
@@ -201,7 +203,7 @@ public:
    template<class NE> void hardDeleteOrphanedStepOwner() {
       auto stepOwner = this->m_self.get<NE>();
       if (stepOwner && stepOwner->name() == "") {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Checking whether our unnamed" << NE::staticMetaObject.className() << "is used elsewhere";
          auto recipesUsingThisStepOwner = ObjectStoreWrapper::findAllMatching<Recipe>(
             [stepOwner](Recipe const * rec) {
@@ -209,7 +211,7 @@ public:
             }
          );
          if (1 == recipesUsingThisStepOwner.size()) {
-            qDebug() <<
+            qCDebug(logCalc) <<
                Q_FUNC_INFO << "Deleting unnamed" << NE::staticMetaObject.className() << "# " << stepOwner->key() <<
                " used only by Recipe #" << this->m_self.key();
             Q_ASSERT(recipesUsingThisStepOwner.at(0)->key() == this->m_self.key());
@@ -257,7 +259,7 @@ public:
       }
 
       BtStringConst const & property = Recipe::propertyNameFor<NE>();
-      qDebug() << Q_FUNC_INFO << "Setting" << property << "to" << ourId;
+      qCDebug(logCalc) << Q_FUNC_INFO << "Setting" << property << "to" << ourId;
       this->m_self.propagatePropertyChange(property);
 
       connect(val.get(), &NamedEntity::changed, &this->m_self, &Recipe::acceptChangeToContainedObject);
@@ -280,11 +282,11 @@ public:
    template<class NE>
    std::shared_ptr<NE> get(int const & ourId) const {
       // Normally leave the next line commented out otherwise it generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Recipe #" << this->m_self.key() << NE::staticMetaObject.className() << "ID" << ourId;
+//      qCDebug(logCalc) << Q_FUNC_INFO << "Recipe #" << this->m_self.key() << NE::staticMetaObject.className() << "ID" << ourId;
       if (ourId < 0) {
          // Negative ID just means there isn't one -- because this is how we store "NULL" for a foreign key
          // Normally leave the next line commented out otherwise it generates too much logging
-//         qDebug() << Q_FUNC_INFO << "No" << NE::staticMetaObject.className() << "on Recipe #" << this->m_self.key();
+//         qCDebug(logCalc) << Q_FUNC_INFO << "No" << NE::staticMetaObject.className() << "on Recipe #" << this->m_self.key();
          return nullptr;
       }
       auto retVal = ObjectStoreWrapper::getById<NE>(ourId);
@@ -758,7 +760,7 @@ public:
       double calculatedGrainsInMash_kg = 0.0;
 
       for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
-         qDebug() << Q_FUNC_INFO << "fermentableAddition:" << *fermentableAddition;
+         qCDebug(logCalc) << Q_FUNC_INFO << "fermentableAddition:" << *fermentableAddition;
          if (fermentableAddition->fermentable() &&
              fermentableAddition->fermentable()->type() == Fermentable::Type::Grain) {
             // I wouldn't have thought you would want to measure grain by volume, but best to check
@@ -776,7 +778,7 @@ public:
       }
 
       if (!qFuzzyCompare(calculatedGrains_kg, this->m_grains_kg)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated weight of grains: " << calculatedGrains_kg << ", stored weight: " << this->m_grains_kg;
          this->m_grains_kg = calculatedGrains_kg;
@@ -787,7 +789,7 @@ public:
       }
 
       if (!qFuzzyCompare(calculatedGrainsInMash_kg, this->m_grainsInMash_kg)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated weight of grains in mash: " << calculatedGrainsInMash_kg << ", stored weight: " <<
             this->m_grainsInMash_kg;
@@ -877,7 +879,7 @@ public:
 ///      }
 
       if (!qFuzzyCompare(calculatedWortFromMash_l, this->m_wortFromMash_l)) {
-//         qDebug() <<
+//         qCDebug(logCalc) <<
 //            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //            "Calculated wort from mash: " << calculatedWortFromMash_l << ", stored: " << this->m_wortFromMash_l;
          this->m_wortFromMash_l = calculatedWortFromMash_l;
@@ -889,7 +891,7 @@ public:
 
       // TODO: Still need to get rid of m_boilVolume_l
       if (!qFuzzyCompare(calculatedBoilVolume_l, this->m_boilVolume_l)) {
-//         qDebug() <<
+//         qCDebug(logCalc) <<
 //            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //            "Calculated boil volume: " << calculatedBoilVolume_l << ", stored: " << this->m_boilVolume_l;
          this->m_boilVolume_l = calculatedBoilVolume_l;
@@ -900,7 +902,7 @@ public:
       }
 
       if (! qFuzzyCompare(calculatedFinalVolume_l, this->m_finalVolume_l)) {
-//         qDebug() <<
+//         qCDebug(logCalc) <<
 //            Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //            "Calculated final volume: " << calculatedFinalVolume_l << ", stored: " << this->m_finalVolume_l;
          this->m_finalVolume_l = calculatedFinalVolume_l;
@@ -911,7 +913,7 @@ public:
       }
 
       if (! qFuzzyCompare(calculatedPostBoilVolume_l, this->m_postBoilVolume_l)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated post boil volume: " << calculatedPostBoilVolume_l << ", stored: " << this->m_postBoilVolume_l;
          this->m_postBoilVolume_l = calculatedPostBoilVolume_l;
@@ -1005,7 +1007,7 @@ public:
       double nonFermentableSugars_kg   = sugars.nonFermentableSugars_kg;  // Mass of sugar that is not fermentable (also counted in sugar_kg_ignoreEfficiency)
 
       // Uncomment for diagnosing problems with calculations
-//      qDebug() <<
+//      qCDebug(logCalc) <<
 //         Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //         "sugar_kg: " << sugar_kg << ", sugar_kg_ignoreEfficiency: " << sugar_kg_ignoreEfficiency <<
 //         ", nonFermentableSugars_kg:" << nonFermentableSugars_kg;
@@ -1040,7 +1042,7 @@ public:
       double tmp_pnts = (calculatedOg - 1) * 1000.0; // points from all sugars
 
       // Uncomment for diagnosing problems with calculations
-//      qDebug() <<
+//      qCDebug(logCalc) <<
 //         Q_FUNC_INFO << "sugar_kg:" << sugar_kg << ", m_finalVolumeNoLosses_l:" << this->m_finalVolumeNoLosses_l <<
 //         ", plato:" << plato << ", calculatedOg:" << calculatedOg << ", tmp_pnts:" << tmp_pnts;
 
@@ -1088,13 +1090,13 @@ public:
       }
 
       // Uncomment for diagnosing problems with calculations
-//      qDebug() <<
+//      qCDebug(logCalc) <<
 //         Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
 //         "attenuation_pct:" << attenuation_pct << ", m_og_fermentable:" << this->m_og_fermentable <<
 //         ", m_fg_fermentable: " << this->m_fg_fermentable;
 
       if (!qFuzzyCompare(this->m_self.m_og, calculatedOg)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated OG: " << calculatedOg << ", stored: " << this->m_self.m_og;
          this->m_self.m_og = calculatedOg;
@@ -1114,7 +1116,7 @@ public:
       }
 
       if (!qFuzzyCompare(this->m_self.m_fg, calculatedFg)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated FG: " << calculatedFg << ", stored: " << this->m_self.m_fg;
          this->m_self.m_fg = calculatedFg;
@@ -1132,7 +1134,7 @@ public:
    void recalcABV_pct() {
       double const calculatedABV_pct = Algorithms::abvFromOgAndFg(this->m_og_fermentable, this->m_fg_fermentable);
       if (!qFuzzyCompare(calculatedABV_pct, m_ABV_pct)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated ABV: " << calculatedABV_pct << ", stored: " << this->m_ABV_pct;
          this->m_ABV_pct = calculatedABV_pct;
@@ -1161,7 +1163,7 @@ public:
       double calculatedBoilGrav = Algorithms::PlatoToSG_20C20C(Algorithms::getPlato(sugar_kg,
                                                                                     this->boilSizeInLitersOr(0.0)));
       if (! qFuzzyCompare(calculatedBoilGrav, this->m_boilGrav)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated Boil Grav: " << calculatedBoilGrav << ", stored: " << this->m_boilGrav;
          this->m_boilGrav = calculatedBoilGrav;
@@ -1176,7 +1178,7 @@ public:
     * Emits changed(IBU). Depends on: _batchSize_l, _boilGrav, _boilVolume_l, _finalVolume_l
     */
    void recalcIBU() {
-      qDebug() << Q_FUNC_INFO << "Recalculating IBU from" << this->m_IBU;
+      qCDebug(logCalc) << Q_FUNC_INFO << "Recalculating IBU from" << this->m_IBU;
 
       double calculatedIbu = 0.0;
 
@@ -1187,11 +1189,11 @@ public:
       this->m_ibus.clear();
       for (auto const & hopAddition : this->m_self.hopAdditions()) {
          double tmp = this->m_self.ibuFromHopAddition(*hopAddition);
-         qDebug() << Q_FUNC_INFO << *hopAddition << "gave IBU" << tmp;
+         qCDebug(logCalc) << Q_FUNC_INFO << *hopAddition << "gave IBU" << tmp;
          this->m_ibus.append(tmp);
          calculatedIbu += tmp;
       }
-      qDebug() << Q_FUNC_INFO << "Calculated IBU from hops" << calculatedIbu;
+      qCDebug(logCalc) << Q_FUNC_INFO << "Calculated IBU from hops" << calculatedIbu;
 
       // Bitterness due to hopped extracts...
       for (auto const & fermentableAddition : this->m_self.fermentableAdditions()) {
@@ -1205,10 +1207,10 @@ public:
                fermentableAddition->fermentable()->key() << ":" << fermentableAddition->name();
          }
       }
-      qDebug() << Q_FUNC_INFO << "Calculated IBU from hops and fermentables" << calculatedIbu;
+      qCDebug(logCalc) << Q_FUNC_INFO << "Calculated IBU from hops and fermentables" << calculatedIbu;
 
       if (! qFuzzyCompare(calculatedIbu, this->m_IBU)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated IBU: " << calculatedIbu << ", stored: " << this->m_IBU;
          this->m_IBU = calculatedIbu;
@@ -1267,7 +1269,7 @@ public:
       }
 
       if (!qFuzzyCompare(calculatedCaloriesPerLiter, this->m_caloriesPerLiter)) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Recipe #" << this->m_self.key() << "(" << this->m_self.name() << ") "
             "Calculated calories/liter: " << calculatedCaloriesPerLiter << ", stored: " << this->m_caloriesPerLiter;
          this->m_caloriesPerLiter = calculatedCaloriesPerLiter;
@@ -1751,7 +1753,7 @@ Recipe::~Recipe() = default;
 void Recipe::setKey(int key) {
    this->NamedEntity::setKey(key);
 
-   qDebug() << Q_FUNC_INFO << "Promulgating key for Recipe #" << key;
+   qCDebug(logCalc) << Q_FUNC_INFO << "Promulgating key for Recipe #" << key;
 
    //
    // This function is called because we've just inserted a new Recipe in the DB and we now know its primary key.
@@ -1772,7 +1774,7 @@ void Recipe::setKey(int key) {
    // .:TBD:. Would it really be so bad for Ancestor ID to be NULL in the DB when there is no direct ancestor?
    //
    if (this->m_ancestor_id <= 0) {
-      qDebug() << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
+      qCDebug(logCalc) << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
 
       // We want to store the new ancestor ID in the DB, but we don't want to signal the UI about this change, so
       // suppress signal sending.
@@ -2168,7 +2170,7 @@ template<> void Recipe::set(std::shared_ptr<Style       > val) { this->setStyle
 template<> void Recipe::set(std::shared_ptr<Equipment   > val) { this->setEquipment   (val); return; }
 template<> void Recipe::set(std::shared_ptr<Water       > val) {
    // We didn't yet figure out what setWater on Recipe should mean!
-   qDebug() << Q_FUNC_INFO << "Operation not supported";
+   qCDebug(logCalc) << Q_FUNC_INFO << "Operation not supported";
    return;
 }
 
@@ -2329,7 +2331,7 @@ QList<std::shared_ptr<Recipe>> Recipe::ancestors() const {
       //     now just the ancestors in the list.
       Recipe * recipe = const_cast<Recipe *>(this);
       while (recipe && recipe->m_ancestor_id > 0 && recipe->m_ancestor_id != recipe->key()) {
-         qDebug() <<
+         qCDebug(logCalc) <<
             Q_FUNC_INFO << "Search ancestors for Recipe #" << recipe->key() << "with m_ancestor_id" <<
             recipe->m_ancestor_id;
          auto ancestor = ObjectStoreWrapper::getById<Recipe>(recipe->m_ancestor_id);
@@ -2340,7 +2342,7 @@ QList<std::shared_ptr<Recipe>> Recipe::ancestors() const {
             break;
          }
 
-         qDebug() << Q_FUNC_INFO << "Found ancestor Recipe #" << ancestor->key();
+         qCDebug(logCalc) << Q_FUNC_INFO << "Found ancestor Recipe #" << ancestor->key();
          ancestor->m_hasDescendants = true;
          this->m_ancestors.append(ancestor);
          recipe = ancestor.get();
@@ -2417,7 +2419,7 @@ void Recipe::setAncestor(Recipe & ancestor) {
    //    - Recipe A is modified
    // This means that, if Recipe A already has a direct ancestor, then Recipe B needs to take it
    //
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "Setting Recipe #" << ancestor.key() << "to be immediate prior version (ancestor) of Recipe #" <<
       this->key();
 
@@ -2603,7 +2605,7 @@ std::optional<double> Recipe::apparentAttenuation_pct() const { return m_apparen
 //==============================Recalculators==================================
 
 void Recipe::recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged) {
-   qDebug() << Q_FUNC_INFO << classNameOfWhatWasAddedOrChanged;
+   qCDebug(logCalc) << Q_FUNC_INFO << classNameOfWhatWasAddedOrChanged;
    // We could just compare with "Hop", "Equipment", etc but there's then no compile-time checking of typos.  Using
    // ::staticMetaObject.className() is a bit more clunky but it's safer.
 
@@ -2632,7 +2634,7 @@ void Recipe::recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged) {
 }
 
 void Recipe::recalcAll() {
-   qDebug() << Q_FUNC_INFO << "Calculations " << (this->m_calcsEnabled ? "enabled" : "disabled") << "for" << *this;
+   qCDebug(logCalc) << Q_FUNC_INFO << "Calculations " << (this->m_calcsEnabled ? "enabled" : "disabled") << "for" << *this;
    if (!this->m_calcsEnabled) {
       return;
    }
@@ -2662,7 +2664,7 @@ void Recipe::recalcAll() {
 
    this->m_recalcMutex.unlock();
 
-   qDebug() << Q_FUNC_INFO << "After calculations:" << *this;
+   qCDebug(logCalc) << Q_FUNC_INFO << "After calculations:" << *this;
    return;
 }
 
@@ -2674,7 +2676,7 @@ Recipe::Sugars Recipe::calcTotalPoints() {
 
    for (auto const & fermentableAddition : this->fermentableAdditions()) {
       auto const & fermentable = fermentableAddition->fermentable();
-      qDebug() <<
+      qCDebug(logCalc) <<
          "calcTotalPoints Rec" << this->key() << "(" << this->name() << ") "
          "Ferm Add" << fermentable->key() << "(" << fermentable->name() << ") equivSucrose_kg" <<
          fermentableAddition->equivSucrose_kg() << ", isSugar?" << fermentable->isSugar() << ", isExtract?" <<
@@ -2722,7 +2724,7 @@ double Recipe::ibuFromHopAddition(RecipeAdditionHop const & hopAddition) {
 
    // It's a coding error to ask one recipe about another's hop additions!  Uncomment the log statement here if the
    // assert is firing.
-//   qDebug() << Q_FUNC_INFO << *this << " / " << hopAddition << "; hopAddition.recipeId():" << hopAddition.recipeId();
+//   qCDebug(logCalc) << Q_FUNC_INFO << *this << " / " << hopAddition << "; hopAddition.recipeId():" << hopAddition.recipeId();
    Q_ASSERT(hopAddition.recipeId() == this->key());
 
    double AArating = hopAddition.hop()->alpha_pct() / 100.0;
@@ -2766,7 +2768,7 @@ double Recipe::ibuFromHopAddition(RecipeAdditionHop const & hopAddition) {
       }
    }
 
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "Equipment" << (equipment ? "set" : "not set") << ", Boil" << (boil ? "present" : "not present") <<
       ", Hop Utilization =" << hopUtilization << ", Boil Time (Mins) =" << boilTime_mins << ", Hop Addition" <<
       hopAddition << ", stage =" << hopAddition.stage() << ", grams =" << grams << ", hopTimeInBoil_mins = " <<
@@ -2792,10 +2794,10 @@ double Recipe::ibuFromHopAddition(RecipeAdditionHop const & hopAddition) {
    } else if (hopAddition.stage() == RecipeAddition::Stage::Mash && mashHopAdjust > 0.0) {
       ibus = mashHopAdjust * IbuMethods::getIbus(parms);
    } else {
-      qDebug() << Q_FUNC_INFO << "No IBUs from " << hopAddition;
+      qCDebug(logCalc) << Q_FUNC_INFO << "No IBUs from " << hopAddition;
    }
 
-   qDebug() << Q_FUNC_INFO << "IBUs before adjustment for form =" << ibus;
+   qCDebug(logCalc) << Q_FUNC_INFO << "IBUs before adjustment for form =" << ibus;
 
    // Adjust for hop form. Tinseth's table was created from whole cone data,
    // and it seems other formulae are optimized that way as well. So, the
@@ -2889,13 +2891,13 @@ void Recipe::acceptChangeToContainedObject(QMetaProperty prop, QVariant val) {
    // This tells us which object sent us the signal
    QObject * signalSender = this->sender();
    if (!signalSender) {
-      qDebug() << Q_FUNC_INFO << "No sender";
+      qCDebug(logCalc) << Q_FUNC_INFO << "No sender";
       return;
    }
 
    QString signalSenderClassName = signalSender->metaObject()->className();
    QString propName = prop.name();
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "Signal received from " << signalSenderClassName << ": changed" << propName << "to" << val;;
 
    //
@@ -2903,11 +2905,11 @@ void Recipe::acceptChangeToContainedObject(QMetaProperty prop, QVariant val) {
    //
    Equipment * equipment = qobject_cast<Equipment *>(signalSender);
    if (equipment) {
-      qDebug() << Q_FUNC_INFO << "Equipment #" << equipment->key() << "(ours=" << this->m_equipmentId << ")";
+      qCDebug(logCalc) << Q_FUNC_INFO << "Equipment #" << equipment->key() << "(ours=" << this->m_equipmentId << ")";
       Q_ASSERT(equipment->key() == this->m_equipmentId);
       if (propName == *PropertyNames::Equipment::kettleBoilSize_l) {
          Q_ASSERT(val.canConvert<double>());
-         qDebug() << Q_FUNC_INFO << "We" << (this->boil() ? "have" : "don't have") << "a boil";
+         qCDebug(logCalc) << Q_FUNC_INFO << "We" << (this->boil() ? "have" : "don't have") << "a boil";
          if (this->boil()) {
             this->boil()->setPreBoilSize_l(val.value<double>());
          }
@@ -3017,7 +3019,7 @@ double Recipe::targetCollectedWortVol_l() const {
 
    double const returnValue = boilSize_liters - lauteringDeadspaceLoss_l - topUpKettle_l - postMashAdditionVolume_l;
 
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "boilSize_liters:" << boilSize_liters << ", postMashAdditionVolume_l:" <<
       postMashAdditionVolume_l << ", lauteringDeadspaceLoss_l:" << lauteringDeadspaceLoss_l << ", topUpKettle_l:" <<
       topUpKettle_l << ", returnValue:" << returnValue;
@@ -3045,7 +3047,7 @@ double Recipe::targetTotalMashVol_l() const {
    double const grainsInMash_kg = this->grainsInMash_kg();
 
    double const returnValue = targetCollectedWortVol_l + absorption_lKg * grainsInMash_kg;
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "targetCollectedWortVol_l:" << targetCollectedWortVol_l << ", absorption_lKg:" <<
       absorption_lKg << ", grainsInMash_kg:" << grainsInMash_kg << ", returnValue:" << returnValue;
    return returnValue;
@@ -3108,7 +3110,7 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
       return;
    }
 
-   qDebug() <<
+   qCDebug(logCalc) <<
       Q_FUNC_INFO << "Modifying: " << ne.metaObject()->className() << "#" << ne.key() << "property" << propertyName;
 
    //
@@ -3135,7 +3137,7 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
 
    // If the object we're about to change already has descendants, then we don't want to create new ones.
    if (owningRecipe->hasDescendants()) {
-      qDebug() << Q_FUNC_INFO << "Recipe #" << owningRecipe->key() << "already has descendants, so not creating any more";
+      qCDebug(logCalc) << Q_FUNC_INFO << "Recipe #" << owningRecipe->key() << "already has descendants, so not creating any more";
       return;
    }
 
@@ -3153,14 +3155,17 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
 
    // Create a deep copy of the Recipe, and put it in the DB, so it has an ID.
    // (This will also emit signalObjectInserted for the new Recipe from ObjectStoreTyped<Recipe>.)
-   qDebug() << Q_FUNC_INFO << "Copying Recipe" << owningRecipe->key();
+   qCDebug(logCalc) << Q_FUNC_INFO << "Copying Recipe" << owningRecipe->key();
+
+   // The deep copy, and the ancestor link below, do many separate writes, which we want in one DB transaction
+   DbUnitOfWork unitOfWork{"Version Recipe"};
 
    // We also don't want to trigger versioning on the newly spawned Recipe until we're completely done here!
    std::shared_ptr<Recipe> spawn = std::make_shared<Recipe>(*owningRecipe);
    NamedEntityModifyingMarker spawnModifyingMarker(*spawn);
    ObjectStoreWrapper::insert(spawn);
 
-   qDebug() << Q_FUNC_INFO << "Copied Recipe #" << owningRecipe->key() << "to new Recipe #" << spawn->key();
+   qCDebug(logCalc) << Q_FUNC_INFO << "Copied Recipe #" << owningRecipe->key() << "to new Recipe #" << spawn->key();
 
    // We assert that the newly created version of the recipe has not yet been brewed (and therefore will not get
    // automatically versioned on subsequent changes before it is brewed).
@@ -3194,14 +3199,14 @@ bool RecipeHelper::getAutomaticVersioningEnabled() {
 RecipeHelper::SuspendRecipeVersioning::SuspendRecipeVersioning() {
    this->savedVersioningValue = RecipeHelper::getAutomaticVersioningEnabled();
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
+      qCDebug(logCalc) << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(false);
    }
    return;
 }
 RecipeHelper::SuspendRecipeVersioning::~SuspendRecipeVersioning() {
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
+      qCDebug(logCalc) << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(true);
    }
    return;
@@ -146,12 +146,16 @@ class Recipe : public NamedEntity,
    /**
     * \brief \c MainWindow is a friend so it can access \c Recipe::recalcAll() and \c Recipe::recalcIfNeeded()
     *        \c BrewDayScrollWidget is a friend so it can access \c Recipe::m_instructions
+    *        \c BatchRunner is a friend so it can access \c Recipe::recalcAll() when running headless
+    *        \c Benchmarks is a friend so it can time \c Recipe::recalcAll()
     *
     *        In the long run, we should fix this, so that \c MainWindow doesn't need to call private member functions on
     *        \c Recipe.
     */
    friend class MainWindow;
    friend class BrewDayScrollWidget;
+   friend class BatchRunner;
+   friend class Benchmarks;
 
 public:
    /**
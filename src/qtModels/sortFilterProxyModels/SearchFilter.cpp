@@ -0,0 +1,68 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * qtModels/sortFilterProxyModels/SearchFilter.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * <http://www.gnu.org/licenses/>.
+#include "qtModels/sortFilterProxyModels/SearchFilter.h"
+
+#include <utility>
+
+#include <QObject>
+
+#include "database/SearchIndex.h"
+
+SearchFilter::SearchFilter(std::function<void()> invalidateFilter) :
+   m_invalidateFilter{std::move(invalidateFilter)},
+   m_searchIndex{nullptr},
+   m_searchIndexConnection{},
+   m_searchText{},
+   m_searchMatches{} {
+   return;
+}
+
+SearchFilter::~SearchFilter() {
+   // The lambda we connected captures this, so it mustn't outlive us
+   QObject::disconnect(this->m_searchIndexConnection);
+   return;
+}
+
+void SearchFilter::setSearch(SearchIndex const & searchIndex, QString const & searchText) {
+   if (this->m_searchIndex != &searchIndex) {
+      QObject::disconnect(this->m_searchIndexConnection);
+      this->m_searchIndex = &searchIndex;
+      this->m_searchIndexConnection = QObject::connect(&searchIndex, &SearchIndex::updated, [this]() {
+         // Nothing to do if we are showing everything anyway
+         if (this->m_searchMatches) {
+            this->setSearchMatches(this->m_searchIndex->matchingKeys(this->m_searchText));
+         }
+         return;
+      });
+   }
+   this->m_searchText = searchText;
+   this->setSearchMatches(searchIndex.matchingKeys(searchText));
+   return;
+}
+
+bool SearchFilter::isActive() const {
+   return this->m_searchMatches.has_value();
+}
+
+bool SearchFilter::matches(int const key) const {
+   return this->m_searchMatches && this->m_searchMatches->contains(key);
+}
+
+void SearchFilter::setSearchMatches(std::optional<QSet<int>> searchMatches) {
+   this->m_searchMatches = std::move(searchMatches);
+   this->m_invalidateFilter();
+   return;
+}
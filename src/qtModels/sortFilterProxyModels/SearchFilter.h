@@ -0,0 +1,72 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * qtModels/sortFilterProxyModels/SearchFilter.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ * <http://www.gnu.org/licenses/>.
+#ifndef SORTFILTERPROXYMODELS_SEARCHFILTER_H
+#define SORTFILTERPROXYMODELS_SEARCHFILTER_H
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include <QMetaObject>
+#include <QSet>
+#include <QString>
+
+class SearchIndex;
+
+/**
+ * \brief The search state shared by \c SortFilterProxyModelBase and \c TreeSortFilterProxyModelBase: which
+ *        \c SearchIndex we are searching, for what, and the keys of the objects that matched.
+ *
+ *        The search is re-run whenever the \c SearchIndex is updated, so that, eg, a newly-added or renamed object
+ *        shows or hides as appropriate without the user having to retype the search.  Each time the matches change,
+ *        we call the \c invalidateFilter function supplied to the constructor, so that the owning proxy model can
+ *        re-filter its rows.
+ */
+class SearchFilter {
+public:
+   SearchFilter(std::function<void()> invalidateFilter);
+   ~SearchFilter();
+
+   /**
+    * \brief Search \c searchIndex for \c searchText (see \c SearchIndex::matchingKeys).  Blank \c searchText turns
+    *        the search off.
+    */
+   void setSearch(SearchIndex const & searchIndex, QString const & searchText);
+
+   /**
+    * \brief Returns \c true if there is a search in effect, in which case only objects for which \c matches returns
+    *        \c true should be shown.
+    */
+   bool isActive() const;
+
+   /**
+    * \brief Returns \c true if the object with primary key \c key matched the current search.  Should only be called
+    *        when \c isActive() is \c true.
+    */
+   bool matches(int const key) const;
+
+private:
+   void setSearchMatches(std::optional<QSet<int>> searchMatches);
+
+   std::function<void()> const m_invalidateFilter;
+   //! The index, if any, that \c m_searchMatches came from, and the text we searched it for
+   SearchIndex const * m_searchIndex;
+   QMetaObject::Connection m_searchIndexConnection;
+   QString m_searchText;
+   std::optional<QSet<int>> m_searchMatches;
+};
+
+#endif
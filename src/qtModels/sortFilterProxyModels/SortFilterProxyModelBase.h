@@ -19,6 +19,10 @@
 #pragma once
 
 #include <QDebug>
+#include <QString>
+
+#include "database/SearchIndex.h"
+#include "qtModels/sortFilterProxyModels/SearchFilter.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 
 /**
@@ -45,7 +49,18 @@ public:
     * \param filter If \c true then we only show "displayable" items; if \c false then we show everything
     */
    SortFilterProxyModelBase(bool filter) :
-      m_filter{filter} {
+      m_filter{filter},
+      m_searchFilter{[this]() { this->derived().invalidateFilter(); }} {
+      return;
+   }
+
+   /**
+    * \brief Restrict the rows shown (in a table model) to those for objects matching \c searchText in \c searchIndex
+    *        (see \c SearchIndex::matchingKeys).  This replaces matching against \c filterRegularExpression().  Blank
+    *        \c searchText goes back to the normal behaviour.  See \c SearchFilter for more details.
+    */
+   void setSearch(SearchIndex const & searchIndex, QString const & searchText) {
+      this->m_searchFilter.setSearch(searchIndex, searchText);
       return;
    }
 
@@ -94,6 +109,10 @@ protected:
             return false;
          }
 
+         if (this->m_searchFilter.isActive()) {
+            return this->m_searchFilter.matches(tableModel->getRow(source_row)->key());
+         }
+
          // The filterRegularExpression() member function we call here is inherited from QSortFilterProxyModel
          QRegularExpression const filterRegExp {this->derived().filterRegularExpression()};
          QString const dataAsString {tableModel->data(index).toString()};
@@ -180,6 +199,7 @@ protected:
 
 private:
    bool const m_filter;
+   SearchFilter m_searchFilter;
 };
 
 
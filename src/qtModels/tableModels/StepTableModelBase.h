@@ -17,6 +17,7 @@
 #define TABLEMODELS_STEPTABLEMODELBASE_H
 #pragma once
 
+#include <algorithm> // For std::min
 #include <memory>
 
 #include <QDebug>
@@ -56,6 +57,8 @@ public:
             this->derived().disconnect(step.get(), nullptr, &this->derived(), nullptr);
          }
          this->derived().m_rows.clear();
+         this->derived().rebuildRowIndex();
+         this->derived().m_cellDataCache.clear();
          this->derived().endRemoveRows();
       }
 
@@ -86,6 +89,7 @@ public:
                "rows";
             this->derived().beginInsertRows(QModelIndex(), 0, tmpSteps.size() - 1);
             this->derived().m_rows = tmpSteps;
+            this->derived().rebuildRowIndex();
             for (auto step : this->derived().m_rows) {
                this->derived().connect(step.get(), &NamedEntity::changed, &this->derived(), &Derived::stepChanged);
             }
@@ -108,7 +112,7 @@ public:
 protected:
    //! \returns true if \c step is successfully found and removed.
    bool doRemoveStep(std::shared_ptr<StepClass> step) {
-      int ii {static_cast<int>(this->derived().m_rows.indexOf(step))};
+      int ii {this->derived().findIndexOf(step.get())};
       if (ii >= 0) {
          qDebug() <<
             Q_FUNC_INFO << "Removing" << StepClass::staticMetaObject.className() << step->name() << "(#" <<
@@ -116,6 +120,9 @@ protected:
          this->derived().beginRemoveRows(QModelIndex(), ii, ii);
          this->derived().disconnect(step.get(), nullptr, &this->derived(), nullptr);
          this->derived().m_rows.removeAt(ii);
+         this->derived().m_rowIndex.remove(step.get());
+         this->derived().rebuildRowIndex(ii);
+         this->derived().m_cellDataCache.invalidate(step.get());
          //reset(); // Tell everybody the table has changed.
          this->derived().endRemoveRows();
 
@@ -169,6 +176,7 @@ private:
       // current -1 when moving up, and swap current with current+1 when moving
       // down
       this->derived().m_rows.swapItemsAt(current, current + doSomething);
+      this->derived().rebuildRowIndex(std::min(current, current + doSomething));
       this->derived().endMoveRows();
       return;
    }
@@ -217,6 +225,7 @@ protected:
 
          int ii = this->derived().findIndexOf(stepSender);
          if (ii >= 0) {
+            this->derived().m_cellDataCache.invalidate(stepSender);
             if (prop.name() == PropertyNames::EnumeratedBase::stepNumber) {
 //               qDebug().noquote() << Q_FUNC_INFO << Logging::getStackTrace();
                this->reorderStep(this->derived().m_rows.at(ii), ii);
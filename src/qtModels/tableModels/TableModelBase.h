@@ -17,12 +17,16 @@
 #define TABLEMODELS_TABLEMODELBASE_H
 #pragma once
 
+#include <algorithm> // For std::max, std::sort
 #include <type_traits>
 #include <utility> // For std::pair
 #include <vector>
 
+#include <QHash>
 #include <QList>
 #include <QModelIndex>
+#include <QSet>
+#include <QTimer>
 
 #include "database/ObjectStoreTyped.h"
 #include "database/ObjectStoreWrapper.h"
@@ -34,6 +38,7 @@
 #include "model/Recipe.h"
 #include "qtModels/tableModels/BtTableModel.h"
 #include "undoRedo/UndoableAddOrRemove.h"
+#include "utils/CellDataCache.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 #include "utils/MetaTypes.h"
 #include "utils/PropertyHelper.h"
@@ -135,7 +140,13 @@ public:
    using ColumnIndex = typename TableModelTraits<Derived>::ColumnIndex;
 
 protected:
-   TableModelBase() : m_rows{} {
+   TableModelBase() :
+      m_rows{},
+      m_rowIndex{},
+      m_pendingChangedRows{},
+      m_changedRowsFlushScheduled{false},
+      m_cellDataCache{Derived::staticMetaObject.className()},
+      m_cacheableColumns{} {
       return;
    }
    // Need a virtual destructor as we have a virtual member function
@@ -162,6 +173,33 @@ public:
       return this->get_ColumnInfo(columnIndex);
    }
 
+   /**
+    * \brief Turn on (or off) caching of the results of \c readDataFromModel.  See \c CellDataCache for more details.
+    *
+    *        We only cache columns whose value we know will be signalled by a \c NamedEntity::changed signal from the
+    *        row object, ie where the property path is a single stored property of \c NE.  Properties of contained
+    *        objects (eg \c alpha_pct of the \c Hop in a \c RecipeAdditionHop) and computed properties (eg
+    *        \c numRecipesUsedIn) are always read afresh.
+    */
+   void setCellCacheEnabled(bool const enabled) {
+      this->m_cacheableColumns.clear();
+      if (enabled) {
+         int const numColumns = this->derived().columnCount();
+         this->m_cacheableColumns.reserve(numColumns);
+         for (int column = 0; column < numColumns; ++column) {
+            auto const & properties = this->get_ColumnInfo(static_cast<ColumnIndex>(column)).propertyPath.properties();
+            bool cacheable = false;
+            if (properties.size() == 1) {
+               int const propertyIndex = NE::staticMetaObject.indexOfProperty(**properties.first());
+               cacheable = propertyIndex >= 0 && NE::staticMetaObject.property(propertyIndex).isStored();
+            }
+            this->m_cacheableColumns.push_back(cacheable);
+         }
+      }
+      this->m_cellDataCache.setEnabled(enabled);
+      return;
+   }
+
    /**
     * \brief Observe a recipe's list of NE (hops, fermentables, etc).  Mostly called from Derived::observeRecipe.
     */
@@ -237,12 +275,15 @@ public:
    QList< std::shared_ptr<NE> > removeDuplicates(QList< std::shared_ptr<NE> > items,
                                                  Recipe const * recipe = nullptr) {
       decltype(items) tmp;
+      // We also need to catch duplicates within items itself, otherwise m_rowIndex would get out of step with m_rows
+      QSet<NE const *> seen;
 
       for (auto ii : items) {
          if (!recipe && ii->deleted()) {
             continue;
          }
-         if (!this->m_rows.contains(ii) ) {
+         if (!this->m_rowIndex.contains(ii.get()) && !seen.contains(ii.get())) {
+            seen.insert(ii.get());
             tmp.append(ii);
          }
       }
@@ -263,23 +304,43 @@ public:
     *
     *        Function name is for consistency with \c QList::indexOf
     *
+    *        This is called for every \c changed signal from every row, so we look up in \c m_rowIndex rather than
+    *        scanning \c m_rows.
+    *
     * \param object  what to search for
     * \return index of object in this->m_rows or -1 if it's not found
     */
    int findIndexOf(NE const * object) const {
-      for (int index = 0; index < this->m_rows.size(); ++index) {
-         if (this->m_rows.at(index).get() == object) {
-            return index;
-         }
+      return this->m_rowIndex.value(object, -1);
+   }
+
+   /**
+    * \brief Bring \c m_rowIndex back in step with \c m_rows, from \c fromRow onwards.  Anything that modifies
+    *        \c m_rows directly (rather than via \c add, \c remove etc) needs to call this afterwards.  (Eg
+    *        \c StepTableModelBase does.)
+    *
+    *        Only rows at or after \c fromRow are renumbered, so removing a row near the end of a large table stays
+    *        cheap.  This means that, when \c fromRow is not 0, the caller is responsible for taking any rows it has
+    *        dropped from \c m_rows out of \c m_rowIndex itself (see \c remove).
+    *
+    * \param fromRow Rows before this one are assumed not to have moved.  The default rebuilds the whole index.
+    */
+   void rebuildRowIndex(int const fromRow = 0) {
+      if (fromRow <= 0) {
+         this->m_rowIndex.clear();
+         this->m_rowIndex.reserve(this->m_rows.size());
+      }
+      for (int index = std::max(fromRow, 0); index < this->m_rows.size(); ++index) {
+         this->m_rowIndex.insert(this->m_rows.at(index).get(), index);
       }
-      return -1;
+      return;
    }
 
    void add(std::shared_ptr<NE> item) {
       qDebug() << Q_FUNC_INFO << item->name();
 
       // Check to see if it's already in the list
-      if (this->m_rows.contains(item)) {
+      if (this->m_rowIndex.contains(item.get())) {
          return;
       }
 
@@ -292,6 +353,7 @@ public:
       int size = this->m_rows.size();
       this->derived().beginInsertRows(QModelIndex(), size, size);
       this->m_rows.append(item);
+      this->m_rowIndex.insert(item.get(), size);
       this->derived().connect(item.get(), &NamedEntity::changed, &this->derived(), &Derived::changed);
       this->derived().added(item);
       //reset(); // Tell everybody that the table has changed.
@@ -315,11 +377,14 @@ public:
 
    //! \returns true if \c item is successfully found and removed.
    bool remove(std::shared_ptr<NE> item) {
-      int rowNum = this->m_rows.indexOf(item);
+      int rowNum = this->findIndexOf(item.get());
       if (rowNum >= 0)  {
          this->derived().beginRemoveRows(QModelIndex(), rowNum, rowNum);
          this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
          this->m_rows.removeAt(rowNum);
+         this->m_rowIndex.remove(item.get());
+         this->rebuildRowIndex(rowNum);
+         this->m_cellDataCache.invalidate(item.get());
 
          this->derived().removed(item);
 
@@ -495,6 +560,7 @@ protected:
          this->derived().beginInsertRows(QModelIndex(), size, size + tmp.size() - 1);
 
          this->m_rows.append(tmp);
+         this->rebuildRowIndex(size);
 
          for (auto item : tmp) {
             this->derived().connect(item.get(), &NamedEntity::changed, &this->derived(), &Derived::changed);
@@ -506,6 +572,59 @@ protected:
       return;
    }
 
+   /**
+    * \brief Insert and move rows so that \c m_rows is in the same order as \c items.  Caller should already have
+    *        removed any rows that are not in \c items.  Runs of new items are inserted with a single
+    *        \c beginInsertRows, and rows that are already in the right place are left alone, so, in the usual case of
+    *        one item being added to a recipe, this is one insert and no moves.
+    */
+   void matchRowOrder(QList< std::shared_ptr<NE> > const & items) {
+      int row = 0;
+      QSet<NE const *> seen;
+      QList< std::shared_ptr<NE> > newItems;
+      auto insertNewItems = [this, &row, &newItems]() {
+         if (newItems.isEmpty()) {
+            return;
+         }
+         this->derived().beginInsertRows(QModelIndex(), row, row + newItems.size() - 1);
+         for (int ii = 0; ii < newItems.size(); ++ii) {
+            this->m_rows.insert(row + ii, newItems.at(ii));
+         }
+         this->rebuildRowIndex(row);
+         for (auto item : newItems) {
+            this->derived().connect(item.get(), &NamedEntity::changed, &this->derived(), &Derived::changed);
+            this->derived().added(item);
+         }
+         this->derived().endInsertRows();
+         row += newItems.size();
+         newItems.clear();
+         return;
+      };
+
+      for (auto const & item : items) {
+         if (seen.contains(item.get())) {
+            continue;
+         }
+         seen.insert(item.get());
+         int const currentRow = this->findIndexOf(item.get());
+         if (currentRow < 0) {
+            newItems.append(item);
+            continue;
+         }
+         insertNewItems();
+         // Everything before row is already in place, so, if this row has to move, it's always up
+         if (currentRow != row) {
+            this->derived().beginMoveRows(QModelIndex(), currentRow, currentRow, QModelIndex(), row);
+            this->m_rows.move(currentRow, row);
+            this->rebuildRowIndex(row);
+            this->derived().endMoveRows();
+         }
+         ++row;
+      }
+      insertNewItems();
+      return;
+   }
+
    /**
     * \brief Clear the model.
     */
@@ -518,6 +637,8 @@ protected:
             this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
             //this->derived().removed(item); // Shouldn't be necessary as we call updateTotals() below
          }
+         this->m_rowIndex.clear();
+         this->m_cellDataCache.clear();
          this->derived().endRemoveRows();
          this->derived().updateTotals();
       }
@@ -600,6 +721,16 @@ protected:
       //    QAbstractItemView::edit()
       //
       auto row = this->m_rows[index.row()];
+
+      bool const cacheable = index.column() < static_cast<int>(this->m_cacheableColumns.size()) &&
+                             this->m_cacheableColumns[index.column()];
+      if (cacheable) {
+         std::optional<QVariant> cachedData = this->m_cellDataCache.get(row.get(), index.column(), role);
+         if (cachedData) {
+            return *cachedData;
+         }
+      }
+
       BtTableModel::ColumnInfo const & columnInfo = this->get_ColumnInfo(index);
 
       QVariant modelData = columnInfo.propertyPath.getValue(*row);
@@ -618,13 +749,16 @@ protected:
 //         Q_FUNC_INFO << columnInfo.columnFqName << ", propertyPath:" << columnInfo.propertyPath << "TypeInfo:" <<
 //         typeInfo << ", modelData:" << modelData;
 
-      return PropertyHelper::readDataFromPropertyValue(modelData,
-                                                       typeInfo,
-                                                       role,
-                                                       columnInfo.extras.has_value(),
-                                                       columnInfo.getForcedSystemOfMeasurement(),
-                                                       columnInfo.getForcedRelativeScale());
-
+      QVariant displayData = PropertyHelper::readDataFromPropertyValue(modelData,
+                                                                       typeInfo,
+                                                                       role,
+                                                                       columnInfo.extras.has_value(),
+                                                                       columnInfo.getForcedSystemOfMeasurement(),
+                                                                       columnInfo.getForcedRelativeScale());
+      if (cacheable) {
+         this->m_cellDataCache.insert(row.get(), index.column(), role, displayData);
+      }
+      return displayData;
    }
 
    /**
@@ -681,6 +815,7 @@ protected:
             if (InventoryTools::hasInventory<NE>(*ingredient)) {
                std::shared_ptr<typename NE::InventoryClass> inventory = InventoryTools::getInventory(*ingredient);
                if (inventory->key() == invKey) {
+                  this->m_cellDataCache.invalidate(ingredient.get());
                   emit this->derived().dataChanged(
                      this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory)),
                      this->derived().createIndex(ii, static_cast<int>(Derived::ColumnIndex::TotalInventory))
@@ -699,14 +834,53 @@ protected:
       return;
    }
 
+   /**
+    * \brief Called when the observed recipe gains or loses items.  Rather than resetting the whole table, we work out
+    *        which rows have gone and which are new, and tell the view about just those.  Rows that are removed are
+    *        removed in contiguous ranges (working backwards so earlier row numbers remain valid) and new rows are
+    *        appended at the end.
+    */
    template<class Caller>
    void checkRecipeItems(Recipe * recipe) requires IsTableModel<Caller> && ObservesRecipe<Caller>{
       qDebug() << Q_FUNC_INFO;
       if (recipe == this->derived().recObs) {
-         this->removeAll();
          // TBD: Commented out version doesn't compile on GCC
-         // this->addItems(this->derived().recObs->allOwned<NE>());
-         this->addItems(recipe->allOwned<NE>());
+         // auto const currentItems = this->derived().recObs->allOwned<NE>();
+         auto const currentItems = recipe->allOwned<NE>();
+         QSet<NE const *> stillInRecipe;
+         stillInRecipe.reserve(currentItems.size());
+         for (auto const & item : currentItems) {
+            stillInRecipe.insert(item.get());
+         }
+
+         int const originalSize = this->m_rows.size();
+         int lowestRemovedRow = originalSize;
+         for (int lastRow = originalSize - 1; lastRow >= 0; --lastRow) {
+            if (stillInRecipe.contains(this->m_rows.at(lastRow).get())) {
+               continue;
+            }
+            int firstRow = lastRow;
+            while (firstRow > 0 && !stillInRecipe.contains(this->m_rows.at(firstRow - 1).get())) {
+               --firstRow;
+            }
+            this->derived().beginRemoveRows(QModelIndex(), firstRow, lastRow);
+            for (int row = lastRow; row >= firstRow; --row) {
+               auto item = this->m_rows.takeAt(row);
+               this->m_rowIndex.remove(item.get());
+               this->m_cellDataCache.invalidate(item.get());
+               this->derived().disconnect(item.get(), nullptr, &this->derived(), nullptr);
+            }
+            this->derived().endRemoveRows();
+            lowestRemovedRow = firstRow;
+            lastRow = firstRow;
+         }
+         if (lowestRemovedRow < originalSize) {
+            this->rebuildRowIndex(lowestRemovedRow);
+         }
+
+         // New rows go where they are in the recipe, rather than on the end
+         this->matchRowOrder(currentItems);
+         this->derived().updateTotals();
          if (this->derived().rowCount() > 0) {
             emit this->derived().headerDataChanged(Qt::Vertical, 0, this->derived().rowCount() - 1);
          }
@@ -743,15 +917,20 @@ protected:
       // Is sender one of our items?
       NE * itemSender = qobject_cast<NE *>(rawSender);
       if (itemSender) {
-         int ii = this->findIndexOf(itemSender);
-         if (ii < 0) {
+         if (this->findIndexOf(itemSender) < 0) {
             return;
          }
+         this->m_cellDataCache.invalidate(itemSender);
 
-         this->derived().updateTotals();
-         emit this->derived().dataChanged(this->derived().createIndex(ii, 0),
-                                          this->derived().createIndex(ii, this->derived().columnCount() - 1));
-         emit this->derived().headerDataChanged(Qt::Vertical, ii, ii);
+         //
+         // A single edit (eg a Recipe::recalcAll()) can result in many changed signals from the same row, so, rather
+         // than emitting dataChanged for each one, we note which rows changed and emit once per event loop turn.
+         //
+         this->m_pendingChangedRows.insert(itemSender);
+         if (!this->m_changedRowsFlushScheduled) {
+            this->m_changedRowsFlushScheduled = true;
+            QTimer::singleShot(0, &this->derived(), [this]() { this->flushChangedRows(); });
+         }
          return;
       }
 
@@ -764,6 +943,48 @@ protected:
       return;
    }
 
+   /**
+    * \brief Emit the coalesced \c dataChanged and \c headerDataChanged signals for rows that \c propertyChanged has
+    *        seen change since the last call.  Contiguous rows are reported as a single range.
+    *
+    *        We store pointers rather than row numbers in \c m_pendingChangedRows because rows can be added or removed
+    *        between a row changing and us getting here.
+    */
+   void flushChangedRows() {
+      this->m_changedRowsFlushScheduled = false;
+      if (this->m_pendingChangedRows.isEmpty()) {
+         return;
+      }
+
+      std::vector<int> changedRows;
+      changedRows.reserve(this->m_pendingChangedRows.size());
+      for (NE const * item : this->m_pendingChangedRows) {
+         int const row = this->findIndexOf(item);
+         if (row >= 0) {
+            changedRows.push_back(row);
+         }
+      }
+      this->m_pendingChangedRows.clear();
+      if (changedRows.empty()) {
+         return;
+      }
+      std::sort(changedRows.begin(), changedRows.end());
+
+      this->derived().updateTotals();
+      int const lastColumn = this->derived().columnCount() - 1;
+      for (auto iter = changedRows.cbegin(); iter != changedRows.cend(); ) {
+         int const firstRow = *iter;
+         int lastRow = firstRow;
+         for (++iter; iter != changedRows.cend() && *iter == lastRow + 1; ++iter) {
+            ++lastRow;
+         }
+         emit this->derived().dataChanged(this->derived().createIndex(firstRow, 0),
+                                          this->derived().createIndex(lastRow, lastColumn));
+         emit this->derived().headerDataChanged(Qt::Vertical, firstRow, lastRow);
+      }
+      return;
+   }
+
    //! \brief Default implementation for Derived::data
    QVariant doDataDefault(QModelIndex const & index, int role) const {
       if (!this->indexAndRoleOk(index, role)) {
@@ -797,6 +1018,21 @@ protected:
    //================================================ Member Variables =================================================
 
    QList< std::shared_ptr<NE> > m_rows;
+
+   /**
+    * \brief Maps each object in \c m_rows to its row number, so that we don't have to do a linear search every time
+    *        one of our rows sends us a signal.  Must be kept in step with \c m_rows -- see \c rebuildRowIndex.
+    */
+   QHash<NE const *, int> m_rowIndex;
+
+   //! \brief Rows for which we have received \c changed signals but not yet emitted \c dataChanged
+   QSet<NE const *> m_pendingChangedRows;
+   bool m_changedRowsFlushScheduled;
+
+   //! \brief Cache of \c readDataFromModel results.  Off unless \c setCellCacheEnabled is called.
+   CellDataCache m_cellDataCache;
+   //! \brief Which columns \c m_cellDataCache may be used for.  Empty if caching is off.
+   std::vector<bool> m_cacheableColumns;
 };
 
 namespace TableModelHelper {
@@ -21,6 +21,11 @@
 #include <QMessageBox>
 #include <QObject>
 
+#include "database/ChangeJournal.h"
+#include "database/DbTransaction.h"
+#include "database/DbWriter.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
 #include "MainWindow.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -35,6 +40,7 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "model/Yeast.h"
+#include "PersistentSettings.h"
 #include "serialization/json/BeerJson.h"
 #include "serialization/xml/BeerXml.h"
 
@@ -127,7 +133,7 @@ namespace {
                }
 
                QString const suffix = match.captured(1).toLower();
-               qDebug() << Q_FUNC_INFO << "Export filter is:" << filter << ".  From this, suffix is:" << suffix;
+               qCDebug(logSerialization) << Q_FUNC_INFO << "Export filter is:" << filter << ".  From this, suffix is:" << suffix;
                fileChooser.setDefaultSuffix(suffix);
                return;
             }
@@ -146,7 +152,7 @@ namespace {
       QString const defaultSuffix = QString{".%1"}.arg(fileChooser.defaultSuffix());
       QList<QString> selectedFiles = fileChooser.selectedFiles();
 
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Selected" << selectedFiles.length() << "file(s) (from directory" << fileChooser.directory() <<
          "):" << fileChooser.selectedFiles() << ". Default suffix:" << defaultSuffix;
 
@@ -214,7 +220,7 @@ namespace {
             }
          }
       }
-      qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
       QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                          messageBoxTitle,
                          messageBoxText};
@@ -253,6 +259,17 @@ namespace {
       }
       return ingredientSet;
    }
+
+   /**
+    * \brief If \c namedEntity is an \c NE, add it to \c neSet
+    */
+   template<class NE> void insertIfType(NamedEntity const * namedEntity, QSet<NE const *> & neSet) {
+      auto ne = dynamic_cast<NE const *>(namedEntity);
+      if (ne) {
+         neSet.insert(ne);
+      }
+      return;
+   }
 }
 
 bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
@@ -269,20 +286,9 @@ bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
       // I guess if the user were importing a lot of files in one go, it might be annoying to have a separate result
       // message for each one, but TBD whether that's much of a use case.  For now, we keep things simple.
       //
-      qDebug() << Q_FUNC_INFO << "Importing " << filename;
       QString userMessage;
       QTextStream userMessageAsStream{&userMessage};
-      bool succeeded = false;
-      if (filename.endsWith("json", Qt::CaseInsensitive)) {
-         succeeded = BeerJson::import(filename, userMessageAsStream);
-      } else if (filename.endsWith("xml", Qt::CaseInsensitive)) {
-         succeeded = BeerXML::getInstance().importFromXML(filename, userMessageAsStream);
-      } else {
-         qInfo() << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
-         userMessageAsStream <<
-            QObject::tr("Did not recognise file extension on \"%1\" so nothing written.").arg(filename);
-      }
-      qDebug() << Q_FUNC_INFO << "Import " << (succeeded ? "succeeded" : "failed");
+      bool const succeeded = ImportExport::importFromFile(filename, userMessageAsStream);
       importExportMsg(ImportOrExport::IMPORT, filename, succeeded, userMessage);
 
       allSucceeded &= succeeded;
@@ -293,6 +299,27 @@ bool ImportExport::importFromFiles(std::optional<QStringList> inputFiles) {
    return allSucceeded;
 }
 
+bool ImportExport::importFromFile(QString const & filename, QTextStream & userMessage) {
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Importing " << filename;
+   //
+   // Without this, every object we store from the file would be its own top-level DB transaction (and thus, eg, its
+   // own commit on PostgreSQL).  Note that we still commit whatever was successfully stored if the import fails part
+   // way through, because it's already in the object caches.
+   //
+   DbUnitOfWork unitOfWork{QString{"Import %1"}.arg(filename)};
+   bool succeeded = false;
+   if (filename.endsWith("json", Qt::CaseInsensitive)) {
+      succeeded = BeerJson::import(filename, userMessage);
+   } else if (filename.endsWith("xml", Qt::CaseInsensitive)) {
+      succeeded = BeerXML::getInstance().importFromXML(filename, userMessage);
+   } else {
+      qInfo() << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
+      userMessage << QObject::tr("Did not recognise file extension on \"%1\" so nothing written.").arg(filename);
+   }
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Import " << (succeeded ? "succeeded" : "failed");
+   return succeeded;
+}
+
 bool ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
                                 QList<Equipment   const *> const * equipments,
                                 QList<Fermentable const *> const * fermentables,
@@ -320,6 +347,36 @@ bool ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
 
    QString userMessage;
    QTextStream userMessageAsStream{&userMessage};
+   bool const succeeded = ImportExport::exportToNamedFile(filename,
+                                                          userMessageAsStream,
+                                                          recipes,
+                                                          equipments,
+                                                          fermentables,
+                                                          hops,
+                                                          miscs,
+                                                          styles,
+                                                          waters,
+                                                          yeasts);
+   importExportMsg(ImportOrExport::EXPORT, filename, succeeded, userMessage);
+
+   return false;
+}
+
+bool ImportExport::exportToNamedFile(QString const & filename,
+                                     QTextStream & userMessage,
+                                     QList<Recipe      const *> const * recipes,
+                                     QList<Equipment   const *> const * equipments,
+                                     QList<Fermentable const *> const * fermentables,
+                                     QList<Hop         const *> const * hops,
+                                     QList<Misc        const *> const * miscs,
+                                     QList<Style       const *> const * styles,
+                                     QList<Water       const *> const * waters,
+                                     QList<Yeast       const *> const * yeasts) {
+   //
+   // We export from the in-memory objects, so this isn't strictly necessary, but it means that, once an export is
+   // done, the DB is guaranteed to match what was exported.
+   //
+   DbWriter::instance().flush();
 
    // Destructor will close the file if nec when we exit the function
    QFile outFile;
@@ -329,7 +386,7 @@ bool ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
 
    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
       qWarning() << Q_FUNC_INFO << "Could not open" << filename << "for writing.";
-      userMessageAsStream << QObject::tr("Could not open \"%1\" for writing").arg(filename);
+      userMessage << QObject::tr("Could not open \"%1\" for writing").arg(filename);
 
    } else if (filename.endsWith(".json", Qt::CaseInsensitive)) {
       //
@@ -356,7 +413,7 @@ bool ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
          }
       }
 
-      BeerJson::Exporter exporter(outFile, userMessageAsStream);
+      BeerJson::Exporter exporter(outFile, userMessage);
       if (!setOfFermentable.isEmpty()   ) { exporter.add(setOfFermentable.values()); }
       if (!setOfHop        .isEmpty()   ) { exporter.add(setOfHop        .values()); }
       if (!setOfMisc       .isEmpty()   ) { exporter.add(setOfMisc       .values()); }
@@ -399,13 +456,117 @@ bool ImportExport::exportToFile(QList<Recipe      const *> const * recipes,
       succeeded = true;
    } else {
       qInfo() << Q_FUNC_INFO << "Don't understand file extension on" << filename << "so ignoring!";
-      userMessageAsStream <<
+      userMessage <<
          QObject::tr("Did not recognise file extension on \"%1\" so nothing read.").arg(filename);
    }
 
 
-   qDebug() << Q_FUNC_INFO << "Export" << (succeeded ? "succeeded" : "failed");
-   importExportMsg(ImportOrExport::EXPORT, filename, succeeded, userMessage);
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Export" << (succeeded ? "succeeded" : "failed");
+   return succeeded;
+}
 
-   return false;
+bool ImportExport::exportChangesToNamedFile(QString const & filename, QTextStream & userMessage) {
+   ChangeJournal & changeJournal = ChangeJournal::instance();
+   qint64 cursor = PersistentSettings::value(PersistentSettings::Names::lastChangeExportSequence, 0).toLongLong();
+   //
+   // If the cursor is ahead of the journal, it must have come from a different DB (since the setting is per user rather
+   // than per DB), so the only safe thing to do is start again from the beginning.
+   //
+   qint64 const latestSequence = changeJournal.latestSequence();
+   if (cursor > latestSequence) {
+      qInfo() <<
+         Q_FUNC_INFO << "Last delta export was at journal entry" << cursor << "but journal only goes up to" <<
+         latestSequence << "so exporting all changes";
+      cursor = 0;
+   }
+
+   QVector<ChangeJournal::Entry> const changes = changeJournal.changesSince(cursor);
+   if (changes.isEmpty()) {
+      userMessage << QObject::tr("Nothing has changed since the last export");
+      return true;
+   }
+
+   QSet<Recipe      const *> setOfRecipe;
+   QSet<Equipment   const *> setOfEquipment;
+   QSet<Fermentable const *> setOfFermentable;
+   QSet<Hop         const *> setOfHop;
+   QSet<Misc        const *> setOfMisc;
+   QSet<Style       const *> setOfStyle;
+   QSet<Water       const *> setOfWater;
+   QSet<Yeast       const *> setOfYeast;
+   int numGone = 0;
+   for (auto const & change : changes) {
+      //
+      // The journal tells us which objects changed, but we export them as they are now, so we only need to look at each
+      // one once, and there is nothing we can do for ones that have since been deleted.
+      //
+      ObjectStore * objectStore = FindObjectStoreForTable(change.tableName);
+      if (!objectStore || !objectStore->contains(change.id)) {
+         ++numGone;
+         continue;
+      }
+      auto namedEntity = std::dynamic_pointer_cast<NamedEntity>(objectStore->getById(change.id));
+      if (!namedEntity || namedEntity->deleted()) {
+         ++numGone;
+         continue;
+      }
+
+      insertIfType(namedEntity.get(), setOfRecipe     );
+      insertIfType(namedEntity.get(), setOfEquipment  );
+      insertIfType(namedEntity.get(), setOfFermentable);
+      insertIfType(namedEntity.get(), setOfHop        );
+      insertIfType(namedEntity.get(), setOfMisc       );
+      insertIfType(namedEntity.get(), setOfStyle      );
+      insertIfType(namedEntity.get(), setOfWater      );
+      insertIfType(namedEntity.get(), setOfYeast      );
+
+      //
+      // Anything that belongs to a Recipe (eg a hop addition or a mash step) is exported as part of that Recipe.  NB: a
+      // Mash etc that is shared between several Recipes has no owning Recipe (see comment in NamedEntity.h), so, in
+      // that case, we do not re-export the Recipes that use it.
+      //
+      auto recipe = namedEntity->owningRecipe();
+      if (recipe && !recipe->deleted()) {
+         setOfRecipe.insert(recipe.get());
+      }
+   }
+
+   QList<Recipe      const *> const recipes     {setOfRecipe     .values()};
+   QList<Equipment   const *> const equipments  {setOfEquipment  .values()};
+   QList<Fermentable const *> const fermentables{setOfFermentable.values()};
+   QList<Hop         const *> const hops        {setOfHop        .values()};
+   QList<Misc        const *> const miscs       {setOfMisc       .values()};
+   QList<Style       const *> const styles      {setOfStyle      .values()};
+   QList<Water       const *> const waters      {setOfWater      .values()};
+   QList<Yeast       const *> const yeasts      {setOfYeast      .values()};
+   qsizetype const numToExport = recipes.size() + equipments.size() + fermentables.size() + hops.size() +
+                                 miscs.size() + styles.size() + waters.size() + yeasts.size();
+   qCDebug(logSerialization) <<
+      Q_FUNC_INFO << changes.size() << "journal entries after" << cursor << "give" << numToExport <<
+      "item(s) to export and" << numGone << "no longer present";
+
+   if (numToExport > 0 &&
+       !ImportExport::exportToNamedFile(filename,
+                                        userMessage,
+                                        &recipes,
+                                        &equipments,
+                                        &fermentables,
+                                        &hops,
+                                        &miscs,
+                                        &styles,
+                                        &waters,
+                                        &yeasts)) {
+      return false;
+   }
+
+   userMessage <<
+      QObject::tr("%1 change(s) since the last export: %2 item(s) exported, %3 deleted item(s) not exported").arg(
+         changes.size()
+      ).arg(
+         numToExport
+      ).arg(
+         numGone
+      );
+   PersistentSettings::insert(PersistentSettings::Names::lastChangeExportSequence, changes.last().sequence);
+   return true;
 }
@@ -21,6 +21,8 @@
 #include <optional>
 
 #include <QList>
+#include <QString>
+#include <QTextStream>
 
 class Equipment;
 class Fermentable;
@@ -47,6 +49,18 @@ namespace ImportExport {
     */
    bool importFromFiles(std::optional<QStringList> inputFiles = std::nullopt);
 
+   /**
+    * \brief Import from a single BeerXML or BeerJSON file (determined by the filename extension) without any user
+    *        interaction.  This is the part of \c importFromFiles that does the actual work, and is also used in batch
+    *        mode (see \c BatchRunner).
+    *
+    * \param filename
+    * \param userMessage Where to write any message for the user about the import
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool importFromFile(QString const & filename, QTextStream & userMessage);
+
    /**
     * \brief Import recipes, hops, equipment, etc to a BeerXML or BeerJSON file specified by the user
     *        (We'll work out whether it's BeerXML or BeerJSON based on the filename extension, so doesn't need to be
@@ -74,6 +88,44 @@ namespace ImportExport {
                      QList<Style       const *> const * styles       = nullptr,
                      QList<Water       const *> const * waters       = nullptr,
                      QList<Yeast       const *> const * yeasts       = nullptr);
+
+   /**
+    * \brief As \c exportToFile, except the file to write to is specified by the caller and there is no user
+    *        interaction.  This is the part of \c exportToFile that does the actual work, and is also used in batch
+    *        mode (see \c BatchRunner).
+    *
+    * \param filename Name of the file to write.  Extension must be ".json" (for BeerJSON) or ".xml" (for BeerXML).
+    * \param userMessage Where to write any message for the user about the export
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool exportToNamedFile(QString const & filename,
+                          QTextStream & userMessage,
+                          QList<Recipe      const *> const * recipes,
+                          QList<Equipment   const *> const * equipments   = nullptr,
+                          QList<Fermentable const *> const * fermentables = nullptr,
+                          QList<Hop         const *> const * hops         = nullptr,
+                          QList<Misc        const *> const * miscs        = nullptr,
+                          QList<Style       const *> const * styles       = nullptr,
+                          QList<Water       const *> const * waters       = nullptr,
+                          QList<Yeast       const *> const * yeasts       = nullptr);
+
+   /**
+    * \brief A "delta export": as \c exportToNamedFile, but exporting only the recipes, hops, equipment, etc that have
+    *        changed (according to \c ChangeJournal) since the last delta export.  A change to something that belongs
+    *        to a recipe (eg one of its hop additions or mash steps) counts as a change to that recipe.  Deleted items
+    *        cannot be exported, so are just counted in \c userMessage.
+    *
+    *        The journal sequence number we got up to is stored in \c PersistentSettings, so the next call carries on
+    *        from there.  The first call exports everything in the journal.
+    *
+    * \param filename Name of the file to write.  Extension must be ".json" (for BeerJSON) or ".xml" (for BeerXML).
+    *                 If nothing has changed, the file is not written.
+    * \param userMessage Where to write any message for the user about the export
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool exportChangesToNamedFile(QString const & filename, QTextStream & userMessage);
 }
 
 #endif
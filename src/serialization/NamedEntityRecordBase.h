@@ -17,6 +17,7 @@
 #define SERIALIZATION_NAMEDENTITYRECORDBASE_H
 #pragma once
 
+#include "Logging.h"
 #include "serialization/SerializationRecord.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 #include "utils/TypeTraits.h"
@@ -40,7 +41,7 @@ namespace Serialization {
          // It's a coding error if this function is called when we already have a NamedEntity
          Q_ASSERT(nullptr == this->derived().m_namedEntity.get());
          // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//         qDebug() <<
+//         qCDebug(logSerialization) <<
 //            Q_FUNC_INFO << "Constructing" << NE::staticMetaObject.className() << "from" << this->derived().m_namedParameterBundle;
 
          this->derived().m_namedEntity = std::make_shared<NE>(this->derived().m_namedParameterBundle);
@@ -134,7 +135,7 @@ namespace Serialization {
             }
          );
          if (matchResult) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Found a match (#" << matchResult->key() << "," << matchResult->name() <<
                ") for #" << namedEntity->key() << ", " << namedEntity->name();
 
@@ -153,7 +154,7 @@ namespace Serialization {
             this->derived().m_namedEntity = matchResult;
             return true;
          }
-         qDebug() << Q_FUNC_INFO << "No match found for "<< namedEntity->name();
+         qCDebug(logSerialization) << Q_FUNC_INFO << "No match found for "<< namedEntity->name();
          return false;
       }
 
@@ -204,14 +205,14 @@ namespace Serialization {
                [currentName](std::shared_ptr<NE> ne) {return ne->name() == currentName;}
             )
          ) {
-            qDebug() << Q_FUNC_INFO << "Found existing " << NE::staticMetaObject.className() << "named" << currentName;
+            qCDebug(logSerialization) << Q_FUNC_INFO << "Found existing " << NE::staticMetaObject.className() << "named" << currentName;
 
             NamedEntity::modifyClashingName(currentName);
 
             //
             // Now the for loop will search again with the new name
             //
-            qDebug() << Q_FUNC_INFO << "Trying " << currentName;
+            qCDebug(logSerialization) << Q_FUNC_INFO << "Trying " << currentName;
          }
 
          this->derived().m_namedEntity->setName(currentName);
@@ -225,14 +226,14 @@ namespace Serialization {
        */
       void doSetContainingEntity([[maybe_unused]] std::shared_ptr<NamedEntity> containingEntity) {
          if constexpr (std::is_base_of<OwnedByRecipe, NE>::value) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << NE::staticMetaObject.className() << "*" <<
                static_cast<void *>(this->derived().m_namedEntity.get()) << ", Recipe * " <<
                static_cast<void *>(containingEntity.get());
             auto ownedByRecipe = std::static_pointer_cast<NE>(this->derived().m_namedEntity);
             ownedByRecipe->setRecipe(static_cast<Recipe *>(containingEntity.get()));
          } else if constexpr (IsBaseClassTemplateOf<EnumeratedBase, NE>) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Setting" << containingEntity->metaObject()->className() << "ID" <<
                containingEntity->key() << "on" << this->derived().m_namedEntity->metaObject()->className() << "#" <<
                this->derived().m_namedEntity->key();
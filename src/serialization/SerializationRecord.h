@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "Logging.h"
 #include "model/NamedEntity.h"
 #include "model/NamedParameterBundle.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
@@ -159,7 +160,7 @@ public:
                                                                 QTextStream & userMessage,
                                                                 ImportRecordCount & stats) {
       if (this->m_namedEntity) {
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Normalise and store " << this->recordDefinition().m_namedEntityClassName << "(" <<
             this->m_namedEntity->metaObject()->className() << "):" << this->m_namedEntity->name();
 
@@ -173,7 +174,7 @@ public:
          // determine whether they are duplicates.  This is why we check again, after storing in the DB, below.
          //
          if (this->resolveDuplicates()) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "(Early found) duplicate" << this->recordDefinition().m_namedEntityClassName <<
                (this->includedInStats() ? " will" : " won't") << " be included in stats";
             if (this->includedInStats()) {
@@ -229,7 +230,7 @@ public:
          // We potentially do stats for everything except failure
          //
          if (SerializationRecord::ProcessingResult::FoundDuplicate == processingResult) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "(Late found) duplicate" << this->recordDefinition().m_namedEntityClassName << "(" <<
                this->recordDefinition().m_localisedEntityName << ") #" << this->m_namedEntity->key() <<
                (this->includedInStats() ? " will" : " won't") << " be included in stats";
@@ -238,7 +239,7 @@ public:
             }
          } else {
             if (SerializationRecord::ProcessingResult::Succeeded == processingResult && this->includedInStats()) {
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "Completed reading" << this->recordDefinition().m_namedEntityClassName << "#" <<
                   this->m_namedEntity->key() << " (which" <<
                   (this->includedInStats() ? "will" : "won't") << "be included in stats)";
@@ -260,7 +261,7 @@ public:
             // MashStep, then deleting the Mash from the DB will also result in those 2 stored MashSteps getting deleted
             // from the DB.)
             //
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Deleting stored" << this->recordDefinition().m_namedEntityClassName <<
                "as failed to read all child records";
             this->deleteNamedEntityFromDb();
@@ -285,16 +286,16 @@ public:
       // items that share the same key in the opposite order to which they were inserted and don't offer STL reverse
       // iterators, so going backwards would be a bit clunky.)
       //
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "this->m_childRecordSets for" << this->m_recordDefinition << "has" <<
          this->m_childRecordSets.size() << "entries";
       for (auto & childRecordSet : this->m_childRecordSets) {
          if (childRecordSet.parentFieldDefinition) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << this->m_recordDefinition << ": childRecordSet" << *childRecordSet.parentFieldDefinition <<
                "now holds" << childRecordSet.records.size() << "record(s)";
          } else {
-            qDebug() << Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
+            qCDebug(logSerialization) << Q_FUNC_INFO << "Top-level record has" << childRecordSet.records.size() << "entries";
          }
 
          // If the list of children is empty, there is no work to do.  Explicitly move on to the next loop item.  (This
@@ -307,7 +308,7 @@ public:
          for (auto & childRecord : childRecordSet.records) {
             // The childRecord variable is a reference to a std::unique_ptr (because the vector we're looping over owns the
             // records it contains), which is why we have all the "member of pointer" (->) operators below.
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Storing" << childRecord->m_recordDefinition.m_namedEntityClassName << "child of" <<
                this->m_recordDefinition.m_namedEntityClassName << ":" << this->m_namedEntity;
             if (SerializationRecord::ProcessingResult::Failed ==
@@ -394,7 +395,7 @@ public:
                      childRecordSet.records.at(0)->m_recordDefinition.m_upAndDownCasters.m_listUpcaster(processedChildren);
                }
 
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "Setting" << propertyPath << "property on" <<
                   this->m_recordDefinition.m_namedEntityClassName << "with" << processedChildren.size() << "value(s):" <<
                   valueToSet;
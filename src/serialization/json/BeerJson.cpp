@@ -32,6 +32,7 @@
 #include <QDebug>
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Boil.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -1206,12 +1207,12 @@ namespace {
                   // integer-dot-integer so a string would be easier to parse).  However, AFAICT, there isn't a way to
                   // do this with Boost.JSON.
                   //
-                  qDebug() << Q_FUNC_INFO << "Version" << *bjVer << "(" << bjVer->kind() << ")";
+                  qCDebug(logSerialization) << Q_FUNC_INFO << "Version" << *bjVer << "(" << bjVer->kind() << ")";
                   double const * bjVersion = bjVer->if_double();
                   if (!bjVersion) {
-                     qDebug() << Q_FUNC_INFO << "Could not parse version" << bjVer << "in" << fileName;
+                     qCDebug(logSerialization) << Q_FUNC_INFO << "Could not parse version" << bjVer << "in" << fileName;
                   } else {
-                     qDebug() << Q_FUNC_INFO << "BeerJSON version of" << fileName << "is" << *bjVersion;
+                     qCDebug(logSerialization) << Q_FUNC_INFO << "BeerJSON version of" << fileName << "is" << *bjVersion;
                      beerJsonVersion = QString::number(*bjVersion);
                   }
                }
@@ -1239,7 +1240,7 @@ namespace {
 
       // If you want to check what Boost.JSON read from the file (eg to debug escaping issues etc), uncomment the next
       // line.
-//      qDebug() << Q_FUNC_INFO << "JSON file read in is:" << inputDocument;
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "JSON file read in is:" << inputDocument;
 
       return BEER_JSON_1_CODING.validateLoadAndStoreInDb(inputDocument, userMessage);
    }
@@ -23,6 +23,7 @@
 #include <QDebug>
 #include <QFile>
 
+#include "Logging.h"
 #include "serialization/json/JsonRecord.h"
 #include "serialization/json/JsonUtils.h"
 #include "utils/ImportRecordCount.h"
@@ -98,7 +99,7 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
       return false;
    }
 
-   qDebug() << Q_FUNC_INFO << "Schema validation succeeded";
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Schema validation succeeded";
 
    //
    // We're expecting the root of the JSON document to be an object named "beerjson".  This should have been
@@ -118,7 +119,7 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
 
    boost::json::value & rootRecordData = *documentRoot.if_contains("beerjson"); //documentRoot["beerjson"];
    Q_ASSERT(rootRecordData.is_object());
-   qDebug() << Q_FUNC_INFO << "Root record contains" << rootRecordData.as_object().size() << "elements";
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Root record contains" << rootRecordData.as_object().size() << "elements";
 
    //
    // Now we've loaded the JSON document into memory and determined that it's valid against its schema, we need to
@@ -132,14 +133,14 @@ bool JsonCoding::validateLoadAndStoreInDb(boost::json::value & inputDocument,
    // Look at the root object first
    //
    JsonRecord rootRecord{*this, rootRecordData, this->pimpl->m_rootRecordDefinition};
-   qDebug() << Q_FUNC_INFO << "Looking at field definitions of root element (" << this->pimpl->m_rootRecordDefinition.m_recordName << ")";
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Looking at field definitions of root element (" << this->pimpl->m_rootRecordDefinition.m_recordName << ")";
 
    ImportRecordCount stats;
 
    if (!rootRecord.load(userMessage)) {
       return false;
    }
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logSerialization) << Q_FUNC_INFO;
 
    // At the root level, Succeeded and FoundDuplicate are both OK return values.  It's only Failed that indicates an
    // error (rather than in info) message for the user in userMessage.
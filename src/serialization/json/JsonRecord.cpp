@@ -24,6 +24,7 @@
 #include <QMetaType>
 #include <qglobal.h> // For Q_ASSERT and Q_UNREACHABLE
 
+#include "Logging.h"
 #include "serialization/json/JsonCoding.h"
 #include "serialization/json/JsonRecordDefinition.h"
 #include "serialization/json/JsonUtils.h"
@@ -73,7 +74,7 @@ namespace {
       //
 
       // Usually leave next line commented as otherwise generates too much logging
-//      qDebug() <<
+//      qCDebug(logSerialization) <<
 //         Q_FUNC_INFO << "Reading" << valueField << "and" << unitField << "sub-fields from" << xPath << "record:" <<
 //         *recordData;
 
@@ -85,7 +86,7 @@ namespace {
          return false;
       }
       // Usually leave next line commented as otherwise generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Raw Value=" << *valueRaw << "(" << valueRaw->kind() << ")";
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "Raw Value=" << *valueRaw << "(" << valueRaw->kind() << ")";
 
       // The JSON type should be number.  Boost.JSON will have chosen either double or int64  (or conceivably uint64) to
       // store the number, depending eg on whether it has a decimal separator.  So we cannot assert that
@@ -102,7 +103,7 @@ namespace {
          return false;
       }
       // Usually leave next line commented as otherwise generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Value=" << value;
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "Value=" << value;
 
       boost::json::value const * unitNameRaw = unitField.followPathFrom(recordData, errCode);
       if (!unitNameRaw) {
@@ -115,7 +116,7 @@ namespace {
       unitName = unitNameRaw->get_string();
 
       // Usually leave next line commented as otherwise generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Read" << xPath << " (" << type << ") as" << value << " " <<
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "Read" << xPath << " (" << type << ") as" << value << " " <<
 //         std::string(unitName).c_str();
       return true;
    }
@@ -170,7 +171,7 @@ namespace {
                                                         JsonMeasureableUnitsMapping::MatchType::CaseInsensitive);
       Measurement::Amount canonicalValue = unit->toCanonical(value);
 
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Converted" << value << " " << std::string(unitName).c_str() << "to" << canonicalValue;
 
       return canonicalValue;
@@ -241,7 +242,7 @@ namespace {
 
       Measurement::Amount canonicalValue = unit->toCanonical(value);
 
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Converted" << value << " " << std::string(unitName).c_str() << "to" << canonicalValue;
 
       return canonicalValue;
@@ -306,7 +307,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
 
 [[nodiscard]] bool JsonRecord::load(QTextStream & userMessage) {
    Q_ASSERT(this->m_recordData.is_object());
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Loading" << this->m_recordDefinition.m_recordName << "record containing" <<
       this->m_recordData.as_object().size() << "elements";
 
@@ -326,7 +327,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/json/BeerJson.cpp.)
    //
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
@@ -342,13 +343,13 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
       if (!container) {
          // As noted above this is usually not an error, but _sometimes_ useful to log for debugging.  Usually leave
          // this logging commented out though as otherwise it fills up the log files
-//         qDebug() <<
+//         qCDebug(logSerialization) <<
 //            Q_FUNC_INFO << fieldDefinition.xPath << " (" << fieldDefinition.type << ") not present (error code " <<
 //            errorCode.value() << ":" << errorCode.message().c_str() << ")";
       } else {
          // Again, it can be useful to uncomment this logging statement for debugging, but usually we don't want it
          // taking up space in the log files.
-//         qDebug() <<
+//         qCDebug(logSerialization) <<
 //            Q_FUNC_INFO << "Found" << fieldDefinition.xPath << " (" << fieldDefinition.type << "/" <<
 //            container->kind() << ")";
 
@@ -578,7 +579,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
                   Q_ASSERT(container->is_object());
                   {
                      std::optional<double> value = readSingleUnitValue(fieldDefinition, container);
-                     qDebug() <<
+                     qCDebug(logSerialization) <<
                         Q_FUNC_INFO << "Read:" << value << "for" << fieldDefinition.xPath << "/" <<
                         fieldDefinition.propertyPath;
                      if (value) {
@@ -627,7 +628,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
                   // out), we can't carry on to normal processing below.  So jump straight to processing the next
                   // node in the loop (via continue).
                   //
-                  qDebug() <<
+                  qCDebug(logSerialization) <<
                      Q_FUNC_INFO << "Skipping " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
                      fieldDefinition.xPath << "=" << *container << "(" << fieldDefinition.propertyPath.asXPath() <<
                      ") as not useful";
@@ -700,7 +701,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
                                                JsonRecordDefinition const & childRecordDefinition,
                                                boost::json::value & childRecordData,
                                                QTextStream & userMessage) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logSerialization) << Q_FUNC_INFO;
    // TODO: We could move these 3 lines to the caller to save duplication with loadChildRecords
    auto constructorWrapper = childRecordDefinition.jsonRecordConstructorWrapper;
    this->m_childRecordSets.push_back(JsonRecord::ChildRecordSet{&parentFieldDefinition, {}});
@@ -721,7 +722,7 @@ SerializationRecordDefinition const & JsonRecord::recordDefinition() const {
                                                 JsonRecordDefinition const & childRecordDefinition,
                                                 boost::json::array & childRecordsData,
                                                 QTextStream & userMessage) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(logSerialization) << Q_FUNC_INFO;
    //
    // This is where we have a list of one or more substantive records of a particular type, which may be either at top
    // level (eg hop_varieties) or inside another record that we are in the process of reading (eg hop_additions inside a
@@ -759,7 +760,7 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
                              boost::json::object & recordDataAsObject,
                              std::string_view const & key,
                              QVariant & value) {
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Writing" << std::string(key).c_str() << "=" << value << "(type" << fieldDefinition.type <<
       ") for xPath" << fieldDefinition.xPath << ", path" << fieldDefinition.propertyPath;
 
@@ -857,14 +858,14 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
             JsonMeasureableUnitsMapping const * const unitsMapping =
                std::get<JsonMeasureableUnitsMapping const *>(fieldDefinition.valueDecoder);
             Q_ASSERT(unitsMapping);
-            qDebug() << Q_FUNC_INFO << *unitsMapping;
+            qCDebug(logSerialization) << Q_FUNC_INFO << *unitsMapping;
             Measurement::Unit const * const aUnit = unitsMapping->defaultUnit();
             Measurement::Unit const & canonicalUnit = aUnit->getCanonical();
-            qDebug() << Q_FUNC_INFO << canonicalUnit;
+            qCDebug(logSerialization) << Q_FUNC_INFO << canonicalUnit;
 
             // Now we found canonical units, we need to find the right string to represent them
             auto unitName = unitsMapping->getNameForUnit(canonicalUnit);
-            qDebug() << Q_FUNC_INFO << std::string(unitName).c_str();
+            qCDebug(logSerialization) << Q_FUNC_INFO << std::string(unitName).c_str();
             recordDataAsObject[key].emplace_object();
             auto & measurementWithUnits = recordDataAsObject[key].as_object();
             measurementWithUnits.emplace(unitsMapping->unitField.asKey(),  unitName);
@@ -897,7 +898,7 @@ void JsonRecord::insertValue(JsonRecordDefinition::FieldDefinition const & field
                if (unitsMapping->getPhysicalQuantity() == amount.unit->getPhysicalQuantity()) {
                   // Now we have the right PhysicalQuantity, we just need the entry for our Units
                   auto unitName = unitsMapping->getNameForUnit(*amount.unit);
-                  qDebug() << Q_FUNC_INFO << std::string(unitName).c_str();
+                  qCDebug(logSerialization) << Q_FUNC_INFO << std::string(unitName).c_str();
                   recordDataAsObject[key].emplace_object();
                   auto & measurementWithUnits = recordDataAsObject[key].as_object();
                   measurementWithUnits.emplace(unitsMapping->unitField.asKey(),  unitName);
@@ -982,7 +983,7 @@ bool JsonRecord::listToJson(QList< std::shared_ptr<NamedEntity> > const & object
 
 bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
    Q_ASSERT(this->m_recordData.is_object());
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Exporting JSON for" << namedEntityToExport.metaObject()->className() << "#" <<
       namedEntityToExport.key();
 
@@ -994,13 +995,13 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/json/BeerJson.cpp.)
    //
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
 
    for (auto & fieldDefinition : this->m_recordDefinition.fieldDefinitions) {
-      qDebug() << Q_FUNC_INFO <<
+      qCDebug(logSerialization) << Q_FUNC_INFO <<
          "fieldDefinition.xPath:" << fieldDefinition.xPath << ", fieldDefinition.propertyPath:" <<
          fieldDefinition.propertyPath;
       // If there isn't a property name that means this is not a field we support so there's nothing to write out.
@@ -1038,7 +1039,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
          // It's a coding error if we're trying to give something other than a Record an empty XPath
          Q_ASSERT(JsonRecordDefinition::FieldType::Record == fieldDefinition.type);
 
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Empty XPath for property path" << fieldDefinition.propertyPath << "means put its fields in "
             "this record";
       }
@@ -1058,12 +1059,12 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
       // the function we're calling.)
       //
       boost::json::value * valuePointer = &this->m_recordData;
-//      qDebug() <<
+//      qCDebug(logSerialization) <<
 //         Q_FUNC_INFO << "valuePointer (" << valuePointer->kind() << ") pre move:" << *valuePointer;
       auto key = fieldDefinition.xPath.makePointerToLeaf(&valuePointer);
 
       // valuePointer should now be pointing at an object in which we can insert a key:value pair
-//      qDebug() <<
+//      qCDebug(logSerialization) <<
 //         Q_FUNC_INFO << "valuePointer (" << valuePointer->kind() << ") post move:" << *valuePointer;
       Q_ASSERT(valuePointer->is_object());
 
@@ -1094,7 +1095,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
             QVariant childNamedEntityVariant = fieldDefinition.propertyPath.getValue(namedEntityToExport);
 
             // Normally leave this log statement commented out to avoid cluttering the logs
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "childNamedEntityVariant:" << childNamedEntityVariant << ", childRecordDefinition:" <<
                childRecordDefinition;
 
@@ -1142,7 +1143,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
                //
                // Otherwise (empty XPath), valuePointer is still pointing to the "current" object.
                //
-               qDebug() << Q_FUNC_INFO << "Creating JsonRecord for" << fieldDefinition.propertyPath;
+               qCDebug(logSerialization) << Q_FUNC_INFO << "Creating JsonRecord for" << fieldDefinition.propertyPath;
                std::unique_ptr<JsonRecord> subRecord{
                   childRecordDefinition.makeRecord(this->m_coding, *valuePointer)
                };
@@ -1151,7 +1152,7 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
                }
 
             } else {
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "No child NamedEntity for xPath" << fieldDefinition.xPath << "/ propertyPath:" <<
                   fieldDefinition.propertyPath;
             }
@@ -1166,11 +1167,11 @@ bool JsonRecord::toJson(NamedEntity const & namedEntityToExport) {
             // However, we have a pointer to the relevant instantiation of NamedEntity::downcastListFromVariant, which
             // will correctly convert the QVariant to QList<std::shared_ptr<NamedEntity>>.
             //
-            qDebug() << Q_FUNC_INFO << "value: " << value;
+            qCDebug(logSerialization) << Q_FUNC_INFO << "value: " << value;
             Q_ASSERT(childRecordDefinition.m_upAndDownCasters.m_listDowncaster);
             QList< std::shared_ptr<NamedEntity> > objectsToWrite =
                childRecordDefinition.m_upAndDownCasters.m_listDowncaster(value);
-            qDebug() << Q_FUNC_INFO << "value (" << value << ") gives" << objectsToWrite.size() << "objects";
+            qCDebug(logSerialization) << Q_FUNC_INFO << "value (" << value << ") gives" << objectsToWrite.size() << "objects";
 
             //
             // In theory we could add some logic here to decide whether to write the array out if it is of zero length.
@@ -28,6 +28,7 @@
 #include <valijson/schema_parser.hpp>
 #include <valijson/validator.hpp>
 
+#include "Logging.h"
 #include "serialization/json/JsonUtils.h"
 #include "utils/BtStringStream.h"
 
@@ -84,7 +85,7 @@ namespace {
    void freeReferencedDocument([[maybe_unused]] boost::json::value const * document) {
       // There isn't anything for us to do, because we hang on to all the JSON schema documents until the program
       // terminates.
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(logSerialization) << Q_FUNC_INFO;
       return;
    }
 
@@ -159,7 +160,7 @@ public:
                                              this->jsonSchema,
                                              &JsonSchema::fetchReferencedDocument,
                                              &freeReferencedDocument);
-         qDebug() << Q_FUNC_INFO << "Schema populated";
+         qCDebug(logSerialization) << Q_FUNC_INFO << "Schema populated";
 
       } catch (std::exception const & exception) {
          // Because we're only populating data from resources shipped with the program, we're not expecting exceptions,
@@ -188,7 +189,7 @@ public:
     * \return Pointer to a Boost.JSON value which is the root of the document tree
     */
    boost::json::value const * getReferencedDocument(std::string const & uri) {
-      qDebug() << Q_FUNC_INFO << "Request for" << uri.c_str();
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Request for" << uri.c_str();
       QString schemaFilePath = QString("%1/%2").arg(this->baseDir, uri.c_str());
       if (!this->schemaFileCache.contains(schemaFilePath)) {
          //
@@ -198,11 +199,11 @@ public:
          std::shared_ptr<boost::json::value const> schemaDocument =
             std::make_shared<boost::json::value const>(JsonUtils::loadJsonDocument(schemaFilePath, true));
 
-         qDebug() << Q_FUNC_INFO << "Read" << uri.c_str() << "as" << schemaFilePath;
+         qCDebug(logSerialization) << Q_FUNC_INFO << "Read" << uri.c_str() << "as" << schemaFilePath;
 
          this->schemaFileCache.insert(schemaFilePath, schemaDocument);
       } else {
-         qDebug() << Q_FUNC_INFO << schemaFilePath << "already in cache";
+         qCDebug(logSerialization) << Q_FUNC_INFO << schemaFilePath << "already in cache";
       }
 
       // We assert that we either already had the schema file in the cache or we just read it into the cache
@@ -294,7 +295,7 @@ bool JsonSchema::validate(boost::json::value const & document, QTextStream & use
       return false;
    }
 
-   qDebug() << Q_FUNC_INFO << "Validation succeeded";
+   qCDebug(logSerialization) << Q_FUNC_INFO << "Validation succeeded";
    return true;
 }
 
@@ -29,6 +29,7 @@
 #include <QFile>
 #include <QString>
 
+#include "Logging.h"
 #include "utils/BtException.h"
 #include "utils/BtStringStream.h"
 #include "utils/ErrorCodeToStream.h"
@@ -226,7 +227,7 @@ void JsonUtils::serialize(std::ostream & stream,
                //
                if (ii->value().kind() == boost::json::kind::object &&
                    ii->value().get_object().size() == 0) {
-                  qDebug() << Q_FUNC_INFO << "Skipping output of empty object for" << QString::fromStdString(ii->key());
+                  qCDebug(logSerialization) << Q_FUNC_INFO << "Skipping output of empty object for" << QString::fromStdString(ii->key());
                   continue;
                }
 
@@ -28,6 +28,7 @@
 #include <QDebug>
 #include <QtGlobal> // For Q_ASSERT
 
+#include "Logging.h"
 #include "serialization/json/JsonUtils.h"
 
 JsonXPath::JsonXPath(char const * const xPath) :
@@ -93,7 +94,7 @@ JsonXPath::JsonXPath(char const * const xPath) :
    for (std::sregex_iterator ii = xPath_begin; ii != xPath_end; ++ii) {
       std::string pathPart = ii->str();
       // Normally leave this logging statement commented out as otherwise it's fills up too much of the log files
-//      qDebug() << Q_FUNC_INFO << "Matched" << pathPart.c_str();
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "Matched" << pathPart.c_str();
       if (pathPart[0] == '/') {
          // This is the easy case
          this->m_pathParts.push_back(pathPart);
@@ -194,14 +195,14 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
          // For a JSON Pointer, Boost.JSON does all the work
          auto jsonPointer{std::get<JsonXPath::JsonPointer>(pathPart)};
          // Normally have this commented out as it generates lots of logging
-//         qDebug() <<
+//         qCDebug(logSerialization) <<
 //            Q_FUNC_INFO << "Following path part" << jsonPointer.c_str() << "from" << *destinationValue << "in" <<
 //            this->m_rawXPath;
          destinationValue = destinationValue->find_pointer(std::string_view{jsonPointer}, errorCode);
          // If we already know there's no result, stop looping through the path parts
          // This is not an error per se, just that nothing was found
          if (!destinationValue) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "No result from" << jsonPointer.c_str() << "while following" << this->m_rawXPath;
             // std::error_code usually holds an implementation-defined value, but we can use POSIX error codes.
             // Here I'm taking a liberal interpretation of the Posix "bad address" (EFAULT) code.  It was a toss up
@@ -228,7 +229,7 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
          // match as, in our use cases, we are not expecting multiple matches and cannot usefully interpret them.)
          bool foundInArray = false;
          boost::json::array const & destinationValueAsArray = destinationValue->get_array();
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Searching through" << destinationValueAsArray.size() << "array items for" <<
             namedArrayItemId;
          //
@@ -273,20 +274,20 @@ boost::json::value const * JsonXPath::followPathFrom(boost::json::value const *
 
             if (*valueAsString == namedArrayItemId.value) {
                // It isn't normally necessary to enable the next log statement
-//               qDebug() << Q_FUNC_INFO << "Found" << valueAsString->c_str();
+//               qCDebug(logSerialization) << Q_FUNC_INFO << "Found" << valueAsString->c_str();
                destinationValue = arrayEntry;
                foundInArray = true;
                break;
             }
 
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Skipping" << valueAsString->c_str() << "while searching for" << namedArrayItemId <<
                "as part of" << this->m_rawXPath;
          }
 
          if (!foundInArray) {
             // It's not necessarily an error if we didn't find the thing we were looking for.  It might be optional.
-            qDebug() << Q_FUNC_INFO << "No match found for" << namedArrayItemId << "when following" << this->m_rawXPath;
+            qCDebug(logSerialization) << Q_FUNC_INFO << "No match found for" << namedArrayItemId << "when following" << this->m_rawXPath;
             errorCode = std::make_error_code(std::errc::bad_address);
             return nullptr;
          }
@@ -308,7 +309,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
    // Start with the special case of the empty XPath, in which case we want valuePointer to be unchanged
    //
    if (this->isEmpty()) {
-      qDebug() << Q_FUNC_INFO << "Empty XPath";
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Empty XPath";
       return "";
    }
 
@@ -402,7 +403,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
       if (!std::holds_alternative<std::monostate>(priorNode)) {
          if (std::holds_alternative<JsonXPath::JsonKey>(priorNode)) {
             auto const & previousKey{std::get<JsonXPath::JsonKey>(priorNode)};
-            qDebug() << Q_FUNC_INFO << "previousKey:" << previousKey.c_str();
+            qCDebug(logSerialization) << Q_FUNC_INFO << "previousKey:" << previousKey.c_str();
             Q_ASSERT(previousValue->is_object());
             boost::json::value * currentValue = previousValue->get_object().if_contains(previousKey);
             if (!currentValue) {
@@ -410,12 +411,12 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
                // key (see examples in comment above)
                if (std::holds_alternative<JsonXPath::JsonKey>(currentNode)) {
                   // This is case (1) Node follows Node
-                  qDebug() << Q_FUNC_INFO << "Making sub-object for" << previousKey.c_str();
+                  qCDebug(logSerialization) << Q_FUNC_INFO << "Making sub-object for" << previousKey.c_str();
                   previousValue->get_object()[previousKey].emplace_object();
                } else {
                   // This is case (2) Named Array Item Id follows Node
                   Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(currentNode));
-                  qDebug() << Q_FUNC_INFO << "Making sub-array for" << previousKey.c_str();
+                  qCDebug(logSerialization) << Q_FUNC_INFO << "Making sub-array for" << previousKey.c_str();
                   previousValue->get_object()[previousKey].emplace_array();
                }
                // The previous key should now exist!
@@ -426,7 +427,7 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
          } else {
             Q_ASSERT(std::holds_alternative<JsonXPath::NamedArrayItemId>(priorNode));
             auto const & namedArrayItemId{std::get<JsonXPath::NamedArrayItemId>(priorNode)};
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "namedArrayItemId.key:" << namedArrayItemId.key.c_str() << ", namedArrayItemId.value:" <<
                namedArrayItemId.value.c_str();
             // As noted above, we cannot have Named Array Item Id follows Named Array Item Id, so we assert that here
@@ -462,14 +463,14 @@ std::string JsonXPath::makePointerToLeaf(boost::json::value ** valuePointer) con
                   break;
                }
 
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "Skipping array entry with" << namedArrayItemId.key.c_str() << "=" <<
                   itemIdAsString->c_str() << "while searching for" << namedArrayItemId.value.c_str();
             }
 
             if (!found) {
                // This is case (3) Node follows Named Array Item Id
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "Creating new array element with" << namedArrayItemId.key.c_str() << "=" <<
                   namedArrayItemId.value.c_str();
                // We're letting BoostJSON do all the constructor calling as we want it to own the objects being made.
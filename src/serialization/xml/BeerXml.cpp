@@ -29,6 +29,7 @@
 #include <QTextStream>
 
 #include "config.h" // For CONFIG_VERSION_STRING
+#include "Logging.h"
 #include "model/Boil.h" // But NB model/BoilStep.h is not needed
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
@@ -1158,7 +1159,7 @@ namespace {
       //
       QByteArray documentData = inputFile.readLine();
       QString firstLine{QString::fromLatin1(documentData)};
-      qDebug() << Q_FUNC_INFO << "First line of " << inputFile.fileName() << " was " << firstLine;
+      qCDebug(logSerialization) << Q_FUNC_INFO << "First line of " << inputFile.fileName() << " was " << firstLine;
       if (!firstLine.startsWith(QString("<?xml version="))) {
          //
          // For the moment, we're being strict and bailing out here.  An alternative approach would be to accept files
@@ -1182,11 +1183,11 @@ namespace {
       documentData = firstLine.toLatin1();
       documentData += inputFile.readAll();
       documentData += "\n</BEER_XML>";
-      qDebug() << Q_FUNC_INFO << "Input file " << inputFile.fileName() << ": " << documentData.length() << " bytes";
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Input file " << inputFile.fileName() << ": " << documentData.length() << " bytes";
 
       // It is sometimes helpful to uncomment the next line for debugging, but usually leave it commented out as can
       // put a _lot_ of data in the logs in DEBUG mode.
-      // qDebug().noquote() << Q_FUNC_INFO << "Full content of " << inputFile.fileName() << " is:\n" << QString(documentData);
+      // qCDebug(logSerialization).noquote() << Q_FUNC_INFO << "Full content of " << inputFile.fileName() << " is:\n" << QString(documentData);
 
       //
       // Some errors we explicitly want to ignore.  In particular, the BeerXML 1.0 standard says:
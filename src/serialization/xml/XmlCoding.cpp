@@ -41,6 +41,7 @@
 #include <xalanc/XercesParserLiaison/XercesDOMSupport.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 
+#include "Logging.h"
 #include "serialization/xml/BtDomDocumentOwner.h"
 #include "serialization/xml/XercesHelpers.h"
 #include "utils/ImportRecordCount.h"
@@ -276,12 +277,12 @@ public:
       }
 
       QByteArray schemaData = schemaFile.readAll();
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Schema file " << schemaFile.fileName() << ": " << schemaData.length() << " bytes";
 
       // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
       // ".noquote()" here.
-      qDebug().noquote() <<
+      qCDebug(logSerialization).noquote() <<
          Q_FUNC_INFO << "Settings for reading schema file " << schemaFile.fileName() << ": " <<
          XercesHelpers::getParameterSettings(*config);
 
@@ -316,7 +317,7 @@ public:
 
       xercesc::Grammar * rootGrammar = this->m_parser->getRootGrammar();
 
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Schema " << schemaFile.fileName() << " loaded OK.  Grammar:" << grammar << ", root grammar:" <<
          rootGrammar;
 
@@ -380,7 +381,7 @@ public:
 
          // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
          // ".noquote()" here.
-         qDebug().noquote() <<
+         qCDebug(logSerialization).noquote() <<
             Q_FUNC_INFO << "Settings for reading input " << fileName << ": " << XercesHelpers::getParameterSettings(*config);
 
          QByteArray fileNameAsCString = fileName.toLocal8Bit();
@@ -400,7 +401,7 @@ public:
          BtDomDocumentOwner domDocumentOwner{this->m_parser->parse(&documentAsDOMLSInput)};
 
          bool parsedOk = !domErrorHandler.failed();
-         qDebug() << Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
+         qCDebug(logSerialization) << Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
 
          if (!parsedOk) {
             userMessage << domErrorHandler.getlastError();
@@ -508,13 +509,13 @@ public:
                                   QTextStream & userMessage) const {
 
       XQString rootNodeName{rootNode->getNodeName()};
-      qDebug() << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
 
       //
       // Look at the root object first
       //
       XmlRecord rootRecord{this->m_self, this->m_rootRecordDefinition};
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Looking at field definitions of root element (" << this->m_rootRecordDefinition.m_recordName << ")";
 
       ImportRecordCount stats;
@@ -18,6 +18,7 @@
 #include <cstring>
 #include <functional>
 
+#include "Logging.h"
 #include "model/Boil.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -83,7 +84,7 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       //
       auto boil = recipe->boil();
       if (boil) {
-         qDebug() << Q_FUNC_INFO << "Deleting boil #" <<boil->key() << "from duplicate Recipe #" << recipe->key();
+         qCDebug(logSerialization) << Q_FUNC_INFO << "Deleting boil #" <<boil->key() << "from duplicate Recipe #" << recipe->key();
          recipe->setBoilId(-1);
          //
          // It's a coding error if the boil we're about to delete is used by any other Recipe, but one from which we can
@@ -98,7 +99,7 @@ XmlRecord::ProcessingResult XmlRecipeRecord::normaliseAndStoreInDb(std::shared_p
       }
       auto fermentation = recipe->fermentation();
       if (fermentation) {
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Deleting fermentation #" <<fermentation->key() << "from duplicate Recipe #" <<
             recipe->key();
          recipe->setFermentationId(-1);
@@ -151,7 +152,7 @@ bool XmlRecipeRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessag
       // This call will also ensure the boil gets saved in the DB
       recipe->setBoil(boil);
 
-      qDebug() << Q_FUNC_INFO << "Created Boil #" << boil->key() << "on Recipe" << *recipe;
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Created Boil #" << boil->key() << "on Recipe" << *recipe;
    }
    if (this->m_namedParameterBundle.containsBundle(PropertyNames::Recipe::fermentation)) {
       // It's a coding error if the recipe already has a fermentation
@@ -166,7 +167,7 @@ bool XmlRecipeRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessag
       // This call will also ensure the fermentation gets saved in the DB
       recipe->setFermentation(fermentation);
 
-      qDebug() << Q_FUNC_INFO << "Created Fermentation #" << fermentation->key() << "on Recipe" << *recipe;
+      qCDebug(logSerialization) << Q_FUNC_INFO << "Created Fermentation #" << fermentation->key() << "on Recipe" << *recipe;
 
       //
       // Now we handle RECIPE > PRIMARY_AGE / PRIMARY_TEMP / SECONDARY_AGE / SECONDARY_TEMP / TERTIARY_AGE /
@@ -179,7 +180,7 @@ bool XmlRecipeRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessag
       //
       if (fermentationBundle.containsBundle(PropertyNames::Fermentation::primary)) {
          auto primaryBundle {fermentationBundle.getBundle(PropertyNames::Fermentation::primary)};
-         qDebug() << Q_FUNC_INFO << primaryBundle;
+         qCDebug(logSerialization) << Q_FUNC_INFO << primaryBundle;
          primaryBundle.insertIfNotPresent(PropertyNames::NamedEntity::name,
                                           QObject::tr("Primary Fermentation Step for %1").arg(recipe->name()));
          primaryBundle.insertIfNotPresent(PropertyNames::Step::description,
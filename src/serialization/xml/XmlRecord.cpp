@@ -24,6 +24,7 @@
 #include <xalanc/XPath/XPathEvaluator.hpp>
 #include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
 
+#include "Logging.h"
 #include "serialization/xml/XmlCoding.h"
 #include "utils/OptionalHelpers.h"
 #include "utils/ObjectAddressStringMapping.h"
@@ -86,7 +87,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
    // Note that it's a coding error if there are no fields in the record definition.  (This usually means a template
    // specialisation was omitted in serialization/xml/BeerXml.cpp.)
    //
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Examining" << this->m_recordDefinition.fieldDefinitions.size() << "field definitions for" <<
       this->m_recordDefinition.m_recordName;
    Q_ASSERT(this->m_recordDefinition.fieldDefinitions.size() > 0);
@@ -140,7 +141,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
       }
       auto numChildNodes = nodesForCurrentXPath.size();
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//      qDebug() << Q_FUNC_INFO << "Found" << numChildNodes << "node(s) for " << fieldDefinition.xPath;
+//      qCDebug(logSerialization) << Q_FUNC_INFO << "Found" << numChildNodes << "node(s) for " << fieldDefinition.xPath;
       if (XmlRecordDefinition::FieldType::Record        == fieldDefinition.type ||
           XmlRecordDefinition::FieldType::ListOfRecords == fieldDefinition.type) {
          //
@@ -179,13 +180,13 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
          xalanc::XalanNodeList const * fieldContents = fieldContainerNode->getChildNodes();
          int numChildrenOfContainerNode = fieldContents->getLength();
          // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Node " << fieldDefinition.xPath << "(" << fieldName << ":" <<
             XALAN_NODE_TYPES[fieldContainerNode->getNodeType()] << ") has " <<
             numChildrenOfContainerNode << " children";
          if (0 == numChildrenOfContainerNode) {
             // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//            qDebug() << Q_FUNC_INFO << "Empty!";
+//            qCDebug(logSerialization) << Q_FUNC_INFO << "Empty!";
          } else {
             {
                //
@@ -201,7 +202,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                xalanc::XalanNode * valueNode = fieldContents->item(0);
                XQString value(valueNode->getNodeValue());
                // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//               qDebug() << Q_FUNC_INFO << "Value " << value;
+//               qCDebug(logSerialization) << Q_FUNC_INFO << "Value " << value;
 
                bool parsedValueOk = false;
                QVariant parsedValue;
@@ -238,7 +239,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                };
 
                // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-               qDebug() << Q_FUNC_INFO << "Value " << value << "; optional=" << (propertyIsOptional ? "true" : "false");
+               qCDebug(logSerialization) << Q_FUNC_INFO << "Value " << value << "; optional=" << (propertyIsOptional ? "true" : "false");
 
                switch (fieldDefinition.type) {
 
@@ -453,7 +454,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                      // node in the loop (via continue).
                      //
                      // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//                     qDebug() <<
+//                     qCDebug(logSerialization) <<
 //                        Q_FUNC_INFO << "Skipping " << this->m_recordDefinition.m_namedEntityClassName << " node " <<
 //                        fieldDefinition.xPath << "=" << value << "(" << fieldDefinition.propertyPath.asXPath() <<
 //                        ") as not useful";
@@ -479,7 +480,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                }
 
                // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-               qDebug() <<
+               qCDebug(logSerialization) <<
                   Q_FUNC_INFO << "parsedValue:" << parsedValue << "; parsedValueOk:" << parsedValueOk <<
                   "; fieldDefinition.propertyPath:" << fieldDefinition.propertyPath;
 
@@ -520,7 +521,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
    //
    if (!this->m_namedParameterBundle.isEmpty()) {
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-      qDebug().noquote() <<
+      qCDebug(logSerialization).noquote() <<
          Q_FUNC_INFO << "Constructing " << this->m_recordDefinition.m_namedEntityClassName << " from " <<
          this->m_namedParameterBundle;
 
@@ -549,7 +550,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
    //
    auto constructorWrapper = childRecordDefinition.xmlRecordConstructorWrapper;
    this->m_childRecordSets.push_back(XmlRecord::ChildRecordSet{&parentFieldDefinition, {}});
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "childRecordDefinition" << childRecordDefinition << ". m_childRecordSets for" <<
       this->m_recordDefinition << "has" << this->m_childRecordSets.size() << "entries";
    XmlRecord::ChildRecordSet & childRecordSet = this->m_childRecordSets.back();
@@ -572,7 +573,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
       //
       XQString childRecordName{childRecordNode->getNodeName()};
       // Normally keep this log statement commented out otherwise it generates too many lines in the log file
-//      qDebug() << Q_FUNC_INFO << childRecordName;
+//      qCDebug(logSerialization) << Q_FUNC_INFO << childRecordName;
 
       std::unique_ptr<XmlRecord> childRecord{
          constructorWrapper(this->m_coding, childRecordDefinition)
@@ -582,14 +583,14 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
       // The return value of xalanc::XalanNode::getIndex() doesn't have an instantly obvious direct meaning, but AFAICT
       // higher values are for nodes that were later in the input file, so useful to log.
       //
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << "Loading child record" << childRecordName << "with index" << childRecordNode->getIndex() <<
          "for" << childRecordDefinition.m_namedEntityClassName;
       if (!childRecord->load(domSupport, childRecordNode, userMessage)) {
          return false;
       }
       childRecordSet.records.push_back(std::move(childRecord));
-      qDebug() <<
+      qCDebug(logSerialization) <<
          Q_FUNC_INFO << this->m_recordDefinition << ": childRecordSet" << *childRecordSet.parentFieldDefinition <<
          "now holds" << childRecordSet.records.size() << "record(s)";
    }
@@ -604,7 +605,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
                       char const * const indentString) const {
    // Callers are not allowed to supply null indent string
    Q_ASSERT(nullptr != indentString);
-   qDebug() <<
+   qCDebug(logSerialization) <<
       Q_FUNC_INFO << "Exporting XML for" << namedEntityToExport.metaObject()->className() << "#" <<
       namedEntityToExport.key();
    if (includeRecordNameTags) {
@@ -660,7 +661,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
             writeIndents(out, indentLevel + 1 + ii, indentString);
             out << "<" << xPathElements.at(ii) << ">\n";
          }
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "Creating XmlRecord for" << fieldDefinition.propertyPath << ".  XPath:" << xPathElements <<
             ";" << (xPathElements.isEmpty() ? QString{"[None]"} : xPathElements.last());
          std::unique_ptr<XmlRecord> subRecord{childRecordDefinition.makeRecord(this->m_coding)};
@@ -744,7 +745,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
          valueAsText = fieldDefinition.propertyPath.asXPath();
       } else {
          // Uncomment this if the assert below is firing
-         qDebug() <<
+         qCDebug(logSerialization) <<
             Q_FUNC_INFO << "To write" << fieldDefinition.xPath << ", reading property" <<
             fieldDefinition.propertyPath << "from" << namedEntityToExport;
          QVariant value = fieldDefinition.propertyPath.getValue(namedEntityToExport);
@@ -885,7 +886,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
          }
 
          if (propertyIsOptional && value.isNull()) {
-            qDebug() <<
+            qCDebug(logSerialization) <<
                Q_FUNC_INFO << "Not writing XPath" << fieldDefinition.xPath << "as property" <<
                fieldDefinition.propertyPath.asXPath() << "is unset, ie set to std::nullopt";
             continue;
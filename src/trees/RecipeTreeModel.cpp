@@ -16,6 +16,10 @@
  =====================================================================================================================*/
 #include "trees/RecipeTreeModel.h"
 
+#include <QSet>
+
+#include "database/DbTransaction.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "AncestorDialog.h"
 #include "OptionDialog.h"
@@ -54,7 +58,7 @@ void RecipeTreeModel::addBrewNoteSubTree(TreeNode & recipeNodeRaw,
    auto & recipeNode = static_cast<TreeItemNode<Recipe> &>(recipeNodeRaw);
 
    // Normally leave the next line commented out as it generates quite a bit of logging
-//   qDebug() << Q_FUNC_INFO << "Adding" << brewNotes.size() << "BrewNotes for" << recipe;
+//   qCDebug(logTrees) << Q_FUNC_INFO << "Adding" << brewNotes.size() << "BrewNotes for" << recipe;
    int childNum = recipeNode.childCount();
    for (auto brewNote : brewNotes) {
       //
@@ -90,7 +94,7 @@ void RecipeTreeModel::addAncestoralTree(TreeNode & recipeNodeRaw,
    auto & recipeNode = static_cast<TreeItemNode<Recipe> &>(recipeNodeRaw);
 
    // Now loop through the ancestors. The nature of the beast is nearest ancestors are first
-   qDebug() << Q_FUNC_INFO << "Adding" << ancestors.size() << "ancestors for" << recipe;
+   qCDebug(logTrees) << Q_FUNC_INFO << "Adding" << ancestors.size() << "ancestors for" << recipe;
    int childNum = recipeNode.childCount();
    for (auto ancestor : ancestors) {
       // Comment in addBrewNoteSubTree() about indexes also applies here
@@ -121,7 +125,7 @@ void RecipeTreeModel::addSubTree(Recipe const & recipe,
 
    QModelIndex recipeNodeIndex = this->indexOfNode(&recipeNode);
    TreeNode * recipeParent = recipeNode.rawParent();
-   qDebug() <<
+   qCDebug(logTrees) <<
       Q_FUNC_INFO << "recipe:" << recipe << ", recipeNode:" << recipeNode << ", recipeParent:" << recipeParent;
    QModelIndex recipeParentIndex = this->derived().parent(recipeNodeIndex);
 
@@ -137,6 +141,42 @@ void RecipeTreeModel::addSubTree(Recipe const & recipe,
    return;
 }
 
+bool RecipeTreeModel::hasSubTree(Recipe const & recipe) const {
+   bool const showSnapshots = PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool();
+   if (showSnapshots && recipe.hasAncestors()) {
+      return true;
+   }
+   // Same logic as in addSubTree() -- if we're not showing ancestors then we show their BrewNotes instead
+   auto const brewNotes = showSnapshots ? recipe.brewNotes() : RecipeHelper::brewNotesForRecipeAndAncestors(recipe);
+   return !brewNotes.empty();
+}
+
+Recipe const * RecipeTreeModel::subTreeOwner(Recipe const & recipe) const {
+   //
+   // Each Recipe knows its immediate ancestor, but not its descendant, so we have to search for that.  Chains of
+   // versions are short, so this is still much cheaper than building the whole tree.  We stop if we come back to
+   // somewhere we've already been, in case the ancestor links in the DB are messed up.
+   //
+   Recipe const * newestVersion = nullptr;
+   QSet<int> visited{recipe.key()};
+   for (Recipe const * current = &recipe; current; ) {
+      int const currentId = current->key();
+      current = ObjectStoreWrapper::findFirstMatching<Recipe>(
+         [currentId](Recipe * candidate) {
+            return candidate->key() != currentId && candidate->getAncestorId() == currentId;
+         }
+      );
+      if (current) {
+         if (visited.contains(current->key())) {
+            break;
+         }
+         visited.insert(current->key());
+         newestVersion = current;
+      }
+   }
+   return newestVersion;
+}
+
 bool RecipeTreeModel::showChild(QModelIndex child) const {
    TreeNode * node = this->treeNode(child);
    return node->showMe();
@@ -235,7 +275,7 @@ void RecipeTreeModel::recipePropertyChanged(int recipeId, BtStringConst const &
    // .:TBD:. We could probably get away with propertyName == PropertyNames::Recipe::ancestorId here because
    // we always use the same constants for property names.
    if (propertyName != PropertyNames::Recipe::ancestorId) {
-      qDebug() << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
+      qCDebug(logTrees) << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
       return;
    }
 
@@ -248,7 +288,7 @@ void RecipeTreeModel::recipePropertyChanged(int recipeId, BtStringConst const &
    int ancestorId = descendant->getAncestorId();
 
    if (ancestorId <= 0 || ancestorId == descendant->key()) {
-      qDebug() << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
+      qCDebug(logTrees) << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
       return;
    }
 
@@ -370,6 +410,8 @@ void RecipeTreeModel::spawnRecipe(QModelIndex index) {
 
    Recipe * ancestor = ancestorNode.underlyingItem().get();
    Q_ASSERT(ancestor);
+   // Copying the Recipe and linking it to its ancestor should be one DB transaction rather than hundreds
+   DbUnitOfWork unitOfWork{"Spawn Recipe"};
    std::shared_ptr<Recipe> descendant = std::make_shared<Recipe>(*ancestor);
    //
    // We want to store the new Recipe first so that it gets an ID.
@@ -381,7 +423,7 @@ void RecipeTreeModel::spawnRecipe(QModelIndex index) {
    // TreeModelBase::doElementAdded and adds the new Recipe (descendant) to the tree -- but without any ancestors
    // (because we haven't yet set the ancestor).
    //
-   qDebug() <<
+   qCDebug(logTrees) <<
       Q_FUNC_INFO << "Created descendant Recipe" << descendant->key() << "of Recipe" << ancestor->key();
 
    //
@@ -398,7 +440,7 @@ void RecipeTreeModel::spawnRecipe(QModelIndex index) {
 }
 
 void RecipeTreeModel::versionedRecipe(Recipe * ancestor, Recipe * descendant) {
-   qDebug() <<
+   qCDebug(logTrees) <<
       Q_FUNC_INFO << "Updating tree now that Recipe" << descendant->key() << "has ancestor Recipe" << ancestor->key();
 
    //
@@ -82,6 +82,15 @@ private:
                    TreeItemNode<Recipe> & recipeNode,
                    bool const recurse = true);
 
+   //! \brief Whether \c addSubTree would add anything for \c recipe
+   bool hasSubTree(Recipe const & recipe) const;
+
+   /**
+    * \brief If \c recipe is a prior version of another Recipe, then it is shown (if at all) in the sub-tree of the
+    *        newest version, which is what we return.  Otherwise returns \c nullptr.
+    */
+   Recipe const * subTreeOwner(Recipe const & recipe) const;
+
 };
 
 #endif
@@ -28,18 +28,23 @@
 #include <utility>
 
 #include <QDebug>
+#include <QHash>
+#include <QList>
 #include <QMimeData>
 #include <QModelIndex>
-#include <QQueue>
+#include <QSet>
 #include <QString>
 #include <QStringBuilder> // Needed for efficient QString concatenation operator (%)
 #include <QVariant>
 #include <qglobal.h> // For Q_ASSERT and Q_UNREACHABLE
 
+#include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "trees/TreeNode.h"
 #include "trees/TreeModel.h"
 #include "trees/TreeModelChangeGuard.h"
+#include "utils/CellDataCache.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 #include "utils/TypeTraits.h"
 
@@ -73,13 +78,22 @@ template<class Derived> class TreeModelPhantom;
 template<class Derived, class NE, typename SNE = void>
 class TreeModelBase : public CuriouslyRecurringTemplateBase<TreeModelPhantom, Derived> {
    friend Derived;
+   /**
+    * \brief There are two possible reasons a tree could support nodes with sub-trees:
+    *           - the tree supports secondary items; and/or
+    *           - it's possible in this tree for primary items to have other primary items as children.
+    */
+   static constexpr bool SupportsSubTrees = !IsVoid<SNE> ||
+                                            std::is_constructible_v<typename TreeItemNode<NE>::ChildPtrTypes,
+                                                                    std::shared_ptr<TreeItemNode<NE>>>;
 private:
    /**
     * \brief Derived classes should also call \c TreeModelBase::connectSignalsAndSlots from their own constructor (see
     *        TREE_MODEL_COMMON_CODE).
     */
    TreeModelBase() :
-   m_rootNode{std::make_unique<TreeFolderNode<NE>>(this->derived())} {
+   m_rootNode{std::make_unique<TreeFolderNode<NE>>(this->derived())},
+   m_cellDataCache{Derived::staticMetaObject.className()} {
       return;
    }
 
@@ -134,10 +148,31 @@ public:
       return QModelIndex();
    }
 
+   /**
+    * \brief Turn on (or off) caching of the results of \c doData.  See \c CellDataCache for more details.
+    */
+   void setCellCacheEnabled(bool const enabled) {
+      this->m_cellDataCache.setEnabled(enabled);
+      return;
+   }
+
    QVariant doData(QModelIndex const & index, int const role) const {
       TreeNode * treeNode = this->doTreeNode(index);
       if (treeNode) {
-         return treeNode->data(index.column(), role);
+         //
+         // Item nodes are cached against the object they show, because that's what sends us the changed signals.
+         // Folders don't (yet) have an underlying NamedEntity, so we use the node itself (which is OK because we
+         // empty the cache whenever nodes are removed from the tree).
+         //
+         void const * cacheKey = treeNode->classifier() == TreeNodeClassifier::Folder ?
+            static_cast<void const *>(treeNode) : static_cast<void const *>(treeNode->rawUnderlyingItem());
+         std::optional<QVariant> cachedData = this->m_cellDataCache.get(cacheKey, index.column(), role);
+         if (cachedData) {
+            return *cachedData;
+         }
+         QVariant data = treeNode->data(index.column(), role);
+         this->m_cellDataCache.insert(cacheKey, index.column(), role, data);
+         return data;
       }
 
       return QVariant();
@@ -159,6 +194,79 @@ public:
       return this->doTreeNode(parent)->childCount();
    }
 
+   /**
+    * \brief For a node whose contents we have not yet put in the tree (see \c insertPrimaryItem), we check whether
+    *        there is anything to put in it, without building the nodes, so that the view only shows as expandable the
+    *        nodes that really are.
+    */
+   bool doHasChildren(QModelIndex const & parent) const {
+      TreeNode * treeNode = this->doTreeNode(parent);
+      if (treeNode->childCount() > 0) {
+         return true;
+      }
+      if (treeNode->classifier() == TreeNodeClassifier::Folder) {
+         auto const deferredItems =
+            this->m_unfetchedFolderItems.constFind(static_cast<TreeFolderNode<NE> const *>(treeNode));
+         return deferredItems != this->m_unfetchedFolderItems.cend() && !deferredItems->isEmpty();
+      }
+      if (treeNode->classifier() == TreeNodeClassifier::PrimaryItem && this->m_unfetchedSubTrees.contains(treeNode)) {
+         return this->hasSubTree(*static_cast<TreeItemNode<NE> const *>(treeNode)->underlyingItem());
+      }
+      return false;
+   }
+
+   /**
+    * \brief Returns \c true if \c predicate is \c true for any item in the folder at \c folderIndex or any of its
+    *        sub-folders.  This includes items that we have not yet put in the tree (see \c insertPrimaryItem), so
+    *        callers (eg a sort/filter proxy searching the tree) do not have to fetch the whole tree to find out.
+    */
+   template<typename Predicate>
+   bool folderContainsItem(QModelIndex const & folderIndex, Predicate const & predicate) const {
+      TreeNode * treeNode = this->doTreeNode(folderIndex);
+      if (treeNode->classifier() != TreeNodeClassifier::Folder) {
+         return false;
+      }
+
+      int const numChildren = this->doRowCount(folderIndex);
+      for (int row = 0; row < numChildren; ++row) {
+         QModelIndex const childIndex = this->doIndex(row, 0, folderIndex);
+         TreeNode * childNode = this->doTreeNode(childIndex);
+         if (childNode->classifier() == TreeNodeClassifier::Folder) {
+            if (this->folderContainsItem(childIndex, predicate)) {
+               return true;
+            }
+         } else if (childNode->classifier() == TreeNodeClassifier::PrimaryItem) {
+            NamedEntity const * item = childNode->rawUnderlyingItem();
+            if (item && predicate(*item)) {
+               return true;
+            }
+         }
+      }
+
+      auto const deferredItems =
+         this->m_unfetchedFolderItems.constFind(static_cast<TreeFolderNode<NE> const *>(treeNode));
+      if (deferredItems != this->m_unfetchedFolderItems.cend()) {
+         for (auto const & item : *deferredItems) {
+            if (predicate(*item)) {
+               return true;
+            }
+         }
+      }
+      return false;
+   }
+
+   bool doCanFetchMore(QModelIndex const & parent) const {
+      return this->isUnfetched(*this->doTreeNode(parent));
+   }
+
+   /**
+    * \brief Called by the view (via the sort/filter proxy) when the user expands a node we haven't populated yet
+    */
+   void doFetchMore(QModelIndex const & parent) {
+      this->fetchNode(*this->doTreeNode(parent));
+      return;
+   }
+
    int doColumnCount([[maybe_unused]] QModelIndex const & parent) const {
       return TreeItemNode<NE>::NumberOfColumns;
    }
@@ -266,7 +374,7 @@ public:
          // "䙥牭敮瑡扬攀"!
          //
          TreeNode * treeNode = this->doTreeNode(modelIndex);
-         qDebug() << Q_FUNC_INFO << *treeNode;
+         qCDebug(logTrees) << Q_FUNC_INFO << *treeNode;
          switch (treeNode->classifier()) {
             case TreeNodeClassifier::Folder:
                {
@@ -322,7 +430,7 @@ public:
                        [[maybe_unused]] int column,
                        QModelIndex const & parentIndex) {
       // See https://en.wikipedia.org/wiki/Media_type for more on MIME types (now called media types)
-      qDebug() <<
+      qCDebug(logTrees) <<
          Q_FUNC_INFO << "MIME Data:" << (mimeData ? mimeData->text() : "NULL") << ".  "
          "Parent" << (parentIndex.isValid() ? "valid" : "invalid");
 
@@ -330,7 +438,7 @@ public:
          return false;
       }
 
-      qDebug() << Q_FUNC_INFO << "Parent row:" << parentIndex.row() << ", column:" << parentIndex.column();
+      qCDebug(logTrees) << Q_FUNC_INFO << "Parent row:" << parentIndex.row() << ", column:" << parentIndex.column();
 
       QByteArray encodedData;
 
@@ -339,7 +447,7 @@ public:
       } else if (mimeData->hasFormat(TreeFolderNode<NE>::DragNDropMimeType)) {
          encodedData = mimeData->data(TreeFolderNode<NE>::DragNDropMimeType);
       } else {
-         qDebug() << Q_FUNC_INFO << "Unrecognised MIME type";
+         qCDebug(logTrees) << Q_FUNC_INFO << "Unrecognised MIME type";
          return false;   // Don't know what we got, but we don't want it
       }
 
@@ -348,7 +456,7 @@ public:
          // Did you know there's a space between elements in a tree, and you can
          // actually drop things there? If somebody drops something there, don't
          // do anything
-         qDebug() << Q_FUNC_INFO << "Invalid drop location";
+         qCDebug(logTrees) << Q_FUNC_INFO << "Invalid drop location";
          return false;
       }
 
@@ -362,7 +470,7 @@ public:
          targetFolderPath = itemParentNode.underlyingItem()->folderPath();
       }
 
-      qDebug() << Q_FUNC_INFO << "Target:" << targetFolderPath;
+      qCDebug(logTrees) << Q_FUNC_INFO << "Target:" << targetFolderPath;
 
       // Pull the stream apart and do that which needs done. Late binding ftw!
       for (QDataStream stream{&encodedData, QIODevice::ReadOnly}; !stream.atEnd(); ) {
@@ -373,16 +481,16 @@ public:
          int id = -1;
          QString name = "";
          stream >> className >> id >> name;
-         qDebug() << Q_FUNC_INFO << "Class:" << className << ", Name:" << name << ", ID:" << id;
+         qCDebug(logTrees) << Q_FUNC_INFO << "Class:" << className << ", Name:" << name << ", ID:" << id;
 
          if (className == NE::staticMetaObject.className()) {
             auto item = ObjectStoreWrapper::getById<NE>(id);
             if (!item) {
-               qDebug() << Q_FUNC_INFO << "Could not find" << NE::staticMetaObject.className() << "with ID" << id;
+               qCDebug(logTrees) << Q_FUNC_INFO << "Could not find" << NE::staticMetaObject.className() << "with ID" << id;
                return false;
             }
             auto folder = item->folderPath();
-            qDebug() <<
+            qCDebug(logTrees) <<
                Q_FUNC_INFO << "Moving" << item << "from folder" << folder << "to folder" << targetFolderPath;
             // Dropping an item in a folder just means setting the folder name on that item
             item->setFolderPath(targetFolderPath);
@@ -425,8 +533,17 @@ public:
 
    /**
     * \brief Add an item to the tree
+    *
+    *        Building tree nodes is not free, and, with a large database, most folders and most items' sub-trees are
+    *        never looked at in a given session.  So we only create nodes for things the user can actually see:
+    *           - If the item is in a folder that has not yet been expanded (or \c deferIfInFolder is \c true), we
+    *             just remember the item against the folder, and \c fetchNode adds it when the folder is expanded;
+    *           - Otherwise we add the item's node, but leave its sub-tree (eg BrewNotes in the Recipe tree) until the
+    *             item itself is expanded.
+    *
+    * \param deferIfInFolder Set by \c loadTreeModel so that, initially, only the top-level items are in the tree
     */
-   void insertPrimaryItem(std::shared_ptr<NE> item) {
+   void insertPrimaryItem(std::shared_ptr<NE> item, bool const deferIfInFolder = false) {
       QModelIndex parentIndex;
       int childNumber;
       QString const folderPath = item->folderPath();
@@ -437,7 +554,13 @@ public:
             qCritical() << Q_FUNC_INFO << "Invalid return from findFolder";
             return;
          }
-         childNumber = this->doTreeNode(parentIndex)->childCount();
+         auto folderNode = static_cast<TreeFolderNode<NE> *>(this->doTreeNode(parentIndex));
+         if (deferIfInFolder || this->m_unfetchedFolderItems.contains(folderNode)) {
+            this->m_unfetchedFolderItems[folderNode].append(item);
+            this->m_unfetchedItemFolders.insert(item.get(), folderNode);
+            return;
+         }
+         childNumber = folderNode->childCount();
       } else {
          childNumber = this->m_rootNode->childCount();
          parentIndex = this->getRootIndex();
@@ -448,7 +571,7 @@ public:
       TreeNode * parentNode = this->doTreeNode(parentIndex);
 
       // Normally leave this debug statement commented out as otherwise it generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Inserting" << *item << "as child #" << childNumber << "of" << parentIndex;
+//      qCDebug(logTrees) << Q_FUNC_INFO << "Inserting" << *item << "as child #" << childNumber << "of" << parentIndex;
       if (!this->insertChild(parentIndex, childNumber, item)) {
          qCritical() << Q_FUNC_INFO << "Insert failed";
          return;
@@ -459,29 +582,168 @@ public:
       auto & itemNode = static_cast<TreeItemNode<NE> &>(*itemRawNode);
 
       // Depending on the tree type, there might be secondary items (eg BrewNote items on RecipeTreeModel) or other
-      // primary items (eg ancestor Recipes on RecipeTreeModel) under this one.
-      this->addSubTreeIfNeeded(*item, itemNode);
+      // primary items (eg ancestor Recipes on RecipeTreeModel) under this one.  If so, they get added by fetchNode when
+      // the item is expanded.
+      if constexpr (SupportsSubTrees) {
+         this->m_unfetchedSubTrees.insert(&itemNode);
+      }
 
       this->observeElement(item);
       return;
    }
 
+   /**
+    * \brief Returns \c true if \c element would have anything under it once its sub-tree is built (see
+    *        \c addSubTreeIfNeeded).  The rules are the same as there.
+    */
+   bool hasSubTree(NE const & element) const {
+      if constexpr (SupportsSubTrees) {
+         if constexpr (std::same_as<SNE,         MashStep> ||
+                       std::same_as<SNE,         BoilStep> ||
+                       std::same_as<SNE, FermentationStep>) {
+            return !SNE::ownedBy(element).empty();
+         } else {
+            return this->derived().hasSubTree(element);
+         }
+      }
+      return false;
+   }
+
+   /**
+    * \brief Returns \c true if \c treeNode has contents that we have deferred putting in the tree
+    */
+   bool isUnfetched(TreeNode const & treeNode) const {
+      if (this->m_unfetchedSubTrees.contains(&treeNode)) {
+         return true;
+      }
+      return treeNode.classifier() == TreeNodeClassifier::Folder &&
+             this->m_unfetchedFolderItems.contains(static_cast<TreeFolderNode<NE> const *>(&treeNode));
+   }
+
+   /**
+    * \brief Put in the tree whatever we deferred adding under \c treeNode (see \c insertPrimaryItem).  Does nothing
+    *        if there is nothing outstanding.
+    */
+   void fetchNode(TreeNode & treeNode) {
+      if (treeNode.classifier() == TreeNodeClassifier::Folder) {
+         auto folderNode = static_cast<TreeFolderNode<NE> *>(&treeNode);
+         if (!this->m_unfetchedFolderItems.contains(folderNode)) {
+            return;
+         }
+         // Take the list out of the map first, so that insertPrimaryItem doesn't just put the items back on it
+         QList<std::shared_ptr<NE>> const items = this->m_unfetchedFolderItems.take(folderNode);
+         qCDebug(logTrees) << Q_FUNC_INFO << "Adding" << items.size() << "deferred item(s) to" << treeNode;
+         for (auto item : items) {
+            this->m_unfetchedItemFolders.remove(item.get());
+            // Note that insertPrimaryItem looks at the item's current folder, which is what we want if it has moved
+            // since we deferred it.
+            if (!item->deleted()) {
+               this->insertPrimaryItem(item);
+            }
+         }
+         return;
+      }
+
+      if (treeNode.classifier() == TreeNodeClassifier::PrimaryItem && this->m_unfetchedSubTrees.remove(&treeNode)) {
+         auto & itemNode = static_cast<TreeItemNode<NE> &>(treeNode);
+         this->addSubTreeIfNeeded(*itemNode.underlyingItem(), itemNode);
+      }
+      return;
+   }
+
+   /**
+    * \brief Recursively fetch everything under \c treeNode.  This is for operations (renaming or deleting a folder,
+    *        etc) that need to see every item under a node, not just the ones the user has looked at.
+    *
+    * \param includeItemSubTrees If \c false, we only fetch the contents of folders
+    */
+   void fetchAll(TreeNode & treeNode, bool const includeItemSubTrees = false) {
+      if (includeItemSubTrees || treeNode.classifier() == TreeNodeClassifier::Folder) {
+         this->fetchNode(treeNode);
+         for (int ii = 0; ii < treeNode.childCount(); ++ii) {
+            this->fetchAll(*treeNode.rawChild(ii), includeItemSubTrees);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Call when \c treeNode is about to be removed from the tree, so we don't hang on to pointers to it or any of
+    *        its children.
+    */
+   void forgetSubTree(TreeNode & treeNode) {
+      this->m_unfetchedSubTrees.remove(&treeNode);
+      switch (treeNode.classifier()) {
+         case TreeNodeClassifier::Folder:
+            {
+               auto & folderNode = static_cast<TreeFolderNode<NE> &>(treeNode);
+               auto const items = this->m_unfetchedFolderItems.take(&folderNode);
+               for (auto item : items) {
+                  this->m_unfetchedItemFolders.remove(item.get());
+               }
+               // The root node doesn't have a Folder
+               if (folderNode.underlyingItem()) {
+                  QString const fullPath = folderNode.underlyingItem()->fullPath();
+                  if (this->m_folderNodeIndex.value(fullPath, nullptr) == &folderNode) {
+                     this->m_folderNodeIndex.remove(fullPath);
+                  }
+               }
+            }
+            break;
+         case TreeNodeClassifier::PrimaryItem:
+            this->m_primaryNodeIndex.remove(static_cast<NE const *>(treeNode.rawUnderlyingItem()), &treeNode);
+            break;
+         case TreeNodeClassifier::SecondaryItem:
+            if constexpr (!IsVoid<SNE>) {
+               this->m_secondaryNodeIndex.remove(static_cast<SNE const *>(treeNode.rawUnderlyingItem()), &treeNode);
+            }
+            break;
+      }
+      for (int ii = 0; ii < treeNode.childCount(); ++ii) {
+         this->forgetSubTree(*treeNode.rawChild(ii));
+      }
+      return;
+   }
+
+   /**
+    * \brief If \c item is waiting to be added to a folder that hasn't been expanded yet, stop waiting.
+    *
+    * \return \c true if the item was waiting (in which case it is not in the tree), \c false otherwise
+    */
+   bool forgetUnfetchedItem(NE const & item) {
+      TreeFolderNode<NE> * folderNode = this->m_unfetchedItemFolders.take(&item);
+      if (!folderNode) {
+         return false;
+      }
+      auto & items = this->m_unfetchedFolderItems[folderNode];
+      items.removeIf([&item](std::shared_ptr<NE> const & waiting) { return waiting.get() == &item; });
+      if (items.isEmpty()) {
+         this->m_unfetchedFolderItems.remove(folderNode);
+      }
+      return true;
+   }
+
    /**
     * \brief Call this at the end of derived class's constructor.
     */
    void loadTreeModel() {
       auto primaryItems = ObjectStoreWrapper::getAllDisplayable<NE>();
-      qDebug() << Q_FUNC_INFO << "Got " << primaryItems.length() << NE::staticMetaObject.className() << "items";
+      qCDebug(logTrees) << Q_FUNC_INFO << "Got " << primaryItems.length() << NE::staticMetaObject.className() << "items";
 
+      // Items in folders are only added to the tree when the folder is expanded -- see comment in insertPrimaryItem
       for (auto item : primaryItems) {
-         this->insertPrimaryItem(item);
+         this->insertPrimaryItem(item, true);
       }
 
-      int const numPrimaryItems = this->m_rootNode->nodeCount(TreeNodeClassifier::PrimaryItem);
-      qDebug() <<
+      int numUnfetchedItems = 0;
+      for (auto const & items : std::as_const(this->m_unfetchedFolderItems)) {
+         numUnfetchedItems += items.size();
+      }
+      int const numPrimaryItems = this->m_rootNode->nodeCount(TreeNodeClassifier::PrimaryItem) + numUnfetchedItems;
+      qCDebug(logTrees) <<
          Q_FUNC_INFO << NE::staticMetaObject.className() << "tree now has" <<
-         numPrimaryItems << "primary items";
-      qDebug().noquote() << Q_FUNC_INFO << "Tree:\n" << this->m_rootNode->subTreeToString();
+         numPrimaryItems << "primary items (" << numUnfetchedItems << "of which in unexpanded folders)";
+      qCDebug(logTrees).noquote() << Q_FUNC_INFO << "Tree:\n" << this->m_rootNode->subTreeToString();
       //
       // It's possible for the tree to have _more_ primary items than we inserted (because, eg in a Recipe tree, we add
       // the ancestors of each recipe), but it should never have fewer.
@@ -497,6 +759,11 @@ public:
 
    void observeElement(std::shared_ptr<NE> observed) {
       if (observed) {
+         // Any property change can alter what we show in one of the columns, so cached data for the item is stale
+         this->derived().connect(observed.get(), &NamedEntity::changed, &this->derived(),
+                                 [this, rawObserved = observed.get()]() {
+                                    this->m_cellDataCache.invalidate(rawObserved);
+                                 });
          this->derived().connect(observed.get(), &NamedEntity::changedName  , &this->derived(), &Derived::elementChanged);
          // .:TBD:. AFAICT nothing emits NamedEntity::changedFolder...
          this->derived().connect(observed.get(), &NamedEntity::changedFolder, &this->derived(), &Derived::folderChanged );
@@ -506,6 +773,10 @@ public:
 
    void observeElement(std::shared_ptr<SNE> observed) requires (!IsVoid<SNE>) {
       if (observed) {
+         this->derived().connect(observed.get(), &NamedEntity::changed, &this->derived(),
+                                 [this, rawObserved = observed.get()]() {
+                                    this->m_cellDataCache.invalidate(rawObserved);
+                                 });
          if constexpr (std::same_as<NE, BrewNote>) {
             // For a BrewNote, it's the date, not the name, that we're interested in
             this->derived().connect(observed.get(), &BrewNote::brewDateChanged, &this->derived(), &Derived::secondaryElementChanged);
@@ -537,115 +808,76 @@ public:
     *        as this is used to show ancestorship (ie prior versions of a \c Recipe).  In all trees, folders can also
     *        contain other folders.  Caller can provide a starting node, otherwise we'll start at the root of the tree.
     *
+    *        If the element is somewhere we haven't yet populated (see \c insertPrimaryItem), then we populate that part
+    *        of the tree first, as the caller is presumably about to do something with the returned index.
+    *
     * \param ne The primary element (eg \c Recipe) we are looking for.
     */
    QModelIndex findElement(NE const * ne, TreeNode * parent = nullptr) {
       Q_ASSERT(ne);
-      if (!parent) {
-         parent = this->m_rootNode.get();
+      TreeFolderNode<NE> * unfetchedFolder = this->m_unfetchedItemFolders.value(ne, nullptr);
+      if (unfetchedFolder) {
+         this->fetchNode(*unfetchedFolder);
       }
 
-      //
-      // We do a breadth-first search of the tree.  It seems as good as anything, given we don't have any a priori
-      // reason to prefer one search order over another.  An obvious alternative would be a depth-first search using
-      // recursion.
-      //
-      QQueue<TreeNode *> queue;
-      queue.enqueue(parent);
-
-      while (!queue.isEmpty()) {
-         auto nodeToSearchIn = queue.dequeue();
-         // Normally leave the next line commented out as it generates quite a bit of logging
-//         qDebug() << Q_FUNC_INFO << "Find" << ne << "(at" << static_cast<void const *>(ne) << ") in" << *nodeToSearchIn;
-         if (nodeToSearchIn->classifier() == TreeNodeClassifier::PrimaryItem) {
-            //
-            // This is a compile-time check whether it's possible in this tree for primary items to have other primary
-            // items as children.  (If not, which is the case in most trees, we can skip over looking for children of
-            // primary items.)
-            //
-            if constexpr (std::is_constructible_v<typename TreeItemNode<NE>::ChildPtrTypes,
-                                                  std::shared_ptr<TreeItemNode<NE>>>) {
-               //
-               // Primary items can be inside other primary items in this tree.  This is the case, eg in the Recipe
-               // tree.
-               //
-               // We assume that nodeToSearchIn doesn't itself match what we're looking for, otherwise we wouldn't have
-               // put it on the queue.
-               //
-               auto & searchInItem = static_cast<TreeItemNode<NE> &>(*nodeToSearchIn);
-               for (int childNumInPrimaryItem = 0; childNumInPrimaryItem < searchInItem.childCount(); ++childNumInPrimaryItem) {
-                  auto child = searchInItem.child(childNumInPrimaryItem);
-                  if (std::holds_alternative<std::shared_ptr<TreeItemNode<NE>>>(child)) {
-                     auto itemNode = std::get<std::shared_ptr<TreeItemNode<NE>>>(child);
-                     // Normally leave the next line commented out as it can generate quite a bit of logging
-//                     qDebug() <<
-//                        Q_FUNC_INFO << "itemNode:" << *itemNode << "(at " <<
-//                        static_cast<void *>(itemNode->underlyingItem().get()) << ")";
-                     if (itemNode->underlyingItem().get() == const_cast<NE *>(ne)) {
-                        // We found what we were looking for
-//                        qDebug() << Q_FUNC_INFO << "Found as child #" << childNumInPrimaryItem << "of" << searchInItem;
-                        return this->derived().createIndex(childNumInPrimaryItem, 0, itemNode.get());
-                     }
-                     //
-                     // The child primary item wasn't a match, but it itself might contain other primary items, so throw
-                     // it on the queue.
-                     //
-                     queue.enqueue(itemNode.get());
-                  }
-                  // Primary items can never contain folders, so if the child wasn't another primary item, we can ignore
-                  // it
-               }
-            }
-
-            //
-            // We either processed this nodeToSearchIn item or skipped over it (because this tree does not support
-            // primary items inside other primary items), so go to the next item in the queue.
-            //
-            continue;
-         }
-
+      QModelIndex index = this->searchForElement(ne, parent);
+      if constexpr (std::is_constructible_v<typename TreeItemNode<NE>::ChildPtrTypes,
+                                            std::shared_ptr<TreeItemNode<NE>>>) {
          //
-         // If we got here, either nodeToSearchIn cannot be a primary item (because either that's not allowed in this
-         // tree or it's handled above), so it's a coding error if we're trying to look inside anything other than a
-         // folder.
+         // In a tree where primary items can be inside other primary items (eg ancestor Recipes in the Recipe tree),
+         // the element could be in a sub-tree we haven't built yet.  The derived class tells us which item that
+         // sub-tree belongs to (eg the newest version of the Recipe), so we find that item (which might mean fetching
+         // its folder) and build just its sub-tree.
          //
-         Q_ASSERT(nodeToSearchIn->classifier() == TreeNodeClassifier::Folder);
-         auto & folderNodeToSearchIn = static_cast<TreeFolderNode<NE> &>(*nodeToSearchIn);
-         for (int childNumInFolder = 0; childNumInFolder < folderNodeToSearchIn.childCount(); ++childNumInFolder) {
-            auto child = folderNodeToSearchIn.child(childNumInFolder);
-            if (std::holds_alternative<std::shared_ptr<TreeItemNode<NE>>>(child)) {
-               auto itemNode = std::get<std::shared_ptr<TreeItemNode<NE>>>(child);
-               // Normally leave the next line commented out as it generates quite a bit of logging
-//               qDebug() <<
-//                  Q_FUNC_INFO << "itemNode:" << *itemNode << "(at " <<
-//                  static_cast<void *>(itemNode->underlyingItem().get()) << ")";
-               if (itemNode->underlyingItem().get() == const_cast<NE *>(ne)) {
-                  // We found what we were looking for
-//                  qDebug() << Q_FUNC_INFO << "Found as child #" << childNumInFolder << "of" << folderNodeToSearchIn;
-                  return this->derived().createIndex(childNumInFolder, 0, itemNode.get());
-               }
-               if constexpr (std::is_constructible_v<typename TreeItemNode<NE>::ChildPtrTypes,
-                                                     std::shared_ptr<TreeItemNode<NE>>>) {
-                  // We're in a tree where primary items can contain other primary items, and the child primary item
-                  // wasn't a match, so throw it on the queue.
-                  queue.enqueue(itemNode.get());
+         if (!index.isValid()) {
+            NE const * subTreeOwner = this->derived().subTreeOwner(*ne);
+            if (subTreeOwner && subTreeOwner != ne) {
+               QModelIndex const subTreeOwnerIndex = this->findElement(subTreeOwner, parent);
+               if (subTreeOwnerIndex.isValid()) {
+                  this->fetchNode(*this->doTreeNode(subTreeOwnerIndex));
+                  index = this->searchForElement(ne, parent);
                }
-            } else if (std::holds_alternative<std::shared_ptr<TreeFolderNode<NE>>>(child)) {
-               // We found another folder to look in.  Add it to the list.
-               auto folderNode = std::get<std::shared_ptr<TreeFolderNode<NE>>>(child);
-//               qDebug() << Q_FUNC_INFO << "folderNode:" << *folderNode;
-               queue.enqueue(folderNode.get());
-            } else {
-               // It should be impossible to get here, as folders only contain either primary items or other folders
-               Q_ASSERT(false);
             }
          }
       }
+      return index;
+   }
+
+private:
+   /**
+    * \brief Does the work for \c findElement, looking only at nodes that are already in the tree.
+    */
+   QModelIndex searchForElement(NE const * ne, TreeNode * parent) {
+      //
+      // An element is normally in the tree at most once, but, eg in the Recipe tree, it's possible for an ancestor
+      // Recipe to briefly be in two places while the tree is being rearranged, hence the need to check that what we
+      // found is under the requested parent.
+      //
+      auto const [begin, end] = this->m_primaryNodeIndex.equal_range(ne);
+      for (auto ii = begin; ii != end; ++ii) {
+         TreeNode * node = ii.value();
+         if (!parent || parent == this->m_rootNode.get() || this->isInSubTree(*node, *parent)) {
+            return this->indexOfNode(node);
+         }
+      }
 
       // If we got here, we didn't find a match
       return QModelIndex();
    }
 
+   /**
+    * \brief Returns \c true if \c treeNode is a descendant of \c ancestor
+    */
+   bool isInSubTree(TreeNode const & treeNode, TreeNode const & ancestor) const {
+      for (TreeNode const * node = treeNode.rawParent(); node; node = node->rawParent()) {
+         if (node == &ancestor) {
+            return true;
+         }
+      }
+      return false;
+   }
+
+public:
    //
    // Notwithstanding the "requires" condition, GCC 13.3 gives an error about "forming reference to void" when we write:
    //       QModelIndex findElement(SNE const & sne) requires (!IsVoid<SNE>) {
@@ -664,24 +896,27 @@ public:
       std::shared_ptr<NE> const owner = sne->owner();
 
       QModelIndex ownerIndex = this->findElement(owner.get());
+      if (!ownerIndex.isValid()) {
+         return QModelIndex();
+      }
       //
       // Secondary elements can only be stored inside of primary ones (eg BrewNote cannot live directly in a folder or
       // in another BrewNote), so this cast is safe.
       //
       auto ownerNode = static_cast<TreeItemNode<NE> *>(this->doTreeNode(ownerIndex));
-      for (int ii = 0; ii < ownerNode->childCount(); ++ii) {
-         auto childNodeVar = ownerNode->child(ii);
-         if (std::holds_alternative<std::shared_ptr<TreeItemNode<SNE>>>(childNodeVar)) {
-            auto childNode = std::get<std::shared_ptr<TreeItemNode<SNE>>>(childNodeVar);
-            std::shared_ptr<SNE> const child = childNode->underlyingItem();
-            if (child->key() == sne->key()) {
-               // See comment in trees/TreeModel.h for how QModelIndex is used in trees.
-               return this->derived().createIndex(ii, 0, childNode.get());
-            }
+      this->fetchNode(*ownerNode);
+
+      //
+      // The same secondary element can be in the tree more than once (eg a BrewNote shows up under each node of its
+      // Recipe), so we want the one that lives under the owner node we just found.
+      //
+      // See comment in trees/TreeModel.h for how QModelIndex is used in trees.
+      auto const [begin, end] = this->m_secondaryNodeIndex.equal_range(sne);
+      for (auto ii = begin; ii != end; ++ii) {
+         if (ii.value()->rawParent() == ownerNode) {
+            return this->indexOfNode(ii.value());
          }
       }
-
-      // If we got here, we didn't find a match
       return QModelIndex();
    }
 
@@ -711,6 +946,20 @@ public:
          return QModelIndex();
       }
 
+      //
+      // Most of the time we're looking for a folder that already exists, starting from the root, in which case we can
+      // just look it up.  Otherwise, we walk down the tree to find where to start creating.
+      //
+      if (pItem == this->m_rootNode.get()) {
+         TreeFolderNode<NE> * folderNode = this->m_folderNodeIndex.value(QString{"/" % dirs.join("/")}, nullptr);
+         if (folderNode) {
+            if (folderIsNewlyCreated) {
+               *folderIsNewlyCreated = false;
+            }
+            return this->indexOfNode(folderNode);
+         }
+      }
+
       QString current = dirs.takeFirst();
       QString fullPath = "/";
       QString targetPath = fullPath % current;
@@ -799,8 +1048,13 @@ public:
                                                 row);
 
       auto childNode = std::make_shared<TreeItemNode<ElementType>>(this->derived(), &parentNode, element);
+      if constexpr (std::same_as<ElementType, NE>) {
+         this->m_primaryNodeIndex.insert(element.get(), childNode.get());
+      } else {
+         this->m_secondaryNodeIndex.insert(element.get(), childNode.get());
+      }
       // Normally leave this debug statement commented out as otherwise it generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Inserting new node " << *childNode << "as child #" << row << "of" << parentNode;
+//      qCDebug(logTrees) << Q_FUNC_INFO << "Inserting new node " << *childNode << "as child #" << row << "of" << parentNode;
 
       // Parent node can only be one of two types. (It cannot be SecondaryItem because, although we allow Recipes to
       // contain Recipes -- for Recipe versioning -- we don't allow BrewNotes to contain BrewNotes etc.)
@@ -815,7 +1069,7 @@ public:
       }
 
       // Normally leave this debug statement commented out as otherwise it generates too much logging
-//      qDebug() << Q_FUNC_INFO << "Insert" << (succeeded ? "succeeded" : "failed");
+//      qCDebug(logTrees) << Q_FUNC_INFO << "Insert" << (succeeded ? "succeeded" : "failed");
 
       // It's a coding error if the parent node into which we just inserted a child doesn't now have one more child than
       // before!
@@ -897,7 +1151,12 @@ public:
                                                 parentIndex,
                                                 firstRow,
                                                 lastRow);
-      qDebug() << Q_FUNC_INFO << "Removing children" << firstRow << "to" << lastRow << "from" << parentNode;
+      qCDebug(logTrees) << Q_FUNC_INFO << "Removing children" << firstRow << "to" << lastRow << "from" << parentNode;
+      for (int row = firstRow; row <= lastRow; ++row) {
+         this->forgetSubTree(*parentNode.rawChild(row));
+      }
+      // Removed folder nodes could be freed and their addresses reused, so we can't keep anything cached against them
+      this->m_cellDataCache.clear();
       return parentNode.removeChildren(firstRow, count);
    }
 
@@ -908,16 +1167,23 @@ public:
     * \return \c true if succeeded, \c false otherwise
     */
    bool removeChildren(int row, int count, QModelIndex const & parentIndex) {
-      if (0 == count) {
-         // No children to remove = no work to do = succeeded
-         return true;
-      }
-
       TreeNode * parentNode = this->doTreeNode(parentIndex);
       if (!parentNode) {
          return false;
       }
 
+      //
+      // Removing all the children of an item is how callers (eg RecipeTreeModel::showAncestors) start rebuilding its
+      // sub-tree themselves, so we must not subsequently add the deferred sub-tree on top of what they put there.
+      // (This applies even if there are no children to remove.)
+      //
+      this->m_unfetchedSubTrees.remove(parentNode);
+
+      if (0 == count) {
+         // No children to remove = no work to do = succeeded
+         return true;
+      }
+
       //
       // Parent node is usually a folder, though in Recipe tree it can also be a primary item (ie Recipe).  It can never
       // be a secondary item.
@@ -958,6 +1224,7 @@ private:
          int const numChildren = parentNode->childCount();
 
          parentNode->insertChild(numChildren, newFolderNode);
+         this->m_folderNodeIndex.insert(newFolder->fullPath(), newFolderNode.get());
 
          // Set the parent item to point to the newly created tree
          parentNode = newFolderNode.get();
@@ -1006,6 +1273,11 @@ protected:
          return;
       }
 
+      // If the owner's sub-tree hasn't been built yet, the new element will get picked up when it is
+      if (this->m_unfetchedSubTrees.contains(this->doTreeNode(parentIndex))) {
+         return;
+      }
+
       int breadth = this->doRowCount(parentIndex);
       if (!this->insertChild(parentIndex, breadth, element)) {
          return;
@@ -1025,7 +1297,13 @@ private:
          return;
       }
 
-      qDebug() << Q_FUNC_INFO << *element << "was deleted";
+      qCDebug(logTrees) << Q_FUNC_INFO << *element << "was deleted";
+      if constexpr (std::same_as<T, NE>) {
+         // If we never got round to putting the element in the tree, there's nothing to remove
+         if (this->forgetUnfetchedItem(*element)) {
+            return;
+         }
+      }
       QModelIndex index = this->findElement(element.get());
       if (!index.isValid()) {
          // This is probably a coding error, but we can recover
@@ -1055,6 +1333,8 @@ public:
          return false;
       }
 
+      this->fetchAll(nodeToDelete, true);
+
       // Doing the deletion recursively here means the leaves of the tree get deleted first, which is what we want
       for (int childNum = 0; childNum < nodeToDelete.childCount(); ++childNum) {
          if (!this->deleteNode(*nodeToDelete.rawChild(childNum))) {
@@ -1064,6 +1344,7 @@ public:
 
       // Remove the node from the tree structure before we delete its contents
       TreeNode & parentNodeToDelete = *nodeToDelete.rawParent();
+      this->forgetSubTree(nodeToDelete);
       parentNodeToDelete.removeChildren(nodeToDelete.childNumber(), 1);
 
       if constexpr (!IsVoid<SNE>) {
@@ -1078,7 +1359,7 @@ public:
       if (nodeToDelete.classifier() == TreeNodeClassifier::PrimaryItem) {
          auto itemNode = static_cast<TreeItemNode<NE> &>(nodeToDelete);
          std::shared_ptr<NE> item = itemNode.underlyingItem();
-         qDebug() << Q_FUNC_INFO << "Deleting" << *item;
+         qCDebug(logTrees) << Q_FUNC_INFO << "Deleting" << *item;
          ObjectStoreWrapper::softDelete(*item);
       }
 
@@ -1103,6 +1384,7 @@ public:
       if (treeNode->classifier() != TreeNodeClassifier::Folder) {
          return leafNodeIndexes;
       }
+      this->fetchAll(*treeNode);
 
       auto folderNodes = QList<TreeNode *>{};
       folderNodes.append(treeNode);
@@ -1155,7 +1437,7 @@ public:
    }
 
    bool removeElement(NE const & element) {
-      qDebug() << Q_FUNC_INFO << "Removing" << element;
+      qCDebug(logTrees) << Q_FUNC_INFO << "Removing" << element;
       QModelIndex elementIndex = this->findElement(&element);
       return this->removeItemByIndex(elementIndex);
    }
@@ -1173,6 +1455,8 @@ public:
 
       QString targetPath = newName % "/" % folder.name();
       TreeNode * folderNode = this->doTreeNode(folderIndex);
+      // We need to move everything in the folder, not just what has been shown so far
+      this->fetchAll(*folderNode);
       QList<QPair<QString, TreeNode *>> folderPathsAndNodes;
       folderPathsAndNodes.append(QPair<QString, TreeNode *>{targetPath, folderNode });
 
@@ -1279,6 +1563,7 @@ public:
          // We want to delete the contents of the folder (and remove it from from the model) before remove the folder
          // itself, otherwise the QModelIndex values for the contents will not be valid.
          Q_ASSERT(treeNode->classifier() == TreeNodeClassifier::Folder);
+         this->fetchAll(*treeNode);
          this->deleteItems(treeNode->rawChildren());
          //
          // For the moment, folders don't exist in the database, so we just remove directly from the tree
@@ -1296,7 +1581,7 @@ public:
     *                     \c newName is the name to give the copy.
     */
    void copyItems(QList<std::pair<QModelIndex, QString>> const & toBeCopied) {
-      qDebug() << Q_FUNC_INFO << "Copying" << toBeCopied.length() << "item(s)";
+      qCDebug(logTrees) << Q_FUNC_INFO << "Copying" << toBeCopied.length() << "item(s)";
       //
       // We make a list of the things we are going to insert before we insert them, as all the QModelIndex objects will
       // be invalidated by the first insert
@@ -1307,13 +1592,15 @@ public:
          rawToBeCopied.append(std::make_pair(treeNode, newName));
       }
 
+      // Deep copies (especially of Recipes) do a lot of separate writes, which we want in one DB transaction
+      DbUnitOfWork unitOfWork{"Copy items"};
       for (auto [treeNode, newName] : rawToBeCopied) {
          if (treeNode->classifier() == TreeNodeClassifier::PrimaryItem) {
             auto & neTreeNode = static_cast<TreeItemNode<NE> &>(*treeNode);
             std::shared_ptr<NE> neItem = neTreeNode.underlyingItem();
             std::shared_ptr<NE> neItemCopy = ObjectStoreWrapper::insertCopyOf(*neItem);
             neItemCopy->setName(newName);
-            qDebug() << Q_FUNC_INFO << "Copied" << *neItem << "to" << *neItemCopy;
+            qCDebug(logTrees) << Q_FUNC_INFO << "Copied" << *neItem << "to" << *neItemCopy;
             //
             // NOTE that we do NOT need to manually add the item to the tree.  Because we are connected to the
             // ObjectStore::signalObjectInserted signal, our doElementAdded() member function will already have been
@@ -1326,9 +1613,9 @@ public:
          }
       }
       int const numPrimaryItems = this->m_rootNode->nodeCount(TreeNodeClassifier::PrimaryItem);
-      qDebug() <<
+      qCDebug(logTrees) <<
          Q_FUNC_INFO << NE::staticMetaObject.className() << "tree now has" << numPrimaryItems << "primary items";
-      qDebug().noquote() << Q_FUNC_INFO << "Tree:\n" << this->m_rootNode->subTreeToString();
+      qCDebug(logTrees).noquote() << Q_FUNC_INFO << "Tree:\n" << this->m_rootNode->subTreeToString();
       return;
    }
 
@@ -1356,6 +1643,7 @@ protected:
          return;
       }
 
+      this->m_cellDataCache.invalidate(element.get());
       QModelIndex indexLeft = this->findElement(element.get());
       if (!indexLeft.isValid()) {
          return;
@@ -1425,7 +1713,7 @@ protected:
       if (!element) {
          return;
       }
-      qDebug() << Q_FUNC_INFO << *element;
+      qCDebug(logTrees) << Q_FUNC_INFO << *element;
 
       // Find the sending item in the existing tree
       QModelIndex elementIndex = this->findElement(element.get());
@@ -1433,7 +1721,6 @@ protected:
          qWarning() << Q_FUNC_INFO << "Could not find element" << element;
          return;
       }
-      auto elementNode = static_cast<TreeItemNode<NE> *>(this->doTreeNode(elementIndex));
 
       //
       // Remove the sending item from its current parent folder, which will be the root node if it had no folder.  (In
@@ -1448,32 +1735,26 @@ protected:
          qWarning() << Q_FUNC_INFO << "Could not remove row" << elementChildNumber;
          return;
       }
+      // insertPrimaryItem will observe the element again if and when it puts it back in the tree
+      this->unObserveElement(element);
 
       // Find the new parent folder.  Note that findFolder() will give us the root node if folderPath is empty, so we
       // don't have to handle that here.  Similarly, we can ask it to create the folder if it (is non-empty and) does
       // not exist.
       QString const & folderPath = element->folderPath();
-      bool folderIsNewlyCreated;
-
-      QModelIndex newParentIndex = this->findFolder(folderPath,
-                                                    this->m_rootNode.get(),
-                                                    IfNotFound::Create,
-                                                    &folderIsNewlyCreated);
-      // Root node is TreeFolderNode<NE> so, regardless of whether the item has a folder, so this cast should always be
-      // valid.
-      auto parentFolderNode = static_cast<TreeFolderNode<NE> *>(this->doTreeNode(newParentIndex));
-
-      int const numElementsInFolder = parentFolderNode->childCount();
-      if (!this->insertChild(newParentIndex, numElementsInFolder, element)) {
-         qWarning() << Q_FUNC_INFO << "Could not insert row" << numElementsInFolder;
-         return;
-      }
+      bool folderIsNewlyCreated = false;
+      this->findFolder(folderPath, this->m_rootNode.get(), IfNotFound::Create, &folderIsNewlyCreated);
 
-      // If we have brewnotes, set them up here.
-      this->addSubTreeIfNeeded(*element, *elementNode);
+      //
+      // This puts the element in its new folder (or, if the folder hasn't been expanded yet, remembers to do so when it
+      // is).  If we have brewnotes etc, they get set up when the element is expanded.
+      //
+      this->insertPrimaryItem(element);
 
       if (folderIsNewlyCreated) {
-         emit this->derived().expandFolder(newParentIndex);
+         emit this->derived().expandFolder(
+            this->findFolder(folderPath, this->m_rootNode.get(), IfNotFound::ReturnInvalid)
+         );
       }
 
       return;
@@ -1482,6 +1763,28 @@ protected:
    //================================================ Member Variables =================================================
    std::unique_ptr<TreeFolderNode<NE>> m_rootNode;
 
+   //! \brief Cache of \c doData results.  Off unless \c setCellCacheEnabled is called.
+   CellDataCache m_cellDataCache;
+
+   //! \brief Primary item nodes whose sub-trees have not yet been built.  See \c insertPrimaryItem.
+   QSet<TreeNode const *> m_unfetchedSubTrees;
+
+   //! \brief Items we have not yet added to the tree, grouped by the (unexpanded) folder they belong in
+   QHash<TreeFolderNode<NE> const *, QList<std::shared_ptr<NE>>> m_unfetchedFolderItems;
+
+   //! \brief Reverse lookup for \c m_unfetchedFolderItems
+   QHash<NE const *, TreeFolderNode<NE> *> m_unfetchedItemFolders;
+
+   /**
+    * \brief Indexes of the nodes currently in the tree, so that \c findElement and \c findFolder do not have to walk
+    *        the tree.  These are updated in \c insertChild, \c createFolderTree and \c forgetSubTree.
+    *
+    *        Folders are indexed by full path (eg "/Stouts/Imperial").
+    */
+   QMultiHash<NE const *, TreeNode *> m_primaryNodeIndex;
+   QMultiHash<SNE const *, TreeNode *> m_secondaryNodeIndex;
+   QHash<QString, TreeFolderNode<NE> *> m_folderNodeIndex;
+
 };
 
 //
@@ -1529,6 +1832,9 @@ protected:
                                   Qt::Orientation orientation,                              \
                                   int role = Qt::DisplayRole) const override;               \
       virtual int rowCount(QModelIndex const & parent = QModelIndex()) const override;      \
+      virtual bool hasChildren(QModelIndex const & parent = QModelIndex()) const override;  \
+      virtual bool canFetchMore(QModelIndex const & parent) const override;                 \
+      virtual void fetchMore(QModelIndex const & parent) override;                          \
       virtual int columnCount(QModelIndex const & index = QModelIndex()) const override;    \
       virtual QModelIndex index(int row,                                                    \
                                 int column,                                                 \
@@ -1595,6 +1901,13 @@ protected:
       return this->doHeaderData(section, orientation, role);                                              \
    }                                                                                                      \
    int NeName##TreeModel::rowCount(QModelIndex const & parent) const { return this->doRowCount(parent); } \
+   bool NeName##TreeModel::hasChildren(QModelIndex const & parent) const {                                \
+      return this->doHasChildren(parent);                                                                 \
+   }                                                                                                      \
+   bool NeName##TreeModel::canFetchMore(QModelIndex const & parent) const {                               \
+      return this->doCanFetchMore(parent);                                                                \
+   }                                                                                                      \
+   void NeName##TreeModel::fetchMore(QModelIndex const & parent) { this->doFetchMore(parent); return; }   \
    int NeName##TreeModel::columnCount(QModelIndex const & parent) const {                                 \
       return this->doColumnCount(parent);                                                                 \
    }                                                                                                      \
@@ -17,6 +17,8 @@
 
 #include <QDebug>
 
+#include "Logging.h"
+
 TreeModelChangeGuard::TreeModelChangeGuard(TreeModelChangeType const changeType,
                                            TreeModel & model,
                                            QModelIndex const & parent,
@@ -26,7 +28,7 @@ TreeModelChangeGuard::TreeModelChangeGuard(TreeModelChangeType const changeType,
    m_model{model} {
    Q_ASSERT(first <= last);
    // Normally leave this debug statement commented out as otherwise it generates too much logging
-//   qDebug() <<
+//   qCDebug(logTrees) <<
 //      Q_FUNC_INFO << "Prepare to" << this->m_changeType << ":" << first << "-" << last << "for parent" << parent;
    switch (this->m_changeType) {
       case TreeModelChangeType::InsertRows  : emit this->m_model.beginInsertRows(parent, first, last); break;
@@ -39,7 +41,7 @@ TreeModelChangeGuard::TreeModelChangeGuard(TreeModelChangeType const changeType,
 
 TreeModelChangeGuard::~TreeModelChangeGuard() {
    // Normally leave this debug statement commented out as otherwise it generates too much logging
-//   qDebug() << Q_FUNC_INFO << "End of" << this->m_changeType;
+//   qCDebug(logTrees) << Q_FUNC_INFO << "End of" << this->m_changeType;
    switch (this->m_changeType) {
       case TreeModelChangeType::InsertRows  : emit this->m_model.endInsertRows(); break;
       case TreeModelChangeType::RemoveRows  : emit this->m_model.endRemoveRows(); break;
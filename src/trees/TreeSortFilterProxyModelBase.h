@@ -19,7 +19,10 @@
 
 #include <QModelIndex>
 #include <QSortFilterProxyModel>
+#include <QString>
 
+#include "database/SearchIndex.h"
+#include "qtModels/sortFilterProxyModels/SearchFilter.h"
 #include "trees/TreeModel.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 
@@ -34,6 +37,17 @@ template<class Derived, class NeTreeModel, class NE, typename SNE = void>
 class TreeSortFilterProxyModelBase : public CuriouslyRecurringTemplateBase<TreeSortFilterProxyModelPhantom, Derived> {
    friend Derived;
 
+public:
+   /**
+    * \brief Only show items for objects matching \c searchText in \c searchIndex (see
+    *        \c SearchIndex::matchingKeys), and the folders that contain them.  Blank \c searchText shows everything
+    *        again.  See \c SearchFilter for more details.
+    */
+   void setSearch(SearchIndex const & searchIndex, QString const & searchText) {
+      this->m_searchFilter.setSearch(searchIndex, searchText);
+      return;
+   }
+
 protected:
 
    /**
@@ -122,6 +136,23 @@ protected:
          return false;
       }
 
+      if (this->m_searchFilter.isActive()) {
+         TreeNode * itemNode = treeModel->doTreeNode(child);
+         if (itemNode->classifier() == TreeNodeClassifier::Folder) {
+            // Otherwise the user would have to open every folder to find out which ones had anything in them.  Note
+            // that this includes items that the tree model hasn't yet fetched into the folder.
+            return treeModel->folderContainsItem(child, [this](NamedEntity const & item) {
+               return !item.deleted() && this->m_searchFilter.matches(item.key());
+            });
+         }
+         if (itemNode->classifier() == TreeNodeClassifier::PrimaryItem) {
+            NamedEntity * item = itemNode->rawUnderlyingItem();
+            if (item && !this->m_searchFilter.matches(item->key())) {
+               return false;
+            }
+         }
+      }
+
       TreeNode * childNode = treeModel->doTreeNode(parent);
       if (childNode->classifier() == TreeNodeClassifier::Folder) {
          return true;
@@ -143,6 +174,9 @@ protected:
 
       return true;
    }
+
+private:
+   SearchFilter m_searchFilter{[this]() { this->derived().invalidateFilter(); }};
 };
 
 /**
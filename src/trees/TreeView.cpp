@@ -25,6 +25,7 @@
 #include <QDrag>
 #include <QMimeData>
 
+#include "Logging.h"
 #include "MainWindow.h"
 #include "trees/TreeModel.h"
 
@@ -137,7 +138,7 @@ void TreeView::keyPressEvent(QKeyEvent * event) {
 }
 
 void TreeView::rowsInserted(QModelIndex const & parent, int start, int end) {
-   qDebug() << Q_FUNC_INFO << "Rows" << start << "-" << end << "added to" << parent;
+   qCDebug(logTrees) << Q_FUNC_INFO << "Rows" << start << "-" << end << "added to" << parent;
    this->QTreeView::rowsInserted(parent, start, end);
    return;
 }
@@ -83,6 +83,12 @@ public:
 
    virtual QString folderName(QModelIndex const & viewIndex) const = 0;
 
+   /**
+    * \brief Only show items matching \c searchText (in name, notes, etc -- see \c SearchIndex).  Blank \c searchText
+    *        shows everything.
+    */
+   virtual void filterItems(QString const & searchText) = 0;
+
 public:
    //! \return the classifier of the item at \c index, or \c nullopt if \c index is invalid
    std::optional<TreeNodeClassifier> classifier(QModelIndex const & index) const;
@@ -30,6 +30,8 @@
 #include <QString>
 #include <QWidget>
 
+#include "database/SearchIndex.h"
+#include "Logging.h"
 #include "utils/CuriouslyRecurringTemplateBase.h"
 #include "trees/NamedEntityTreeSortFilterProxyModel.h"
 
@@ -71,6 +73,7 @@ private:
    TreeViewBase() :
       m_model          {nullptr},
       m_treeSortFilterProxy{nullptr} {
+      this->m_model.setCellCacheEnabled(true);
       this->m_treeSortFilterProxy.setSourceModel(&this->m_model);
       this->m_treeSortFilterProxy.setDynamicSortFilter(true);
       this->m_treeSortFilterProxy.setFilterKeyColumn(1);
@@ -141,7 +144,7 @@ protected:
 
       if (node->classifier() == TreeNodeClassifier::Folder) {
          // default behavior is fine, but no warning
-         qDebug() << Q_FUNC_INFO << "Folder";
+         qCDebug(logTrees) << Q_FUNC_INFO << "Folder";
          return;
       }
 
@@ -217,7 +220,7 @@ public:
       }
       QModelIndex const modelIndex = this->m_treeSortFilterProxy.mapToSource(viewIndex);
       if (modelIndex.isValid()) {
-         qDebug() << Q_FUNC_INFO << "modelIndex:" << modelIndex;
+         qCDebug(logTrees) << Q_FUNC_INFO << "modelIndex:" << modelIndex;
          return this->m_treeSortFilterProxy.mapFromSource(this->m_model.parent(modelIndex));
       }
 
@@ -229,7 +232,7 @@ public:
    }
 
    QModelIndex findElement(NE const * ne) {
-      qDebug() << Q_FUNC_INFO << *ne;
+      qCDebug(logTrees) << Q_FUNC_INFO << *ne;
       return this->m_treeSortFilterProxy.mapFromSource(this->m_model.findElement(ne));
    }
 
@@ -237,7 +240,7 @@ public:
    // See comment on TreeModelBase::findElement for why we cannot just use `SNE const &` as the parameter type
    //
    QModelIndex findElement(SNE const * sne) requires (!IsVoid<SNE>) {
-      qDebug() << Q_FUNC_INFO << *sne;
+      qCDebug(logTrees) << Q_FUNC_INFO << *sne;
       return this->m_treeSortFilterProxy.mapFromSource(this->m_model.findElement(sne));
    }
 
@@ -271,7 +274,7 @@ public:
       if (!viewIndex.isValid()) {
          return;
       }
-      qDebug() << Q_FUNC_INFO << "New selected index:" << viewIndex;
+      qCDebug(logTrees) << Q_FUNC_INFO << "New selected index:" << viewIndex;
       this->derived().selectionModel()->select(viewIndex, QItemSelectionModel::Select);
       TreeNode * treeNode = this->doTreeNode(viewIndex);
       QModelIndex parentIndex = this->parentIndex(viewIndex);
@@ -441,6 +444,11 @@ public:
       return this->indexOfNode(newSelectedTreeNode);
    }
 
+   void doFilterItems(QString const & searchText) {
+      this->m_treeSortFilterProxy.setSearch(SearchIndex::instance<NE>(), searchText);
+      return;
+   }
+
    void doCopySelected() {
       QModelIndexList selected = this->derived().selectionModel()->selectedRows();
       this->doCopy(selected);
@@ -451,11 +459,11 @@ public:
       QModelIndexList selected = this->derived().selectionModel()->selectedRows();
 
       QModelIndex start = selected.first();
-      qDebug() << Q_FUNC_INFO << "Delete starting from row" << start.row();
+      qCDebug(logTrees) << Q_FUNC_INFO << "Delete starting from row" << start.row();
       std::optional<QModelIndex> newSelected = this->doDeleteItems(selected);
       if (newSelected && newSelected->isValid()) {
          TreeNode * node = this->doTreeNode(*newSelected);
-         qDebug() << Q_FUNC_INFO << "Row" << newSelected->row() << "(" << *newSelected << ") is" << *node;
+         qCDebug(logTrees) << Q_FUNC_INFO << "Row" << newSelected->row() << "(" << *newSelected << ") is" << *node;
          this->doSetSelected(*newSelected);
       }
 
@@ -579,7 +587,7 @@ public:
       }
 
       if (index.isValid()) {
-         qDebug() << Q_FUNC_INFO << "index:" << index;
+         qCDebug(logTrees) << Q_FUNC_INFO << "index:" << index;
          QModelIndex const translatedIndex{this->m_treeSortFilterProxy.mapFromSource(index)};
          if (translatedIndex.isValid() && !this->derived().isExpanded(translatedIndex)) {
             this->derived().expand(translatedIndex);
@@ -682,6 +690,7 @@ using RecipeEditor = MainWindow;
       virtual void renameSelected() override;                                         \
       virtual void addFolder(QString const & folder) override;                        \
       virtual QString folderName(QModelIndex const & viewIndex) const override;       \
+      virtual void filterItems(QString const & searchText) override;                  \
                                                                                       \
    public slots:                                                                      \
       virtual void activated(QModelIndex const & viewIndex) override;                 \
@@ -740,6 +749,10 @@ using RecipeEditor = MainWindow;
       }                                                                              \
    QString NeName##TreeView::folderName(QModelIndex const & viewIndex) const {       \
       return this->doFolderName(viewIndex);                                          \
+   }                                                                                 \
+   void NeName##TreeView::filterItems(QString const & searchText) {                  \
+      this->doFilterItems(searchText);                                               \
+      return;                                                                        \
    }                                                                                 \
                                                                                      \
    void NeName##TreeView::activated(QModelIndex const & viewIndex) {                 \
@@ -0,0 +1,996 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/Benchmarks.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "unitTests/Benchmarks.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <QApplication>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QMimeData>
+#include <QRandomGenerator>
+#include <QScopeGuard>
+#include <QSettings>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QString>
+#include <QTableView>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QThread>
+#include <QtTest/QtTest>
+
+#include "Algorithms.h"
+#include "Application.h"
+#include "config.h"
+#include "database/Database.h"
+#include "database/DbMaintenance.h"
+#include "database/DbTransaction.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "database/SearchIndex.h"
+#include "database/StartupSnapshot.h"
+#include "database/SyntheticDataGenerator.h"
+#include "Logging.h"
+#include "MainWindow.h"
+#include "measurement/IbuMethods.h"
+#include "measurement/Unit.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/NamedParameterBundle.h"
+#include "model/Recipe.h"
+#include "model/RecipeAdditionFermentable.h"
+#include "model/RecipeAdditionHop.h"
+#include "PersistentSettings.h"
+#include "qtModels/sortFilterProxyModels/HopSortFilterProxyModel.h"
+#include "qtModels/tableModels/HopTableModel.h"
+#include "serialization/ImportExport.h"
+#include "trees/NamedEntityTreeModel.h"
+#include "utils/MetaTypes.h"
+
+namespace {
+   //! \brief How many hops we put in the database before we start
+   int const numInitialHops = 500;
+
+   //! \brief How many objects we insert or update in each run of the ObjectStore benchmarks
+   int const numObjectsPerRun = 100;
+
+   //! \brief How many hop additions (or gravities) we do calculations for in each run of the IbuMethods (and SG to Brix)
+   //!        benchmarks
+   std::size_t const numIbuCalculations = 10000;
+
+   //! \brief How many rows we load (or pretend to load) in each run of the loadAll and NamedParameterBundle benchmarks
+   int const numRowsPerLoad = 10000;
+
+   //! \brief Roughly a hop table row's worth of properties, for the NamedParameterBundle benchmarks
+   std::vector<BtStringConst const *> const hopRowPropertyNames {
+      &PropertyNames::NamedEntity::name , &PropertyNames::Hop::alpha_pct   , &PropertyNames::Hop::beta_pct    ,
+      &PropertyNames::Hop::form         , &PropertyNames::Hop::type        , &PropertyNames::Hop::notes       ,
+      &PropertyNames::Hop::origin       , &PropertyNames::Hop::producer    , &PropertyNames::Hop::productId   ,
+      &PropertyNames::Hop::substitutes  , &PropertyNames::Hop::year        , &PropertyNames::Hop::hsi_pct     ,
+      &PropertyNames::Hop::humulene_pct , &PropertyNames::Hop::myrcene_pct , &PropertyNames::Hop::totalOil_mlPer100g,
+   };
+
+   /**
+    * \brief Fill \c bundle as \c ObjectStore::loadAll would for one row, then read everything back as a constructor
+    *        would.  Returns something derived from the values so the compiler can't optimise the reads away.
+    */
+   double fillAndReadBundle(NamedParameterBundle & bundle, int const row, bool const byOrdinal) {
+      for (int ordinal = 0; ordinal < static_cast<int>(hopRowPropertyNames.size()); ++ordinal) {
+         QVariant value{static_cast<double>(row + ordinal)};
+         if (byOrdinal) {
+            bundle.insert(ordinal, std::move(value));
+         } else {
+            bundle.insert(*hopRowPropertyNames[ordinal], value);
+         }
+      }
+      double total = 0.0;
+      for (auto const propertyName : hopRowPropertyNames) {
+         total += bundle.val<double>(*propertyName);
+      }
+      // Constructors also ask for things that aren't there, to get default values
+      total += bundle.val<double>(PropertyNames::Hop::xanthohumol_pct, 0.0);
+      return total;
+   }
+}
+
+class Benchmarks::impl {
+public:
+   impl(QString const & resultsFile) :
+      m_tempDir{QDir::tempPath()},
+      m_resultsFile{resultsFile},
+      m_results{},
+      m_hops{},
+      m_recipe{},
+      m_numInsertedHops{0} {
+      return;
+   }
+
+   /**
+    * \brief What we record about each benchmark for the JSON output
+    */
+   struct Result {
+      QString name;
+      qint64  runs;
+      qint64  operationsPerRun;
+      qint64  elapsed_ns;
+   };
+
+   /**
+    * \brief Run \c operation under \c QBENCHMARK, and record how long it took on average.  (QtTest reports its own
+    *        timings, but not in a format we can easily compare between builds.)
+    *
+    *        NB: QtTest only allows one \c QBENCHMARK per test function, so each benchmark slot should only call this
+    *            once.
+    *
+    * \param name What to call this benchmark in the JSON output
+    * \param operationsPerRun How many "things" (objects inserted, strings parsed, etc) each call to \c operation does
+    * \param operation
+    */
+   template<typename Functor>
+   void measure(QString const & name, qint64 const operationsPerRun, Functor operation) {
+      qint64 runs = 0;
+      QElapsedTimer timer;
+      timer.start();
+      QBENCHMARK {
+         operation();
+         ++runs;
+      }
+      this->record(name, runs, operationsPerRun, timer.nsecsElapsed());
+      return;
+   }
+
+   /**
+    * \brief As \c measure, but for things that can only be done once per run (eg because they create a singleton), so
+    *        uses \c QBENCHMARK_ONCE.
+    */
+   template<typename Functor>
+   void measureOnce(QString const & name, Functor operation) {
+      qint64 runs = 0;
+      QElapsedTimer timer;
+      timer.start();
+      QBENCHMARK_ONCE {
+         operation();
+         ++runs;
+      }
+      this->record(name, runs, 1, timer.nsecsElapsed());
+      return;
+   }
+
+   /**
+    * \brief Add a timing to \c m_results, and log it
+    */
+   void record(QString const & name, qint64 const runs, qint64 const operationsPerRun, qint64 const nsecsElapsed) {
+      qint64 const elapsed_ns = std::max<qint64>(1, nsecsElapsed);
+      this->m_results.push_back(Result{name, runs, operationsPerRun, elapsed_ns});
+      qInfo().noquote() <<
+         Q_FUNC_INFO << name << ":" << runs << "runs of" << operationsPerRun << "operations in" << elapsed_ns <<
+         "ns (" << (runs * operationsPerRun * 1000000000 / elapsed_ns) << "operations per second)";
+      return;
+   }
+
+   /**
+    * \brief Write \c m_results to \c m_resultsFile
+    */
+   bool writeResults() const {
+      boost::json::array results;
+      for (auto const & result : this->m_results) {
+         qint64 const numOperations = result.runs * result.operationsPerRun;
+         results.emplace_back(boost::json::object{
+            {"name"                   , result.name.toStdString()},
+            {"runs"                   , result.runs},
+            {"operationsPerRun"       , result.operationsPerRun},
+            {"totalNanoseconds"       , result.elapsed_ns},
+            {"nanosecondsPerOperation", static_cast<double>(result.elapsed_ns) / numOperations},
+            {"operationsPerSecond"    , static_cast<double>(numOperations) * 1.0e9 / result.elapsed_ns},
+         });
+      }
+      boost::json::object const output{
+         {"application", CONFIG_APPLICATION_NAME_LC},
+         {"version"    , CONFIG_VERSION_STRING},
+         {"qtVersion"  , qVersion()},
+         {"timestamp"  , QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toStdString()},
+         {"results"    , results},
+      };
+
+      QFile file{this->m_resultsFile};
+      if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+         qCritical() << Q_FUNC_INFO << "Unable to open" << this->m_resultsFile << "for writing:" << file.errorString();
+         return false;
+      }
+      file.write(QByteArray::fromStdString(boost::json::serialize(output)));
+      file.write("\n");
+      qInfo() << Q_FUNC_INFO << "Wrote" << this->m_results.size() << "results to" << this->m_resultsFile;
+      return true;
+   }
+
+   std::shared_ptr<Hop> makeHop(QString const & name, double const alpha_pct) {
+      auto hop = std::make_shared<Hop>(name);
+      hop->setAlpha_pct(alpha_pct);
+      hop->setType(Hop::Type::AromaAndBittering);
+      hop->setForm(Hop::Form::Pellet);
+      ObjectStoreWrapper::insert(hop);
+      return hop;
+   }
+
+   /**
+    * \brief Import \c fileName (as a benchmark, so no checking of the results beyond success/failure)
+    */
+   static bool importFile(QString const & fileName) {
+      QString userMessage;
+      QTextStream userMessageAsStream{&userMessage};
+      bool const succeeded = ImportExport::importFromFile(fileName, userMessageAsStream);
+      if (!succeeded) {
+         qWarning() << Q_FUNC_INFO << "Importing" << fileName << "failed:" << userMessage;
+      }
+      return succeeded;
+   }
+
+   /**
+    * \brief Export \c m_recipe to \c fileName, the extension of which determines whether it's BeerXML or BeerJSON
+    */
+   bool exportRecipe(QString const & fileName) const {
+      QList<Recipe const *> const recipes{this->m_recipe.get()};
+      QString userMessage;
+      QTextStream userMessageAsStream{&userMessage};
+      bool const succeeded = ImportExport::exportToNamedFile(fileName, userMessageAsStream, &recipes);
+      if (!succeeded) {
+         qWarning() << Q_FUNC_INFO << "Exporting to" << fileName << "failed:" << userMessage;
+      }
+      return succeeded;
+   }
+
+   //================================================ MEMBER VARIABLES =================================================
+
+   //! \brief Where we write the database, log files and any import/export files.  See comment in Testing.cpp.
+   QDir m_tempDir;
+
+   QString m_resultsFile;
+
+   std::vector<Result> m_results;
+
+   std::vector<std::shared_ptr<Hop>> m_hops;
+
+   std::shared_ptr<Recipe> m_recipe;
+
+   //! \brief Used to give unique names to the hops we insert
+   int m_numInsertedHops;
+};
+
+Benchmarks::Benchmarks(QString const & resultsFile) :
+   QObject(),
+   pimpl{std::make_unique<impl>(resultsFile)} {
+
+   registerMetaTypes();
+
+   //
+   // As in Testing, we use a unique temporary directory, so that we're not touching any real data and so that we don't
+   // clash with unit tests that might be running at the same time.
+   //
+   std::ostringstream buffer;
+   buffer << QRandomGenerator::securelySeeded().generate();
+   QString subDirName;
+   QTextStream{&subDirName} << CONFIG_APPLICATION_NAME_UC << "-BenchmarkRun-" << QString::fromStdString(buffer.str());
+   if (!this->pimpl->m_tempDir.mkdir(subDirName) || !this->pimpl->m_tempDir.cd(subDirName)) {
+      qCritical() <<
+         Q_FUNC_INFO << "Unable to create" << subDirName << "sub-directory of" << this->pimpl->m_tempDir.absolutePath();
+      throw std::runtime_error{"Unable to create unique temp directory"};
+   }
+   return;
+}
+
+Benchmarks::~Benchmarks() {
+   // See comment in Testing::~Testing
+   if (this->pimpl->m_tempDir.exists() &&
+       this->pimpl->m_tempDir.absolutePath() != QDir::tempPath() &&
+       !this->pimpl->m_tempDir.isRoot()) {
+      if (!this->pimpl->m_tempDir.removeRecursively()) {
+         qWarning() <<
+            Q_FUNC_INFO << "Unable to remove temporary directory" << this->pimpl->m_tempDir.absolutePath();
+      }
+   }
+   return;
+}
+
+//
+// We can't use QTEST_MAIN here because we want to take our own command line option for where to write the JSON results,
+// which we need to remove before QtTest sees the arguments (otherwise it will complain about an unknown option).
+//
+//    ${PROJECT_NAME}_benchmarks [-json <file>] [QtTest options] [benchmark names]
+//
+int main(int argc, char * argv[]) {
+   // Benchmarks need to be able to run on build machines without a display
+   if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+      qputenv("QT_QPA_PLATFORM", "offscreen");
+   }
+   QApplication app{argc, argv};
+
+   QStringList arguments = app.arguments();
+   QString resultsFile{"benchmarks.json"};
+   qsizetype const jsonOptionIndex = arguments.indexOf("-json");
+   if (jsonOptionIndex > 0) {
+      if (jsonOptionIndex + 1 >= arguments.size()) {
+         std::cerr << "-json option needs a file name" << std::endl;
+         return 1;
+      }
+      resultsFile = QFileInfo{arguments.at(jsonOptionIndex + 1)}.absoluteFilePath();
+      arguments.remove(jsonOptionIndex, 2);
+   } else {
+      resultsFile = QFileInfo{resultsFile}.absoluteFilePath();
+   }
+
+   Benchmarks benchmarks{resultsFile};
+   return QTest::qExec(&benchmarks, arguments);
+}
+
+void Benchmarks::initTestCase() {
+   try {
+      xercesc::XMLPlatformUtils::Initialize();
+   } catch (xercesc::XMLException const & xercesInitException) {
+      qCritical() << Q_FUNC_INFO << "Xerces XML Parser Initialisation Failed: " << xercesInitException.getMessage();
+      QFAIL("Xerces XML Parser Initialisation Failed");
+   }
+
+   try {
+      // As in Testing::initTestCase, use different options so as not to clobber real ones
+      static QString const benchmarkDomain = QString{"%1/benchmark"}.arg(CONFIG_ORGANIZATION_DOMAIN);
+      QCoreApplication::setOrganizationDomain(benchmarkDomain);
+      static QString const benchmarkAppName = QString{"%1-benchmark"}.arg(CONFIG_APPLICATION_NAME_LC);
+      QCoreApplication::setApplicationName(benchmarkAppName);
+
+      PersistentSettings::initialise(this->pimpl->m_tempDir.absolutePath());
+      Logging::initializeLogging();
+      Logging::setDirectory(QDir{this->pimpl->m_tempDir.absolutePath()}, Logging::NewDirectoryIsTemporary);
+      //
+      // Unlike the unit tests, we don't want debug logging, as otherwise that is mostly what we'd be timing.  (There is
+      // a separate benchmark, benchmarkRecipeRecalcAllDebugLogging, that looks at the overhead of debug logging.)
+      //
+      Logging::setLogLevel(Logging::LogLevel_INFO);
+
+      PersistentSettings::insert(PersistentSettings::Names::color_formula, "morey"  );
+      PersistentSettings::insert(PersistentSettings::Names::ibu_formula  , "tinseth");
+
+      //
+      // This creates the database in this->pimpl->m_tempDir.  NB: It's an on-disk SQLite database rather than an
+      // in-memory one, because Database opens a separate connection per thread, and each connection to ":memory:"
+      // would get its own, empty, database.  (We have synchronous writes turned off for SQLite, so this is not so
+      // different in practice.)
+      //
+      Application::setInteractive(false);
+      QVERIFY(Application::initialize());
+
+      //
+      // Everything is benchmarked against the same reproducible synthetic data set (on top of the default content).
+      // This is deliberately a lot smaller than SyntheticDataGenerator's defaults so that the benchmarks don't take too
+      // long to set up.
+      //
+      SyntheticDataGenerator::Parameters dataSetParameters;
+      dataSetParameters.seed           = 42;
+      dataSetParameters.numIngredients = 2000;
+      dataSetParameters.numRecipes     = 200;
+      QString generatorMessage;
+      QTextStream generatorMessageAsStream{&generatorMessage};
+      QVERIFY2(SyntheticDataGenerator::generate(dataSetParameters, generatorMessageAsStream),
+               qPrintable(generatorMessage));
+
+      for (int ii = 0; ii < numInitialHops; ++ii) {
+         this->pimpl->m_hops.push_back(
+            this->pimpl->makeHop(QString{"Benchmark Hop %1"}.arg(ii), 2.0 + static_cast<double>(ii % 160) / 10.0)
+         );
+      }
+
+      auto equipment = std::make_shared<Equipment>("Benchmark Equipment");
+      equipment->setKettleBoilSize_l(24.0);
+      equipment->setFermenterBatchSize_l(20.0);
+      equipment->setMashTunVolume_l(40.0);
+      equipment->setKettleEvaporationPerHour_l(4.0);
+      equipment->setBoilTime_min(60);
+      equipment->setMashTunGrainAbsorption_LKg(1.0);
+      equipment->setBoilingPoint_c(100);
+      ObjectStoreWrapper::insert(equipment);
+
+      auto twoRow = std::make_shared<Fermentable>("Benchmark Two Row");
+      twoRow->setType(Fermentable::Type::Grain);
+      twoRow->setFineGrindYield_pct(70.0);
+      twoRow->setColor_srm(2.0);
+      ObjectStoreWrapper::insert(twoRow);
+
+      this->pimpl->m_recipe = std::make_shared<Recipe>("Benchmark Recipe");
+      ObjectStoreWrapper::insert(this->pimpl->m_recipe);
+      this->pimpl->m_recipe->setEquipment(equipment);
+      this->pimpl->m_recipe->setBatchSize_l(equipment->fermenterBatchSize_l());
+
+      auto fermentableAddition = std::make_shared<RecipeAdditionFermentable>("Benchmark Grain Addition");
+      fermentableAddition->setFermentable(twoRow.get());
+      fermentableAddition->setStage(RecipeAddition::Stage::Mash);
+      fermentableAddition->setQuantity(5.0);
+      fermentableAddition->setMeasure(Measurement::PhysicalQuantity::Mass);
+      this->pimpl->m_recipe->addAddition(fermentableAddition);
+
+      // A typical recipe has a bittering, a flavour and an aroma addition
+      for (int const time_mins : {60, 15, 5}) {
+         auto hopAddition = std::make_shared<RecipeAdditionHop>(QString{"Benchmark Hop Addition %1"}.arg(time_mins));
+         hopAddition->setHop(this->pimpl->m_hops.at(time_mins).get());
+         hopAddition->setStage(RecipeAddition::Stage::Boil);
+         hopAddition->setAddAtTime_mins(time_mins);
+         hopAddition->setQuantity(0.025);
+         hopAddition->setMeasure(Measurement::PhysicalQuantity::Mass);
+         this->pimpl->m_recipe->addAddition(hopAddition);
+      }
+   } catch (std::exception const & e) {
+      // See comment in Testing::initTestCase
+      std::cerr << "Caught exception: " << e.what() << std::endl;
+      throw;
+   }
+
+   return;
+}
+
+void Benchmarks::cleanupTestCase() {
+   bool const wroteResults = this->pimpl->writeResults();
+
+   // Let go of our objects before the object stores are torn down
+   this->pimpl->m_recipe.reset();
+   this->pimpl->m_hops.clear();
+
+   Application::cleanup();
+   Logging::terminateLogging();
+   QSettings().clear();
+   xercesc::XMLPlatformUtils::Terminate();
+
+   QVERIFY(wroteResults);
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreInsert() {
+   this->pimpl->measure("ObjectStore::insert", numObjectsPerRun, [this]() {
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         this->pimpl->makeHop(QString{"Inserted Hop %1"}.arg(this->pimpl->m_numInsertedHops++), 5.0);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreInsertUnitOfWork() {
+   this->pimpl->measure("ObjectStore::insert in DbUnitOfWork", numObjectsPerRun, [this]() {
+      DbUnitOfWork unitOfWork{"Benchmark insert"};
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         this->pimpl->makeHop(QString{"Inserted Hop %1"}.arg(this->pimpl->m_numInsertedHops++), 5.0);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreUpdateProperty() {
+   //
+   // Normally updateProperty gets called as a side-effect of calling a setter (eg Hop::setAlpha_pct), but we want to
+   // time just the DB write, so we call it directly.  It doesn't matter that the value hasn't changed.
+   //
+   this->pimpl->measure("ObjectStore::updateProperty", numObjectsPerRun, [this]() {
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         ObjectStoreWrapper::updateProperty(*this->pimpl->m_hops.at(ii), PropertyNames::Hop::alpha_pct);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreUpdatePropertyUnitOfWork() {
+   this->pimpl->measure("ObjectStore::updateProperty in DbUnitOfWork", numObjectsPerRun, [this]() {
+      DbUnitOfWork unitOfWork{"Benchmark update"};
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         ObjectStoreWrapper::updateProperty(*this->pimpl->m_hops.at(ii), PropertyNames::Hop::alpha_pct);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreHardDelete() {
+   //
+   // We need something to delete each time round, so this also includes the time to insert the hops.  Subtract the
+   // result of benchmarkObjectStoreInsert to get the time for the deletes on their own.
+   //
+   this->pimpl->measure("ObjectStore::insert + hardDelete", numObjectsPerRun, [this]() {
+      std::vector<std::shared_ptr<Hop>> hops;
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         hops.push_back(this->pimpl->makeHop(QString{"Deleted Hop %1"}.arg(ii), 5.0));
+      }
+      for (auto const & hop : hops) {
+         ObjectStoreWrapper::hardDelete(hop);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreHardDeleteWithoutIndexes() {
+   //
+   // The benchmarks run on SQLite, which keeps the statement that created each index, so we can put them back exactly
+   // as they were afterwards.  All the indexes we create (see ObjectStore::TableDefinition::indexedColumns and
+   // migrate_to_19) have names ending "_idx".
+   //
+   QSqlDatabase connection = Database::instance().sqlDatabase();
+   QStringList indexNames;
+   QStringList indexCreations;
+   {
+      QSqlQuery query{connection};
+      QVERIFY2(query.exec("SELECT name, sql FROM sqlite_master WHERE type = 'index' AND name LIKE '%\\_idx' ESCAPE '\\'"),
+               qPrintable(query.lastError().text()));
+      while (query.next()) {
+         indexNames.append(query.value(0).toString());
+         indexCreations.append(query.value(1).toString());
+      }
+   }
+   QVERIFY(!indexNames.isEmpty());
+   auto const restoreIndexes = qScopeGuard([&connection, &indexCreations]() {
+      for (auto const & indexCreation : indexCreations) {
+         QSqlQuery query{connection};
+         if (!query.exec(indexCreation)) {
+            qCritical() << Q_FUNC_INFO << "Unable to recreate index:" << indexCreation << query.lastError().text();
+         }
+      }
+      return;
+   });
+   for (auto const & indexName : indexNames) {
+      QSqlQuery query{connection};
+      QVERIFY2(query.exec(QString{"DROP INDEX %1"}.arg(indexName)), qPrintable(query.lastError().text()));
+   }
+   qInfo() << Q_FUNC_INFO << "Dropped" << indexNames.size() << "indexes";
+
+   // Same as benchmarkObjectStoreHardDelete
+   this->pimpl->measure("ObjectStore::insert + hardDelete (no indexes)", numObjectsPerRun, [this]() {
+      std::vector<std::shared_ptr<Hop>> hops;
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         hops.push_back(this->pimpl->makeHop(QString{"Deleted Hop %1"}.arg(ii), 5.0));
+      }
+      for (auto const & hop : hops) {
+         ObjectStoreWrapper::hardDelete(hop);
+      }
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreLoadAll() {
+   qint64 const numHopsInDb = static_cast<qint64>(ObjectStoreTyped<Hop>::getInstance().size());
+   this->pimpl->measure("ObjectStore::loadAll", numHopsInDb, []() {
+      auto objectStore = ObjectStoreTyped<Hop>::createDetachedInstance();
+      objectStore->loadAll();
+   });
+   return;
+}
+
+void Benchmarks::benchmarkDbMaintenanceCycle() {
+   //
+   // In the program, a cycle is spread over many small steps in idle time, but what we want to know here is how much
+   // work it is in total (which DbMaintenance also logs).  A cycle purges everything it can, so there is only one
+   // cycle's worth of purging to time per run.
+   //
+   {
+      DbUnitOfWork unitOfWork{"Benchmark soft delete hops"};
+      for (int ii = 0; ii < numObjectsPerRun; ++ii) {
+         auto hop = this->pimpl->makeHop(QString{"Purged Hop %1"}.arg(ii), 5.0);
+         ObjectStoreWrapper::softDelete(*hop);
+      }
+   }
+   DbMaintenance::Report report;
+   this->pimpl->measureOnce("DbMaintenance::runCycle", [&report]() {
+      report = DbMaintenance::instance().runCycle();
+   });
+   QVERIFY(report.numPurged >= numObjectsPerRun);
+   qInfo() <<
+      Q_FUNC_INFO << "Purged" << report.numPurged << "objects in" << report.numSteps << "steps.  DB size" <<
+      report.bytesBefore << "->" << report.bytesAfter << "bytes";
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreLoadFromSnapshot10kRows() {
+   QTemporaryFile snapshotFile;
+   QVERIFY(snapshotFile.open());
+   {
+      QDataStream out{&snapshotFile};
+      out.setVersion(StartupSnapshot::dataStreamVersion);
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      QVERIFY(ObjectStoreTyped<Hop>::getInstance().writeSnapshot(connection, out));
+   }
+   QVERIFY(snapshotFile.flush());
+   qint64 const snapshotSize = snapshotFile.size();
+   QString const snapshotFilePath = snapshotFile.fileName();
+
+   // So that this compares like with like with loading from the DB, we include mapping the file, as
+   // StartupSnapshot::open does.  (It will usually be in the OS file cache, but then so will the DB.)
+   this->pimpl->measure("ObjectStore::loadFromSnapshot (10k rows)", 1, [&snapshotFilePath, snapshotSize]() {
+      QFile file{snapshotFilePath};
+      QVERIFY(file.open(QIODevice::ReadOnly));
+      uchar * data = file.map(0, snapshotSize);
+      QVERIFY(data);
+      auto objectStore = ObjectStoreTyped<Hop>::createDetachedInstance();
+      QVERIFY(objectStore->loadFromSnapshot(
+         QByteArray::fromRawData(reinterpret_cast<char const *>(data), snapshotSize)
+      ));
+      file.unmap(data);
+   });
+   return;
+}
+
+void Benchmarks::benchmarkLoggingThroughput() {
+   // Enough threads that they will be contending with each other for the logging queue
+   int const numThreads = std::max(4, QThread::idealThreadCount());
+   int const messagesPerThread = 20000;
+
+   //
+   // Elsewhere we have debug logging turned off (see initTestCase), but here it's what we're timing.  We don't want all
+   // these messages on stderr though.
+   //
+   Logging::setLogLevel(Logging::LogLevel_DEBUG);
+   Logging::setLoggingToStderr(false);
+   auto const restoreLogging = qScopeGuard([]() {
+      Logging::setLoggingToStderr(true);
+      Logging::setLogLevel(Logging::LogLevel_INFO);
+      return;
+   });
+
+   this->pimpl->measure("Logging from several threads", numThreads * messagesPerThread, [&]() {
+      std::vector<std::thread> threads;
+      for (int threadNum = 0; threadNum < numThreads; ++threadNum) {
+         threads.emplace_back([threadNum, messagesPerThread]() {
+            for (int ii = 0; ii < messagesPerThread; ++ii) {
+               qDebug() << Q_FUNC_INFO << "Thread" << threadNum << "message" << ii;
+            }
+         });
+      }
+      for (auto & thread : threads) {
+         thread.join();
+      }
+      // The messages aren't logged until they are written out
+      Logging::flush();
+   });
+   return;
+}
+
+void Benchmarks::benchmarkRecipeRecalcAll() {
+   this->pimpl->measure("Recipe::recalcAll", 1, [this]() {
+      this->pimpl->m_recipe->recalcAll();
+   });
+   return;
+}
+
+void Benchmarks::benchmarkRecipeRecalcAllDebugLogging() {
+   // As in benchmarkLoggingThroughput, we want the debug logging, but not on stderr
+   Logging::setLogLevel(Logging::LogLevel_DEBUG);
+   Logging::setLoggingToStderr(false);
+   auto const restoreLogging = qScopeGuard([]() {
+      Logging::setLoggingToStderr(true);
+      Logging::setLogLevel(Logging::LogLevel_INFO);
+      return;
+   });
+
+   this->pimpl->measure("Recipe::recalcAll (debug logging)", 1, [this]() {
+      this->pimpl->m_recipe->recalcAll();
+      // Include the cost of writing out the log messages, not just of queueing them
+      Logging::flush();
+   });
+   return;
+}
+
+void Benchmarks::benchmarkIbuMethodsSingle() {
+   IbuMethods::formula = IbuMethods::IbuFormula::Tinseth;
+   double checksum = 0.0;
+   this->pimpl->measure("IbuMethods::getIbus (single)", numIbuCalculations, [&checksum]() {
+      for (std::size_t ii = 0; ii < numIbuCalculations; ++ii) {
+         double const fraction = static_cast<double>(ii) / numIbuCalculations;
+         checksum += IbuMethods::getIbus(IbuMethods::IbuCalculationParms{
+            0.02 + 0.16 * fraction, 5.0 + 200.0 * fraction, 20.0, 1.040 + 0.06 * fraction, static_cast<double>(ii % 91)
+         });
+      }
+   });
+   QVERIFY(checksum > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkIbuMethodsBatch() {
+   IbuMethods::formula = IbuMethods::IbuFormula::Tinseth;
+   std::vector<double> aaRatings(numIbuCalculations), hopsGrams(numIbuCalculations), volumes(numIbuCalculations),
+                       gravities(numIbuCalculations), boilTimes(numIbuCalculations), ibus(numIbuCalculations);
+   for (std::size_t ii = 0; ii < numIbuCalculations; ++ii) {
+      double const fraction = static_cast<double>(ii) / numIbuCalculations;
+      aaRatings[ii] = 0.02 + 0.16 * fraction;
+      hopsGrams[ii] = 5.0 + 200.0 * fraction;
+      volumes  [ii] = 20.0;
+      gravities[ii] = 1.040 + 0.06 * fraction;
+      boilTimes[ii] = static_cast<double>(ii % 91);
+   }
+   IbuMethods::IbuCalculationBatch const batch{aaRatings, hopsGrams, volumes, gravities, boilTimes};
+   this->pimpl->measure("IbuMethods::getIbus (batch)", numIbuCalculations, [&batch, &ibus]() {
+      IbuMethods::getIbus(batch, ibus);
+   });
+   QVERIFY(ibus.back() > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkSgToBrixSingle() {
+   double checksum = 0.0;
+   this->pimpl->measure("Algorithms::SgAt20CToBrix (single)", numIbuCalculations, [&checksum]() {
+      for (std::size_t ii = 0; ii < numIbuCalculations; ++ii) {
+         checksum += Algorithms::SgAt20CToBrix(1.001 + 0.12 * static_cast<double>(ii) / numIbuCalculations);
+      }
+   });
+   QVERIFY(checksum > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkSgToBrixBatch() {
+   std::vector<double> gravities(numIbuCalculations), brix(numIbuCalculations);
+   for (std::size_t ii = 0; ii < numIbuCalculations; ++ii) {
+      gravities[ii] = 1.001 + 0.12 * static_cast<double>(ii) / numIbuCalculations;
+   }
+   this->pimpl->measure("Algorithms::SgAt20CToBrix (batch)", numIbuCalculations, [&gravities, &brix]() {
+      Algorithms::SgAt20CToBrix(gravities, brix);
+   });
+   QVERIFY(brix.back() > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkAmountParsing() {
+   // We didn't set a locale in initTestCase, so we stick to inputs that are valid in most of them
+   QStringList const inputs {"3 kg", "12 L", "  25 oz", "1234 g", "5 gal", "2 qt", "75 tsp", "68 F"};
+   auto const & massUnitSystem = Measurement::Unit::getCanonicalUnit(Measurement::PhysicalQuantity::Mass).getUnitSystem();
+   int numMassAmounts = 0;
+   this->pimpl->measure("Measurement::Unit::splitAmountString + getUnit", inputs.size(), [&]() {
+      for (auto const & input : inputs) {
+         bool ok = false;
+         auto const [amount, name] = Measurement::Unit::splitAmountString(input, &ok);
+         if (ok && Measurement::Unit::getUnit(name, massUnitSystem)) {
+            ++numMassAmounts;
+         }
+      }
+   });
+   QVERIFY(numMassAmounts > 0);
+   return;
+}
+
+void Benchmarks::benchmarkAmountParsingThreaded() {
+   // Same inputs as benchmarkAmountParsing
+   QStringList const inputs {"3 kg", "12 L", "  25 oz", "1234 g", "5 gal", "2 qt", "75 tsp", "68 F"};
+   int const numThreads = std::max(4, QThread::idealThreadCount());
+   int const passesPerThread = 5000;
+   auto const & massUnitSystem = Measurement::Unit::getCanonicalUnit(Measurement::PhysicalQuantity::Mass).getUnitSystem();
+   std::atomic<int> numMassAmounts{0};
+   this->pimpl->measure("Measurement::Unit::splitAmountString + getUnit (threaded)",
+                        static_cast<qint64>(numThreads) * passesPerThread * inputs.size(),
+                        [&]() {
+      std::vector<std::thread> threads;
+      for (int threadNum = 0; threadNum < numThreads; ++threadNum) {
+         threads.emplace_back([&]() {
+            for (int ii = 0; ii < passesPerThread; ++ii) {
+               for (auto const & input : inputs) {
+                  bool ok = false;
+                  auto const [amount, name] = Measurement::Unit::splitAmountString(input, &ok);
+                  if (ok && Measurement::Unit::getUnit(name, massUnitSystem)) {
+                     ++numMassAmounts;
+                  }
+               }
+            }
+         });
+      }
+      for (auto & thread : threads) {
+         thread.join();
+      }
+   });
+   QVERIFY(numMassAmounts > 0);
+   return;
+}
+
+void Benchmarks::benchmarkBeerXmlExport() {
+   QString const fileName = this->pimpl->m_tempDir.filePath("benchmark.xml");
+   bool succeeded = true;
+   this->pimpl->measure("BeerXML export", 1, [&]() {
+      succeeded = succeeded && this->pimpl->exportRecipe(fileName);
+   });
+   QVERIFY(succeeded);
+   return;
+}
+
+void Benchmarks::benchmarkBeerXmlImport() {
+   QString const fileName = this->pimpl->m_tempDir.filePath("benchmark.xml");
+   if (!QFile::exists(fileName)) {
+      QVERIFY(this->pimpl->exportRecipe(fileName));
+   }
+   bool succeeded = true;
+   this->pimpl->measure("BeerXML import", 1, [&]() {
+      succeeded = succeeded && impl::importFile(fileName);
+   });
+   QVERIFY(succeeded);
+   return;
+}
+
+void Benchmarks::benchmarkBeerJsonExport() {
+   QString const fileName = this->pimpl->m_tempDir.filePath("benchmark.json");
+   bool succeeded = true;
+   this->pimpl->measure("BeerJSON export", 1, [&]() {
+      succeeded = succeeded && this->pimpl->exportRecipe(fileName);
+   });
+   QVERIFY(succeeded);
+   return;
+}
+
+void Benchmarks::benchmarkBeerJsonImport() {
+   QString const fileName = this->pimpl->m_tempDir.filePath("benchmark.json");
+   if (!QFile::exists(fileName)) {
+      QVERIFY(this->pimpl->exportRecipe(fileName));
+   }
+   bool succeeded = true;
+   this->pimpl->measure("BeerJSON import", 1, [&]() {
+      succeeded = succeeded && impl::importFile(fileName);
+   });
+   QVERIFY(succeeded);
+   return;
+}
+
+void Benchmarks::benchmarkTableModelSort() {
+   QTableView tableView;
+   HopTableModel tableModel{&tableView, false};
+   tableModel.observeDatabase(true);
+   HopSortFilterProxyModel proxyModel{nullptr, false, &tableModel};
+   qint64 const numRows = tableModel.rowCount();
+   QVERIFY(numRows >= numInitialHops);
+
+   int const alphaColumn = static_cast<int>(HopTableModel::ColumnIndex::Alpha);
+   Qt::SortOrder sortOrder = Qt::AscendingOrder;
+   this->pimpl->measure("HopSortFilterProxyModel::sort", numRows, [&]() {
+      sortOrder = (sortOrder == Qt::AscendingOrder) ? Qt::DescendingOrder : Qt::AscendingOrder;
+      proxyModel.sort(alphaColumn, sortOrder);
+   });
+   return;
+}
+
+void Benchmarks::benchmarkTreeModelMoveItems() {
+   int const numItems = 1000;
+   std::array<QString, 2> const folders{"/Benchmark/Source", "/Benchmark/Target"};
+
+   HopTreeModel treeModel;
+   QVERIFY(treeModel.addFolder(folders[0]));
+   QVERIFY(treeModel.addFolder(folders[1]));
+
+   // The benchmarks that follow expect the same hops in the DB as before this one, so we take ours out again after
+   std::vector<std::shared_ptr<Hop>> hops;
+   auto const deleteHops = qScopeGuard([&hops]() {
+      for (auto const & hop : hops) {
+         ObjectStoreWrapper::hardDelete(hop);
+      }
+      return;
+   });
+
+   // Drag-and-drop data for moving all the hops, in the same format as TreeModelBase::doMimeData
+   QByteArray encodedData;
+   QDataStream encodedDataStream(&encodedData, QIODevice::WriteOnly);
+   {
+      DbUnitOfWork unitOfWork{"Benchmark tree model hops"};
+      for (int ii = 0; ii < numItems; ++ii) {
+         auto hop = std::make_shared<Hop>(QString{"Tree Benchmark Hop %1"}.arg(ii));
+         hop->setFolderPath(folders[0]);
+         ObjectStoreWrapper::insert(hop);
+         hops.push_back(hop);
+         encodedDataStream << QString{Hop::staticMetaObject.className()} << hop->key() << hop->name();
+      }
+   }
+   QMimeData mimeData;
+   mimeData.setData(TreeItemNode<Hop>::DragNDropMimeType, encodedData);
+
+   // Each run moves all the hops to the other folder
+   std::size_t destination = 1;
+   bool succeeded = true;
+   this->pimpl->measure("HopTreeModel::dropMimeData (move)", numItems, [&]() {
+      QModelIndex const targetIndex = treeModel.findFolder(folders[destination], nullptr, IfNotFound::ReturnInvalid);
+      succeeded = succeeded && treeModel.dropMimeData(&mimeData, Qt::MoveAction, -1, -1, targetIndex);
+      destination = 1 - destination;
+   });
+   QVERIFY(succeeded);
+   return;
+}
+
+void Benchmarks::benchmarkSearchIndex() {
+   SearchIndex const & searchIndex = SearchIndex::instance<Hop>();
+   qint64 const numHops = searchIndex.size();
+   this->pimpl->measure("SearchIndex::search", numHops, [&searchIndex]() {
+      auto results = searchIndex.search("hop 0001");
+      QVERIFY(!results.isEmpty());
+   });
+   return;
+}
+
+void Benchmarks::benchmarkSubstringSearch() {
+   QList<Hop *> const hops = ObjectStoreTyped<Hop>::getInstance().getAllRaw();
+   qint64 const numHops = hops.size();
+   this->pimpl->measure("Substring search", numHops, [&hops]() {
+      QVector<int> results;
+      for (Hop const * hop : hops) {
+         if (hop->name().contains("hop 0001", Qt::CaseInsensitive)) {
+            results.append(hop->key());
+         }
+      }
+      QVERIFY(!results.isEmpty());
+   });
+   return;
+}
+
+void Benchmarks::benchmarkObjectStoreLoadAll10kRows() {
+   auto & hopStore = ObjectStoreTyped<Hop>::getInstance();
+   QVERIFY(static_cast<int>(hopStore.size()) <= numRowsPerLoad);
+   {
+      DbUnitOfWork unitOfWork{"Benchmark top up hops"};
+      while (static_cast<int>(hopStore.size()) < numRowsPerLoad) {
+         this->pimpl->makeHop(QString{"Inserted Hop %1"}.arg(this->pimpl->m_numInsertedHops++), 5.0);
+      }
+   }
+   this->pimpl->measure("ObjectStore::loadAll (10k rows)", 1, []() {
+      auto objectStore = ObjectStoreTyped<Hop>::createDetachedInstance();
+      objectStore->loadAll();
+   });
+   return;
+}
+
+void Benchmarks::benchmarkNamedParameterBundleByName() {
+   double checksum = 0.0;
+   this->pimpl->measure("NamedParameterBundle by name (10k rows)", 1, [&checksum]() {
+      for (int row = 0; row < numRowsPerLoad; ++row) {
+         NamedParameterBundle bundle;
+         checksum += fillAndReadBundle(bundle, row, false);
+      }
+   });
+   QVERIFY(checksum > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkNamedParameterBundleLayout() {
+   auto const layout = std::make_shared<NamedParameterBundle::Layout const>(hopRowPropertyNames);
+   double checksum = 0.0;
+   this->pimpl->measure("NamedParameterBundle by ordinal (10k rows)", 1, [&checksum, &layout]() {
+      for (int row = 0; row < numRowsPerLoad; ++row) {
+         NamedParameterBundle bundle{layout};
+         checksum += fillAndReadBundle(bundle, row, true);
+      }
+   });
+   QVERIFY(checksum > 0.0);
+   return;
+}
+
+void Benchmarks::benchmarkMainWindowTimeToInteractive() {
+   //
+   // This is the same span that MainWindow itself logs as time-to-interactive: from construction, through
+   // initialisation, until the event loop has had a chance to paint the window.  (The clock starts a little earlier
+   // here, as it includes creating MainWindow::impl.)  MainWindow is a singleton, so we can only do this once per run.
+   //
+   this->pimpl->measureOnce("MainWindow time to interactive", []() {
+      MainWindow & mainWindow = MainWindow::instance();
+      mainWindow.initialiseAndMakeVisible();
+      QCoreApplication::processEvents();
+   });
+   return;
+}
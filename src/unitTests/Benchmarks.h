@@ -0,0 +1,154 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * unitTests/Benchmarks.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UNITTESTS_BENCHMARKS_H
+#define UNITTESTS_BENCHMARKS_H
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QString>
+
+/**
+ * \brief Performance benchmarks, run by a separate executable from the unit tests (see \c Testing).
+ *
+ *        Each benchmark uses \c QBENCHMARK, so the usual QtTest options (eg \c -iterations, \c -minimumvalue) apply,
+ *        but we also record our own timings and write them out as JSON at the end of the run, so that results can be
+ *        compared between builds to spot performance regressions.
+ */
+class Benchmarks : public QObject {
+   Q_OBJECT
+
+public:
+   /**
+    * \param resultsFile Where to write the JSON results
+    */
+   Benchmarks(QString const & resultsFile);
+   virtual ~Benchmarks();
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+private slots:
+
+   // Run once before all benchmarks
+   void initTestCase();
+
+   // Run once after all benchmarks -- this is where we write out the JSON results
+   void cleanupTestCase();
+
+   //! \brief Inserting new \c Hop objects into the database
+   void benchmarkObjectStoreInsert();
+
+   //! \brief As \c benchmarkObjectStoreInsert but with all the inserts inside one \c DbUnitOfWork
+   void benchmarkObjectStoreInsertUnitOfWork();
+
+   //! \brief Writing a single changed property of an existing \c Hop back to the database
+   void benchmarkObjectStoreUpdateProperty();
+
+   //! \brief As \c benchmarkObjectStoreUpdateProperty but with all the updates inside one \c DbUnitOfWork
+   void benchmarkObjectStoreUpdatePropertyUnitOfWork();
+
+   //! \brief Deleting \c Hop objects from the database, which involves foreign key checks on tables that refer to it
+   void benchmarkObjectStoreHardDelete();
+
+   //! \brief As \c benchmarkObjectStoreHardDelete, but with the indexes that \c ObjectStore creates temporarily dropped,
+   //!        to show what they save
+   void benchmarkObjectStoreHardDeleteWithoutIndexes();
+
+   //! \brief Reading all the \c Hop records from the database (as happens at start-up)
+   void benchmarkObjectStoreLoadAll();
+
+   //! \brief A whole \c DbMaintenance cycle, run in one go rather than in idle-time steps, including purging a batch of
+   //!        soft-deleted \c Hop objects
+   void benchmarkDbMaintenanceCycle();
+
+   //! \brief Logging debug messages from several threads at once, so that they contend for the logging queue
+   void benchmarkLoggingThroughput();
+
+   //! \brief Full recalculation of a typical recipe
+   void benchmarkRecipeRecalcAll();
+
+   //! \brief As \c benchmarkRecipeRecalcAll but with debug logging on, to show what that costs
+   void benchmarkRecipeRecalcAllDebugLogging();
+
+   //! \brief Calculating IBUs one hop addition at a time
+   void benchmarkIbuMethodsSingle();
+
+   //! \brief Calculating IBUs for many hop additions at once
+   void benchmarkIbuMethodsBatch();
+
+   //! \brief Converting specific gravities to Brix one at a time
+   void benchmarkSgToBrixSingle();
+
+   //! \brief Converting many specific gravities to Brix at once
+   void benchmarkSgToBrixBatch();
+
+   //! \brief Parsing user-entered amounts with units (eg "3,5 kg")
+   void benchmarkAmountParsing();
+
+   //! \brief As \c benchmarkAmountParsing, but with several threads parsing at once, so that they share the parser
+   void benchmarkAmountParsingThreaded();
+
+   //! \brief Exporting a recipe to BeerXML
+   void benchmarkBeerXmlExport();
+
+   //! \brief Importing a recipe from BeerXML
+   void benchmarkBeerXmlImport();
+
+   //! \brief Exporting a recipe to BeerJSON
+   void benchmarkBeerJsonExport();
+
+   //! \brief Importing a recipe from BeerJSON
+   void benchmarkBeerJsonImport();
+
+   //! \brief Sorting the hop catalog table
+   void benchmarkTableModelSort();
+
+   //! \brief Moving a large number of items between folders in a tree model (as if by drag and drop)
+   void benchmarkTreeModelMoveItems();
+
+   //! \brief Searching all hops by text using the full-text index
+   void benchmarkSearchIndex();
+
+   //! \brief As \c benchmarkSearchIndex, but doing a case-insensitive substring match on every name, as the filters
+   //!        used to, for comparison
+   void benchmarkSubstringSearch();
+
+   //! \brief As \c benchmarkObjectStoreLoadAll, but with exactly 10,000 \c Hop records in the database.  This comes
+   //!        last as it leaves all those extra hops behind.
+   void benchmarkObjectStoreLoadAll10kRows();
+
+   //! \brief As \c benchmarkObjectStoreLoadAll10kRows, but loading the same 10,000 \c Hop records from a startup
+   //!        snapshot file (see \c StartupSnapshot) rather than from the database.  The two together compare, per
+   //!        table, a warm start with a cold one.
+   void benchmarkObjectStoreLoadFromSnapshot10kRows();
+
+   //! \brief Filling and reading back 10,000 row-sized \c NamedParameterBundle objects keyed by property name
+   void benchmarkNamedParameterBundleByName();
+
+   //! \brief As \c benchmarkNamedParameterBundleByName, but with the bundles sharing a \c NamedParameterBundle::Layout,
+   //!        as \c ObjectStore::loadAll does
+   void benchmarkNamedParameterBundleLayout();
+
+   //! \brief Creating and initialising \c MainWindow, up to the point where it is painted and usable.  This comes last
+   //!        as the window then stays around, listening for changes to everything, until the end of the run.
+   void benchmarkMainWindowTimeToInteractive();
+};
+
+#endif
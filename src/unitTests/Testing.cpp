@@ -21,37 +21,66 @@
  ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
 #include "unitTests/Testing.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <exception>
 #include <filesystem>
+#include <future>
 #include <iostream>
 #include <iostream> // For std::cout
 #include <math.h>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 #include <boost/json/src.hpp> // Needs to be included exactly once in the code to use header-only version of Boost.JSON
 
 #include <xercesc/util/PlatformUtils.hpp>
 
 #include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMimeData>
 #include <QString>
 #include <QtTest/QtTest>
 #include <QRandomGenerator>
+#include <QScopeGuard>
+#include <QSqlDriver>
+#include <QSqlError>
+#include <QSqlQuery>
 #include <QVector>
 
 #include "Application.h"
 #include "Logging.h"
 #include "Algorithms.h"
 #include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/ChangeJournal.h"
+#include "database/Database.h"
+#include "database/DbChangeNotifier.h"
+#include "database/DbMaintenance.h"
+#include "database/DbTransaction.h"
+#include "database/DbWriter.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/QueryStats.h"
+#include "database/SearchIndex.h"
+#include "database/StartupSnapshot.h"
 #include "Localization.h"
 #include "Logging.h"
+#include "measurement/AmountParser.h"
+#include "measurement/IbuMethods.h"
 #include "measurement/Measurement.h"
 #include "measurement/Unit.h"
 #include "measurement/UnitSystem.h"
 #include "model/Boil.h"
+#include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
@@ -62,6 +91,8 @@
 #include "model/RecipeAdditionFermentable.h"
 #include "model/RecipeAdditionHop.h"
 #include "PersistentSettings.h"
+#include "serialization/ImportExport.h"
+#include "trees/NamedEntityTreeModel.h"
 #include "utils/ErrorCodeToStream.h"
 #include "utils/FileSystemHelpers.h"
 
@@ -809,6 +840,36 @@ void Testing::testNamedParameterBundle() {
       "Error retrieving optional enum"
    );
 
+   //
+   // Bundles with a layout should behave the same whether values are supplied by ordinal or by name, and should still
+   // accept properties that are not in the layout.  We deliberately use a different BtStringConst instance with the
+   // same text for one of the look-ups, to check we're not relying on the address of the string.
+   //
+   auto const layout = std::make_shared<NamedParameterBundle::Layout const>(
+      std::vector<BtStringConst const *>{&myInt, &myString, &PropertyNames::Hop::type}
+   );
+   QCOMPARE(layout->ordinal(myString), 1);
+   QCOMPARE(layout->ordinal(myDouble), -1);
+   NamedParameterBundle layoutBundle{layout};
+   QVERIFY(layoutBundle.isEmpty());
+   QVERIFY(!layoutBundle.contains(myInt));
+   layoutBundle.insert(0, 42);
+   layoutBundle.insert(myString, "Four and twenty blackbirds");
+   layoutBundle.insert(myDouble, 2.5);
+   QCOMPARE(layoutBundle.size(), static_cast<std::size_t>(3));
+   BtStringConst const myIntCopy{"myInt"};
+   QCOMPARE(layoutBundle.val<int>(myIntCopy), 42);
+   QCOMPARE(layoutBundle.val<QString>(myString), QString{"Four and twenty blackbirds"});
+   QVERIFY(fuzzyComp(layoutBundle.val<double>(myDouble), 2.5, 0.0000000001));
+   QCOMPARE(layoutBundle.val<int>(PropertyNames::Hop::type, -1), -1);
+   bool threwForMissing = false;
+   try {
+      layoutBundle.get(PropertyNames::Hop::type);
+   } catch (std::invalid_argument const &) {
+      threwForMissing = true;
+   }
+   QVERIFY2(threwForMissing, "Missing required parameter in layout did not throw");
+
    return;
 }
 
@@ -843,6 +904,81 @@ void Testing::testAlgorithms() {
    return;
 }
 
+void Testing::testBatchAlgorithms() {
+   //
+   // Sweep the inputs across the ranges we'd expect to see in practice
+   //
+   std::size_t const numValues = 20000;
+   std::vector<double> aaRatings(numValues), hopsGrams(numValues), volumes(numValues), gravities(numValues),
+                       boilTimes(numValues), platos(numValues), finalGravities(numValues);
+   for (std::size_t ii = 0; ii < numValues; ++ii) {
+      double const fraction = static_cast<double>(ii) / numValues;
+      aaRatings     [ii] = 0.02 + 0.16 * fraction;
+      hopsGrams     [ii] = 5.0 + 200.0 * fraction;
+      volumes       [ii] = 10.0 + 40.0 * (1.0 - fraction);
+      gravities     [ii] = 1.001 + 0.12 * fraction;
+      boilTimes     [ii] = static_cast<double>(ii % 91);
+      platos        [ii] = -5.0 + 38.0 * fraction;
+      finalGravities[ii] = 1.0 + (gravities[ii] - 1.0) * 0.25;
+   }
+
+   std::vector<double> batchResults(numValues);
+
+   // Put the global IBU formula back however we leave this function -- including via a failed QVERIFY / QCOMPARE
+   auto const restoreFormula = qScopeGuard([savedFormula = IbuMethods::formula]() {
+      IbuMethods::formula = savedFormula;
+      return;
+   });
+   for (auto const formula : {IbuMethods::IbuFormula::Tinseth,
+                              IbuMethods::IbuFormula::Rager  ,
+                              IbuMethods::IbuFormula::Noonan ,
+                              IbuMethods::IbuFormula::mIbu   }) {
+      IbuMethods::formula = formula;
+      // mIbu is slow (it does a numerical integration), so we only check a sample of values
+      std::size_t const step = (formula == IbuMethods::IbuFormula::mIbu) ? 97 : 1;
+      std::vector<double> sampleAa, sampleHops, sampleVolumes, sampleGravities, sampleTimes;
+      for (std::size_t ii = 0; ii < numValues; ii += step) {
+         sampleAa       .push_back(aaRatings[ii]);
+         sampleHops     .push_back(hopsGrams[ii]);
+         sampleVolumes  .push_back(volumes  [ii]);
+         sampleGravities.push_back(gravities[ii]);
+         sampleTimes    .push_back(boilTimes[ii]);
+      }
+      IbuMethods::IbuCalculationBatch const batch{
+         sampleAa, sampleHops, sampleVolumes, sampleGravities, sampleTimes, 10.0, 40.0, 30.0
+      };
+      std::vector<double> ibus(sampleAa.size());
+      IbuMethods::getIbus(batch, ibus);
+      for (std::size_t ii = 0; ii < ibus.size(); ++ii) {
+         double const expected = IbuMethods::getIbus(IbuMethods::IbuCalculationParms{
+            sampleAa[ii], sampleHops[ii], sampleVolumes[ii], sampleGravities[ii], sampleTimes[ii], 10.0, 40.0, 30.0
+         });
+         QVERIFY2(fuzzyComp(ibus[ii], expected, 0.000001 * std::max(1.0, std::abs(expected))),
+                  qPrintable(QString("%1 IBU mismatch at %2: %3 vs %4").arg(
+                     IbuMethods::formulaStringMapping[formula]
+                  ).arg(ii).arg(ibus[ii]).arg(expected)));
+      }
+   }
+
+   Algorithms::SgAt20CToBrix(gravities, batchResults);
+   for (std::size_t ii = 0; ii < numValues; ++ii) {
+      QVERIFY(fuzzyComp(batchResults[ii], Algorithms::SgAt20CToBrix(gravities[ii]), 0.005));
+   }
+
+   Algorithms::PlatoToSG_20C20C(platos, batchResults);
+   for (std::size_t ii = 0; ii < numValues; ++ii) {
+      QVERIFY(fuzzyComp(batchResults[ii], Algorithms::PlatoToSG_20C20C(platos[ii]), 0.000001));
+   }
+
+   Algorithms::abvFromOgAndFg(gravities, finalGravities, batchResults);
+   for (std::size_t ii = 0; ii < numValues; ++ii) {
+      QVERIFY(fuzzyComp(batchResults[ii], Algorithms::abvFromOgAndFg(gravities[ii], finalGravities[ii]), 0.0000001));
+   }
+
+   // See Benchmarks for how much faster the batch versions are
+   return;
+}
+
 void Testing::testTypeLookups() {
    QVERIFY2(Hop::typeLookup.getType(PropertyNames::Hop::alpha_pct).typeIndex == typeid(double),
             "PropertyNames::Hop::alpha_pct not a double");
@@ -871,6 +1007,9 @@ void Testing::testLogRotation() {
    // Put logging back to normal
    Logging::setLoggingToStderr(true);
 
+   // Log files are written in the background, so we need to wait for that to finish before looking at them
+   Logging::flush();
+
    QFileInfoList fileList = Logging::getLogFileList();
    qDebug() << Q_FUNC_INFO << "Logging::getLogFileList() has" << fileList.size() << "entries";
    qDebug() << Q_FUNC_INFO << "Logging::logFileCount =" << Logging::logFileCount;
@@ -887,6 +1026,64 @@ void Testing::testLogRotation() {
    return;
 }
 
+void Testing::testAmountParser() {
+   //
+   // Per comment above, we should be in French locale here, so decimal comma.  The grouping separator is not a plain
+   // space or dot (in Qt 6 it is U+202F narrow no-break space), so we ask the locale for it rather than hard-code it.
+   //
+   QString const thousands = "1" + Localization::getLocale().groupSeparator() + "234,5 g";
+   QStringList const inputs {"3,5 kg", "12 L", "  0,25 oz", thousands, "5 gal", "2 qt", ",75 tsp", "68 F"};
+   int const numThreads = std::max(4, QThread::idealThreadCount());
+   int const passesPerThread = 100;
+
+   auto const parser = Measurement::AmountParser::current();
+   auto const [quantity, unitName] = parser->splitAmountString("3,5 kg");
+   QVERIFY(fuzzyComp(3.5, quantity, 0.0000000001));
+   QCOMPARE(unitName, QString{"kg"});
+   bool thousandsOk = false;
+   auto const [thousandsQuantity, thousandsUnitName] = parser->splitAmountString(thousands, &thousandsOk);
+   QVERIFY(thousandsOk);
+   QVERIFY(fuzzyComp(1234.5, thousandsQuantity, 0.0000000001));
+   QCOMPARE(thousandsUnitName, QString{"g"});
+   QVERIFY(parser->findUnit("KG", Measurement::PhysicalQuantity::Mass) == &Measurement::Units::kilograms);
+   QVERIFY(parser->findUnit("kg", Measurement::PhysicalQuantity::Volume) == nullptr);
+   // Unless the display unit system says otherwise, an ambiguous "gal" means US Customary gallons
+   bool const displayingImperialVolume =
+      Measurement::getDisplayUnitSystem(Measurement::PhysicalQuantity::Volume) == Measurement::UnitSystems::volume_Imperial;
+   QVERIFY(parser->findUnit("gal", Measurement::PhysicalQuantity::Volume) ==
+           (displayingImperialVolume ? &Measurement::Units::imperial_gallons : &Measurement::Units::us_gallons));
+   QVERIFY(Localization::hasUnits("12 L"));
+   QVERIFY(!Localization::hasUnits("12"));
+
+   //
+   // The parser is shared between threads, so check that we get the same answers when several threads are using it at
+   // once.  (Benchmarks::benchmarkAmountParsingThreaded times the same thing.)
+   //
+   auto const & massUnitSystem = Measurement::Unit::getCanonicalUnit(Measurement::PhysicalQuantity::Mass).getUnitSystem();
+   std::atomic<int> numMassAmounts{0};
+   std::vector<std::thread> threads;
+   for (int threadNum = 0; threadNum < numThreads; ++threadNum) {
+      threads.emplace_back([&inputs, &massUnitSystem, &numMassAmounts, passesPerThread]() {
+         for (int ii = 0; ii < passesPerThread; ++ii) {
+            for (auto const & input : inputs) {
+               bool ok = false;
+               auto const [amount, name] = Measurement::Unit::splitAmountString(input, &ok);
+               if (ok && Measurement::Unit::getUnit(name, massUnitSystem)) {
+                  ++numMassAmounts;
+               }
+            }
+         }
+      });
+   }
+   for (auto & thread : threads) {
+      thread.join();
+   }
+
+   // Of the inputs, only "kg", "oz" and "g" are units of mass
+   QCOMPARE(numMassAmounts.load(), numThreads * passesPerThread * 3);
+   return;
+}
+
 void Testing::cleanupTestCase() {
    Application::cleanup();
    Logging::terminateLogging();
@@ -950,3 +1147,612 @@ void Testing::testInventory() {
 
    return;
 }
+
+void Testing::testTreeModelMoveItems() {
+   qDebug() << Q_FUNC_INFO << "Starting";
+   int const numItems = 100;
+   QString const sourceFolder = "/Move Test/Source";
+   QString const targetFolder = "/Move Test/Target";
+
+   HopTreeModel treeModel;
+   QVERIFY(treeModel.addFolder(sourceFolder));
+   QVERIFY(treeModel.addFolder(targetFolder));
+
+   //
+   // Adding the Hops to the database will, via ObjectStoreTyped::signalObjectInserted, also add them to the tree.  At
+   // the same time, we build the drag-and-drop data for moving them all, in the same format as
+   // TreeModelBase::doMimeData.
+   //
+   std::vector<std::shared_ptr<Hop>> hops;
+   // Other tests share the DB, so we don't want to leave our hops behind, even if one of our checks fails
+   auto const deleteHops = qScopeGuard([&hops]() {
+      for (auto const & hop : hops) {
+         ObjectStoreWrapper::hardDelete(hop);
+      }
+      return;
+   });
+   QByteArray encodedData;
+   QDataStream encodedDataStream(&encodedData, QIODevice::WriteOnly);
+   for (int ii = 0; ii < numItems; ++ii) {
+      auto hop = std::make_shared<Hop>(QString{"Move Test Hop %1"}.arg(ii));
+      hop->setFolderPath(sourceFolder);
+      ObjectStoreWrapper::insert(hop);
+      hops.push_back(hop);
+      encodedDataStream << QString{Hop::staticMetaObject.className()} << hop->key() << hop->name();
+   }
+   QMimeData mimeData;
+   mimeData.setData(TreeItemNode<Hop>::DragNDropMimeType, encodedData);
+
+   QModelIndex const sourceIndex = treeModel.findFolder(sourceFolder, nullptr, IfNotFound::ReturnInvalid);
+   QVERIFY(sourceIndex.isValid());
+   QCOMPARE(treeModel.allChildren(sourceIndex).size(), numItems);
+
+   QModelIndex const targetIndex = treeModel.findFolder(targetFolder, nullptr, IfNotFound::ReturnInvalid);
+   QVERIFY(targetIndex.isValid());
+   QVERIFY(treeModel.dropMimeData(&mimeData, Qt::MoveAction, -1, -1, targetIndex));
+
+   QCOMPARE(treeModel.allChildren(treeModel.findFolder(sourceFolder, nullptr, IfNotFound::ReturnInvalid)).size(), 0);
+   QCOMPARE(treeModel.allChildren(treeModel.findFolder(targetFolder, nullptr, IfNotFound::ReturnInvalid)).size(),
+            numItems);
+   for (auto const & hop : hops) {
+      QCOMPARE(hop->folderPath(), targetFolder);
+   }
+   return;
+}
+
+void Testing::testDbWriter() {
+   int const numChanges = 100;
+   auto hop = std::make_shared<Hop>(QString{"DB Writer Hop"});
+   ObjectStoreWrapper::insert(hop);
+
+   auto alphaInDb = [&hop]() {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      query.prepare("SELECT alpha FROM hop WHERE id = :id;");
+      query.bindValue(":id", hop->key());
+      if (!query.exec() || !query.next()) {
+         qCritical() << Q_FUNC_INFO << "Unable to read back hop #" << hop->key() << query.lastError().text();
+         return -1.0;
+      }
+      return query.value(0).toDouble();
+   };
+
+   //
+   // To check that writes really are queued, we hold up the writer thread with a write that doesn't finish until we
+   // say so.  Anything we queue after it has started has to wait.
+   //
+   auto holdUpWriter = [](DbWriter & writer, std::shared_future<void> const & release) {
+      // Shared, as the promise has to outlive the call to set_value() on the writer thread
+      auto started = std::make_shared<std::promise<void>>();
+      std::future<void> hasStarted = started->get_future();
+      writer.enqueue("Hold up writer", [started, release](QSqlDatabase &) {
+         started->set_value();
+         release.wait();
+         return true;
+      });
+      hasStarted.wait();
+      return;
+   };
+
+   DbWriter & dbWriter = DbWriter::instance();
+   dbWriter.start();
+   std::promise<void> releaseWriter;
+   // Other tests expect synchronous writes, so make sure the writer is released and stopped even if a check fails
+   auto const stopWriter = qScopeGuard([&dbWriter, &releaseWriter]() {
+      try { releaseWriter.set_value(); } catch (std::future_error const &) { }
+      dbWriter.stop();
+      return;
+   });
+   QVERIFY(dbWriter.isRunning());
+
+   holdUpWriter(dbWriter, releaseWriter.get_future().share());
+   for (int ii = 1; ii <= numChanges; ++ii) {
+      hop->setAlpha_pct(ii / 10.0);
+   }
+   // Nothing should have been written yet
+   QVERIFY(dbWriter.numQueued() >= static_cast<std::size_t>(numChanges));
+   QVERIFY(alphaInDb() != numChanges / 10.0);
+   releaseWriter.set_value();
+   dbWriter.flush();
+   QCOMPARE(dbWriter.numQueued(), static_cast<std::size_t>(0));
+   // Only the last value should be in the DB
+   QCOMPARE(alphaInDb(), numChanges / 10.0);
+
+   //
+   // Stopping should also leave nothing unwritten, and flush() should wait for that, even though, as soon as stop() is
+   // called, isRunning() is false.  So we hold up the writer again, stop it on another thread, and only let it go
+   // after a short delay.
+   //
+   std::promise<void> releaseStoppingWriter;
+   holdUpWriter(dbWriter, releaseStoppingWriter.get_future().share());
+   hop->setAlpha_pct(1.5);
+   std::thread stopper{[&dbWriter]() { dbWriter.stop(); return; }};
+   while (dbWriter.isRunning()) {
+      std::this_thread::yield();
+   }
+   std::thread releaser{[&releaseStoppingWriter]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      releaseStoppingWriter.set_value();
+      return;
+   }};
+   dbWriter.flush();
+   double const alphaAfterFlush = alphaInDb();
+   releaser.join();
+   stopper.join();
+   QCOMPARE(alphaAfterFlush, 1.5);
+   QVERIFY(!dbWriter.isRunning());
+   return;
+}
+
+void Testing::testSearchIndex() {
+   QCOMPARE(SearchIndex::terms("Hallertauer Mittelfrüh (AROMA)"),
+            (QStringList{"hallertauer", "mittelfruh", "aroma"}));
+
+   // We use made-up words so as not to match anything else in the DB
+   auto hop1 = std::make_shared<Hop>(QString{"Zorblax Gold"});
+   hop1->setNotes("Qwimble and frondle");
+   auto hop2 = std::make_shared<Hop>(QString{"Frondle Special"});
+   hop2->setNotes("Very zorblaxy");
+   hop2->setSubstitutes("Zorblax Gold");
+   auto hop3 = std::make_shared<Hop>(QString{"Plimmet Frühling"});
+   ObjectStoreWrapper::insert(hop1);
+   ObjectStoreWrapper::insert(hop2);
+   ObjectStoreWrapper::insert(hop3);
+
+   SearchIndex const & searchIndex = SearchIndex::instance<Hop>();
+   QVERIFY(searchIndex.size() >= 3);
+
+   auto keysOf = [](QVector<SearchIndex::Result> const & results) {
+      QVector<int> keys;
+      for (auto const & result : results) {
+         keys.append(result.key);
+      }
+      return keys;
+   };
+
+   // Name matches rank above matches in other fields
+   QCOMPARE(keysOf(searchIndex.search("frondle")), (QVector<int>{hop2->key(), hop1->key()}));
+   QCOMPARE(keysOf(searchIndex.search("zorblax")), (QVector<int>{hop1->key(), hop2->key()}));
+   // Prefix matching, accents ignored and all terms must match
+   QCOMPARE(keysOf(searchIndex.search("ZORB")), (QVector<int>{hop1->key(), hop2->key()}));
+   QCOMPARE(keysOf(searchIndex.search("fruhling")), (QVector<int>{hop3->key()}));
+   QCOMPARE(keysOf(searchIndex.search("zorblax qwim")), (QVector<int>{hop1->key()}));
+   QCOMPARE(searchIndex.search("zorblax plimmet").size(), 0);
+   QCOMPARE(searchIndex.search("zorb", 1).size(), 1);
+   QVERIFY(!searchIndex.matchingKeys("  ").has_value());
+
+   // Index is kept up-to-date when things change, and tells listeners (once per burst of changes) that it has been
+   QSignalSpy updatedSpy{&searchIndex, &SearchIndex::updated};
+   hop3->setNotes("Now with added qwimble");
+   QCOMPARE(keysOf(searchIndex.search("qwimble")), (QVector<int>{hop1->key(), hop3->key()}));
+   ObjectStoreWrapper::softDelete(*hop1);
+   QCOMPARE(keysOf(searchIndex.search("qwimble")), (QVector<int>{hop3->key()}));
+   // A whole-object update doesn't say which properties changed, so the index has to pick it up from its own signal
+   QSignalSpy objectUpdatedSpy{&ObjectStoreTyped<Hop>::getInstance(), &ObjectStore::signalObjectUpdated};
+   ObjectStoreWrapper::update(*hop3);
+   QCOMPARE(objectUpdatedSpy.count(), 1);
+   QCOMPARE(objectUpdatedSpy.at(0).at(0).toInt(), hop3->key());
+   QCOMPARE(keysOf(searchIndex.search("qwimble")), (QVector<int>{hop3->key()}));
+   QVERIFY(updatedSpy.wait(1000));
+   QCOMPARE(updatedSpy.count(), 1);
+   return;
+}
+
+void Testing::testQueryStats() {
+   QueryStats::reset();
+   int const numExecutions = 10;
+   QString const selectSql{"SELECT id FROM hop WHERE id <= :maxId;"};
+   qint64 const numHops = [&]() {
+      BtSqlQuery countQuery{Database::instance().sqlDatabase()};
+      countQuery.prepare("SELECT COUNT(*) FROM hop WHERE id <= 5;");
+      countQuery.exec();
+      countQuery.next();
+      return countQuery.value(0).toLongLong();
+   }();
+   QVERIFY(numHops > 0);
+
+   {
+      BtSqlQuery query{Database::instance().sqlDatabase()};
+      query.prepare(selectSql);
+      for (int ii = 0; ii < numExecutions; ++ii) {
+         query.bindValue(":maxId", 5);
+         QVERIFY(query.exec());
+         while (query.next()) {
+            ;
+         }
+      }
+   }
+
+   auto const stats = QueryStats::snapshot();
+   auto const match = std::find_if(stats.begin(),
+                                   stats.end(),
+                                   [&selectSql](auto const & statementStats) {
+                                      return statementStats.statement == selectSql;
+                                   });
+   QVERIFY(match != stats.end());
+   QCOMPARE(match->count, static_cast<qint64>(numExecutions));
+   QCOMPARE(match->rows, numHops * numExecutions);
+   QVERIFY(match->total_ns > 0);
+   QVERIFY(match->p50_ns > 0);
+   QVERIFY(match->p99_ns >= match->p50_ns);
+
+   QString report;
+   QTextStream reportAsStream{&report};
+   QueryStats::writeReport(reportAsStream);
+   QVERIFY(report.contains(selectSql));
+   return;
+}
+
+void Testing::testRowVersionConflict() {
+   auto hop = std::make_shared<Hop>(QString{"Row Version Hop"});
+   hop->setAlpha_pct(5.0);
+   ObjectStoreWrapper::insert(hop);
+   QSignalSpy conflictSpy{&DbChangeNotifier::instance(), &DbChangeNotifier::conflictDetected};
+
+   // Pretend another client changed the row behind our back
+   {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      QVERIFY(query.prepare(
+         "UPDATE hop SET name = :name, alpha = :alpha, row_version = row_version + 1 WHERE id = :id;"
+      ));
+      query.bindValue(":name", "Row Version Hop (changed elsewhere)");
+      query.bindValue(":alpha", 6.0);
+      query.bindValue(":id", hop->key());
+      QVERIFY(query.exec());
+   }
+
+   // Our change should be rejected, and we should end up with the other client's version of the hop
+   hop->setAlpha_pct(7.5);
+   QTRY_COMPARE(conflictSpy.count(), 1);
+   QCOMPARE(hop->name(), QString{"Row Version Hop (changed elsewhere)"});
+   QCOMPARE(hop->alpha_pct(), 6.0);
+
+   // Now we're back in step with the DB, changes go through as normal
+   hop->setAlpha_pct(8.0);
+   QCoreApplication::processEvents();
+   QCOMPARE(conflictSpy.count(), 1);
+   {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      QVERIFY(query.prepare("SELECT alpha, row_version FROM hop WHERE id = :id;"));
+      query.bindValue(":id", hop->key());
+      QVERIFY(query.exec());
+      QVERIFY(query.next());
+      QCOMPARE(query.value(0).toDouble(), 8.0);
+      QCOMPARE(query.value(1).toInt(), 3);
+   }
+
+   //
+   // A write that is rolled back along with the transaction around it mustn't leave us expecting a later row version
+   // than the DB has, otherwise our next change would look like a conflict.
+   //
+   {
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      DbTransaction outerTransaction{Database::instance(), connection, "Rolled back row version"};
+      hop->setAlpha_pct(9.0);
+      // No commit, so the write (which only released its own savepoint) is undone here
+   }
+   hop->setAlpha_pct(9.5);
+   QCoreApplication::processEvents();
+   QCOMPARE(conflictSpy.count(), 1);
+   {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      QVERIFY(query.prepare("SELECT alpha, row_version FROM hop WHERE id = :id;"));
+      query.bindValue(":id", hop->key());
+      QVERIFY(query.exec());
+      QVERIFY(query.next());
+      QCOMPARE(query.value(0).toDouble(), 9.5);
+      QCOMPARE(query.value(1).toInt(), 4);
+   }
+   return;
+}
+
+void Testing::testQueuedWriteConflict() {
+   auto hop = std::make_shared<Hop>(QString{"Queued Row Version Hop"});
+   hop->setAlpha_pct(5.0);
+   ObjectStoreWrapper::insert(hop);
+   QSignalSpy conflictSpy{&DbChangeNotifier::instance(), &DbChangeNotifier::conflictDetected};
+
+   DbWriter & dbWriter = DbWriter::instance();
+   dbWriter.start();
+   // Other tests expect synchronous writes, so make sure the writer is stopped even if one of our checks fails
+   auto const stopWriter = qScopeGuard([&dbWriter]() { dbWriter.stop(); return; });
+
+   // A queued write that goes through as normal
+   hop->setAlpha_pct(5.5);
+   dbWriter.flush();
+   QCoreApplication::processEvents();
+   QCOMPARE(conflictSpy.count(), 0);
+
+   // Pretend another client changed the row behind our back
+   {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      QVERIFY(query.prepare(
+         "UPDATE hop SET name = :name, alpha = :alpha, row_version = row_version + 1 WHERE id = :id;"
+      ));
+      query.bindValue(":name", "Queued Row Version Hop (changed elsewhere)");
+      query.bindValue(":alpha", 6.0);
+      query.bindValue(":id", hop->key());
+      QVERIFY(query.exec());
+   }
+
+   //
+   // Once our change is queued, the row version we expect after it is the same as the one the other client's change
+   // gave the row.  Our change should still be rejected, and we should still end up with the other client's version.
+   //
+   hop->setAlpha_pct(7.5);
+   dbWriter.flush();
+   QTRY_COMPARE(conflictSpy.count(), 1);
+   QCOMPARE(hop->name(), QString{"Queued Row Version Hop (changed elsewhere)"});
+   QCOMPARE(hop->alpha_pct(), 6.0);
+
+   // Now we're back in step with the DB, changes go through as normal
+   hop->setAlpha_pct(8.0);
+   dbWriter.flush();
+   QCoreApplication::processEvents();
+   QCOMPARE(conflictSpy.count(), 1);
+   {
+      QSqlQuery query{Database::instance().sqlDatabase()};
+      QVERIFY(query.prepare("SELECT alpha, row_version FROM hop WHERE id = :id;"));
+      query.bindValue(":id", hop->key());
+      QVERIFY(query.exec());
+      QVERIFY(query.next());
+      QCOMPARE(query.value(0).toDouble(), 8.0);
+      QCOMPARE(query.value(1).toInt(), 4);
+   }
+   return;
+}
+
+void Testing::testChangeNotificationPgsql() {
+   //
+   // The rest of the tests run on SQLite, so we need to be told which PostgreSQL DB to use.  Host, port, user and
+   // password, if not the defaults, can be given in the usual PGHOST, PGPORT, PGUSER and PGPASSWORD environment
+   // variables, as libpq picks these up for anything we don't set.  We don't create any tables, so any DB will do.
+   //
+   QString const databaseName = qEnvironmentVariable("BREWTARGET_TEST_PG_DATABASE");
+   if (databaseName.isEmpty()) {
+      QSKIP("Set BREWTARGET_TEST_PG_DATABASE (and, if needed, PGHOST etc) to run against PostgreSQL");
+   }
+
+   QString const listenConnectionName {"testChangeNotificationPgsql_listen" };
+   QString const publishConnectionName{"testChangeNotificationPgsql_publish"};
+   auto const removeConnections = qScopeGuard([&listenConnectionName, &publishConnectionName]() {
+      QSqlDatabase::removeDatabase(listenConnectionName);
+      QSqlDatabase::removeDatabase(publishConnectionName);
+      return;
+   });
+
+   {
+      QSqlDatabase listenConnection = QSqlDatabase::addDatabase("QPSQL", listenConnectionName);
+      listenConnection.setDatabaseName(databaseName);
+      QVERIFY2(listenConnection.open(), qPrintable(listenConnection.lastError().text()));
+      QSqlDatabase publishConnection = QSqlDatabase::addDatabase("QPSQL", publishConnectionName);
+      publishConnection.setDatabaseName(databaseName);
+      QVERIFY2(publishConnection.open(), qPrintable(publishConnection.lastError().text()));
+
+      QVERIFY(listenConnection.driver()->subscribeToNotification(DbChangeNotifier::channelName()));
+      QStringList payloads;
+      QObject::connect(
+         listenConnection.driver(),
+         QOverload<QString const &, QSqlDriver::NotificationSource, QVariant const &>::of(&QSqlDriver::notification),
+         [&payloads](QString const & name,
+                     [[maybe_unused]] QSqlDriver::NotificationSource source,
+                     QVariant const & payload) {
+            if (name == DbChangeNotifier::channelName()) {
+               payloads.append(payload.toString());
+            }
+            return;
+         }
+      );
+
+      // Nothing should be sent for a change that is rolled back...
+      QVERIFY(publishConnection.transaction());
+      QVERIFY(DbChangeNotifier::publish(publishConnection, DbChangeNotifier::Operation::Update, "hop", 41, {"alpha"}));
+      QVERIFY(publishConnection.rollback());
+
+      // ...nor for one that is committed until the commit happens...
+      QVERIFY(publishConnection.transaction());
+      QVERIFY(DbChangeNotifier::publish(publishConnection, DbChangeNotifier::Operation::Update, "hop", 42, {"alpha"}));
+      QTest::qWait(200);
+      QCOMPARE(payloads.size(), 0);
+
+      // ...but then it should be
+      QVERIFY(publishConnection.commit());
+      QTRY_COMPARE(payloads.size(), 1);
+      QJsonObject const change = QJsonDocument::fromJson(payloads.at(0).toUtf8()).object();
+      QCOMPARE(change.value("client").toString(), DbChangeNotifier::clientId());
+      QCOMPARE(change.value("op"    ).toString(), QString{"update"});
+      QCOMPARE(change.value("table" ).toString(), QString{"hop"});
+      QCOMPARE(change.value("id"    ).toInt(), 42);
+      QCOMPARE(change.value("cols"  ).toArray(), QJsonArray{"alpha"});
+
+      listenConnection.driver()->unsubscribeFromNotification(DbChangeNotifier::channelName());
+      listenConnection.close();
+      publishConnection.close();
+   }
+   return;
+}
+
+void Testing::testChangeJournal() {
+   ChangeJournal & changeJournal = ChangeJournal::instance();
+   qint64 const startSequence = changeJournal.latestSequence();
+   PersistentSettings::insert(PersistentSettings::Names::lastChangeExportSequence, startSequence);
+
+   // Inserting a hop might also insert related objects (eg inventory), so we only look at entries for the hop itself
+   auto changesToHop = [&changeJournal](qint64 const cursor, int const hopId) {
+      QVector<ChangeJournal::Entry> entries;
+      for (auto const & entry : changeJournal.changesSince(cursor)) {
+         if (entry.tableName == "hop" && entry.id == hopId) {
+            entries.append(entry);
+         }
+      }
+      return entries;
+   };
+
+   // Changes made before the journal is next written should be merged into the insert
+   auto hop = std::make_shared<Hop>(QString{"Change Journal Hop"});
+   ObjectStoreWrapper::insert(hop);
+   hop->setAlpha_pct(4.5);
+   hop->setNotes("First");
+   auto changes = changesToHop(startSequence, hop->key());
+   QCOMPARE(changes.size(), 1);
+   QVERIFY(changes.at(0).operation == DbChangeNotifier::Operation::Insert);
+   QVERIFY(changes.at(0).sequence > startSequence);
+   QCOMPARE(changeJournal.numPending(), 0);
+
+   // Several updates to the same object become one entry, listing all the columns changed
+   qint64 const insertSequence = changes.at(0).sequence;
+   hop->setAlpha_pct(5.5);
+   hop->setNotes("Second");
+   hop->setAlpha_pct(6.5);
+   changes = changesToHop(insertSequence, hop->key());
+   QCOMPARE(changes.size(), 1);
+   QVERIFY(changes.at(0).operation == DbChangeNotifier::Operation::Update);
+   QCOMPARE(changes.at(0).columnNames.size(), 2);
+   QVERIFY(changes.at(0).columnNames.contains("alpha"));
+   QVERIFY(changes.at(0).columnNames.contains("notes"));
+
+   // The delta export includes the hop the first time, but not the second
+   QTemporaryDir tempDir;
+   QVERIFY(tempDir.isValid());
+   QString const exportFileName = tempDir.filePath("delta.json");
+   QString message;
+   QTextStream messageAsStream{&message};
+   QVERIFY(ImportExport::exportChangesToNamedFile(exportFileName, messageAsStream));
+   {
+      QFile exportFile{exportFileName};
+      QVERIFY(exportFile.open(QIODevice::ReadOnly));
+      QVERIFY(exportFile.readAll().contains("Change Journal Hop"));
+   }
+   QVERIFY(QFile::remove(exportFileName));
+   QVERIFY(ImportExport::exportChangesToNamedFile(exportFileName, messageAsStream));
+   QVERIFY(!QFile::exists(exportFileName));
+
+   // Deletes are journaled too
+   int const hopId = hop->key();
+   ObjectStoreWrapper::hardDelete<Hop>(hopId);
+   changes = changesToHop(changes.at(0).sequence, hopId);
+   QCOMPARE(changes.size(), 1);
+   QVERIFY(changes.at(0).operation == DbChangeNotifier::Operation::Delete);
+   return;
+}
+
+void Testing::testStartupSnapshot() {
+   auto & hopStore = ObjectStoreTyped<Hop>::getInstance();
+   auto hop = std::make_shared<Hop>(QString{"Snapshot Hop"});
+   hop->setAlpha_pct(12.5);
+   hop->setNotes("Snapshot notes");
+   ObjectStoreWrapper::insert(hop);
+   DbWriter::instance().flush();
+
+   QByteArray snapshotData;
+   {
+      QDataStream out{&snapshotData, QIODevice::WriteOnly};
+      out.setVersion(StartupSnapshot::dataStreamVersion);
+      QSqlDatabase connection = Database::instance().sqlDatabase();
+      QVERIFY(hopStore.writeSnapshot(connection, out));
+   }
+
+   // Loading from the snapshot should give the same objects as loading from the DB
+   auto snapshotStore = ObjectStoreTyped<Hop>::createDetachedInstance();
+   QVERIFY(snapshotStore->loadFromSnapshot(snapshotData));
+   QCOMPARE(snapshotStore->size(), hopStore.size());
+   QVERIFY(snapshotStore->contains(hop->key()));
+   auto snapshotHop = std::static_pointer_cast<Hop>(snapshotStore->getById(hop->key()));
+   QCOMPARE(snapshotHop->name(), hop->name());
+   QCOMPARE(snapshotHop->alpha_pct(), 12.5);
+   QCOMPARE(snapshotHop->notes(), QString{"Snapshot notes"});
+
+   // A truncated snapshot is rejected without anything being loaded
+   auto truncatedStore = ObjectStoreTyped<Hop>::createDetachedInstance();
+   QVERIFY(!truncatedStore->loadFromSnapshot(snapshotData.left(snapshotData.size() - 1)));
+   QCOMPARE(truncatedStore->size(), static_cast<size_t>(0));
+   return;
+}
+
+void Testing::testDbMaintenance() {
+   auto & hopStore = ObjectStoreTyped<Hop>::getInstance();
+   auto hop = std::make_shared<Hop>(QString{"Maintenance Hop"});
+   ObjectStoreWrapper::insert(hop);
+   int const hopId = hop->key();
+   ObjectStoreWrapper::softDelete(*hop);
+   QVERIFY(hopStore.contains(hopId));
+
+   // Whilst something is still using the hop, it should not be purged
+   DbMaintenance & dbMaintenance = DbMaintenance::instance();
+   dbMaintenance.runCycle();
+   QVERIFY(hopStore.contains(hopId));
+
+   // Once nothing is, it should be
+   hop.reset();
+   DbMaintenance::Report const report = dbMaintenance.runCycle();
+   QVERIFY(!hopStore.contains(hopId));
+   QVERIFY(report.numPurged >= 1);
+   QVERIFY(report.numSteps > 0);
+   QVERIFY(report.bytesAfter > 0);
+
+   // A recipe's brew notes are a record of what was brewed, so a recipe that has them should not be purged...
+   auto & recipeStore = ObjectStoreTyped<Recipe>::getInstance();
+   auto & brewNoteStore = ObjectStoreTyped<BrewNote>::getInstance();
+   auto recipe = std::make_shared<Recipe>(QString{"Maintenance Recipe"});
+   ObjectStoreWrapper::insert(recipe);
+   int const recipeId = recipe->key();
+   auto brewNote = std::make_shared<BrewNote>(*recipe);
+   ObjectStoreWrapper::insert(brewNote);
+   int const brewNoteId = brewNote->key();
+   ObjectStoreWrapper::softDelete(*recipe);
+   recipe.reset();
+   dbMaintenance.runCycle();
+   QVERIFY(recipeStore.contains(recipeId));
+   QVERIFY(brewNoteStore.contains(brewNoteId));
+   QVERIFY(!brewNote->deleted());
+
+   // ...until the brew notes are deleted too
+   ObjectStoreWrapper::softDelete(*brewNote);
+   brewNote.reset();
+   dbMaintenance.runCycle();
+   QVERIFY(!brewNoteStore.contains(brewNoteId));
+   QVERIFY(!recipeStore.contains(recipeId));
+
+   //
+   // Objects that can't be purged mustn't stop us getting to the ones after them.  We need more of them than
+   // DbMaintenance looks at in one step.
+   //
+   std::vector<std::shared_ptr<Hop>> inUseHops;
+   for (int ii = 0; ii < 25; ++ii) {
+      auto inUseHop = std::make_shared<Hop>(QString{"Maintenance In Use Hop %1"}.arg(ii));
+      ObjectStoreWrapper::insert(inUseHop);
+      ObjectStoreWrapper::softDelete(*inUseHop);
+      inUseHops.push_back(inUseHop);
+   }
+   auto unusedHop = std::make_shared<Hop>(QString{"Maintenance Unused Hop"});
+   ObjectStoreWrapper::insert(unusedHop);
+   int const unusedHopId = unusedHop->key();
+   ObjectStoreWrapper::softDelete(*unusedHop);
+   unusedHop.reset();
+   dbMaintenance.runCycle();
+   QVERIFY(!hopStore.contains(unusedHopId));
+   for (auto const & inUseHop : inUseHops) {
+      QVERIFY(hopStore.contains(inUseHop->key()));
+   }
+
+   // Change journal entries that a delta export has already covered are pruned, but later ones are kept
+   ChangeJournal & changeJournal = ChangeJournal::instance();
+   auto journalHop = std::make_shared<Hop>(QString{"Maintenance Journal Hop"});
+   ObjectStoreWrapper::insert(journalHop);
+   qint64 const exportedSequence = changeJournal.latestSequence();
+   journalHop->setAlpha_pct(4.2);
+   QVERIFY(changeJournal.latestSequence() > exportedSequence);
+   QVariant const savedExportSequence =
+      PersistentSettings::value(PersistentSettings::Names::lastChangeExportSequence, 0);
+   auto const restoreExportSequence = qScopeGuard([&savedExportSequence]() {
+      PersistentSettings::insert(PersistentSettings::Names::lastChangeExportSequence, savedExportSequence);
+      return;
+   });
+   PersistentSettings::insert(PersistentSettings::Names::lastChangeExportSequence, exportedSequence);
+   DbMaintenance::Report const pruneReport = dbMaintenance.runCycle();
+   QVERIFY(pruneReport.numJournalEntriesPruned >= 1);
+   QVector<ChangeJournal::Entry> const oldestEntry = changeJournal.changesSince(0, 1);
+   QVERIFY(!oldestEntry.isEmpty());
+   QVERIFY(oldestEntry.first().sequence > exportedSequence);
+   QVERIFY(!changeJournal.changesSince(exportedSequence).isEmpty());
+   return;
+}
@@ -77,6 +77,12 @@ private slots:
     */
    void testAlgorithms();
 
+   /**
+    * \brief Verify that the batch versions of IBU and gravity calculations give the same results as the single-value
+    *        ones.  (See \c Benchmarks for the difference in speed.)
+    */
+   void testBatchAlgorithms();
+
    /**
     * \brief Verify the mechanism we use for looking up type info about a parameter in the "model" classes (ie
     *        \c NamedEntity and subclasses thereof).
@@ -86,6 +92,43 @@ private slots:
    //! \brief Verify Log rotation is working
    void testLogRotation();
 
+   //! \brief Verify that moving items between folders in a tree model (by drag and drop) moves them all
+   void testTreeModelMoveItems();
+
+   //! \brief Verify that amount strings (eg "3,5 kg") are parsed correctly, including when several threads are parsing
+   void testAmountParser();
+
+   //! \brief Verify that property changes queued on the DB writer thread all get written, in order, by \c flush()
+   void testDbWriter();
+
+   //! \brief Verify full-text search (term splitting, prefix matching, ranking and keeping up-to-date with changes)
+   void testSearchIndex();
+
+   //! \brief Verify that \c BtSqlQuery records execution counts and rows in \c QueryStats
+   void testQueryStats();
+
+   //! \brief Verify that a write to a row someone else changed is rejected, and the object re-read, via the row version,
+   //!        and that a rolled-back write does not leave our row version ahead of the DB
+   void testRowVersionConflict();
+
+   //! \brief Verify that a queued write to a row someone else changed leaves us with their version, not our rejected one
+   void testQueuedWriteConflict();
+
+   //! \brief Verify that change notifications are delivered, on PostgreSQL, when (and only when) the write commits.
+   //!        Skipped unless BREWTARGET_TEST_PG_DATABASE names a PostgreSQL DB we can connect to.
+   void testChangeNotificationPgsql();
+
+   //! \brief Verify that ObjectStore writes are journaled (with updates merged), and that delta export uses the journal
+   void testChangeJournal();
+
+   //! \brief Verify that an ObjectStore loaded from a snapshot matches one loaded from the DB
+   void testStartupSnapshot();
+
+   //! \brief Verify that DB maintenance purges soft-deleted objects once nothing (including a brew note) is using them,
+   //!        without being held up by ones that are still in use, and prunes change journal entries that have already
+   //!        been exported
+   void testDbMaintenance();
+
 };
 
 #endif
@@ -0,0 +1,146 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/CellDataCache.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/CellDataCache.h"
+
+#include <atomic>
+
+#include <QDebug>
+
+namespace {
+   //
+   // Incremented by CellDataCache::displaySettingsChanged.  Each CellDataCache remembers the value it last saw, and
+   // empties itself if the global value has moved on.  This saves every model having to connect to every source of
+   // display setting changes.
+   //
+   // It is atomic because, although the caches themselves are only used on the GUI thread, there is no guarantee that
+   // the things bumping the generation are.
+   //
+   std::atomic<unsigned int> displaySettingsGeneration{0};
+
+   //
+   // How many lookups between routine logging of the statistics.  Big enough that it doesn't fill up the log file when
+   // someone scrolls up and down a large catalog, but small enough that you can see what's going on in a normal session.
+   //
+   constexpr quint64 lookupsBetweenStatisticsLogging = 100000;
+}
+
+CellDataCache::CellDataCache(char const * const ownerName) :
+   m_ownerName    {ownerName                },
+   m_enabled      {false                    },
+   m_values       {                         },
+   m_generation   {displaySettingsGeneration},
+   m_hits         {0                        },
+   m_misses       {0                        },
+   m_invalidations{0                        } {
+   return;
+}
+
+CellDataCache::~CellDataCache() {
+   if (this->m_enabled) {
+      this->logStatistics();
+   }
+   return;
+}
+
+void CellDataCache::setEnabled(bool const enabled) {
+   this->m_enabled = enabled;
+   if (!enabled) {
+      this->m_values.clear();
+   }
+   return;
+}
+
+bool CellDataCache::isEnabled() const {
+   return this->m_enabled;
+}
+
+qint64 CellDataCache::makeCellKey(int const column, int const role) {
+   return (static_cast<qint64>(column) << 32) | static_cast<quint32>(role);
+}
+
+void CellDataCache::checkGeneration() const {
+   unsigned int const currentGeneration = displaySettingsGeneration;
+   if (this->m_generation != currentGeneration) {
+      this->m_values.clear();
+      this->m_generation = currentGeneration;
+      ++this->m_invalidations;
+   }
+   return;
+}
+
+std::optional<QVariant> CellDataCache::get(void const * rowObject, int const column, int const role) const {
+   if (!this->m_enabled) {
+      return std::nullopt;
+   }
+
+   this->checkGeneration();
+
+   if ((this->m_hits + this->m_misses + 1) % lookupsBetweenStatisticsLogging == 0) {
+      this->logStatistics();
+   }
+
+   auto const rowValues = this->m_values.constFind(rowObject);
+   if (rowValues != this->m_values.cend()) {
+      auto const value = rowValues->constFind(makeCellKey(column, role));
+      if (value != rowValues->cend()) {
+         ++this->m_hits;
+         return *value;
+      }
+   }
+
+   ++this->m_misses;
+   return std::nullopt;
+}
+
+void CellDataCache::insert(void const * rowObject, int const column, int const role, QVariant const & value) const {
+   if (this->m_enabled) {
+      this->m_values[rowObject].insert(makeCellKey(column, role), value);
+   }
+   return;
+}
+
+void CellDataCache::invalidate(void const * rowObject) {
+   if (this->m_values.remove(rowObject) > 0) {
+      ++this->m_invalidations;
+   }
+   return;
+}
+
+void CellDataCache::clear() {
+   if (!this->m_values.isEmpty()) {
+      this->m_values.clear();
+      ++this->m_invalidations;
+   }
+   return;
+}
+
+void CellDataCache::logStatistics() const {
+   quint64 const lookups = this->m_hits + this->m_misses;
+   qInfo().noquote() <<
+      Q_FUNC_INFO << this->m_ownerName << "cell cache:" << lookups << "lookups," << this->m_hits << "hits (" <<
+      QString::number(lookups ? (100.0 * this->m_hits / lookups) : 0.0, 'f', 1) << "%)," << this->m_misses <<
+      "misses," << this->m_invalidations << "invalidations," << this->m_values.size() << "rows cached";
+   return;
+}
+
+void CellDataCache::displaySettingsChanged() {
+   ++displaySettingsGeneration;
+   return;
+}
+
+unsigned int CellDataCache::currentDisplaySettingsGeneration() {
+   return displaySettingsGeneration;
+}
@@ -0,0 +1,113 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/CellDataCache.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_CELLDATACACHE_H
+#define UTILS_CELLDATACACHE_H
+#pragma once
+
+#include <optional>
+
+#include <QHash>
+#include <QString>
+#include <QVariant>
+
+/**
+ * \brief Optional cache of the values returned by the \c data() member functions of table and tree models (ie
+ *        \c TableModelBase and \c TreeModelBase subclasses), keyed by (row object, column, role).
+ *
+ *        Formatting a cell for display typically means reading a property, looking up any forced system of
+ *        measurement or scale for the column (which is a \c PersistentSettings read), converting units and localising
+ *        the result.  When the user scrolls or resizes a large catalog, Qt asks for the same cells many times a
+ *        second, so it is worth remembering the results.
+ *
+ *        The owning model is responsible for calling \c invalidate when one of its row objects changes (typically on
+ *        receipt of the \c NamedEntity::changed signal) and \c clear when rows are removed.  Changes to how amounts are
+ *        displayed (global unit systems, forced units and scales set from \c UnitAndScalePopUpMenu, date format,
+ *        language) affect every cache, so we handle those via \c CellDataCache::displaySettingsChanged, which causes
+ *        every cache to empty itself the next time it is used.
+ *
+ *        The cache is off by default, and the owning model has to opt in by calling \c setEnabled.
+ *
+ *        NOTE: This is not thread-safe.  Like the models that use it, it is only intended to be used on the GUI thread.
+ */
+class CellDataCache {
+public:
+   /**
+    * \param ownerName Used only for logging (typically the class name of the owning model).
+    */
+   CellDataCache(char const * const ownerName);
+   ~CellDataCache();
+
+   void setEnabled(bool const enabled);
+   bool isEnabled() const;
+
+   /**
+    * \return The cached value, or \c std::nullopt if there is none (including if the cache is not enabled)
+    */
+   std::optional<QVariant> get(void const * rowObject, int const column, int const role) const;
+
+   /**
+    * \brief Store a value.  No-op if the cache is not enabled.
+    */
+   void insert(void const * rowObject, int const column, int const role, QVariant const & value) const;
+
+   //! \brief Discard all cached values for the supplied row object
+   void invalidate(void const * rowObject);
+
+   //! \brief Discard all cached values
+   void clear();
+
+   /**
+    * \brief Write the hit/miss statistics to the log.  This is also done automatically every so often, and when the
+    *        cache is destroyed.
+    */
+   void logStatistics() const;
+
+   /**
+    * \brief Call this whenever something changes that could alter how any value is displayed, eg
+    *        \c Measurement::setDisplayUnitSystem, \c SmartAmounts::setForcedSystemOfMeasurement.  All caches will be
+    *        emptied before their next use.
+    */
+   static void displaySettingsChanged();
+
+   /**
+    * \brief Returns a number that changes every time \c displaySettingsChanged is called.  This allows other caches of
+    *        formatted output (eg \c HtmlFragmentCache) to notice when their contents are stale.
+    */
+   static unsigned int currentDisplaySettingsGeneration();
+
+private:
+   /**
+    * \brief If display settings have changed since we last looked, throw away everything we have.
+    *
+    *        This is const because it is called from \c get, but, since the cache is not part of the logical state of
+    *        the owning model, the members it modifies are mutable.
+    */
+   void checkGeneration() const;
+
+   static qint64 makeCellKey(int const column, int const role);
+
+   char const * const m_ownerName;
+   bool m_enabled;
+
+   mutable QHash<void const *, QHash<qint64, QVariant>> m_values;
+   mutable unsigned int m_generation;
+
+   mutable quint64 m_hits;
+   mutable quint64 m_misses;
+   mutable quint64 m_invalidations;
+};
+
+#endif
@@ -0,0 +1,215 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/HtmlFragmentCache.cpp is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#include "utils/HtmlFragmentCache.h"
+
+#include <optional>
+
+#include <QHash>
+#include <QMetaProperty>
+
+#include "Logging.h"
+#include "model/NamedEntity.h"
+#include "utils/CellDataCache.h"
+
+namespace {
+   struct Section {
+      QList<BtStringConst const *>        ownerProperties;
+      HtmlFragmentCache::DependencyLister dependencyLister;
+      HtmlFragmentCache::Builder          builder;
+      std::optional<QString>              html;
+      //! Connections to the \c changed signals of the objects on which \c html depends
+      QList<QMetaObject::Connection>      connections;
+   };
+}
+
+// This private implementation class holds all private non-virtual members of HtmlFragmentCache
+class HtmlFragmentCache::impl {
+public:
+
+   impl(char const * const ownerName, QObject & context) :
+      m_ownerName      {ownerName},
+      m_context        {context  },
+      m_owner          {nullptr  },
+      m_ownerConnection{},
+      m_sections       {},
+      m_generation     {CellDataCache::currentDisplaySettingsGeneration()},
+      m_hits           {0},
+      m_misses         {0},
+      m_invalidations  {0} {
+      return;
+   }
+
+   ~impl() {
+      QObject::disconnect(this->m_ownerConnection);
+      for (auto & section : this->m_sections) {
+         this->discard(section);
+      }
+      return;
+   }
+
+   void discard(Section & section) {
+      for (auto const & connection : section.connections) {
+         QObject::disconnect(connection);
+      }
+      section.connections.clear();
+      if (section.html) {
+         section.html.reset();
+         ++this->m_invalidations;
+      }
+      return;
+   }
+
+   void discardAll() {
+      for (auto & section : this->m_sections) {
+         this->discard(section);
+      }
+      return;
+   }
+
+   /**
+    * \brief Called when the owner emits \c changed.  Discards only the sections that depend on the property that
+    *        changed.
+    */
+   void ownerChanged(QMetaProperty const & prop) {
+      QString const propName = prop.name();
+      for (auto & section : this->m_sections) {
+         if (!section.html) {
+            continue;
+         }
+         bool dependsOnProperty = section.ownerProperties.isEmpty();
+         for (auto const * ownerProperty : section.ownerProperties) {
+            if (propName == **ownerProperty) {
+               dependsOnProperty = true;
+               break;
+            }
+         }
+         if (dependsOnProperty) {
+            this->discard(section);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief If display settings have changed since we last looked, throw away everything we have.
+    */
+   void checkGeneration() {
+      unsigned int const currentGeneration = CellDataCache::currentDisplaySettingsGeneration();
+      if (this->m_generation != currentGeneration) {
+         this->discardAll();
+         this->m_generation = currentGeneration;
+      }
+      return;
+   }
+
+   char const * const m_ownerName;
+   QObject & m_context;
+   NamedEntity const * m_owner;
+   QMetaObject::Connection m_ownerConnection;
+   QHash<int, Section> m_sections;
+   unsigned int m_generation;
+
+   quint64 m_hits;
+   quint64 m_misses;
+   quint64 m_invalidations;
+};
+
+HtmlFragmentCache::HtmlFragmentCache(char const * const ownerName, QObject & context) :
+   pimpl{std::make_unique<impl>(ownerName, context)} {
+   return;
+}
+
+HtmlFragmentCache::~HtmlFragmentCache() {
+   this->logStatistics();
+   return;
+}
+
+void HtmlFragmentCache::addSection(int const section,
+                                   QList<BtStringConst const *> const & ownerProperties,
+                                   DependencyLister dependencyLister,
+                                   Builder builder) {
+   Q_ASSERT(!this->pimpl->m_sections.contains(section));
+   this->pimpl->m_sections.insert(section, Section{ownerProperties, dependencyLister, builder, std::nullopt, {}});
+   return;
+}
+
+void HtmlFragmentCache::setOwner(NamedEntity const * owner) {
+   if (owner == this->pimpl->m_owner) {
+      return;
+   }
+
+   QObject::disconnect(this->pimpl->m_ownerConnection);
+   this->pimpl->discardAll();
+   this->pimpl->m_owner = owner;
+   if (owner) {
+      this->pimpl->m_ownerConnection = QObject::connect(
+         owner,
+         &NamedEntity::changed,
+         &this->pimpl->m_context,
+         [this](QMetaProperty prop, [[maybe_unused]] QVariant val) { this->pimpl->ownerChanged(prop); return; }
+      );
+   }
+   return;
+}
+
+QString HtmlFragmentCache::fragment(int const section) {
+   this->pimpl->checkGeneration();
+
+   auto sectionIter = this->pimpl->m_sections.find(section);
+   Q_ASSERT(sectionIter != this->pimpl->m_sections.end());
+   Section & cached = *sectionIter;
+   if (cached.html) {
+      ++this->pimpl->m_hits;
+      return *cached.html;
+   }
+
+   ++this->pimpl->m_misses;
+   for (auto const * dependency : cached.dependencyLister()) {
+      if (dependency) {
+         cached.connections.append(
+            QObject::connect(dependency,
+                             &NamedEntity::changed,
+                             &this->pimpl->m_context,
+                             [this, section]() { this->invalidate(section); return; })
+         );
+      }
+   }
+   cached.html = cached.builder();
+   qCDebug(logUi) << Q_FUNC_INFO << this->pimpl->m_ownerName << "rebuilt section" << section;
+   return *cached.html;
+}
+
+void HtmlFragmentCache::invalidate(int const section) {
+   auto sectionIter = this->pimpl->m_sections.find(section);
+   if (sectionIter != this->pimpl->m_sections.end()) {
+      this->pimpl->discard(*sectionIter);
+   }
+   return;
+}
+
+void HtmlFragmentCache::clear() {
+   this->pimpl->discardAll();
+   return;
+}
+
+void HtmlFragmentCache::logStatistics() const {
+   quint64 const lookups = this->pimpl->m_hits + this->pimpl->m_misses;
+   qCDebug(logUi).noquote() <<
+      Q_FUNC_INFO << this->pimpl->m_ownerName << "HTML fragment cache:" << lookups << "lookups," <<
+      this->pimpl->m_hits << "hits," << this->pimpl->m_misses << "misses," << this->pimpl->m_invalidations <<
+      "invalidations";
+   return;
+}
@@ -0,0 +1,99 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/HtmlFragmentCache.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_HTMLFRAGMENTCACHE_H
+#define UTILS_HTMLFRAGMENTCACHE_H
+#pragma once
+
+#include <functional>
+#include <memory> // For PImpl
+
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include "utils/BtStringConst.h"
+
+class NamedEntity;
+
+/**
+ * \brief Cache of the HTML fragments (title, fermentables, hops, mash, instructions, etc) from which \c RecipeFormatter
+ *        and \c BrewDayFormatter assemble a page.
+ *
+ *        Each section is registered once with \c addSection, giving:
+ *           - the properties of the owner object (ie the \c Recipe) on which the fragment depends.  An empty list means
+ *             the fragment depends on every property of the owner (which is what we want for things like the stats
+ *             table that show a lot of calculated values);
+ *           - a function returning the other objects (eg the hop additions and their hops) on which the fragment
+ *             depends.  Any \c NamedEntity::changed signal from one of these discards the fragment;
+ *           - a function to build the fragment.
+ *
+ *        So, eg, editing a hop addition only rebuilds the hops table, rather than every table on the page.
+ *
+ *        As with \c CellDataCache, changes to how amounts are displayed (see \c CellDataCache::displaySettingsChanged)
+ *        discard everything.
+ *
+ *        NOTE: This is not thread-safe.  Fragments are built by reading model objects, so this is only intended to be
+ *              used on the GUI thread.
+ */
+class HtmlFragmentCache {
+public:
+   using Builder          = std::function<QString()>;
+   using DependencyLister = std::function<QList<NamedEntity const *>()>;
+
+   /**
+    * \param ownerName Used only for logging (typically the class name of the owning formatter).
+    * \param context Used as the context object for signal connections, so it should be the owning formatter.
+    */
+   HtmlFragmentCache(char const * const ownerName, QObject & context);
+   ~HtmlFragmentCache();
+
+   /**
+    * \brief Register a section.  See class comment for details.
+    *
+    * \param section Caller-defined identifier (typically an enum value)
+    */
+   void addSection(int const section,
+                   QList<BtStringConst const *> const & ownerProperties,
+                   DependencyLister dependencyLister,
+                   Builder builder);
+
+   /**
+    * \brief Set the object (usually a \c Recipe) whose \c changed signal we listen to.  Changing owner discards all
+    *        cached fragments.
+    */
+   void setOwner(NamedEntity const * owner);
+
+   /**
+    * \return The cached fragment for \c section, building it first if necessary
+    */
+   QString fragment(int const section);
+
+   //! \brief Discard the cached fragment for \c section
+   void invalidate(int const section);
+
+   //! \brief Discard all cached fragments
+   void clear();
+
+   //! \brief Write the hit/miss statistics to the log
+   void logStatistics() const;
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+};
+
+#endif
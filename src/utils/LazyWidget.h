@@ -0,0 +1,143 @@
+/*╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌
+ * utils/LazyWidget.h is part of Brewtarget, and is copyright the following authors 2025:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation, either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with this program.  If not, see
+ * <http://www.gnu.org/licenses/>.
+ ╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌╌*/
+#ifndef UTILS_LAZYWIDGET_H
+#define UTILS_LAZYWIDGET_H
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QWidget>
+
+#include "Logging.h"
+
+/**
+ * \brief Non-templated base of \c LazyWidget, so that an owner can keep a list of its lazily-created widgets (eg for
+ *        pre-warming them in idle time).
+ */
+class LazyWidgetBase {
+public:
+   LazyWidgetBase(char const * const name) : m_name{name} {
+      return;
+   }
+   virtual ~LazyWidgetBase() = default;
+
+   char const * name() const {
+      return this->m_name;
+   }
+
+   //! \return \c true if the widget has been created
+   virtual bool exists() const = 0;
+
+   //! \brief Create the widget now, if it does not already exist, without showing it
+   virtual void prewarm() = 0;
+
+private:
+   char const * const m_name;
+};
+
+/**
+ * \brief Holds a dialog, catalog, tool window, etc that is only constructed the first time it is used.
+ *
+ *        Some of the windows that \c MainWindow can open are expensive to construct (eg each catalog builds a table
+ *        model and proxy over a whole \c ObjectStore), and most are never opened in a typical session.  So, rather than
+ *        construct them all at start-up, we hold each one in one of these, and it gets created the first time someone
+ *        dereferences it.
+ *
+ *        Anything that needs to be done to a newly-created widget (eg telling it which recipe is current) can be
+ *        registered with \c onCreate.  Code that just wants to keep an already-existing widget up-to-date should use
+ *        \c ifExists, so it doesn't cause the widget to be created.
+ *
+ *        Like the widgets it holds, this is only intended to be used on the GUI thread.
+ *
+ * \tparam T The widget class
+ * \tparam Parent The type of parent pointer \c T's constructor takes (usually \c QWidget, but a few take
+ *                \c MainWindow)
+ */
+template<class T, class Parent = QWidget>
+class LazyWidget : public LazyWidgetBase {
+public:
+   using Initialiser = std::function<void(T &)>;
+
+   /**
+    * \param parent Passed to the constructor of \c T
+    * \param name Used only for logging (typically the class name of \c T)
+    */
+   LazyWidget(Parent & parent, char const * const name) :
+      LazyWidgetBase{name},
+      m_parent      {parent},
+      m_widget      {},
+      m_initialisers{} {
+      return;
+   }
+   ~LazyWidget() = default;
+
+   T & get() {
+      if (!this->m_widget) {
+         QElapsedTimer timer;
+         timer.start();
+         this->m_widget = std::make_unique<T>(&this->m_parent);
+         for (auto const & initialiser : this->m_initialisers) {
+            initialiser(*this->m_widget);
+         }
+         qCDebug(logUi) << Q_FUNC_INFO << "Created" << this->name() << "in" << timer.elapsed() << "ms";
+      }
+      return *this->m_widget;
+   }
+
+   T * operator->() { return &this->get(); }
+   T & operator*()  { return  this->get(); }
+
+   virtual bool exists() const override {
+      return static_cast<bool>(this->m_widget);
+   }
+
+   virtual void prewarm() override {
+      this->get();
+      return;
+   }
+
+   /**
+    * \brief Register something to be done to the widget when it is created.  If it already exists, this is done
+    *        straight away.
+    */
+   void onCreate(Initialiser initialiser) {
+      if (this->m_widget) {
+         initialiser(*this->m_widget);
+      }
+      this->m_initialisers.append(initialiser);
+      return;
+   }
+
+   /**
+    * \brief Do something to the widget only if it already exists
+    */
+   void ifExists(std::function<void(T &)> const & action) {
+      if (this->m_widget) {
+         action(*this->m_widget);
+      }
+      return;
+   }
+
+private:
+   Parent & m_parent;
+   std::unique_ptr<T> m_widget;
+   QList<Initialiser> m_initialisers;
+};
+
+#endif
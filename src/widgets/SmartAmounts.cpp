@@ -19,6 +19,7 @@
 
 #include "measurement/Measurement.h"
 #include "PersistentSettings.h"
+#include "utils/CellDataCache.h"
 #include "utils/TypeLookup.h"
 #include "widgets/SmartLabel.h"
 #include "widgets/SmartField.h"
@@ -98,6 +99,7 @@ void SmartAmounts::setForcedSystemOfMeasurement(char const * const owningWindowN
                                  owningWindowName,
                                  PersistentSettings::Extension::UNIT);
    }
+   CellDataCache::displaySettingsChanged();
    return;
 }
 
@@ -114,6 +116,7 @@ void SmartAmounts::setForcedRelativeScale(char const * const owningWindowName,
                                  owningWindowName,
                                  PersistentSettings::Extension::SCALE);
    }
+   CellDataCache::displaySettingsChanged();
    return;
 }
 